@@ -565,6 +565,7 @@ if(TARGET bgfx::shaderc)
 	# 	OUT_FILES_VAR variable name
 	# 	INCLUDE_DIRS directories
 	# 	DEFINES defines
+	# 	[DEPENDS files]
 	# 	[PROFILES profiles]
 	# 	[AS_HEADERS]
 	# 	[NO_SOURCE_GROUP]
@@ -573,7 +574,7 @@ if(TARGET bgfx::shaderc)
 	function(bgfx_compile_shaders)
 		set(options AS_HEADERS NO_SOURCE_GROUP)
 		set(oneValueArgs TYPE VARYING_DEF OUTPUT_DIR OUT_FILES_VAR)
-		set(multiValueArgs SHADERS INCLUDE_DIRS DEFINES PROFILES)
+		set(multiValueArgs SHADERS INCLUDE_DIRS DEFINES PROFILES DEPENDS)
 		cmake_parse_arguments(ARGS "${options}" "${oneValueArgs}" "${multiValueArgs}" "${ARGN}")
 
 		if(ARGS_PROFILES)
@@ -684,7 +685,7 @@ if(TARGET bgfx::shaderc)
 				OUTPUT ${OUTPUTS}
 				COMMAND ${MKDIR_COMMANDS} ${COMMANDS}
 				MAIN_DEPENDENCY ${SHADER_FILE_ABSOLUTE}
-				DEPENDS ${ARGS_VARYING_DEF}
+				DEPENDS ${ARGS_VARYING_DEF} ${ARGS_DEPENDS}
 			)
 		endforeach()
 
@@ -0,0 +1,70 @@
+// Round-trips a compiled layout: builds one with LayoutBuilder, views the
+// buffer, instantiates it, then hot-reloads an edited copy onto the same
+// tree (in place) and a reshaped copy (which has to be rebuilt).
+#include "../include/UILO.hpp"
+#include "../include/CompiledLayout.hpp"
+#include <cstdio>
+
+using namespace uilo;
+
+static std::vector<uint8_t> makeLayout(int rows, Color labelColor) {
+    LayoutBuilder b;
+    b.begin(ElementType::Column, "root").scrollable(true);
+    for (int i = 0; i < rows; ++i) {
+        b.begin(ElementType::Row).size(100_pct, 32_px).colorRole("surface");
+        b.begin(ElementType::Text).size(50_pct, 100_pct)
+         .text("Track " + std::to_string(i)).color(labelColor).end();
+        b.begin(ElementType::Slider, "gain" + std::to_string(i))
+         .size(50_pct, 100_pct).range(-60.f, 6.f).value(0.f).end();
+        b.end();
+    }
+    b.end();
+    std::vector<uint8_t> bytes;
+    b.finish(bytes);
+    return bytes;
+}
+
+static int fail(const char* what) {
+    std::fprintf(stderr, "compiled_layout_test: %s\n", what);
+    return 1;
+}
+
+int main() {
+    const auto v1 = makeLayout(500, Color::White);
+    CompiledLayout layout;
+    if (!layout.view(v1.data(), v1.size())) return fail("v1 rejected");
+    if (layout.getNodeCount() != 1 + 500 * 3) return fail("wrong node count");
+
+    Page* p = layout.page("mixer");
+    if (!p) return fail("instantiate failed");
+    UILO ui;
+    ui.addPage(p);
+    ui.setPage("mixer");
+
+    auto* gain = ui.getElement<Slider>("gain7");
+    if (!gain) return fail("named slider missing");
+    gain->setValue(-12.f);
+
+    // Same shape, new colour: reused in place, user state kept.
+    const auto v2 = makeLayout(500, Color::Black);
+    CompiledLayout edited;
+    if (!edited.view(v2.data(), v2.size())) return fail("v2 rejected");
+    if (!ui.loadPage(edited, "mixer")) return fail("in-place reload failed");
+    if (ui.getElement<Slider>("gain7") != gain || gain->getValue() != -12.f)
+        return fail("in-place reload replaced the slider");
+
+    // One more row: the tree is rebuilt.
+    const auto v3 = makeLayout(501, Color::Black);
+    CompiledLayout reshaped;
+    if (!reshaped.view(v3.data(), v3.size())) return fail("v3 rejected");
+    if (!ui.loadPage(reshaped, "mixer")) return fail("rebuild failed");
+
+    // A corrupt buffer must be refused, not read.
+    auto bad = v1;
+    bad[0] ^= 0xFF;
+    CompiledLayout broken;
+    if (broken.view(bad.data(), bad.size())) return fail("corrupt buffer accepted");
+
+    std::puts("compiled_layout_test: OK");
+    return 0;
+}
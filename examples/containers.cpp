@@ -72,12 +72,13 @@ static void applyTheme(UILO& ui, bool dark) {
 // ---------------------------------------------------------------------------
 // Floating FPS HUD
 // ---------------------------------------------------------------------------
+// Refs are resolved once at install; each per-frame use is a handle check.
 struct FpsHud {
-    Text*   fps   = nullptr;
-    Text*   draws = nullptr;
-    Text*   cpu   = nullptr;
-    Text*   gpu   = nullptr;
-    Column* root  = nullptr;
+    ElementRef<Text>   fps;
+    ElementRef<Text>   draws;
+    ElementRef<Text>   cpu;
+    ElementRef<Text>   gpu;
+    ElementRef<Column> root;
 };
 
 static FpsHud installFpsHud(UILO& ui) {
@@ -141,11 +142,11 @@ static FpsHud installFpsHud(UILO& ui) {
         "fps_hud"
     ).setPosition(12_px, 12_px).setDraggable(true));
     return FpsHud{
-        ui.getElement<Text>  ("fps_text"),
-        ui.getElement<Text>  ("fps_draws"),
-        ui.getElement<Text>  ("fps_cpu"),
-        ui.getElement<Text>  ("fps_gpu"),
-        ui.getElement<Column>("fps_hud"),
+        ui.getElementRef<Text>  ("fps_text"_id),
+        ui.getElementRef<Text>  ("fps_draws"_id),
+        ui.getElementRef<Text>  ("fps_cpu"_id),
+        ui.getElementRef<Text>  ("fps_gpu"_id),
+        ui.getElementRef<Column>("fps_hud"_id),
     };
 }
 
@@ -226,10 +227,10 @@ static void handleEvent(
     if (event.type == SDL_EVENT_KEY_DOWN) {
         SDL_Keycode k = event.key.key;
         if (k == SDLK_EQUALS || k == SDLK_KP_PLUS) {
-            if (!latch.plus) ui.setScale(ui.getScale() + 0.1f);
+            if (!latch.plus) ui.setScale(ui.getTargetScale() + 0.1f, true);
             latch.plus = true;
         } else if (k == SDLK_MINUS || k == SDLK_KP_MINUS) {
-            if (!latch.minus) ui.setScale(ui.getScale() - 0.1f);
+            if (!latch.minus) ui.setScale(ui.getTargetScale() - 0.1f, true);
             latch.minus = true;
         } else if (k == SDLK_F10) {
             if (!latch.f10) showFps = !showFps;
@@ -1,5 +1,6 @@
-// Gradient showcase: literal gradients, palette-role stops, named palette
-// gradients, rounded corners, and live mutation from a hover callback.
+// Gradient showcase: literal gradients, palette-role stops, multi-stop
+// linear / radial fills, named palette gradients, rounded corners, and live
+// mutation from a hover callback.
 #include "../include/UILO.hpp"
 #include "../include/renderer/Renderer.hpp"
 #include <SDL3/SDL.h>
@@ -24,7 +25,7 @@ static Container* buildRoot() {
         contains{
             // Vertical fade, rounded. Position-named setters read top->bottom.
             row(
-                Modifier().setHeight(22_pct).setOuterPadding(8.f),
+                Modifier().setHeight(18_pct).setOuterPadding(8.f),
                 RowOptions()
                     .setGradient(Gradient()
                         .setTop(Color{240, 120, 90})
@@ -34,7 +35,7 @@ static Container* buildRoot() {
 
             // Horizontal gradient built from palette roles: follows theme.
             row(
-                Modifier().setHeight(22_pct).setOuterPadding(8.f),
+                Modifier().setHeight(18_pct).setOuterPadding(8.f),
                 RowOptions()
                     .setGradient(Gradient()
                         .setLeft("accent")
@@ -44,7 +45,7 @@ static Container* buildRoot() {
 
             // Four explicit corners, each named by where it sits.
             row(
-                Modifier().setHeight(22_pct).setOuterPadding(8.f),
+                Modifier().setHeight(18_pct).setOuterPadding(8.f),
                 RowOptions()
                     .setGradient(Gradient()
                         .setTopLeft(Color{80, 170, 255})
@@ -54,10 +55,39 @@ static Container* buildRoot() {
                     .setRounding(18.f)
             ),
 
+            // Multi-stop fills, evaluated per pixel: a 30-degree linear
+            // ramp beside a radial glow.
+            row(
+                Modifier().setHeight(18_pct),
+                RowOptions(),
+                {
+                    row(
+                        Modifier().setOuterPadding(8.f),
+                        RowOptions()
+                            .setGradient(Gradient::linear(30.f, {
+                                {0.0f, Color{255, 94, 98}},
+                                {0.5f, Color{255, 195, 113}},
+                                {1.0f, Color{72, 198, 239}},
+                            }))
+                            .setRounding(18.f)
+                    ),
+                    row(
+                        Modifier().setOuterPadding(8.f),
+                        RowOptions()
+                            .setGradient(Gradient::radial({
+                                {0.0f, Color{255, 255, 255}},
+                                {0.4f, "accent"},
+                                {1.0f, "panel"},
+                            }).setCenter(0.5f, 0.4f).setRadius(0.8f))
+                            .setRounding(18.f)
+                    ),
+                }
+            ),
+
             // Named palette gradient + a gradient button that swaps its
             // gradient from a hover callback.
             row(
-                Modifier().setHeight(22_pct).setOuterPadding(8.f),
+                Modifier().setHeight(18_pct).setOuterPadding(8.f),
                 RowOptions().setGradientRole("hero").setRounding(18.f),
                 {
                     button(
@@ -99,14 +129,19 @@ int main() {
     ui.addPage(page(buildRoot(), "main"));
     ui.setPage("main");
 
+    // Static page: only draw when something changed, sleep otherwise.
+    ui.setOnDemand(true);
+
     bool running = true;
     while (running) {
+        ui.waitForFrame();
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_EVENT_QUIT) running = false;
             ui.handleEvent(event);
         }
         ui.update();
+        if (!ui.needsFrame()) continue;
 
         renderer.beginFrame();
         renderer.clear(ui.getPalette().get("app.bg"));
@@ -0,0 +1,300 @@
+// Layout and hit-test bench: builds one synthetic tree per scenario, sweeps
+// a synthetic pointer across the window every frame and reports how long
+// UILO::update() spent laying out and dispatching input, next to the
+// renderer's CPU and GPU times, so layout changes can be measured apart
+// from draw changes.
+//
+// Scenarios:
+//   deep   - Columns and Rows nested <depth> levels deep (default 64)
+//   wide   - one Row holding <children> flat cells (default 10000)
+//   scroll - a scrollable Column of <children> / 5 rows between pinned
+//            header and footer, scrolled a little every frame
+//   canvas - a Canvas with <children> / 2 freely placed cells
+//   hover  - a 40x40 grid of cells with hover handlers
+//
+// Usage: layout_bench [scenario=all|deep|wide|scroll|canvas|hover]
+//                     [frames=<n>] [depth=<n>] [children=<n>]
+//                     [relayout=true|false] [vsync=true|false]
+//                     [headless=true|false] [json=<file>|-]
+//   scenario - which tree to run, or all of them in turn (default all)
+//   frames   - measured frames per scenario, after 30 warmup (default 300)
+//   depth    - nesting depth for deep (default 64)
+//   children - cell count for wide; scroll and canvas scale from it
+//              (default 10000)
+//   relayout - dirty the whole tree each frame so every update() is a full
+//              layout; false measures the incremental path (default true)
+//   vsync    - present with vsync (default false)
+//   headless - render offscreen without a window (default false)
+//   json     - write the results as JSON to <file>, or to stdout instead
+//              of the summary lines with "-" (default none)
+// Arguments may appear in any order.
+#include "../include/UILO.hpp"
+#include "../include/renderer/Renderer.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace uilo;
+
+namespace {
+
+struct Series {
+    std::vector<float> samples;
+
+    void  add(float ms) { samples.push_back(ms); }
+    float mean() const {
+        double sum = 0.0;
+        for (float s : samples) sum += s;
+        return samples.empty() ? 0.f : (float)(sum / (double)samples.size());
+    }
+    // Nearest-rank percentile; sorts a copy.
+    float percentile(float p) const {
+        if (samples.empty()) return 0.f;
+        std::vector<float> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        const size_t rank = (size_t)std::ceil(p / 100.f * (float)sorted.size());
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+};
+
+struct Result {
+    std::string name;
+    size_t      elements    = 0;
+    long        frames      = 0;
+    uint32_t    hoverEnters = 0;
+    Series      layout, dispatch, cpu, gpu;
+};
+
+Color cellColor(int i) {
+    return Color{ (uint8_t)(40 + (i * 7) % 180), (uint8_t)(40 + (i * 11) % 180),
+                  (uint8_t)(60 + (i * 3) % 160), 255 };
+}
+
+Row* cell(Modifier modifier, int i) {
+    return row(modifier, RowOptions().setColor(cellColor(i)));
+}
+
+// Every builder returns the page root and counts the elements it made.
+Container* buildDeep(int depth, size_t& count) {
+    Container* root = column(Modifier().setOuterPadding(2.f),
+                             ColumnOptions().setColor(Color{24, 25, 34, 255}));
+    count = 1;
+    Container* at = root;
+    for (int d = 0; d < depth; ++d) {
+        // A fixed sibling at every level so each container has real work.
+        at->addElement(cell(Modifier().setWidth(Dimension{4.f, false})
+                                      .setHeight(Dimension{4.f, false}), d));
+        Container* next = (d % 2 == 0)
+            ? static_cast<Container*>(row(Modifier().setOuterPadding(1.f), RowOptions().setColor(cellColor(d))))
+            : static_cast<Container*>(column(Modifier().setOuterPadding(1.f), ColumnOptions().setColor(cellColor(d))));
+        at->addElement(next);
+        at = next;
+        count += 2;
+    }
+    return root;
+}
+
+Container* buildWide(int children, size_t& count) {
+    Row* strip = row(Modifier().setHeight(Dimension{50.f, true}), RowOptions());
+    for (int i = 0; i < children; ++i)
+        strip->addElement(cell(Modifier().setWidth(Dimension{100.f / (float)children, true}), i));
+    count = (size_t)children + 2;
+    return column(Modifier(), ColumnOptions().setColor(Color{24, 25, 34, 255}), { strip });
+}
+
+Container* buildScroll(int rows, size_t& count) {
+    Column* list = column(Modifier(),
+                          ColumnOptions().setColor(Color{24, 25, 34, 255}).setScrollable(true));
+    list->addElement(cell(Modifier().setHeight(Dimension{32.f, false}).ignoreScroll(true), 0));
+    for (int i = 0; i < rows; ++i)
+        list->addElement(cell(Modifier().setHeight(Dimension{20.f, false}).setOuterPadding(1.f), i));
+    list->addElement(cell(Modifier().setHeight(Dimension{32.f, false}).ignoreScroll(true)
+                                    .setAlign(Align::Bottom), 1));
+    count = (size_t)rows + 3;
+    return list;
+}
+
+Container* buildCanvas(int children, size_t& count) {
+    Canvas* board = canvas(Modifier(), CanvasOptions().setColor(Color{24, 25, 34, 255}));
+    const int side = std::max(1, (int)std::ceil(std::sqrt((float)children)));
+    for (int i = 0; i < children; ++i)
+        board->addChild(cell(Modifier().setWidth(Dimension{8.f, false})
+                                       .setHeight(Dimension{8.f, false}), i),
+                        (float)(i % side) * 11.f, (float)(i / side) * 11.f);
+    count = (size_t)children + 1;
+    return board;
+}
+
+Container* buildHover(uint32_t& hoverEnters, size_t& count) {
+    constexpr int kSide = 40;
+    Column* grid = column(Modifier(), ColumnOptions().setColor(Color{24, 25, 34, 255}));
+    for (int r = 0; r < kSide; ++r) {
+        Row* line = row(Modifier().setHeight(Dimension{100.f / kSide, true}), RowOptions());
+        for (int c = 0; c < kSide; ++c)
+            line->addElement(cell(Modifier().setWidth(Dimension{100.f / kSide, true})
+                                            .setOuterPadding(1.f)
+                                            .setOnHoverEnter([&hoverEnters] { ++hoverEnters; }),
+                                  r * kSide + c));
+        grid->addElement(line);
+    }
+    count = 1 + kSide + (size_t)kSide * kSide;
+    return grid;
+}
+
+// A diagonal zig-zag that crosses every row and column of the window
+// every 120 frames.
+Vec2f sweep(long frame, Vec2u size) {
+    const float t = (float)(frame % 120) / 120.f;
+    const float u = (float)((frame / 7) % 120) / 120.f;
+    return { t * (float)size.x, (t < 0.5f ? u : 1.f - u) * (float)size.y };
+}
+
+bool runScenario(Renderer& renderer, const std::string& name, int depth, int children,
+                 long frames, bool relayout, Result& out) {
+    constexpr long kWarmupFrames = 30;   // excluded from all stats
+
+    UILO ui;
+    ui.setRenderer(renderer);
+    out.name = name;
+
+    Container* root = nullptr;
+    if      (name == "deep")   root = buildDeep(depth, out.elements);
+    else if (name == "wide")   root = buildWide(children, out.elements);
+    else if (name == "scroll") root = buildScroll(std::max(1, children / 5), out.elements);
+    else if (name == "canvas") root = buildCanvas(std::max(1, children / 2), out.elements);
+    else if (name == "hover")  root = buildHover(out.hoverEnters, out.elements);
+    else {
+        std::fprintf(stderr, "unknown scenario '%s'\n", name.c_str());
+        return false;
+    }
+    ui.addPage(page(root, name));
+    ui.setPage(name);
+
+    for (long frame = 0; frame < kWarmupFrames + frames; ++frame) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_EVENT_QUIT) return false;
+            ui.handleEvent(event);
+        }
+        const Vec2f pointer = sweep(frame, renderer.getSize());
+        ui.setPointerOverride(pointer);
+        if (name == "scroll")
+            ui.dispatchScroll(pointer, Vec2f{0.f, (frame / 60) % 2 ? 1.f : -1.f}, false);
+        if (relayout) ui.markTreeDirty();
+
+        ui.update();
+        renderer.beginFrame();
+        renderer.clear(Color{24, 25, 34, 255});
+        ui.render();
+        renderer.endFrame();
+
+        if (frame == kWarmupFrames) out.hoverEnters = 0;
+        if (frame < kWarmupFrames) continue;
+        const RendererStats st = renderer.getStats();
+        out.layout.add(ui.getLastLayoutMs());
+        out.dispatch.add(ui.getLastDispatchMs());
+        out.cpu.add((float)st.cpuTimeMs);
+        out.gpu.add((float)st.gpuTimeMs);
+        ++out.frames;
+    }
+    return true;
+}
+
+void writeSeries(std::FILE* f, const char* key, const Series& s, bool last = false) {
+    std::fprintf(f, "      \"%s\": {\"mean\": %.4f, \"p50\": %.4f, \"p99\": %.4f, \"max\": %.4f}%s\n",
+                 key, s.mean(), s.percentile(50.f), s.percentile(99.f), s.percentile(100.f),
+                 last ? "" : ",");
+}
+
+bool writeJson(const std::string& path, const std::vector<Result>& results, bool relayout) {
+    std::FILE* f = path == "-" ? stdout : std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "layout_bench: can't open '%s' for writing\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "{\n  \"relayout\": %s,\n  \"scenarios\": [\n", relayout ? "true" : "false");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(f, "    {\n      \"name\": \"%s\",\n      \"elements\": %zu,\n"
+                        "      \"frames\": %ld,\n      \"hoverEnters\": %u,\n",
+                     r.name.c_str(), r.elements, r.frames, r.hoverEnters);
+        writeSeries(f, "layoutMs",   r.layout);
+        writeSeries(f, "dispatchMs", r.dispatch);
+        writeSeries(f, "cpuMs",      r.cpu);
+        writeSeries(f, "gpuMs",      r.gpu, true);
+        std::fprintf(f, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    if (f != stdout) std::fclose(f);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string scenario = "all";
+    long   frames   = 300;
+    int    depth    = 64;
+    int    children = 10000;
+    bool   relayout = true;
+    bool   vsync    = false;
+    bool   headless = false;
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        const size_t eq = arg.find('=');
+        const std::string_view key = eq == std::string_view::npos ? arg : arg.substr(0, eq);
+        const std::string_view val = eq == std::string_view::npos ? "" : arg.substr(eq + 1);
+        const bool truthy = val == "true" || val == "1";
+        if      (key == "scenario") scenario = std::string(val);
+        else if (key == "frames")   frames   = std::atol(std::string(val).c_str());
+        else if (key == "depth")    depth    = std::atoi(std::string(val).c_str());
+        else if (key == "children") children = std::atoi(std::string(val).c_str());
+        else if (key == "relayout") relayout = truthy;
+        else if (key == "vsync")    vsync    = truthy;
+        else if (key == "headless") headless = truthy;
+        else if (key == "json")     jsonPath = std::string(val);
+        else {
+            std::fprintf(stderr, "unknown argument '%s'\n"
+                "usage: layout_bench [scenario=all|deep|wide|scroll|canvas|hover] [frames=<n>] [depth=<n>] [children=<n>] [relayout=true|false] [vsync=true|false] [headless=true|false] [json=<file>|-]\n",
+                argv[i]);
+            return 1;
+        }
+    }
+    if (frames <= 0) frames = 300;
+    if (depth < 1) depth = 1;
+    if (children < 1) children = 1;
+
+    Renderer renderer;
+    const bool ok = headless ? renderer.initHeadless(1000, 700)
+                             : renderer.init(1000, 700, "UILO layout bench");
+    if (!ok) {
+        std::fprintf(stderr, "Failed to initialize renderer\n");
+        return 1;
+    }
+    renderer.setVsync(vsync);
+
+    std::vector<std::string> names;
+    if (scenario == "all") names = { "deep", "wide", "scroll", "canvas", "hover" };
+    else                   names = { scenario };
+
+    std::vector<Result> results;
+    for (const auto& name : names) {
+        Result r;
+        if (!runScenario(renderer, name, depth, children, frames, relayout, r)) return 1;
+        if (jsonPath != "-")
+            std::printf("layout_bench: %-6s elements=%zu layoutMs=%.3f (p99 %.3f) dispatchMs=%.3f (p99 %.3f) cpuMs=%.3f gpuMs=%.3f hoverEnters=%u frames=%ld\n",
+                        r.name.c_str(), r.elements, r.layout.mean(), r.layout.percentile(99.f),
+                        r.dispatch.mean(), r.dispatch.percentile(99.f), r.cpu.mean(), r.gpu.mean(),
+                        r.hoverEnters, r.frames);
+        results.push_back(std::move(r));
+    }
+    if (!jsonPath.empty() && !writeJson(jsonPath, results, relayout)) return 1;
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Two windows on one bgfx context: the second renderer opens with
+// initShared(), so both draw with the same programs, font atlases and
+// texture cache. Each window has its own UILO; events go to whichever
+// window they name. Closing the inspector hides it and leaves the main window running.
+#include "../include/UILO.hpp"
+#include "../include/renderer/Renderer.hpp"
+#include <SDL3/SDL.h>
+#include <cstdio>
+#include <string>
+
+using namespace uilo;
+
+static Container* buildRoot(const std::string& title, const std::string& name) {
+    return column(
+        Modifier().setOuterPadding(16.f),
+        ColumnOptions().setColorRole("panel").setRounding(12.f),
+        contains{
+            text(
+                Modifier().setHeight(48_px),
+                TextOptions()
+                    .setFont("assets/fonts/Montserrat.ttf")
+                    .setContent(title)
+                    .setColorRole("text")
+                    .setCharSize(24)
+                    .setTextAlignY(Align::CenterY)
+            ),
+            text(
+                Modifier().setHeight(32_px),
+                TextOptions()
+                    .setFont("assets/fonts/Montserrat.ttf")
+                    .setContent("clicks: 0")
+                    .setColorRole("text")
+                    .setCharSize(18)
+                    .setTextAlignY(Align::CenterY),
+                name
+            ),
+        }
+    );
+}
+
+int main() {
+    Renderer mainRenderer;
+    if (!mainRenderer.init(900, 600, "UILO Main", 4)) {
+        std::fprintf(stderr, "Failed to initialize renderer\n");
+        return 1;
+    }
+    Renderer inspectorRenderer;
+    bool inspectorOpen = inspectorRenderer.initShared(mainRenderer, 420, 600, "UILO Inspector");
+    if (!inspectorOpen) std::fprintf(stderr, "No second window; running with one\n");
+
+    UILO mainUi;
+    mainUi.setRenderer(mainRenderer);
+    mainUi.addPage(page(buildRoot("Main window", "main_clicks"), "main"));
+    mainUi.setPage("main");
+
+    UILO inspectorUi;
+    if (inspectorOpen) {
+        inspectorUi.setRenderer(inspectorRenderer);
+        inspectorUi.addPage(page(buildRoot("Inspector", "inspector_clicks"), "main"));
+        inspectorUi.setPage("main");
+    }
+
+    int mainClicks = 0, inspectorClicks = 0;
+    bool running = true;
+    while (running) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_EVENT_QUIT) running = false;
+            if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) {
+                if (inspectorOpen && event.window.windowID == SDL_GetWindowID(inspectorRenderer.sdlWindow())) {
+                    // Torn down with the rest at exit (before the main
+                    // renderer: it's declared after it).
+                    SDL_HideWindow(inspectorRenderer.sdlWindow());
+                    inspectorOpen = false;
+                    continue;
+                }
+                running = false;
+            }
+            if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN) {
+                const SDL_Window* from = SDL_GetWindowFromEvent(&event);
+                if (inspectorOpen && from == inspectorRenderer.sdlWindow()) ++inspectorClicks;
+                else if (from == mainRenderer.sdlWindow())                  ++mainClicks;
+            }
+            mainUi.handleEvent(event);
+            if (inspectorOpen) inspectorUi.handleEvent(event);
+        }
+
+        if (auto* t = mainUi.getElement<Text>("main_clicks"))
+            t->setString("clicks: " + std::to_string(mainClicks));
+        mainUi.update();
+
+        // The shared window records first; the main endFrame() presents both.
+        if (inspectorOpen) {
+            if (auto* t = inspectorUi.getElement<Text>("inspector_clicks"))
+                t->setString("clicks: " + std::to_string(inspectorClicks));
+            inspectorUi.update();
+            inspectorRenderer.beginFrame();
+            inspectorRenderer.clear(inspectorUi.getPalette().get("bg"));
+            inspectorUi.render();
+            inspectorRenderer.endFrame();
+        }
+
+        mainRenderer.beginFrame();
+        mainRenderer.clear(mainUi.getPalette().get("bg"));
+        mainUi.render();
+        mainRenderer.endFrame();
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Peak-kernel microbench: runs the scalar and the dispatched (SSE2 / AVX2 /
+// NEON) min/max kernels that Waveform builds its peaks with over the same
+// synthetic planar buffer, checks they agree, and prints samples per
+// second for each. No window is opened.
+//
+// Usage: peak_bench [frames=<n>] [channels=<n>] [iterations=<n>]
+//   frames     - frames per channel (default 4194304)
+//   channels   - planar channels (default 2)
+//   iterations - passes per measurement; the best pass is reported (default 20)
+// Arguments may appear in any order.
+#include "../include/utils/PeakKernels.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace uilo;
+
+namespace {
+
+struct Result {
+    double samplesPerSec = 0.0;
+    float  mn = 0.f, mx = 0.f;
+};
+
+template <class Fn>
+Result measure(int iterations, double samples, Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    Result r;
+    double best = 1e30;
+    for (int i = 0; i < iterations; ++i) {
+        float mn = 0.f, mx = 0.f;
+        const auto t0 = clock::now();
+        fn(mn, mx);
+        const double sec = std::chrono::duration<double>(clock::now() - t0).count();
+        if (sec < best) best = sec;
+        r.mn = mn;
+        r.mx = mx;
+    }
+    r.samplesPerSec = best > 0.0 ? samples / best : 0.0;
+    return r;
+}
+
+void report(const char* what, const PeakKernels& scalar, const PeakKernels& best,
+            const Result& a, const Result& b) {
+    std::printf("%-10s %-6s %8.1f Msamples/s   %-6s %8.1f Msamples/s   x%.2f%s\n",
+                what, scalar.name, a.samplesPerSec / 1e6, best.name, b.samplesPerSec / 1e6,
+                a.samplesPerSec > 0.0 ? b.samplesPerSec / a.samplesPerSec : 0.0,
+                (a.mn == b.mn && a.mx == b.mx) ? "" : "   MISMATCH");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long frames     = 1L << 22;
+    long channels   = 2;
+    int  iterations = 20;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        const size_t eq = arg.find('=');
+        const std::string_view key = arg.substr(0, eq);
+        const std::string val = eq == std::string_view::npos ? "" : std::string(arg.substr(eq + 1));
+        if      (key == "frames")     frames     = std::atol(val.c_str());
+        else if (key == "channels")   channels   = std::atol(val.c_str());
+        else if (key == "iterations") iterations = std::atoi(val.c_str());
+        else {
+            std::fprintf(stderr, "unknown argument '%s'\n"
+                "usage: peak_bench [frames=<n>] [channels=<n>] [iterations=<n>]\n",
+                argv[i]);
+            return 1;
+        }
+    }
+    if (frames <= 0) frames = 1L << 22;
+    if (channels <= 0) channels = 2;
+    if (iterations <= 0) iterations = 20;
+
+    // Deterministic, not-quite-periodic signal so neither bound is found early.
+    std::vector<float> samples((size_t)(frames * channels));
+    for (size_t i = 0; i < samples.size(); ++i)
+        samples[i] = 0.6f * std::sin((float)i * 0.0137f) + 0.3f * std::sin((float)i * 0.291f);
+
+    std::vector<const float*> channelPtrs;
+    for (long c = 0; c < channels; ++c) channelPtrs.push_back(samples.data() + c * frames);
+
+    const PeakKernels& scalar = getScalarPeakKernels();
+    const PeakKernels& best   = getPeakKernels();
+    const double planarSamples = (double)frames * (double)channels;
+
+    auto planar = [&](const PeakKernels& k) {
+        return measure(iterations, planarSamples, [&](float& mn, float& mx) {
+            for (long c = 0; c < channels; ++c)
+                k.minMax(samples.data() + c * frames, (size_t)frames, mn, mx);
+        });
+    };
+    auto mono = [&](const PeakKernels& k) {
+        return measure(iterations, planarSamples, [&](float& mn, float& mx) {
+            k.sumMinMax(channelPtrs.data(), (size_t)channels, 0, (size_t)frames, mn, mx);
+        });
+    };
+
+    std::printf("peak_bench: frames=%ld channels=%ld iterations=%d\n", frames, channels, iterations);
+    report("planar", scalar, best, planar(scalar), planar(best));
+    report("sum-mono", scalar, best, mono(scalar), mono(best));
+    return 0;
+}
@@ -0,0 +1,477 @@
+// Performance gate: runs fixed render, layout, text, waveform and startup
+// scenarios headless, and either stores what they cost as a JSON baseline
+// or compares against one, failing when any metric goes over its budget
+// (baseline * (1 + tolerance) + slack). Every metric is lower-is-better:
+// draw calls, vertices, CPU / GPU / wall frame ms, layout ms, allocations
+// per frame and peak RSS. The perf_record / perf_check targets run it
+// against examples/perf_baseline.json; record on the machine that checks.
+//
+// Usage: perf_gate [record=<file>] [compare=<file>] [frames=<n>]
+//                  [scenarios=<a,b,..>] [tol.<metric>=<fraction>]
+//   record    - write the results to <file> as the new baseline
+//   compare   - compare the results with the baseline in <file>; exits 1
+//               when a budget is exceeded, 2 when the file can't be read
+//   frames    - measured frames per scenario, after 30 warm-up frames
+//               (default 300)
+//   scenarios - comma-separated subset of render, layout, text, waveform,
+//               startup (default all)
+//   tol.<m>   - tolerance for metric <m> (e.g. tol.cpuMs=0.5), overriding
+//               the baseline's; recorded into the baseline with record=
+// With neither record= nor compare= the results are only printed.
+// Arguments may appear in any order.
+#include "../include/UILO.hpp"
+#include "../include/renderer/Renderer.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <psapi.h>
+    #if defined(_MSC_VER)
+        #pragma comment(lib, "psapi.lib")
+    #endif
+#else
+    #include <sys/resource.h>
+#endif
+
+using namespace uilo;
+
+// ---- Allocation counter ----------------------------------------------------
+// Every global new in the process (the library's included) bumps it; the
+// aligned forms are left alone, so SlabPool slabs don't count.
+namespace {
+std::atomic<uint64_t> g_allocs{0};
+}
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept                   { std::free(p); }
+void operator delete[](void* p) noexcept                 { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept      { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept    { std::free(p); }
+
+namespace {
+
+using Metrics = std::map<std::string, double>;      // metric -> value
+using Results = std::map<std::string, Metrics>;     // scenario -> metrics
+
+constexpr int kWarmupFrames = 30;
+
+double peakRssKb() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0.0;
+    return (double)pmc.PeakWorkingSetSize / 1024.0;
+#else
+    rusage ru{};
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0.0;
+  #if defined(__APPLE__)
+    return (double)ru.ru_maxrss / 1024.0;   // bytes there
+  #else
+    return (double)ru.ru_maxrss;
+  #endif
+#endif
+}
+
+double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Default budgets: counts are deterministic so they get little room,
+// timings get a lot. Slack is absolute, for metrics that sit near zero.
+struct Tolerance { double fraction; double slack; };
+Tolerance defaultTolerance(const std::string& metric) {
+    if (metric == "drawCalls" || metric == "vertices") return {0.05, 2.0};
+    if (metric == "allocsPerFrame")                     return {0.10, 2.0};
+    if (metric == "peakRssKb")                          return {0.15, 1024.0};
+    return {0.25, 0.05};                                // *Ms
+}
+
+// Runs `frames` measured frames (after the warm-up) of `ui`, calling
+// `step(frame)` before each update, and averages the renderer's counters.
+Metrics runFrames(Renderer& renderer, UILO& ui, int frames, const std::function<void(int)>& step) {
+    double cpu = 0.0, gpu = 0.0, wall = 0.0, layout = 0.0, draws = 0.0, verts = 0.0;
+    uint64_t allocs = 0;
+    for (int f = 0; f < kWarmupFrames + frames; ++f) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) ui.handleEvent(event);
+        const uint64_t a0 = g_allocs.load(std::memory_order_relaxed);
+        const auto t0 = std::chrono::steady_clock::now();
+        if (step) step(f);
+        ui.update();
+        renderer.beginFrame();
+        renderer.clear(Color{24, 25, 34, 255});
+        ui.render();
+        renderer.endFrame();
+        const double ms = msSince(t0);
+        if (f < kWarmupFrames) continue;
+        const RendererStats st = renderer.getStats();
+        cpu    += st.cpuTimeMs;
+        gpu    += st.gpuTimeMs;
+        draws  += st.numDraw;
+        verts  += st.numVertices;
+        wall   += ms;
+        layout += ui.getLastLayoutMs();
+        allocs += g_allocs.load(std::memory_order_relaxed) - a0;
+    }
+    const double n = (double)frames;
+    return {
+        {"drawCalls", draws / n}, {"vertices", verts / n},
+        {"cpuMs", cpu / n}, {"gpuMs", gpu / n}, {"frameMs", wall / n}, {"layoutMs", layout / n},
+        {"allocsPerFrame", (double)allocs / n}, {"peakRssKb", peakRssKb()},
+    };
+}
+
+// ---- Scenarios ---------------------------------------------------------------
+
+// render_bench's tree: a 30x30 grid of colored rows under two labels.
+Container* gridTree() {
+    constexpr int kRows = 30, kCols = 30;
+    Column* root = column(Modifier().setOuterPadding(4.f), ColumnOptions().setColor(Color{24, 25, 34, 255}));
+    root->addElement(text(Modifier().setHeight(Dimension{24.f, false}),
+                          TextOptions().setContent("The quick brown fox jumps over the lazy dog 0123456789")
+                                       .setCharSize(18).setColor(Color::White)));
+    for (int r = 0; r < kRows; ++r) {
+        Row* rowEl = row(Modifier().setHeight(Dimension{100.f / kRows, true}).setOuterPadding(1.f), RowOptions());
+        for (int c = 0; c < kCols; ++c)
+            rowEl->addElement(row(Modifier().setWidth(Dimension{100.f / kCols, true}).setOuterPadding(1.f),
+                                  RowOptions().setColor(Color{(uint8_t)(40 + (r * 7 + c * 13) % 180),
+                                                              (uint8_t)(40 + (r * 11 + c * 5) % 180),
+                                                              (uint8_t)(60 + (r * 3 + c * 17) % 160), 255})
+                                              .setRounding((r + c) % 3 == 0 ? 4.f : 0.f)));
+        root->addElement(rowEl);
+    }
+    return root;
+}
+
+Metrics scenarioRender(Renderer& renderer, int frames) {
+    UILO ui;
+    ui.setRenderer(renderer);
+    ui.addPage(page(gridTree(), "main"));
+    ui.setPage("main");
+    return runFrames(renderer, ui, frames, {});
+}
+
+// The same grid, laid out from scratch every frame.
+Metrics scenarioLayout(Renderer& renderer, int frames) {
+    UILO ui;
+    ui.setRenderer(renderer);
+    ui.addPage(page(gridTree(), "main"));
+    ui.setPage("main");
+    return runFrames(renderer, ui, frames, [&](int) { ui.markTreeDirty(); });
+}
+
+// 40 x 10 labels; a quarter of them change text every frame, so shaping,
+// glyph lookup and the text batch all run.
+Metrics scenarioText(Renderer& renderer, int frames) {
+    constexpr int kLines = 40, kPerLine = 10;
+    UILO ui;
+    ui.setRenderer(renderer);
+    Column* root = column(Modifier(), ColumnOptions().setColor(Color{24, 25, 34, 255}));
+    std::vector<Text*> labels;
+    for (int l = 0; l < kLines; ++l) {
+        Row* line = row(Modifier().setHeight(Dimension{100.f / kLines, true}), RowOptions());
+        for (int i = 0; i < kPerLine; ++i) {
+            Text* t = text(Modifier().setWidth(Dimension{100.f / kPerLine, true}),
+                           TextOptions().setContent("Param " + std::to_string(l * kPerLine + i))
+                                        .setCharSize(12).setColor(Color{200, 210, 230, 255}));
+            labels.push_back(t);
+            line->addElement(t);
+        }
+        root->addElement(line);
+    }
+    ui.addPage(page(root, "main"));
+    ui.setPage("main");
+    return runFrames(renderer, ui, frames, [&](int f) {
+        for (size_t i = (size_t)(f % 4); i < labels.size(); i += 4)
+            labels[i]->setString(std::to_string(f * 31 + (int)i) + " dB");
+    });
+}
+
+// Four stereo lanes of a minute of synthetic audio in the three styles,
+// scrolled every frame so the column peaks are rebuilt.
+Metrics scenarioWaveform(Renderer& renderer, int frames) {
+    constexpr size_t kFrames = 48000 * 60;
+    std::vector<float> left(kFrames), right(kFrames);
+    for (size_t i = 0; i < kFrames; ++i) {
+        left[i]  = 0.8f * std::sin((float)i * 0.011f) * std::sin((float)i * 0.00003f);
+        right[i] = 0.6f * std::sin((float)i * 0.017f + 1.f);
+    }
+    const float* channels[2] = { left.data(), right.data() };
+
+    UILO ui;
+    ui.setRenderer(renderer);
+    Column* root = column(Modifier(), ColumnOptions().setColor(Color{24, 25, 34, 255}));
+    const WaveformStyle styles[4] = { WaveformStyle::Bars, WaveformStyle::Line,
+                                      WaveformStyle::Filled, WaveformStyle::Line };
+    std::vector<Waveform*> lanes;
+    for (int i = 0; i < 4; ++i) {
+        Waveform* w = waveform(Modifier().setHeight(Dimension{25.f, true}),
+                               WaveformOptions().setStyle(styles[i]).setGpuPeaks(i == 3));
+        w->setSamples(channels, 2, kFrames);
+        lanes.push_back(w);
+        root->addElement(w);
+    }
+    ui.addPage(page(root, "main"));
+    ui.setPage("main");
+    return runFrames(renderer, ui, frames, [&](int f) {
+        const size_t first = (size_t)f * 4800 % (kFrames / 2);
+        for (Waveform* w : lanes) w->setRange(first, kFrames / 2);
+    });
+}
+
+// Init to first presented frame on a renderer of its own, averaged.
+Metrics scenarioStartup(int runs) {
+    RendererStartupStats sum;
+    for (int i = 0; i < runs; ++i) {
+        Renderer r;
+        if (!r.initHeadless(1000, 700)) return {};
+        r.beginFrame();
+        r.clear(Color{24, 25, 34, 255});
+        r.endFrame();
+        const RendererStartupStats st = r.getStartupStats();
+        sum.contextMs    += st.contextMs;
+        sum.resourcesMs  += st.resourcesMs;
+        sum.firstFrameMs += st.firstFrameMs;
+        r.shutdown();
+    }
+    const double n = (double)runs;
+    return {
+        {"contextMs", sum.contextMs / n}, {"resourcesMs", sum.resourcesMs / n},
+        {"firstFrameMs", sum.firstFrameMs / n}, {"peakRssKb", peakRssKb()},
+    };
+}
+
+// ---- Baseline file -------------------------------------------------------------
+// {"scenarios": {"<name>": {"<metric>": <number>, ...}, ...},
+//  "tolerances": {"<metric>": <fraction>, ...}}
+
+struct Baseline {
+    Results                       scenarios;
+    std::map<std::string, double> tolerances;
+};
+
+bool writeBaseline(const std::string& path, const Results& results,
+                   const std::map<std::string, double>& tolerances) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "perf_gate: can't open '%s' for writing\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "{\n  \"scenarios\": {\n");
+    size_t si = 0;
+    for (const auto& [name, metrics] : results) {
+        std::fprintf(f, "    \"%s\": {", name.c_str());
+        size_t mi = 0;
+        for (const auto& [metric, value] : metrics)
+            std::fprintf(f, "%s\"%s\": %.6g", mi++ ? ", " : " ", metric.c_str(), value);
+        std::fprintf(f, " }%s\n", ++si < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  },\n  \"tolerances\": {");
+    size_t ti = 0;
+    for (const auto& [metric, tol] : tolerances)
+        std::fprintf(f, "%s\"%s\": %.6g", ti++ ? ", " : " ", metric.c_str(), tol);
+    std::fprintf(f, " }\n}\n");
+    return std::fclose(f) == 0;
+}
+
+// Just enough JSON for the format above: nested objects of numbers.
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view s) : m_s(s) {}
+
+    bool readBaseline(Baseline& out) {
+        return object([&](const std::string& section) {
+            if (section == "scenarios")
+                return object([&](const std::string& name) {
+                    return object([&](const std::string& metric) {
+                        return number(out.scenarios[name][metric]);
+                    });
+                });
+            if (section == "tolerances")
+                return object([&](const std::string& metric) { return number(out.tolerances[metric]); });
+            return false;
+        }) && (skipSpace(), m_i == m_s.size());
+    }
+
+private:
+    void skipSpace() { while (m_i < m_s.size() && std::strchr(" \t\r\n", m_s[m_i])) ++m_i; }
+    bool eat(char c) {
+        skipSpace();
+        if (m_i >= m_s.size() || m_s[m_i] != c) return false;
+        ++m_i;
+        return true;
+    }
+    bool string(std::string& out) {
+        if (!eat('"')) return false;
+        const size_t end = m_s.find('"', m_i);
+        if (end == std::string_view::npos) return false;
+        out.assign(m_s.substr(m_i, end - m_i));
+        m_i = end + 1;
+        return true;
+    }
+    bool number(double& out) {
+        skipSpace();
+        const std::string tail(m_s.substr(m_i, std::min<size_t>(32, m_s.size() - m_i)));
+        char* end = nullptr;
+        out = std::strtod(tail.c_str(), &end);
+        if (end == tail.c_str()) return false;
+        m_i += (size_t)(end - tail.c_str());
+        return true;
+    }
+    bool object(const std::function<bool(const std::string&)>& member) {
+        if (!eat('{')) return false;
+        if (eat('}')) return true;
+        do {
+            std::string key;
+            if (!string(key) || !eat(':') || !member(key)) return false;
+        } while (eat(','));
+        return eat('}');
+    }
+
+    std::string_view m_s;
+    size_t           m_i = 0;
+};
+
+bool readBaseline(const std::string& path, Baseline& out) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        std::fprintf(stderr, "perf_gate: no baseline at '%s' (run with record=<file> first)\n", path.c_str());
+        return false;
+    }
+    std::string text;
+    char buf[4096];
+    for (size_t n; (n = std::fread(buf, 1, sizeof(buf), f)) > 0;) text.append(buf, n);
+    std::fclose(f);
+    if (!JsonReader(text).readBaseline(out)) {
+        std::fprintf(stderr, "perf_gate: '%s' is not a perf_gate baseline\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Prints every metric against its budget; true when all are within.
+bool compare(const Results& results, const Baseline& base,
+             const std::map<std::string, double>& overrides) {
+    bool ok = true;
+    for (const auto& [name, metrics] : results) {
+        auto b = base.scenarios.find(name);
+        if (b == base.scenarios.end()) {
+            std::printf("perf_gate: %-9s not in the baseline, skipped\n", name.c_str());
+            continue;
+        }
+        for (const auto& [metric, value] : metrics) {
+            auto bm = b->second.find(metric);
+            if (bm == b->second.end()) continue;
+            Tolerance tol = defaultTolerance(metric);
+            if (auto t = base.tolerances.find(metric); t != base.tolerances.end()) tol.fraction = t->second;
+            if (auto t = overrides.find(metric);       t != overrides.end())       tol.fraction = t->second;
+            const double budget = bm->second * (1.0 + tol.fraction) + tol.slack;
+            const bool   over   = value > budget;
+            ok = ok && !over;
+            std::printf("perf_gate: %-9s %-15s %12.3f  baseline %12.3f  budget %12.3f  %s\n",
+                        name.c_str(), metric.c_str(), value, bm->second, budget, over ? "OVER" : "ok");
+        }
+    }
+    return ok;
+}
+
+} // anon
+
+int main(int argc, char** argv) {
+    std::string recordPath, comparePath;
+    int frames = 300;
+    std::vector<std::string> scenarios = { "render", "layout", "text", "waveform", "startup" };
+    std::map<std::string, double> tolerances;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        const size_t eq = arg.find('=');
+        const std::string key(arg.substr(0, eq));
+        const std::string val(eq == std::string_view::npos ? std::string_view{} : arg.substr(eq + 1));
+        if      (key == "record")  recordPath  = val;
+        else if (key == "compare") comparePath = val;
+        else if (key == "frames")  frames = std::max(1, std::atoi(val.c_str()));
+        else if (key == "scenarios") {
+            scenarios.clear();
+            for (size_t p = 0; p <= val.size();) {
+                const size_t c = std::min(val.find(',', p), val.size());
+                if (c > p) scenarios.push_back(val.substr(p, c - p));
+                p = c + 1;
+            }
+        } else if (key.rfind("tol.", 0) == 0 && key.size() > 4) {
+            tolerances[key.substr(4)] = std::atof(val.c_str());
+        } else {
+            std::fprintf(stderr, "unknown argument '%s'\n"
+                "usage: perf_gate [record=<file>] [compare=<file>] [frames=<n>] [scenarios=<a,b,..>] [tol.<metric>=<fraction>]\n",
+                argv[i]);
+            return 1;
+        }
+    }
+
+    Baseline base;
+    if (!comparePath.empty() && !readBaseline(comparePath, base)) return 2;
+
+    auto wants = [&](const char* s) { return std::find(scenarios.begin(), scenarios.end(), s) != scenarios.end(); };
+    Results results;
+    // Startup first, before the shared renderer's resources are around.
+    if (wants("startup")) results["startup"] = scenarioStartup(5);
+    {
+        Renderer renderer;
+        if (!renderer.initHeadless(1000, 700)) {
+            std::fprintf(stderr, "Failed to initialize renderer\n");
+            return 1;
+        }
+        if (wants("render"))   results["render"]   = scenarioRender(renderer, frames);
+        if (wants("layout"))   results["layout"]   = scenarioLayout(renderer, frames);
+        if (wants("text"))     results["text"]     = scenarioText(renderer, frames);
+        if (wants("waveform")) results["waveform"] = scenarioWaveform(renderer, frames);
+    }
+
+    bool ok = true;
+    if (!comparePath.empty()) {
+        ok = compare(results, base, tolerances);
+    } else {
+        for (const auto& [name, metrics] : results)
+            for (const auto& [metric, value] : metrics)
+                std::printf("perf_gate: %-9s %-15s %12.3f\n", name.c_str(), metric.c_str(), value);
+    }
+    if (!recordPath.empty()) {
+        // Keep the tolerances a previous baseline was tuned with: the one
+        // compared against, else the one being replaced (perf_record only
+        // passes record=).
+        std::map<std::string, double> keep = base.tolerances;
+        if (recordPath != comparePath) {
+            if (std::FILE* f = std::fopen(recordPath.c_str(), "rb")) {
+                std::fclose(f);
+                Baseline old;
+                if (readBaseline(recordPath, old)) keep.insert(old.tolerances.begin(), old.tolerances.end());
+            }
+        }
+        for (const auto& [metric, tol] : tolerances) keep[metric] = tol;
+        if (!writeBaseline(recordPath, results, keep)) return 2;
+        std::printf("perf_gate: baseline written to %s\n", recordPath.c_str());
+    }
+    if (!ok) std::printf("perf_gate: FAILED, over budget\n");
+    return ok ? 0 : 1;
+}
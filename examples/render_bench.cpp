@@ -6,25 +6,94 @@
 // pixel-identity screenshots.
 //
 // Usage: render_bench [vsync=true|false] [hold=true|false] [duration=<sec>]
+//                     [labels=<n>] [retained=true|false] [threads=<n>]
+//                     [flat=true|false] [instanced=true|false]
+//                     [indexedclips=true|false] [msaa=<n>] [aa=true|false]
+//                     [fps=<n>] [lateinput=true|false] [trace=<file>]
+//                     [headless=true|false] [capture=<file.ppm>]
 //   vsync    - present with vsync (default true)
 //   hold     - keep the window open indefinitely, e.g. for screenshots
 //              (default false; bare "hold" also accepted)
 //   duration - measurement length in seconds (default 5)
+//   labels   - add a strip of <n> small text labels under the grid, like a
+//              dense parameter panel, to exercise text batching (default 0)
+//   retained - record the whole tree into a retained draw list and replay
+//              it while nothing changes (default false)
+//   threads  - lay out grid rows on <n> worker threads (default 0)
+//   flat     - solve the Column/Row grid with the data-oriented FlatLayout
+//              pass instead of recursive update() calls (default false)
+//   instanced - draw rects / rounded rects / circles through the instanced
+//               shape batch where supported (default true)
+//   indexedclips - clip through the indexed clip table instead of the clip
+//                  uniforms, where supported (default false)
+//   msaa     - backbuffer MSAA samples, 1 for none (default 8)
+//   aa       - analytic edge AA for rects (default true)
+//   fps      - framerate limit, 0 for none (default 0)
+//   lateinput - sample input just before the frame deadline; needs fps
+//               (default false)
+//   trace    - record trace zones and write them to <file> as Chrome /
+//              Perfetto JSON on exit (default none)
+//   headless - render offscreen without a window (Renderer::initHeadless);
+//              vsync and msaa don't apply (default false)
+//   capture  - headless only: read the last measured frame back and write
+//              it to <file> as binary PPM, for pixel-identity checks
+//              (default none)
 // Arguments may appear in any order.
 #include "../include/UILO.hpp"
 #include "../include/renderer/Renderer.hpp"
+#include "../include/utils/Trace.hpp"
 #include <SDL3/SDL.h>
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <string>
 #include <string_view>
 
 using namespace uilo;
 
+namespace {
+
+// Binary PPM: no alpha and no dependencies, and any image tool can diff it.
+bool writePpm(const std::string& path, const uint8_t* bgra, uint32_t w, uint32_t h) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "render_bench: can't open '%s' for writing\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "P6\n%u %u\n255\n", w, h);
+    std::string row(size_t(w) * 3, '\0');
+    for (uint32_t y = 0; y < h; ++y) {
+        const uint8_t* src = bgra + size_t(y) * w * 4;
+        for (uint32_t x = 0; x < w; ++x) {
+            row[x * 3 + 0] = (char)src[x * 4 + 2];
+            row[x * 3 + 1] = (char)src[x * 4 + 1];
+            row[x * 3 + 2] = (char)src[x * 4 + 0];
+        }
+        std::fwrite(row.data(), 1, row.size(), f);
+    }
+    return std::fclose(f) == 0;
+}
+
+} // namespace
+
 int main(int argc, char** argv) {
     bool   vsync    = true;
     bool   hold     = false;
     double duration = 5.0;
+    int    labels   = 0;
+    bool   retained = false;
+    int    threads  = 0;
+    bool   flat     = false;
+    bool   instanced = true;
+    bool   indexedClips = false;
+    int    msaa     = 8;
+    bool   analyticAA = true;
+    float  fps      = 0.f;
+    bool   lateInput = false;
+    std::string tracePath;
+    bool   headless = false;
+    std::string capturePath;
 
     for (int i = 1; i < argc; ++i) {
         const std::string_view arg{argv[i]};
@@ -32,7 +101,7 @@ int main(int argc, char** argv) {
         if (eq == std::string_view::npos) {
             if (arg == "hold") { hold = true; continue; }
             std::fprintf(stderr, "unknown argument '%s'\n"
-                "usage: render_bench [vsync=true|false] [hold=true|false] [duration=<sec>]\n",
+                "usage: render_bench [vsync=true|false] [hold=true|false] [duration=<sec>] [labels=<n>] [retained=true|false] [threads=<n>] [flat=true|false]\n",
                 argv[i]);
             return 1;
         }
@@ -42,29 +111,59 @@ int main(int argc, char** argv) {
         if      (key == "vsync")    vsync = truthy;
         else if (key == "hold")     hold  = truthy;
         else if (key == "duration") duration = std::atof(std::string(val).c_str());
+        else if (key == "labels")   labels   = std::atoi(std::string(val).c_str());
+        else if (key == "retained") retained = truthy;
+        else if (key == "threads")  threads  = std::atoi(std::string(val).c_str());
+        else if (key == "flat")     flat     = truthy;
+        else if (key == "instanced") instanced = truthy;
+        else if (key == "indexedclips") indexedClips = truthy;
+        else if (key == "msaa")     msaa = std::atoi(std::string(val).c_str());
+        else if (key == "aa")       analyticAA = truthy;
+        else if (key == "fps")      fps = (float)std::atof(std::string(val).c_str());
+        else if (key == "lateinput") lateInput = truthy;
+        else if (key == "trace")    tracePath = std::string(val);
+        else if (key == "headless") headless  = truthy;
+        else if (key == "capture")  capturePath = std::string(val);
         else {
             std::fprintf(stderr, "unknown argument '%s'\n"
-                "usage: render_bench [vsync=true|false] [hold=true|false] [duration=<sec>]\n",
+                "usage: render_bench [vsync=true|false] [hold=true|false] [duration=<sec>] [labels=<n>] [retained=true|false] [threads=<n>] [flat=true|false]\n",
                 argv[i]);
             return 1;
         }
     }
     if (duration <= 0.0) duration = 5.0;
+    if (labels < 0) labels = 0;
+    if (threads < 0) threads = 0;
+    if (msaa < 1) msaa = 1;
 
     Renderer renderer;
-    if (!renderer.init(1000, 700, "UILO render bench", 8)) {
+    const bool ok = headless ? renderer.initHeadless(1000, 700)
+                             : renderer.init(1000, 700, "UILO render bench", (uint8_t)std::min(msaa, 16));
+    if (!ok) {
         std::fprintf(stderr, "Failed to initialize renderer\n");
         return 1;
     }
     renderer.setVsync(vsync);
+    renderer.setInstancedShapes(instanced);
+    renderer.setIndexedClips(indexedClips);
+    renderer.setAnalyticAA(analyticAA);
+    renderer.setFramerateLimit(fps);
+    renderer.setLateInputSampling(lateInput);
+    if (!tracePath.empty()) {
+        Trace::setThreadName("main");
+        Trace::setEnabled(true);
+    }
 
     UILO ui;
     ui.setRenderer(renderer);
+    // Each grid row is a subtree of kCols + 1 elements.
+    if (threads > 0) ui.setLayoutThreads((unsigned)threads, 16);
+    ui.setFlatLayout(flat);
 
     constexpr int kRows = 30, kCols = 30;
     Column* root = column(
         Modifier().setOuterPadding(4.f),
-        ColumnOptions().setColor(Color{24, 25, 34, 255}));
+        ColumnOptions().setColor(Color{24, 25, 34, 255}).setRetained(retained));
     root->addElement(text(
         Modifier().setHeight(Dimension{24.f, false}),
         TextOptions().setContent("The quick brown fox jumps over the lazy dog 0123456789")
@@ -88,6 +187,20 @@ int main(int argc, char** argv) {
         }
         root->addElement(rowEl);
     }
+    if (labels > 0) {
+        // All labels share the strip's clip and font atlas, so with text
+        // batching the whole strip costs a single draw call.
+        Row* strip = row(Modifier().setHeight(Dimension{16.f, false}), RowOptions());
+        char buf[16];
+        for (int i = 0; i < labels; ++i) {
+            std::snprintf(buf, sizeof(buf), "P%02d", i);
+            strip->addElement(text(
+                Modifier().setWidth(Dimension{100.f / labels, true}),
+                TextOptions().setContent(buf).setCharSize(10)
+                             .setColor(Color{180, 190, 210, 255})));
+        }
+        root->addElement(strip);
+    }
 
     ui.addPage(page(root, "main"));
     ui.setPage("main");
@@ -99,11 +212,15 @@ int main(int argc, char** argv) {
     auto tMeasureStart = tStart;
     double   cpuSum   = 0.0;
     uint32_t drawLast = 0;
+    uint32_t culledLast = 0;
+    uint32_t rejectedLast = 0;
+    RendererStats pacing;
     long     measured = 0;
     long     frame    = 0;
 
     bool running = true;
     while (running) {
+        renderer.waitForInputDeadline();
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_EVENT_QUIT) running = false;
@@ -121,6 +238,9 @@ int main(int argc, char** argv) {
             RendererStats st = renderer.getStats();
             cpuSum  += st.cpuTimeMs;
             drawLast = st.numDraw;
+            culledLast = st.culledElements;
+            rejectedLast = st.rejectedDraws;
+            pacing = st;
             ++measured;
         }
 
@@ -135,9 +255,33 @@ int main(int argc, char** argv) {
         const double measuredSec =
             std::chrono::duration<double>(clock::now() - tMeasureStart).count();
         const double avgFps = measuredSec > 0.0 ? (double)measured / measuredSec : 0.0;
-        std::printf("render_bench: vsync=%s drawCalls=%u avgFps=%.1f avgCpuMs=%.3f frames=%ld (%.1fs)\n",
-                    vsync ? "on" : "off", drawLast, avgFps,
-                    cpuSum / (double)measured, measured, measuredSec);
+        std::printf("render_bench: vsync=%s msaa=%d aa=%s labels=%d retained=%s drawCalls=%u culled=%u rejected=%u avgFps=%.1f avgCpuMs=%.3f frames=%ld (%.1fs)\n"
+                    "render_bench: fps=%.0f lateinput=%s frameMs=%.3f+-%.3f costMs=%.3f inputLatencyMs=%.3f\n",
+                    vsync ? "on" : "off", msaa, analyticAA ? "on" : "off", labels, retained ? "on" : "off", drawLast, culledLast, rejectedLast, avgFps,
+                    cpuSum / (double)measured, measured, measuredSec,
+                    fps, lateInput ? "on" : "off", pacing.frameTimeMeanMs, pacing.frameTimeStdDevMs,
+                    pacing.frameCostMs, pacing.inputLatencyMs);
+    }
+    if (!capturePath.empty()) {
+        bool delivered = false, written = false;
+        const bool queued = renderer.requestReadback(
+            [&](const uint8_t* bgra, uint32_t w, uint32_t h) {
+                delivered = true;
+                written   = writePpm(capturePath, bgra, w, h);
+            });
+        // Keep drawing the same tree until the GPU hands the copy back.
+        for (int i = 0; queued && !delivered && i < 8; ++i) {
+            ui.update();
+            renderer.beginFrame();
+            renderer.clear(Color{24, 25, 34, 255});
+            ui.render();
+            renderer.endFrame();
+        }
+        if (!written) {
+            std::fprintf(stderr, "render_bench: capture to '%s' failed\n", capturePath.c_str());
+            return 1;
+        }
     }
+    if (!tracePath.empty() && !Trace::dumpChromeJson(tracePath)) return 1;
     return 0;
 }
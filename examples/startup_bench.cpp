@@ -0,0 +1,89 @@
+// Startup bench: how long from Renderer::init() to the first presented
+// frame, split into window, bgfx context and GPU resources, then what the
+// first glass panel costs (its programs are created on first use).
+//
+// Usage: startup_bench [headless=true|false] [runs=<n>]
+//   headless - render offscreen without a window (default false)
+//   runs     - init / first frame / shutdown cycles to average (default 5)
+// Arguments may appear in any order.
+#include "../include/renderer/Renderer.hpp"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+using namespace uilo;
+
+namespace {
+
+double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void drawPlainFrame(Renderer& renderer) {
+    renderer.beginFrame();
+    renderer.clear(Color{30, 31, 40, 255});
+    renderer.draw(Rect{{ 50.f, 50.f}, {300.f, 120.f}, Color{60, 120, 200, 255}});
+    renderer.draw(Rect{{400.f, 50.f}, {300.f, 120.f}, Color{200, 120, 60, 255}});
+    renderer.endFrame();
+}
+
+} // anon
+
+int main(int argc, char** argv) {
+    bool headless = false;
+    int  runs     = 5;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if      (arg == "headless=true")  headless = true;
+        else if (arg == "headless=false") headless = false;
+        else if (arg.rfind("runs=", 0) == 0) runs = std::max(1, std::atoi(argv[i] + 5));
+        else {
+            std::fprintf(stderr, "unknown argument '%s'\n"
+                         "usage: startup_bench [headless=true|false] [runs=<n>]\n", argv[i]);
+            return 1;
+        }
+    }
+
+    RendererStartupStats sum;
+    double glassMs = 0.0;
+    for (int run = 0; run < runs; ++run) {
+        Renderer renderer;
+        const bool ok = headless ? renderer.initHeadless(800, 600)
+                                 : renderer.init(800, 600, "startup_bench", 4);
+        if (!ok) {
+            std::fprintf(stderr, "Failed to initialize renderer\n");
+            return 1;
+        }
+        drawPlainFrame(renderer);
+        const RendererStartupStats st = renderer.getStartupStats();
+        sum.windowMs     += st.windowMs;
+        sum.contextMs    += st.contextMs;
+        sum.resourcesMs  += st.resourcesMs;
+        sum.firstFrameMs += st.firstFrameMs;
+
+        // First glass frame: glass, blur and ladder programs get built here.
+        const auto t0 = std::chrono::steady_clock::now();
+        renderer.beginFrame();
+        renderer.clear(Color{30, 31, 40, 255});
+        renderer.drawGlass(Rectf{{100.f, 100.f}, {300.f, 200.f}}, Material::Blur().setRadius(8.f),
+                           Color{60, 60, 90, 180});
+        renderer.endFrame();
+        glassMs += msSince(t0);
+
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {}
+        renderer.shutdown();
+    }
+
+    const float n = (float)runs;
+    std::printf("startup_bench: headless=%s runs=%d window=%.2fms context=%.2fms resources=%.2fms "
+                "firstFrame=%.2fms firstGlassFrame=%.2fms\n",
+                headless ? "true" : "false", runs,
+                sum.windowMs / n, sum.contextMs / n, sum.resourcesMs / n,
+                sum.firstFrameMs / n, glassMs / runs);
+    return 0;
+}
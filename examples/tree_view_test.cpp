@@ -0,0 +1,92 @@
+// Drives a TreeView over a synthetic million-node tree (100 x 100 x 100)
+// whose provider answers synchronously, and one that answers later, and
+// checks that expand / collapse only touch the visible rows, that
+// collapsed branches are released, and that rows stay in pre-order.
+#include "../include/UILO.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace uilo;
+
+namespace {
+
+constexpr uint64_t kFanout = 100;
+constexpr int      kDepth  = 3;
+
+// Node id encodes its path: level in the top byte, index below.
+uint64_t makeId(int level, uint64_t index) { return ((uint64_t)level << 56) | index; }
+int      levelOf(uint64_t id)              { return (int)(id >> 56); }
+uint64_t indexOf(uint64_t id)              { return id & ((1ull << 56) - 1); }
+
+std::vector<TreeNodeInfo> childrenOf(uint64_t parent) {
+    const int      level = parent == TreeView::kRoot ? 0 : levelOf(parent) + 1;
+    const uint64_t base  = parent == TreeView::kRoot ? 0 : indexOf(parent) * kFanout;
+    std::vector<TreeNodeInfo> out;
+    out.reserve(kFanout);
+    for (uint64_t i = 0; i < kFanout; ++i)
+        out.push_back({ makeId(level, base + i), "node " + std::to_string(base + i), level + 1 < kDepth });
+    return out;
+}
+
+int fail(const char* what) {
+    std::fprintf(stderr, "tree_view_test: %s\n", what);
+    return 1;
+}
+
+double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // anon
+
+int main() {
+    // --- Synchronous provider ---
+    TreeView* tree = treeView(Modifier(), TreeViewOptions()
+        .setReleaseCollapsed(true)
+        .setFetchChildren([](TreeView& tv, uint64_t parent) { tv.setChildren(parent, childrenOf(parent)); }));
+
+    tree->reload();                                 // top level
+    if (tree->getVisibleCount() != kFanout) return fail("top level not listed");
+
+    // Open every top-level node and the first child of each: 100 + 100*100 + 100*100 rows.
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < kFanout; ++i) {
+        tree->expand(makeId(0, i));
+        tree->expand(makeId(1, i * kFanout));
+    }
+    const double expandMs = msSince(t0);
+    const size_t expected = kFanout + kFanout * kFanout + kFanout * kFanout;
+    if (tree->getVisibleCount() != expected) return fail("wrong row count after expand");
+
+    // Collapse a branch in the middle: its 100 + 100 rows go, its nodes are freed.
+    const size_t nodesBefore = tree->getNodeCount();
+    tree->collapse(makeId(0, 50));
+    if (tree->getVisibleCount() != expected - 2 * kFanout) return fail("collapse removed the wrong rows");
+    if (tree->getNodeCount() != nodesBefore - 2 * kFanout) return fail("collapsed branch not released");
+
+    // Re-expanding fetches again; the grandchild branch stays closed.
+    tree->expand(makeId(0, 50));
+    if (tree->getVisibleCount() != expected - kFanout) return fail("re-expand row count");
+
+    // --- Asynchronous provider: answers arrive later, in any order ---
+    std::vector<uint64_t> asked;
+    TreeView* lazy = treeView(Modifier(), TreeViewOptions()
+        .setFetchChildren([&](TreeView&, uint64_t parent) { asked.push_back(parent); }));
+    lazy->reload();
+    if (!lazy->isLoading(TreeView::kRoot) || lazy->getVisibleCount() != 0) return fail("root should be pending");
+    lazy->setChildren(TreeView::kRoot, childrenOf(TreeView::kRoot));
+    lazy->expand(makeId(0, 3));
+    lazy->expand(makeId(0, 1));
+    if (!lazy->isLoading(makeId(0, 3))) return fail("child should be pending");
+    lazy->setChildren(makeId(0, 3), childrenOf(makeId(0, 3)));
+    lazy->setChildren(makeId(0, 1), childrenOf(makeId(0, 1)));
+    if (lazy->getVisibleCount() != 3 * kFanout) return fail("late children not spliced in");
+    if (asked.size() != 3) return fail("provider asked the wrong number of times");
+
+    std::printf("tree_view_test: OK (%zu rows, 200 expands in %.2f ms)\n", expected, expandMs);
+    delete tree;
+    delete lazy;
+    return 0;
+}
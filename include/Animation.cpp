@@ -0,0 +1,156 @@
+#include "Animation.hpp"
+#include "UILO.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace uilo {
+
+float ease(Easing easing, float t) {
+    t = std::clamp(t, 0.f, 1.f);
+    switch (easing) {
+        case Easing::Linear:    return t;
+        case Easing::EaseIn:    return t * t * t;
+        case Easing::EaseOut:   { const float u = 1.f - t; return 1.f - u * u * u; }
+        case Easing::EaseInOut: {
+            if (t < 0.5f) return 4.f * t * t * t;
+            const float u = -2.f * t + 2.f;
+            return 1.f - u * u * u * 0.5f;
+        }
+        case Easing::Back: {
+            constexpr float c1 = 1.70158f;
+            constexpr float c3 = c1 + 1.f;
+            const float u = t - 1.f;
+            return 1.f + c3 * u * u * u + c1 * u * u;
+        }
+    }
+    return t;
+}
+
+Color lerp(Color a, Color b, float t) {
+    auto channel = [t](uint8_t x, uint8_t y) {
+        return (uint8_t)std::clamp(std::lround(lerp((float)x, (float)y, t)), 0l, 255l);
+    };
+    return { channel(a.r, b.r), channel(a.g, b.g), channel(a.b, b.b), channel(a.a, b.a) };
+}
+
+
+/*
+    start(UILO& ui, Element* target, Tween tween):
+    - Params:   UILO& ui, Element* target, Tween tween
+    - Returns:  TweenId
+    - Desc:     Queues a tween on `target`; it first applies on the next
+                step(), from its start: that step's dt (which in on-demand
+                mode spans the idle wait before the event that started it)
+                doesn't count. Started from inside a step (an apply or
+                onDone callback) it waits in m_started so the running array
+                isn't reallocated under the loop.
+*/
+TweenId Animator::start(UILO& ui, Element* target, Tween tween) {
+    if (!target || !tween.apply) return {};
+    const ElementHandle handle = ui.getHandle(target);
+    if (!handle) return {};
+    Running r;
+    r.id     = TweenId{ m_nextId++ };
+    r.target = handle;
+    r.tween  = std::move(tween);
+    const TweenId id = r.id;
+    (m_stepping ? m_started : m_tweens).push_back(std::move(r));
+    return id;
+}
+
+
+/*
+    cancel(TweenId id):
+    - Params:   TweenId id
+    - Returns:  void
+    - Desc:     Stops a tween where it is, without running onDone. Safe from
+                inside a callback; the slot is compacted out after the step.
+*/
+void Animator::cancel(TweenId id) {
+    if (!id) return;
+    for (auto& r : m_tweens)  if (r.id == id) r.done = true;
+    for (auto& r : m_started) if (r.id == id) r.done = true;
+}
+
+
+void Animator::cancelAll(UILO& ui, const Element* target) {
+    const ElementHandle handle = ui.getHandle(target);
+    if (!handle) return;
+    for (auto& r : m_tweens)  if (r.target == handle) r.done = true;
+    for (auto& r : m_started) if (r.target == handle) r.done = true;
+}
+
+
+float Animator::nextFrameIn() const {
+    float wait = -1.f;
+    auto scan = [&](const std::vector<Running>& v) {
+        for (const auto& r : v) {
+            if (r.done) continue;
+            const float left = std::max(0.f, r.tween.delay - r.elapsed);
+            if (wait < 0.f || left < wait) wait = left;
+        }
+    };
+    scan(m_tweens);
+    scan(m_started);
+    return std::max(0.f, wait);
+}
+
+
+/*
+    step(UILO& ui, float dt):
+    - Params:   UILO& ui, float dt
+    - Returns:  void
+    - Desc:     Advances every running tween by dt (tweens started since
+                the last step stay at their start), applies its eased
+                progress and dirties its target: markDirty() when the tween
+                affects layout, the target's own dirty flag (repaint only)
+                otherwise. Finished tweens run onDone and, with cancelled
+                ones and those whose target was freed, are compacted out.
+*/
+void Animator::step(UILO& ui, float dt) {
+    if (m_tweens.empty() && m_started.empty()) return;
+    m_stepping = true;
+    for (size_t i = 0; i < m_tweens.size(); ++i) {
+        Running& r = m_tweens[i];
+        if (r.done) continue;
+        Element* e = ui.resolve(r.target);
+        if (!e) { r.done = true; continue; }
+
+        if (r.fresh) r.fresh = false;
+        else         r.elapsed += dt;
+        const Tween& tw = r.tween;
+        if (r.elapsed < tw.delay) continue;
+
+        const float t = tw.duration > 0.f
+            ? std::min(1.f, (r.elapsed - tw.delay) / tw.duration) : 1.f;
+        tw.apply(e, ease(tw.easing, r.reverse ? 1.f - t : t));
+        if (tw.affectsLayout) e->markDirty();
+        else                  e->m_dirty = true;
+
+        if (t < 1.f) continue;
+        if (tw.loop && !r.done) {
+            // The delay only holds off the first pass.
+            r.elapsed = tw.delay + (tw.duration > 0.f
+                ? std::fmod(r.elapsed - tw.delay, tw.duration) : 0.f);
+            if (tw.pingPong) r.reverse = !r.reverse;
+            continue;
+        }
+        const bool cancelled = r.done;
+        r.done = true;
+        if (!cancelled && tw.onDone) {
+            auto onDone = std::move(r.tween.onDone);
+            onDone(e);
+        }
+    }
+    m_stepping = false;
+
+    m_tweens.erase(std::remove_if(m_tweens.begin(), m_tweens.end(),
+                                  [](const Running& r) { return r.done; }),
+                   m_tweens.end());
+    for (auto& s : m_started)
+        if (!s.done) m_tweens.push_back(std::move(s));
+    m_started.clear();
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "elements/Element.hpp"
+#include "utils/Color.hpp"
+#include "utils/Math.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace uilo {
+
+class UILO;
+
+enum class Easing : uint8_t {
+    Linear,
+    EaseIn,         // cubic
+    EaseOut,
+    EaseInOut,
+    Back,           // overshoots slightly, then settles
+};
+
+// Maps linear progress t in [0, 1] through the curve.
+float ease(Easing easing, float t);
+
+inline float lerp(float a, float b, float t) { return a + (b - a) * t; }
+inline Vec2f lerp(Vec2f a, Vec2f b, float t) { return { lerp(a.x, b.x, t), lerp(a.y, b.y, t) }; }
+Color lerp(Color a, Color b, float t);
+
+// Identifies a running tween; 0 is "none".
+struct TweenId {
+    uint64_t value = 0;
+    explicit operator bool() const { return value != 0; }
+    bool operator==(const TweenId& o) const { return value == o.value; }
+};
+
+/*
+    Tween:
+    - Desc: One animation, handed to UILO::animate(). `apply` gets the
+            target and the eased progress each frame and writes whatever
+            it animates (an Options colour, a Modifier width, ...), lerping
+            with the helpers above. `affectsLayout` says whether that can
+            change layout: when false (colours, opacity, anything drawn
+            only) the target is just repainted, when true its layout runs
+            again too. `loop` restarts it on completion (with `pingPong`
+            running every other pass backwards) until cancelled; otherwise
+            `onDone` runs once after the final apply.
+*/
+struct Tween {
+    float    duration      = 0.25f;   // seconds
+    float    delay         = 0.f;
+    Easing   easing        = Easing::EaseInOut;
+    bool     affectsLayout = false;
+    bool     loop          = false;
+    bool     pingPong      = false;
+    std::function<void(Element*, float)> apply;
+    std::function<void(Element*)>        onDone;
+};
+
+/*
+    Animator:
+    - Desc: UILO's tween scheduler. Running tweens sit in one contiguous
+            array and are stepped once per update() with the frame's delta
+            time; each dirties only its own target, so nothing else is
+            touched and no element has to poll from onUpdateStart. Targets
+            are held by ElementHandle, so a tween whose element is freed
+            quietly ends. With nothing running it costs nothing and lets
+            on-demand mode skip idle frames.
+*/
+class Animator {
+public:
+    // Returns a null id when `target` has no handle (isn't owned by `ui`)
+    // or the tween has no apply function.
+    TweenId start(UILO& ui, Element* target, Tween tween);
+    void    cancel(TweenId id);
+    // Drops every tween on `target`.
+    void    cancelAll(UILO& ui, const Element* target);
+    void    step(UILO& ui, float dt);
+
+    bool   isActive()       const { return !m_tweens.empty() || !m_started.empty(); }
+    size_t getActiveCount() const { return m_tweens.size() + m_started.size(); }
+    // Seconds until some tween next needs a frame: 0 once any is past its
+    // delay, otherwise the shortest delay left.
+    float  nextFrameIn()    const;
+
+private:
+    struct Running {
+        TweenId       id;
+        ElementHandle target;
+        float         elapsed = 0.f;   // includes the delay
+        bool          reverse = false;
+        bool          done    = false;
+        bool          fresh   = true;    // not stepped yet
+        Tween         tween;
+    };
+
+    std::vector<Running> m_tweens;
+    std::vector<Running> m_started;    // added while stepping; merged after
+    uint64_t             m_nextId   = 1;
+    bool                 m_stepping = false;
+};
+
+}
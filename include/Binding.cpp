@@ -0,0 +1,49 @@
+#include "Binding.hpp"
+#include "UILO.hpp"
+
+#include <cstdio>
+
+namespace uilo {
+
+BindingBase::~BindingBase() {
+    if (UILO* ui = getUILO()) ui->removeBinding(this);
+}
+
+
+/*
+    attach(Element* element):
+    - Params:   Element* element
+    - Returns:  bool
+    - Desc:     Registers this binding with the element's UILO the first
+                time, so UILO::update() drains its mailbox. False when the
+                element has no handle yet or belongs to another UILO.
+*/
+bool BindingBase::attach(Element* element) {
+    UILO* ui = element->getUILO();
+    if (!ui || !element->getHandle()) {
+        std::fprintf(stderr, "[UILO] Binding: element is not attached to a UILO\n");
+        return false;
+    }
+    UILO* current = getUILO();
+    if (current == ui) return true;
+    if (current) {
+        std::fprintf(stderr, "[UILO] Binding: element belongs to a different UILO\n");
+        return false;
+    }
+    m_ui.store(ui, std::memory_order_release);
+    ui->addBinding(this);
+    return true;
+}
+
+
+Element* BindingBase::resolve(ElementHandle handle) const {
+    UILO* ui = getUILO();
+    return ui ? ui->resolve(handle) : nullptr;
+}
+
+
+void BindingBase::notifyPublished() const {
+    if (UILO* ui = getUILO()) ui->notifyBindingPublished();
+}
+
+}
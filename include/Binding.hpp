@@ -0,0 +1,168 @@
+#pragma once
+
+#include "elements/Element.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace uilo {
+
+class UILO;
+
+/*
+    BindingBase:
+    - Desc: The untyped half of Binding<T>: its registration with the
+            UILO whose elements it drives, and the cross-thread wake-up.
+            A binding attaches to a UILO on its first bind() and detaches
+            when either side is destroyed, so neither has to outlive the
+            other. Defined in Binding.cpp.
+*/
+class BindingBase {
+public:
+    BindingBase() = default;
+    BindingBase(const BindingBase&) = delete;
+    BindingBase& operator=(const BindingBase&) = delete;
+    virtual ~BindingBase();
+
+    UILO* getUILO() const { return m_ui.load(std::memory_order_acquire); }
+
+protected:
+    friend class UILO;
+
+    // Moves a published value into the bound elements; UI thread, from
+    // UILO::update().
+    virtual void drain() = 0;
+    // UILO is going away.
+    virtual void detach() { m_ui.store(nullptr, std::memory_order_release); }
+
+    bool     attach(Element* element);
+    Element* resolve(ElementHandle handle) const;
+    // Any thread. Tells the UILO a value is waiting.
+    void     notifyPublished() const;
+
+    std::atomic<UILO*> m_ui{ nullptr };
+};
+
+/*
+    Binding<T>:
+    - Desc: An observable value that elements bind to in place of polling
+            engine state from onUpdateStart hooks. set() on the UI thread
+            applies a changed value straight to every bound element, which
+            dirties just those elements through their own setters; equal
+            values do nothing. publish() is for other threads (audio,
+            engine, analysis workers): it's lock-free, drops into a
+            latest-value mailbox, and the UI picks it up once per frame
+            ahead of layout, so a burst of publishes costs one update.
+            Bound elements are held by handle; a freed one just falls off.
+            bindContent() / bindValue() on Text, Slider and Knob wrap bind().
+*/
+template <typename T>
+class Binding final : public BindingBase {
+public:
+    using Apply = std::function<void(Element*, const T&)>;
+
+    explicit Binding(T initial = T{}) : m_value(std::move(initial)) {}
+    ~Binding() override { delete m_boxed.load(std::memory_order_acquire); }
+
+    const T& get() const { return m_value; }
+
+    // UI thread.
+    void set(const T& value) {
+        if (value == m_value) return;
+        m_value = value;
+        notify();
+    }
+
+    // Any thread, any number of them; lock-free. The latest value shows
+    // up on the UI's next update(), earlier unconsumed ones are dropped.
+    void publish(const T& value) {
+        if constexpr (kPacked) {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(T));
+            m_packed.store(bits, std::memory_order_release);
+            m_fresh.store(true, std::memory_order_release);
+        } else {
+            delete m_boxed.exchange(new T(value), std::memory_order_acq_rel);
+        }
+        notifyPublished();
+    }
+
+    // Binds `element` and applies the current value to it at once. Fails
+    // (with a message) when the element isn't attached to a UILO, or to a
+    // different one than earlier bindings.
+    bool bind(Element* element, Apply apply) {
+        if (!element || !apply || !attach(element)) return false;
+        apply(element, m_value);
+        m_subscribers.push_back({ element->getHandle(), std::move(apply) });
+        return true;
+    }
+
+    void unbind(const Element* element) {
+        if (!element) return;
+        const ElementHandle h = element->getHandle();
+        m_subscribers.erase(std::remove_if(m_subscribers.begin(), m_subscribers.end(),
+                                           [&](const Subscriber& s) { return s.handle == h; }),
+                            m_subscribers.end());
+    }
+
+    size_t getBoundCount() const { return m_subscribers.size(); }
+
+private:
+    struct Subscriber {
+        ElementHandle handle;
+        Apply         apply;
+    };
+
+    void drain() override {
+        if constexpr (kPacked) {
+            if (!m_fresh.exchange(false, std::memory_order_acq_rel)) return;
+            T value{};
+            const uint64_t bits = m_packed.load(std::memory_order_acquire);
+            std::memcpy(&value, &bits, sizeof(T));
+            set(value);
+        } else {
+            std::unique_ptr<T> value(m_boxed.exchange(nullptr, std::memory_order_acq_rel));
+            if (value) set(*value);
+        }
+    }
+
+    void detach() override {
+        BindingBase::detach();
+        m_subscribers.clear();
+    }
+
+    void notify() {
+        // An apply must not bind to or unbind from this same binding.
+        bool stale = false;
+        for (size_t i = 0; i < m_subscribers.size(); ++i) {
+            Element* e = resolve(m_subscribers[i].handle);
+            if (!e) { stale = true; continue; }
+            m_subscribers[i].apply(e, m_value);
+        }
+        if (stale)
+            m_subscribers.erase(std::remove_if(m_subscribers.begin(), m_subscribers.end(),
+                                               [&](const Subscriber& s) { return !resolve(s.handle); }),
+                                m_subscribers.end());
+    }
+
+    T                       m_value;
+    std::vector<Subscriber> m_subscribers;
+
+    // Mailbox. Small trivially copyable values (float, Color, ...) travel
+    // as bits in one atomic word; anything else (std::string) as a boxed
+    // copy swapped in by pointer, the displaced box freed by whoever
+    // displaced it.
+    static constexpr bool kPacked = std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(uint64_t);
+    std::atomic<uint64_t> m_packed{ 0 };
+    std::atomic<bool>     m_fresh{ false };
+    std::atomic<T*>       m_boxed{ nullptr };
+};
+
+}
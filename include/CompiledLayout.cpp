@@ -0,0 +1,481 @@
+#include "CompiledLayout.hpp"
+#include "Page.hpp"
+#include "elements/Elements.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace uilo {
+
+using layout::LayoutHeader;
+using layout::LayoutNode;
+using layout::kNoString;
+
+namespace {
+
+bool isSupported(uint8_t type) {
+    switch ((ElementType)type) {
+        case ElementType::Column: case ElementType::Row:   case ElementType::Spacer:
+        case ElementType::Text:   case ElementType::Image: case ElementType::Button:
+        case ElementType::Slider: case ElementType::Knob:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool takesChildren(uint8_t type) {
+    return (ElementType)type == ElementType::Column || (ElementType)type == ElementType::Row;
+}
+
+// Strings a node refers to, resolved; "" for none.
+struct NodeStrings {
+    const char* text = "";
+    const char* role = "";
+};
+
+void fillModifier(Modifier& m, const LayoutNode& n) {
+    m.setWidth(Dimension{ n.width, (n.flags & layout::kWidthPct) != 0 });
+    m.setHeight(Dimension{ n.height, (n.flags & layout::kHeightPct) != 0 });
+    m.setAlign((Align)n.align);
+    m.setOuterPadding(n.padding);
+    m.setVisible((n.flags & layout::kHidden) == 0);
+}
+
+// Without kHasColor a color goes back to the options default, so that
+// removing it from a reloaded layout takes effect.
+template <class O>
+Color colorOf(const LayoutNode& n, Color (O::*get)() const) {
+    return (n.flags & layout::kHasColor) ? Color::fromRGBA(n.color) : (O{}.*get)();
+}
+
+template <class O>
+void fillSurface(O& o, const LayoutNode& n, const NodeStrings& s) {
+    o.setColor(colorOf<O>(n, &O::getColor));
+    o.setColorRole(s.role);
+    o.setRounding(n.rounding);
+}
+
+void fill(ColumnOptions& o, const LayoutNode& n, const NodeStrings& s) {
+    fillSurface(o, n, s);
+    o.setScrollable((n.flags & layout::kScrollable) != 0);
+}
+
+void fill(RowOptions& o, const LayoutNode& n, const NodeStrings& s) {
+    fillSurface(o, n, s);
+    o.setScrollable((n.flags & layout::kScrollable) != 0);
+}
+
+void fill(SpacerOptions& o, const LayoutNode& n, const NodeStrings& s) { fillSurface(o, n, s); }
+void fill(ButtonOptions& o, const LayoutNode& n, const NodeStrings& s) { fillSurface(o, n, s); }
+
+void fill(TextOptions& o, const LayoutNode& n, const NodeStrings& s) {
+    o.setContent(s.text);
+    o.setColor(colorOf<TextOptions>(n, &TextOptions::getColor));
+    o.setColorRole(s.role);
+    if (n.charSize > 0.f) o.setCharSize((unsigned int)n.charSize);
+    o.setWrap((n.flags & layout::kWrap) != 0);
+    o.setBold((n.flags & layout::kBold) != 0);
+    o.setItalic((n.flags & layout::kItalic) != 0);
+}
+
+void fill(ImageOptions& o, const LayoutNode& n, const NodeStrings& s) {
+    o.setPath(s.text);
+    o.setColor(colorOf<ImageOptions>(n, &ImageOptions::getColor));
+    o.setColorRole(s.role);
+}
+
+void fill(SliderOptions& o, const LayoutNode& n, const NodeStrings& s) {
+    o.setFillColor(colorOf<SliderOptions>(n, &SliderOptions::getFillColor));
+    o.setFillColorRole(s.role);
+    o.setRange(n.min, n.max);
+    o.setStep(n.step);
+    if (n.flags & layout::kHasValue) o.setDefaultValue(n.value);
+}
+
+void fill(KnobOptions& o, const LayoutNode& n, const NodeStrings& s) {
+    o.setArcColor(colorOf<KnobOptions>(n, &KnobOptions::getArcColor));
+    o.setArcColorRole(s.role);
+    o.setRange(n.min, n.max);
+    o.setStep(n.step);
+    if (n.flags & layout::kHasValue) o.setDefaultValue(n.value);
+}
+
+} // namespace
+
+
+/*
+    begin(ElementType type, const std::string& name):
+    - Params:   ElementType type, const std::string& name
+    - Returns:  LayoutBuilder&
+    - Desc:     Opens a node as the next child of the open node (or as the
+                root), seeded with the Modifier defaults.
+*/
+LayoutBuilder& LayoutBuilder::begin(ElementType type, const std::string& name) {
+    if (m_open.empty() && !m_nodes.empty()) {
+        std::fprintf(stderr, "[UILO] LayoutBuilder: a layout has one root node\n");
+        m_failed = true;
+    }
+    const Modifier defaults;
+    LayoutNode n;
+    n.type    = (uint8_t)type;
+    n.align   = (uint8_t)defaults.getAlign();
+    n.width   = defaults.getWidth().value;
+    n.height  = defaults.getHeight().value;
+    n.padding = defaults.getOuterPadding();
+    if (defaults.getWidth().percent)  n.flags |= layout::kWidthPct;
+    if (defaults.getHeight().percent) n.flags |= layout::kHeightPct;
+    if (!name.empty()) n.name = intern(name);
+    if (!m_open.empty()) ++m_nodes[m_open.back()].childCount;
+    m_open.push_back((uint32_t)m_nodes.size());
+    m_nodes.push_back(n);
+    return *this;
+}
+
+LayoutBuilder& LayoutBuilder::end() {
+    if (m_open.empty()) {
+        std::fprintf(stderr, "[UILO] LayoutBuilder: end() without begin()\n");
+        m_failed = true;
+    } else {
+        m_open.pop_back();
+    }
+    return *this;
+}
+
+LayoutNode& LayoutBuilder::top() {
+    if (m_open.empty()) {
+        m_failed = true;
+        return m_discard;
+    }
+    return m_nodes[m_open.back()];
+}
+
+uint32_t LayoutBuilder::intern(const std::string& s) {
+    auto [it, added] = m_stringIds.try_emplace(s, (uint32_t)m_strings.size());
+    if (added) m_strings.push_back(s);
+    return it->second;
+}
+
+void LayoutBuilder::setFlag(uint16_t flag, bool on) {
+    LayoutNode& n = top();
+    n.flags = on ? (uint16_t)(n.flags | flag) : (uint16_t)(n.flags & ~flag);
+}
+
+LayoutBuilder& LayoutBuilder::size(Dimension width, Dimension height) {
+    top().width  = width.value;
+    top().height = height.value;
+    setFlag(layout::kWidthPct, width.percent);
+    setFlag(layout::kHeightPct, height.percent);
+    return *this;
+}
+
+LayoutBuilder& LayoutBuilder::align(Align alignment) { top().align = (uint8_t)alignment; return *this; }
+LayoutBuilder& LayoutBuilder::padding(float px)      { top().padding = px;              return *this; }
+LayoutBuilder& LayoutBuilder::visible(bool v)        { setFlag(layout::kHidden, !v);    return *this; }
+LayoutBuilder& LayoutBuilder::color(Color c)         { top().color = c.toRGBA(); setFlag(layout::kHasColor, true); return *this; }
+LayoutBuilder& LayoutBuilder::colorRole(const std::string& role) {
+    top().colorRole = role.empty() ? kNoString : intern(role);
+    return *this;
+}
+LayoutBuilder& LayoutBuilder::text(const std::string& contentOrPath) { top().text = intern(contentOrPath); return *this; }
+LayoutBuilder& LayoutBuilder::rounding(float r)        { top().rounding = r;  return *this; }
+LayoutBuilder& LayoutBuilder::charSize(float px)       { top().charSize = px; return *this; }
+LayoutBuilder& LayoutBuilder::range(float mn, float mx) { top().min = mn; top().max = mx; return *this; }
+LayoutBuilder& LayoutBuilder::step(float s)            { top().step = s;      return *this; }
+LayoutBuilder& LayoutBuilder::value(float v)           { top().value = v; setFlag(layout::kHasValue, true); return *this; }
+LayoutBuilder& LayoutBuilder::scrollable(bool v)       { setFlag(layout::kScrollable, v); return *this; }
+LayoutBuilder& LayoutBuilder::wrap(bool v)             { setFlag(layout::kWrap, v);       return *this; }
+LayoutBuilder& LayoutBuilder::bold(bool v)             { setFlag(layout::kBold, v);       return *this; }
+LayoutBuilder& LayoutBuilder::italic(bool v)           { setFlag(layout::kItalic, v);     return *this; }
+
+
+/*
+    finish(std::vector<uint8_t>& out):
+    - Params:   std::vector<uint8_t>& out
+    - Returns:  bool
+    - Desc:     Lays the header, nodes, string offsets and string blob out
+                back to back in `out`. False (out untouched) when the
+                layout is empty, a node is still open, or a call failed.
+*/
+bool LayoutBuilder::finish(std::vector<uint8_t>& out) const {
+    if (m_failed || m_nodes.empty() || !m_open.empty()) {
+        std::fprintf(stderr, "[UILO] LayoutBuilder: layout is empty or unbalanced\n");
+        return false;
+    }
+    std::vector<uint32_t> offsets;
+    std::string blob;
+    offsets.reserve(m_strings.size());
+    for (const auto& s : m_strings) {
+        offsets.push_back((uint32_t)blob.size());
+        blob.append(s).push_back('\0');
+    }
+    while (blob.size() % 4) blob.push_back('\0');
+
+    LayoutHeader h;
+    h.nodeSize      = (uint16_t)sizeof(LayoutNode);
+    h.nodeCount     = (uint32_t)m_nodes.size();
+    h.nodesOffset   = (uint32_t)sizeof(LayoutHeader);
+    h.stringCount   = (uint32_t)offsets.size();
+    h.stringsOffset = h.nodesOffset + h.nodeCount * (uint32_t)sizeof(LayoutNode);
+    h.blobOffset    = h.stringsOffset + h.stringCount * (uint32_t)sizeof(uint32_t);
+    h.blobSize      = (uint32_t)blob.size();
+
+    out.assign((size_t)h.blobOffset + h.blobSize, 0);
+    std::memcpy(out.data(), &h, sizeof(h));
+    std::memcpy(out.data() + h.nodesOffset, m_nodes.data(), m_nodes.size() * sizeof(LayoutNode));
+    if (!offsets.empty())
+        std::memcpy(out.data() + h.stringsOffset, offsets.data(), offsets.size() * sizeof(uint32_t));
+    if (!blob.empty()) std::memcpy(out.data() + h.blobOffset, blob.data(), blob.size());
+    return true;
+}
+
+bool LayoutBuilder::writeFile(const std::string& path) const {
+    std::vector<uint8_t> bytes;
+    if (!finish(bytes)) return false;
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "[UILO] LayoutBuilder: cannot write '%s'\n", path.c_str());
+        return false;
+    }
+    const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return (std::fclose(f) == 0) && ok;
+}
+
+
+bool CompiledLayout::open(const std::string& path) {
+    close();
+    if (!m_file.open(path.c_str())) {
+        std::fprintf(stderr, "[UILO] CompiledLayout: cannot open '%s'\n", path.c_str());
+        return false;
+    }
+    if (validate(m_file.data(), m_file.size())) return true;
+    close();
+    return false;
+}
+
+bool CompiledLayout::view(const uint8_t* data, size_t size) {
+    close();
+    if (validate(data, size)) return true;
+    close();
+    return false;
+}
+
+void CompiledLayout::close() {
+    m_file.close();
+    m_nodes       = nullptr;
+    m_nodeCount   = 0;
+    m_strings     = nullptr;
+    m_stringCount = 0;
+    m_blob        = nullptr;
+}
+
+
+/*
+    validate(const uint8_t* data, size_t size):
+    - Params:   const uint8_t* data, size_t size
+    - Returns:  bool
+    - Desc:     Checks the header (magic, which also catches a foreign byte
+                order, version and node size), that every section and
+                string lies inside the buffer, and that the nodes form one
+                tree of supported types; only then points the view at it.
+*/
+bool CompiledLayout::validate(const uint8_t* data, size_t size) {
+    auto fail = [](const char* why) {
+        std::fprintf(stderr, "[UILO] CompiledLayout: %s\n", why);
+        return false;
+    };
+    if (!data || size < sizeof(LayoutHeader)) return fail("buffer too small");
+    if ((uintptr_t)data % alignof(LayoutNode) != 0) return fail("buffer is not 4-byte aligned");
+    LayoutHeader h;
+    std::memcpy(&h, data, sizeof(h));
+    if (h.magic != layout::kMagic)             return fail("not a compiled layout (or wrong byte order)");
+    if (h.version != layout::kVersion)         return fail("unsupported version");
+    if (h.nodeSize != sizeof(LayoutNode))      return fail("node size mismatch");
+
+    auto inside = [size](uint64_t offset, uint64_t bytes) {
+        return offset % 4 == 0 && offset + bytes <= size;
+    };
+    if (h.nodeCount == 0 || !inside(h.nodesOffset, (uint64_t)h.nodeCount * sizeof(LayoutNode)))
+        return fail("node table out of bounds");
+    if (!inside(h.stringsOffset, (uint64_t)h.stringCount * sizeof(uint32_t)))
+        return fail("string table out of bounds");
+    if (h.blobOffset > size || (uint64_t)h.blobOffset + h.blobSize > size)
+        return fail("string blob out of bounds");
+
+    const auto* nodes   = reinterpret_cast<const LayoutNode*>(data + h.nodesOffset);
+    const auto* strings = reinterpret_cast<const uint32_t*>(data + h.stringsOffset);
+    const char* blob    = reinterpret_cast<const char*>(data + h.blobOffset);
+    if (h.stringCount > 0 && (h.blobSize == 0 || blob[h.blobSize - 1] != '\0'))
+        return fail("string blob is not terminated");
+    for (uint32_t i = 0; i < h.stringCount; ++i)
+        if (strings[i] >= h.blobSize) return fail("string offset out of bounds");
+
+    // Pre-order shape: a stack of children still owed to each open node.
+    std::vector<uint32_t> owed;
+    auto stringOk = [&](uint32_t id) { return id == kNoString || id < h.stringCount; };
+    for (uint32_t i = 0; i < h.nodeCount; ++i) {
+        const LayoutNode& n = nodes[i];
+        while (!owed.empty() && owed.back() == 0) owed.pop_back();
+        if (owed.empty() && i > 0) return fail("more than one root node");
+        if (!owed.empty()) --owed.back();
+        if (!isSupported(n.type)) return fail("unsupported element type");
+        if (!stringOk(n.name) || !stringOk(n.text) || !stringOk(n.colorRole))
+            return fail("string id out of range");
+        if (n.childCount > h.nodeCount - 1 - i) return fail("child count overruns the node table");
+        if ((ElementType)n.type == ElementType::Button) {
+            if (n.childCount > 1 || (n.childCount == 1 && (ElementType)nodes[i + 1].type != ElementType::Text))
+                return fail("a Button's only child is its Text label");
+        } else if (n.childCount > 0 && !takesChildren(n.type)) {
+            return fail("a leaf element has children");
+        }
+        if (n.childCount > 0) owed.push_back(n.childCount);
+    }
+    while (!owed.empty() && owed.back() == 0) owed.pop_back();
+    if (!owed.empty()) return fail("truncated tree");
+
+    m_nodes       = nodes;
+    m_nodeCount   = h.nodeCount;
+    m_strings     = strings;
+    m_stringCount = h.stringCount;
+    m_blob        = blob;
+    return true;
+}
+
+const char* CompiledLayout::str(uint32_t id) const {
+    return id == kNoString ? "" : m_blob + m_strings[id];
+}
+
+
+Element* CompiledLayout::instantiate() const {
+    if (!valid()) return nullptr;
+    uint32_t index = 0;
+    return build(index);
+}
+
+Page* CompiledLayout::page(const std::string& name) const {
+    if (!valid()) return nullptr;
+    if (!takesChildren(m_nodes[0].type)) {
+        std::fprintf(stderr, "[UILO] CompiledLayout: a page's root must be a Column or Row\n");
+        return nullptr;
+    }
+    return new Page(static_cast<Container*>(instantiate()), name);
+}
+
+
+/*
+    build(uint32_t& index):
+    - Params:   uint32_t& index
+    - Returns:  Element*
+    - Desc:     Constructs the node at `index` and, recursively, the nodes
+                of its subtree, leaving `index` one past the subtree.
+*/
+Element* CompiledLayout::build(uint32_t& index) const {
+    const LayoutNode& n = m_nodes[index++];
+    const NodeStrings s{ str(n.text), str(n.colorRole) };
+    const std::string name = str(n.name);
+    Modifier mod;
+    fillModifier(mod, n);
+
+    auto withChildren = [&](Container* c) {
+        for (uint32_t k = 0; k < n.childCount; ++k) c->addElement(build(index));
+        return c;
+    };
+    switch ((ElementType)n.type) {
+        case ElementType::Column: { ColumnOptions o; fill(o, n, s); return withChildren(new Column(mod, o, {}, name)); }
+        case ElementType::Row:    { RowOptions o;    fill(o, n, s); return withChildren(new Row(mod, o, {}, name)); }
+        case ElementType::Spacer: { SpacerOptions o; fill(o, n, s); return new Spacer(mod, o, name); }
+        case ElementType::Text:   { TextOptions o;   fill(o, n, s); return new Text(mod, o, name); }
+        case ElementType::Image:  { ImageOptions o;  fill(o, n, s); return new Image(mod, o, name); }
+        case ElementType::Slider: { SliderOptions o; fill(o, n, s); return new Slider(mod, o, name); }
+        case ElementType::Knob:   { KnobOptions o;   fill(o, n, s); return new Knob(mod, o, name); }
+        case ElementType::Button: {
+            ButtonOptions o;
+            fill(o, n, s);
+            if (n.childCount == 1) o.setLabel(static_cast<Text*>(build(index)));
+            return new Button(mod, o, name);
+        }
+        default: return nullptr;   // rejected by validate()
+    }
+}
+
+
+bool CompiledLayout::apply(Element* root) const {
+    if (!valid() || !root) return false;
+    uint32_t index = 0;
+    if (!matches(root, index) || index != m_nodeCount) return false;
+    index = 0;
+    update(root, index);
+    return true;
+}
+
+
+/*
+    matches(Element* e, uint32_t& index):
+    - Params:   Element* e, uint32_t& index
+    - Returns:  bool
+    - Desc:     True when the subtree at `e` has the shape of the node at
+                `index`: same type, name and child count, all the way
+                down. A Text going from a fixed size back to fit-to-height
+                doesn't match either; TextOptions can't unset a size.
+*/
+bool CompiledLayout::matches(Element* e, uint32_t& index) const {
+    if (index >= m_nodeCount) return false;
+    const LayoutNode& n = m_nodes[index++];
+    if ((uint8_t)e->getType() != n.type || e->getName() != str(n.name)) return false;
+    if ((ElementType)n.type == ElementType::Text &&
+        n.charSize <= 0.f && static_cast<Text*>(e)->getOptions().hasCharSize())
+        return false;
+    if (!takesChildren(n.type) && (ElementType)n.type != ElementType::Button) return n.childCount == 0;
+    const auto& children = static_cast<Container*>(e)->getChildren();
+    if (children.size() != n.childCount) return false;
+    for (Element* c : children)
+        if (!c || !matches(c, index)) return false;
+    return true;
+}
+
+
+/*
+    update(Element* e, uint32_t& index):
+    - Params:   Element* e, uint32_t& index
+    - Returns:  void
+    - Desc:     Writes the node at `index` into the matching element's
+                Modifier and Options through their setters, so only what's
+                set here changes and the element dirties itself; then its
+                children.
+*/
+void CompiledLayout::update(Element* e, uint32_t& index) const {
+    const LayoutNode& n = m_nodes[index++];
+    const NodeStrings s{ str(n.text), str(n.colorRole) };
+    fillModifier(e->getModifier(), n);
+
+    switch ((ElementType)n.type) {
+        case ElementType::Column: { auto* c = static_cast<Column*>(e); auto o = c->getOptions(); fill(o, n, s); c->setOptions(o); break; }
+        case ElementType::Row:    { auto* r = static_cast<Row*>(e);    auto o = r->getOptions(); fill(o, n, s); r->setOptions(o); break; }
+        case ElementType::Button: { auto* b = static_cast<Button*>(e); auto o = b->getOptions(); fill(o, n, s); b->setOptions(o); break; }
+        case ElementType::Spacer: { auto* p = static_cast<Spacer*>(e); fill(p->getOptions(), n, s); p->markDirty(); break; }
+        case ElementType::Slider: { auto* p = static_cast<Slider*>(e); fill(p->getOptions(), n, s); p->markDirty(); break; }
+        case ElementType::Knob:   { auto* p = static_cast<Knob*>(e);   fill(p->getOptions(), n, s); p->markDirty(); break; }
+        case ElementType::Text: {
+            auto* t = static_cast<Text*>(e);
+            auto o = t->getOptions();
+            fill(o, n, s);
+            t->setOptions(o);
+            t->setString(o.getContent());
+            break;
+        }
+        case ElementType::Image: {
+            auto* img = static_cast<Image*>(e);
+            auto o = img->getOptions();
+            fill(o, n, s);
+            // Only a new path reloads the texture.
+            if (o.getPath() != img->getOptions().getPath()) img->setOptions(o);
+            else { img->getOptions() = o; img->markDirty(); }
+            break;
+        }
+        default: break;
+    }
+    if (takesChildren(n.type) || (ElementType)n.type == ElementType::Button)
+        for (Element* c : static_cast<Container*>(e)->getChildren()) update(c, index);
+}
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "elements/Element.hpp"
+#include "utils/MappedFile.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace uilo {
+
+class Page;
+
+// On-disk form of a compiled layout. Little-endian, 4-byte aligned, and
+// read in place (from a mapping or any caller buffer) without parsing:
+//
+//   LayoutHeader
+//   LayoutNode   nodes[nodeCount]        pre-order; a node's children
+//                                        follow it, childCount of them
+//   uint32_t     strings[stringCount]    offsets into the blob
+//   char         blob[blobSize]          NUL-terminated, each string once
+//
+// Strings (names, text, image paths, palette roles) are interned: a node
+// stores an index into `strings`, and kNoString for none.
+namespace layout {
+
+inline constexpr uint32_t kMagic    = 0x424C4955u;   // "UILB"
+inline constexpr uint16_t kVersion  = 1;
+inline constexpr uint32_t kNoString = 0xFFFFFFFFu;
+
+struct LayoutHeader {
+    uint32_t magic       = kMagic;     // also the byte-order check
+    uint16_t version     = kVersion;
+    uint16_t nodeSize    = 0;          // sizeof(LayoutNode)
+    uint32_t nodeCount   = 0;
+    uint32_t nodesOffset = 0;
+    uint32_t stringCount = 0;
+    uint32_t stringsOffset = 0;
+    uint32_t blobOffset  = 0;
+    uint32_t blobSize    = 0;
+};
+
+enum NodeFlags : uint16_t {
+    kHidden     = 1 << 0,
+    kWidthPct   = 1 << 1,
+    kHeightPct  = 1 << 2,
+    kHasColor   = 1 << 3,    // `color` overrides the options default
+    kHasValue   = 1 << 4,    // `value` is a default value
+    kScrollable = 1 << 5,
+    kWrap       = 1 << 6,
+    kBold       = 1 << 7,
+    kItalic     = 1 << 8,
+};
+
+// One element. Fields a type doesn't use are ignored; which option each
+// lands in is listed beside it.
+struct LayoutNode {
+    uint8_t  type       = 0;           // ElementType
+    uint8_t  align      = 0;           // Align bits
+    uint16_t flags      = 0;           // NodeFlags
+    uint32_t childCount = 0;
+    uint32_t name       = kNoString;
+    uint32_t text       = kNoString;   // Text content, Image path
+    uint32_t colorRole  = kNoString;   // the type's main color role
+    uint32_t color      = 0;           // RGBA: background / text / fill / arc
+    float    width      = 0.f;
+    float    height     = 0.f;
+    float    padding    = 0.f;         // Modifier outer padding
+    float    rounding   = 0.f;         // Column, Row, Spacer, Button
+    float    charSize   = 0.f;         // Text; 0 = fit to height
+    float    min        = 0.f;         // Slider, Knob
+    float    max        = 1.f;
+    float    step       = 0.f;
+    float    value      = 0.f;
+};
+
+} // namespace layout
+
+/*
+    LayoutBuilder:
+    - Desc: Writes a compiled layout without constructing any element:
+            begin() opens a node (nested inside the open one), the setters
+            fill it, end() closes it. Unset fields take the Modifier and
+            *Options defaults. Supports Column, Row, Spacer, Text, Image,
+            Button (its first child Text is the label), Slider and Knob.
+*/
+class LayoutBuilder {
+public:
+    LayoutBuilder& begin(ElementType type, const std::string& name = "");
+    LayoutBuilder& end();
+
+    LayoutBuilder& size(Dimension width, Dimension height);
+    LayoutBuilder& align(Align alignment);
+    LayoutBuilder& padding(float px);
+    LayoutBuilder& visible(bool v);
+    LayoutBuilder& color(Color c);
+    LayoutBuilder& colorRole(const std::string& role);
+    LayoutBuilder& text(const std::string& contentOrPath);
+    LayoutBuilder& rounding(float r);
+    LayoutBuilder& charSize(float px);
+    LayoutBuilder& range(float mn, float mx);
+    LayoutBuilder& step(float s);
+    LayoutBuilder& value(float v);
+    LayoutBuilder& scrollable(bool v);
+    LayoutBuilder& wrap(bool v);
+    LayoutBuilder& bold(bool v);
+    LayoutBuilder& italic(bool v);
+
+    // The finished buffer; false when a node is still open or none exist.
+    bool finish(std::vector<uint8_t>& out) const;
+    bool writeFile(const std::string& path) const;
+
+private:
+    layout::LayoutNode& top();
+    uint32_t intern(const std::string& s);
+    void     setFlag(uint16_t flag, bool on);
+
+    std::vector<layout::LayoutNode>           m_nodes;
+    std::vector<uint32_t>                     m_open;      // indices of open nodes
+    layout::LayoutNode                        m_discard;   // setters outside begin/end
+    bool                                      m_failed = false;
+    std::vector<std::string>                  m_strings;
+    std::unordered_map<std::string, uint32_t> m_stringIds;
+};
+
+/*
+    CompiledLayout:
+    - Desc: A validated, read-only view of a compiled layout. open() maps
+            the file; view() wraps a buffer the caller keeps alive. Both
+            check the header, bounds and tree shape once, so instantiate()
+            and apply() trust the data. instantiate() builds the element
+            tree in one pass over the nodes (elements come from the usual
+            SlabPool classes); apply() is the hot-reload path.
+*/
+class CompiledLayout {
+public:
+    bool open(const std::string& path);
+    bool view(const uint8_t* data, size_t size);
+    void close();
+
+    bool     valid()        const { return m_nodes != nullptr; }
+    uint32_t getNodeCount() const { return m_nodeCount; }
+
+    // A new tree, or nullptr when invalid. The root is a Container when
+    // the first node is one; page() wraps that in a Page.
+    Element* instantiate() const;
+    Page*    page(const std::string& name) const;
+
+    // Hot reload onto a tree previously built from (an earlier version
+    // of) this layout: when every node matches the element at the same
+    // pre-order position by type, child count and name, the existing
+    // elements are updated in place -- keeping their callbacks, drag or
+    // scroll state and GPU resources -- and true is returned. Any shape
+    // change returns false without touching anything; rebuild then.
+    bool apply(Element* root) const;
+
+private:
+    bool        validate(const uint8_t* data, size_t size);
+    const char* str(uint32_t id) const;
+    Element*    build(uint32_t& index) const;
+    bool        matches(Element* e, uint32_t& index) const;
+    void        update(Element* e, uint32_t& index) const;
+
+    MappedFile                      m_file;
+    const layout::LayoutNode*       m_nodes       = nullptr;
+    uint32_t                        m_nodeCount   = 0;
+    const uint32_t*                 m_strings     = nullptr;
+    uint32_t                        m_stringCount = 0;
+    const char*                     m_blob        = nullptr;
+};
+
+}
@@ -1,5 +1,6 @@
 #include "Page.hpp"
 #include "UILO.hpp"
+#include "utils/Trace.hpp"
 
 namespace uilo {
 
@@ -23,6 +24,7 @@ Page::Page(Container* rootContainer, const std::string& name) {
                 given screen bounds and delta time.
 */
 void Page::update(Rectf& screenBounds, float dt) {
+    UILO_TRACE_ZONE("Page::update");
     m_rootContainer->tick(screenBounds, dt);
 }
 
@@ -34,7 +36,7 @@ void Page::update(Rectf& screenBounds, float dt) {
     - Desc:     Draws the page by rendering its root container.
 */
 void Page::render() {
-    m_rootContainer->render();
+    m_rootContainer->paint();
 }
 
 
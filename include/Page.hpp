@@ -21,6 +21,10 @@ protected:
     UILO* m_uiloRef = nullptr;
     Container* m_rootContainer = nullptr;
     std::string m_name = "";
+    // Page switching (UILO::prewarmPage / setPageReleaseDelay).
+    uint64_t m_lastShownNs = 0;     // SDL_GetTicksNS() when last left
+    bool     m_prewarmed   = false;
+    bool     m_released    = false;
 
     void update(Rectf& screenBounds, float dt);
     void render();
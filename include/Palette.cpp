@@ -19,6 +19,7 @@ void Palette::set(const std::string& role, Color color) {
     e.color   = color;
     e.aliasOf.clear();
     e.isAlias = false;
+    ++m_version;
 }
 
 
@@ -34,6 +35,7 @@ void Palette::setAlias(const std::string& role, const std::string& target) {
     auto& e = m_entries[role];
     e.aliasOf = target;
     e.isAlias = true;
+    ++m_version;
 }
 
 
@@ -79,6 +81,37 @@ Color Palette::resolve(std::string_view role, Color literal) const {
 }
 
 
+/*
+    resolve(const Role& role, Color literal):
+    - Params:   const Role& role, Color literal
+    - Returns:  Color
+    - Desc:     Same result as the string overload, served from the per-id
+                cache. A slot resolved at an older palette version is
+                looked up again by name and refreshed.
+*/
+Color Palette::resolve(const Role& role, Color literal) const {
+    static const Role kNone("none");
+    if (role.empty() || role == kNone) return literal;
+
+    auto& slots = m_colorCache.slots;
+    if (m_readOnly) {
+        if (role.id() < slots.size() && slots[role.id()].version == m_version)
+            return slots[role.id()].found ? slots[role.id()].color : literal;
+        return resolve(role.str(), literal);
+    }
+    if (role.id() >= slots.size()) slots.resize(role.id() + 1);
+    CachedColor& slot = slots[role.id()];
+    if (slot.version != m_version) {
+        auto it = m_entries.find(role.str());
+        slot.found = it != m_entries.end();
+        if (slot.found)
+            slot.color = it->second.isAlias ? resolveImpl(it->second.aliasOf, 1) : it->second.color;
+        slot.version = m_version;
+    }
+    return slot.found ? slot.color : literal;
+}
+
+
 /*
     resolveImpl(std::string_view role, int depth):
     - Params:   std::string_view role, int depth
@@ -107,6 +140,7 @@ Color Palette::resolveImpl(std::string_view role, int depth) const {
 */
 void Palette::setGradient(const std::string& role, const Gradient& gradient) {
     m_gradients[role] = gradient;
+    ++m_version;
 }
 
 
@@ -123,6 +157,55 @@ const Gradient* Palette::getGradient(std::string_view role) const {
 }
 
 
+/*
+    getGradient(const Role& role):
+    - Params:   const Role& role
+    - Returns:  const Gradient*
+    - Desc:     Cached form of the string overload, refreshed when the
+                palette version changes.
+*/
+const Gradient* Palette::getGradient(const Role& role) const {
+    if (role.empty()) return nullptr;
+    auto& slots = m_gradientCache.slots;
+    if (m_readOnly) {
+        if (role.id() < slots.size() && slots[role.id()].version == m_version)
+            return slots[role.id()].gradient;
+        return getGradient(role.str());
+    }
+    if (role.id() >= slots.size()) slots.resize(role.id() + 1);
+    CachedGradient& slot = slots[role.id()];
+    if (slot.version != m_version) {
+        slot.gradient = getGradient(role.str());
+        slot.version  = m_version;
+    }
+    return slot.gradient;
+}
+
+
+/*
+    beginConcurrentReads():
+    - Params:   none
+    - Returns:  void
+    - Desc:     Fills the color and gradient slot of every interned role at
+                the current version, skipped when the version is unchanged
+                and no role was interned since the last call, and switches the
+                Role lookups to read-only so several threads can share them.
+*/
+void Palette::beginConcurrentReads() const {
+    const uint32_t roles = Role::count();
+    if (m_colorCache.slots.size() < roles || m_version != m_warmVersion) {
+        m_readOnly = false;
+        for (uint32_t id = 1; id < roles; ++id) {
+            const Role role = Role::fromId(id);
+            resolve(role, Color{});
+            getGradient(role);
+        }
+        m_warmVersion = m_version;
+    }
+    m_readOnly = true;
+}
+
+
 /*
     hasGradient(std::string_view role):
     - Params:   std::string_view role
@@ -143,6 +226,7 @@ bool Palette::hasGradient(std::string_view role) const {
 void Palette::clear() {
     m_entries.clear();
     m_gradients.clear();
+    ++m_version;
 }
 
 
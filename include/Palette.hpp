@@ -2,10 +2,13 @@
 
 #include "utils/Color.hpp"
 #include "utils/Gradient.hpp"
+#include "utils/Role.hpp"
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace uilo {
 
@@ -19,6 +22,11 @@ namespace uilo {
             the palette's fallback color. Aliases let one role point at
             another so a small base of colors drives many widget-specific
             roles, with cycles broken after a depth cap.
+
+            Lookups by Role (what the Options setters store) go through a
+            flat table indexed by the role's id. Each slot remembers the
+            palette version it was resolved at, and every mutation bumps
+            the version, so a slot re-resolves at most once per change.
 */
 class Palette {
 public:
@@ -29,16 +37,30 @@ public:
     Color get(std::string_view role) const;
     bool has(std::string_view role) const;
     Color resolve(std::string_view role, Color literal) const;
+    Color resolve(const Role& role, Color literal) const;
 
-    void  setFallback(Color c) { m_fallback = c; }
+    void  setFallback(Color c) { m_fallback = c; ++m_version; }
     Color getFallback() const  { return m_fallback; }
 
     void setGradient(const std::string& role, const Gradient& gradient);
     const Gradient* getGradient(std::string_view role) const;
+    const Gradient* getGradient(const Role& role) const;
     bool hasGradient(std::string_view role) const;
 
     void clear();
 
+    // Bumped by every change to the palette.
+    uint64_t getVersion() const { return m_version; }
+
+    // Parallel render slices share one palette. beginConcurrentReads()
+    // brings every cache slot up to date for the roles interned so far,
+    // then the Role lookups only read the caches until
+    // endConcurrentReads(); a role interned in between is resolved by
+    // name without being cached. The palette itself must not change
+    // meanwhile.
+    void beginConcurrentReads() const;
+    void endConcurrentReads() const { m_readOnly = false; }
+
     static Palette defaultDark();
     static Palette defaultLight();
 
@@ -51,6 +73,26 @@ private:
 
     Color resolveImpl(std::string_view role, int depth) const;
 
+    // Per-Role-id resolution cache; a slot is current when its version
+    // matches m_version.
+    struct CachedColor {
+        uint64_t version = 0;
+        Color    color { 0, 0, 0, 0 };
+        bool     found   = false;
+    };
+    struct CachedGradient {
+        uint64_t        version  = 0;
+        const Gradient* gradient = nullptr;
+    };
+    // Gradient slots point into m_gradients, so a copy starts empty.
+    template <class T>
+    struct Cache {
+        std::vector<T> slots;
+        Cache() = default;
+        Cache(const Cache&) {}
+        Cache& operator=(const Cache&) { slots.clear(); return *this; }
+    };
+
     struct StringHash {
         using is_transparent = void;
         size_t operator()(std::string_view s) const noexcept {
@@ -74,6 +116,11 @@ private:
     std::unordered_map<std::string, Entry, StringHash, StringEq> m_entries;
     std::unordered_map<std::string, Gradient, StringHash, StringEq> m_gradients;
     Color m_fallback { 255, 0, 255, 255 };
+    uint64_t m_version = 1;
+    mutable Cache<CachedColor>    m_colorCache;
+    mutable Cache<CachedGradient> m_gradientCache;
+    mutable bool                  m_readOnly    = false;
+    mutable uint64_t              m_warmVersion = 0;   // of the last beginConcurrentReads() fill
 };
 
 }
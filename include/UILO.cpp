@@ -1,10 +1,15 @@
 #include "UILO.hpp"
+#include "Binding.hpp"
+#include "CompiledLayout.hpp"
 #include "elements/interactible/Interactible.hpp"
 #include "platform/MacScroll.hpp"
 #include "platform/MacWindow.hpp"
+#include "utils/Trace.hpp"
 #include <SDL3/SDL.h>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <utility>
 
 namespace uilo {
 
@@ -22,6 +27,11 @@ UILO::UILO(Renderer& renderer, Page* page) {
 }
 
 
+UILO::~UILO() {
+    for (BindingBase* b : m_bindings) b->detach();
+}
+
+
 /*
     addPage(Page* page):
     - Params:   Page* page
@@ -35,6 +45,154 @@ void UILO::addPage(Page* page) {
 }
 
 
+/*
+    removePage(const std::string& pageName):
+    - Params:   const std::string& pageName
+    - Returns:  bool
+    - Desc:     Removes an inactive page and marks every element in its
+                tree for deletion; the next update() frees them in one
+                sweep, returning their slabs. Returns false when there is
+                no such page or it is the active one.
+*/
+bool UILO::removePage(const std::string& pageName) {
+    auto it = m_pages.find(pageName);
+    if (it == m_pages.end()) return false;
+    if (it->second.get() == m_activePage) {
+        std::fprintf(stderr, "[UILO] removePage: '%s' is the active page\n", pageName.c_str());
+        return false;
+    }
+
+    std::vector<Element*> doomed;
+    it->second->m_rootContainer->collectSubtree(doomed);
+    for (auto* e : doomed) e->m_markedForDeletion = true;
+    m_prewarmQueue.erase(std::remove(m_prewarmQueue.begin(), m_prewarmQueue.end(), it->second.get()),
+                         m_prewarmQueue.end());
+    m_pages.erase(it);
+    return true;
+}
+
+
+namespace {
+// Object size by type; elements of custom types count as a plain Element.
+size_t elementObjectBytes(ElementType type) {
+    switch (type) {
+        case ElementType::Column:
+        case ElementType::ScrollableColumn: return sizeof(Column);
+        case ElementType::Row:
+        case ElementType::ScrollableRow:    return sizeof(Row);
+        case ElementType::Canvas:           return sizeof(Canvas);
+        case ElementType::VirtualColumn:    return sizeof(VirtualColumn);
+        case ElementType::VirtualRow:       return sizeof(VirtualRow);
+        case ElementType::Spacer:           return sizeof(Spacer);
+        case ElementType::Text:             return sizeof(Text);
+        case ElementType::Image:            return sizeof(Image);
+        case ElementType::TiledImage:       return sizeof(TiledImage);
+        case ElementType::Waveform:         return sizeof(Waveform);
+        case ElementType::Button:           return sizeof(Button);
+        case ElementType::Slider:           return sizeof(Slider);
+        case ElementType::Dropdown:         return sizeof(Dropdown);
+        case ElementType::Knob:             return sizeof(Knob);
+        case ElementType::TextBox:          return sizeof(Textbox);
+        case ElementType::Resizer:          return sizeof(Resizer);
+        case ElementType::Grid:
+        case ElementType::NONE:             break;
+    }
+    return sizeof(Element);
+}
+} // anon
+
+
+/*
+    getMemoryStats():
+    - Params:   none
+    - Returns:  UiloMemoryStats
+    - Desc:     Renderer memory by subsystem plus the element pool's
+                approximate footprint by ElementType.
+*/
+UiloMemoryStats UILO::getMemoryStats() const {
+    UiloMemoryStats out;
+    if (m_renderer) out.renderer = m_renderer->getMemoryStats();
+    for (const auto& e : m_elementPool) {
+        const size_t type  = std::min((size_t)e->m_type, kElementTypeCount - 1);
+        const uint64_t bytes = elementObjectBytes(e->m_type) + e->heapBytes();
+        out.byType[type].count += 1;
+        out.byType[type].bytes += bytes;
+        out.elementBytes       += bytes;
+        ++out.elements;
+        if (e->m_type == ElementType::Waveform) {
+            const auto* w = static_cast<const Waveform*>(e.get());
+            out.waveformSampleBytes += w->sampleBytes();
+            out.waveformPeakBytes   += w->peakBytes();
+        }
+    }
+    return out;
+}
+
+
+#if UILO_PROFILER
+/*
+    topProfiledSubtrees(size_t count, std::vector<Element*>& out):
+    - Params:   size_t count, std::vector<Element*>& out
+    - Returns:  void
+    - Desc:     Replaces out with the (at most) count registered elements
+                whose subtrees cost the most smoothed update + render time,
+                costliest first. Elements not ticked or painted in the last
+                two frames (culled, hidden, removed) are left out.
+*/
+void UILO::topProfiledSubtrees(size_t count, std::vector<Element*>& out) const {
+    out.clear();
+    for (const auto& e : m_elementPool)
+        if (!e->m_markedForDeletion && e->m_profile.frame + 1 >= m_profileFrame)
+            out.push_back(e.get());
+    auto cost = [](const Element* e) {
+        return e->m_profile.avgUpdateMs + e->m_profile.avgRenderMs;
+    };
+    const size_t n = std::min(count, out.size());
+    std::partial_sort(out.begin(), out.begin() + (std::ptrdiff_t)n, out.end(),
+                      [&](const Element* a, const Element* b) { return cost(a) > cost(b); });
+    out.resize(n);
+}
+#endif
+
+
+/*
+    getHandle(const Element* element):
+    - Params:   const Element* element
+    - Returns:  ElementHandle
+    - Desc:     Returns a generational handle to an element registered with
+                this UILO, or a null handle for anything else.
+*/
+ElementHandle UILO::getHandle(const Element* element) const {
+    if (!element || element->m_uiloRef != this) return {};
+    const uint32_t index = element->m_handleIndex;
+    if (index >= m_handleSlots.size() || m_handleSlots[index].element != element) return {};
+    return { index, m_handleSlots[index].generation };
+}
+
+
+uint32_t UILO::acquireHandleSlot(Element* element) {
+    uint32_t index;
+    if (!m_freeHandleSlots.empty()) {
+        index = m_freeHandleSlots.back();
+        m_freeHandleSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_handleSlots.size());
+        m_handleSlots.emplace_back();
+    }
+    m_handleSlots[index].element = element;
+    return index;
+}
+
+
+void UILO::releaseHandleSlot(uint32_t index) {
+    if (index >= m_handleSlots.size()) return;
+    HandleSlot& slot = m_handleSlots[index];
+    slot.element = nullptr;
+    if (++slot.generation == 0) slot.generation = 1;  // 0 means "null handle"
+    m_freeHandleSlots.push_back(index);
+}
+
+
 /*
     setPage(const std::string& pageName):
     - Params:   const std::string& pageName
@@ -45,11 +203,14 @@ void UILO::addPage(Page* page) {
 void UILO::setPage(const std::string& pageName) {
     auto it = m_pages.find(pageName);
     if (it != m_pages.end()) {
+        m_redrawRequested = true;
         m_overlays.clear();
         m_resizers.clear();
         m_floating.clear();
         setCurrInteractible(nullptr);
+        leavePage(m_activePage);
         m_activePage = it->second.get();
+        m_activePage->m_released = false;
     }
 }
 
@@ -65,11 +226,135 @@ void UILO::setPage(const std::string& pageName) {
 void UILO::setActivePage(Page* page) {
     if (m_activePage == page) return;
     if (page) page->setUILO(*this);
+    m_redrawRequested = true;
     m_overlays.clear();
     m_resizers.clear();
     m_floating.clear();
     setCurrInteractible(nullptr);
+    leavePage(m_activePage);
     m_activePage = page;
+    if (page) page->m_released = false;
+}
+
+
+void UILO::leavePage(Page* page) {
+    if (page) page->m_lastShownNs = SDL_GetTicksNS();
+}
+
+
+/*
+    prewarmPage(const std::string& pageName):
+    - Params:   const std::string& pageName
+    - Returns:  bool
+    - Desc:     Queues an inactive page for a layout pass ahead of being
+                shown (see prewarmStep). The active page, or one already
+                queued, is left as is.
+*/
+bool UILO::prewarmPage(const std::string& pageName) {
+    auto it = m_pages.find(pageName);
+    if (it == m_pages.end()) {
+        std::fprintf(stderr, "[UILO] prewarmPage: no page '%s'\n", pageName.c_str());
+        return false;
+    }
+    Page* page = it->second.get();
+    if (page == m_activePage) return true;
+    if (std::find(m_prewarmQueue.begin(), m_prewarmQueue.end(), page) == m_prewarmQueue.end())
+        m_prewarmQueue.push_back(page);
+    // Stay warm even under a release delay until it's shown.
+    page->m_lastShownNs = SDL_GetTicksNS();
+    m_redrawRequested = true;
+    return true;
+}
+
+
+/*
+    loadPage(const CompiledLayout& layout, const std::string& pageName):
+    - Params:   const CompiledLayout& layout, const std::string& pageName
+    - Returns:  bool
+    - Desc:     Adds a page built from `layout`, or reloads the existing
+                one. CompiledLayout::apply() is tried first so unchanged
+                shapes keep their elements; otherwise the page's root is
+                replaced and the old tree marked for deletion like
+                removePage() does. Replacing the active page's tree also
+                drops the overlays, resizers and focus that pointed into it.
+*/
+bool UILO::loadPage(const CompiledLayout& layout, const std::string& pageName) {
+    auto it = m_pages.find(pageName);
+    if (it != m_pages.end() && layout.apply(it->second->m_rootContainer)) return true;
+
+    Page* fresh = layout.page(pageName);
+    if (!fresh) return false;
+    if (it == m_pages.end()) {
+        addPage(fresh);
+        return true;
+    }
+
+    Page* page = it->second.get();
+    std::vector<Element*> doomed;
+    page->m_rootContainer->collectSubtree(doomed);
+    for (auto* e : doomed) e->m_markedForDeletion = true;
+    page->m_rootContainer = std::exchange(fresh->m_rootContainer, nullptr);
+    delete fresh;
+    page->setUILO(*this);
+    page->m_prewarmed = false;
+    if (page == m_activePage) {
+        m_overlays.clear();
+        m_resizers.clear();
+        setCurrInteractible(nullptr);
+    }
+    m_redrawRequested = true;
+    return true;
+}
+
+
+/*
+    prewarmStep(Rectf& screenBounds, float layoutSeconds):
+    - Params:   Rectf& screenBounds, float layoutSeconds
+    - Returns:  void
+    - Desc:     Ticks the next queued page against the window bounds when
+                this frame's own layout took under kPrewarmBudget, so the
+                extra tick lands on idle frames rather than busy ones. Its
+                elements keep their bounds; switching to it later ticks
+                clean. New textures and fonts start loading here too.
+*/
+void UILO::prewarmStep(Rectf& screenBounds, float layoutSeconds) {
+    constexpr float kPrewarmBudget = 0.004f;
+    if (m_prewarmQueue.empty() || layoutSeconds > kPrewarmBudget) return;
+    Page* page = m_prewarmQueue.front();
+    m_prewarmQueue.erase(m_prewarmQueue.begin());
+    if (page == m_activePage) return;
+    UILO_TRACE_ZONE("UILO::prewarmPage");
+    page->update(screenBounds, 0.f);
+    page->m_prewarmed = true;
+    page->m_released  = false;
+    // More to do (or async loads in flight): come back next frame.
+    if (!m_prewarmQueue.empty()) m_redrawRequested = true;
+}
+
+
+/*
+    releaseIdlePages():
+    - Params:   none
+    - Returns:  void
+    - Desc:     Under a non-negative release delay, calls releaseResources()
+                on every element of each inactive page not shown for that
+                long, once per idle spell.
+*/
+void UILO::releaseIdlePages() {
+    if (m_pageReleaseDelay < 0.f) return;
+    const Uint64 now   = SDL_GetTicksNS();
+    const Uint64 delay = (Uint64)((double)m_pageReleaseDelay * 1e9);
+    std::vector<Element*> subtree;
+    for (auto& [name, page] : m_pages) {
+        Page* p = page.get();
+        if (p == m_activePage || p->m_released || now - p->m_lastShownNs < delay) continue;
+        if (std::find(m_prewarmQueue.begin(), m_prewarmQueue.end(), p) != m_prewarmQueue.end()) continue;
+        subtree.clear();
+        p->m_rootContainer->collectSubtree(subtree);
+        for (Element* e : subtree) e->releaseResources();
+        p->m_released  = true;
+        p->m_prewarmed = false;
+    }
 }
 
 
@@ -99,12 +384,91 @@ void UILO::setCurrInteractible(Interactible* i) {
 
 
 /*
-    setScale(float scale):
-    - Params:   float scale
+    setScale(float scale, bool transitional):
+    - Params:   float scale, bool transitional
     - Returns:  void
     - Desc:     Sets the global UI scale factor. Ignores non-positive values.
+                A plain call relays out the whole tree at the new scale
+                right away; a transition in progress still lands on its
+                target (Canvas swaps the scale around its own render). A
+                transitional one only updates the target the tree is drawn
+                scaled to; stepScaleTransition() applies it once the values
+                settle.
 */
-void UILO::setScale(float scale) { if (scale > 0.f) m_scale = scale; }
+void UILO::setScale(float scale, bool transitional) {
+    if (!(scale > 0.f)) return;
+    if (!transitional) {
+        if (scale != m_scale) { m_scale = scale; markTreeDirty(); }
+        return;
+    }
+    if (!isScaleTransitioning() && scale == m_scale) return;
+    m_scaleTarget     = scale;
+    m_scaleTransition = ScaleTransition::Changing;
+    m_scaleChangedNs  = SDL_GetTicksNS();
+    m_redrawRequested = true;
+}
+
+
+/*
+    stepScaleTransition():
+    - Params:   none
+    - Returns:  void
+    - Desc:     Runs at the top of update() while a transitional scale is
+                pending. kScaleSettleNs after the last value it asks the
+                renderer to bake the recently drawn text at the new sizes
+                (spread over frames by the glyph baker); when that's done,
+                or after kScaleBakeMaxNs regardless, the target becomes the
+                scale and the tree relays out once.
+*/
+void UILO::stepScaleTransition() {
+    constexpr Uint64 kScaleSettleNs  = 150'000'000;
+    constexpr Uint64 kScaleBakeMaxNs = 500'000'000;
+    const Uint64 now = SDL_GetTicksNS();
+    if (m_scaleTransition == ScaleTransition::Changing) {
+        if (now - m_scaleChangedNs < kScaleSettleNs) {
+            requestRedrawIn((float)(kScaleSettleNs - (now - m_scaleChangedNs)) * 1e-9f);
+            return;
+        }
+        if (m_scaleTarget == m_scale) { m_scaleTransition = ScaleTransition::None; return; }
+        if (m_renderer) m_renderer->prewarmRescaledText(m_scaleTarget / m_scale);
+        m_scaleTransition = ScaleTransition::Baking;
+        m_scaleChangedNs  = now;
+    }
+    if (m_renderer && m_renderer->isFontPrewarming() && now - m_scaleChangedNs < kScaleBakeMaxNs) {
+        m_redrawRequested = true;   // uploads land in beginFrame
+        return;
+    }
+    m_scaleTransition = ScaleTransition::None;
+    setScale(m_scaleTarget);
+}
+
+
+/*
+    markTreeDirty():
+    - Params:   none
+    - Returns:  void
+    - Desc:     Marks every registered element dirty and requests a redraw.
+*/
+void UILO::markTreeDirty() {
+    for (auto& e : m_elementPool) e->m_dirty = true;
+    m_redrawRequested = true;
+}
+
+
+/*
+    setPointerOverride(Vec2f pos, bool leftDown, bool rightDown):
+    - Params:   Vec2f pos, bool leftDown, bool rightDown
+    - Returns:  void
+    - Desc:     Makes update() hit-test a synthetic pointer at `pos`
+                (backing pixels) with the given button state instead of
+                SDL's mouse, until clearPointerOverride().
+*/
+void UILO::setPointerOverride(Vec2f pos, bool leftDown, bool rightDown) {
+    m_pointerOverride = true;
+    m_pointerPos      = pos;
+    m_pointerLeft     = leftDown;
+    m_pointerRight    = rightDown;
+}
 
 
 /*
@@ -118,6 +482,7 @@ void UILO::registerOverlay(Element* e, std::function<void()> onDismiss) {
     for (auto& ov : m_overlays)
         if (ov.element == e) return;
     m_overlays.push_back({e, std::move(onDismiss)});
+    m_redrawRequested = true;
 }
 
 
@@ -128,6 +493,7 @@ void UILO::registerOverlay(Element* e, std::function<void()> onDismiss) {
     - Desc:     Removes an element from the overlay list.
 */
 void UILO::unregisterOverlay(Element* e) {
+    m_redrawRequested = true;
     m_overlays.erase(
         std::remove_if(m_overlays.begin(), m_overlays.end(),
             [e](const OverlayEntry& ov) { return ov.element == e; }),
@@ -153,6 +519,7 @@ Element* UILO::addFloating(FreeElement f) {
     entry.yPos      = f.yPos;
     entry.draggable = f.draggable;
     m_floating.push_back(entry);
+    m_redrawRequested = true;
     return f.element;
 }
 
@@ -164,6 +531,7 @@ Element* UILO::addFloating(FreeElement f) {
     - Desc:     Removes a floating element by pointer.
 */
 void UILO::removeFloating(Element* e) {
+    m_redrawRequested = true;
     m_floating.erase(
         std::remove_if(m_floating.begin(), m_floating.end(),
             [e](const FloatingEntry& f) { return f.element == e; }),
@@ -195,10 +563,7 @@ void UILO::requestCursor(CursorType type, int priority) {
                 axis, or 0 when unset.
 */
 float UILO::getScrollLinkOffset(const std::string& linkId, bool horizontal) const {
-    if (linkId.empty()) return 0.f;
-    const auto& links = horizontal ? m_scrollLinksX : m_scrollLinksY;
-    auto it = links.find(linkId);
-    return it != links.end() ? it->second : 0.f;
+    return findLinkValue(horizontal ? LinkKind::ScrollX : LinkKind::ScrollY, linkId, 0.f);
 }
 
 
@@ -211,8 +576,7 @@ float UILO::getScrollLinkOffset(const std::string& linkId, bool horizontal) cons
 */
 void UILO::setScrollLinkOffset(const std::string& linkId, float offset, bool horizontal) {
     if (linkId.empty()) return;
-    auto& links = horizontal ? m_scrollLinksX : m_scrollLinksY;
-    links[linkId] = offset;
+    setLinkValue(resolveLink(horizontal ? LinkKind::ScrollX : LinkKind::ScrollY, linkId), offset);
 }
 
 
@@ -224,10 +588,7 @@ void UILO::setScrollLinkOffset(const std::string& linkId, float offset, bool hor
                 or 1 when unset.
 */
 float UILO::getZoomLinkValue(const std::string& linkId, bool horizontal) const {
-    if (linkId.empty()) return 1.f;
-    const auto& links = horizontal ? m_zoomLinksX : m_zoomLinksY;
-    auto it = links.find(linkId);
-    return it != links.end() ? it->second : 1.f;
+    return findLinkValue(horizontal ? LinkKind::ZoomX : LinkKind::ZoomY, linkId, 1.f);
 }
 
 
@@ -240,8 +601,103 @@ float UILO::getZoomLinkValue(const std::string& linkId, bool horizontal) const {
 */
 void UILO::setZoomLinkValue(const std::string& linkId, float zoom, bool horizontal) {
     if (linkId.empty()) return;
-    auto& links = horizontal ? m_zoomLinksX : m_zoomLinksY;
-    links[linkId] = zoom;
+    setLinkValue(resolveLink(horizontal ? LinkKind::ZoomX : LinkKind::ZoomY, linkId), zoom);
+}
+
+
+/*
+    findLinkValue(LinkKind kind, const std::string& linkId, float fallback):
+    - Params:   LinkKind kind, const std::string& linkId, float fallback
+    - Returns:  float
+    - Desc:     Looks a link id up without creating its slot, so the string
+                getters stay const. Returns `fallback` for an empty or
+                unknown id.
+*/
+float UILO::findLinkValue(LinkKind kind, const std::string& linkId, float fallback) const {
+    if (linkId.empty()) return fallback;
+    const auto& ids = m_linkIds[static_cast<size_t>(kind)];
+    auto it = ids.find(linkId);
+    return it != ids.end() ? m_links[it->second].value : fallback;
+}
+
+
+/*
+    resolveLink(LinkKind kind, const std::string& linkId):
+    - Params:   LinkKind kind, const std::string& linkId
+    - Returns:  LinkHandle
+    - Desc:     Returns the handle for a link id, creating its slot on first
+                use with the kind's resting value (0 scroll, 1 zoom). An
+                empty id gives an invalid handle.
+*/
+LinkHandle UILO::resolveLink(LinkKind kind, const std::string& linkId) {
+    if (linkId.empty()) return {};
+    auto& ids = m_linkIds[static_cast<size_t>(kind)];
+    auto [it, inserted] = ids.try_emplace(linkId, static_cast<uint32_t>(m_links.size()));
+    if (inserted) {
+        LinkSlot slot;
+        slot.value = (kind == LinkKind::ZoomX || kind == LinkKind::ZoomY) ? 1.f : 0.f;
+        m_links.push_back(std::move(slot));
+    }
+    return { it->second };
+}
+
+
+/*
+    setLinkValue(LinkHandle link, float value, const Element* source):
+    - Params:   LinkHandle link, float value, const Element* source
+    - Returns:  void
+    - Desc:     Stores a link's value. When it changed, every subscriber
+                but `source` is marked dirty so it picks the value up on
+                its next update; subscribers that have since been freed
+                are dropped.
+*/
+void UILO::setLinkValue(LinkHandle link, float value, const Element* source) {
+    if (link.index >= m_links.size()) return;
+    LinkSlot& slot = m_links[link.index];
+    if (slot.value == value) return;
+    slot.value = value;
+    auto& subs = slot.subscribers;
+    for (size_t i = 0; i < subs.size();) {
+        Element* e = resolve(subs[i]);
+        if (!e) { subs[i] = subs.back(); subs.pop_back(); continue; }
+        if (e != source) e->markDirty();
+        ++i;
+    }
+}
+
+
+/*
+    subscribeLink(LinkHandle link, const Element* element):
+    - Params:   LinkHandle link, const Element* element
+    - Returns:  bool
+    - Desc:     Adds `element` to the link's subscribers, once, so
+                setLinkValue() marks it dirty when the value changes.
+                Returns false for an invalid link or an element this UILO
+                holds no handle to; the caller must then poll.
+*/
+bool UILO::subscribeLink(LinkHandle link, const Element* element) {
+    const ElementHandle h = getHandle(element);
+    if (link.index >= m_links.size() || !h) return false;
+    auto& subs = m_links[link.index].subscribers;
+    if (std::find(subs.begin(), subs.end(), h) == subs.end()) subs.push_back(h);
+    return true;
+}
+
+
+/*
+    unsubscribeLink(LinkHandle link, const Element* element):
+    - Params:   LinkHandle link, const Element* element
+    - Returns:  void
+    - Desc:     Removes `element` from the link's subscribers, if it is
+                one. Used when an element's link id changes, so the old
+                link stops marking it dirty.
+*/
+void UILO::unsubscribeLink(LinkHandle link, const Element* element) {
+    const ElementHandle h = getHandle(element);
+    if (link.index >= m_links.size() || !h) return;
+    auto& subs = m_links[link.index].subscribers;
+    auto it = std::find(subs.begin(), subs.end(), h);
+    if (it != subs.end()) { *it = subs.back(); subs.pop_back(); }
 }
 
 
@@ -257,23 +713,273 @@ void UILO::setOnLiveResize(std::function<void()> cb) {
 }
 
 
+/*
+    setOnDemand(bool enabled):
+    - Params:   bool enabled
+    - Returns:  void
+    - Desc:     Switches on-demand rendering on or off. Either way the next
+                frame is requested so the switch itself is always drawn.
+*/
+void UILO::setOnDemand(bool enabled) {
+    m_onDemand        = enabled;
+    m_redrawRequested = true;
+}
+
+
+/*
+    requestRedrawIn(float seconds):
+    - Params:   float seconds
+    - Returns:  void
+    - Desc:     Asks for a frame no later than `seconds` from now, for
+                time-driven state such as a caret blink. Keeps the earliest
+                of several pending deadlines.
+*/
+void UILO::requestRedrawIn(float seconds) {
+    if (seconds <= 0.f) { m_redrawRequested = true; return; }
+    const Uint64 at = SDL_GetTicksNS() + (Uint64)((double)seconds * 1e9);
+    if (m_redrawDeadlineNs == 0 || at < m_redrawDeadlineNs) m_redrawDeadlineNs = at;
+}
+
+
+/*
+    animate(Element* element, Tween tween):
+    - Params:   Element* element, Tween tween
+    - Returns:  TweenId
+    - Desc:     Starts a tween on an element owned by this UILO and asks for
+                a frame so it begins even when on-demand mode is idle. While
+                any tween runs, update() keeps requesting frames (or, when
+                all are still in their delay, a deadline); with none it
+                requests nothing. Returns a null id for a foreign element
+                or a tween with no apply function.
+*/
+TweenId UILO::animate(Element* element, Tween tween) {
+    const TweenId id = m_animator.start(*this, element, std::move(tween));
+    if (id) m_redrawRequested = true;
+    return id;
+}
+
+
+/*
+    notifyBindingPublished():
+    - Params:   none
+    - Returns:  void
+    - Desc:     Called from a Binding's publish(), on any thread. The first
+                publish since the last drain also pushes an SDL user event
+                so a host parked in waitForFrame() wakes up; SDL_PushEvent
+                is thread-safe.
+*/
+void UILO::notifyBindingPublished() {
+    if (!m_bindingsPending.exchange(true, std::memory_order_acq_rel)) pushWakeEvent();
+}
+
+
+void UILO::pushWakeEvent() {
+    SDL_Event ev{};
+    ev.type = SDL_EVENT_USER;
+    SDL_PushEvent(&ev);
+}
+
+
+/*
+    post(std::function<void(UILO&)> command, uint64_t coalesceKey):
+    - Params:   std::function<void(UILO&)> command, uint64_t coalesceKey
+    - Returns:  void
+    - Desc:     Queues a command for the UI thread; safe from any thread.
+                With a non-zero key an already queued command under that
+                key is replaced in place. The first post after a drain
+                pushes a wake-up event like a binding publish.
+*/
+void UILO::post(std::function<void(UILO&)> command, uint64_t coalesceKey) {
+    if (!command) return;
+    {
+        std::lock_guard<std::mutex> lock(m_postMutex);
+        if (coalesceKey != 0) {
+            auto [it, added] = m_postedByKey.try_emplace(coalesceKey, m_posted.size());
+            if (!added) { m_posted[it->second].run = std::move(command); return; }
+        }
+        m_posted.push_back({ coalesceKey, std::move(command) });
+    }
+    if (!m_postPending.exchange(true, std::memory_order_acq_rel)) pushWakeEvent();
+}
+
+
+/*
+    post(ElementHandle target, uint16_t channel, std::function<void(Element&)> command):
+    - Params:   ElementHandle target, uint16_t channel,
+                std::function<void(Element&)> command
+    - Returns:  void
+    - Desc:     Element form of post(): coalesces per (target, channel) and
+                runs only if the target still resolves when drained.
+*/
+void UILO::post(ElementHandle target, uint16_t channel, std::function<void(Element&)> command) {
+    if (!target || !command) return;
+    const uint64_t key = (1ull << 63) | ((uint64_t)target.index << 16) | channel;
+    post([target, command = std::move(command)](UILO& ui) {
+        if (Element* e = ui.resolve(target)) command(*e);
+    }, key);
+}
+
+
+/*
+    drainPosted():
+    - Params:   none
+    - Returns:  void
+    - Desc:     Runs the commands posted since the last frame. The queue is
+                swapped out under the lock and run outside it, so producers
+                never wait on a command, and anything a command posts lands
+                in the next frame.
+*/
+void UILO::drainPosted() {
+    if (!m_postPending.exchange(false, std::memory_order_acq_rel)) return;
+    {
+        std::lock_guard<std::mutex> lock(m_postMutex);
+        m_postedDraining.swap(m_posted);
+        m_postedByKey.clear();
+    }
+    for (auto& c : m_postedDraining) c.run(*this);
+    m_postedDraining.clear();
+}
+
+
+void UILO::addBinding(BindingBase* binding) {
+    if (std::find(m_bindings.begin(), m_bindings.end(), binding) == m_bindings.end())
+        m_bindings.push_back(binding);
+}
+
+
+void UILO::removeBinding(BindingBase* binding) {
+    m_bindings.erase(std::remove(m_bindings.begin(), m_bindings.end(), binding), m_bindings.end());
+}
+
+
+void UILO::drainBindings() {
+    if (!m_bindingsPending.exchange(false, std::memory_order_acq_rel)) return;
+    // By index: a bound element's setter may register another binding.
+    for (size_t i = 0; i < m_bindings.size(); ++i) m_bindings[i]->drain();
+}
+
+
+/*
+    needsFrame():
+    - Params:   none
+    - Returns:  bool
+    - Desc:     Always true unless on-demand mode is on. Otherwise true when
+                a redraw was requested or its deadline passed, an event was
+                handled since the last render(), the window changed size, a
+                momentum scroll is coasting, a binding has a published value
+                or a post()ed command waiting, the renderer drew an animated
+                material last frame or has decoded textures to upload, or
+                any element on screen is dirty.
+*/
+bool UILO::needsFrame() const {
+    if (!m_onDemand || m_redrawRequested) return true;
+    if (m_redrawDeadlineNs != 0 && SDL_GetTicksNS() >= m_redrawDeadlineNs) return true;
+    if (isMacScrollMomentumActive()) return true;
+    if (m_bindingsPending.load(std::memory_order_acquire) ||
+        m_postPending.load(std::memory_order_acquire)) return true;
+    // Queued scroll/zoom only reaches the tree in update().
+    if (!m_pendingInput.empty()) return true;
+    if (m_renderer && (m_renderer->isAnimating() ||
+                       m_renderer->getSize() != m_prevWindowSize ||
+                       m_renderer->hasTextureUploads())) return true;
+    if (m_activePage && m_activePage->m_rootContainer->isDirty()) return true;
+    for (auto& f : m_floating)  if (f.element->isDirty())  return true;
+    for (auto& ov : m_overlays) if (ov.element->isDirty()) return true;
+    return false;
+}
+
+
+/*
+    waitForFrame(int maxWaitMs):
+    - Params:   int maxWaitMs
+    - Returns:  void
+    - Desc:     Blocks until a frame is needed: returns at once when
+                needsFrame() is true, otherwise sleeps in SDL's event wait
+                until an event arrives, the earliest redraw deadline passes,
+                or maxWaitMs elapses (-1 = no limit); while async textures
+                are loading it wakes every 16 ms to check on them. The
+                waking event is left in the queue for the host's normal
+                poll loop.
+*/
+void UILO::waitForFrame(int maxWaitMs) {
+    if (needsFrame()) return;
+    Sint32 timeoutMs = maxWaitMs;
+    if (m_redrawDeadlineNs != 0) {
+        const Uint64 now = SDL_GetTicksNS();
+        const Uint64 leftNs = m_redrawDeadlineNs > now ? m_redrawDeadlineNs - now : 0;
+        const Sint32 leftMs = (Sint32)((leftNs + 999999) / 1000000);
+        if (timeoutMs < 0 || leftMs < timeoutMs) timeoutMs = leftMs;
+    }
+    // Background texture decodes post no event; poll for their uploads.
+    constexpr Sint32 kTexturePollMs = 16;
+    if (m_renderer && m_renderer->isTextureLoading() &&
+        (timeoutMs < 0 || timeoutMs > kTexturePollMs))
+        timeoutMs = kTexturePollMs;
+    if (timeoutMs < 0) SDL_WaitEvent(nullptr);
+    else               SDL_WaitEventTimeout(nullptr, timeoutMs);
+}
+
+
+/*
+    setLayoutThreads(unsigned threads, size_t minSubtreeElements):
+    - Params:   unsigned threads, size_t minSubtreeElements
+    - Returns:  void
+    - Desc:     Starts (or replaces) the worker pool used for parallel
+                layout, or shuts it down when threads is 0. Containers hand
+                safe sibling subtrees of at least minSubtreeElements
+                elements to the pool once their slots are known.
+*/
+void UILO::setLayoutThreads(unsigned threads, size_t minSubtreeElements) {
+    m_layoutPool.reset();
+    if (threads > 0) m_layoutPool = std::make_unique<JobPool>(threads);
+    m_parallelMinElements = std::max<size_t>(1, minSubtreeElements);
+}
+
+
+/*
+    setFlatLayout(bool enabled):
+    - Params:   bool enabled
+    - Returns:  void
+    - Desc:     Switches the active page between the data-oriented layout
+                pass (FlatLayout) and the usual recursive tick. The flat
+                copy of the tree is built on the next update().
+*/
+void UILO::setFlatLayout(bool enabled) {
+    if (!enabled)               m_flatLayout.reset();
+    else if (!m_flatLayout)     m_flatLayout = std::make_unique<FlatLayout>();
+}
+
+
 /*
     update():
     - Params:   none
     - Returns:  void
-    - Desc:     Advances the UI by one frame. On the first frame -- and only
-                when UILO owns its window, never when embedded in a host -- it
-                installs the macOS native scroll and zoom monitors and the
-                live-resize configuration. Each frame it converts the SDL mouse
-                position from logical points to backing pixels, updates layout
-                for the active page and every floating element, culls elements
-                marked for deletion, then dispatches hover, left-click, and
-                right-click input. Floating elements are opaque to input: the
-                topmost one under the cursor consumes hover and clicks so the
-                page beneath is shielded, and draggable ones follow the cursor
+    - Desc:     Advances the UI by one frame. It first runs commands
+                post()ed from other threads. On the first frame -- and only
+                when UILO owns its window, never when embedded in a host --
+                it installs the macOS native scroll and zoom monitors and
+                the live-resize configuration. Each frame it resets the frame
+                arena, delivers the scroll and zoom input queued since the
+                last frame, applies values published to bindings, steps
+                running tweens, updates layout for the active page and
+                every floating element, prewarms a queued page when the
+                frame has time to spare, releases pages idle past the
+                release delay, culls elements marked for deletion, converts
+                the SDL mouse position from logical points to backing
+                pixels, then dispatches hover, left-click, and right-click
+                input. Floating elements are opaque to input: the topmost
+                one under the cursor consumes hover and clicks so the page
+                beneath is shielded, and draggable ones follow the cursor
                 while held.
 */
 void UILO::update() {
+    UILO_TRACE_ZONE("UILO::update");
+    m_frameArena.reset();
+#if UILO_PROFILER
+    ++m_profileFrame;
+#endif
+    drainPosted();
+
     static bool s_macInstalled = false;
     if (!s_macInstalled && m_renderer && m_renderer->ownsContext()) {
         s_macInstalled = true;
@@ -295,30 +1001,15 @@ void UILO::update() {
             return true;
         }, this);
         installMacScrollMonitor([this](float dyLines, float dxLines, bool momentum) -> bool {
-            float mx = m_mousePos.x, my = m_mousePos.y;
-            SDL_GetMouseState(&mx, &my);
-            if (m_renderer) if (SDL_Window* w = m_renderer->sdlWindow()) {
-                int lw = 1, lh = 1, pw = 1, ph = 1;
-                SDL_GetWindowSize(w, &lw, &lh);
-                SDL_GetWindowSizeInPixels(w, &pw, &ph);
-                if (lw > 0) mx *= (float)pw / (float)lw;
-                if (lh > 0) my *= (float)ph / (float)lh;
-            }
-            const Vec2f pos { mx, my };
-            dispatchScroll(pos, Vec2f{dxLines, dyLines}, true, momentum);
+            Vec2f pos = m_mousePos;
+            backingMouseState(pos);
+            queueScroll(pos, Vec2f{dxLines, dyLines}, true, momentum);
             return !isSDLScrollTarget(pos);
         });
         installMacZoomMonitor([this](float mag) -> bool {
-            float mx = m_mousePos.x, my = m_mousePos.y;
-            SDL_GetMouseState(&mx, &my);
-            if (m_renderer) if (SDL_Window* w = m_renderer->sdlWindow()) {
-                int lw = 1, lh = 1, pw = 1, ph = 1;
-                SDL_GetWindowSize(w, &lw, &lh);
-                SDL_GetWindowSizeInPixels(w, &pw, &ph);
-                if (lw > 0) mx *= (float)pw / (float)lw;
-                if (lh > 0) my *= (float)ph / (float)lh;
-            }
-            dispatchZoom(Vec2f{mx, my}, mag);
+            Vec2f pos = m_mousePos;
+            backingMouseState(pos);
+            queueZoom(pos, mag);
             return true;
         });
     }
@@ -328,13 +1019,27 @@ void UILO::update() {
     m_pendingCursor         = CursorType::Arrow;
     m_pendingCursorPriority = 0;
 
-    if (!m_activePage) return;
+    if (!m_activePage) { m_pendingInput.clear(); return; }
 
+    if (isScaleTransitioning()) stepScaleTransition();
+    // Ahead of layout, so this frame lays out the scrolled / zoomed state.
+    flushInput();
+    drainBindings();
+    m_animator.step(*this, m_deltaTime);
+    if (m_animator.isActive()) requestRedrawIn(m_animator.nextFrameIn());
+
+    Timer phase;
     const Vec2u windowSize = m_renderer->getSize();
     if (windowSize != m_prevWindowSize) {
+        m_redrawRequested = true;
         for (auto& e : m_elementPool) e->m_dirty = true;
         m_forceTreeUpdate = true;
         m_prevWindowSize = windowSize;
+        // Prewarmed layouts are for the old size.
+        for (auto& [name, page] : m_pages)
+            if (page->m_prewarmed && page.get() != m_activePage &&
+                std::find(m_prewarmQueue.begin(), m_prewarmQueue.end(), page.get()) == m_prewarmQueue.end())
+                m_prewarmQueue.push_back(page.get());
     } else {
         m_forceTreeUpdate = false;
     }
@@ -344,7 +1049,8 @@ void UILO::update() {
         { static_cast<float>(windowSize.x), static_cast<float>(windowSize.y) }
     };
 
-    m_activePage->update(logicalBounds, m_deltaTime);
+    if (m_flatLayout) m_flatLayout->run(m_activePage->m_rootContainer, logicalBounds, m_deltaTime);
+    else              m_activePage->update(logicalBounds, m_deltaTime);
 
     const float winW  = static_cast<float>(windowSize.x);
     const float winH  = static_cast<float>(windowSize.y);
@@ -358,38 +1064,53 @@ void UILO::update() {
         f.element->tick(slot, m_deltaTime);
     }
 
+    prewarmStep(logicalBounds, phase.elapsed());
+    releaseIdlePages();
+
     m_resizers.clear();
     m_activePage->m_rootContainer->collectResizers(m_resizers);
 
+    // Survivors whose parent is about to be freed drop the back-pointer so
+    // a later markDirty() doesn't walk into freed memory.
+    for (auto& e : m_elementPool)
+        if (e->m_parent && e->m_parent->m_markedForDeletion) e->m_parent = nullptr;
+
     m_elementPool.erase(
         std::remove_if(
             m_elementPool.begin(), m_elementPool.end(),
             [&](const std::unique_ptr<Element>& e) {
                 if (e->m_markedForDeletion) {
-                    if (!e->m_name.empty()) m_elements.erase(e->m_name);
+                    if (!e->m_name.empty()) {
+                        // A replacement may already hold the name.
+                        auto named = m_elements.find(e->m_name);
+                        if (named != m_elements.end() && named->second == e.get()) m_elements.erase(named);
+                        auto id = m_elementIds.find(ElementId(e->m_name).value);
+                        if (id != m_elementIds.end() && id->second == e.get()) m_elementIds.erase(id);
+                    }
+                    releaseHandleSlot(e->m_handleIndex);
                     return true;
                 }
                 return false;
             }
         ), m_elementPool.end()
     );
-
-    float mx, my;
-    SDL_GetMouseState(&mx, &my);
-    if (SDL_Window* w = m_renderer->sdlWindow()) {
-        int lw = 1, lh = 1, pw = 1, ph = 1;
-        SDL_GetWindowSize(w, &lw, &lh);
-        SDL_GetWindowSizeInPixels(w, &pw, &ph);
-        if (lw > 0) mx *= (float)pw / (float)lw;
-        if (lh > 0) my *= (float)ph / (float)lh;
-    }
-    m_mousePos = { mx, my };
+    m_lastLayoutMs = phase.restart() * 1000.f;
+
+    // One SDL query per frame for both position and buttons.
+    Vec2f pointer = m_pointerPos;
+    const uint32_t buttons = m_pointerOverride ? 0u : backingMouseState(pointer);
+    // Mid-transition the tree is drawn scaled from the origin; hit-test in
+    // its layout space.
+    if (const float k = scaleTransitionRatio(); k != 1.f) pointer = { pointer.x / k, pointer.y / k };
+    m_mousePos = pointer;
     const Vec2f mouse = m_mousePos;
 
     if (m_renderer) m_renderer->setMouseState(mouse);
 
-    bool leftDown  = (SDL_GetMouseState(nullptr, nullptr) & SDL_BUTTON_MASK(SDL_BUTTON_LEFT))  != 0;
-    bool rightDown = (SDL_GetMouseState(nullptr, nullptr) & SDL_BUTTON_MASK(SDL_BUTTON_RIGHT)) != 0;
+    bool leftDown  = m_pointerOverride ? m_pointerLeft
+                                       : (buttons & SDL_BUTTON_MASK(SDL_BUTTON_LEFT))  != 0;
+    bool rightDown = m_pointerOverride ? m_pointerRight
+                                       : (buttons & SDL_BUTTON_MASK(SDL_BUTTON_RIGHT)) != 0;
 
     auto* root = m_activePage->m_rootContainer;
 
@@ -488,6 +1209,7 @@ void UILO::update() {
     m_prevRightMouse = rightDown;
 
     m_forceTreeUpdate = false;
+    m_lastDispatchMs  = phase.elapsed() * 1000.f;
 }
 
 
@@ -496,15 +1218,48 @@ void UILO::update() {
     - Params:   none
     - Returns:  void
     - Desc:     Draws the active page, then floating elements, overlays, and
-                resizers in back-to-front order.
+                resizers in back-to-front order. Settles pending redraw
+                requests for on-demand mode. With setParallelRender() those
+                are recorded concurrently via Renderer::recordParallel().
 */
 void UILO::render() {
+    UILO_TRACE_ZONE("UILO::render");
+    m_redrawRequested = false;
+    if (m_redrawDeadlineNs != 0 && SDL_GetTicksNS() >= m_redrawDeadlineNs)
+        m_redrawDeadlineNs = 0;
     if (!m_activePage) return;
 
-    m_activePage->render();
-    for (auto& f : m_floating)  f.element->render();
-    for (auto& ov : m_overlays) ov.element->render();
-    for (auto* r : m_resizers)  r->render();
+    // A pending transitional scale draws the current layout scaled instead
+    // of laying out the tree again every step. drawGlass maps its panels
+    // through the transform; retained layers fall back to live drawing
+    // meanwhile (beginLayer refuses under a transform).
+    const float k = m_renderer ? scaleTransitionRatio() : 1.f;
+    if (k != 1.f) m_renderer->pushTransform(Transform2D::scale(k, k));
+
+    if (!m_parallelRender || !m_renderer || !m_layoutPool) {
+        m_activePage->render();
+        for (auto& f : m_floating)  f.element->paint();
+        for (auto& ov : m_overlays) ov.element->paint();
+        for (auto* r : m_resizers)  r->paint();
+    } else {
+        // Units in draw order: page, floating, overlays, then the resizers.
+        const size_t floating = m_floating.size();
+        const size_t overlays = m_overlays.size();
+        const size_t units    = 1 + floating + overlays + (m_resizers.empty() ? 0 : 1);
+        // Every slice resolves roles; the palette caches are filled here
+        // and only read until the slices have joined.
+        m_palette.beginConcurrentReads();
+        m_renderer->recordParallel(m_layoutPool.get(), units, [&](size_t i) {
+            if (i == 0)                        m_activePage->render();
+            else if (i <= floating)            m_floating[i - 1].element->paint();
+            else if (i <= floating + overlays) m_overlays[i - 1 - floating].element->paint();
+            else
+                for (auto* r : m_resizers) r->paint();
+        });
+        m_palette.endConcurrentReads();
+    }
+
+    if (k != 1.f) m_renderer->popTransform();
 }
 
 
@@ -521,15 +1276,106 @@ void UILO::dispatchScroll(const Vec2f& pos, Vec2f delta, bool precise, bool mome
     if (!m_activePage || (delta.x == 0.f && delta.y == 0.f)) return;
     m_mousePos = pos;
     m_inMomentumScroll = momentum;
-    Element* scrollOverlay = nullptr;
-    for (auto& ov : m_overlays)
-        if (ov.element->getBounds().contains(pos)) { scrollOverlay = ov.element; break; }
+    Element* scrollOverlay = overlayAt(pos);
     if (scrollOverlay) scrollOverlay->checkScroll(pos, delta, precise, momentum);
     else               m_activePage->m_rootContainer->checkScroll(pos, delta, precise, momentum);
     m_inMomentumScroll = false;
 }
 
 
+/*
+    queueScroll / queueZoom / flushInput:
+    - Desc:     Event-side halves of dispatchScroll / dispatchZoom. Queued
+                input merges into the previous entry when it is the same
+                kind with the same flags over the same overlay (or the
+                page): scroll deltas add, zoom ratios compose. Only
+                consecutive entries merge, so interleaved scroll and zoom
+                keep their order. flushInput() dispatches each entry once,
+                at its latest position.
+*/
+Element* UILO::overlayAt(const Vec2f& pos) const {
+    for (auto& ov : m_overlays)
+        if (ov.element->getBounds().contains(pos)) return ov.element;
+    return nullptr;
+}
+
+void UILO::queueScroll(const Vec2f& pos, Vec2f delta, bool precise, bool momentum) {
+    if (!m_activePage || (delta.x == 0.f && delta.y == 0.f)) return;
+    Element* overlay = overlayAt(pos);
+    if (!m_pendingInput.empty()) {
+        PendingInput& last = m_pendingInput.back();
+        if (last.kind == PendingInput::Scroll && last.overlay == overlay &&
+            last.precise == precise && last.momentum == momentum) {
+            last.pos    = pos;
+            last.delta += delta;
+            return;
+        }
+    }
+    PendingInput in;
+    in.kind     = PendingInput::Scroll;
+    in.overlay  = overlay;
+    in.pos      = pos;
+    in.delta    = delta;
+    in.precise  = precise;
+    in.momentum = momentum;
+    m_pendingInput.push_back(in);
+}
+
+void UILO::queueZoom(const Vec2f& pos, float magnification) {
+    if (!m_activePage || magnification == 0.f) return;
+    Element* overlay = overlayAt(pos);
+    if (!m_pendingInput.empty()) {
+        PendingInput& last = m_pendingInput.back();
+        if (last.kind == PendingInput::Zoom && last.overlay == overlay) {
+            // Receivers apply 1 + magnification; compose the ratios.
+            last.pos           = pos;
+            last.magnification = (1.f + last.magnification) * (1.f + magnification) - 1.f;
+            return;
+        }
+    }
+    PendingInput in;
+    in.kind          = PendingInput::Zoom;
+    in.overlay       = overlay;
+    in.pos           = pos;
+    in.magnification = magnification;
+    m_pendingInput.push_back(in);
+}
+
+void UILO::flushInput() {
+    if (m_pendingInput.empty()) return;
+    // Taken first: a handler may queue more, which waits for next frame.
+    std::vector<PendingInput> batch;
+    batch.swap(m_pendingInput);
+    for (const PendingInput& in : batch) {
+        if (in.kind == PendingInput::Scroll)
+            dispatchScroll(in.pos, in.delta, in.precise, in.momentum);
+        else
+            dispatchZoom(in.pos, in.magnification);
+    }
+    batch.clear();
+    if (m_pendingInput.empty()) m_pendingInput.swap(batch);   // keep the capacity
+}
+
+uint32_t UILO::backingMouseState(Vec2f& pos) const {
+    float mx = pos.x, my = pos.y;
+    const SDL_MouseButtonFlags buttons = SDL_GetMouseState(&mx, &my);
+    if (m_renderer) if (SDL_Window* w = m_renderer->sdlWindow()) {
+        // The pointer is over another of the app's windows: nowhere here.
+        if (SDL_Window* focus = SDL_GetMouseFocus(); focus && focus != w) {
+            pos = { -1.f, -1.f };
+            return 0;
+        }
+        int lw = 1, lh = 1, pw = 1, ph = 1;
+        SDL_GetWindowSize(w, &lw, &lh);
+        SDL_GetWindowSizeInPixels(w, &pw, &ph);
+        if (lw > 0) mx *= (float)pw / (float)lw;
+        if (lh > 0) my *= (float)ph / (float)lh;
+    }
+    pos = { mx, my };
+    return buttons;
+}
+
+
 /*
     dispatchZoom(const Vec2f& pos, float magnification):
     - Params:   const Vec2f& pos, float magnification
@@ -540,9 +1386,7 @@ void UILO::dispatchScroll(const Vec2f& pos, Vec2f delta, bool precise, bool mome
 void UILO::dispatchZoom(const Vec2f& pos, float magnification) {
     if (!m_activePage || magnification == 0.f) return;
     m_mousePos = pos;
-    Element* overlay = nullptr;
-    for (auto& ov : m_overlays)
-        if (ov.element->getBounds().contains(pos)) { overlay = ov.element; break; }
+    Element* overlay = overlayAt(pos);
     if (overlay) overlay->checkZoom(pos, magnification);
     else         m_activePage->m_rootContainer->checkZoom(pos, magnification);
 }
@@ -590,13 +1434,22 @@ bool UILO::isSDLScrollTarget(const Vec2f& pos) const {
     - Returns:  void
     - Desc:     Processes one SDL event. Mouse-wheel events map to zoom when
                 Ctrl/Cmd is held, horizontal scroll when Shift is held, or
-                normal scroll otherwise. Text input and key input route to the
-                focused interactible, with a filter that drops the stale
-                key-repeat events Wayland can deliver after a key is released.
-                UTF-8 text is decoded one codepoint at a time so batched or IME
-                input is not dropped.
+                normal scroll otherwise; scroll and zoom are queued and reach
+                the tree, coalesced, at the next update(). Text input and key
+                input route to the focused interactible, with a filter that
+                drops the stale key-repeat events Wayland can deliver after a
+                key is released. UTF-8 text is decoded one codepoint at a time
+                so batched or IME input is not dropped. Events addressed to
+                another window are ignored; every other event requests a
+                redraw for on-demand mode.
 */
 void UILO::handleEvent(const SDL_Event& event) {
+    // With several windows (Renderer::initShared) each UILO only takes its
+    // own window's events; app-wide ones (no window) reach all of them.
+    if (m_renderer) if (SDL_Window* own = m_renderer->sdlWindow())
+        if (SDL_Window* from = SDL_GetWindowFromEvent(&event); from && from != own) return;
+    // Any input may change hover, focus or layout; draw at least one frame.
+    m_redrawRequested = true;
     if (!m_activePage) return;
 
     if (event.type == SDL_EVENT_MOUSE_WHEEL) {
@@ -607,18 +1460,18 @@ void UILO::handleEvent(const SDL_Event& event) {
         const bool zoomShortcut = (mods & (SDL_KMOD_CTRL | SDL_KMOD_GUI)) != 0;
         if (zoomShortcut && dy != 0.f) {
             const float mag = dy * 0.1f;
-            dispatchZoom(m_mousePos, mag);
+            queueZoom(m_mousePos, mag);
             return;
         }
         if (shiftHeld && dx == 0.f && dy != 0.f) {
             const bool precise = std::fabs(dy - std::round(dy)) > 1e-4f
                               || (dy != 0.f && std::fabs(dy) < 1.f);
-            dispatchScroll(m_mousePos, Vec2f{dy, 0.f}, precise);
+            queueScroll(m_mousePos, Vec2f{dy, 0.f}, precise);
             return;
         }
         const bool precise = std::fabs(dy - std::round(dy)) > 1e-4f
                           || (dy != 0.f && std::fabs(dy) < 1.f);
-        dispatchScroll(m_mousePos, Vec2f{dx, dy}, precise);
+        queueScroll(m_mousePos, Vec2f{dx, dy}, precise);
     }
 
     if (event.type == SDL_EVENT_KEY_UP) {
@@ -656,11 +1509,11 @@ void UILO::handleEvent(const SDL_Event& event) {
         const bool zoomShortcut = (mods & (SDL_KMOD_CTRL | SDL_KMOD_GUI)) != 0;
         if (zoomShortcut) {
             if (event.key.key == SDLK_EQUALS || event.key.key == SDLK_KP_PLUS) {
-                dispatchZoom(m_mousePos, 0.1f);
+                queueZoom(m_mousePos, 0.1f);
                 return;
             }
             if (event.key.key == SDLK_MINUS || event.key.key == SDLK_KP_MINUS) {
-                dispatchZoom(m_mousePos, -0.1f);
+                queueZoom(m_mousePos, -0.1f);
                 return;
             }
         }
@@ -685,7 +1538,7 @@ void UILO::handleEvent(const SDL_Event& event) {
             }
 
             if (horizontal != 0.f || vertical != 0.f) {
-                dispatchScroll(m_mousePos, Vec2f{horizontal, vertical}, false);
+                queueScroll(m_mousePos, Vec2f{horizontal, vertical}, false);
                 return;
             }
         }
@@ -5,14 +5,42 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <atomic>
+#include <mutex>
 
 #include "Elements.hpp"
 #include "Palette.hpp"
+#include "Animation.hpp"
 #include "../include/renderer/Renderer.hpp"
+#include "utils/FrameArena.hpp"
+#include "utils/JobPool.hpp"
+#include "utils/ElementId.hpp"
 
 namespace uilo {
 
 class Interactible;
+class BindingBase;
+class CompiledLayout;
+template <typename T> class ElementRef;
+
+// UILO::getMemoryStats(): the renderer's caches plus the element pool.
+// Element bytes are each object's size plus what it owns on the heap
+// (Element::heapBytes), so approximate; waveform audio and peaks are
+// also broken out on their own.
+struct UiloMemoryStats {
+    struct ByType {
+        uint32_t count = 0;
+        uint64_t bytes = 0;
+    };
+    RendererMemoryStats renderer;
+    uint32_t elements     = 0;
+    uint64_t elementBytes = 0;
+    ByType   byType[kElementTypeCount];   // indexed by ElementType
+    uint64_t waveformSampleBytes = 0;
+    uint64_t waveformPeakBytes   = 0;
+
+    uint64_t totalBytes() const { return renderer.totalBytes() + elementBytes; }
+};
 
 /*
     UILO:
@@ -24,21 +52,84 @@ class Interactible;
 class UILO {
 public:
     UILO() = default;
+    // Detaches any Binding still registered, so bindings may outlive it.
+    ~UILO();
     UILO(Renderer& renderer, Page* page);
 
     void update();
     void render();
 
+    // On-demand rendering. When enabled, needsFrame() reports whether the
+    // next update()/render() would change anything: a pending redraw
+    // request or deadline, any handled SDL event, a dirty element tree, a
+    // window resize, momentum scrolling, a running tween, or an animated
+    // material on screen.
+    // Hosts that skip frames while it's false can park in waitForFrame()
+    // instead of spinning on vsync. State changed from outside an event
+    // callback (audio meters, network data) must call requestRedraw().
+    void setOnDemand(bool enabled);
+    bool isOnDemand() const { return m_onDemand; }
+    void requestRedraw()    { m_redrawRequested = true; }
+    void requestRedrawIn(float seconds);
+    bool needsFrame() const;
+    void waitForFrame(int maxWaitMs = -1);
+
+    // Parallel layout. With threads > 0, sibling subtrees of at least
+    // minSubtreeElements elements are laid out on that many worker threads
+    // alongside the calling thread. Subtrees holding update hooks, text
+    // wrapping, interactive widgets, linked scrolling or anything else that
+    // touches shared state stay on the main thread. 0 turns it off.
+    void setLayoutThreads(unsigned threads, size_t minSubtreeElements = 64);
+    JobPool* getLayoutPool()                  { return m_layoutPool.get(); }
+    size_t getParallelLayoutThreshold() const { return m_parallelMinElements; }
+
+    // Parallel draw recording. The page, each floating element, each
+    // overlay and the resizers are recorded on the layout pool, one bgfx
+    // encoder apiece, and land in that order. The palette is shared
+    // read-only meanwhile, and the built-in elements neither walk their
+    // parents nor touch shared state from render(); custom render()
+    // overrides must do the same. Needs setLayoutThreads(); off by default.
+    void setParallelRender(bool enabled) { m_parallelRender = enabled; }
+    bool isParallelRender() const        { return m_parallelRender; }
+
+    // Data-oriented layout (see FlatLayout). The active page's plain
+    // Column/Row stacks are solved from flat arrays instead of through
+    // their update() calls; every other element still ticks normally.
+    // Worth it on large, mostly static trees. Off by default.
+    void setFlatLayout(bool enabled);
+    bool isFlatLayout() const               { return m_flatLayout != nullptr; }
+
     void handleEvent(const SDL_Event& event);
     void dispatchScroll(const Vec2f& pos, Vec2f delta, bool precise, bool momentum = false);
     void dispatchZoom(const Vec2f& pos, float magnification);
     bool isSDLScrollTarget(const Vec2f& pos) const;
 
+    // Synthetic pointer. While set, update() hit-tests this backing-pixel
+    // position and button state instead of SDL's mouse; for benchmarks and
+    // scripted input. clearPointerOverride() hands the real mouse back.
+    void setPointerOverride(Vec2f pos, bool leftDown = false, bool rightDown = false);
+    void clearPointerOverride() { m_pointerOverride = false; }
+
     void setRenderer(Renderer& renderer) { m_renderer = &renderer; }
     void addPage(Page* page);
     void setPage(const std::string& pageName);
     void setActivePage(Page* page);
-    void setScale(float scale);
+    // `transitional`: for values that keep coming (pinch-to-zoom of the
+    // whole UI, a window crossing monitors). The tree keeps its layout and
+    // fonts at the current scale and is drawn GPU-scaled to the new one;
+    // once no new value has come for a moment, the text on screen is baked
+    // at the final size in the background, and then the tree relays out
+    // once. getScale() reports the layout scale throughout. Glass is
+    // mapped through the scale like everything else; retained layers are
+    // bypassed (drawn live) until it settles, since beginLayer refuses
+    // under a transform.
+    void setScale(float scale, bool transitional = false);
+    bool  isScaleTransitioning()    const { return m_scaleTransition != ScaleTransition::None; }
+    float getTargetScale()          const { return isScaleTransitioning() ? m_scaleTarget : m_scale; }
+    // Dirties every element, so the next update() lays out the whole tree
+    // and retained draw lists re-record. Colors and scale are resolved at
+    // render time, which is why changing them goes through here.
+    void markTreeDirty();
 
     void registerOverlay(Element* e, std::function<void()> onDismiss = {});
     void unregisterOverlay(Element* e);
@@ -55,14 +146,42 @@ public:
     Vec2f getMousePosition()        const { return m_mousePos; }
     bool isMomentumScrolling()      const { return m_inMomentumScroll; }
     bool isForcingTreeUpdate()      const { return m_forceTreeUpdate; }
+    // Wall time the last update() spent on layout (page, floating elements,
+    // pool sweep) and on input dispatch (hover, clicks, cursor).
+    float getLastLayoutMs()         const { return m_lastLayoutMs; }
+    float getLastDispatchMs()       const { return m_lastDispatchMs; }
     Renderer& getRenderer()         { return *m_renderer; }
+    // Per-frame scratch memory for layout and render temporaries; reset
+    // at the top of every update().
+    FrameArena& getFrameArena()     { return m_frameArena; }
 
 
-    void setPalette(const Palette& palette)     { m_palette = palette; }
-    void setPalette(Palette&& palette)          { m_palette = std::move(palette); }
+    void setPalette(const Palette& palette)     { m_palette = palette; markTreeDirty(); }
+    void setPalette(Palette&& palette)          { m_palette = std::move(palette); markTreeDirty(); }
     Palette& getPalette()                       { return m_palette; }
     const Palette& getPalette()                 const { return m_palette; }
 
+    // Tweens (see Animation.hpp), stepped once per update() ahead of
+    // layout. Each dirties only its target, and with none running on-demand
+    // mode can skip frames. animate() returns a null id when the element
+    // isn't attached to this UILO.
+    TweenId animate(Element* element, Tween tween);
+    void    cancelTween(TweenId id)                 { m_animator.cancel(id); }
+    void    cancelTweens(const Element* element)    { m_animator.cancelAll(*this, element); }
+    bool    isAnimating() const                     { return m_animator.isActive(); }
+
+    // Cross-thread mutation. post() may be called from any thread; the
+    // commands run on the UI thread at the top of the next update(), in
+    // posting order. A non-zero coalesce key replaces the command already
+    // queued under it (keeping its place), so a worker that posts faster
+    // than frames only gets its latest one applied. Keys with the top bit
+    // set are reserved for the element form, which keys on the target's
+    // handle plus a caller-chosen channel and skips targets freed by then.
+    // Plain values headed for widgets can skip the queue entirely through
+    // a Binding (lock-free publish()).
+    void post(std::function<void(UILO&)> command, uint64_t coalesceKey = 0);
+    void post(ElementHandle target, uint16_t channel, std::function<void(Element&)> command);
+
     void requestCursor(CursorType type, int priority = 0);
 
     float getScrollLinkOffset(const std::string& linkId, bool horizontal) const;
@@ -70,19 +189,111 @@ public:
     float getZoomLinkValue(const std::string& linkId, bool horizontal) const;
     void  setZoomLinkValue(const std::string& linkId, float zoom, bool horizontal);
 
+    // Handle form of the links above: an id resolves once to an index into
+    // a flat value table, so per-frame reads and writes hash nothing.
+    // subscribeLink() registers an element to be markDirty()'d when the
+    // value changes, so linked containers only lay out again when it
+    // does; the writer passed as `source` is skipped.
+    LinkHandle resolveLink(LinkKind kind, const std::string& linkId);
+    float      getLinkValue(LinkHandle link) const {
+        return link.index < m_links.size() ? m_links[link.index].value : 0.f;
+    }
+    void       setLinkValue(LinkHandle link, float value, const Element* source = nullptr);
+    // False when `element` has no handle (it isn't owned by this UILO);
+    // it must then poll getLinkValue() itself.
+    bool       subscribeLink(LinkHandle link, const Element* element);
+    // Drops the subscription again, for an element moving to another id.
+    void       unsubscribeLink(LinkHandle link, const Element* element);
+
     void setOnLiveResize(std::function<void()> cb);
 
     template <typename T>
     T* getElement(const std::string& name) {
         auto it = m_elements.find(name);
         if (it == m_elements.end()) return nullptr;
-        return dynamic_cast<T*>(it->second);
+        return elementCast<T>(it->second);
     }
+    // Same lookup keyed by a hashed name ("meterL"_id), without hashing
+    // a string on every call.
+    template <typename T>
+    T* getElement(ElementId id) {
+        auto it = m_elementIds.find(id.value);
+        if (it == m_elementIds.end()) return nullptr;
+        return elementCast<T>(it->second);
+    }
+    // Resolve a name once and keep the result: the returned ElementRef is
+    // type-checked here and costs a handle check per use afterwards.
+    template <typename T> ElementRef<T> getElementRef(const std::string& name);
+    template <typename T> ElementRef<T> getElementRef(ElementId id);
+
+    // Generational handles (see ElementHandle). resolve() returns nullptr
+    // once the element has been erase()d or freed.
+    ElementHandle getHandle(const Element* element) const;
+    Element* resolve(ElementHandle handle) const {
+        if (handle.index >= m_handleSlots.size()) return nullptr;
+        const HandleSlot& slot = m_handleSlots[handle.index];
+        if (slot.generation != handle.generation || !slot.element) return nullptr;
+        return slot.element->m_markedForDeletion ? nullptr : slot.element;
+    }
+    template <typename T>
+    T* resolve(ElementHandle handle) const { return elementCast<T>(resolve(handle)); }
+
+    // Drops a page that isn't active. Its whole tree is marked for
+    // deletion and freed together at the end of the next update().
+    bool removePage(const std::string& pageName);
+    // Lays out an inactive page ahead of time, starting its font and
+    // texture loads, so a later setPage() presents it at once. The work
+    // runs inside update(), one page per frame and only on frames whose
+    // own layout left time over; the layout is kept (and redone after a
+    // window resize) until the page is released. Update hooks on that
+    // page fire for the prewarm tick. False for an unknown page.
+    bool prewarmPage(const std::string& pageName);
+    // Builds a page from a compiled layout (see CompiledLayout.hpp) and
+    // adds it or, when a page of that name exists, hot-reloads it: in
+    // place when the layout still has the tree's shape, otherwise by
+    // swapping in a new tree (the old one is freed at the end of the next
+    // update()). False when the layout is invalid or its root is neither
+    // a Column nor a Row.
+    bool loadPage(const CompiledLayout& layout, const std::string& pageName);
+    // Pages not shown for `seconds` release their elements' resources
+    // (Element::releaseResources) and reload them when next shown or
+    // prewarmed. Negative, the default, keeps everything resident.
+    void setPageReleaseDelay(float seconds) { m_pageReleaseDelay = seconds; }
+
+    // Walks the element pool and the renderer's caches; meant for an
+    // overlay or a log line, not every frame.
+    UiloMemoryStats getMemoryStats() const;
+
+#if UILO_PROFILER
+    // Element profiler (see utils/Profiler.hpp and ProfilerOverlay). Each
+    // update() starts a new profile frame. topProfiledSubtrees() fills
+    // `out` with up to `count` elements profiled in the last two frames,
+    // costliest smoothed update + render time first.
+    uint32_t getProfileFrame() const { return m_profileFrame; }
+    void     topProfiledSubtrees(size_t count, std::vector<Element*>& out) const;
+#endif
 
 private:
     std::vector<std::unique_ptr<Element>>                   m_elementPool;
     std::unordered_map<std::string, Element*>               m_elements;
+    std::unordered_map<uint64_t, Element*>                  m_elementIds;   // ElementId(name).value
+
+    // Handle table: a freed slot bumps its generation and is reused.
+    struct HandleSlot {
+        Element* element    = nullptr;
+        uint32_t generation = 1;
+    };
+    std::vector<HandleSlot> m_handleSlots;
+    std::vector<uint32_t>   m_freeHandleSlots;
+    uint32_t acquireHandleSlot(Element* element);
+    void     releaseHandleSlot(uint32_t index);
     std::unordered_map<std::string, std::unique_ptr<Page>>  m_pages;
+    std::vector<Page*> m_prewarmQueue;
+    float              m_pageReleaseDelay = -1.f;
+    void prewarmStep(Rectf& screenBounds, float layoutSeconds);
+    void releaseIdlePages();
+    // Notes when the outgoing active page was last shown.
+    void leavePage(Page* page);
 
     struct OverlayEntry {
         Element*              element;
@@ -101,30 +312,77 @@ private:
     };
     std::vector<FloatingEntry> m_floating;
 
+    // Scroll / zoom input gathered between frames (handleEvent, the macOS
+    // monitors) and delivered at the top of update(). A new event merges
+    // into the last queued one when kind, flags and overlay target match,
+    // so a 1000 Hz wheel or a pinch burst costs one tree walk per frame.
+    struct PendingInput {
+        enum Kind : uint8_t { Scroll, Zoom };
+        Kind     kind          = Scroll;
+        Element* overlay       = nullptr;   // overlay under pos, or the page
+        Vec2f    pos{};                     // latest event's
+        Vec2f    delta{};                   // Scroll: summed
+        float    magnification = 0.f;       // Zoom: composed ratio - 1
+        bool     precise       = false;
+        bool     momentum      = false;
+    };
+    std::vector<PendingInput> m_pendingInput;
+    Element* overlayAt(const Vec2f& pos) const;
+    void     queueScroll(const Vec2f& pos, Vec2f delta, bool precise, bool momentum = false);
+    void     queueZoom(const Vec2f& pos, float magnification);
+    void     flushInput();
+    // SDL's mouse position in backing pixels; returns its button mask.
+    uint32_t backingMouseState(Vec2f& pos) const;
+
     Page* m_activePage = nullptr;
 
     float m_scale = 1.f;
     float m_deltaTime = 0.f;
 
+    // setScale(s, true): Changing while values arrive, Baking once they
+    // stop, until the fonts are in (or kScaleBakeMaxNs) and m_scale moves.
+    enum class ScaleTransition : uint8_t { None, Changing, Baking };
+    ScaleTransition m_scaleTransition = ScaleTransition::None;
+    float  m_scaleTarget     = 1.f;
+    Uint64 m_scaleChangedNs  = 0;      // SDL_GetTicksNS() of the last value / bake start
+    void   stepScaleTransition();
+    // Draw-time factor from the laid-out scale to the requested one.
+    float  scaleTransitionRatio() const { return isScaleTransitioning() ? m_scaleTarget / m_scale : 1.f; }
+
     Timer m_timer;
+    FrameArena m_frameArena;
+    std::unique_ptr<JobPool> m_layoutPool;
+    size_t     m_parallelMinElements = 64;
+    bool       m_parallelRender      = false;
+    std::unique_ptr<FlatLayout> m_flatLayout;
 
     Renderer* m_renderer = nullptr;
     Vec2u     m_prevWindowSize = {0u, 0u};
     Vec2f     m_mousePos       = {};
     bool      m_inMomentumScroll = false;
     bool      m_forceTreeUpdate = false;
+    bool      m_pointerOverride = false;
+    Vec2f     m_pointerPos      = {};
+    bool      m_pointerLeft     = false;
+    bool      m_pointerRight    = false;
+    float     m_lastLayoutMs    = 0.f;
+    float     m_lastDispatchMs  = 0.f;
 
     std::function<void()> m_onLiveResize;
 
     bool m_prevLeftMouse  = false;
     bool m_prevRightMouse = false;
 
-    Palette m_palette;
+    Palette  m_palette;
+    Animator m_animator;
 
-    std::unordered_map<std::string, float> m_scrollLinksX;
-    std::unordered_map<std::string, float> m_scrollLinksY;
-    std::unordered_map<std::string, float> m_zoomLinksX;
-    std::unordered_map<std::string, float> m_zoomLinksY;
+    struct LinkSlot {
+        float                      value = 0.f;
+        std::vector<ElementHandle> subscribers;
+    };
+    std::vector<LinkSlot>                     m_links;
+    std::unordered_map<std::string, uint32_t> m_linkIds[4];   // by LinkKind
+    float findLinkValue(LinkKind kind, const std::string& linkId, float fallback) const;
 
     CursorType m_pendingCursor         = CursorType::Arrow;
     int        m_pendingCursorPriority = 0;
@@ -135,8 +393,73 @@ private:
 
     Uint64 m_lastKeyUpNs = 0;
 
+    bool   m_onDemand         = false;
+    // requestRedraw() may come from a render slice or an audio callback.
+    std::atomic<bool> m_redrawRequested{ true };
+    Uint64 m_redrawDeadlineNs = 0;     // SDL_GetTicksNS(); 0 = none
+
+    // Bindings (see Binding.hpp) with elements here; drained each update()
+    // once a publish() from another thread has set m_bindingsPending.
+    std::vector<BindingBase*> m_bindings;
+    std::atomic<bool>         m_bindingsPending{ false };
+    void addBinding(BindingBase* binding);
+    void removeBinding(BindingBase* binding);
+    void notifyBindingPublished();
+    void drainBindings();
+
+    // post() queue; producers hold m_postMutex only to append.
+    struct PostedCommand {
+        uint64_t                   key = 0;
+        std::function<void(UILO&)> run;
+    };
+    std::mutex                             m_postMutex;
+    std::vector<PostedCommand>             m_posted;
+    std::unordered_map<uint64_t, size_t>   m_postedByKey;   // key -> index in m_posted
+    std::vector<PostedCommand>             m_postedDraining;
+    std::atomic<bool>                      m_postPending{ false };
+    void drainPosted();
+    // Wakes a host parked in waitForFrame(); any thread.
+    void pushWakeEvent();
+
+#if UILO_PROFILER
+    uint32_t m_profileFrame = 0;
+#endif
+
     friend class Element;
     friend class Interactible;
+    friend class BindingBase;
 };
 
+// Cached, typed reference to a named element (UILO::getElementRef). The
+// name lookup and type check happen once; get() only confirms through the
+// element's handle that it hasn't been erased, and returns nullptr after.
+template <typename T>
+class ElementRef {
+public:
+    ElementRef() = default;
+
+    T* get() const { return (m_ui && m_ui->resolve(m_handle)) ? m_ptr : nullptr; }
+    T* operator->() const { return get(); }
+    explicit operator bool() const { return get() != nullptr; }
+    ElementHandle getHandle() const { return m_handle; }
+
+private:
+    ElementRef(const UILO* ui, T* ptr) : m_ui(ui), m_ptr(ptr) {
+        if (ptr) m_handle = ui->getHandle(ptr);
+        if (!m_handle) { m_ui = nullptr; m_ptr = nullptr; }
+    }
+
+    const UILO*   m_ui  = nullptr;
+    T*            m_ptr = nullptr;
+    ElementHandle m_handle;
+
+    friend class UILO;
+};
+
+template <typename T>
+ElementRef<T> UILO::getElementRef(const std::string& name) { return ElementRef<T>(this, getElement<T>(name)); }
+
+template <typename T>
+ElementRef<T> UILO::getElementRef(ElementId id) { return ElementRef<T>(this, getElement<T>(id)); }
+
 }
\ No newline at end of file
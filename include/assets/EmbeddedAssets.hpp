@@ -1,13 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <vector>
 #include "EmbeddedFont.hpp"
 #include "EmbeddedIcons.hpp"
 
 namespace uilo {
 
-// Use the embedded DejaVu Sans font
-inline const std::vector<uint8_t>& EMBEDDED_FONT = EMBEDDED_DEJAVUSANS_FONT;
+// Use the embedded DejaVu Sans font (a view of the array, never copied)
+inline constexpr std::span<const uint8_t> EMBEDDED_FONT{EMBEDDED_DEJAVUSANS_FONT};
 
 } // namespace uilo
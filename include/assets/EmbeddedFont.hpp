@@ -1,13 +1,13 @@
 #pragma once
 
 #include <cstdint>
-#include <vector>
 
 namespace uilo {
 
 // Embedded font: DejaVuSans.ttf
 // Size: 759720 bytes
-inline const std::vector<uint8_t> EMBEDDED_DEJAVUSANS_FONT = {
+// A constant array, so it sits in read-only data and nothing copies it at startup.
+inline constexpr uint8_t EMBEDDED_DEJAVUSANS_FONT[] = {
     0x00, 0x01, 0x00, 0x00, 0x00, 0x14, 0x01, 0x00, 0x00, 0x04, 0x00, 0x40,
     0x46, 0x46, 0x54, 0x4D, 0xA4, 0x90, 0xD1, 0xC7, 0x00, 0x00, 0x01, 0x4C,
     0x00, 0x00, 0x00, 0x1C, 0x47, 0x44, 0x45, 0x46, 0x8E, 0xEC, 0x94, 0xC3,
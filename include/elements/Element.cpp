@@ -1,24 +1,128 @@
 #include "Element.hpp"
 #include "../UILO.hpp"
+#include "../utils/SlabPool.hpp"
+#include <cstdio>
 
 namespace uilo {
+
+const char* elementTypeName(ElementType type) {
+    switch (type) {
+        case ElementType::Column:           return "Column";
+        case ElementType::Row:              return "Row";
+        case ElementType::ScrollableColumn: return "ScrollableColumn";
+        case ElementType::ScrollableRow:    return "ScrollableRow";
+        case ElementType::Grid:             return "Grid";
+        case ElementType::Canvas:           return "Canvas";
+        case ElementType::VirtualColumn:    return "VirtualColumn";
+        case ElementType::VirtualRow:       return "VirtualRow";
+        case ElementType::Spacer:           return "Spacer";
+        case ElementType::Text:             return "Text";
+        case ElementType::Image:            return "Image";
+        case ElementType::TiledImage:       return "TiledImage";
+        case ElementType::Waveform:         return "Waveform";
+        case ElementType::Button:           return "Button";
+        case ElementType::Slider:           return "Slider";
+        case ElementType::Dropdown:         return "Dropdown";
+        case ElementType::Knob:             return "Knob";
+        case ElementType::TextBox:          return "TextBox";
+        case ElementType::Resizer:          return "Resizer";
+        case ElementType::NONE:             break;
+    }
+    return "Element";
+}
     
+    void* Element::operator new(std::size_t size) { return SlabPool::allocate(size); }
+    void  Element::operator delete(void* p, std::size_t size) noexcept { SlabPool::deallocate(p, size); }
+
     Rectf Element::getBounds() const { return m_bounds; }
     Modifier& Element::getModifier() { return m_modifier; }
-    bool Element::isDirty() const { return m_dirty; }
-    void Element::erase() { m_markedForDeletion = true; }
+    bool Element::isDirty() const {
+        if (!m_modifier.getVisible() && !m_visibilityChanged) return false;
+        return m_dirty;
+    }
+    // The parent still lists this element until its next update() prunes
+    // it, so that update must not be skipped.
+    void Element::erase() { m_markedForDeletion = true; invalidateLayout(); }
+
+    void Element::markDirty() {
+        m_dirty = true;
+        invalidateLayout();
+    }
+
+    void Element::invalidateLayout() {
+        for (Element* e = this; e; e = e->m_parent) {
+            e->m_layoutDirty         = true;
+            e->m_subtreeParallelSafe = false;
+        }
+    }
+
+    void Element::translate(Vec2f delta) {
+        m_bounds.position           += delta;
+        m_subtreeBounds.position    += delta;
+        m_lastParentBounds.position += delta;
+        m_dirty = true;
+    }
+
+    void Element::updateSubtreeCache() {
+        m_subtreeBounds = m_bounds;
+        const bool hooks = m_modifier.getOnUpdateStart() || m_modifier.getOnUpdateEnd();
+        m_subtreeLive         = wantsUpdate() || hooks;
+        m_subtreeParallelSafe = !hooks && parallelSafe();
+        m_subtreeSize         = 1;
+    }
     ElementType Element::getType() const { return m_type; }
 
+    ElementHandle Element::getHandle() const {
+        return m_uiloRef ? m_uiloRef->getHandle(this) : ElementHandle{};
+    }
+
     float Element::getDeltaTime() const { return m_uiloRef ? m_uiloRef->getDeltaTime() : 0.f; }
+    FrameArena* Element::getFrameArena() const {
+        if (FrameArena* worker = JobPool::jobArena()) return worker;
+        return m_uiloRef ? &m_uiloRef->getFrameArena() : nullptr;
+    }
 
     Color Element::resolveColor(std::string_view role, Color literal) const {
         if (!m_uiloRef) return literal;
         return m_uiloRef->getPalette().resolve(role, literal);
     }
 
+    Color Element::resolveColor(const Role& role, Color literal) const {
+        if (!m_uiloRef) return literal;
+        return m_uiloRef->getPalette().resolve(role, literal);
+    }
+
+    namespace {
+        // Corners for any gradient; for a stop gradient also its ramp,
+        // baked into the renderer's gradient table when `ramp` is given.
+        bool resolveActiveGradient(const Gradient& g, const Palette& palette,
+                                   Renderer& renderer, Color out[4], GradientRamp* ramp) {
+            g.resolve(palette, out);
+            if (!g.hasStops())
+                return out[0].a > 0 || out[1].a > 0 || out[2].a > 0 || out[3].a > 0;
+
+            thread_local std::vector<GradientColorStop> resolved;
+            thread_local std::vector<GradientRampStop>  stops;
+            g.resolveStops(palette, resolved);
+            bool visible = false;
+            stops.clear();
+            for (const auto& s : resolved) {
+                stops.push_back({ s.offset, s.color.color });
+                visible |= s.color.color.a > 0;
+            }
+            if (visible && ramp) {
+                float geom[4];
+                g.rampGeometry(geom);
+                *ramp = renderer.bakeGradientRamp(stops.data(), stops.size(),
+                                                  g.kind == GradientKind::Radial, geom);
+            }
+            return visible;
+        }
+    } // anon
+
     bool Element::resolveGradient(const Gradient& literal,
                                   std::string_view gradientRole,
-                                  Color out[4]) const {
+                                  Color out[4], GradientRamp* ramp) const {
         if (!m_uiloRef) return false;
         const Palette& palette = m_uiloRef->getPalette();
 
@@ -28,21 +132,88 @@ namespace uilo {
                 g = named;
         }
         if (!g->active()) return false;
+        return resolveActiveGradient(*g, palette, m_uiloRef->getRenderer(), out, ramp);
+    }
+
+    bool Element::resolveGradient(const Gradient& literal,
+                                  const Role& gradientRole,
+                                  Color out[4], GradientRamp* ramp) const {
+        if (!m_uiloRef) return false;
+        const Palette& palette = m_uiloRef->getPalette();
 
-        g->resolve(palette, out);
-        return out[0].a > 0 || out[1].a > 0 || out[2].a > 0 || out[3].a > 0;
+        const Gradient* g = &literal;
+        if (!gradientRole.empty()) {
+            if (const Gradient* named = palette.getGradient(gradientRole))
+                g = named;
+        }
+        if (!g->active()) return false;
+        return resolveActiveGradient(*g, palette, m_uiloRef->getRenderer(), out, ramp);
     }
 
-    void Element::tick(Rectf& parentBounds, float dt) {
-        if (m_uiloRef && m_uiloRef->isForcingTreeUpdate()) {
-            m_dirty = true;
+    bool Element::recordTick(const Rectf& parentBounds) {
+        const bool forced = m_uiloRef && m_uiloRef->isForcingTreeUpdate();
+        if (forced) m_dirty = true;
+        const bool visible = m_modifier.getVisible();
+        m_visibilityChanged = visible != m_wasVisible;
+        if (m_visibilityChanged) {
+            m_wasVisible  = visible;
+            m_dirty       = true;
+            m_layoutDirty = true;
         }
 
+        const float scale = m_uiloRef ? m_uiloRef->getScale() : 1.f;
+        const bool sameInputs = parentBounds == m_lastParentBounds && scale == m_lastTickScale;
+        m_lastParentBounds = parentBounds;
+        m_lastTickScale    = scale;
+        return !forced && sameInputs;
+    }
+
+    void Element::tick(Rectf& parentBounds, float dt) {
+#if UILO_PROFILER
+        const uint64_t t0 = profilerNowNs();
+#endif
+        const bool sameInputs = recordTick(parentBounds);
+
         if (m_modifier.getOnUpdateStart()) m_modifier.getOnUpdateStart()(this);
-        update(parentBounds, dt);
+        // Decided after onUpdateStart so a hook that changes this element
+        // is laid out on the same tick.
+        if (sameInputs && !m_layoutDirty && !wantsUpdate()) {
+            tickClean(dt);
+        } else {
+            m_layoutDirty = false;
+            update(parentBounds, dt);
+        }
         if (m_modifier.getOnUpdateEnd())   m_modifier.getOnUpdateEnd()(this);
+        updateSubtreeCache();
+#if UILO_PROFILER
+        profileFrame().updateNs += profilerNowNs() - t0;
+#endif
     }
 
+#if UILO_PROFILER
+    ElementProfile& Element::profileFrame() {
+        const uint32_t frame = m_uiloRef ? m_uiloRef->getProfileFrame() : 0;
+        if (m_profile.frame != frame) m_profile.roll(frame);
+        return m_profile;
+    }
+
+    void Element::paint() {
+        Renderer* renderer = m_uiloRef ? m_uiloRef->m_renderer : nullptr;
+        uint32_t submits0 = 0, vertices0 = 0;
+        if (renderer) renderer->getProfileCounters(submits0, vertices0);
+        const uint64_t t0 = profilerNowNs();
+        render();
+        ElementProfile& p = profileFrame();
+        p.renderNs += profilerNowNs() - t0;
+        if (renderer) {
+            uint32_t submits1 = 0, vertices1 = 0;
+            renderer->getProfileCounters(submits1, vertices1);
+            p.draws    += submits1 - submits0;
+            p.vertices += vertices1 - vertices0;
+        }
+    }
+#endif
+
     void Element::resize(const Rectf& parent) {
         float scale = m_uiloRef ? m_uiloRef->getScale() : 1.f;
         float op = m_modifier.getOuterPadding() * scale;
@@ -129,7 +300,15 @@ namespace uilo {
         if (m_uiloRef == &uiloRef) return;
         m_uiloRef = &uiloRef;
         uiloRef.m_elementPool.emplace_back(this);
-        if (!m_name.empty()) uiloRef.m_elements[m_name] = this;
+        m_handleIndex = uiloRef.acquireHandleSlot(this);
+        if (!m_name.empty()) {
+            uiloRef.m_elements[m_name] = this;
+            Element*& byId = uiloRef.m_elementIds[ElementId(m_name).value];
+            if (byId && byId->m_name != m_name)
+                std::fprintf(stderr, "[UILO] element names '%s' and '%s' hash to the same ElementId\n",
+                             byId->m_name.c_str(), m_name.c_str());
+            byId = this;
+        }
     }
 
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -7,6 +8,8 @@
 #include "Modifier.hpp"
 #include "../../include/utils/Math.hpp"
 #include "../utils/Gradient.hpp"
+#include "../renderer/shapes/GradientRamp.hpp"
+#include "../utils/Profiler.hpp"
 
 namespace uilo {
 
@@ -22,10 +25,13 @@ enum class ElementType {
     ScrollableRow,
     Grid,
     Canvas,
+    VirtualColumn,
+    VirtualRow,
 
     Spacer,
     Text,
     Image,
+    TiledImage,
     Waveform,
 
     Button,
@@ -35,31 +41,88 @@ enum class ElementType {
     TextBox,
     Resizer,
 };
+inline constexpr size_t kElementTypeCount = (size_t)ElementType::Resizer + 1;
+// "Column", "TextBox", ...; "Element" for NONE.
+const char* elementTypeName(ElementType type);
+
+// Main axis of a container that stacks its children like a plain
+// (non-scrolling) Column or Row; see Element::layoutAxis().
+enum class LayoutAxis : uint8_t {
+    None,
+    Vertical,
+    Horizontal,
+};
 
 class UILO;
+class FrameArena;
+class Element;
+template <typename T> class Binding;
+
+// Weak reference to an element registered with a UILO. Unlike a raw
+// pointer it can be kept across frames: once the element is erase()d
+// (or its page removed) UILO::resolve() returns nullptr, and the slot's
+// generation makes sure a later element reusing it doesn't answer for
+// the old one.
+struct ElementHandle {
+    uint32_t index      = static_cast<uint32_t>(-1);
+    uint32_t generation = 0;
+
+    explicit operator bool() const { return generation != 0; }
+    bool operator==(const ElementHandle& o) const { return index == o.index && generation == o.generation; }
+};
+
+// A scroll / zoom link id as resolved by UILO::resolveLink(). Ids are per
+// kind: "lanes" as ScrollY and as ZoomY are separate values.
+enum class LinkKind : uint8_t { ScrollX, ScrollY, ZoomX, ZoomY };
+struct LinkHandle {
+    uint32_t index = static_cast<uint32_t>(-1);
+    bool valid() const { return index != static_cast<uint32_t>(-1); }
+};
 
 class Element {
 public:
-    Element() = default;
+    Element() { m_modifier.m_owner.element = this; }
     virtual ~Element() = default;
 
+    // Elements are carved out of SlabPool size classes rather than
+    // individual heap blocks.
+    static void* operator new(std::size_t size);
+    static void  operator delete(void* p, std::size_t size) noexcept;
+
     Rectf getBounds() const;
     Modifier& getModifier();
     virtual bool isDirty() const;
+    // Flag this element for redraw and relayout. Its ancestors are flagged
+    // for relayout too so the next update reaches it. Setters call this;
+    // call it yourself after changing state through getOptions().
+    void markDirty();
     bool isHovered() const { return m_hovered; }
     UILO* getUILO() const { return m_uiloRef; }
+    const std::string& getName() const { return m_name; }
+    // Handle to this element; null until it's attached to a UILO.
+    ElementHandle getHandle() const;
     float getDeltaTime() const; // defined in Element.cpp (needs UILO complete type)
+    // Scratch memory reset every frame (see FrameArena); nullptr when the
+    // element isn't attached to a UILO.
+    FrameArena* getFrameArena() const;
     // Resolves a per-widget color through the owning UILO's Palette.
     // Returns `literal` unchanged when there's no UILO or the role is
     // empty/"none" or unknown. Defined in Element.cpp.
     Color resolveColor(std::string_view role, Color literal) const;
+    // Interned-role forms of the two resolvers; these hit the Palette's
+    // per-role cache instead of hashing the name.
+    Color resolveColor(const Role& role, Color literal) const;
     // Resolves an options gradient for drawing. A non-empty `gradientRole`
     // that names a palette gradient wins over `literal`; each stop's own
     // role is then resolved to a color. Returns true when the result should
-    // be drawn (an active gradient with at least one visible corner) and
-    // fills `out` in TL, TR, BL, BR order. Defined in Element.cpp.
+    // be drawn (an active gradient with at least one visible corner or
+    // stop) and fills `out` in TL, TR, BL, BR order. For a linear / radial
+    // gradient `ramp`, when given, is baked for the renderer to sample;
+    // `out` is then its fallback. Defined in Element.cpp.
     bool resolveGradient(const Gradient& literal, std::string_view gradientRole,
-                         Color out[4]) const;
+                         Color out[4], GradientRamp* ramp = nullptr) const;
+    bool resolveGradient(const Gradient& literal, const Role& gradientRole,
+                         Color out[4], GradientRamp* ramp = nullptr) const;
     void erase();
 
     virtual void setUILO(UILO& uiloRef);
@@ -70,6 +133,14 @@ public:
     // the lifecycle hooks always fire.
     void tick(Rectf& parentBounds, float dt);
     virtual void render() = 0;
+    // Non-virtual wrapper around render(), its counterpart for drawing:
+    // what the profiler times. Containers and UILO paint() their children.
+#if UILO_PROFILER
+    void paint();
+    const ElementProfile& getProfile() const { return m_profile; }
+#else
+    void paint() { render(); }
+#endif
     virtual bool checkLeftClick(const Vec2f& mousePosition);
     virtual bool checkRightClick(const Vec2f& mousePosition);
     virtual bool checkHover(const Vec2f& mousePosition);
@@ -90,26 +161,106 @@ public:
 
     // Recursively collect all Resizer-type descendant elements
     virtual void collectResizers(std::vector<Element*>&) {}
+    // Append this element and every element it owns (children, popups,
+    // headers). UILO::removePage() uses it to free a page's whole tree.
+    virtual void collectSubtree(std::vector<Element*>& out) { out.push_back(this); }
+    // Heap memory owned beyond the object itself (name, child list, sample
+    // buffers). Approximate; feeds UILO::getMemoryStats().
+    virtual size_t heapBytes() const { return m_name.capacity(); }
+    // Drop GPU resources and caches that update() / render() rebuild on
+    // demand. UILO calls it on pages left idle (setPageReleaseDelay).
+    virtual void releaseResources() {}
 
     ElementType getType() const;
 
 protected:
+    // Forget pending changes without rendering; used when a container culls
+    // this element because it lies outside the visible viewport.
+    virtual void clearDirty() { m_dirty = false; }
+    // Refresh the m_subtree* fields after a tick. Containers fold in their
+    // children.
+    virtual void updateSubtreeCache();
+
+    // Incremental layout. tick() skips update() when the parent bounds and
+    // scale are the same as last time, nothing called invalidateLayout()
+    // on this element or below it, and wantsUpdate() is false. Elements
+    // that poll per-frame state (drags, caret blink, linked scroll) return
+    // true from wantsUpdate(). They should call markDirty() when that
+    // state switches on, so their ancestors start ticking them again.
+    virtual bool wantsUpdate() const { return false; }
+    // Runs instead of update() on a skipped tick. Containers tick the
+    // children that still need it with their previous slots.
+    virtual void tickClean(float dt) { (void)dt; }
+    // Moves this element and its subtree by `delta` as laid out, without
+    // running update(): for a parent whose slot for it only moved (a
+    // scroll). The tick that follows with the moved slot is then clean.
+    // Overrides also shift anything else they keep in window space.
+    virtual void translate(Vec2f delta);
+    void invalidateLayout();
+    // True when this element's update() only touches its own state (and
+    // its children's), so its subtree may be laid out on a worker thread.
+    // Hooks, renderer access, SDL polling and UILO writes don't qualify.
+    virtual bool parallelSafe() const { return false; }
+    // Vertical / Horizontal when update() is exactly the stacking pass of
+    // a non-scrolling Column / Row, so FlatLayout may solve this element
+    // and its children from its arrays instead of calling update().
+    virtual LayoutAxis layoutAxis() const { return LayoutAxis::None; }
+    // The bookkeeping half of tick(): applies forced updates and
+    // visibility changes and remembers the inputs. Returns true when they
+    // match the previous tick and no full update is forced.
+    bool recordTick(const Rectf& parentBounds);
+
     UILO* m_uiloRef             = nullptr;
     std::string m_name          = "";
 
     Rectf m_bounds     = {};
     Rectf m_pastBounds = {};
+    // Bounds of this element and everything below it as of the last tick(),
+    // so hit-testing can skip whole subtrees the cursor is nowhere near.
+    Rectf m_subtreeBounds = {};
+    Rectf m_lastParentBounds = {};
+    float m_lastTickScale    = 0.f;
+    // Set by the container that last laid this element out.
+    Element* m_parent        = nullptr;
+    // Slot in the owning UILO's handle table.
+    uint32_t m_handleIndex   = static_cast<uint32_t>(-1);
 
     bool m_dirty                = true;
+    bool m_layoutDirty          = true;
+    // This element or a visible descendant must be ticked every frame
+    // (wantsUpdate() or an onUpdateStart/onUpdateEnd hook).
+    bool m_subtreeLive          = false;
+    // Every element in the subtree is parallelSafe() and hook-free, as of
+    // the last tick; invalidateLayout() clears it up the parent chain.
+    bool m_subtreeParallelSafe  = false;
+    size_t m_subtreeSize        = 1;
+    // Visibility as of the last tick(). A hidden element never renders, so
+    // its m_dirty is never cleared; isDirty() ignores it unless it was
+    // shown or hidden this tick.
+    bool m_wasVisible           = true;
+    bool m_visibilityChanged    = false;
     bool m_markedForDeletion    = false;
     bool m_hovered              = false;
+    // Some descendant is hovered; it still has to see the cursor leave even
+    // when the cursor is outside m_subtreeBounds.
+    bool m_hoverInSubtree       = false;
 
     ElementType m_type          = ElementType::NONE;
     Modifier m_modifier         = Modifier();
 
+#if UILO_PROFILER
+    ElementProfile m_profile;
+    // m_profile, rolled over first if it still counts an earlier frame.
+    ElementProfile& profileFrame();
+#endif
+
     friend class UILO;
     friend class Container;
     friend class Canvas;
+    friend class Modifier;
+    friend class FlatLayout;
+    friend class ProfilerOverlay;
+    friend class Animator;
 };
 
 }
\ No newline at end of file
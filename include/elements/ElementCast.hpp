@@ -0,0 +1,45 @@
+#pragma once
+
+#include <type_traits>
+
+#include "Element.hpp"
+
+namespace uilo {
+
+// ElementType of each built-in element class, so elementCast() can check
+// the tag instead of going through RTTI. Classes without an entry (bases,
+// user subclasses) fall back to dynamic_cast.
+template <typename T> struct ElementTypeOf { static constexpr ElementType value = ElementType::NONE; };
+
+template <> struct ElementTypeOf<Column>        { static constexpr ElementType value = ElementType::Column; };
+template <> struct ElementTypeOf<Row>           { static constexpr ElementType value = ElementType::Row; };
+template <> struct ElementTypeOf<Canvas>        { static constexpr ElementType value = ElementType::Canvas; };
+template <> struct ElementTypeOf<VirtualColumn> { static constexpr ElementType value = ElementType::VirtualColumn; };
+template <> struct ElementTypeOf<VirtualRow>    { static constexpr ElementType value = ElementType::VirtualRow; };
+template <> struct ElementTypeOf<Spacer>        { static constexpr ElementType value = ElementType::Spacer; };
+template <> struct ElementTypeOf<Text>          { static constexpr ElementType value = ElementType::Text; };
+template <> struct ElementTypeOf<Image>         { static constexpr ElementType value = ElementType::Image; };
+template <> struct ElementTypeOf<TiledImage>    { static constexpr ElementType value = ElementType::TiledImage; };
+template <> struct ElementTypeOf<Waveform>      { static constexpr ElementType value = ElementType::Waveform; };
+template <> struct ElementTypeOf<Button>        { static constexpr ElementType value = ElementType::Button; };
+template <> struct ElementTypeOf<Slider>        { static constexpr ElementType value = ElementType::Slider; };
+template <> struct ElementTypeOf<Dropdown>      { static constexpr ElementType value = ElementType::Dropdown; };
+template <> struct ElementTypeOf<Knob>          { static constexpr ElementType value = ElementType::Knob; };
+template <> struct ElementTypeOf<Textbox>       { static constexpr ElementType value = ElementType::TextBox; };
+template <> struct ElementTypeOf<Resizer>       { static constexpr ElementType value = ElementType::Resizer; };
+
+// Checked downcast: the ElementType tag when T has one and it matches,
+// dynamic_cast otherwise. Returns nullptr when `e` isn't a T.
+template <typename T>
+T* elementCast(Element* e) {
+    if (!e) return nullptr;
+    if constexpr (std::is_same_v<T, Element>) {
+        return e;
+    } else {
+        constexpr ElementType tag = ElementTypeOf<T>::value;
+        if (tag != ElementType::NONE && e->getType() == tag) return static_cast<T*>(e);
+        return dynamic_cast<T*>(e);
+    }
+}
+
+} // namespace uilo
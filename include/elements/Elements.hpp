@@ -4,9 +4,13 @@
 #include "containers/Column.hpp"
 #include "containers/Row.hpp"
 #include "containers/Canvas.hpp"
+#include "containers/VirtualList.hpp"
+#include "containers/TreeView.hpp"
+#include "containers/FlatLayout.hpp"
 
 #include "decoration/Spacer.hpp"
 #include "decoration/Image.hpp"
+#include "decoration/TiledImage.hpp"
 #include "decoration/Text.hpp"
 #include "decoration/Waveform.hpp"
 
@@ -18,5 +22,14 @@
 #include "interactible/Resizer.hpp"
 #include "interactible/Textbox.hpp"
 
+// Widgets
+#include "widgets/Filebrowser.hpp"
+
+// Debug tools (UILO_PROFILER builds only)
+#include "widgets/ProfilerOverlay.hpp"
+
+// Typed casts
+#include "ElementCast.hpp"
+
 // Factory
 #include "Factory.hpp"
\ No newline at end of file
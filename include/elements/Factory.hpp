@@ -26,6 +26,29 @@ inline Canvas* canvas(
     const std::string& name = ""
 ) { return new Canvas(modifier, options, children, name); }
 
+// virtualColumn / virtualRow build a list that materializes only the
+// rows in view; see VirtualListOptions for the item count, extent and the
+// create / bind callbacks.
+inline VirtualColumn* virtualColumn(
+    Modifier modifier = {},
+    VirtualListOptions options = {},
+    const std::string& name = ""
+) { return new VirtualColumn(modifier, options, name); }
+
+// treeView lists a lazily fetched tree through a virtual list; see
+// TreeViewOptions::setFetchChildren for the node provider.
+inline TreeView* treeView(
+    Modifier modifier = {},
+    TreeViewOptions options = {},
+    const std::string& name = ""
+) { return new TreeView(modifier, options, name); }
+
+inline VirtualRow* virtualRow(
+    Modifier modifier = {},
+    VirtualListOptions options = {},
+    const std::string& name = ""
+) { return new VirtualRow(modifier, options, name); }
+
 // freeColumn / freeRow build a normal Column/Row but mark the result as
 // floating: it lives outside the page layout flow and is positioned in
 // window space by UILO::addFloating(). Width and height come from the
@@ -55,6 +78,13 @@ inline FreeElement freeRow(
     const std::string& name = ""
 ) { return { new Row(modifier, options, children, name) }; }
 
+#if UILO_PROFILER
+// Per-element profiler table; see ProfilerOverlay.
+inline FreeElement profilerOverlay(Modifier modifier = {}, size_t rows = 20) {
+    return { new ProfilerOverlay(modifier, rows) };
+}
+#endif
+
 inline Spacer* spacer(
     Modifier modifier = {}, 
     SpacerOptions options = {}, 
@@ -67,6 +97,12 @@ inline Image* image(
     const std::string& name = ""
 ) { return new Image(modifier, options, name); }
 
+inline TiledImage* tiledImage(
+    Modifier modifier = {},
+    TiledImageOptions options = {},
+    const std::string& name = ""
+) { return new TiledImage(modifier, options, name); }
+
 inline Text* text(
     Modifier modifier = {}, 
     TextOptions options = {}, 
@@ -109,6 +145,23 @@ inline Dropdown* dropdown(
     const std::string& name = ""
 ) { return new Dropdown(modifier, options, items, name); }
 
+// Large item lists: read in place from the caller's storage, or through a
+// callback, instead of being copied. See Dropdown.
+inline Dropdown* dropdown(
+    Modifier modifier,
+    DropdownOptions options,
+    std::span<const std::string> items,
+    const std::string& name = ""
+) { return new Dropdown(modifier, options, items, name); }
+
+inline Dropdown* dropdown(
+    Modifier modifier,
+    DropdownOptions options,
+    size_t itemCount,
+    DropdownItemFn itemAt,
+    const std::string& name = ""
+) { return new Dropdown(modifier, options, itemCount, std::move(itemAt), name); }
+
 inline Resizer* resizer(
     Modifier modifier = {}, 
     ResizerOptions options = {}, 
@@ -121,4 +174,10 @@ inline Textbox* textbox(
     const std::string& name = ""
 ) { return new Textbox(modifier, options, name); }
 
+inline Filebrowser* filebrowser(
+    Modifier modifier = {},
+    FilebrowserOptions options = {},
+    const std::string& name = ""
+) { return new Filebrowser(modifier, options, name); }
+
 }
\ No newline at end of file
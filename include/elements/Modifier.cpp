@@ -1,39 +1,69 @@
 #include "Modifier.hpp"
+#include "Element.hpp"
 #include <algorithm>
 
 namespace uilo {
 
 Modifier& Modifier::setWidth(Dimension dim) {
     if (dim.percent) dim.value = std::clamp(dim.value, 1.f, 100.f);
+    if (dim == m_width) return *this;
     m_width = dim;
+    touch();
     return *this;
 }
 
 Modifier& Modifier::setHeight(Dimension dim) {
     if (dim.percent) dim.value = std::clamp(dim.value, 1.f, 100.f);
+    if (dim == m_height) return *this;
     m_height = dim;
+    touch();
     return *this;
 }
 
-Modifier& Modifier::setAlign(Align alignment) { m_align = alignment; return *this; }
-Modifier& Modifier::setOuterPadding(float padding) { m_outerPadding = padding; return *this; }
-Modifier& Modifier::setVisible(bool visible) { m_visible = visible; return *this; }
-Modifier& Modifier::ignoreScroll(bool ignore) { m_ignoreScroll = ignore; return *this; }
-Modifier& Modifier::setFreePosition(const Vec2f& freePos) { m_freePosition = freePos; return *this; }
+Modifier& Modifier::setAlign(Align alignment) {
+    if (alignment != m_align) { m_align = alignment; touch(); }
+    return *this;
+}
+Modifier& Modifier::setOuterPadding(float padding) {
+    if (padding != m_outerPadding) { m_outerPadding = padding; touch(); }
+    return *this;
+}
+Modifier& Modifier::setVisible(bool visible) {
+    if (visible != m_visible) { m_visible = visible; touch(); }
+    return *this;
+}
+Modifier& Modifier::ignoreScroll(bool ignore) {
+    if (ignore != m_ignoreScroll) { m_ignoreScroll = ignore; touch(); }
+    return *this;
+}
+Modifier& Modifier::setFreePosition(const Vec2f& freePos) {
+    if (!(freePos == m_freePosition)) { m_freePosition = freePos; touch(); }
+    return *this;
+}
+// Render-only, and Dropdown re-applies it every frame: no relayout.
 Modifier& Modifier::setMaterial(const Material& m) { m_material = m; return *this; }
+void Modifier::touch() {
+    if (m_owner.element) m_owner.element->invalidateLayout();
+}
+
 // setOnLeftClick / setOnRightClick / setOnHover / setOnScroll are templated
 // in the header so they can auto-wrap user lambdas with different shapes.
 
 Dimension Modifier::getWidth() const { return m_width; }
 Dimension Modifier::getHeight() const { return m_height; }
 Align Modifier::getAlign() const { return m_align; }
-const FuncPtr& Modifier::getOnLeftClick() const { return m_onLeftClick; }
-const FuncPtr& Modifier::getOnRightClick() const { return m_onRightClick; }
-const FuncPtr& Modifier::getOnHoverEnter() const { return m_onHoverEnter; }
-const FuncPtr& Modifier::getOnHoverExit() const { return m_onHoverExit; }
-const FuncPtr& Modifier::getOnUpdateStart() const { return m_onUpdateStart; }
-const FuncPtr& Modifier::getOnUpdateEnd() const { return m_onUpdateEnd; }
-const ScrollFuncPtr& Modifier::getOnScroll() const { return m_onScroll; }
+namespace {
+const FuncPtr       kNoHandler;
+const ScrollFuncPtr kNoScrollHandler;
+}
+
+const FuncPtr& Modifier::getOnLeftClick() const   { return m_handlers.table ? m_handlers.table->leftClick   : kNoHandler; }
+const FuncPtr& Modifier::getOnRightClick() const  { return m_handlers.table ? m_handlers.table->rightClick  : kNoHandler; }
+const FuncPtr& Modifier::getOnHoverEnter() const  { return m_handlers.table ? m_handlers.table->hoverEnter  : kNoHandler; }
+const FuncPtr& Modifier::getOnHoverExit() const   { return m_handlers.table ? m_handlers.table->hoverExit   : kNoHandler; }
+const FuncPtr& Modifier::getOnUpdateStart() const { return m_handlers.table ? m_handlers.table->updateStart : kNoHandler; }
+const FuncPtr& Modifier::getOnUpdateEnd() const   { return m_handlers.table ? m_handlers.table->updateEnd   : kNoHandler; }
+const ScrollFuncPtr& Modifier::getOnScroll() const { return m_handlers.table ? m_handlers.table->scroll     : kNoScrollHandler; }
 float Modifier::getOuterPadding() const { return m_outerPadding; }
 bool Modifier::getVisible() const { return m_visible; }
 bool Modifier::getIgnoreScroll() const { return m_ignoreScroll; }
@@ -1,11 +1,12 @@
 #pragma once
 
-#include <functional>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include "../../include/utils/Math.hpp"
 #include "../utils/Utils.hpp"
 #include "../utils/Material.hpp"
+#include "../utils/InlineFunction.hpp"
 
 namespace uilo {
 
@@ -15,9 +16,11 @@ class Element; // fwd: callbacks receive a self-pointer
 // element that fired it, so lambdas can mutate the element they're
 // attached to without capturing it from the outside. The public setters
 // below accept many friendlier shapes (no-arg, generic `Element*`,
-// element-typed `Button*` etc.) and wrap them down to these.
-using FuncPtr       = std::function<void(Element*)>;
-using ScrollFuncPtr = std::function<void(Element*, float)>;
+// element-typed `Button*` etc.) and wrap them down to these. They hold
+// the wrapped lambda inline, so setting a handler doesn't allocate unless
+// its captures outgrow the buffer.
+using FuncPtr       = InlineFunction<void(Element*)>;
+using ScrollFuncPtr = InlineFunction<void(Element*, float)>;
 
 namespace detail {
 
@@ -95,8 +98,8 @@ public:
     //   .setOnLeftClick([](){ ... })                 // legacy no-arg
     //   .setOnLeftClick([](Element* self){ ... })    // generic self-ptr
     //   .setOnLeftClick([](Button*  self){ ... })    // typed self-ptr
-    template <class F> Modifier& setOnLeftClick(F&& f)  { m_onLeftClick  = detail::makeClickCb(std::forward<F>(f));  return *this; }
-    template <class F> Modifier& setOnRightClick(F&& f) { m_onRightClick = detail::makeClickCb(std::forward<F>(f));  return *this; }
+    template <class F> Modifier& setOnLeftClick(F&& f)  { handlers().leftClick  = detail::makeClickCb(std::forward<F>(f));  touch(); return *this; }
+    template <class F> Modifier& setOnRightClick(F&& f) { handlers().rightClick = detail::makeClickCb(std::forward<F>(f));  touch(); return *this; }
 
     // Edge-triggered hover callbacks. `onHoverEnter` fires once when the
     // cursor first enters the element bounds; `onHoverExit` fires once
@@ -104,21 +107,22 @@ public:
     // callback — handlers should react to the transitions and toggle
     // state on the element itself if a persistent visual change is
     // wanted.
-    template <class F> Modifier& setOnHoverEnter(F&& f) { m_onHoverEnter = detail::makeClickCb(std::forward<F>(f)); return *this; }
-    template <class F> Modifier& setOnHoverExit(F&& f)  { m_onHoverExit  = detail::makeClickCb(std::forward<F>(f)); return *this; }
+    template <class F> Modifier& setOnHoverEnter(F&& f) { handlers().hoverEnter = detail::makeClickCb(std::forward<F>(f)); touch(); return *this; }
+    template <class F> Modifier& setOnHoverExit(F&& f)  { handlers().hoverExit  = detail::makeClickCb(std::forward<F>(f)); touch(); return *this; }
     // Back-compat alias: legacy `setOnHover` callers get enter semantics
     // (which is how it had always behaved on Element — see Element.cpp).
     template <class F> Modifier& setOnHover(F&& f)      { return setOnHoverEnter(std::forward<F>(f)); }
 
-    template <class F> Modifier& setOnScroll(F&& f)     { m_onScroll = detail::makeScrollCb(std::forward<F>(f));     return *this; }
+    template <class F> Modifier& setOnScroll(F&& f)     { handlers().scroll = detail::makeScrollCb(std::forward<F>(f));     touch(); return *this; }
 
     // Per-frame lifecycle hooks. `onUpdateStart` fires at the top of every
     // update tick (before layout/state is recomputed); `onUpdateEnd` fires
-    // after. Both receive the element self-pointer so handlers can read
+    // after. They keep firing on ticks where an unchanged element skips
+    // its layout. Both receive the element self-pointer so handlers can read
     // current bounds or mutate options based on per-frame state (e.g.
     // `if (r->isDragging()) r->getOptions().setColor(...)`).
-    template <class F> Modifier& setOnUpdateStart(F&& f) { m_onUpdateStart = detail::makeClickCb(std::forward<F>(f)); return *this; }
-    template <class F> Modifier& setOnUpdateEnd(F&& f)   { m_onUpdateEnd   = detail::makeClickCb(std::forward<F>(f)); return *this; }
+    template <class F> Modifier& setOnUpdateStart(F&& f) { handlers().updateStart = detail::makeClickCb(std::forward<F>(f)); touch(); return *this; }
+    template <class F> Modifier& setOnUpdateEnd(F&& f)   { handlers().updateEnd   = detail::makeClickCb(std::forward<F>(f)); touch(); return *this; }
 
     Modifier& setOuterPadding(float padding);
     Modifier& setVisible(bool visible);
@@ -143,21 +147,57 @@ public:
     const Material& getMaterial()       const;
 
 private:
+    // The element this modifier belongs to. Setters that change something
+    // invalidate its layout; copies start detached and assignment keeps
+    // the destination's owner.
+    struct Owner {
+        Element* element = nullptr;
+        Owner() = default;
+        Owner(const Owner&) {}
+        Owner& operator=(const Owner&) { return *this; }
+    };
+    void touch();
+
+    // Callbacks live in one table allocated when the first one is set, so
+    // a Modifier without handlers (most of them) stays small and cheap to
+    // copy. Copies get their own table.
+    struct Handlers {
+        FuncPtr       leftClick;
+        FuncPtr       rightClick;
+        FuncPtr       hoverEnter;
+        FuncPtr       hoverExit;
+        FuncPtr       updateStart;
+        FuncPtr       updateEnd;
+        ScrollFuncPtr scroll;
+    };
+    struct HandlerTable {
+        std::unique_ptr<Handlers> table;
+        HandlerTable() = default;
+        HandlerTable(const HandlerTable& o) : table(o.table ? std::make_unique<Handlers>(*o.table) : nullptr) {}
+        HandlerTable(HandlerTable&&) noexcept = default;
+        HandlerTable& operator=(const HandlerTable& o) {
+            if (this != &o) table = o.table ? std::make_unique<Handlers>(*o.table) : nullptr;
+            return *this;
+        }
+        HandlerTable& operator=(HandlerTable&&) noexcept = default;
+    };
+    Handlers& handlers() {
+        if (!m_handlers.table) m_handlers.table = std::make_unique<Handlers>();
+        return *m_handlers.table;
+    }
+
+    Owner m_owner;
     Dimension m_width                   = 100_pct;
     Dimension m_height                  = 100_pct;
     Align m_align                       = Align::Left | Align::Top;
-    FuncPtr m_onLeftClick;
-    FuncPtr m_onRightClick;
-    FuncPtr m_onHoverEnter;
-    FuncPtr m_onHoverExit;
-    FuncPtr m_onUpdateStart;
-    FuncPtr m_onUpdateEnd;
-    ScrollFuncPtr m_onScroll;
+    HandlerTable m_handlers;
     float m_outerPadding                = 0.f;
     bool m_visible                      = true;
     bool m_ignoreScroll                 = false;
     Vec2f m_freePosition = {0.f, 0.f};
     Material m_material;
+
+    friend class Element;
 };
 
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "../../UILO.hpp"
+#include "../../utils/Trace.hpp"
 #include "../../renderer/Shapes.hpp"
 #include "../../utils/RenderUtils.hpp"
 
@@ -25,7 +26,16 @@ Canvas::Canvas(Modifier modifier, CanvasOptions options, contains children, cons
     m_type = ElementType::Canvas;
     // Children passed through the contains list land at (0,0) in
     // canvas-space; reposition them later with setChildPosition().
-    for (auto* c : children) m_positions[c] = {0.f, 0.f};
+    for (auto* c : children) m_positions[c] = Placement{};
+}
+
+Canvas::~Canvas() {
+    if (m_uiloRef && m_grid.geo.valid()) m_uiloRef->getRenderer().destroyGeometry(m_grid.geo);
+}
+
+void Canvas::releaseResources() {
+    if (m_uiloRef && m_grid.geo.valid()) m_uiloRef->getRenderer().destroyGeometry(m_grid.geo);
+    m_grid = GridCache{};
 }
 
 Vec2f Canvas::snap(Vec2f v) const {
@@ -66,7 +76,7 @@ void Canvas::setZoom(float zx, float zy) {
     m_zoomX = cx;
     m_zoomY = cy;
     m_pan   = clampPan(m_pan);
-    m_dirty = true;
+    markDirty();
 }
 
 void Canvas::zoomAt(Vec2f pivotWindowPx, float factor) {
@@ -100,40 +110,95 @@ void Canvas::zoomAt(Vec2f pivotWindowPx, float factorX, float factorY) {
     m_zoomY = newZY;
     m_pan   = clampPan({ canvasPt.x - localPx.x / newZX,
                          canvasPt.y - localPx.y / newZY });
-    m_dirty = true;
+    markDirty();
 }
 
 void Canvas::addChild(Element* element, float x, float y) {
     if (!element) return;
     m_children.push_back(element);
-    m_positions[element] = snap({x, y});
+    ++m_childrenVersion;   // the index picks it up on the next update
+    m_positions[element] = Placement{ snap({x, y}) };
     if (m_uiloRef) element->setUILO(*m_uiloRef);
-    m_dirty = true;
+    markDirty();
 }
 
 void Canvas::setChildPosition(Element* element, float x, float y) {
     if (!element) return;
-    m_positions[element] = snap({x, y});
-    m_dirty = true;
+    Placement& p = m_positions[element];
+    p.pos = snap({x, y});
+    if (m_indexValid && m_indexVersion == m_childrenVersion &&
+        p.child < m_children.size() && m_children[p.child] == element)
+        m_index.move(p.child, { p.pos, m_index.rectOf(p.child).size });
+    markDirty();
 }
 
 Vec2f Canvas::getChildPosition(Element* element) const {
     auto it = m_positions.find(element);
-    return it == m_positions.end() ? Vec2f{0.f, 0.f} : it->second;
+    return it == m_positions.end() ? Vec2f{0.f, 0.f} : it->second.pos;
+}
+
+Vec2f Canvas::childExtent(const Element* child, float baseScale) const {
+    const Dimension dw = child->m_modifier.getWidth();
+    const Dimension dh = child->m_modifier.getHeight();
+    return { dw.percent ? (dw.value * 0.01f * m_bounds.size.x) : (dw.value * baseScale),
+             dh.percent ? (dh.value * 0.01f * m_bounds.size.y) : (dh.value * baseScale) };
+}
+
+void Canvas::syncIndex(float baseScale) {
+    if (!m_indexValid || m_indexVersion != m_childrenVersion) {
+        m_index.clear();
+        for (auto& [element, p] : m_positions) p.child = UINT32_MAX;
+        m_hovering.clear();
+        for (uint32_t i = 0; i < (uint32_t)m_children.size(); ++i) {
+            Element* child = m_children[i];
+            if (!child) continue;
+            Placement& p = m_positions[child];
+            p.child = i;
+            m_index.insert(i, { p.pos, childExtent(child, baseScale) });
+            if (child->m_hovered || child->m_hoverInSubtree) m_hovering.push_back(i);
+        }
+        m_indexValid   = true;
+        m_indexVersion = m_childrenVersion;
+        m_visiblePrev.clear();
+        m_overflow.clear();
+        return;
+    }
+    for (uint32_t i = 0; i < (uint32_t)m_children.size(); ++i) {
+        if (!m_children[i]) continue;
+        const Vec2f ext = childExtent(m_children[i], baseScale);
+        const Rectf& r  = m_index.rectOf(i);
+        if (r.size != ext) m_index.move(i, { r.position, ext });
+    }
+}
+
+void Canvas::gatherAt(const Vec2f& mousePosition, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (m_indexValid && m_indexVersion == m_childrenVersion && m_bounds.contains(mousePosition)) {
+        const Vec2f local = mousePosition - m_bounds.position;
+        m_index.query(Vec2f{ m_pan.x + local.x / std::max(0.0001f, m_zoomX),
+                             m_pan.y + local.y / std::max(0.0001f, m_zoomY) }, out);
+    }
+    out.insert(out.end(), m_overflow.begin(), m_overflow.end());
+    out.insert(out.end(), m_hovering.begin(), m_hovering.end());
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    while (!out.empty() && out.back() >= m_children.size()) out.pop_back();
 }
 
 void Canvas::setPan(Vec2f pan) {
     Vec2f np = clampPan(pan);
     if (np.x != m_pan.x || np.y != m_pan.y) {
         m_pan = np;
-        m_dirty = true;
+        markDirty();
     }
 }
 
 void Canvas::update(Rectf& parentBounds, float dt) {
+    UILO_TRACE_ZONE("Canvas::update");
     // Resolve modifier-driven size/align/padding so outerPadding, fixed
     // width/height, and alignment work just like any other element.
     resize(parentBounds);
+    const bool forceTreeUpdate = m_uiloRef && m_uiloRef->isForcingTreeUpdate();
 
     // Middle-mouse drag-to-pan. Polled here because UILO has no
     // middle-mouse plumbing of its own.
@@ -172,29 +237,25 @@ void Canvas::update(Rectf& parentBounds, float dt) {
     const float geomZoom  = std::sqrt(std::max(0.0001f, m_zoomX * m_zoomY));
     if (m_uiloRef && geomZoom != 1.f) m_uiloRef->setScale(baseScale * geomZoom);
 
-    for (auto* child : m_children) {
-        if (!child) continue;
-        const Vec2f canvasPos = getChildPosition(child);
-
-        // Final per-axis size in window pixels. Compute up-front from
-        // the child's declared dimension so percent and px both honor
-        // independent zoom factors.
-        const Dimension dw = child->getModifier().getWidth();
-        const Dimension dh = child->getModifier().getHeight();
-        const float intrinsicW = dw.percent ? (dw.value * 0.01f * m_bounds.size.x)
-                                            : (dw.value * baseScale);
-        const float intrinsicH = dh.percent ? (dh.value * 0.01f * m_bounds.size.y)
-                                            : (dh.value * baseScale);
-        const float finalW = intrinsicW * m_zoomX;
-        const float finalH = intrinsicH * m_zoomY;
-
-        Rectf childBounds;
-        childBounds.position = {
-            m_bounds.position.x + (canvasPos.x - m_pan.x) * m_zoomX,
-            m_bounds.position.y + (canvasPos.y - m_pan.y) * m_zoomY,
-        };
-        childBounds.size = { finalW, finalH };
-
+    syncIndex(baseScale);
+    const Rectf view{ m_pan, { m_bounds.size.x / std::max(0.0001f, m_zoomX),
+                               m_bounds.size.y / std::max(0.0001f, m_zoomY) } };
+    m_visible.clear();
+    m_index.query(view, m_visible);
+    std::sort(m_visible.begin(), m_visible.end());
+
+    // Window-space slot of child i: its indexed canvas rect, panned and
+    // stretched per axis.
+    auto slotOf = [&](uint32_t i) {
+        const Rectf& c = m_index.rectOf(i);
+        return Rectf{ { m_bounds.position.x + (c.position.x - m_pan.x) * m_zoomX,
+                        m_bounds.position.y + (c.position.y - m_pan.y) * m_zoomY },
+                      { c.size.x * m_zoomX, c.size.y * m_zoomY } };
+    };
+    m_overflow.clear();
+    auto tickAt = [&](uint32_t i) {
+        Element* child = m_children[i];
+        Rectf childBounds = slotOf(i);
         child->tick(childBounds, dt);
 
         // Force the final bounds (Element::resize re-resolves using
@@ -204,11 +265,121 @@ void Canvas::update(Rectf& parentBounds, float dt) {
         // intended per-axis size and ignore any alignment shifts).
         child->m_bounds.position = childBounds.position;
         child->m_bounds.size     = childBounds.size;
+        child->updateSubtreeCache();
+        if (child->m_subtreeBounds != child->m_bounds) m_overflow.push_back(i);
+    };
+
+    if (!m_options.getCullUpdates() || forceTreeUpdate) {
+        size_t v = 0;
+        for (uint32_t i = 0; i < (uint32_t)m_children.size(); ++i) {
+            if (!m_children[i]) continue;
+            tickAt(i);
+            const bool inView = v < m_visible.size() && m_visible[v] == i;
+            if (inView) ++v;
+            // Out of view it draws nothing, so it can't dirty what's cached.
+            else m_children[i]->clearDirty();
+        }
+    } else {
+        for (uint32_t i : m_visible) if (m_children[i]) tickAt(i);
+        // Left the view this frame: park it in its slot once. After that
+        // it sits untouched until it comes back.
+        for (uint32_t i : m_visiblePrev) {
+            if (i >= m_children.size() || !m_children[i]) continue;
+            if (!std::binary_search(m_visible.begin(), m_visible.end(), i))
+                parkChild(m_children[i], slotOf(i));
+        }
+    }
+    // A subtree spilling past its rect may reach the view from outside it.
+    if (!m_overflow.empty()) {
+        m_visible.insert(m_visible.end(), m_overflow.begin(), m_overflow.end());
+        std::sort(m_visible.begin(), m_visible.end());
+        m_visible.erase(std::unique(m_visible.begin(), m_visible.end()), m_visible.end());
     }
+    m_visiblePrev = m_visible;
 
     if (m_uiloRef && geomZoom != 1.f) m_uiloRef->setScale(baseScale);
 }
 
+void Canvas::tickClean(float dt) {
+    if (!m_subtreeLive) return;
+    Rectf parent = m_lastParentBounds;
+    update(parent, dt);
+}
+
+void Canvas::drawGrid(Renderer& r, const GridKey& key, uint32_t lodStride) {
+    // Local space: the origin sits on the grid point of the pan's cell.
+    // The pan's offset into that cell (always within one step) is applied
+    // as a translate, so the lines run one step past the viewport.
+    const Vec2f origin{ key.cellX * key.step.x, key.cellY * key.step.y };
+    const Vec2f offset{ m_bounds.position.x + (origin.x - m_pan.x) * key.zoom.x,
+                        m_bounds.position.y + (origin.y - m_pan.y) * key.zoom.y };
+
+    if (!m_grid.valid || !(m_grid.key == key)) {
+        const Vec2f pitch{ key.step.x * key.zoom.x, key.step.y * key.zoom.y };
+        const int64_t nx = static_cast<int64_t>(key.size.x / pitch.x) + 1;
+        const int64_t ny = static_cast<int64_t>(key.size.y / pitch.y) + 1;
+        const float   w  = key.size.x + pitch.x;
+        const float   h  = key.size.y + pitch.y;
+        auto inX = [&](int64_t i) {
+            const float cx = origin.x + i * key.step.x;
+            return cx >= key.boundLo.x && cx <= key.boundHi.x;
+        };
+        auto inY = [&](int64_t j) {
+            const float cy = origin.y + j * key.step.y;
+            return cy >= key.boundLo.y && cy <= key.boundHi.y;
+        };
+        // Stride from the global index, so the thinned set is stable as
+        // the origin moves.
+        auto onStride = [&](int64_t cell) { return cell % (int64_t)lodStride == 0; };
+
+        auto& lines = m_grid.lines;
+        lines.clear();
+        if (key.style == GridLineStyle::Lines) {
+            lines.reserve(static_cast<size_t>(nx + ny + 2));
+            for (int64_t i = 0; i <= nx; ++i) {
+                if (!inX(i)) continue;
+                const float x = i * pitch.x;
+                lines.push_back(Line{{x, 0.f}, {x, h}, key.thick, key.color});
+            }
+            for (int64_t j = 0; j <= ny; ++j) {
+                if (!inY(j)) continue;
+                const float y = j * pitch.y;
+                lines.push_back(Line{{0.f, y}, {w, y}, key.thick, key.color});
+            }
+        } else if (key.style == GridLineStyle::Crosses) {
+            const float halfArm = std::max(2.f, key.cross * 0.5f);
+            lines.reserve(static_cast<size_t>(((nx + 1) * (ny + 1)) / (lodStride * lodStride)) * 2u + 8u);
+            for (int64_t j = 0; j <= ny; ++j) {
+                if (!inY(j) || !onStride(key.cellY + j)) continue;
+                const float y = j * pitch.y;
+                for (int64_t i = 0; i <= nx; ++i) {
+                    if (!inX(i) || !onStride(key.cellX + i)) continue;
+                    const float x = i * pitch.x;
+                    lines.push_back(Line{{x - halfArm, y}, {x + halfArm, y}, key.thick, key.color});
+                    lines.push_back(Line{{x, y - halfArm}, {x, y + halfArm}, key.thick, key.color});
+                }
+            }
+        }
+
+        if (!m_grid.geo.valid() && !m_grid.geoUnsupported) {
+            m_grid.geo = r.createGeometry();
+            m_grid.geoUnsupported = !m_grid.geo.valid();
+        }
+        if (m_grid.geo.valid()) r.updateGeometry(m_grid.geo, lines.data(), lines.size());
+        m_grid.key   = key;
+        m_grid.valid = true;
+    }
+
+    if (m_grid.lines.empty()) return;
+    if (m_grid.geo.valid()) {
+        r.drawGeometry(m_grid.geo, offset);
+        return;
+    }
+    r.pushTransform(Transform2D::translate(offset.x, offset.y));
+    r.drawLines(m_grid.lines.data(), m_grid.lines.size());
+    r.popTransform();
+}
+
 void Canvas::render() {
     if (!m_modifier.getVisible()) return;
     if (m_bounds.size.x <= 0.f || m_bounds.size.y <= 0.f) return;
@@ -222,14 +393,17 @@ void Canvas::render() {
         m_options.getColorRole(), m_options.getColor());
     const float rounding = m_options.getRounding() * scale;
     Color gc[4];
-    if (resolveGradient(m_options.getGradient(), m_options.getGradientRole(), gc)) {
+    GradientRamp ramp;
+    if (resolveGradient(m_options.getGradient(), m_options.getGradientRole(), gc, &ramp)) {
         if (rounding <= 0.f) {
             Rect shape{m_bounds.position, m_bounds.size};
             shape.setGradientColors(gc);
+            shape.ramp = ramp;
             r.draw(shape);
         } else {
             RoundedRect shape{m_bounds.position, m_bounds.size, rounding, 8u};
             shape.setGradientColors(gc);
+            shape.ramp = ramp;
             r.draw(shape);
         }
     } else if (bg.a > 0) {
@@ -258,35 +432,16 @@ void Canvas::render() {
         const float zoomX = std::max(0.0001f, m_zoomX);
         const float zoomY = std::max(0.0001f, m_zoomY);
 
-        // Canvas-space extents of the visible viewport (per axis).
-        const float x0 = m_pan.x;
-        const float x1 = m_pan.x + m_bounds.size.x / zoomX;
-        const float y0 = m_pan.y;
-        const float y1 = m_pan.y + m_bounds.size.y / zoomY;
-
-        // First grid line >= x0, etc.
-        const float startX = std::ceil(x0 / stepX) * stepX;
-        const float startY = std::ceil(y0 / stepY) * stepY;
-
         // Optional canvas-bounds clipping for the grid drawing range.
         const auto& mnX = m_options.getMinX();
         const auto& mxX = m_options.getMaxX();
         const auto& mnY = m_options.getMinY();
         const auto& mxY = m_options.getMaxY();
-        const float boundLoX = mnX ? *mnX : -1e30f;
-        const float boundHiX = mxX ? *mxX :  1e30f;
-        const float boundLoY = mnY ? *mnY : -1e30f;
-        const float boundHiY = mxY ? *mxY :  1e30f;
 
-        auto toWinX = [&](float cx) { return m_bounds.position.x + (cx - m_pan.x) * zoomX; };
-        auto toWinY = [&](float cy) { return m_bounds.position.y + (cy - m_pan.y) * zoomY; };
-
-        auto countSamples = [](float start, float end, float step) -> uint64_t {
-            if (step <= 0.f || end < start) return 0u;
-            return static_cast<uint64_t>(std::floor((end - start) / step)) + 1u;
-        };
-        const uint64_t approxX = countSamples(startX, x1, stepX);
-        const uint64_t approxY = countSamples(startY, y1, stepY);
+        // Sized from the viewport alone (not where the pan falls), so the
+        // stride doesn't flicker between rebuilds.
+        const uint64_t approxX = static_cast<uint64_t>(m_bounds.size.x / zoomX / stepX) + 2u;
+        const uint64_t approxY = static_cast<uint64_t>(m_bounds.size.y / zoomY / stepY) + 2u;
         const uint64_t approxMarkers = approxX * approxY;
         constexpr uint64_t kMaxDenseMarkers = 12000u;
         const uint32_t lodStride = (approxMarkers > kMaxDenseMarkers)
@@ -301,32 +456,16 @@ void Canvas::render() {
         const bool tooDense = (stepX * zoomX < minScreenStep) || (stepY * zoomY < minScreenStep);
         if (tooDense) {
             // skip grid pass entirely
-        } else if (style == GridLineStyle::Lines) {
-            std::vector<Line> lines;
-            lines.reserve(static_cast<size_t>(approxX + approxY));
-            // Vertical lines.
-            for (float cx = startX; cx <= x1; cx += stepX) {
-                if (cx < boundLoX || cx > boundHiX) continue;
-                const float wx = toWinX(cx);
-                lines.push_back(Line{
-                    {wx, m_bounds.position.y},
-                    {wx, m_bounds.position.y + m_bounds.size.y},
-                    thick, gc
-                });
-            }
-            // Horizontal lines.
-            for (float cy = startY; cy <= y1; cy += stepY) {
-                if (cy < boundLoY || cy > boundHiY) continue;
-                const float wy = toWinY(cy);
-                lines.push_back(Line{
-                    {m_bounds.position.x,                  wy},
-                    {m_bounds.position.x + m_bounds.size.x, wy},
-                    thick, gc
-                });
-            }
-            if (!lines.empty()) r.drawLines(lines.data(), lines.size());
         } else if (style == GridLineStyle::Dots) {
             const float radius = std::max(1.f, thick);
+            const float boundLoX = mnX ? *mnX : -1e30f;
+            const float boundHiX = mxX ? *mxX :  1e30f;
+            const float boundLoY = mnY ? *mnY : -1e30f;
+            const float boundHiY = mxY ? *mxY :  1e30f;
+            const float x1 = m_pan.x + m_bounds.size.x / zoomX;
+            const float y1 = m_pan.y + m_bounds.size.y / zoomY;
+            const float startX = std::ceil(m_pan.x / stepX) * stepX;
+            const float startY = std::ceil(m_pan.y / stepY) * stepY;
             uint32_t yi = 0u;
             for (float cy = startY; cy <= y1; cy += stepY, ++yi) {
                 if (cy < boundLoY || cy > boundHiY) continue;
@@ -335,28 +474,24 @@ void Canvas::render() {
                 for (float cx = startX; cx <= x1; cx += stepX, ++xi) {
                     if (cx < boundLoX || cx > boundHiX) continue;
                     if ((xi % lodStride) != 0u) continue;
-                    r.draw(Circle{{toWinX(cx), toWinY(cy)}, radius, 12, gc});
-                }
-            }
-        } else if (style == GridLineStyle::Crosses) {
-            const float halfArm = std::max(2.f, cross * 0.5f);
-            std::vector<Line> lines;
-            lines.reserve(static_cast<size_t>((approxMarkers / (lodStride * lodStride)) * 2u + 8u));
-            uint32_t yi = 0u;
-            for (float cy = startY; cy <= y1; cy += stepY, ++yi) {
-                if (cy < boundLoY || cy > boundHiY) continue;
-                if ((yi % lodStride) != 0u) continue;
-                uint32_t xi = 0u;
-                for (float cx = startX; cx <= x1; cx += stepX, ++xi) {
-                    if (cx < boundLoX || cx > boundHiX) continue;
-                    if ((xi % lodStride) != 0u) continue;
-                    const float wx = toWinX(cx);
-                    const float wy = toWinY(cy);
-                    lines.push_back(Line{{wx - halfArm, wy}, {wx + halfArm, wy}, thick, gc});
-                    lines.push_back(Line{{wx, wy - halfArm}, {wx, wy + halfArm}, thick, gc});
+                    r.draw(Circle{{m_bounds.position.x + (cx - m_pan.x) * zoomX,
+                                   m_bounds.position.y + (cy - m_pan.y) * zoomY}, radius, 12, gc});
                 }
             }
-            if (!lines.empty()) r.drawLines(lines.data(), lines.size());
+        } else {
+            GridKey key;
+            key.style   = style;
+            key.step    = {stepX, stepY};
+            key.size    = m_bounds.size;
+            key.zoom    = {zoomX, zoomY};
+            key.boundLo = {mnX ? *mnX : -1e30f, mnY ? *mnY : -1e30f};
+            key.boundHi = {mxX ? *mxX :  1e30f, mxY ? *mxY :  1e30f};
+            key.thick   = thick;
+            key.cross   = cross;
+            key.color   = gc;
+            key.cellX   = static_cast<int64_t>(std::floor(m_pan.x / stepX));
+            key.cellY   = static_cast<int64_t>(std::floor(m_pan.y / stepY));
+            drawGrid(r, key, lodStride);
         }
     }
 
@@ -369,11 +504,19 @@ void Canvas::render() {
     const float geomZoom = std::sqrt(std::max(0.0001f, m_zoomX * m_zoomY));
     if (geomZoom != 1.f) m_uiloRef->setScale(oldScale * geomZoom);
 
-    for (auto* child : m_children) {
+    // Only what the index put in view last update; the rest are culled
+    // without being visited.
+    uint32_t drawn = 0;
+    for (uint32_t i : m_visible) {
+        if (i >= m_children.size()) continue;
+        Element* child = m_children[i];
         if (!child) continue;
+        ++drawn;
         if (child->getType() == ElementType::Resizer) continue;
-        child->render();
+        if (cullChild(child, m_bounds)) continue;
+        child->paint();
     }
+    if (m_children.size() > drawn) r.countCulled((uint32_t)(m_children.size() - drawn));
 
     if (geomZoom != 1.f) m_uiloRef->setScale(oldScale);
 
@@ -392,7 +535,9 @@ bool Canvas::checkScroll(const Vec2f& mousePosition, Vec2f delta, bool precise,
 
     // Let children (e.g. a Column placed inside the canvas) consume the
     // scroll first.
-    for (auto* child : m_children) {
+    gatherAt(mousePosition, m_hits);
+    for (uint32_t i : m_hits) {
+        Element* child = m_children[i];
         if (!child) continue;
         if (child->getBounds().contains(mousePosition))
             if (child->checkScroll(mousePosition, delta, precise, momentum)) return true;
@@ -425,6 +570,69 @@ bool Canvas::checkScroll(const Vec2f& mousePosition, Vec2f delta, bool precise,
     return true;
 }
 
+// Container's hit tests, over gatherAt()'s candidates instead of every
+// child.
+bool Canvas::checkLeftClick(const Vec2f& mousePosition) {
+    bool childClicked = false;
+    gatherAt(mousePosition, m_hits);
+    for (uint32_t i : m_hits) {
+        Element* child = m_children[i];
+        if (!child || child->getType() == ElementType::Resizer) continue;
+        if (child->getBounds().contains(mousePosition))
+            childClicked |= child->checkLeftClick(mousePosition);
+    }
+
+    if (!childClicked && m_bounds.contains(mousePosition)) {
+        if (m_modifier.getOnLeftClick()) m_modifier.getOnLeftClick()(this);
+        return true;
+    }
+    return childClicked;
+}
+
+bool Canvas::checkRightClick(const Vec2f& mousePosition) {
+    bool childClicked = false;
+    gatherAt(mousePosition, m_hits);
+    for (uint32_t i : m_hits) {
+        Element* child = m_children[i];
+        if (child && child->getBounds().contains(mousePosition))
+            childClicked |= child->checkRightClick(mousePosition);
+    }
+
+    if (!childClicked && m_bounds.contains(mousePosition)) {
+        if (m_modifier.getOnRightClick()) m_modifier.getOnRightClick()(this);
+        return true;
+    }
+    return childClicked;
+}
+
+bool Canvas::checkHover(const Vec2f& mousePosition) {
+    bool childHovered = false;
+    gatherAt(mousePosition, m_hits);
+    m_hovering.clear();
+    for (uint32_t i : m_hits) {
+        Element* child = m_children[i];
+        if (!child || child->getType() == ElementType::Resizer) continue;
+        if (!child->m_hovered && !child->m_hoverInSubtree &&
+            !child->m_subtreeBounds.contains(mousePosition)) continue;
+        if (child->checkHover(mousePosition)) childHovered = true;
+        if (child->m_hovered || child->m_hoverInSubtree) m_hovering.push_back(i);
+    }
+    m_hoverInSubtree = !m_hovering.empty();
+
+    const bool inside = !childHovered && m_bounds.contains(mousePosition);
+    if (inside && !m_hovered) {
+        m_hovered = true; m_dirty = true;
+        if (m_modifier.getOnHoverEnter()) m_modifier.getOnHoverEnter()(this);
+    } else if (!inside && m_hovered) {
+        m_hovered = false; m_dirty = true;
+        if (m_modifier.getOnHoverExit()) m_modifier.getOnHoverExit()(this);
+    }
+
+    if (inside && m_uiloRef && m_modifier.getOnLeftClick())
+        m_uiloRef->requestCursor(CursorType::Hand, 1);
+    return inside;
+}
+
 bool Canvas::checkZoom(const Vec2f& mousePosition, float magnification) {
     if (!m_bounds.contains(mousePosition)) return false;
     if (!m_options.getZoomEnabled()) return false;
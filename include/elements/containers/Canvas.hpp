@@ -2,6 +2,7 @@
 
 #include "Container.hpp"
 #include "../../utils/Math.hpp"
+#include "../../utils/Quadtree.hpp"
 #include <optional>
 #include <unordered_map>
 
@@ -75,16 +76,21 @@ public:
     CanvasOptions& setZoomAxes(bool x, bool y)          { m_zoomAxisX = x; m_zoomAxisY = y; return *this; }
     CanvasOptions& setZoomAxisX(bool v)                 { m_zoomAxisX = v; return *this; }
     CanvasOptions& setZoomAxisY(bool v)                 { m_zoomAxisY = v; return *this; }
+    // Children panned fully out of view aren't updated until they come
+    // back. They are always skipped at render time regardless, and hit
+    // testing only ever looks at the children under the cursor (both via
+    // the canvas's spatial index, so neither walks every child).
+    CanvasOptions& setCullUpdates(bool v)               { m_cullUpdates = v; return *this; }
 
     Color         getColor()           const { return m_color; }
-    const std::string& getColorRole()  const { return m_colorRole; }
+    const Role&        getColorRole()  const { return m_colorRole; }
     const Gradient&    getGradient()     const { return m_gradient; }
-    const std::string& getGradientRole() const { return m_gradientRole; }
+    const Role&        getGradientRole() const { return m_gradientRole; }
     float         getRounding()        const { return m_rounding; }
     Vec2f         getGridSize()        const { return m_gridSize; }
     GridLineStyle getGridLineStyle()   const { return m_gridStyle; }
     Color         getGridLineColor()   const { return m_gridColor; }
-    const std::string& getGridLineColorRole() const { return m_gridColorRole; }
+    const Role&        getGridLineColorRole() const { return m_gridColorRole; }
     float         getGridLineThickness() const { return m_gridThickness; }
     int           getGridLineSpacing() const { return m_gridSpacing; }
     float         getGridCrossSize()   const { return m_gridCrossSize; }
@@ -100,18 +106,19 @@ public:
     bool          getZoomEnabled()     const { return m_zoomEnabled; }
     bool          getZoomAxisX()       const { return m_zoomAxisX; }
     bool          getZoomAxisY()       const { return m_zoomAxisY; }
+    bool          getCullUpdates()     const { return m_cullUpdates; }
 
 private:
     Color       m_color         = Color{0, 0, 0, 0};
-    std::string m_colorRole;
+    Role        m_colorRole;
     Gradient    m_gradient;
-    std::string m_gradientRole;
+    Role        m_gradientRole;
     float       m_rounding      = 0.f;
 
     Vec2f       m_gridSize      = {0.f, 0.f};
     GridLineStyle m_gridStyle   = GridLineStyle::None;
     Color       m_gridColor     = Color{255, 255, 255, 40};
-    std::string m_gridColorRole;
+    Role        m_gridColorRole;
     float       m_gridThickness = 1.f;
     int         m_gridSpacing   = 1;
     float       m_gridCrossSize = 6.f;
@@ -126,21 +133,27 @@ private:
     bool        m_zoomEnabled   = true;
     bool        m_zoomAxisX     = true;
     bool        m_zoomAxisY     = true;
+    bool        m_cullUpdates   = false;
 };
 
 // Canvas: a Container that places children at free canvas-space pixel
 // coordinates inside a pannable viewport. Optional grid metric snaps
 // placement positions to a regular lattice; optional bounds clamp the
 // pan extent. Pan input comes from the trackpad / scroll wheel and
-// (when enabled) middle-mouse drag.
+// (when enabled) middle-mouse drag. Child rects are kept in a canvas-space
+// quadtree, so rendering and hit testing cost what is visible rather than
+// what is placed.
 class Canvas : public Container {
 public:
     Canvas(Modifier modifier, CanvasOptions options, const std::string& name = "");
     Canvas(Modifier modifier, CanvasOptions options, contains children, const std::string& name = "");
+    ~Canvas() override;
+    // Frees the cached grid lines and their GPU geometry.
+    void releaseResources() override;
 
     const CanvasOptions& getOptions() const { return m_options; }
     CanvasOptions&       getOptions()       { return m_options; }
-    void setOptions(const CanvasOptions& o) { m_options = o; m_dirty = true; }
+    void setOptions(const CanvasOptions& o) { m_options = o; markDirty(); }
 
     // Place a child at canvas-space (x, y). The position is snapped to
     // the grid step on each axis where the step is > 0.
@@ -169,16 +182,71 @@ public:
 
     void update(Rectf& parentBounds, float dt) override;
     void render() override;
+    bool checkLeftClick(const Vec2f& mousePosition) override;
+    bool checkRightClick(const Vec2f& mousePosition) override;
+    bool checkHover(const Vec2f& mousePosition) override;
     bool checkScroll(const Vec2f& mousePosition, float delta, bool precise = false, bool momentum = false) override;
     bool checkScroll(const Vec2f& mousePosition, Vec2f delta, bool precise = false, bool momentum = false) override;
     bool checkZoom(const Vec2f& mousePosition, float magnification) override;
 
 private:
+    // Middle-mouse panning is polled; children get per-axis bounds
+    // forced after their tick, so a clean tick just re-runs update().
+    bool wantsUpdate() const override { return m_options.getMiddleMousePan(); }
+    void tickClean(float dt) override;
     Vec2f snap(Vec2f v) const;
     Vec2f clampPan(Vec2f pan) const;
+    // Canvas-space size of a child: its declared width/height at the
+    // unzoomed scale (percent of the viewport for percent dimensions).
+    Vec2f childExtent(const Element* child, float baseScale) const;
+    // Rebuilds m_index when the child list changed, else refreshes the
+    // size of any child whose extent moved.
+    void  syncIndex(float baseScale);
+    // Children that may care about a pointer at `mousePosition`, ascending
+    // (paint order): those whose rect holds it, plus any whose subtree
+    // overflows its rect or that hold the hover and must see it leave.
+    void  gatherAt(const Vec2f& mousePosition, std::vector<uint32_t>& out) const;
+
+    // Line / cross grid, built in a local space anchored on the grid cell
+    // holding the pan, so panning within a cell only moves the offset it
+    // is drawn at. Anything else in the key changing rebuilds it.
+    struct GridKey {
+        GridLineStyle style = GridLineStyle::None;
+        Vec2f   step, size, zoom, boundLo, boundHi;
+        float   thick = 0.f, cross = 0.f;
+        Color   color;
+        int64_t cellX = 0, cellY = 0;
+        bool operator==(const GridKey&) const = default;
+    };
+    struct GridCache {
+        GridKey           key;
+        bool              valid = false;
+        std::vector<Line> lines;   // local space; kept for the drawLines fallback
+        Geometry          geo;     // the same lines on the GPU, when supported
+        bool              geoUnsupported = false;
+    };
+    void drawGrid(Renderer& r, const GridKey& key, uint32_t lodStride);
+
+    struct Placement {
+        Vec2f    pos;                    // canvas-space, snapped
+        uint32_t child = UINT32_MAX;     // index in m_children at the last index sync
+    };
 
     CanvasOptions m_options;
-    std::unordered_map<Element*, Vec2f> m_positions; // child -> canvas-space pos
+    std::unordered_map<Element*, Placement> m_positions;
+
+    // Canvas-space rect of every child, keyed by child index. Rebuilt when
+    // m_childrenVersion moves; positions are moved in by addChild /
+    // setChildPosition and sizes refreshed each update.
+    Quadtree m_index;
+    bool     m_indexValid   = false;
+    uint32_t m_indexVersion = 0;
+    std::vector<uint32_t> m_visible;     // children in view at the last update, ascending
+    std::vector<uint32_t> m_visiblePrev;
+    std::vector<uint32_t> m_overflow;    // ticked children whose subtree exceeds their rect
+    std::vector<uint32_t> m_hovering;    // hovered (or holding the hover) at the last checkHover
+    std::vector<uint32_t> m_hits;        // gatherAt scratch
+    GridCache m_grid;
     Vec2f m_pan   = {0.f, 0.f};
     float m_zoomX = 1.f;
     float m_zoomY = 1.f;
@@ -1,5 +1,6 @@
 #include "Column.hpp"
 #include "../../UILO.hpp"
+#include "../../utils/Trace.hpp"
 #include "../../utils/RenderUtils.hpp"
 #include "../interactible/Resizer.hpp"
 #include <algorithm>
@@ -43,7 +44,9 @@ float normalizeGridStep(float step,
 
 Column::Column(Modifier modifier, ColumnOptions options, contains children, const std::string& name)
     : Container(modifier, children, name), m_options(options)
-{}
+{
+    m_type = ElementType::Column;
+}
 
 void Column::setScrollOffset(float offset) {
     const float contentMax = std::max(0.f, m_contentHeight - m_bounds.size.y);
@@ -51,10 +54,35 @@ void Column::setScrollOffset(float offset) {
     float maxScroll = 0.f;
     resolveScrollBounds(m_options, contentMax, minScroll, maxScroll);
     m_scrollOffset = std::clamp(offset, minScroll, maxScroll);
-    m_dirty = true;
+    markDirty();
+}
+
+void Column::resolveLinks() {
+    if (!m_uiloRef) return;
+    const std::string& scrollId = m_options.getScrollLink();
+    const std::string& zoomId   = m_options.getZoomLink();
+    if (scrollId == m_scrollLinkId && zoomId == m_zoomLinkId &&
+        (m_scrollLink.valid() || m_zoomLink.valid() || !linked())) return;
+    // The old links would otherwise keep marking this dirty.
+    if (m_scrollLink.valid()) m_uiloRef->unsubscribeLink(m_scrollLink, this);
+    if (m_zoomLink.valid())   m_uiloRef->unsubscribeLink(m_zoomLink, this);
+    m_scrollLinkId = scrollId;
+    m_zoomLinkId   = zoomId;
+    m_scrollLink   = m_uiloRef->resolveLink(LinkKind::ScrollY, scrollId);
+    m_zoomLink     = m_uiloRef->resolveLink(LinkKind::ZoomY, zoomId);
+    bool subscribed = true;
+    if (m_scrollLink.valid()) subscribed &= m_uiloRef->subscribeLink(m_scrollLink, this);
+    if (m_zoomLink.valid())   subscribed &= m_uiloRef->subscribeLink(m_zoomLink, this);
+    m_pollLinks = !subscribed;
+}
+
+void Column::translate(Vec2f delta) {
+    Container::translate(delta);
+    m_scrollViewportY += delta.y;
 }
 
 void Column::update(Rectf& parentBounds, float dt) {
+    UILO_TRACE_ZONE("Column::update");
     pruneChildren();
     resize(parentBounds);
     const bool forceTreeUpdate = m_uiloRef && m_uiloRef->isForcingTreeUpdate();
@@ -65,22 +93,19 @@ void Column::update(Rectf& parentBounds, float dt) {
         m_lastScale = scale;
     }
 
-    if (m_uiloRef && !m_options.getScrollLink().empty()) {
-        m_scrollOffset = m_uiloRef->getScrollLinkOffset(m_options.getScrollLink(), false);
-    }
-
-    if (m_uiloRef && !m_options.getZoomLink().empty()) {
-        m_zoomY = m_uiloRef->getZoomLinkValue(m_options.getZoomLink(), false);
-    }
+    resolveLinks();
+    if (m_uiloRef && m_scrollLink.valid()) m_scrollOffset = m_uiloRef->getLinkValue(m_scrollLink);
+    if (m_uiloRef && m_zoomLink.valid())   m_zoomY      = m_uiloRef->getLinkValue(m_zoomLink);
 
     m_scrollViewportHeight = m_bounds.size.y;
 
     // Scrollable path: supports pinned children (Modifier::ignoreScroll)
     // and scrolls only the remaining sibling viewport.
     if (m_options.getScrollable()) {
-        std::vector<Element*> pinnedTop;
-        std::vector<Element*> pinnedMid;
-        std::vector<Element*> pinnedBottom;
+        FrameArena* arena = getFrameArena();
+        FrameVector<Element*> pinnedTop(arena);
+        FrameVector<Element*> pinnedMid(arena);
+        FrameVector<Element*> pinnedBottom(arena);
 
         auto resolvedPinnedH = [&](Element* e) -> float {
             Dimension dim = e->getModifier().getHeight();
@@ -110,12 +135,12 @@ void Column::update(Rectf& parentBounds, float dt) {
             }
         }
 
-        auto layoutPinnedGroup = [&](std::vector<Element*>& group, float startY) {
+        auto layoutPinnedGroup = [&](FrameVector<Element*>& group, float startY) {
             float cursorY = startY;
             for (auto* child : group) {
                 const float rh = resolvedPinnedH(child);
                 Rectf slot{{m_bounds.position.x, cursorY}, {m_bounds.size.x, rh}};
-                child->tick(slot, dt);
+                tickChild(child, slot, dt);
                 cursorY += rh;
             }
         };
@@ -131,6 +156,7 @@ void Column::update(Rectf& parentBounds, float dt) {
 
         float cursorY = scrollViewport.position.y - m_scrollOffset;
         m_contentHeight = 0.f;
+        const bool cullUpdates = m_options.getCullUpdates() && !forceTreeUpdate;
         for (auto* child : m_children) {
             if (!child->getModifier().getVisible()) continue;
             if (child->getType() == ElementType::Resizer) continue;
@@ -140,10 +166,14 @@ void Column::update(Rectf& parentBounds, float dt) {
             const float zf = m_options.getZoomableY() ? m_zoomY : 1.f;
             float rh = dim.percent ? (scrollViewport.size.y * dim.value / 100.f) : dim.value * scale * zf;
             Rectf slot{ {scrollViewport.position.x, cursorY}, {scrollViewport.size.x, rh} };
-            child->tick(slot, dt);
+            // A scroll only moves the slots, so the children are
+            // translated rather than laid out again.
+            if (cullUpdates && !slot.intersects(m_bounds)) parkChild(child, slot);
+            else                                           tickMovedChild(child, slot, dt);
             cursorY      += rh;
             m_contentHeight += rh;
         }
+        flushChildTicks(dt);
         m_scrollViewportY = scrollViewport.position.y;
         const float contentMax = std::max(0.f, m_contentHeight - scrollViewport.size.y);
         float minScroll = 0.f;
@@ -151,10 +181,10 @@ void Column::update(Rectf& parentBounds, float dt) {
         resolveScrollBounds(m_options, contentMax, minScroll, maxScroll);
         const float clamped    = std::clamp(m_scrollOffset, minScroll, maxScroll);
         if (clamped != m_scrollOffset) { m_scrollOffset = clamped; m_dirty = true; }
-        if (m_uiloRef && !m_options.getScrollLink().empty())
-            m_uiloRef->setScrollLinkOffset(m_options.getScrollLink(), m_scrollOffset, false);
-        if (m_uiloRef && !m_options.getZoomLink().empty())
-            m_uiloRef->setZoomLinkValue(m_options.getZoomLink(), m_zoomY, false);
+        if (m_uiloRef && m_scrollLink.valid())
+            m_uiloRef->setLinkValue(m_scrollLink, m_scrollOffset, this);
+        if (m_uiloRef && m_zoomLink.valid())
+            m_uiloRef->setLinkValue(m_zoomLink, m_zoomY, this);
 
         // Keep resizers interactive in scrollable columns while still excluding
         // them from layout flow.
@@ -250,9 +280,11 @@ void Column::update(Rectf& parentBounds, float dt) {
         return;
     }
 
-    std::vector<Element*> top;
-    std::vector<Element*> mid;
-    std::vector<Element*> bot;
+    FrameArena* arena = getFrameArena();
+    FrameVector<Element*> top(arena);
+    FrameVector<Element*> mid(arena);
+    FrameVector<Element*> bot(arena);
+    top.reserve(m_children.size());
 
     float totalFixed = 0.f;
     float totalPct = 0.f;
@@ -319,7 +351,7 @@ void Column::update(Rectf& parentBounds, float dt) {
         - Adjusts the slot origin within the slot based on the child's
           vertical alignment flag (TOP, MIDY, BOTTOM)
     */
-    auto layoutGroup = [&](std::vector<Element*>& group, float startY) {
+    auto layoutGroup = [&](FrameVector<Element*>& group, float startY) {
         float cursorY = startY;
 
         for (auto* child : group) {
@@ -336,7 +368,7 @@ void Column::update(Rectf& parentBounds, float dt) {
             Rectf slot;
             slot.position   = { m_bounds.position.x, slotY };
             slot.size       = { m_bounds.size.x, sh};
-            child->tick(slot, dt);
+            tickChild(child, slot, dt);
             cursorY += rh;
         }
     };
@@ -350,6 +382,7 @@ void Column::update(Rectf& parentBounds, float dt) {
     layoutGroup(top, m_bounds.position.y);
     layoutGroup(mid, m_bounds.position.y + (m_bounds.size.y - midH) * 0.5f);
     layoutGroup(bot, m_bounds.position.y + m_bounds.size.y - botH);
+    flushChildTicks(dt);
 
     // Position Resizer children at element boundaries (invisible to layout flow)
     for (size_t i = 0; i < m_children.size(); ++i) {
@@ -452,6 +485,9 @@ void Column::update(Rectf& parentBounds, float dt) {
 void Column::render() {
     if (!m_modifier.getVisible()) return;
     if (m_bounds.size.x <= 0.f || m_bounds.size.y <= 0.f) return;
+    if (beginLayerRender(m_options.getLayerCached()
+                         && m_modifier.getMaterial().kind == Material::Kind::None)) return;
+    if (beginRetainedRender(m_options.getRetained())) return;
 
     // TODO: BGFX rendering — background fill + children
     // For now: unconditionally render all visible children
@@ -467,15 +503,18 @@ void Column::render() {
         } else {
             float r = m_options.getRounding() * scale;
             Color gc[4];
+            GradientRamp ramp;
             if (resolveGradient(m_options.getGradient(),
-                                m_options.getGradientRole(), gc)) {
+                                m_options.getGradientRole(), gc, &ramp)) {
                 if (r <= 0.f) {
                     Rect shape{m_bounds.position, m_bounds.size};
                     shape.setGradientColors(gc);
+                    shape.ramp = ramp;
                     m_uiloRef->getRenderer().draw(shape);
                 } else {
                     RoundedRect shape{m_bounds.position, m_bounds.size, r, 8u};
                     shape.setGradientColors(gc);
+                    shape.ramp = ramp;
                     m_uiloRef->getRenderer().draw(shape);
                 }
             } else if (bg.a > 0) {
@@ -544,32 +583,43 @@ void Column::render() {
                 }
             }
 
-            if (segmentCount > 1u && minorStep > 0.f) {
+            if (majorStep > 0.f) {
                 Color minorColor = divColor;
                 minorColor.a = static_cast<uint8_t>(static_cast<float>(divColor.a) * 0.45f);
-                const float minorOffset = positiveMod(m_scrollOffset, minorStep);
-                const float firstMinorY = viewTop - minorOffset;
-                std::vector<Line> minorLines;
-                const size_t minorEstimate = static_cast<size_t>(
-                    std::max(0.f, (viewBottom + 0.5f - firstMinorY) / minorStep) + 1.f);
-                minorLines.reserve(minorEstimate);
-                for (float y = firstMinorY; y <= viewBottom + 0.5f; y += minorStep)
-                    minorLines.push_back(Line{{left, y}, {right, y}, 1.f, minorColor});
-                if (!minorLines.empty())
-                    renderer.drawLines(minorLines.data(), minorLines.size());
-            }
+                const SubdivisionKey key{ majorStep, minorStep, right - left,
+                                          m_scrollViewportHeight, divColor, minorColor };
+                if (!m_subdivValid || !(m_subdivKey == key)) {
+                    // One major step past the viewport covers every phase.
+                    const float span = key.viewHeight + majorStep + 0.5f;
+                    m_subdivMajor.clear();
+                    m_subdivMinor.clear();
+                    m_subdivMajor.reserve(static_cast<size_t>(span / majorStep) + 1u);
+                    for (float y = 0.f; y <= span; y += majorStep)
+                        m_subdivMajor.push_back(Line{{0.f, y}, {key.width, y}, 1.f, divColor});
+                    if (segmentCount > 1u && minorStep > 0.f) {
+                        m_subdivMinor.reserve(static_cast<size_t>(span / minorStep) + 1u);
+                        for (float y = 0.f; y <= span; y += minorStep)
+                            m_subdivMinor.push_back(Line{{0.f, y}, {key.width, y}, 1.f, minorColor});
+                    }
+                    m_subdivKey   = key;
+                    m_subdivValid = true;
+                }
 
-            if (majorStep > 0.f) {
-                const float majorOffset = positiveMod(m_scrollOffset, majorStep);
-                const float firstMajorY = viewTop - majorOffset;
-                std::vector<Line> majorLines;
-                const size_t majorEstimate = static_cast<size_t>(
-                    std::max(0.f, (viewBottom + 0.5f - firstMajorY) / majorStep) + 1.f);
-                majorLines.reserve(majorEstimate);
-                for (float y = firstMajorY; y <= viewBottom + 0.5f; y += majorStep)
-                    majorLines.push_back(Line{{left, y}, {right, y}, 1.f, divColor});
-                if (!majorLines.empty())
-                    renderer.drawLines(majorLines.data(), majorLines.size());
+                // Minor lines divide the major step, so one phase fits both.
+                // Draw the same range as before: from the last line at or
+                // above viewTop down to viewBottom + 0.5.
+                const float phase = positiveMod(m_scrollOffset, majorStep);
+                const float limit = m_scrollViewportHeight + phase + 0.5f;
+                auto drawRange = [&](const std::vector<Line>& lines, float step) {
+                    const size_t first = std::min(static_cast<size_t>(phase / step), lines.size());
+                    const size_t last  = std::min(static_cast<size_t>(std::max(0.f, limit / step)) + 1u,
+                                                  lines.size());
+                    if (last > first) renderer.drawLines(lines.data() + first, last - first);
+                };
+                renderer.pushTransform(Transform2D::translate(left, viewTop - phase));
+                if (!m_subdivMinor.empty()) drawRange(m_subdivMinor, minorStep);
+                drawRange(m_subdivMajor, majorStep);
+                renderer.popTransform();
             }
         }
     }
@@ -580,11 +630,12 @@ void Column::render() {
         for (auto* child : m_children) {
             if (child->getType() == ElementType::Resizer) continue;
             if (child->getModifier().getIgnoreScroll() != ignoreScrollChildren) continue;
+            if (cullChild(child, m_bounds)) continue;
             if (m_uiloRef) {
                 const float rr = m_options.getRounding() * (m_uiloRef->getScale());
                 m_uiloRef->getRenderer().pushRoundClip(m_bounds, rr);
             }
-            child->render();
+            child->paint();
             if (m_uiloRef) m_uiloRef->getRenderer().popRoundClip();
         }
     };
@@ -595,6 +646,8 @@ void Column::render() {
 
     if (glassSubtree) m_uiloRef->getRenderer().endGlassSubtree();
 
+    endRetainedRender();
+    if (endLayerRender()) { render(); return; }
     m_dirty = false;
 }
 
@@ -618,17 +671,17 @@ bool Column::checkZoom(const Vec2f& mousePosition, float magnification) {
     float maxScroll = 0.f;
     resolveScrollBounds(m_options, std::max(0.f, m_contentHeight - m_scrollViewportHeight), minScroll, maxScroll);
     m_scrollOffset = std::clamp(content * sc * m_zoomY - mRel, minScroll, maxScroll);
-    if (m_uiloRef && !m_options.getScrollLink().empty())
-        m_uiloRef->setScrollLinkOffset(m_options.getScrollLink(), m_scrollOffset, false);
-    if (m_uiloRef && !m_options.getZoomLink().empty())
-        m_uiloRef->setZoomLinkValue(m_options.getZoomLink(), m_zoomY, false);
-    m_dirty = true;
+    if (m_uiloRef && m_scrollLink.valid())
+        m_uiloRef->setLinkValue(m_scrollLink, m_scrollOffset, this);
+    if (m_uiloRef && m_zoomLink.valid())
+        m_uiloRef->setLinkValue(m_zoomLink, m_zoomY, this);
+    markDirty();
     return true;
 }
 
 void Column::setZoomY(float z) {
     m_zoomY = std::clamp(z, m_options.getZoomMin(), m_options.getZoomMax());
-    m_dirty = true;
+    markDirty();
 }
 
 bool Column::checkScroll(const Vec2f& mousePosition, float delta, bool precise, bool momentum) {
@@ -649,11 +702,11 @@ bool Column::checkScroll(const Vec2f& mousePosition, float delta, bool precise,
         float maxScroll = 0.f;
         resolveScrollBounds(m_options, contentMax, minScroll, maxScroll);
         m_scrollOffset = std::clamp(m_scrollOffset - delta * step, minScroll, maxScroll);
-        if (m_uiloRef && !m_options.getScrollLink().empty())
-            m_uiloRef->setScrollLinkOffset(m_options.getScrollLink(), m_scrollOffset, false);
-        if (m_uiloRef && !m_options.getZoomLink().empty())
-            m_uiloRef->setZoomLinkValue(m_options.getZoomLink(), m_zoomY, false);
-        m_dirty = true;
+        if (m_uiloRef && m_scrollLink.valid())
+            m_uiloRef->setLinkValue(m_scrollLink, m_scrollOffset, this);
+        if (m_uiloRef && m_zoomLink.valid())
+            m_uiloRef->setLinkValue(m_zoomLink, m_zoomY, this);
+        markDirty();
         return true;
     }
 
@@ -681,11 +734,11 @@ bool Column::checkScroll(const Vec2f& mousePosition, Vec2f delta, bool precise,
             float minScroll = 0.f, maxScroll = 0.f;
             resolveScrollBounds(m_options, contentMax, minScroll, maxScroll);
             m_scrollOffset = std::clamp(m_scrollOffset - delta.y * step, minScroll, maxScroll);
-            if (m_uiloRef && !m_options.getScrollLink().empty())
-                m_uiloRef->setScrollLinkOffset(m_options.getScrollLink(), m_scrollOffset, false);
-            if (m_uiloRef && !m_options.getZoomLink().empty())
-                m_uiloRef->setZoomLinkValue(m_options.getZoomLink(), m_zoomY, false);
-            m_dirty  = true;
+            if (m_uiloRef && m_scrollLink.valid())
+                m_uiloRef->setLinkValue(m_scrollLink, m_scrollOffset, this);
+            if (m_uiloRef && m_zoomLink.valid())
+                m_uiloRef->setLinkValue(m_zoomLink, m_zoomY, this);
+            markDirty();
             consumed = true;
         }
     }
@@ -22,6 +22,19 @@ public:
     ColumnOptions& setScrollMin(float v)        { m_scrollMin = v; m_scrollMinSet = true; return *this; }
     ColumnOptions& setScrollMax(float v)        { m_scrollMax = v; m_scrollMaxSet = true; return *this; }
     ColumnOptions& setScrollLink(const std::string& id) { m_scrollLink = id; return *this; }
+    // Record this subtree's shapes and text once and replay them on frames
+    // where nothing inside changed. Pays off for large, mostly static
+    // panels; changes that bypass the dirty flags (e.g. editing options
+    // through getOptions() instead of setOptions()) won't show up.
+    ColumnOptions& setRetained(bool v)          { m_retained = v; return *this; }
+    // Render this subtree into an offscreen texture and composite it as a
+    // single quad until something inside changes or the bounds move. Same
+    // caveat as setRetained; glass materials inside disable it.
+    ColumnOptions& setLayerCached(bool v)       { m_layerCached = v; return *this; }
+    // Scrollable only: children scrolled fully out of view aren't updated
+    // (no layout, no per-frame animation) until they come back. Useful for
+    // very long lists; they are always skipped at render time regardless.
+    ColumnOptions& setCullUpdates(bool v)       { m_cullUpdates = v; return *this; }
 
     // Subdivision grid -------------------------------------------------
     ColumnOptions& setSubDivisions(float px)                     { m_subDivisions = px;       return *this; }
@@ -44,9 +57,9 @@ public:
     ColumnOptions& setZoomLink(const std::string& id) { m_zoomLink = id; return *this; }
 
     Color getColor()       const { return m_color; }
-    const std::string& getColorRole() const { return m_colorRole; }
+    const Role&        getColorRole() const { return m_colorRole; }
     const Gradient&    getGradient()     const { return m_gradient; }
-    const std::string& getGradientRole() const { return m_gradientRole; }
+    const Role&        getGradientRole() const { return m_gradientRole; }
     float     getRounding()    const { return m_rounding; }
     bool      getScrollable()  const { return m_scrollable; }
     float     getScrollSpeed() const { return m_scrollSpeed; }
@@ -55,19 +68,22 @@ public:
     bool      hasScrollMin()   const { return m_scrollMinSet; }
     bool      hasScrollMax()   const { return m_scrollMaxSet; }
     const std::string& getScrollLink() const { return m_scrollLink; }
+    bool      getRetained()    const { return m_retained; }
+    bool      getLayerCached() const { return m_layerCached; }
+    bool      getCullUpdates() const { return m_cullUpdates; }
 
     float              getSubDivisions()           const { return m_subDivisions; }
     unsigned int       getSubDivisionMajor()       const { return m_subDivMajor; }
     unsigned int       getSubDivisionMinor()       const { return m_subDivMinor; }
     Color              getSubDivisionColor()       const { return m_subDivColor; }
-    const std::string& getSubDivisionColorRole()   const { return m_subDivColorRole; }
+    const Role&        getSubDivisionColorRole()   const { return m_subDivColorRole; }
     float              getSubDivisionMinScreenPx() const { return m_subDivMinPx; }
     float              getSubDivisionResubdivideMinScreenPx() const { return m_subDivResubdivideMinPx; }
     float              getSubDivisionsMinDistance() const { return m_subDivMinDistance; }
     float              getSubDivisionsMaxDistance() const { return m_subDivMaxDistance; }
     unsigned int       getSubDivisionStripeEvery() const { return m_subDivStripeEvery; }
     Color              getSubDivisionStripeColor() const { return m_subDivStripeColor; }
-    const std::string& getSubDivisionStripeColorRole() const { return m_subDivStripeColorRole; }
+    const Role&        getSubDivisionStripeColorRole() const { return m_subDivStripeColorRole; }
     bool               getZoomableY()              const { return m_zoomableY; }
     float              getZoomMin()                const { return m_zoomMin; }
     float              getZoomMax()                const { return m_zoomMax; }
@@ -75,9 +91,9 @@ public:
 
 private:
     Color m_color       = Color{0,0,0,0};
-    std::string m_colorRole;
+    Role        m_colorRole;
     Gradient    m_gradient;
-    std::string m_gradientRole;
+    Role        m_gradientRole;
     float     m_rounding    = 0.f;
     bool      m_scrollable  = false;
     float     m_scrollSpeed = 40.f;
@@ -86,19 +102,22 @@ private:
     bool      m_scrollMinSet = false;
     bool      m_scrollMaxSet = false;
     std::string m_scrollLink;
+    bool        m_retained    = false;
+    bool        m_layerCached = false;
+    bool        m_cullUpdates = false;
 
     float       m_subDivisions    = 0.f;
     unsigned int m_subDivMajor    = 1;
     unsigned int m_subDivMinor    = 3;
     Color       m_subDivColor     = Color{255, 255, 255, 30};
-    std::string m_subDivColorRole;
+    Role        m_subDivColorRole;
     float       m_subDivMinPx     = 4.f;
     float       m_subDivResubdivideMinPx = 24.f;
     float       m_subDivMinDistance = 0.f;
     float       m_subDivMaxDistance = 0.f;
     unsigned int m_subDivStripeEvery = 0;
     Color       m_subDivStripeColor = Color{0, 0, 0, 0};
-    std::string m_subDivStripeColorRole;
+    Role        m_subDivStripeColorRole;
     bool        m_zoomableY       = false;
     float       m_zoomMin         = 0.1f;
     float       m_zoomMax         = 50.f;
@@ -113,7 +132,7 @@ public:
 
     const ColumnOptions& getOptions() const        { return m_options; }
     ColumnOptions&       getOptions()              { return m_options; }
-    void setOptions(const ColumnOptions& opts)      { m_options = opts; m_dirty = true; }
+    void setOptions(const ColumnOptions& opts)      { m_options = opts; markDirty(); }
     void setScrollOffset(float offset);
 
     void update(Rectf& parentBounds, float dt) override;
@@ -126,6 +145,24 @@ public:
     void  setZoomY(float z);
 
 private:
+    void translate(Vec2f delta) override;
+    // Linked scroll / zoom values can change from another element. UILO
+    // marks this dirty when they do; only an element it can't hold a
+    // handle to polls them every tick. Ids changed since the last
+    // resolveLinks() keep it ticking until it subscribes to the new ones.
+    bool linked() const {
+        return !m_options.getScrollLink().empty() || !m_options.getZoomLink().empty();
+    }
+    bool wantsUpdate() const override {
+        return m_pollLinks || m_options.getScrollLink() != m_scrollLinkId ||
+               m_options.getZoomLink() != m_zoomLinkId;
+    }
+    bool parallelSafe() const override { return !linked(); }
+    LayoutAxis layoutAxis() const override {
+        return (m_options.getScrollable() || linked()) ? LayoutAxis::None : LayoutAxis::Vertical;
+    }
+    // Re-resolves the link handles when the option ids changed.
+    void resolveLinks();
     ColumnOptions m_options;
     float         m_scrollOffset  = 0.f;
     float         m_contentHeight = 0.f;
@@ -133,6 +170,25 @@ private:
     float         m_scrollViewportY      = 0.f;
     float         m_lastScale     = 1.f;
     float         m_zoomY         = 1.f;
+
+    LinkHandle    m_scrollLink;
+    LinkHandle    m_zoomLink;
+    std::string   m_scrollLinkId;   // the ids the handles were resolved for
+    std::string   m_zoomLinkId;
+    bool          m_pollLinks = false;
+
+    // Subdivision lines one major step apart repeat with the scroll, so
+    // they're built once at y = 0.. and drawn translated by the scroll's
+    // phase within a major step; only a change to the key rebuilds them.
+    struct SubdivisionKey {
+        float majorStep = 0.f, minorStep = 0.f, width = 0.f, viewHeight = 0.f;
+        Color major, minor;
+        bool operator==(const SubdivisionKey&) const = default;
+    };
+    SubdivisionKey    m_subdivKey;
+    bool              m_subdivValid = false;
+    std::vector<Line> m_subdivMajor;    // local space, ascending y
+    std::vector<Line> m_subdivMinor;
 };
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Container.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include "../../UILO.hpp"
 
 namespace uilo {
@@ -18,6 +19,7 @@ Container::Container(
 }
 
 bool Container::isDirty() const {
+    if (!m_modifier.getVisible() && !m_visibilityChanged) return false;
     if (m_dirty) return true;
     for (auto* child : m_children) {
         if (child->isDirty()) return true;
@@ -25,6 +27,163 @@ bool Container::isDirty() const {
     return false;
 }
 
+void Container::clearDirty() {
+    m_dirty = false;
+    for (auto* child : m_children) child->clearDirty();
+}
+
+bool Container::cullChild(Element* child, const Rectf& viewport) {
+    if (!child->getModifier().getVisible()) return false;
+    if (child->m_bounds.intersects(viewport)) return false;
+    // It drew nothing, so whatever is cached above it is still current.
+    child->clearDirty();
+    if (m_uiloRef) m_uiloRef->getRenderer().countCulled();
+    return true;
+}
+
+void Container::updateSubtreeCache() {
+    Element::updateSubtreeCache();
+    float x0 = m_bounds.position.x, x1 = x0 + m_bounds.size.x;
+    float y0 = m_bounds.position.y, y1 = y0 + m_bounds.size.y;
+    for (auto* child : m_children) {
+        child->m_parent = this;
+        const Rectf& b = child->m_subtreeBounds;
+        x0 = std::min(x0, b.position.x); x1 = std::max(x1, b.position.x + b.size.x);
+        y0 = std::min(y0, b.position.y); y1 = std::max(y1, b.position.y + b.size.y);
+        if (child->m_subtreeLive && child->getModifier().getVisible()) m_subtreeLive = true;
+        m_subtreeParallelSafe = m_subtreeParallelSafe && child->m_subtreeParallelSafe;
+        m_subtreeSize += child->m_subtreeSize;
+    }
+    m_subtreeBounds = {{x0, y0}, {x1 - x0, y1 - y0}};
+}
+
+void Container::tickChild(Element* child, Rectf slot, float dt) {
+    JobPool* pool = m_uiloRef ? m_uiloRef->getLayoutPool() : nullptr;
+    if (pool && !JobPool::inJob() && child->m_subtreeParallelSafe &&
+        child->m_subtreeSize >= m_uiloRef->getParallelLayoutThreshold()) {
+        m_pendingTicks.push_back({child, slot});
+        return;
+    }
+    child->tick(slot, dt);
+}
+
+void Container::tickMovedChild(Element* child, Rectf slot, float dt) {
+    const Rectf& last = child->m_lastParentBounds;
+    if (!child->m_layoutDirty && slot.size == last.size && slot.position != last.position)
+        child->translate(slot.position - last.position);
+    tickChild(child, slot, dt);
+}
+
+void Container::flushChildTicks(float dt) {
+    if (m_pendingTicks.empty()) return;
+    if (m_pendingTicks.size() == 1) {
+        // Nothing to overlap with; ticking it here lets its own children
+        // fan out instead.
+        m_pendingTicks[0].child->tick(m_pendingTicks[0].slot, dt);
+    } else {
+        m_uiloRef->getLayoutPool()->parallelFor(m_pendingTicks.size(), [&](size_t i) {
+            m_pendingTicks[i].child->tick(m_pendingTicks[i].slot, dt);
+        });
+    }
+    m_pendingTicks.clear();
+}
+
+void Container::tickClean(float dt) {
+    // Layout inputs are unchanged, so every child keeps its previous slot.
+    for (auto* child : m_children) {
+        if (!child->m_subtreeLive || !child->getModifier().getVisible()) continue;
+        Rectf slot = child->m_lastParentBounds;
+        child->tick(slot, dt);
+    }
+}
+
+void Container::translate(Vec2f delta) {
+    Element::translate(delta);
+    for (auto* child : m_children) child->translate(delta);
+}
+
+void Container::parkChild(Element* child, const Rectf& slot) {
+    child->m_bounds = slot;
+    child->m_subtreeBounds = slot;
+    // A clean tick reuses m_lastParentBounds; park it there.
+    child->m_lastParentBounds = slot;
+    child->m_layoutDirty = true;
+    child->clearDirty();
+}
+
+bool Container::beginLayerRender(bool enabled) {
+    m_layerRendering = false;
+    if (!m_uiloRef) return false;
+    auto& renderer = m_uiloRef->getRenderer();
+    if (!enabled) {
+        if (m_fb.valid()) renderer.destroyFrameBuffer(m_fb);
+        m_layerValid = false;
+        return false;
+    }
+    const bool sameBounds = m_bounds == m_layerBounds;
+    if (m_layerUnsupported) {
+        if (sameBounds) return false;
+        m_layerUnsupported = false;
+    }
+    if (m_layerValid && sameBounds && !isDirty()) {
+        renderer.drawFrameBuffer(m_fb, m_layerOrigin,
+                                 {(float)m_fb.size.x, (float)m_fb.size.y});
+        return true;
+    }
+
+    // Pixel-aligned so compositing is a 1:1 copy.
+    m_layerOrigin = {std::floor(m_bounds.position.x), std::floor(m_bounds.position.y)};
+    const Vec2u size{
+        (unsigned)std::ceil(m_bounds.position.x + m_bounds.size.x - m_layerOrigin.x),
+        (unsigned)std::ceil(m_bounds.position.y + m_bounds.size.y - m_layerOrigin.y)};
+    if (m_fb.valid()) renderer.resizeFrameBuffer(m_fb, size);
+    else              m_fb = renderer.createFrameBuffer(size);
+    m_layerBounds = m_bounds;
+    m_layerValid  = false;
+    m_layerRendering = renderer.beginLayer(m_fb, m_layerOrigin);
+    return false;
+}
+
+bool Container::endLayerRender() {
+    if (!m_layerRendering) return false;
+    m_layerRendering = false;
+    auto& renderer = m_uiloRef->getRenderer();
+    if (!renderer.endLayer()) {
+        renderer.destroyFrameBuffer(m_fb);
+        m_layerUnsupported = true;
+        return true;
+    }
+    m_layerValid = true;
+    renderer.drawFrameBuffer(m_fb, m_layerOrigin,
+                             {(float)m_fb.size.x, (float)m_fb.size.y});
+    return false;
+}
+
+bool Container::beginRetainedRender(bool enabled) {
+    m_drawListRecording = false;
+    if (!enabled || !m_uiloRef) {
+        if (m_drawList.valid()) m_drawList.reset();
+        return false;
+    }
+    auto& renderer = m_uiloRef->getRenderer();
+    const bool unchanged = !isDirty() && m_bounds == m_drawListBounds;
+    if (unchanged && renderer.replayDrawList(m_drawList)) return true;
+    // Subtrees that can't be recorded just render; retry once they change.
+    if (unchanged && m_drawListUnrecordable) return false;
+
+    m_drawListBounds       = m_bounds;
+    m_drawListUnrecordable = false;
+    renderer.beginDrawList(m_drawList);
+    m_drawListRecording = true;
+    return false;
+}
+
+void Container::endRetainedRender() {
+    if (!m_drawListRecording) return;
+    m_drawListRecording    = false;
+    m_drawListUnrecordable = !m_uiloRef->getRenderer().endDrawList(m_drawList);
+}
+
 bool Container::checkLeftClick(const Vec2f& mousePosition) {
     bool childClicked = false;
 
@@ -58,16 +217,23 @@ bool Container::checkRightClick(const Vec2f& mousePosition) {
 }
 
 bool Container::checkHover(const Vec2f& mousePosition) {
-    // Recurse into ALL children unconditionally so each one can fire its
-    // own onHoverExit when the cursor leaves it. (Previously the parent
-    // skipped children whose bounds did not contain the mouse, which
-    // left their `m_hovered` flag stuck on `true` forever.)
+    // Recurse into every child that could change state: one whose subtree
+    // contains the cursor, or one that is (or holds) the hovered element
+    // and so has to fire onHoverExit. Anything else would be a no-op, so
+    // a mouse move only walks the hovered path instead of the whole tree.
+    // (Testing only the child's own bounds left `m_hovered` stuck on
+    // `true` once the cursor left.)
     bool childHovered = false;
+    bool hoverBelow   = false;
 
     for (auto& child : m_children) {
         if (child->getType() == ElementType::Resizer) continue;
+        if (!child->m_hovered && !child->m_hoverInSubtree &&
+            !child->m_subtreeBounds.contains(mousePosition)) continue;
         if (child->checkHover(mousePosition)) childHovered = true;
+        hoverBelow |= child->m_hovered || child->m_hoverInSubtree;
     }
+    m_hoverInSubtree = hoverBelow;
 
     const bool inside = !childHovered && m_bounds.contains(mousePosition);
 
@@ -124,19 +290,22 @@ bool Container::checkZoom(const Vec2f& mousePosition, float magnification) {
 void Container::addElement(Element* element) {
     if (!element) return;
     m_children.push_back(element);
+    ++m_childrenVersion;
+    element->m_parent = this;
     if (m_uiloRef) {
         element->setUILO(*m_uiloRef);
     }
-    m_dirty = true;
+    markDirty();
 }
 
 void Container::pruneChildren() {
-    m_children.erase(
-        std::remove_if(
-            m_children.begin(), m_children.end(), 
-            [](Element* e) { return e->m_markedForDeletion; }
-        ), m_children.end()
+    const auto end = std::remove_if(
+        m_children.begin(), m_children.end(),
+        [](Element* e) { return e->m_markedForDeletion; }
     );
+    if (end == m_children.end()) return;
+    m_children.erase(end, m_children.end());
+    ++m_childrenVersion;
 }
 
 void Container::setUILO(UILO& uiloRef) {
@@ -154,4 +323,9 @@ void Container::collectResizers(std::vector<Element*>& out) {
     }
 }
 
+void Container::collectSubtree(std::vector<Element*>& out) {
+    out.push_back(this);
+    for (auto* child : m_children) child->collectSubtree(out);
+}
+
 }
\ No newline at end of file
@@ -26,14 +26,81 @@ public:
     void addElement(Element* element);
     void setUILO(UILO& uiloRef) override;
     void collectResizers(std::vector<Element*>& out) override;
+    void collectSubtree(std::vector<Element*>& out) override;
     bool isDirty() const override;
 
     const std::vector<Element*>& getChildren() const { return m_children; }
+    size_t heapBytes() const override {
+        return Element::heapBytes() + m_children.capacity() * sizeof(Element*);
+    }
 
 protected:
     std::vector<Element*> m_children;
+    // Bumped whenever m_children gains or loses an element, so FlatLayout
+    // can tell its copy of the tree is stale.
+    uint32_t m_childrenVersion = 0;
     FrameBuffer m_fb;  // per-container render target (replaces sf::RenderTexture m_rt)
     void pruneChildren();
+    void clearDirty() override;
+    void updateSubtreeCache() override;
+    void tickClean(float dt) override;
+    void translate(Vec2f delta) override;
+
+    // Viewport culling. cullChild() returns true when a visible child lies
+    // entirely outside `viewport` (the clip it would render under), so
+    // render() can skip it; the skip is counted in
+    // RendererStats::culledElements. parkChild() stands in for tick() on a
+    // child whose slot is off-screen (the *Options::setCullUpdates path):
+    // the child just takes the slot as its bounds, so hit-testing and the
+    // next render-time cull see it where it is, and its subtree is left as
+    // it was (dirty flags cleared) until it scrolls back in.
+    bool cullChild(Element* child, const Rectf& viewport);
+    void parkChild(Element* child, const Rectf& slot);
+
+    // Parallel layout (UILO::setLayoutThreads). tickChild() ticks a child
+    // now, or queues it when its subtree is big enough and safe to lay out
+    // off the main thread. flushChildTicks() runs the queue across the
+    // pool and returns once it's done; call it before reading any queued
+    // child's bounds.
+    struct PendingTick { Element* child; Rectf slot; };
+    void tickChild(Element* child, Rectf slot, float dt);
+    // tickChild() for a scrolled child: when only the slot's position
+    // changed, the child is translated into place rather than laid out
+    // again.
+    void tickMovedChild(Element* child, Rectf slot, float dt);
+    void flushChildTicks(float dt);
+    std::vector<PendingTick> m_pendingTicks;
+
+    // Layer caching (ColumnOptions/RowOptions::setLayerCached). Call
+    // beginLayerRender() before beginRetainedRender(): it returns true when
+    // the subtree's cached m_fb was composited and render() should return.
+    // Otherwise it may have redirected drawing into m_fb; endLayerRender()
+    // at the bottom of render() composites it, or returns true when the
+    // subtree turned out uncacheable (glass) and render() must run again
+    // to draw it directly.
+    bool beginLayerRender(bool enabled);
+    bool endLayerRender();
+    Rectf m_layerBounds;
+    Vec2f m_layerOrigin;
+    bool  m_layerRendering   = false;
+    bool  m_layerValid       = false;
+    bool  m_layerUnsupported = false;  // retried when the bounds change
+
+    // Retained rendering (ColumnOptions/RowOptions::setRetained). Call
+    // beginRetainedRender() at the top of render(), after the visibility
+    // and empty-bounds early-outs: it returns true when the subtree's
+    // recorded draw list was replayed (nothing below is dirty, bounds are
+    // unchanged, the parent clip matches) and render() should return.
+    // Otherwise it may have started recording, which endRetainedRender()
+    // at the bottom of render() closes.
+    bool beginRetainedRender(bool enabled);
+    void endRetainedRender();
+    DrawList m_drawList;
+    Rectf    m_drawListBounds;
+    bool     m_drawListRecording    = false;
+    bool     m_drawListUnrecordable = false;  // last try drew images/glass
+
+    friend class FlatLayout;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "FlatLayout.hpp"
+#include "../../UILO.hpp"
+
+namespace uilo {
+
+namespace {
+constexpr uint32_t kNoParent = static_cast<uint32_t>(-1);
+
+// 0 = start (top / left), 1 = centered, 2 = end (bottom / right); the
+// same buckets Column and Row sort their children into.
+int stackGroup(Align align, bool vertical) {
+    if (hasAlign(align, vertical ? Align::Bottom : Align::Right))    return 2;
+    if (hasAlign(align, vertical ? Align::CenterY : Align::CenterX)) return 1;
+    return 0;
+}
+}
+
+/*
+    Classification:
+    - Hidden: not visible; skipped by the sweep like Column/Row skip it
+    - Stack: a plain Column/Row without hooks or Resizer children; its
+      stale children are pruned here, as its update() would have
+    - Leaf: everything else, ticked normally with its slot
+*/
+FlatLayout::Kind FlatLayout::classify(Element* e) const {
+    if (!e->m_modifier.getVisible()) return Hidden;
+    if (e->layoutAxis() == LayoutAxis::None) return Leaf;
+    if (e->m_modifier.getOnUpdateStart() || e->m_modifier.getOnUpdateEnd()) return Leaf;
+
+    auto* c = static_cast<Container*>(e);
+    c->pruneChildren();
+    for (auto* child : c->m_children)
+        if (child->getType() == ElementType::Resizer) return Leaf;
+    return Stack;
+}
+
+void FlatLayout::clear() {
+    m_root = nullptr;
+    m_nodes.clear();   m_parent.clear(); m_first.clear();  m_count.clear();
+    m_version.clear(); m_kind.clear();   m_axis.clear();   m_width.clear();
+    m_height.clear();  m_align.clear();  m_padding.clear(); m_slot.clear();
+    m_rect.clear();    m_main.clear();
+}
+
+/*
+    Build:
+    - Breadth-first walk from the root; a Stack's children are appended
+      as one contiguous run, so the sweep can index them as [first, first + count)
+    - Only topology and kinds are recorded; gather() fills in the values
+*/
+void FlatLayout::build(Container* root) {
+    clear();
+    m_root = root;
+
+    auto push = [&](Element* e, uint32_t parent) {
+        m_nodes.push_back(e);
+        m_parent.push_back(parent);
+        m_first.push_back(0);
+        m_count.push_back(0);
+        m_version.push_back(0);
+        m_kind.push_back(classify(e));
+        m_axis.push_back(e->layoutAxis());
+    };
+
+    push(root, kNoParent);
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_kind[i] != Stack) continue;
+        auto* c = static_cast<Container*>(m_nodes[i]);
+        m_version[i] = c->m_childrenVersion;
+        m_first[i]   = static_cast<uint32_t>(m_nodes.size());
+        m_count[i]   = static_cast<uint32_t>(c->m_children.size());
+        for (auto* child : c->m_children) push(child, static_cast<uint32_t>(i));
+    }
+
+    const size_t n = m_nodes.size();
+    m_width.resize(n);
+    m_height.resize(n);
+    m_align.resize(n);
+    m_padding.resize(n);
+    m_slot.resize(n);
+    m_rect.resize(n);
+    m_main.resize(n);
+}
+
+/*
+    Gather:
+    - Re-reads each node's Modifier into the arrays
+    - Returns false as soon as a node's kind or a Stack's children no
+      longer match the arrays. Nodes are visited parent-first, so the
+      walk stops before it reaches anything a pruned parent let go of
+*/
+bool FlatLayout::gather() {
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        Element* e = m_nodes[i];
+        const Kind kind = classify(e);
+        if (kind != m_kind[i]) return false;
+        if (kind == Stack && static_cast<Container*>(e)->m_childrenVersion != m_version[i])
+            return false;
+
+        const Modifier& mod = e->m_modifier;
+        m_width[i]   = mod.getWidth();
+        m_height[i]  = mod.getHeight();
+        m_align[i]   = mod.getAlign();
+        m_padding[i] = mod.getOuterPadding();
+    }
+    return true;
+}
+
+/*
+    Solve:
+    - One forward sweep; a node's rect is final before its children are visited
+    - Per Stack, the same three passes as Column/Row::update(): fixed and
+      percent totals, resolved extents with group sums, then slots per
+      group (start, centered, end)
+    - Stack children also resolve their rect, mirroring Element::resize()
+*/
+void FlatLayout::solve(float scale) {
+    auto resolve = [&](size_t i, const Rectf& parent) {
+        const float op = m_padding[i] * scale;
+        auto scaled = [&](Dimension dim, float parentSize) {
+            return dim.percent ? (dim.value / 100.f * parentSize) : (dim.value * scale);
+        };
+
+        Rectf r;
+        r.size.x = scaled(m_width[i],  parent.size.x) - 2.f * op;
+        r.size.y = scaled(m_height[i], parent.size.y) - 2.f * op;
+
+        const Rectf inner = {
+            {parent.position.x + op, parent.position.y + op},
+            {parent.size.x - 2.f * op, parent.size.y - 2.f * op}
+        };
+        const Align align = m_align[i];
+
+        if (hasAlign(align, Align::Left))         r.position.x = inner.position.x;
+        else if (hasAlign(align, Align::Right))   r.position.x = inner.position.x + inner.size.x - r.size.x;
+        else if (hasAlign(align, Align::CenterX)) r.position.x = inner.position.x + (inner.size.x - r.size.x) * 0.5f;
+        else                                      r.position.x = inner.position.x;
+
+        if (hasAlign(align, Align::Top))          r.position.y = inner.position.y;
+        else if (hasAlign(align, Align::Bottom))  r.position.y = inner.position.y + inner.size.y - r.size.y;
+        else if (hasAlign(align, Align::CenterY)) r.position.y = inner.position.y + (inner.size.y - r.size.y) * 0.5f;
+        else                                      r.position.y = inner.position.y;
+
+        m_rect[i] = r;
+    };
+
+    resolve(0, m_slot[0]);
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_kind[i] != Stack) continue;
+
+        const Rectf r        = m_rect[i];
+        const bool vertical  = m_axis[i] == LayoutAxis::Vertical;
+        const size_t begin   = m_first[i];
+        const size_t end     = begin + m_count[i];
+        const std::vector<Dimension>& dims = vertical ? m_height : m_width;
+
+        float totalFixed = 0.f;
+        float totalPct   = 0.f;
+        for (size_t j = begin; j < end; ++j) {
+            if (m_kind[j] == Hidden) continue;
+            if (dims[j].percent) totalPct   += dims[j].value;
+            else                 totalFixed += dims[j].value * scale;
+        }
+
+        const float remaining = (vertical ? r.size.y : r.size.x) - totalFixed;
+        const float pctSlot   = totalPct > 0.f ? (remaining * 100.f / totalPct) : remaining;
+
+        float groupExtent[3] = {0.f, 0.f, 0.f};
+        for (size_t j = begin; j < end; ++j) {
+            if (m_kind[j] == Hidden) continue;
+            m_main[j] = dims[j].percent ? (dims[j].value / 100.f * pctSlot) : dims[j].value * scale;
+            groupExtent[stackGroup(m_align[j], vertical)] += m_main[j];
+        }
+
+        const float origin = vertical ? r.position.y : r.position.x;
+        const float extent = vertical ? r.size.y     : r.size.x;
+        const float groupStart[3] = {
+            origin,
+            origin + (extent - groupExtent[1]) * 0.5f,
+            origin + extent - groupExtent[2],
+        };
+
+        for (int g = 0; g < 3; ++g) {
+            float cursor = groupStart[g];
+            for (size_t j = begin; j < end; ++j) {
+                if (m_kind[j] == Hidden) continue;
+                if (stackGroup(m_align[j], vertical) != g) continue;
+
+                const float slotExtent = dims[j].percent ? pctSlot : dims[j].value * scale;
+                const float rh = m_main[j];
+                float at;
+                if (g == 2)      at = cursor + rh - slotExtent;
+                else if (g == 1) at = cursor - (slotExtent - rh) * 0.5f;
+                else             at = cursor;
+
+                m_slot[j] = vertical ? Rectf{{r.position.x, at}, {r.size.x, slotExtent}}
+                                     : Rectf{{at, r.position.y}, {slotExtent, r.size.y}};
+                if (m_kind[j] == Stack) resolve(j, m_slot[j]);
+                cursor += rh;
+            }
+        }
+    }
+}
+
+/*
+    Apply:
+    - Stacks get tick()'s bookkeeping and their solved bounds; Leaves are
+      ticked with their slots in array order
+    - Hidden children are only ticked on a forced update, with their old
+      bounds, as Column/Row do
+    - Subtree caches are refreshed bottom-up once every leaf has run
+*/
+void FlatLayout::apply(float dt) {
+    const bool forced = m_root->m_uiloRef && m_root->m_uiloRef->isForcingTreeUpdate();
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        Element* e = m_nodes[i];
+        switch (m_kind[i]) {
+            case Stack:
+                e->recordTick(m_slot[i]);
+                e->m_layoutDirty = false;
+                if (e->m_bounds.size != m_rect[i].size) e->m_dirty = true;
+                e->m_bounds = m_rect[i];
+                break;
+            case Leaf:
+                e->tick(m_slot[i], dt);
+                break;
+            case Hidden: {
+                if (!forced) break;
+                Rectf slot = e->getBounds();
+                if (slot.size.x <= 0.f || slot.size.y <= 0.f) {
+                    slot.position = m_rect[m_parent[i]].position;
+                    slot.size     = {0.f, 0.f};
+                }
+                e->tick(slot, dt);
+                break;
+            }
+        }
+    }
+
+    for (size_t i = m_nodes.size(); i-- > 0;)
+        if (m_kind[i] == Stack) m_nodes[i]->updateSubtreeCache();
+}
+
+void FlatLayout::run(Container* root, Rectf& bounds, float dt) {
+    if (classify(root) != Stack) {
+        clear();
+        root->tick(bounds, dt);
+        return;
+    }
+
+    // Nothing below the root changed: tick() skips it the same way and
+    // tickClean() still reaches the live leaves.
+    const float scale  = root->m_uiloRef ? root->m_uiloRef->getScale() : 1.f;
+    const bool  forced = root->m_uiloRef && root->m_uiloRef->isForcingTreeUpdate();
+    if (!forced && !root->m_layoutDirty && root->m_wasVisible
+        && bounds == root->m_lastParentBounds && scale == root->m_lastTickScale) {
+        root->tick(bounds, dt);
+        return;
+    }
+
+    if (m_root != root || !gather()) {
+        build(root);
+        gather();
+    }
+    m_slot[0] = bounds;
+    solve(scale);
+    apply(dt);
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Container.hpp"
+
+namespace uilo {
+
+/*
+    FlatLayout — a data-oriented layout pass (UILO::setFlatLayout).
+
+    The page's tree is mirrored breadth-first into structure-of-arrays, so
+    every node's children sit next to each other and after their parent.
+    Plain Column / Row stacking (Element::layoutAxis()) is solved as one
+    forward sweep over those arrays and written back to m_bounds; nothing
+    that isn't a plain stack is expanded. Those nodes (widgets, scrolling
+    containers, anything with hooks or resizers) are leaves here and get an
+    ordinary tick() with the slot the sweep gave them.
+
+    The arrays are rebuilt only when a container's children, visibility,
+    hooks or layout axis change; otherwise each pass just re-reads the
+    Modifier values. Results match what the containers' own update()
+    would have produced.
+*/
+class FlatLayout {
+public:
+    FlatLayout() = default;
+    FlatLayout(const FlatLayout&) = delete;
+    FlatLayout& operator=(const FlatLayout&) = delete;
+
+    // Drop-in for root->tick(bounds, dt). Falls back to exactly that when
+    // the root isn't a plain stack or nothing below it changed.
+    void run(Container* root, Rectf& bounds, float dt);
+
+    // Nodes in the arrays as of the last pass; 0 when it fell back.
+    size_t getNodeCount() const { return m_nodes.size(); }
+
+private:
+    enum Kind : uint8_t { Leaf, Hidden, Stack };
+
+    Kind classify(Element* e) const;
+    void build(Container* root);
+    bool gather();
+    void solve(float scale);
+    void apply(float dt);
+    void clear();
+
+    Container* m_root = nullptr;
+
+    // One entry per node, breadth-first. m_first / m_count index the
+    // node's children and are only meaningful for Stack nodes.
+    std::vector<Element*>   m_nodes;
+    std::vector<uint32_t>   m_parent;
+    std::vector<uint32_t>   m_first;
+    std::vector<uint32_t>   m_count;
+    std::vector<uint32_t>   m_version;    // Container::m_childrenVersion
+    std::vector<Kind>       m_kind;
+    std::vector<LayoutAxis> m_axis;
+    std::vector<Dimension>  m_width;
+    std::vector<Dimension>  m_height;
+    std::vector<Align>      m_align;
+    std::vector<float>      m_padding;
+    std::vector<Rectf>      m_slot;       // what the parent handed down
+    std::vector<Rectf>      m_rect;       // resolved bounds
+    std::vector<float>      m_main;       // scratch: main-axis extent
+};
+
+}
@@ -0,0 +1,15 @@
+#include "ListRows.hpp"
+
+namespace uilo {
+
+void styleListRow(Button& button, bool selected, bool hovered,
+                  Color selectedColor, const Role& selectedRole,
+                  Color hoverColor, const Role& hoverRole) {
+    ButtonOptions& b = button.getOptions();
+    if (selected)     b.setColor(selectedColor).setColorRole(selectedRole);
+    else if (hovered) b.setColor(hoverColor).setColorRole(hoverRole);
+    else              b.setColor(Color{0, 0, 0, 0}).setColorRole("");
+    button.markDirty();
+}
+
+} // namespace uilo
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "VirtualList.hpp"
+#include "../interactible/Button.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace uilo {
+
+// One recycled VirtualList row built around a Button (TreeView,
+// Filebrowser): the button and the item position it is bound to. Widgets
+// derive their row slot from this and add the children they fill in.
+struct ListRow {
+    static constexpr size_t kNoRow = static_cast<size_t>(-1);
+    Button* button = nullptr;
+    size_t  pos    = kNoRow;
+};
+
+// Which bound row the pointer is over. Only the rows that gain or lose the
+// hover are rebound, so moving across a long list restyles two rows, not
+// the viewport.
+class ListRowHover {
+public:
+    template <typename Row>
+    void track(VirtualList& list, const std::vector<Row>& rows, const Vec2f& mousePosition) {
+        int hovered = -1;
+        for (const ListRow& row : rows)
+            if (row.pos != ListRow::kNoRow && row.button->getBounds().contains(mousePosition)) {
+                hovered = (int)row.pos;
+                break;
+            }
+        if (hovered == m_pos) return;
+        if (m_pos   >= 0) list.refreshItem((size_t)m_pos);
+        if (hovered >= 0) list.refreshItem((size_t)hovered);
+        m_pos = hovered;
+    }
+    bool is(size_t pos) const { return (int)pos == m_pos; }
+    // The positions moved under it (rows inserted, erased or replaced).
+    void reset() { m_pos = -1; }
+
+private:
+    int m_pos = -1;
+};
+
+// Colours a bound row's button: selected over hovered over clear. Goes
+// through getOptions(), since Button::setOptions() would reset the
+// children to a single label.
+void styleListRow(Button& button, bool selected, bool hovered,
+                  Color selectedColor, const Role& selectedRole,
+                  Color hoverColor, const Role& hoverRole);
+
+} // namespace uilo
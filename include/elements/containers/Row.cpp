@@ -1,5 +1,6 @@
 #include "Row.hpp"
 #include "../../UILO.hpp"
+#include "../../utils/Trace.hpp"
 #include "../../utils/RenderUtils.hpp"
 #include "../interactible/Resizer.hpp"
 #include <algorithm>
@@ -45,9 +46,36 @@ float normalizeGridStep(float step,
 
 Row::Row(Modifier modifier, RowOptions options, contains children, const std::string& name)
     : Container(modifier, children, name), m_options(options)
-{}
+{
+    m_type = ElementType::Row;
+}
+
+void Row::resolveLinks() {
+    if (!m_uiloRef) return;
+    const std::string& scrollId = m_options.getScrollLink();
+    const std::string& zoomId   = m_options.getZoomLink();
+    if (scrollId == m_scrollLinkId && zoomId == m_zoomLinkId &&
+        (m_scrollLink.valid() || m_zoomLink.valid() || !linked())) return;
+    // The old links would otherwise keep marking this dirty.
+    if (m_scrollLink.valid()) m_uiloRef->unsubscribeLink(m_scrollLink, this);
+    if (m_zoomLink.valid())   m_uiloRef->unsubscribeLink(m_zoomLink, this);
+    m_scrollLinkId = scrollId;
+    m_zoomLinkId   = zoomId;
+    m_scrollLink   = m_uiloRef->resolveLink(LinkKind::ScrollX, scrollId);
+    m_zoomLink     = m_uiloRef->resolveLink(LinkKind::ZoomX, zoomId);
+    bool subscribed = true;
+    if (m_scrollLink.valid()) subscribed &= m_uiloRef->subscribeLink(m_scrollLink, this);
+    if (m_zoomLink.valid())   subscribed &= m_uiloRef->subscribeLink(m_zoomLink, this);
+    m_pollLinks = !subscribed;
+}
+
+void Row::translate(Vec2f delta) {
+    Container::translate(delta);
+    m_scrollViewportX += delta.x;
+}
 
 void Row::update(Rectf& parentBounds, float dt) {
+    UILO_TRACE_ZONE("Row::update");
     pruneChildren();
     resize(parentBounds);
     const bool forceTreeUpdate = m_uiloRef && m_uiloRef->isForcingTreeUpdate();
@@ -58,22 +86,19 @@ void Row::update(Rectf& parentBounds, float dt) {
         m_lastScale = scale;
     }
 
-    if (m_uiloRef && !m_options.getScrollLink().empty()) {
-        m_scrollOffset = m_uiloRef->getScrollLinkOffset(m_options.getScrollLink(), true);
-    }
-
-    if (m_uiloRef && !m_options.getZoomLink().empty()) {
-        m_zoomX = m_uiloRef->getZoomLinkValue(m_options.getZoomLink(), true);
-    }
+    resolveLinks();
+    if (m_uiloRef && m_scrollLink.valid()) m_scrollOffset = m_uiloRef->getLinkValue(m_scrollLink);
+    if (m_uiloRef && m_zoomLink.valid())   m_zoomX      = m_uiloRef->getLinkValue(m_zoomLink);
 
     m_scrollViewportWidth = m_bounds.size.x;
 
     // Scrollable path: supports pinned children (Modifier::ignoreScroll)
     // and scrolls only the remaining sibling viewport.
     if (m_options.getScrollable()) {
-        std::vector<Element*> pinnedLeft;
-        std::vector<Element*> pinnedMid;
-        std::vector<Element*> pinnedRight;
+        FrameArena* arena = getFrameArena();
+        FrameVector<Element*> pinnedLeft(arena);
+        FrameVector<Element*> pinnedMid(arena);
+        FrameVector<Element*> pinnedRight(arena);
 
         auto resolvedPinnedW = [&](Element* e) -> float {
             Dimension dim = e->getModifier().getWidth();
@@ -103,12 +128,12 @@ void Row::update(Rectf& parentBounds, float dt) {
             }
         }
 
-        auto layoutPinnedGroup = [&](std::vector<Element*>& group, float startX) {
+        auto layoutPinnedGroup = [&](FrameVector<Element*>& group, float startX) {
             float cursorX = startX;
             for (auto* child : group) {
                 const float rw = resolvedPinnedW(child);
                 Rectf slot{{cursorX, m_bounds.position.y}, {rw, m_bounds.size.y}};
-                child->tick(slot, dt);
+                tickChild(child, slot, dt);
                 cursorX += rw;
             }
         };
@@ -124,6 +149,7 @@ void Row::update(Rectf& parentBounds, float dt) {
 
         float cursorX = scrollViewport.position.x - m_scrollOffset;
         m_contentWidth = 0.f;
+        const bool cullUpdates = m_options.getCullUpdates() && !forceTreeUpdate;
         for (auto* child : m_children) {
             if (!child->getModifier().getVisible()) continue;
             if (child->getType() == ElementType::Resizer) continue;
@@ -133,10 +159,14 @@ void Row::update(Rectf& parentBounds, float dt) {
             const float zf = m_options.getZoomableX() ? m_zoomX : 1.f;
             float rw = dim.percent ? (scrollViewport.size.x * dim.value / 100.f) : dim.value * scale * zf;
             Rectf slot{ {cursorX, scrollViewport.position.y}, {rw, scrollViewport.size.y} };
-            child->tick(slot, dt);
+            // A scroll only moves the slots, so the children are
+            // translated rather than laid out again.
+            if (cullUpdates && !slot.intersects(m_bounds)) parkChild(child, slot);
+            else                                           tickMovedChild(child, slot, dt);
             cursorX       += rw;
             m_contentWidth += rw;
         }
+        flushChildTicks(dt);
         m_scrollViewportX = scrollViewport.position.x;
         const float contentMax = std::max(0.f, m_contentWidth - scrollViewport.size.x);
         float minScroll = 0.f;
@@ -144,10 +174,10 @@ void Row::update(Rectf& parentBounds, float dt) {
         resolveScrollBounds(m_options, contentMax, minScroll, maxScroll);
         const float clamped     = std::clamp(m_scrollOffset, minScroll, maxScroll);
         if (clamped != m_scrollOffset) { m_scrollOffset = clamped; m_dirty = true; }
-        if (m_uiloRef && !m_options.getScrollLink().empty())
-            m_uiloRef->setScrollLinkOffset(m_options.getScrollLink(), m_scrollOffset, true);
-        if (m_uiloRef && !m_options.getZoomLink().empty())
-            m_uiloRef->setZoomLinkValue(m_options.getZoomLink(), m_zoomX, true);
+        if (m_uiloRef && m_scrollLink.valid())
+            m_uiloRef->setLinkValue(m_scrollLink, m_scrollOffset, this);
+        if (m_uiloRef && m_zoomLink.valid())
+            m_uiloRef->setLinkValue(m_zoomLink, m_zoomX, this);
 
         // Keep resizers interactive in scrollable rows while still excluding
         // them from layout flow.
@@ -231,9 +261,11 @@ void Row::update(Rectf& parentBounds, float dt) {
         return;
     }
 
-    std::vector<Element*> left;
-    std::vector<Element*> mid;
-    std::vector<Element*> right;
+    FrameArena* arena = getFrameArena();
+    FrameVector<Element*> left(arena);
+    FrameVector<Element*> mid(arena);
+    FrameVector<Element*> right(arena);
+    left.reserve(m_children.size());
 
     float totalFixed = 0.f;
     float totalPct = 0.f;
@@ -300,7 +332,7 @@ void Row::update(Rectf& parentBounds, float dt) {
         - Adjusts the slot origin within the slot based on the child's
           horizontal alignment flag (LEFT, MIDX, RIGHT)
     */
-    auto layoutGroup = [&](std::vector<Element*>& group, float startX) {
+    auto layoutGroup = [&](FrameVector<Element*>& group, float startX) {
         float cursorX = startX;
 
         for (auto* child : group) {
@@ -317,7 +349,7 @@ void Row::update(Rectf& parentBounds, float dt) {
             Rectf slot;
             slot.position   = { slotX, m_bounds.position.y };
             slot.size       = { sw, m_bounds.size.y };
-            child->tick(slot, dt);
+            tickChild(child, slot, dt);
             cursorX += rw;
         }
     };
@@ -331,6 +363,7 @@ void Row::update(Rectf& parentBounds, float dt) {
     layoutGroup(left,  m_bounds.position.x);
     layoutGroup(mid,   m_bounds.position.x + (m_bounds.size.x - midW) * 0.5f);
     layoutGroup(right, m_bounds.position.x + m_bounds.size.x - rightW);
+    flushChildTicks(dt);
 
     // Position Resizer children at element boundaries (invisible to layout flow)
     for (size_t i = 0; i < m_children.size(); ++i) {
@@ -421,6 +454,9 @@ void Row::update(Rectf& parentBounds, float dt) {
 void Row::render() {
     if (!m_modifier.getVisible()) return;
     if (m_bounds.size.x <= 0.f || m_bounds.size.y <= 0.f) return;
+    if (beginLayerRender(m_options.getLayerCached()
+                         && m_modifier.getMaterial().kind == Material::Kind::None)) return;
+    if (beginRetainedRender(m_options.getRetained())) return;
 
     // TODO: BGFX rendering — background fill + children
     float scale = m_uiloRef ? m_uiloRef->getScale() : 1.f;
@@ -438,15 +474,18 @@ void Row::render() {
         } else {
             float r = m_options.getRounding() * scale;
             Color gc[4];
+            GradientRamp ramp;
             if (resolveGradient(m_options.getGradient(),
-                                m_options.getGradientRole(), gc)) {
+                                m_options.getGradientRole(), gc, &ramp)) {
                 if (r <= 0.f) {
                     Rect shape{m_bounds.position, m_bounds.size};
                     shape.setGradientColors(gc);
+                    shape.ramp = ramp;
                     m_uiloRef->getRenderer().draw(shape);
                 } else {
                     RoundedRect shape{m_bounds.position, m_bounds.size, r, 8u};
                     shape.setGradientColors(gc);
+                    shape.ramp = ramp;
                     m_uiloRef->getRenderer().draw(shape);
                 }
             } else if (bg.a > 0) {
@@ -520,7 +559,7 @@ void Row::render() {
                 minorColor.a = static_cast<uint8_t>(static_cast<float>(divColor.a) * 0.45f);
                 const float minorOffset = positiveMod(m_scrollOffset, minorStep);
                 const float firstMinorX = viewLeft - minorOffset;
-                std::vector<Line> minorLines;
+                FrameVector<Line> minorLines(getFrameArena());
                 const size_t minorEstimate = static_cast<size_t>(
                     std::max(0.f, (viewRight + 0.5f - firstMinorX) / minorStep) + 1.f);
                 minorLines.reserve(minorEstimate);
@@ -533,7 +572,7 @@ void Row::render() {
             if (majorStep > 0.f) {
                 const float majorOffset = positiveMod(m_scrollOffset, majorStep);
                 const float firstMajorX = viewLeft - majorOffset;
-                std::vector<Line> majorLines;
+                FrameVector<Line> majorLines(getFrameArena());
                 const size_t majorEstimate = static_cast<size_t>(
                     std::max(0.f, (viewRight + 0.5f - firstMajorX) / majorStep) + 1.f);
                 majorLines.reserve(majorEstimate);
@@ -551,11 +590,12 @@ void Row::render() {
         for (auto* child : m_children) {
             if (child->getType() == ElementType::Resizer) continue;
             if (child->getModifier().getIgnoreScroll() != ignoreScrollChildren) continue;
+            if (cullChild(child, m_bounds)) continue;
             if (m_uiloRef) {
                 const float rr = m_options.getRounding() * (m_uiloRef->getScale());
                 m_uiloRef->getRenderer().pushRoundClip(m_bounds, rr);
             }
-            child->render();
+            child->paint();
             if (m_uiloRef) m_uiloRef->getRenderer().popRoundClip();
         }
     };
@@ -566,6 +606,8 @@ void Row::render() {
 
     if (glassSubtree) m_uiloRef->getRenderer().endGlassSubtree();
 
+    endRetainedRender();
+    if (endLayerRender()) { render(); return; }
     m_dirty = false;
 }
 
@@ -592,18 +634,18 @@ bool Row::checkZoom(const Vec2f& mousePosition, float magnification) {
     float maxScroll = 0.f;
     resolveScrollBounds(m_options, std::max(0.f, m_contentWidth - m_scrollViewportWidth), minScroll, maxScroll);
     m_scrollOffset = std::clamp(content * sc * m_zoomX - mRel, minScroll, maxScroll);
-    if (m_uiloRef && !m_options.getScrollLink().empty())
-        m_uiloRef->setScrollLinkOffset(m_options.getScrollLink(), m_scrollOffset, true);
-    if (m_uiloRef && !m_options.getZoomLink().empty())
-        m_uiloRef->setZoomLinkValue(m_options.getZoomLink(), m_zoomX, true);
+    if (m_uiloRef && m_scrollLink.valid())
+        m_uiloRef->setLinkValue(m_scrollLink, m_scrollOffset, this);
+    if (m_uiloRef && m_zoomLink.valid())
+        m_uiloRef->setLinkValue(m_zoomLink, m_zoomX, this);
 
-    m_dirty = true;
+    markDirty();
     return true;
 }
 
 void Row::setZoomX(float z) {
     m_zoomX = std::clamp(z, m_options.getZoomMin(), m_options.getZoomMax());
-    m_dirty = true;
+    markDirty();
 }
 
 bool Row::checkScroll(const Vec2f& mousePosition, float delta, bool precise, bool momentum) {
@@ -626,11 +668,11 @@ bool Row::checkScroll(const Vec2f& mousePosition, float delta, bool precise, boo
         float maxScroll = 0.f;
         resolveScrollBounds(m_options, contentMax, minScroll, maxScroll);
         m_scrollOffset = std::clamp(m_scrollOffset - delta * step, minScroll, maxScroll);
-        if (m_uiloRef && !m_options.getScrollLink().empty())
-            m_uiloRef->setScrollLinkOffset(m_options.getScrollLink(), m_scrollOffset, true);
-        if (m_uiloRef && !m_options.getZoomLink().empty())
-            m_uiloRef->setZoomLinkValue(m_options.getZoomLink(), m_zoomX, true);
-        m_dirty = true;
+        if (m_uiloRef && m_scrollLink.valid())
+            m_uiloRef->setLinkValue(m_scrollLink, m_scrollOffset, this);
+        if (m_uiloRef && m_zoomLink.valid())
+            m_uiloRef->setLinkValue(m_zoomLink, m_zoomX, this);
+        markDirty();
         return true;
     }
 
@@ -658,11 +700,11 @@ bool Row::checkScroll(const Vec2f& mousePosition, Vec2f delta, bool precise, boo
             float minScroll = 0.f, maxScroll = 0.f;
             resolveScrollBounds(m_options, contentMax, minScroll, maxScroll);
             m_scrollOffset = std::clamp(m_scrollOffset - delta.x * step, minScroll, maxScroll);
-            if (m_uiloRef && !m_options.getScrollLink().empty())
-                m_uiloRef->setScrollLinkOffset(m_options.getScrollLink(), m_scrollOffset, true);
-            if (m_uiloRef && !m_options.getZoomLink().empty())
-                m_uiloRef->setZoomLinkValue(m_options.getZoomLink(), m_zoomX, true);
-            m_dirty  = true;
+            if (m_uiloRef && m_scrollLink.valid())
+                m_uiloRef->setLinkValue(m_scrollLink, m_scrollOffset, this);
+            if (m_uiloRef && m_zoomLink.valid())
+                m_uiloRef->setLinkValue(m_zoomLink, m_zoomX, this);
+            markDirty();
             consumed = true;
         }
     }
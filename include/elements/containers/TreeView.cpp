@@ -0,0 +1,353 @@
+#include "TreeView.hpp"
+
+#include <algorithm>
+
+#include "../../UILO.hpp"
+
+namespace uilo {
+
+TreeView::TreeView(Modifier modifier, TreeViewOptions options, const std::string& name)
+    : VirtualColumn(modifier,
+                    VirtualListOptions()
+                        .setItemExtent(options.getItemHeight())
+                        .setScrollSpeed(options.getScrollSpeed())
+                        .setColor(options.getColor())
+                        .setColorRole(options.getColorRole()),
+                    name)
+    , m_treeOptions(std::move(options))
+{
+    // Hidden root: always expanded, its children are the top level.
+    Node root;
+    root.id          = kRoot;
+    root.hasChildren = true;
+    root.expanded    = true;
+    m_nodes.push_back(std::move(root));
+    m_byId.emplace(kRoot, 0);
+
+    getOptions()
+        .setCreateItem([this]() { return createRow(); })
+        .setBindItem([this](Element* e, size_t pos) {
+            for (size_t k = 0; k < m_rows.size(); ++k)
+                if (m_rows[k].button == e) { bindRow(k, pos); return; }
+        });
+}
+
+// ---- Node store ------------------------------------------------------------
+
+uint32_t TreeView::find(uint64_t id) const {
+    auto it = m_byId.find(id);
+    return it == m_byId.end() ? kNoNode : it->second;
+}
+
+uint32_t TreeView::allocNode() {
+    if (!m_free.empty()) {
+        const uint32_t i = m_free.back();
+        m_free.pop_back();
+        return i;
+    }
+    m_nodes.emplace_back();
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+// Frees every descendant of `node` (not the node itself) back to m_free.
+void TreeView::releaseChildren(uint32_t node) {
+    m_scratch.assign(m_nodes[node].children.begin(), m_nodes[node].children.end());
+    std::vector<uint32_t>().swap(m_nodes[node].children);
+    while (!m_scratch.empty()) {
+        const uint32_t i = m_scratch.back();
+        m_scratch.pop_back();
+        Node& n = m_nodes[i];
+        m_scratch.insert(m_scratch.end(), n.children.begin(), n.children.end());
+        m_byId.erase(n.id);
+        n = Node{};
+        m_free.push_back(i);
+    }
+}
+
+// ---- Visible rows ----------------------------------------------------------
+
+bool TreeView::childRange(uint32_t node, size_t& first, size_t& end) const {
+    if (node == 0) {
+        first = 0;
+        end   = m_visible.size();
+        return true;
+    }
+    // On screen only when every ancestor is expanded; only then is the
+    // O(visible) search worth doing.
+    for (uint32_t p = m_nodes[node].parent; p != 0; p = m_nodes[p].parent)
+        if (p == kNoNode || !m_nodes[p].expanded) return false;
+    auto it = std::find(m_visible.begin(), m_visible.end(), node);
+    if (it == m_visible.end()) return false;
+    first = static_cast<size_t>(it - m_visible.begin()) + 1;
+    end   = first;
+    const uint32_t depth = m_nodes[node].depth;
+    while (end < m_visible.size() && m_nodes[m_visible[end]].depth > depth) ++end;
+    return true;
+}
+
+// Pre-order rows under an expanded, loaded `node`, descending into the
+// children that are expanded themselves.
+void TreeView::appendVisible(uint32_t node, std::vector<uint32_t>& out) const {
+    std::vector<uint32_t> stack(m_nodes[node].children.rbegin(), m_nodes[node].children.rend());
+    while (!stack.empty()) {
+        const uint32_t i = stack.back();
+        stack.pop_back();
+        out.push_back(i);
+        const Node& n = m_nodes[i];
+        if (n.expanded && n.load == Load::Done)
+            stack.insert(stack.end(), n.children.rbegin(), n.children.rend());
+    }
+}
+
+/*
+    insertRows(size_t at, const std::vector<uint32_t>& rows) / eraseRows:
+    - Desc:     Splice the visible array. A change above the first row in
+                view moves the scroll offset by the same amount, so what's
+                on screen stays put when an off-screen branch loads.
+*/
+void TreeView::insertRows(size_t at, const std::vector<uint32_t>& rows) {
+    if (rows.empty()) return;
+    m_hover.reset();   // positions below `at` shift
+    m_visible.insert(m_visible.begin() + (ptrdiff_t)at, rows.begin(), rows.end());
+    if (at < getFirstVisibleItem()) {
+        const float scale = m_uiloRef ? m_uiloRef->getScale() : 1.f;
+        setScrollOffset(getScrollOffset() + (float)rows.size() * m_treeOptions.getItemHeight() * scale);
+    }
+}
+
+void TreeView::eraseRows(size_t first, size_t end) {
+    if (end <= first) return;
+    m_hover.reset();
+    m_visible.erase(m_visible.begin() + (ptrdiff_t)first, m_visible.begin() + (ptrdiff_t)end);
+    if (first < getFirstVisibleItem()) {
+        const float scale = m_uiloRef ? m_uiloRef->getScale() : 1.f;
+        const size_t above = std::min(end, getFirstVisibleItem()) - first;
+        setScrollOffset(getScrollOffset() - (float)above * m_treeOptions.getItemHeight() * scale);
+    }
+}
+
+void TreeView::rowsChanged() {
+    // Rebinds the recycled rows; no element is created or freed.
+    setItemCount(m_visible.size());
+}
+
+// ---- Expand / collapse -----------------------------------------------------
+
+void TreeView::expandNode(uint32_t node) {
+    Node& n = m_nodes[node];
+    if (!n.hasChildren || n.expanded) return;
+    n.expanded = true;
+    const uint64_t id = n.id;
+    if (m_treeOptions.getOnToggle()) m_treeOptions.getOnToggle()(id, true);
+
+    if (n.load == Load::None) {
+        // Rows appear when setChildren() answers, possibly from inside
+        // this call.
+        n.load = Load::Pending;
+        rowsChanged();
+        if (m_treeOptions.getFetchChildren()) m_treeOptions.getFetchChildren()(*this, id);
+        return;
+    }
+    if (n.load == Load::Pending) { rowsChanged(); return; }
+
+    size_t first = 0, end = 0;
+    if (childRange(node, first, end)) {
+        std::vector<uint32_t> rows;
+        appendVisible(node, rows);
+        insertRows(first, rows);
+    }
+    rowsChanged();
+}
+
+void TreeView::collapseNode(uint32_t node) {
+    Node& n = m_nodes[node];
+    if (node == 0 || !n.expanded) return;
+    size_t first = 0, end = 0;
+    if (childRange(node, first, end)) eraseRows(first, end);
+    n.expanded = false;
+    if (m_treeOptions.getReleaseCollapsed() && n.load == Load::Done) {
+        releaseChildren(node);
+        m_nodes[node].load = Load::None;
+    }
+    rowsChanged();
+    if (m_treeOptions.getOnToggle()) m_treeOptions.getOnToggle()(m_nodes[node].id, false);
+}
+
+void TreeView::expand(uint64_t id) {
+    const uint32_t i = find(id);
+    if (i != kNoNode) expandNode(i);
+}
+
+void TreeView::collapse(uint64_t id) {
+    const uint32_t i = find(id);
+    if (i != kNoNode) collapseNode(i);
+}
+
+void TreeView::toggle(uint64_t id) {
+    const uint32_t i = find(id);
+    if (i == kNoNode) return;
+    if (m_nodes[i].expanded) collapseNode(i);
+    else                     expandNode(i);
+}
+
+bool TreeView::isExpanded(uint64_t id) const {
+    const uint32_t i = find(id);
+    return i != kNoNode && m_nodes[i].expanded;
+}
+
+bool TreeView::isLoading(uint64_t id) const {
+    const uint32_t i = find(id);
+    return i != kNoNode && m_nodes[i].load == Load::Pending;
+}
+
+/*
+    setChildren(uint64_t parent, std::vector<TreeNodeInfo> children):
+    - Params:   uint64_t parent, std::vector<TreeNodeInfo> children
+    - Returns:  bool
+    - Desc:     The provider's answer for `parent`. Replaces (and frees)
+                any children it had; when the parent is expanded and on
+                screen, its old rows are cut out of the visible array and
+                the new ones spliced in, so the cost is the number of
+                visible rows rather than the size of the tree. Ids that
+                already exist elsewhere in the tree are skipped.
+*/
+bool TreeView::setChildren(uint64_t parent, std::vector<TreeNodeInfo> children) {
+    const uint32_t p = find(parent);
+    if (p == kNoNode) return false;
+
+    size_t first = 0, end = 0;
+    const bool onScreen = m_nodes[p].expanded && childRange(p, first, end);
+    if (onScreen) eraseRows(first, end);
+    releaseChildren(p);
+
+    const uint32_t depth = p == 0 ? 0 : m_nodes[p].depth + 1;
+    std::vector<uint32_t> kids;
+    kids.reserve(children.size());
+    for (auto& info : children) {
+        if (m_byId.count(info.id)) continue;
+        const uint32_t i = allocNode();
+        Node& n = m_nodes[i];              // allocNode() may have moved m_nodes
+        n.id          = info.id;
+        n.label       = std::move(info.label);
+        n.hasChildren = info.hasChildren;
+        n.parent      = p;
+        n.depth       = depth;
+        m_byId.emplace(n.id, i);
+        kids.push_back(i);
+    }
+    Node& pn = m_nodes[p];
+    pn.children    = std::move(kids);
+    pn.load        = Load::Done;
+    pn.hasChildren = p == 0 || !pn.children.empty();
+
+    if (onScreen) insertRows(first, pn.children);
+    rowsChanged();
+    return true;
+}
+
+void TreeView::reload(uint64_t id) {
+    const uint32_t i = find(id);
+    if (i == kNoNode) return;
+    size_t first = 0, end = 0;
+    if (m_nodes[i].expanded && childRange(i, first, end)) eraseRows(first, end);
+    releaseChildren(i);
+    Node& n = m_nodes[i];
+    n.load = Load::None;
+    if (n.expanded) {
+        // Fetch again as if it had just been expanded.
+        n.expanded = false;
+        n.hasChildren = true;
+        expandNode(i);
+    } else {
+        rowsChanged();
+    }
+}
+
+void TreeView::select(uint64_t id) {
+    if (id == m_selected) return;
+    m_selected = id;
+    refresh();
+    if (m_treeOptions.getOnSelect()) m_treeOptions.getOnSelect()(id);
+}
+
+// ---- Rows ------------------------------------------------------------------
+
+Element* TreeView::createRow() {
+    const TreeViewOptions& o = m_treeOptions;
+    TextOptions textOpts;
+    if (!o.getFontPath().empty()) textOpts.setFont(o.getFontPath());
+    if (o.hasCharSize()) textOpts.setCharSize(o.getCharSize());
+    textOpts
+        .setColor(o.getTextColor())
+        .setColorRole(o.getTextColorRole())
+        .setTextAlignY(Align::CenterY);
+
+    RowSlot row;
+    row.indent     = new Spacer(Modifier().setWidth({0.f, false}).setHeight({100.f, true}), SpacerOptions());
+    row.disclosure = new Text(Modifier().setWidth({o.getItemHeight(), false}).setHeight({100.f, true}),
+                              TextOptions(textOpts).setTextAlignX(Align::CenterX), "");
+    row.label      = new Text(Modifier().setWidth({100.f, true}).setHeight({100.f, true}),
+                              textOpts, "");
+
+    const size_t slot = m_rows.size();
+    row.button = new Button(
+        Modifier().setWidth({100.f, true}).setHeight({o.getItemHeight(), false})
+            .setOnLeftClick([this, slot]() { onRowClick(slot); }),
+        ButtonOptions(), "");
+    row.button->addElement(row.indent);
+    row.button->addElement(row.disclosure);
+    row.button->addElement(row.label);
+    m_rows.push_back(row);
+    return row.button;
+}
+
+void TreeView::bindRow(size_t slot, size_t pos) {
+    RowSlot& row = m_rows[slot];
+    row.pos = pos;
+    if (pos >= m_visible.size()) return;
+    const Node& n = m_nodes[m_visible[pos]];
+
+    row.indent->getModifier().setWidth({(float)n.depth * m_treeOptions.getIndent(), false});
+    row.disclosure->setString(!n.hasChildren        ? ""
+                              : n.load == Load::Pending ? "..."
+                              : n.expanded           ? "-" : "+");
+    row.label->setString(n.label);
+
+    const TreeViewOptions& o = m_treeOptions;
+    styleListRow(*row.button, n.id == m_selected, m_hover.is(pos),
+                 o.getSelectedColor(), o.getSelectedColorRole(),
+                 o.getRowHoverColor(), o.getRowHoverColorRole());
+}
+
+void TreeView::onRowClick(size_t slot) {
+    const RowSlot& row = m_rows[slot];
+    if (row.pos >= m_visible.size()) return;
+    const uint32_t node  = m_visible[row.pos];
+    const Vec2f    mouse = m_uiloRef ? m_uiloRef->getMousePosition() : Vec2f{};
+    if (m_nodes[node].hasChildren && row.disclosure->getBounds().contains(mouse)) {
+        if (m_nodes[node].expanded) collapseNode(node);
+        else                        expandNode(node);
+        return;
+    }
+    select(m_nodes[node].id);
+}
+
+// ---- Update ----------------------------------------------------------------
+
+void TreeView::update(Rectf& parentBounds, float dt) {
+    if (!m_started) {
+        m_started = true;
+        if (m_nodes[0].load == Load::None) {
+            m_nodes[0].load = Load::Pending;
+            if (m_treeOptions.getFetchChildren()) m_treeOptions.getFetchChildren()(*this, kRoot);
+        }
+    }
+    VirtualList::update(parentBounds, dt);
+}
+
+bool TreeView::checkHover(const Vec2f& mousePosition) {
+    m_hover.track(*this, m_rows, mousePosition);
+    return VirtualList::checkHover(mousePosition);
+}
+
+}
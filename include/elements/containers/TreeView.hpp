@@ -0,0 +1,190 @@
+#pragma once
+
+#include "ListRows.hpp"
+#include "VirtualList.hpp"
+#include "../decoration/Spacer.hpp"
+#include "../decoration/Text.hpp"
+#include "../interactible/Button.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace uilo {
+
+class TreeView;
+
+// One node as the provider describes it. Ids are the provider's own and
+// must be unique within the tree.
+struct TreeNodeInfo {
+    uint64_t    id          = 0;
+    std::string label;
+    bool        hasChildren = false;
+};
+
+class TreeViewOptions {
+public:
+    TreeViewOptions() = default;
+
+    // Asked for the children of `parent` (TreeView::kRoot for the top
+    // level) the first time it's expanded. Answer with
+    // TreeView::setChildren(), right away or later; an answer from another
+    // thread has to come through UILO::post().
+    TreeViewOptions& setFetchChildren(std::function<void(TreeView&, uint64_t parent)> f) {
+        m_fetch = std::move(f); return *this;
+    }
+    TreeViewOptions& setOnSelect(std::function<void(uint64_t id)> f)               { m_onSelect = std::move(f); return *this; }
+    TreeViewOptions& setOnToggle(std::function<void(uint64_t id, bool expanded)> f) { m_onToggle = std::move(f); return *this; }
+    // Forget a node's children when it collapses (they're fetched again on
+    // the next expand), so only expanded branches are held in memory.
+    TreeViewOptions& setReleaseCollapsed(bool v)      { m_releaseCollapsed = v; return *this; }
+
+    TreeViewOptions& setItemHeight(float h)           { m_itemHeight = h;  return *this; }
+    TreeViewOptions& setIndent(float px)              { m_indent = px;     return *this; }
+    TreeViewOptions& setScrollSpeed(float s)          { m_scrollSpeed = s; return *this; }
+    TreeViewOptions& setFont(const std::string& path) { m_fontPath = path; return *this; }
+    TreeViewOptions& setCharSize(unsigned int n)      { m_charSize = n;    return *this; }
+    TreeViewOptions& setColor(Color c)                { m_color = c;       return *this; }
+    TreeViewOptions& setColorRole(const std::string& r) { m_colorRole = r; return *this; }
+    TreeViewOptions& setRowHoverColor(Color c)        { m_hoverColor = c;  return *this; }
+    TreeViewOptions& setRowHoverColorRole(const std::string& r) { m_hoverColorRole = r; return *this; }
+    TreeViewOptions& setSelectedColor(Color c)        { m_selectedColor = c; return *this; }
+    TreeViewOptions& setSelectedColorRole(const std::string& r) { m_selectedColorRole = r; return *this; }
+    TreeViewOptions& setTextColor(Color c)            { m_textColor = c;   return *this; }
+    TreeViewOptions& setTextColorRole(const std::string& r) { m_textColorRole = r; return *this; }
+
+    const std::function<void(TreeView&, uint64_t)>&   getFetchChildren() const { return m_fetch; }
+    const std::function<void(uint64_t)>&              getOnSelect()      const { return m_onSelect; }
+    const std::function<void(uint64_t, bool)>&        getOnToggle()      const { return m_onToggle; }
+    bool               getReleaseCollapsed()   const { return m_releaseCollapsed; }
+    float              getItemHeight()         const { return m_itemHeight; }
+    float              getIndent()             const { return m_indent; }
+    float              getScrollSpeed()        const { return m_scrollSpeed; }
+    const std::string& getFontPath()           const { return m_fontPath; }
+    unsigned int       getCharSize()           const { return m_charSize.value_or(14); }
+    bool               hasCharSize()           const { return m_charSize.has_value(); }
+    Color              getColor()              const { return m_color; }
+    const Role&        getColorRole()          const { return m_colorRole; }
+    Color              getRowHoverColor()      const { return m_hoverColor; }
+    const Role&        getRowHoverColorRole()  const { return m_hoverColorRole; }
+    Color              getSelectedColor()      const { return m_selectedColor; }
+    const Role&        getSelectedColorRole()  const { return m_selectedColorRole; }
+    Color              getTextColor()          const { return m_textColor; }
+    const Role&        getTextColorRole()      const { return m_textColorRole; }
+
+private:
+    std::function<void(TreeView&, uint64_t)> m_fetch;
+    std::function<void(uint64_t)>            m_onSelect;
+    std::function<void(uint64_t, bool)>      m_onToggle;
+    bool         m_releaseCollapsed = false;
+    float        m_itemHeight    = 24.f;
+    float        m_indent        = 16.f;
+    float        m_scrollSpeed   = 40.f;
+    std::string  m_fontPath;
+    std::optional<unsigned int> m_charSize;
+    Color        m_color         = Color{0, 0, 0, 0};
+    Role         m_colorRole;
+    Color        m_hoverColor    = Color{55, 55, 55, 255};
+    Role         m_hoverColorRole;
+    Color        m_selectedColor = Color{45, 75, 120, 255};
+    Role         m_selectedColorRole;
+    Color        m_textColor     = Color::White;
+    Role         m_textColorRole;
+};
+
+/*
+    TreeView — a VirtualColumn over the tree's visible rows. The nodes
+    fetched so far live in one flat store; the rows on screen are a
+    pre-order array of the expanded part of the tree, so expanding or
+    collapsing splices that array (O(visible rows)) and the recycled row
+    elements just rebind. Children are fetched through the provider on
+    first expand and may arrive asynchronously; until then the node shows
+    as loading. Clicking the disclosure toggles a node, clicking the rest
+    of the row selects it.
+*/
+class TreeView : public VirtualColumn {
+public:
+    static constexpr uint64_t kRoot = UINT64_MAX;
+
+    explicit TreeView(Modifier modifier, TreeViewOptions options = {}, const std::string& name = "");
+
+    const TreeViewOptions& getTreeOptions() const { return m_treeOptions; }
+
+    // The children of `parent` (kRoot: the top level), replacing any it
+    // had. False when `parent` isn't a known node.
+    bool setChildren(uint64_t parent, std::vector<TreeNodeInfo> children);
+    // Drop a node's children and fetch them again if it's expanded.
+    void reload(uint64_t id = kRoot);
+
+    void expand(uint64_t id);
+    void collapse(uint64_t id);
+    void toggle(uint64_t id);
+    bool isExpanded(uint64_t id) const;
+    bool isLoading(uint64_t id) const;
+
+    void     select(uint64_t id);
+    uint64_t getSelected() const { return m_selected; }
+
+    size_t getVisibleCount() const { return m_visible.size(); }
+    // Nodes currently held (fetched and not released).
+    size_t getNodeCount()    const { return m_byId.size(); }
+
+    void update(Rectf& parentBounds, float dt) override;
+    bool checkHover(const Vec2f& mousePosition) override;
+
+private:
+    static constexpr uint32_t kNoNode = UINT32_MAX;
+
+    enum class Load : uint8_t { None, Pending, Done };
+
+    struct Node {
+        uint64_t              id       = 0;
+        std::string           label;
+        std::vector<uint32_t> children;
+        uint32_t              parent   = kNoNode;
+        uint32_t              depth    = 0;      // top-level nodes are 0
+        bool                  hasChildren = false;
+        bool                  expanded = false;
+        Load                  load     = Load::None;
+    };
+
+    struct RowSlot : ListRow {
+        Spacer* indent     = nullptr;
+        Text*   disclosure = nullptr;
+        Text*   label      = nullptr;
+    };
+
+    uint32_t find(uint64_t id) const;
+    uint32_t allocNode();
+    void     releaseChildren(uint32_t node);
+    // Where `node`'s descendants sit in m_visible: [first, end). False when
+    // the node itself isn't on screen (an ancestor is collapsed).
+    bool     childRange(uint32_t node, size_t& first, size_t& end) const;
+    void     appendVisible(uint32_t node, std::vector<uint32_t>& out) const;
+    void     insertRows(size_t at, const std::vector<uint32_t>& rows);
+    void     eraseRows(size_t first, size_t end);
+    void     expandNode(uint32_t node);
+    void     collapseNode(uint32_t node);
+    void     rowsChanged();
+
+    Element* createRow();
+    void     bindRow(size_t slot, size_t pos);
+    void     onRowClick(size_t slot);
+
+    TreeViewOptions m_treeOptions;
+    std::vector<Node>     m_nodes;          // [0] is the hidden root
+    std::vector<uint32_t> m_free;
+    std::unordered_map<uint64_t, uint32_t> m_byId;
+    std::vector<uint32_t> m_visible;        // pre-order rows on screen
+    std::vector<uint32_t> m_scratch;
+
+    uint64_t m_selected = kRoot;            // kRoot: none
+    ListRowHover m_hover;
+    bool     m_started  = false;
+    std::vector<RowSlot> m_rows;
+};
+
+}
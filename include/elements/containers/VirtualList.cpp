@@ -0,0 +1,346 @@
+#include "VirtualList.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../../UILO.hpp"
+#include "../../utils/Trace.hpp"
+#include "../../renderer/Shapes.hpp"
+
+namespace uilo {
+
+namespace {
+inline size_t lowBit(size_t i) { return i & (~i + 1); }
+}
+
+VirtualList::VirtualList(Modifier modifier, VirtualListOptions options, bool vertical,
+                         const std::string& name)
+    : Container(modifier, {}, name)
+    , m_options(std::move(options))
+    , m_vertical(vertical)
+{}
+
+VirtualColumn::VirtualColumn(Modifier modifier, VirtualListOptions options, const std::string& name)
+    : VirtualList(modifier, std::move(options), true, name)
+{
+    m_type = ElementType::VirtualColumn;
+}
+
+VirtualRow::VirtualRow(Modifier modifier, VirtualListOptions options, const std::string& name)
+    : VirtualList(modifier, std::move(options), false, name)
+{
+    m_type = ElementType::VirtualRow;
+}
+
+void VirtualList::setOptions(const VirtualListOptions& opts) {
+    m_options = opts;
+    m_extents.clear();      // the estimate may have changed; re-measure
+    m_extentTree.clear();
+    m_rebindAll = true;
+    markDirty();
+}
+
+void VirtualList::setItemCount(size_t n) {
+    m_options.setItemCount(n);
+    m_rebindAll = true;
+    markDirty();
+}
+
+void VirtualList::refreshItem(size_t index) {
+    m_refreshItems.push_back(index);
+    markDirty();
+}
+
+void VirtualList::scrollToItem(size_t index) {
+    const size_t count = m_options.getItemCount();
+    const float  scale = m_uiloRef ? m_uiloRef->getScale() : 1.f;
+    syncExtents();
+    setScrollOffset(itemOffset(std::min(index, count)) * scale);
+}
+
+void VirtualList::setScrollOffset(float offset) {
+    // Clamped against the content size during update().
+    m_scrollOffset = std::max(0.f, offset);
+    markDirty();
+}
+
+Element* VirtualList::getItemElement(size_t index) const {
+    for (size_t k = 0; k < m_children.size() && k < m_rowIndex.size(); ++k)
+        if (m_rowIndex[k] == index) return m_children[k];
+    return nullptr;
+}
+
+// ---- Item geometry ---------------------------------------------------------
+// Fixed mode is pure arithmetic. Estimated mode keeps one extent per item
+// and a Fenwick tree of them (1-based, m_extentTree[0] unused), so prefix
+// offsets and offset -> item lookups stay O(log n) for any item count.
+
+float VirtualList::itemOffset(size_t index) const {
+    if (m_extentTree.empty())
+        return static_cast<float>(index) * std::max(1.f, m_options.getItemExtent());
+    double sum = 0.0;
+    for (size_t i = std::min(index, m_extents.size()); i > 0; i -= lowBit(i))
+        sum += m_extentTree[i];
+    return static_cast<float>(sum);
+}
+
+float VirtualList::itemExtent(size_t index) const {
+    if (m_extentTree.empty()) return std::max(1.f, m_options.getItemExtent());
+    return m_extents[index];
+}
+
+size_t VirtualList::itemAt(float offset) const {
+    const size_t count = m_options.getItemCount();
+    if (count == 0 || offset <= 0.f) return 0;
+    if (m_extentTree.empty()) {
+        const size_t i = static_cast<size_t>(offset / std::max(1.f, m_options.getItemExtent()));
+        return std::min(i, count - 1);
+    }
+    // Largest prefix that still ends at or before `offset`.
+    size_t pos = 0;
+    double rem = offset;
+    size_t step = 1;
+    while (step * 2 <= count) step *= 2;
+    for (; step > 0; step >>= 1) {
+        if (pos + step <= count && m_extentTree[pos + step] <= rem) {
+            pos += step;
+            rem -= m_extentTree[pos];
+        }
+    }
+    return std::min(pos, count - 1);
+}
+
+void VirtualList::syncExtents() {
+    if (!m_options.getEstimatedExtent()) {
+        m_extents.clear();
+        m_extentTree.clear();
+        return;
+    }
+    const size_t count = m_options.getItemCount();
+    if (m_extents.size() == count && m_extentTree.size() == count + 1) return;
+    m_extents.resize(count, std::max(1.f, m_options.getItemExtent()));
+    m_extentTree.assign(count + 1, 0.0);
+    for (size_t i = 1; i <= count; ++i) {
+        m_extentTree[i] += m_extents[i - 1];
+        const size_t parent = i + lowBit(i);
+        if (parent <= count) m_extentTree[parent] += m_extentTree[i];
+    }
+}
+
+void VirtualList::setMeasuredExtent(size_t index, float px) {
+    if (m_extentTree.empty() || index >= m_extents.size()) return;
+    px = std::max(1.f, px);
+    const double delta = static_cast<double>(px) - m_extents[index];
+    if (delta == 0.0) return;
+    m_extents[index] = px;
+    for (size_t i = index + 1; i < m_extentTree.size(); i += lowBit(i))
+        m_extentTree[i] += delta;
+    // Keep what's on screen still when an item above the view is measured.
+    if (index < m_first) m_scrollOffset += static_cast<float>(delta) * m_lastScale;
+    m_dirty = true;
+}
+
+float VirtualList::maxScroll() const {
+    const size_t count = m_options.getItemCount();
+    if (count == 0) return 0.f;
+    const float scale    = m_uiloRef ? m_uiloRef->getScale() : 1.f;
+    const float viewport = m_vertical ? m_bounds.size.y : m_bounds.size.x;
+    return std::max(0.f, itemOffset(count) * scale - viewport);
+}
+
+// ---- Update ----------------------------------------------------------------
+
+void VirtualList::update(Rectf& parentBounds, float dt) {
+    UILO_TRACE_ZONE("VirtualList::update");
+    pruneChildren();
+    // Rows erased from outside: forget every binding and rebind.
+    if (m_rowIndex.size() != m_children.size())
+        m_rowIndex.assign(m_children.size(), kUnbound);
+    resize(parentBounds);
+
+    const float scale = m_uiloRef ? m_uiloRef->getScale() : 1.f;
+    if (scale != m_lastScale && m_lastScale > 0.f) {
+        m_scrollOffset *= scale / m_lastScale;
+        m_lastScale = scale;
+    }
+    syncExtents();
+
+    const size_t count = m_options.getItemCount();
+    const float  clamped = std::clamp(m_scrollOffset, 0.f, maxScroll());
+    if (clamped != m_scrollOffset) { m_scrollOffset = clamped; m_dirty = true; }
+
+    /*
+        Visible Range:
+        - [first, last) covers the viewport, widened by the overscan on
+          both sides so rows are already bound when they scroll in
+    */
+    size_t first = 0;
+    size_t last  = 0;
+    m_first = 0;
+    if (count > 0 && scale > 0.f) {
+        const float viewport = m_vertical ? m_bounds.size.y : m_bounds.size.x;
+        const float viewEnd  = (m_scrollOffset + viewport) / scale;
+        first = itemAt(m_scrollOffset / scale);
+        last  = first;
+        while (last < count && itemOffset(last) < viewEnd) ++last;
+        m_first = first;
+        const size_t over = m_options.getOverscan();
+        first = first > over ? first - over : 0;
+        last  = std::min(count, last + over);
+    }
+
+    /*
+        Recycling:
+        - Rows still bound to an item inside the range keep it
+        - Every other row is released and reused for items that just
+          came into range; new rows are only created when none are free
+    */
+    FrameArena* arena = getFrameArena();
+    FrameVector<size_t> rowForItem(last - first, kUnbound, arena);
+    FrameVector<size_t> freeRows(arena);
+    freeRows.reserve(m_children.size());
+    for (size_t k = 0; k < m_children.size(); ++k) {
+        const size_t idx = m_rowIndex[k];
+        if (idx != kUnbound && idx >= first && idx < last && rowForItem[idx - first] == kUnbound) {
+            rowForItem[idx - first] = k;
+        } else {
+            m_rowIndex[k] = kUnbound;
+            freeRows.push_back(k);
+        }
+    }
+
+    const auto& create = m_options.getCreateItem();
+    const auto& bind   = m_options.getBindItem();
+    for (size_t i = first; i < last; ++i) {
+        size_t k = rowForItem[i - first];
+        bool needsBind = m_rebindAll ||
+            std::find(m_refreshItems.begin(), m_refreshItems.end(), i) != m_refreshItems.end();
+        if (k == kUnbound) {
+            if (!freeRows.empty()) {
+                k = freeRows.back();
+                freeRows.pop_back();
+            } else {
+                Element* e = create ? create() : nullptr;
+                if (!e) break;
+                addElement(e);
+                m_rowIndex.push_back(kUnbound);
+                k = m_children.size() - 1;
+            }
+            m_rowIndex[k] = i;
+            needsBind = true;
+        }
+        if (!needsBind) continue;
+
+        Element* row = m_children[k];
+        if (bind) bind(row, i);
+        m_dirty = true;
+        if (m_options.getEstimatedExtent()) {
+            const Dimension d = m_vertical ? row->getModifier().getHeight()
+                                           : row->getModifier().getWidth();
+            if (!d.percent)
+                setMeasuredExtent(i, d.value + 2.f * row->getModifier().getOuterPadding());
+        }
+    }
+    m_rebindAll = false;
+    m_refreshItems.clear();
+
+    // Lay out bound rows; released ones collapse to an empty rect so they
+    // can't be hit-tested until they're reused.
+    const float mainStart = (m_vertical ? m_bounds.position.y : m_bounds.position.x) - m_scrollOffset;
+    for (size_t k = 0; k < m_children.size(); ++k) {
+        Element* child = m_children[k];
+        const size_t idx = m_rowIndex[k];
+        if (idx == kUnbound) {
+            parkChild(child, Rectf{m_bounds.position, {0.f, 0.f}});
+            continue;
+        }
+        const float start = mainStart + itemOffset(idx) * scale;
+        const float ext   = itemExtent(idx) * scale;
+        Rectf slot = m_vertical
+            ? Rectf{{m_bounds.position.x, start}, {m_bounds.size.x, ext}}
+            : Rectf{{start, m_bounds.position.y}, {ext, m_bounds.size.y}};
+        tickMovedChild(child, slot, dt);
+    }
+    flushChildTicks(dt);
+}
+
+// ---- Render ----------------------------------------------------------------
+
+void VirtualList::render() {
+    if (!m_modifier.getVisible()) return;
+    if (m_bounds.size.x <= 0.f || m_bounds.size.y <= 0.f) return;
+    if (!m_uiloRef) return;
+
+    auto& r = m_uiloRef->getRenderer();
+    const float rounding = m_options.getRounding() * m_uiloRef->getScale();
+    const Color bg = m_uiloRef->getPalette().resolve(
+        m_options.getColorRole(), m_options.getColor());
+    if (bg.a > 0) {
+        if (rounding <= 0.f)
+            r.draw(Rect{m_bounds.position, m_bounds.size, bg});
+        else
+            r.draw(RoundedRect{m_bounds.position, m_bounds.size, rounding, 8u, bg});
+    }
+
+    r.pushRoundClip(m_bounds, rounding);
+    for (size_t k = 0; k < m_children.size(); ++k) {
+        Element* child = m_children[k];
+        if (m_rowIndex[k] == kUnbound) continue;
+        if (cullChild(child, m_bounds)) continue;
+        child->paint();
+    }
+    r.popRoundClip();
+
+    m_dirty = false;
+}
+
+// ---- Scrolling -------------------------------------------------------------
+
+bool VirtualList::scrollBy(float delta, bool precise) {
+    const float limit = maxScroll();
+    if (limit <= 0.f) return false;
+    // Same feel as Column / Row: trackpad pixel-precise, wheel stepped.
+    const float speed = m_options.getScrollSpeed();
+    const float step  = precise ? 30.f * (speed / 40.f) : speed;
+    m_scrollOffset = std::clamp(m_scrollOffset - delta * step, 0.f, limit);
+    markDirty();
+    return true;
+}
+
+bool VirtualList::checkScroll(const Vec2f& mousePosition, float delta, bool precise, bool momentum) {
+    if (!m_bounds.contains(mousePosition)) return false;
+
+    for (auto* child : m_children)
+        if (child->getBounds().contains(mousePosition))
+            if (child->checkScroll(mousePosition, delta, precise, momentum)) return true;
+
+    if (delta != 0.f && scrollBy(delta, precise)) return true;
+
+    if (m_modifier.getOnScroll()) {
+        m_modifier.getOnScroll()(this, delta);
+        return true;
+    }
+    return false;
+}
+
+bool VirtualList::checkScroll(const Vec2f& mousePosition, Vec2f delta, bool precise, bool momentum) {
+    if (!m_bounds.contains(mousePosition)) return false;
+
+    // Like Column / Row: children see the full 2D delta, but consuming it
+    // doesn't stop this list from scrolling along its own axis.
+    bool consumed = false;
+    for (auto* child : m_children)
+        if (child->getBounds().contains(mousePosition))
+            if (child->checkScroll(mousePosition, delta, precise, momentum)) { consumed = true; break; }
+
+    const float mainDelta = m_vertical ? delta.y : delta.x;
+    if (mainDelta != 0.f && scrollBy(mainDelta, precise)) consumed = true;
+
+    if (!consumed && m_modifier.getOnScroll()) {
+        m_modifier.getOnScroll()(this, delta.y);
+        return true;
+    }
+    return consumed;
+}
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Container.hpp"
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace uilo {
+
+class VirtualListOptions {
+public:
+    VirtualListOptions() = default;
+
+    // Number of items in the list. Items are only materialized while they
+    // are (nearly) in view, so this can be large.
+    VirtualListOptions& setItemCount(size_t n)        { m_itemCount = n; return *this; }
+    // Main-axis size of one item in px (scaled like other px dimensions).
+    VirtualListOptions& setItemExtent(float px)       { m_itemExtent = px; return *this; }
+    // Treat the item extent as an estimate: after an item is bound, its
+    // element's own px height (VirtualColumn) / width (VirtualRow) from the
+    // Modifier replaces the estimate. Percent sizes keep the estimate.
+    VirtualListOptions& setEstimatedExtent(bool v)    { m_estimated = v; return *this; }
+    // Extra items materialized before / after the viewport.
+    VirtualListOptions& setOverscan(unsigned int n)   { m_overscan = n; return *this; }
+    VirtualListOptions& setScrollSpeed(float s)       { m_scrollSpeed = s; return *this; }
+    VirtualListOptions& setColor(const Color& c)      { m_color = c; return *this; }
+    VirtualListOptions& setColorRole(const std::string& r) { m_colorRole = r; return *this; }
+    VirtualListOptions& setRounding(float r)          { m_rounding = r; return *this; }
+
+    // createItem builds one recyclable row element (called only while the
+    // pool is smaller than what the viewport needs). bindItem fills a row
+    // element with the data for `index`; it runs whenever an element is
+    // (re)assigned to an item and after refresh().
+    VirtualListOptions& setCreateItem(std::function<Element*()> fn)             { m_create = std::move(fn); return *this; }
+    VirtualListOptions& setBindItem(std::function<void(Element*, size_t)> fn)   { m_bind   = std::move(fn); return *this; }
+
+    size_t       getItemCount()       const { return m_itemCount; }
+    float        getItemExtent()      const { return m_itemExtent; }
+    bool         getEstimatedExtent() const { return m_estimated; }
+    unsigned int getOverscan()        const { return m_overscan; }
+    float        getScrollSpeed()     const { return m_scrollSpeed; }
+    Color        getColor()           const { return m_color; }
+    const Role&        getColorRole() const { return m_colorRole; }
+    float        getRounding()        const { return m_rounding; }
+    const std::function<Element*()>&           getCreateItem() const { return m_create; }
+    const std::function<void(Element*, size_t)>& getBindItem() const { return m_bind; }
+
+private:
+    size_t       m_itemCount   = 0;
+    float        m_itemExtent  = 24.f;
+    bool         m_estimated   = false;
+    unsigned int m_overscan    = 2;
+    float        m_scrollSpeed = 40.f;
+    Color        m_color       = Color{0, 0, 0, 0};
+    Role         m_colorRole;
+    float        m_rounding    = 0.f;
+    std::function<Element*()>           m_create;
+    std::function<void(Element*, size_t)> m_bind;
+};
+
+// VirtualList: a scrollable list that only keeps enough row elements to
+// fill its viewport (plus overscan) and rebinds them as items scroll in
+// and out, so element count and layout time don't grow with the item
+// count. Use VirtualColumn / VirtualRow for the vertical / horizontal
+// variants. Row elements come from createItem and are owned by UILO like
+// any other element; give them 100% cross-axis size to fill the list.
+class VirtualList : public Container {
+public:
+    VirtualList(Modifier modifier, VirtualListOptions options, bool vertical,
+                const std::string& name = "");
+
+    const VirtualListOptions& getOptions() const { return m_options; }
+    VirtualListOptions&       getOptions()       { return m_options; }
+    void setOptions(const VirtualListOptions& opts);
+
+    void   setItemCount(size_t n);
+    size_t getItemCount() const { return m_options.getItemCount(); }
+    // Rebind every materialized row (the data behind them changed).
+    void   refresh()                { m_rebindAll = true; markDirty(); }
+    void   refreshItem(size_t index);
+    // Scroll so `index` is the first item in view.
+    void   scrollToItem(size_t index);
+    void   setScrollOffset(float offset);
+    float  getScrollOffset() const  { return m_scrollOffset; }
+    size_t getFirstVisibleItem() const { return m_first; }
+    // Element currently bound to `index`, or nullptr when it isn't
+    // materialized.
+    Element* getItemElement(size_t index) const;
+
+    void update(Rectf& parentBounds, float dt) override;
+    void render() override;
+    bool checkScroll(const Vec2f& mousePosition, float delta, bool precise = false, bool momentum = false) override;
+    bool checkScroll(const Vec2f& mousePosition, Vec2f delta, bool precise = false, bool momentum = false) override;
+
+private:
+    static constexpr size_t kUnbound = static_cast<size_t>(-1);
+
+    float  itemOffset(size_t index) const;   // unscaled px from list start
+    float  itemExtent(size_t index) const;   // unscaled px
+    size_t itemAt(float offset) const;       // item containing unscaled offset
+    void   syncExtents();
+    void   setMeasuredExtent(size_t index, float px);
+    float  maxScroll() const;
+    bool   scrollBy(float delta, bool precise);
+
+    VirtualListOptions  m_options;
+    bool                m_vertical     = true;
+    float               m_scrollOffset = 0.f;   // window px
+    float               m_lastScale    = 1.f;
+    size_t              m_first        = 0;     // first item in view
+    bool                m_rebindAll    = false;
+    std::vector<size_t> m_rowIndex;             // item bound to m_children[k]
+    std::vector<size_t> m_refreshItems;
+    // Estimated-extent mode: per-item extents and a Fenwick tree over them
+    // for O(log n) offset <-> index lookups.
+    std::vector<float>  m_extents;
+    std::vector<double> m_extentTree;
+};
+
+class VirtualColumn : public VirtualList {
+public:
+    explicit VirtualColumn(Modifier modifier, VirtualListOptions options, const std::string& name = "");
+};
+
+class VirtualRow : public VirtualList {
+public:
+    explicit VirtualRow(Modifier modifier, VirtualListOptions options, const std::string& name = "");
+};
+
+}
@@ -16,9 +16,17 @@ Image::Image(
 
 void Image::init() {
     if (m_loaded || !m_uiloRef || m_options.getPath().empty()) return;
-    Texture tex = m_uiloRef->getRenderer().loadTexture(m_options.getPath());
+    Renderer& renderer = m_uiloRef->getRenderer();
+    const TextureLoadOptions& topts = m_options.getTextureOptions();
+    Texture tex = m_options.getAsync() ? renderer.loadTextureAsync(m_options.getPath(), topts)
+                                       : renderer.loadTexture(m_options.getPath(), topts);
     if (tex.valid()) {
+        // Pin it: under a texture budget unretained entries can be evicted.
+        renderer.retainTexture(m_options.getPath(), topts);
+        m_retainedPath    = m_options.getPath();
+        m_retainedOptions = topts;
         m_textureHandle = tex.handle;
+        m_textureUv     = tex.uv;
         m_textureWidth  = tex.width;
         m_textureHeight = tex.height;
         m_loaded = true;
@@ -32,11 +40,17 @@ void Image::init() {
             else if (m_options.getLockAspectHeight() && !h.percent)
                 m_modifier.setWidth(Dimension{ h.value * aspect, false });
         }
+        // An async load lands frames after the placeholder was laid out.
+        if (m_options.getAsync()) {
+            invalidateLayout();
+            markDirty();
+        }
     }
 }
 
 void Image::rebuildTexture() {
     releaseOwnedTexture();
+    releaseCachedTexture();
     m_pixels.clear();
     m_pixelsWidth  = 0;
     m_pixelsHeight = 0;
@@ -50,6 +64,23 @@ bool Image::isLoaded() const { return m_loaded; }
 
 Image::~Image() {
     releaseOwnedTexture();
+    releaseCachedTexture();
+}
+
+void Image::releaseResources() {
+    if (m_ownsTexture || m_pixelsDirty) return;
+    releaseCachedTexture();
+    m_textureHandle = 0xFFFFu;
+    m_loaded        = false;
+    m_pixels        = {};
+    m_pixelsWidth   = 0;
+    m_pixelsHeight  = 0;
+}
+
+void Image::releaseCachedTexture() {
+    if (m_retainedPath.empty()) return;
+    if (m_uiloRef) m_uiloRef->getRenderer().releaseTexture(m_retainedPath, m_retainedOptions);
+    m_retainedPath.clear();
 }
 
 void Image::releaseOwnedTexture() {
@@ -99,10 +130,12 @@ void Image::syncPixels() {
             (uint16_t)m_pixelsWidth, (uint16_t)m_pixelsHeight);
         if (!own.valid()) return;
         m_textureHandle = own.handle;
+        m_textureUv     = own.uv;
         m_textureWidth  = m_pixelsWidth;
         m_textureHeight = m_pixelsHeight;
         m_ownsTexture   = true;
         m_loaded        = true;
+        releaseCachedTexture();
     }
     Texture tex;
     tex.handle = m_textureHandle;
@@ -132,11 +165,18 @@ void Image::render() {
     m_dirty = false;
     syncPixels();   // before the m_loaded check: a setPixel made before the
                     // first frame creates the texture rather than needing one
-    if (!m_loaded || !m_uiloRef) return;
+    if (!m_uiloRef) return;
+    if (!m_loaded) {
+        const Color ph = m_options.getPlaceholderColor();
+        if (m_options.getAsync() && !m_options.getPath().empty() && ph.a > 0)
+            m_uiloRef->getRenderer().draw(Rect{m_bounds.position, m_bounds.size, ph});
+        return;
+    }
     Texture tex;
     tex.handle = m_textureHandle;
     tex.width  = (uint16_t)m_textureWidth;
     tex.height = (uint16_t)m_textureHeight;
+    tex.uv     = m_textureUv;
     const Color literal = m_options.getRecolor() ? m_options.getColor() : Color::White;
     const Color tint = m_options.getRecolor()
         ? m_uiloRef->getPalette().resolve(m_options.getColorRole(), literal)
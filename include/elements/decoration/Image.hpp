@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "../Element.hpp"
+#include "../../renderer/Renderer.hpp"
 
 namespace uilo {
 
@@ -22,27 +23,46 @@ public:
     ImageOptions& setClipEllipse(bool v)            { m_clipEllipse      = v;   return *this; }
     ImageOptions& setFlipH(bool v)                  { m_flipH            = v;   return *this; }
     ImageOptions& setFlipV(bool v)                  { m_flipV            = v;   return *this; }
+    // Decode the file off the render thread (Renderer::loadTextureAsync),
+    // showing the placeholder color until it is on the GPU, or for good if
+    // it fails to load.
+    ImageOptions& setAsync(bool v)                  { m_async            = v;   return *this; }
+    ImageOptions& setPlaceholderColor(const Color& c) { m_placeholderColor = c; return *this; }
+    // Store the texture box-filtered down to fit maxWidth x maxHeight
+    // (0 = unconstrained) instead of at file resolution, e.g. the largest
+    // size a thumbnail is shown at. Pixel access still sees the full file.
+    ImageOptions& setTextureSize(uint16_t maxWidth, uint16_t maxHeight) {
+        m_textureOptions.maxWidth = maxWidth; m_textureOptions.maxHeight = maxHeight; return *this;
+    }
+    // Full mip chain, for images drawn well below their texture size.
+    ImageOptions& setMipmaps(bool v)                { m_textureOptions.mipmaps = v; return *this; }
 
     const std::string& getPath()             const { return m_path; }
     Color              getColor()            const { return m_color; }
-    const std::string& getColorRole()        const { return m_colorRole; }
+    const Role&        getColorRole()        const { return m_colorRole; }
     bool                            getLockAspectWidth()  const { return m_lockAspectWidth; }
     bool                            getLockAspectHeight() const { return m_lockAspectHeight; }
     bool                            getRecolor()          const { return m_recolor; }
     bool                            getClipEllipse()      const { return m_clipEllipse; }
     bool                            getFlipH()            const { return m_flipH; }
     bool                            getFlipV()            const { return m_flipV; }
+    bool                            getAsync()            const { return m_async; }
+    Color                           getPlaceholderColor() const { return m_placeholderColor; }
+    const TextureLoadOptions&       getTextureOptions()   const { return m_textureOptions; }
 
 private:
     std::string m_path;
     Color       m_color           = Color::White;
-    std::string m_colorRole;
+    Role        m_colorRole;
     bool m_lockAspectWidth  = false;
     bool m_lockAspectHeight = false;
     bool m_recolor          = false;
     bool m_clipEllipse      = false;
     bool m_flipH            = false;
     bool m_flipV            = false;
+    bool m_async            = false;
+    Color m_placeholderColor = Color{128, 128, 128, 48};
+    TextureLoadOptions m_textureOptions;
 };
 
 class Image : public Element {
@@ -54,7 +74,7 @@ public:
 
     const ImageOptions& getOptions() const     { return m_options; }
     ImageOptions&       getOptions()           { return m_options; }
-    void setOptions(const ImageOptions& opts)  { m_options = opts; rebuildTexture(); }
+    void setOptions(const ImageOptions& opts)  { m_options = opts; rebuildTexture(); markDirty(); }
 
     bool isLoaded() const;
 
@@ -75,15 +95,25 @@ public:
 
     ~Image() override;
 
+    // Unpins a cached texture (the renderer's budget may then evict it)
+    // and frees the CPU pixel copy; the next update() reloads. An Image
+    // with pixel edits keeps its private texture.
+    void releaseResources() override;
+
 private:
+    // Keeps retrying until the texture is available.
+    bool wantsUpdate() const override { return !m_loaded; }
+    bool parallelSafe() const override { return m_loaded; }
     void rebuildTexture();
     void init();
     bool ensurePixels() const;      // lazy CPU-side decode of the source file
     void syncPixels();              // upload pending writes (copy-on-write)
     void releaseOwnedTexture();
+    void releaseCachedTexture();    // drop our retainTexture on the cache
 
     ImageOptions  m_options;
     uint16_t      m_textureHandle = 0xFFFFu;
+    Rectf         m_textureUv     = {{0.f, 0.f}, {1.f, 1.f}};   // region within an atlas page
     uint32_t      m_textureWidth  = 0;
     uint32_t      m_textureHeight = 0;
     Color         m_lastRecolor   = Color::White;
@@ -96,6 +126,8 @@ private:
     mutable uint32_t m_pixelsHeight = 0;
     bool m_pixelsDirty = false;     // CPU buffer has writes not yet uploaded
     bool m_ownsTexture = false;     // m_textureHandle is private, not cached
+    std::string m_retainedPath;     // path + options we hold a cache reference on
+    TextureLoadOptions m_retainedOptions;
 };
 
 }
\ No newline at end of file
@@ -13,12 +13,12 @@ public:
     SpacerOptions& setRounding(float r)          { m_rounding = r; return *this; }
 
     Color getColor()    const { return m_color; }
-    const std::string& getColorRole() const { return m_colorRole; }
+    const Role&        getColorRole() const { return m_colorRole; }
     float     getRounding() const { return m_rounding; }
 
 private:
     Color m_color    = Color{0,0,0,0};
-    std::string m_colorRole;
+    Role        m_colorRole;
     float     m_rounding = 0.f;
 };
 
@@ -28,12 +28,13 @@ public:
 
     const SpacerOptions& getOptions() const        { return m_options; }
     SpacerOptions&       getOptions()              { return m_options; }
-    void setOptions(const SpacerOptions& opts)      { m_options = opts; }
+    void setOptions(const SpacerOptions& opts)      { m_options = opts; markDirty(); }
 
     void update(Rectf& parentBounds, float dt) override;
     void render() override;
 
 private:
+    bool parallelSafe() const override { return true; }
     SpacerOptions m_options;
 };
 
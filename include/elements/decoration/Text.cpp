@@ -1,9 +1,10 @@
 #include "Text.hpp"
 #include "../../UILO.hpp"
+#include "../../Binding.hpp"
 #include "../../utils/Alignment.hpp"
 #include "../../renderer/Renderer.hpp"
-
-#include <sstream>
+#include "../../utils/TextWrap.hpp"
+#include "../../utils/Utf8.hpp"
 
 namespace uilo {
 
@@ -21,7 +22,7 @@ Text::Text(
 void Text::init() {
     if (m_loaded || !m_uiloRef) return;
 
-    Font f = m_uiloRef->getRenderer().loadFont(m_options.getFontPath());
+    Font f = m_uiloRef->getRenderer().loadFont(m_options.getFontPath(), m_options.getSdf());
     if (f.valid()) {
         m_fontId = f.id;
         m_loaded = true;
@@ -29,34 +30,36 @@ void Text::init() {
     }
 }
 
-std::string Text::wrapContent(float maxWidth) const {
+std::string Text::wrapContent(float maxWidth) {
     if (!m_uiloRef || !m_loaded || maxWidth <= 0.f) return m_content;
-    auto& renderer = m_uiloRef->getRenderer();
-    Font f; f.id = m_fontId;
-    const float scale = m_uiloRef->getScale();
-    const float pxH   = (float)m_charSize * scale;
-
-    std::string result;
-    result.reserve(m_content.size() + 16);
-
-    std::stringstream ss(m_content);
-    std::string word;
-    std::string line;
-    while (std::getline(ss, word, ' ')) {
-        std::string candidate = line.empty() ? word : (line + " " + word);
-        TextMetrics m = renderer.measureText(candidate, f, pxH);
-        if (m.size.x > maxWidth && !line.empty()) {
-            result += line; result += '\n';
-            line = word;
-        } else {
-            line = candidate;
+    if (!m_advancesValid) {
+        Font f; f.id = m_fontId;
+        const float pxH = (float)m_charSize * m_uiloRef->getScale();
+        m_contentU32 = utf8ToU32(m_content);
+        m_advances.resize(m_contentU32.size());
+        m_uiloRef->getRenderer().glyphAdvances(m_contentU32, f, pxH, m_advances.data());
+        m_advancesValid = true;
+    }
+    wrapText(m_contentU32, m_advances.data(), maxWidth, false, m_breaks);
+    if (m_breaks.empty()) return m_content;
+
+    // Spaces hanging at a break are dropped so alignment sees the words.
+    std::u32string out;
+    out.reserve(m_contentU32.size() + m_breaks.size());
+    size_t b = 0;
+    for (size_t i = 0; i < m_contentU32.size(); ++i) {
+        if (b < m_breaks.size() && m_breaks[b] == i) {
+            while (!out.empty() && out.back() == U' ') out.pop_back();
+            out += U'\n';
+            ++b;
         }
+        out += m_contentU32[i];
     }
-    result += line;
-    return result;
+    return u32ToUtf8(out);
 }
 
 void Text::rebuildText() {
+    m_advancesValid = false;
     if (m_options.getWrap() && m_lastWrapWidth > 0.f) {
         m_wrappedContent = wrapContent(m_lastWrapWidth);
     } else {
@@ -65,17 +68,32 @@ void Text::rebuildText() {
     m_cachedMetricsValid = false;
 }
 
+void Text::rewrapForWidth() {
+    if (!m_options.getWrap() || m_lastWrapWidth <= 0.f) return;
+    std::string wrapped = wrapContent(m_lastWrapWidth);
+    // Live resize mostly moves no break; keep the measured run then.
+    if (wrapped == m_wrappedContent) return;
+    m_wrappedContent     = std::move(wrapped);
+    m_cachedMetricsValid = false;
+}
+
 bool Text::isLoaded() const { return m_loaded; }
 
 void Text::setString(const std::string& content) {
     if (content == m_content) return;
     m_content = content;
     m_wrappedContent = content;
-    m_dirty = true;
+    markDirty();
     m_cachedMetricsValid = false;
     if (m_loaded) rebuildText();
 }
 
+bool Text::bindContent(Binding<std::string>& content) {
+    return content.bind(this, [](Element* e, const std::string& s) {
+        static_cast<Text*>(e)->setString(s);
+    });
+}
+
 void Text::update(Rectf& parentBounds, float dt) {
     (void)dt;
     if (!m_loaded) init();
@@ -85,6 +103,7 @@ void Text::update(Rectf& parentBounds, float dt) {
 
     float scale = m_uiloRef ? m_uiloRef->getScale() : 1.f;
     bool needRebuild = false;
+    bool needRewrap  = false;
 
     if (!m_options.hasCharSize()) {
         const unsigned int autoCs = std::max(1u,
@@ -96,13 +115,14 @@ void Text::update(Rectf& parentBounds, float dt) {
     }
     if (m_options.getWrap() && m_bounds.size.x != m_lastWrapWidth) {
         m_lastWrapWidth = m_bounds.size.x;
-        needRebuild = true;
+        needRewrap = true;
     }
     if (scale != m_lastScale) {
         m_lastScale = scale;
         needRebuild = true;
     }
-    if (needRebuild) rebuildText();
+    if (needRebuild)     rebuildText();
+    else if (needRewrap) rewrapForWidth();
 }
 
 void Text::render() {
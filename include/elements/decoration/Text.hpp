@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "../Element.hpp"
 #include "../../renderer/Renderer.hpp"
@@ -13,6 +14,9 @@ public:
     TextOptions() = default;
 
     TextOptions& setFont(const std::string& path) { m_fontPath = path; return *this; }
+    // Render with signed-distance glyphs: one atlas entry per glyph serves
+    // every size and zoom level. Best for text that animates or zooms.
+    TextOptions& setSdf(bool v)                    { m_sdf = v;              return *this; }
     TextOptions& setContent(const std::string& s) { m_content = s;          return *this; }
     TextOptions& setCharSize(unsigned int n)       { m_charSize = n;         return *this; }
     TextOptions& setColor(const Color& c)      { m_color = c;            return *this; }
@@ -26,11 +30,12 @@ public:
     TextOptions& setTextAlignY(Align a)            { m_textAlignY = a;       return *this; }
 
     const std::string& getFontPath()       const { return m_fontPath; }
+    bool               getSdf()            const { return m_sdf; }
     const std::string& getContent()        const { return m_content; }
     unsigned int       getCharSize()       const { return m_charSize.value_or(30); }
     bool               hasCharSize()       const { return m_charSize.has_value(); }
     Color          getColor()          const { return m_color; }
-    const std::string& getColorRole()  const { return m_colorRole; }
+    const Role&        getColorRole()  const { return m_colorRole; }
     bool               getWrap()           const { return m_wrap; }
     bool               getBold()           const { return m_bold; }
     bool               getItalic()         const { return m_italic; }
@@ -41,10 +46,11 @@ public:
 
 private:
     std::string     m_fontPath;
+    bool            m_sdf           = false;
     std::string     m_content;
     std::optional<unsigned int> m_charSize;
     Color       m_color         = Color::White;
-    std::string m_colorRole;
+    Role        m_colorRole;
     bool            m_wrap          = false;
     bool            m_bold          = false;
     bool            m_italic        = false;
@@ -62,22 +68,42 @@ public:
     void render() override;
 
     void setString(const std::string& content);
+    // Follows `content` from now on (see Binding.hpp); false if this Text
+    // isn't attached to a UILO yet.
+    bool bindContent(Binding<std::string>& content);
 
     const TextOptions& getOptions() const      { return m_options; }
     TextOptions&       getOptions()            { return m_options; }
-    void setOptions(const TextOptions& opts)   { m_options = opts; rebuildText(); }
+    void setOptions(const TextOptions& opts)   {
+        m_options = opts;
+        if (opts.hasCharSize()) m_charSize = opts.getCharSize();
+        rebuildText();
+        markDirty();
+    }
 
     bool isLoaded() const;
 
 private:
-    std::string wrapContent(float maxWidth) const;
+    // Keeps retrying until the font is available.
+    bool wantsUpdate() const override { return !m_loaded; }
+    // Wrapping reads glyph advances through the renderer.
+    bool parallelSafe() const override { return m_loaded && !m_options.getWrap(); }
+    std::string wrapContent(float maxWidth);
+    // rebuildText() after content / size / scale changes; a wrap width
+    // change alone only re-runs the break pass over cached advances.
     void rebuildText();
+    void rewrapForWidth();
     void init();
 
     TextOptions             m_options;
     uint32_t                m_fontId        = 0xFFFFFFFFu;
     std::string             m_content;
     std::string             m_wrappedContent;
+    // Codepoints + advances of m_content at the current size, for wrapping.
+    std::u32string          m_contentU32;
+    std::vector<float>      m_advances;
+    std::vector<size_t>     m_breaks;
+    bool                    m_advancesValid = false;
     unsigned int            m_charSize      = 30;
     // float                   m_lastBoundsH   = 0.f;
     Color                   m_lastColor     = Color::White;
@@ -0,0 +1,288 @@
+#include "TiledImage.hpp"
+#include "../../UILO.hpp"
+#include "../../renderer/Shapes.hpp"
+#include "../../utils/ImageResample.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace uilo {
+
+namespace {
+
+// Overlap of two rects; zero-sized (at a's corner) when they don't meet.
+Rectf intersectRect(const Rectf& a, const Rectf& b) {
+    const float x0 = std::max(a.left(), b.left()), y0 = std::max(a.top(), b.top());
+    const float x1 = std::min(a.right(), b.right()), y1 = std::min(a.bottom(), b.bottom());
+    if (x1 <= x0 || y1 <= y0) return {a.position, {0.f, 0.f}};
+    return {{x0, y0}, {x1 - x0, y1 - y0}};
+}
+
+} // namespace
+
+struct TiledImage::DecodeJob {
+    std::thread        thread;
+    std::atomic<bool>  cancel{false};
+    std::atomic<bool>  done{false};
+    std::vector<Level> levels;
+};
+
+TiledImage::TiledImage(Modifier modifier, TiledImageOptions options,
+                       const std::string& name)
+    : m_options(options)
+{
+    m_modifier = modifier;
+    m_name     = name;
+    m_type     = ElementType::TiledImage;
+}
+
+TiledImage::~TiledImage() {
+    cancelDecode();
+    releaseTiles();
+}
+
+void TiledImage::setOptions(const TiledImageOptions& opts) {
+    const bool reload = opts.getPath() != m_options.getPath() ||
+                        opts.getTileSize() != m_options.getTileSize();
+    m_options = opts;
+    if (reload) {
+        cancelDecode();
+        releaseTiles();
+        m_levels.clear();
+        m_decodeStarted = false;
+        invalidateLayout();
+    }
+    markDirty();
+}
+
+uint32_t TiledImage::tileSize() const {
+    return std::clamp<uint32_t>(m_options.getTileSize(), 64, 2048);
+}
+
+// Worker side. stb_image has no region decode, so the file is decoded
+// whole once; every level after that is a 2x box of the one before, down
+// to the first that fits in one tile.
+bool TiledImage::buildLevels(const std::string& path, uint32_t tile,
+                             std::vector<Level>& levels, const std::atomic<bool>* cancel) {
+    Level base;
+    if (!Renderer::loadImagePixels(path, base.rgba, base.width, base.height)) return false;
+    levels.push_back(std::move(base));
+    while (levels.back().width > tile || levels.back().height > tile) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+        const Level& prev = levels.back();
+        Level next;
+        next.width  = std::max<uint32_t>(1, prev.width / 2);
+        next.height = std::max<uint32_t>(1, prev.height / 2);
+        next.rgba.resize((size_t)next.width * next.height * 4);
+        boxDownsampleRgba(prev.rgba.data(), (int)prev.width, (int)prev.height,
+                          next.rgba.data(), (int)next.width, (int)next.height);
+        levels.push_back(std::move(next));
+    }
+    return true;
+}
+
+void TiledImage::startDecode() {
+    m_decodeStarted = true;
+    if (m_options.getPath().empty()) return;
+    m_job = std::make_unique<DecodeJob>();
+    DecodeJob* job = m_job.get();
+    job->thread = std::thread([job, path = m_options.getPath(), tile = tileSize()] {
+        if (!buildLevels(path, tile, job->levels, &job->cancel)) job->levels.clear();
+        job->done.store(true, std::memory_order_release);
+    });
+}
+
+void TiledImage::cancelDecode() {
+    if (!m_job) return;
+    m_job->cancel.store(true, std::memory_order_relaxed);
+    m_job->thread.join();
+    m_job.reset();
+}
+
+void TiledImage::pollDecode() {
+    if (!m_job->done.load(std::memory_order_acquire)) return;
+    m_job->thread.join();
+    m_levels.swap(m_job->levels);
+    m_job.reset();
+    m_dirty = true;
+}
+
+void TiledImage::releaseTiles() {
+    if (m_uiloRef) {
+        Renderer& renderer = m_uiloRef->getRenderer();
+        for (auto& kv : m_tiles) renderer.destroyTexture(kv.second.tex);
+    }
+    m_tiles.clear();
+}
+
+void TiledImage::update(Rectf& parentBounds, float dt) {
+    (void)dt;
+    if (!m_decodeStarted) startDecode();
+    if (m_job) pollDecode();
+    resize(parentBounds);
+}
+
+const TiledImage::Tile* TiledImage::tile(Renderer& renderer, int level,
+                                         uint32_t tx, uint32_t ty, bool force) {
+    const uint64_t key = tileKey(level, tx, ty);
+    auto it = m_tiles.find(key);
+    if (it != m_tiles.end()) {
+        it->second.lastUsed = m_frame;
+        return &it->second;
+    }
+    if (!force && m_uploadsLeft == 0) return nullptr;
+
+    // Copy the tile out with a one-texel border taken from its neighbours
+    // (clamped at the image edge), so linear filtering is seamless across
+    // tiles.
+    const Level&   L  = m_levels[(size_t)level];
+    const uint32_t T  = tileSize();
+    const uint32_t x0 = tx * T, y0 = ty * T;
+    const uint32_t tw = std::min(T, L.width - x0), th = std::min(T, L.height - y0);
+    const uint32_t bw = tw + 2, bh = th + 2;
+    Texture tex = renderer.createTexture((uint16_t)bw, (uint16_t)bh);
+    if (!tex.valid()) return nullptr;
+
+    std::vector<uint8_t> texels((size_t)bw * bh * 4);
+    for (uint32_t row = 0; row < bh; ++row) {
+        const uint32_t sy = (uint32_t)std::clamp((int64_t)y0 + row - 1, (int64_t)0, (int64_t)L.height - 1);
+        const uint8_t* src = L.rgba.data() + (size_t)sy * L.width * 4;
+        uint8_t*       dst = texels.data() + (size_t)row * bw * 4;
+        const uint32_t left  = x0 > 0 ? x0 - 1 : 0;
+        const uint32_t right = std::min(x0 + tw, L.width - 1);
+        std::memcpy(dst, src + (size_t)left * 4, 4);
+        std::memcpy(dst + 4, src + (size_t)x0 * 4, (size_t)tw * 4);
+        std::memcpy(dst + (size_t)(tw + 1) * 4, src + (size_t)right * 4, 4);
+    }
+    renderer.updateTexture(tex, texels.data());
+    tex.uv = {{1.f / (float)bw, 1.f / (float)bh},
+              {(float)tw / (float)bw, (float)th / (float)bh}};
+    if (!force) --m_uploadsLeft;
+
+    Tile& t = m_tiles[key];
+    t.tex      = tex;
+    t.lastUsed = m_frame;
+    return &t;
+}
+
+bool TiledImage::drawLevel(Renderer& renderer, int level, const Rectf& visible,
+                           const Rectf& src, bool force) {
+    const Level&   L  = m_levels[(size_t)level];
+    const uint32_t T  = tileSize();
+    // Level texels per full-resolution pixel.
+    const float fx = (float)L.width  / (float)m_levels[0].width;
+    const float fy = (float)L.height / (float)m_levels[0].height;
+    const float toScreenX = m_bounds.size.x / src.size.x;
+    const float toScreenY = m_bounds.size.y / src.size.y;
+
+    const uint32_t tilesX = (L.width  + T - 1) / T;
+    const uint32_t tilesY = (L.height + T - 1) / T;
+    const uint32_t tx0 = std::min(tilesX - 1, (uint32_t)std::max(0.f, visible.left()  * fx / (float)T));
+    const uint32_t ty0 = std::min(tilesY - 1, (uint32_t)std::max(0.f, visible.top()   * fy / (float)T));
+    const uint32_t tx1 = std::min(tilesX - 1, (uint32_t)std::max(0.f, std::ceil(visible.right()  * fx / (float)T) - 1.f));
+    const uint32_t ty1 = std::min(tilesY - 1, (uint32_t)std::max(0.f, std::ceil(visible.bottom() * fy / (float)T) - 1.f));
+
+    bool complete = true;
+    for (uint32_t ty = ty0; ty <= ty1; ++ty) {
+        for (uint32_t tx = tx0; tx <= tx1; ++tx) {
+            const Tile* t = tile(renderer, level, tx, ty, force);
+            if (!t) { complete = false; continue; }
+            // The tile in full-resolution pixels, cropped to the view.
+            const float w = (float)std::min(T, L.width  - tx * T);
+            const float h = (float)std::min(T, L.height - ty * T);
+            const Rectf full = {{(float)(tx * T) / fx, (float)(ty * T) / fy}, {w / fx, h / fy}};
+            const Rectf part = intersectRect(full, src);
+            if (part.size.x <= 0.f || part.size.y <= 0.f) continue;
+            const Rectf uv = {{(part.left() - full.left()) / full.size.x,
+                               (part.top()  - full.top())  / full.size.y},
+                              {part.size.x / full.size.x, part.size.y / full.size.y}};
+            const Rectf dst = {{m_bounds.position.x + (part.left() - src.left()) * toScreenX,
+                                m_bounds.position.y + (part.top()  - src.top())  * toScreenY},
+                               {part.size.x * toScreenX, part.size.y * toScreenY}};
+            renderer.drawImage(dst, t->tex, Color::White, uv);
+        }
+    }
+    return complete;
+}
+
+void TiledImage::evictTiles(Renderer& renderer) {
+    const size_t budget = m_options.getMaxResidentTiles();
+    if (m_tiles.size() <= budget) return;
+    const int coarsest = (int)m_levels.size() - 1;
+    std::vector<std::pair<uint32_t, uint64_t>> lru;
+    for (const auto& kv : m_tiles)
+        if (kv.second.lastUsed != m_frame && (int)(kv.first >> 48) != coarsest)
+            lru.emplace_back(kv.second.lastUsed, kv.first);
+    std::sort(lru.begin(), lru.end());
+    for (const auto& [lastUsed, key] : lru) {
+        if (m_tiles.size() <= budget) break;
+        (void)lastUsed;
+        auto it = m_tiles.find(key);
+        renderer.destroyTexture(it->second.tex);
+        m_tiles.erase(it);
+    }
+}
+
+void TiledImage::render() {
+    m_dirty = false;
+    if (!m_uiloRef) return;
+    Renderer& renderer = m_uiloRef->getRenderer();
+    if (m_levels.empty()) {
+        const Color ph = m_options.getPlaceholderColor();
+        if (ph.a > 0) renderer.draw(Rect{m_bounds.position, m_bounds.size, ph});
+        return;
+    }
+    if (m_bounds.size.x <= 0.f || m_bounds.size.y <= 0.f) return;
+    ++m_frame;
+    m_uploadsLeft = std::max<uint32_t>(1, m_options.getUploadsPerFrame());
+
+    const Rectf image = {{0.f, 0.f}, {(float)m_levels[0].width, (float)m_levels[0].height}};
+    const Rectf src = m_viewRegion.size.x > 0.f && m_viewRegion.size.y > 0.f
+        ? intersectRect(m_viewRegion, image) : image;
+    const Rectf onScreen = intersectRect(m_bounds, renderer.getClipBounds());
+    if (src.size.x <= 0.f || src.size.y <= 0.f ||
+        onScreen.size.x <= 0.f || onScreen.size.y <= 0.f) {
+        evictTiles(renderer);
+        return;
+    }
+
+    // Source pixels per screen pixel picks the level: the finest one that
+    // is still at least as dense as the screen.
+    const float perPxX = src.size.x / m_bounds.size.x;
+    const float perPxY = src.size.y / m_bounds.size.y;
+    const float perPx  = std::min(perPxX, perPxY);
+    int level = 0;
+    while (level + 1 < (int)m_levels.size() && (float)(2 << level) <= perPx) ++level;
+
+    const Rectf visible = {
+        {src.left() + (onScreen.left() - m_bounds.position.x) * perPxX,
+         src.top()  + (onScreen.top()  - m_bounds.position.y) * perPxY},
+        {onScreen.size.x * perPxX, onScreen.size.y * perPxY}};
+
+    // The coarsest level is one tile and always kept; it stands in under
+    // finer tiles that haven't been uploaded yet.
+    const int coarsest = (int)m_levels.size() - 1;
+    bool complete = true;
+    if (level != coarsest) {
+        bool missing = false;
+        const uint32_t T = tileSize();
+        const Level& L = m_levels[(size_t)level];
+        const float fx = (float)L.width  / image.size.x;
+        const float fy = (float)L.height / image.size.y;
+        for (uint32_t ty = (uint32_t)(visible.top() * fy) / T;
+             !missing && ty * T < std::ceil(visible.bottom() * fy) && ty * T < L.height; ++ty)
+            for (uint32_t tx = (uint32_t)(visible.left() * fx) / T;
+                 tx * T < std::ceil(visible.right() * fx) && tx * T < L.width; ++tx)
+                if (!m_tiles.count(tileKey(level, tx, ty))) { missing = true; break; }
+        if (missing) drawLevel(renderer, coarsest, visible, src, true);
+        complete = drawLevel(renderer, level, visible, src, false);
+    } else {
+        drawLevel(renderer, coarsest, visible, src, true);
+    }
+
+    evictTiles(renderer);
+    if (!complete) m_uiloRef->requestRedraw();
+}
+
+} // namespace uilo
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Element.hpp"
+#include "../../renderer/Renderer.hpp"
+
+namespace uilo {
+
+class TiledImageOptions {
+public:
+    TiledImageOptions() = default;
+
+    TiledImageOptions& setPath(const std::string& path)   { m_path = path;  return *this; }
+    // Edge of a square tile in texels (clamped to [64, 2048]).
+    TiledImageOptions& setTileSize(uint16_t px)           { m_tileSize = px; return *this; }
+    // GPU tiles kept before off-screen ones are destroyed, least recently
+    // drawn first. Tiles drawn this frame are never evicted.
+    TiledImageOptions& setMaxResidentTiles(uint32_t n)    { m_maxResidentTiles = n; return *this; }
+    // Tiles uploaded per frame; the rest show the coarsest level meanwhile.
+    TiledImageOptions& setUploadsPerFrame(uint32_t n)     { m_uploadsPerFrame = n; return *this; }
+    // Filled in while the file is decoding, or for good if it fails.
+    TiledImageOptions& setPlaceholderColor(const Color& c) { m_placeholderColor = c; return *this; }
+
+    const std::string& getPath()             const { return m_path; }
+    uint16_t           getTileSize()         const { return m_tileSize; }
+    uint32_t           getMaxResidentTiles() const { return m_maxResidentTiles; }
+    uint32_t           getUploadsPerFrame()  const { return m_uploadsPerFrame; }
+    Color              getPlaceholderColor() const { return m_placeholderColor; }
+
+private:
+    std::string m_path;
+    uint16_t    m_tileSize         = 512;
+    uint32_t    m_maxResidentTiles = 64;
+    uint32_t    m_uploadsPerFrame  = 4;
+    Color       m_placeholderColor = Color{128, 128, 128, 48};
+};
+
+/*
+    TiledImage — an image too large for one texture (scanned scores,
+    spectrograms 16k+ px wide). The file is decoded once on a worker thread
+    into a CPU pyramid: full resolution, then halved until a level fits in
+    a single tile. Each frame only the tiles of the level matching the
+    on-screen scale that intersect the visible region are uploaded, a few
+    per frame, and off-screen tiles are evicted past setMaxResidentTiles.
+    The whole image is stretched over the bounds unless setViewRegion()
+    picks a sub-rectangle (zoom / pan).
+*/
+class TiledImage : public Element {
+public:
+    explicit TiledImage(Modifier modifier, TiledImageOptions options = {}, const std::string& name = "");
+    ~TiledImage() override;
+
+    void update(Rectf& parentBounds, float dt) override;
+    void render() override;
+
+    const TiledImageOptions& getOptions() const { return m_options; }
+    void setOptions(const TiledImageOptions& opts);
+
+    // Region of the image shown in the bounds, in source pixels; clamped
+    // to the image. An empty rect shows the whole image.
+    void  setViewRegion(const Rectf& region) { m_viewRegion = region; markDirty(); }
+    Rectf getViewRegion() const              { return m_viewRegion; }
+
+    bool     isLoaded() const        { return !m_levels.empty(); }
+    uint32_t getImageWidth()  const  { return m_levels.empty() ? 0 : m_levels[0].width; }
+    uint32_t getImageHeight() const  { return m_levels.empty() ? 0 : m_levels[0].height; }
+    size_t   getResidentTiles() const { return m_tiles.size(); }
+
+private:
+    struct Level {
+        uint32_t             width  = 0;
+        uint32_t             height = 0;
+        std::vector<uint8_t> rgba;
+    };
+    struct Tile {
+        Texture  tex;
+        uint32_t lastUsed = 0;   // m_frame
+    };
+    struct DecodeJob;
+
+    bool wantsUpdate() const override { return !m_decodeStarted || m_job != nullptr; }
+    static bool buildLevels(const std::string& path, uint32_t tileSize,
+                            std::vector<Level>& levels, const std::atomic<bool>* cancel);
+    void startDecode();
+    void cancelDecode();
+    void pollDecode();
+    void releaseTiles();
+    // Resident tile (tx, ty) of `level`, uploading it if the budget allows;
+    // nullptr when it isn't on the GPU yet.
+    const Tile* tile(Renderer& renderer, int level, uint32_t tx, uint32_t ty, bool force);
+    // Draws the part of `level` covering `visible` (source pixels) mapped
+    // through src -> m_bounds. Returns false when some tile is missing.
+    bool drawLevel(Renderer& renderer, int level, const Rectf& visible, const Rectf& src,
+                   bool force);
+    void evictTiles(Renderer& renderer);
+    uint32_t tileSize() const;
+
+    static uint64_t tileKey(int level, uint32_t tx, uint32_t ty) {
+        return ((uint64_t)level << 48) | ((uint64_t)ty << 24) | (uint64_t)tx;
+    }
+
+    TiledImageOptions            m_options;
+    Rectf                        m_viewRegion = {{0.f, 0.f}, {0.f, 0.f}};
+    std::vector<Level>           m_levels;     // [0] = full resolution
+    std::unique_ptr<DecodeJob>   m_job;
+    bool                         m_decodeStarted = false;
+    std::unordered_map<uint64_t, Tile> m_tiles;
+    uint32_t                     m_frame         = 0;
+    uint32_t                     m_uploadsLeft   = 0;   // this frame
+};
+
+} // namespace uilo
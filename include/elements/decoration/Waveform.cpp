@@ -1,12 +1,24 @@
 #include "Waveform.hpp"
 #include "../../UILO.hpp"
 #include "../../renderer/Shapes.hpp"
+#include "../../utils/PeakKernels.hpp"
+#include "../../utils/Trace.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
+#include <thread>
 
 namespace uilo {
 
+namespace {
+// Nothing wakes an on-demand loop when the producer writes; a streaming
+// waveform asks for frames at about display rate instead.
+constexpr float kStreamPollSeconds = 1.f / 60.f;
+// Same for a pyramid job: polled until its result can be adopted.
+constexpr float kPeakJobPollSeconds = 1.f / 30.f;
+}
+
 Waveform::Waveform(Modifier modifier, WaveformOptions options,
                    const std::string& name)
     : m_options(options)
@@ -19,14 +31,13 @@ Waveform::Waveform(Modifier modifier, WaveformOptions options,
 void Waveform::setSamples(const float* const* channels,
                           std::size_t numChannels,
                           std::size_t numFrames) {
+    cancelPeakJob();
+    m_stream.reset();
+    m_streamColumns = 0;
+    m_channels.clear();
     if (!channels || numChannels == 0 || numFrames == 0) {
-        m_samples.clear();
-        m_numChannels = 0;
-        m_numFrames   = 0;
-        m_rangeStart  = 0;
-        m_rangeCount  = 0;
-        m_peaksDirty  = true;
-        m_dirty       = true;
+        std::vector<float>().swap(m_samples);
+        adoptSource(0, 0);
         return;
     }
     m_samples.resize(numChannels * numFrames);
@@ -37,17 +48,153 @@ void Waveform::setSamples(const float* const* channels,
         else
             std::memset(m_samples.data() + c * numFrames, 0,
                         numFrames * sizeof(float));
+        m_channels.push_back(m_samples.data() + c * numFrames);
+    }
+    adoptSource(numChannels, numFrames);
+}
+
+void Waveform::setSampleView(const float* const* channels,
+                             std::size_t numChannels,
+                             std::size_t numFrames) {
+    if (!channels || numChannels == 0 || numFrames == 0) {
+        setSamples(nullptr, 0, 0);
+        return;
+    }
+    for (std::size_t c = 0; c < numChannels; ++c) {
+        if (!channels[c]) {
+            std::fprintf(stderr, "[UILO] Waveform::setSampleView: channel %zu is null\n", c);
+            setSamples(nullptr, 0, 0);
+            return;
+        }
+    }
+    cancelPeakJob();
+    m_stream.reset();
+    m_streamColumns = 0;
+    std::vector<float>().swap(m_samples);
+    m_channels.assign(channels, channels + numChannels);
+    adoptSource(numChannels, numFrames);
+}
+
+void Waveform::invalidateSampleView() {
+    cancelPeakJob();
+    if (!m_stream && !m_channels.empty()) {
+        m_pyramidBase  = kPyramidBase;
+        m_pyramidDirty = true;
     }
-    m_numChannels = numChannels;
-    m_numFrames   = numFrames;
-    if (m_rangeStart >= numFrames) m_rangeStart = 0;
-    if (m_rangeCount > 0 && m_rangeStart + m_rangeCount > numFrames)
-        m_rangeCount = numFrames - m_rangeStart;
     m_peaksDirty = true;
     m_dirty      = true;
 }
 
+bool Waveform::setPeakData(const float* const* minMax,
+                           std::size_t numChannels,
+                           std::size_t numFrames,
+                           std::size_t framesPerBlock) {
+    if (m_stream) {
+        std::fprintf(stderr, "[UILO] Waveform::setPeakData: not available while streaming\n");
+        return false;
+    }
+    if (!minMax || numChannels == 0 || numFrames == 0 || framesPerBlock == 0) {
+        std::fprintf(stderr, "[UILO] Waveform::setPeakData: empty peak data\n");
+        return false;
+    }
+    for (std::size_t c = 0; c < numChannels; ++c) {
+        if (!minMax[c]) {
+            std::fprintf(stderr, "[UILO] Waveform::setPeakData: channel %zu is null\n", c);
+            return false;
+        }
+    }
+    cancelPeakJob();
+    if (m_channels.empty()) {
+        // Peaks only: there are no samples to fall back on.
+        std::vector<float>().swap(m_samples);
+        adoptSource(numChannels, numFrames);
+    } else if (numChannels != m_numChannels || numFrames != m_numFrames) {
+        std::fprintf(stderr, "[UILO] Waveform::setPeakData: %zu x %zu frames doesn't match the samples (%zu x %zu)\n",
+                     numChannels, numFrames, m_numChannels, m_numFrames);
+        return false;
+    }
+
+    const std::size_t lanes   = m_numChannels > 1 ? m_numChannels + 1 : m_numChannels;
+    const std::size_t blocks0 = (numFrames + framesPerBlock - 1) / framesPerBlock;
+    m_pyramidBase      = framesPerBlock;
+    m_pyramidBlocks[0] = blocks0;
+    m_pyramid[0].assign(lanes * blocks0 * 2, 0.f);
+    for (std::size_t c = 0; c < numChannels; ++c)
+        std::memcpy(m_pyramid[0].data() + c * blocks0 * 2, minMax[c], blocks0 * 2 * sizeof(float));
+    if (lanes > numChannels) {
+        // Per-channel peaks can't give the exact envelope of the average;
+        // averaging the channels' bounds is the closest they allow.
+        float* mono = m_pyramid[0].data() + numChannels * blocks0 * 2;
+        for (std::size_t b = 0; b < blocks0 * 2; ++b) {
+            float sum = 0.f;
+            for (std::size_t c = 0; c < numChannels; ++c) sum += minMax[c][b];
+            mono[b] = sum / (float)numChannels;
+        }
+    }
+    foldLevels(m_pyramid, m_pyramidBlocks, lanes, numFrames, framesPerBlock);
+    m_pyramidDirty = false;
+    m_peaksDirty   = true;
+    m_dirty        = true;
+    return true;
+}
+
+void Waveform::adoptSource(std::size_t numChannels, std::size_t numFrames) {
+    cancelPeakJob();
+    m_numChannels = numChannels;
+    m_numFrames   = numFrames;
+    if (numFrames == 0) {
+        m_rangeStart = 0;
+        m_rangeCount = 0;
+    } else {
+        if (m_rangeStart >= numFrames) m_rangeStart = 0;
+        if (m_rangeCount > 0 && m_rangeStart + m_rangeCount > numFrames)
+            m_rangeCount = numFrames - m_rangeStart;
+    }
+    for (int L = 0; L < kPyramidLevels; ++L) {
+        m_pyramid[L].clear();
+        m_pyramidBlocks[L] = 0;
+    }
+    m_pyramidBase  = kPyramidBase;
+    m_pyramidDirty = !m_channels.empty();
+    m_peaksDirty   = true;
+    // Through the layout too: update() starts an async pyramid job.
+    markDirty();
+}
+
+void Waveform::setStreaming(std::size_t numChannels, std::size_t windowFrames) {
+    cancelPeakJob();
+    m_stream.reset();
+    m_streamColumns = 0;
+    m_streamTotal   = 0;
+    m_streamPeaks.clear();
+    if (numChannels == 0 || windowFrames == 0) {
+        setSamples(nullptr, 0, 0);
+        return;
+    }
+
+    // One window of headroom: the UI can miss a whole window's worth of
+    // audio before the producer starts dropping.
+    m_stream      = std::make_unique<SpscSampleRing>(numChannels, windowFrames);
+    m_samples.assign(numChannels * windowFrames, 0.f);
+    m_channels.clear();
+    for (std::size_t c = 0; c < numChannels; ++c)
+        m_channels.push_back(m_samples.data() + c * windowFrames);
+    m_rangeStart  = 0;
+    m_rangeCount  = 0;
+    m_rangeStartD = 0.0;
+    m_rangeCountD = 0.0;
+    adoptSource(numChannels, windowFrames);
+    m_pyramidDirty = false;   // streaming keeps its own column peaks
+    // wantsUpdate() just turned on; get the ancestors ticking us again.
+    markDirty();
+}
+
+std::size_t Waveform::pushSamples(const float* const* channels, std::size_t numFrames) {
+    return m_stream ? m_stream->write(channels, numFrames) : 0;
+}
+
 void Waveform::setRange(std::size_t firstFrame, std::size_t frameCount) {
+    if (m_stream) return;
     if (m_numFrames == 0) {
         m_rangeStart = 0;
         m_rangeCount = 0;
@@ -64,7 +211,7 @@ void Waveform::setRange(std::size_t firstFrame, std::size_t frameCount) {
 }
 
 void Waveform::zoomAt(float anchorNorm, float factor) {
-    if (m_numFrames == 0 || factor <= 0.f) return;
+    if (m_stream || m_numFrames == 0 || factor <= 0.f) return;
     anchorNorm = std::clamp(anchorNorm, 0.f, 1.f);
 
     const double total   = (double)m_numFrames;
@@ -94,8 +241,24 @@ void Waveform::zoomAt(float anchorNorm, float factor) {
     m_dirty      = true;
 }
 
+std::size_t Waveform::sampleBytes() const {
+    return m_samples.capacity() * sizeof(float) + m_channels.capacity() * sizeof(const float*);
+}
+
+std::size_t Waveform::peakBytes() const {
+    std::size_t bytes = (m_streamPeaks.capacity() + m_peaks.capacity()) * sizeof(float);
+    for (const auto& level : m_pyramid) bytes += level.capacity() * sizeof(float);
+    return bytes;
+}
+
 void Waveform::update(Rectf& parentBounds, float dt) {
     (void)dt;
+    if (m_stream) {
+        drainStream();
+        if (m_uiloRef) m_uiloRef->requestRedrawIn(kStreamPollSeconds);
+    }
+    if (m_pyramidDirty && asyncPyramid()) startPeakJob();
+    if (m_peakJob) pollPeakJob();
     Vec2f oldSize = m_bounds.size;
     resize(parentBounds);
     if (m_bounds.size != oldSize) {
@@ -104,7 +267,298 @@ void Waveform::update(Rectf& parentBounds, float dt) {
     }
 }
 
+void Waveform::buildPyramid() {
+    cancelPeakJob();
+    m_pyramidDirty = false;
+    buildLevels(m_channels.data(), m_channels.size(), m_numFrames, m_pyramidBase,
+                m_pyramid, m_pyramidBlocks, nullptr);
+}
+
+bool Waveform::buildLevels(const float* const* channels, std::size_t numChannels,
+                           std::size_t numFrames, std::size_t base,
+                           std::vector<float>* levels, std::size_t* blocks,
+                           const std::atomic<bool>* cancel) {
+    for (int L = 0; L < kPyramidLevels; ++L) {
+        levels[L].clear();
+        blocks[L] = 0;
+    }
+    if (numChannels == 0 || numFrames == 0) return true;
+
+    const std::size_t lanes = numChannels > 1 ? numChannels + 1 : numChannels;
+    const PeakKernels& k = getPeakKernels();
+
+    // Level 0 straight from the samples; the mono lane averages first.
+    const std::size_t blocks0 = numFrames / base;
+    blocks[0] = blocks0;
+    levels[0].assign(lanes * blocks0 * 2, 0.f);
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+        for (std::size_t b = 0; b < blocks0; ++b) {
+            // A worker checks for cancellation every 64 blocks.
+            if (cancel && (b & 63) == 0 && cancel->load(std::memory_order_relaxed))
+                return false;
+            float mn = 0.f, mx = 0.f;
+            if (lane < numChannels) k.minMax(channels[lane] + b * base, base, mn, mx);
+            else                    k.sumMinMax(channels, numChannels, b * base, base, mn, mx);
+            levels[0][(lane * blocks0 + b) * 2 + 0] = mn;
+            levels[0][(lane * blocks0 + b) * 2 + 1] = mx;
+        }
+    }
+    foldLevels(levels, blocks, lanes, numFrames, base);
+    return true;
+}
+
+// Each coarser level folds 16 blocks of the one below; only whole blocks
+// are kept, so a partial last level-0 block never reaches them.
+void Waveform::foldLevels(std::vector<float>* levels, std::size_t* blocks,
+                          std::size_t lanes, std::size_t numFrames, std::size_t base) {
+    for (int L = 1; L < kPyramidLevels; ++L) {
+        const std::size_t fine  = blocks[L - 1];
+        const std::size_t count = numFrames / (base << (4 * L));
+        blocks[L] = count;
+        levels[L].assign(lanes * count * 2, 0.f);
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            const float* src = levels[L - 1].data() + lane * fine * 2;
+            float*       dst = levels[L].data()     + lane * count * 2;
+            for (std::size_t b = 0; b < count; ++b) {
+                float mn = src[b * 32], mx = src[b * 32 + 1];
+                for (std::size_t k = 1; k < 16; ++k) {
+                    mn = std::min(mn, src[(b * 16 + k) * 2 + 0]);
+                    mx = std::max(mx, src[(b * 16 + k) * 2 + 1]);
+                }
+                dst[b * 2 + 0] = mn;
+                dst[b * 2 + 1] = mx;
+            }
+        }
+    }
+}
+
+// Built off the UI thread; the source buffers can't change underneath it
+// because every call that replaces them cancels and joins first.
+struct Waveform::PeakJob {
+    std::thread        thread;
+    std::atomic<bool>  cancel{false};
+    std::atomic<bool>  done{false};
+    std::vector<float> levels[kPyramidLevels];
+    std::size_t        blocks[kPyramidLevels] = {};
+};
+
+Waveform::~Waveform() {
+    cancelPeakJob();
+    releasePeakTexture();
+}
+
+void Waveform::startPeakJob() {
+    cancelPeakJob();
+    m_pyramidDirty = false;
+    for (int L = 0; L < kPyramidLevels; ++L) {
+        m_pyramid[L].clear();
+        m_pyramidBlocks[L] = 0;
+    }
+
+    m_peakJob = std::make_unique<PeakJob>();
+    PeakJob* job = m_peakJob.get();
+    job->thread = std::thread([job, channels = m_channels, frames = m_numFrames,
+                               base = m_pyramidBase] {
+        if (buildLevels(channels.data(), channels.size(), frames, base,
+                        job->levels, job->blocks, &job->cancel))
+            job->done.store(true, std::memory_order_release);
+    });
+}
+
+void Waveform::cancelPeakJob() {
+    if (!m_peakJob) return;
+    m_peakJob->cancel.store(true, std::memory_order_relaxed);
+    m_peakJob->thread.join();
+    m_peakJob.reset();
+}
+
+void Waveform::pollPeakJob() {
+    if (!m_peakJob->done.load(std::memory_order_acquire)) {
+        if (m_uiloRef) m_uiloRef->requestRedrawIn(kPeakJobPollSeconds);
+        return;
+    }
+    m_peakJob->thread.join();
+    for (int L = 0; L < kPyramidLevels; ++L) {
+        m_pyramid[L].swap(m_peakJob->levels[L]);
+        m_pyramidBlocks[L] = m_peakJob->blocks[L];
+    }
+    m_peakJob.reset();
+    m_peaksDirty = true;
+    m_dirty      = true;
+    if (m_uiloRef) m_uiloRef->requestRedraw();
+}
+
+// Placeholder peaks while the pyramid is being built: at most 16 evenly
+// spaced frames per column, so the outline shows up at once.
+void Waveform::previewPeaks(std::size_t lane, std::size_t s0, std::size_t s1,
+                            float& mn, float& mx) const {
+    const std::size_t step = std::max<std::size_t>(1, (s1 - s0) / 16);
+    for (std::size_t s = s0; s < s1; s += step) {
+        float v;
+        if (lane < m_numChannels) {
+            v = m_channels[lane][s];
+        } else {
+            float sum = 0.f;
+            for (std::size_t c = 0; c < m_numChannels; ++c) sum += m_channels[c][s];
+            v = sum / (float)m_numChannels;
+        }
+        mn = std::min(mn, v);
+        mx = std::max(mx, v);
+    }
+}
+
+void Waveform::scanPeaks(std::size_t lane, std::size_t s0, std::size_t s1,
+                         int level, float& mn, float& mx) const {
+    if (s0 >= s1) return;
+
+    if (level < 0) {
+        const PeakKernels& k = getPeakKernels();
+        if (lane < m_numChannels)
+            k.minMax(m_channels[lane] + s0, s1 - s0, mn, mx);
+        else
+            k.sumMinMax(m_channels.data(), m_numChannels, s0, s1 - s0, mn, mx);
+        return;
+    }
+
+    if (level == 0 && m_channels.empty()) {
+        // Peaks only: nothing finer to take the edges from, so every block
+        // the range touches counts.
+        const std::size_t B = blockFrames(0);
+        const std::size_t b = std::min((s1 + B - 1) / B, m_pyramidBlocks[0]);
+        const float* blocks = m_pyramid[0].data() + lane * m_pyramidBlocks[0] * 2;
+        for (std::size_t k = s0 / B; k < b; ++k) {
+            mn = std::min(mn, blocks[k * 2 + 0]);
+            mx = std::max(mx, blocks[k * 2 + 1]);
+        }
+        return;
+    }
+
+    // Whole blocks of this level inside [s0, s1); the ragged edges go one
+    // level finer, so each edge costs at most 15 blocks per level.
+    const std::size_t B = blockFrames(level);
+    const std::size_t a = (s0 + B - 1) / B;
+    const std::size_t b = std::min(s1 / B, m_pyramidBlocks[level]);
+    if (a >= b) {
+        scanPeaks(lane, s0, s1, level - 1, mn, mx);
+        return;
+    }
+    const float* blocks = m_pyramid[level].data() + lane * m_pyramidBlocks[level] * 2;
+    for (std::size_t k = a; k < b; ++k) {
+        mn = std::min(mn, blocks[k * 2 + 0]);
+        mx = std::max(mx, blocks[k * 2 + 1]);
+    }
+    scanPeaks(lane, s0, a * B, level - 1, mn, mx);
+    scanPeaks(lane, b * B, s1, level - 1, mn, mx);
+}
+
+int Waveform::columnsFor(std::size_t frames) const {
+    int cols = m_options.getColumns();
+    if (cols <= 0) {
+        const float res = std::max(0.0001f, m_options.getResolution());
+        cols = std::max(1, (int)std::floor(m_bounds.size.x * res));
+    }
+    return (int)std::min<std::size_t>((std::size_t)cols, frames);
+}
+
+void Waveform::drainStream() {
+    const std::size_t n = m_stream->readable();
+    if (n == 0) return;
+
+    // The ring never holds more than a window, so every drained frame is
+    // still on screen and the copy touches each display slot at most once.
+    const std::size_t W    = m_numFrames;
+    const std::size_t cap  = m_stream->getCapacity();
+    const std::size_t from = m_stream->readOffset();
+    std::size_t done = 0;
+    while (done < n) {
+        const std::size_t src = (from + done) % cap;
+        const std::size_t dst = (std::size_t)((m_streamTotal + done) % W);
+        const std::size_t run = std::min({n - done, cap - src, W - dst});
+        for (std::size_t c = 0; c < m_numChannels; ++c)
+            std::memcpy(m_samples.data() + c * W + dst,
+                        m_stream->channel(c) + src, run * sizeof(float));
+        done += run;
+    }
+    m_stream->consume(n);
+
+    const std::uint64_t a = m_streamTotal;
+    m_streamTotal += n;
+    if (m_streamColumns > 0) foldStream(a, m_streamTotal);
+    m_peaksDirty = true;
+    m_dirty      = true;
+}
+
+void Waveform::scanStream(std::size_t lane, std::uint64_t a, std::uint64_t b,
+                          float& mn, float& mx) const {
+    const PeakKernels& k = getPeakKernels();
+    const std::size_t W = m_numFrames;
+    while (a < b) {
+        const std::size_t at  = (std::size_t)(a % W);
+        const std::size_t run = (std::size_t)std::min<std::uint64_t>(b - a, W - at);
+        if (m_streamSum)
+            k.sumMinMax(m_channels.data(), m_numChannels, at, run, mn, mx);
+        else
+            k.minMax(m_channels[lane] + at, run, mn, mx);
+        a += run;
+    }
+}
+
+void Waveform::foldStream(std::uint64_t a, std::uint64_t b) {
+    const std::size_t   F     = m_streamFramesPerColumn;
+    const std::size_t   cols  = (std::size_t)m_streamColumns;
+    const std::size_t   lanes = m_streamSum ? 1 : m_numChannels;
+    while (a < b) {
+        const std::uint64_t col = a / F;
+        const std::uint64_t end = std::min<std::uint64_t>(b, (col + 1) * F);
+        const std::size_t   slot = (std::size_t)(col % cols);
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            float* p = m_streamPeaks.data() + (lane * cols + slot) * 2;
+            if (a % F == 0) p[0] = p[1] = 0.f;   // slot reused for a new column
+            scanStream(lane, a, end, p[0], p[1]);
+        }
+        a = end;
+    }
+}
+
+void Waveform::rebuildStreamPeaks() {
+    const int         cols  = columnsFor(m_numFrames);
+    if (cols <= 0) return;
+    const bool        sum   = (m_options.getLayout() == WaveformLayout::SumMono);
+    const std::size_t lanes = sum ? 1 : m_numChannels;
+    const std::size_t F     = std::max<std::size_t>(1, m_numFrames / (std::size_t)cols);
+    const std::uint64_t colEnd = (m_streamTotal + F - 1) / F;  // one past the newest column
+
+    // Geometry changed: recompute every visible column from the window.
+    // cols * F <= window, so they are all still in m_samples.
+    if (cols != m_streamColumns || F != m_streamFramesPerColumn || sum != m_streamSum) {
+        m_streamColumns         = cols;
+        m_streamFramesPerColumn = F;
+        m_streamSum             = sum;
+        m_streamPeaks.assign(lanes * (std::size_t)cols * 2, 0.f);
+        const std::uint64_t colStart = colEnd > (std::uint64_t)cols ? colEnd - cols : 0;
+        foldStream(colStart * F, m_streamTotal);
+    }
+
+    m_peaks.assign(lanes * (std::size_t)cols * 2, 0.f);
+    m_peakChannels = lanes;
+    m_peakColumns  = cols;
+    for (int c = 0; c < cols; ++c) {
+        // Newest column on the right; columns before the first frame stay 0.
+        const std::int64_t col = (std::int64_t)colEnd - cols + c;
+        if (col < 0) continue;
+        const std::size_t slot = (std::size_t)(col % cols);
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            const float* src = m_streamPeaks.data() + (lane * (std::size_t)cols + slot) * 2;
+            float*       dst = m_peaks.data()       + (lane * (std::size_t)cols + (std::size_t)c) * 2;
+            dst[0] = src[0];
+            dst[1] = src[1];
+        }
+    }
+}
+
 void Waveform::rebuildPeaks() {
+    UILO_TRACE_ZONE("Waveform::rebuildPeaks");
+    m_peakTexDirty   = true;
     m_peaks.clear();
     m_peakChannels   = 0;
     m_peakColumns    = 0;
@@ -114,17 +568,18 @@ void Waveform::rebuildPeaks() {
     if (m_numChannels == 0 || m_numFrames == 0) return;
     if (m_bounds.size.x <= 0.f || m_bounds.size.y <= 0.f) return;
 
+    if (m_stream) { rebuildStreamPeaks(); return; }
+    // An async pyramid still waiting for update() to start its job shows
+    // the preview too.
+    if (m_pyramidDirty && !asyncPyramid()) buildPyramid();
+    const bool preview = m_pyramidDirty || m_peakJob != nullptr;
+
     const std::size_t first = m_rangeStart;
     const std::size_t total = (m_rangeCount > 0) ? m_rangeCount
                                                  : (m_numFrames - first);
     if (total == 0) return;
 
-    int cols = m_options.getColumns();
-    if (cols <= 0) {
-        const float res = std::max(0.0001f, m_options.getResolution());
-        cols = std::max(1, (int)std::floor(m_bounds.size.x * res));
-    }
-    cols = std::min<int>(cols, (int)total);
+    const int cols = columnsFor(total);
     if (cols <= 0) return;
 
     const bool sum = (m_options.getLayout() == WaveformLayout::SumMono);
@@ -134,8 +589,16 @@ void Waveform::rebuildPeaks() {
     m_peakChannels = outChannels;
     m_peakColumns  = cols;
 
-    // For each output column, scan its slice of input frames and record
+    // For each output column, fold its slice of input frames into
     // (min,max). Slice size is total/cols, distributed with remainder.
+    // Start from the coarsest pyramid level whose blocks fit in a column:
+    // rebuild cost then follows the column count, not the frame count.
+    const std::size_t span = std::max<std::size_t>(1, total / (std::size_t)cols);
+    int level = -1;
+    while (level + 1 < kPyramidLevels && blockFrames(level + 1) <= span) ++level;
+    if (m_channels.empty()) level = std::max(level, 0);
+
+    const std::size_t sumLane = m_numChannels > 1 ? m_numChannels : 0;
     for (int col = 0; col < cols; ++col) {
         std::size_t s0 = first + (std::size_t)((double)total * (double)col       / (double)cols);
         std::size_t s1 = first + (std::size_t)((double)total * (double)(col + 1) / (double)cols);
@@ -144,25 +607,15 @@ void Waveform::rebuildPeaks() {
 
         if (sum) {
             float mn = 0.f, mx = 0.f;
-            for (std::size_t s = s0; s < s1; ++s) {
-                float sum = 0.f;
-                for (std::size_t c = 0; c < m_numChannels; ++c)
-                    sum += m_samples[c * m_numFrames + s];
-                sum /= (float)m_numChannels;
-                if (sum < mn) mn = sum;
-                if (sum > mx) mx = sum;
-            }
+            if (preview) previewPeaks(sumLane, s0, s1, mn, mx);
+            else         scanPeaks(sumLane, s0, s1, level, mn, mx);
             m_peaks[(std::size_t)col * 2 + 0] = mn;
             m_peaks[(std::size_t)col * 2 + 1] = mx;
         } else {
             for (std::size_t c = 0; c < m_numChannels; ++c) {
-                const float* src = m_samples.data() + c * m_numFrames;
                 float mn = 0.f, mx = 0.f;
-                for (std::size_t s = s0; s < s1; ++s) {
-                    float v = src[s];
-                    if (v < mn) mn = v;
-                    if (v > mx) mx = v;
-                }
+                if (preview) previewPeaks(c, s0, s1, mn, mx);
+                else         scanPeaks(c, s0, s1, level, mn, mx);
                 std::size_t base = c * (std::size_t)cols * 2 + (std::size_t)col * 2;
                 m_peaks[base + 0] = mn;
                 m_peaks[base + 1] = mx;
@@ -171,7 +624,50 @@ void Waveform::rebuildPeaks() {
     }
 }
 
-void Waveform::renderChannelStrip(std::size_t ch, Rectf strip) {
+bool Waveform::syncPeakTexture() {
+    if (!m_options.getGpuPeaks() || m_peakColumns <= 0 || m_peakChannels == 0) return false;
+    if (m_peakColumns > 0xFFFF || m_peakChannels > 0xFFFF) return false;
+    const auto cols  = (uint16_t)m_peakColumns;
+    const auto lanes = (uint16_t)m_peakChannels;
+    const std::uint32_t size = ((std::uint32_t)cols << 16) | lanes;
+    if (size == m_peakTexMiss) return false;
+
+    auto& renderer = m_uiloRef->getRenderer();
+    if (m_peakTexture != 0xFFFFu && (m_peakTexColumns != cols || m_peakTexLanes != lanes))
+        releasePeakTexture();
+    if (m_peakTexture == 0xFFFFu) {
+        const Texture tex = renderer.createPeakTexture(cols, lanes);
+        if (!tex.valid()) { m_peakTexMiss = size; return false; }
+        m_peakTexture    = tex.handle;
+        m_peakTexColumns = cols;
+        m_peakTexLanes   = lanes;
+        m_peakTexDirty   = true;
+    }
+    if (m_peakTexDirty) {
+        Texture tex;
+        tex.handle = m_peakTexture;
+        tex.width  = cols;
+        tex.height = lanes;
+        renderer.updatePeakTexture(tex, m_peaks.data());
+        m_peakTexDirty = false;
+    }
+    return true;
+}
+
+void Waveform::releasePeakTexture() {
+    if (m_peakTexture == 0xFFFFu) return;
+    if (m_uiloRef) {
+        Texture tex;
+        tex.handle = m_peakTexture;
+        m_uiloRef->getRenderer().destroyTexture(tex);
+    }
+    m_peakTexture    = 0xFFFFu;
+    m_peakTexColumns = 0;
+    m_peakTexLanes   = 0;
+    m_peakTexDirty   = true;
+}
+
+void Waveform::renderChannelStrip(std::size_t ch, Rectf strip, bool gpu) {
     if (m_peakColumns <= 0) return;
     auto& renderer = m_uiloRef->getRenderer();
 
@@ -190,13 +686,23 @@ void Waveform::renderChannelStrip(std::size_t ch, Rectf strip) {
     }
     const auto  style  = m_options.getStyle();
 
-    const float colW = strip.size.x / (float)m_peakColumns;
-
-    std::vector<Line> lines;
+    if (gpu) {
+        const PeakStyle peakStyle = style == WaveformStyle::Line   ? PeakStyle::Line
+                                  : style == WaveformStyle::Filled ? PeakStyle::Filled
+                                                                   : PeakStyle::Bars;
+        Texture tex;
+        tex.handle = m_peakTexture;
+        tex.width  = m_peakTexColumns;
+        tex.height = m_peakTexLanes;
+        if (renderer.drawWaveform(strip, tex, (uint16_t)ch, peakStyle, color, gain, thick))
+            return;
+    }
 
+    const float colW = strip.size.x / (float)m_peakColumns;
     const std::size_t base = ch * (std::size_t)m_peakColumns * 2;
 
     if (style == WaveformStyle::Bars) {
+        FrameVector<Line> lines(getFrameArena());
         lines.reserve((std::size_t)m_peakColumns);
         for (int col = 0; col < m_peakColumns; ++col) {
             float mn = m_peaks[base + (std::size_t)col * 2 + 0] * gain;
@@ -209,43 +715,43 @@ void Waveform::renderChannelStrip(std::size_t ch, Rectf strip) {
             if (std::abs(y1 - y0) < 1.f) { y0 = midY - 0.5f; y1 = midY + 0.5f; }
             lines.push_back(Line{{x, y0}, {x, y1}, thick, color});
         }
-    } else if (style == WaveformStyle::Filled) {
-        // Vertical bar from baseline to the signed peak, fat enough to
-        // touch neighbouring columns — gives a solid filled envelope.
-        lines.reserve((std::size_t)m_peakColumns);
-        const float barThick = std::max(thick, colW + 1.f);
-        for (int col = 0; col < m_peakColumns; ++col) {
-            float mn = m_peaks[base + (std::size_t)col * 2 + 0] * gain;
-            float mx = m_peaks[base + (std::size_t)col * 2 + 1] * gain;
-            mn = std::clamp(mn, -1.f, 1.f);
-            mx = std::clamp(mx, -1.f, 1.f);
-            float v  = (std::abs(mx) >= std::abs(mn)) ? mx : mn;
-            float x  = strip.position.x + colW * ((float)col + 0.5f);
-            float y  = midY - v * halfH;
-            if (std::abs(y - midY) < 0.5f) y = midY + (v >= 0.f ? -0.5f : 0.5f);
-            lines.push_back(Line{{x, midY}, {x, y}, barThick, color});
-        }
-    } else { // WaveformStyle::Line
-        // Continuous polyline through one signed value per column.
-        lines.reserve((std::size_t)std::max(0, m_peakColumns - 1));
-        auto pointAt = [&](int col) {
-            float mn = m_peaks[base + (std::size_t)col * 2 + 0] * gain;
-            float mx = m_peaks[base + (std::size_t)col * 2 + 1] * gain;
-            mn = std::clamp(mn, -1.f, 1.f);
-            mx = std::clamp(mx, -1.f, 1.f);
-            float v  = (std::abs(mx) >= std::abs(mn)) ? mx : mn;
-            return Vec2f{strip.position.x + colW * ((float)col + 0.5f),
-                         midY - v * halfH};
-        };
-        Vec2f prev = pointAt(0);
-        for (int col = 1; col < m_peakColumns; ++col) {
-            Vec2f cur = pointAt(col);
-            lines.push_back(Line{prev, cur, thick, color});
-            prev = cur;
-        }
+        renderer.drawLines(lines.data(), lines.size());
+        return;
     }
 
-    renderer.drawLines(lines.data(), lines.size());
+    // Line / Filled: one signed value per column (the larger-magnitude
+    // peak), as a single strip.
+    auto pointAt = [&](int col) {
+        float mn = m_peaks[base + (std::size_t)col * 2 + 0] * gain;
+        float mx = m_peaks[base + (std::size_t)col * 2 + 1] * gain;
+        mn = std::clamp(mn, -1.f, 1.f);
+        mx = std::clamp(mx, -1.f, 1.f);
+        float v  = (std::abs(mx) >= std::abs(mn)) ? mx : mn;
+        return Vec2f{strip.position.x + colW * ((float)col + 0.5f),
+                     midY - v * halfH};
+    };
+    FrameVector<Vec2f> points(getFrameArena());
+    points.reserve((std::size_t)m_peakColumns + 2);
+
+    if (style == WaveformStyle::Filled) {
+        // Envelope from the baseline to the signed peak, held flat out to
+        // the strip's edges like the columns it replaces. At least half a
+        // pixel tall, so silence still shows as a midline.
+        auto filledAt = [&](int col) {
+            Vec2f p = pointAt(col);
+            if (std::abs(p.y - midY) < 0.5f) p.y = midY + (p.y <= midY ? -0.5f : 0.5f);
+            return p;
+        };
+        points.push_back(Vec2f{strip.position.x, filledAt(0).y});
+        for (int col = 0; col < m_peakColumns; ++col)
+            points.push_back(filledAt(col));
+        points.push_back(Vec2f{strip.position.x + strip.size.x, points.back().y});
+        renderer.drawFilledEnvelope(points.data(), points.size(), midY, color);
+    } else { // WaveformStyle::Line
+        for (int col = 0; col < m_peakColumns; ++col)
+            points.push_back(pointAt(col));
+        renderer.drawPolyline(points.data(), points.size(), thick, color, LineJoin::Miter);
+    }
 }
 
 void Waveform::render() {
@@ -274,15 +780,16 @@ void Waveform::render() {
     renderer.pushRoundClip(m_bounds, r);
 
     if (m_peaksDirty || m_peakBoundsSize != m_bounds.size) rebuildPeaks();
+    const bool gpu = syncPeakTexture();
 
     if (m_peakChannels > 0 && m_peakColumns > 0) {
         switch (m_options.getLayout()) {
             case WaveformLayout::SumMono:
-                renderChannelStrip(0, m_bounds);
+                renderChannelStrip(0, m_bounds, gpu);
                 break;
             case WaveformLayout::Overlay:
                 for (std::size_t c = 0; c < m_peakChannels; ++c)
-                    renderChannelStrip(c, m_bounds);
+                    renderChannelStrip(c, m_bounds, gpu);
                 break;
             case WaveformLayout::Stacked: {
                 const float h = m_bounds.size.y / (float)m_peakChannels;
@@ -292,7 +799,7 @@ void Waveform::render() {
                          m_bounds.position.y + (float)c * h},
                         {m_bounds.size.x, h}
                     };
-                    renderChannelStrip(c, strip);
+                    renderChannelStrip(c, strip, gpu);
                 }
                 break;
             }
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "../Element.hpp"
+#include "../../utils/SpscSampleRing.hpp"
 #include <vector>
 #include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 
 namespace uilo {
 
@@ -50,15 +54,24 @@ public:
     // Vertical scaling factor applied to the normalized peak before
     // mapping to pixels. 1.0 == fill the strip; values > 1 over-drive.
     WaveformOptions& setGain(float g)               { m_gain = g;        return *this; }
+    // Build the peak pyramid for large buffers (1M+ samples) on a worker
+    // thread. Until it lands the widget draws a sparse preview sampled
+    // straight from the buffer. Off by default.
+    WaveformOptions& setAsyncPeaks(bool a)          { m_asyncPeaks = a;  return *this; }
+    // Upload the peaks to a float texture and draw each strip as a single
+    // quad shaded on the GPU, so the per-frame CPU cost doesn't grow with
+    // the width. Falls back to line batches when the backend can't sample
+    // float textures. On by default.
+    WaveformOptions& setGpuPeaks(bool g)            { m_gpuPeaks = g;    return *this; }
 
     Color           getColor()          const { return m_color; }
-    const std::string& getColorRole()           const { return m_colorRole; }
+    const Role&        getColorRole()           const { return m_colorRole; }
     Color           getLeftChannelColor()  const { return m_leftColor; }
-    const std::string& getLeftChannelColorRole()  const { return m_leftColorRole; }
+    const Role&        getLeftChannelColorRole()  const { return m_leftColorRole; }
     Color           getRightChannelColor() const { return m_rightColor; }
-    const std::string& getRightChannelColorRole() const { return m_rightColorRole; }
+    const Role&        getRightChannelColorRole() const { return m_rightColorRole; }
     Color           getBackgroundColor() const { return m_bgColor; }
-    const std::string& getBackgroundColorRole() const { return m_bgColorRole; }
+    const Role&        getBackgroundColorRole() const { return m_bgColorRole; }
     float           getRounding()       const { return m_rounding; }
     float           getLineThickness()  const { return m_lineThickness; }
     WaveformLayout  getLayout()         const { return m_layout; }
@@ -66,16 +79,18 @@ public:
     int             getColumns()        const { return m_columns; }
     float           getResolution()     const { return m_resolution; }
     float           getGain()           const { return m_gain; }
+    bool            getAsyncPeaks()     const { return m_asyncPeaks; }
+    bool            getGpuPeaks()       const { return m_gpuPeaks; }
 
 private:
     Color          m_color         = Color{255, 255, 255, 255};
-    std::string    m_colorRole;
+    Role           m_colorRole;
     Color          m_leftColor     = Color{0, 0, 0, 0};   // a=0 -> use m_color
-    std::string    m_leftColorRole;
+    Role           m_leftColorRole;
     Color          m_rightColor    = Color{0, 0, 0, 0};   // a=0 -> use m_color
-    std::string    m_rightColorRole;
+    Role           m_rightColorRole;
     Color          m_bgColor       = Color{0, 0, 0, 0};
-    std::string    m_bgColorRole;
+    Role           m_bgColorRole;
     float          m_rounding      = 0.f;
     float          m_lineThickness = 1.f;
     WaveformLayout m_layout        = WaveformLayout::Stacked;
@@ -83,12 +98,15 @@ private:
     int            m_columns       = 0;
     float          m_resolution    = 1.f;
     float          m_gain          = 1.f;
+    bool           m_asyncPeaks    = false;
+    bool           m_gpuPeaks      = true;
 };
 
 class Waveform : public Element {
 public:
     explicit Waveform(Modifier modifier, WaveformOptions options = {},
                       const std::string& name = "");
+    ~Waveform() override;
 
     const WaveformOptions& getOptions() const { return m_options; }
     WaveformOptions&       getOptions()       { return m_options; }
@@ -102,6 +120,50 @@ public:
                     std::size_t numChannels,
                     std::size_t numFrames);
 
+    // Non-owning alternative to setSamples() for sample data the caller
+    // already keeps, e.g. a memory-mapped decode. Only the channel
+    // pointers are stored; every channel must be non-null. The buffers
+    // must stay valid until the view is replaced (setSampleView,
+    // setSamples, setStreaming), cleared with setSamples(nullptr, 0, 0),
+    // or the widget is destroyed. After changing their contents, call
+    // invalidateSampleView() so the peaks are rebuilt.
+    void setSampleView(const float* const* channels,
+                       std::size_t numChannels,
+                       std::size_t numFrames);
+    void invalidateSampleView();
+
+    // Precomputed peaks, e.g. from a .peak cache file, so the widget
+    // needn't scan the samples itself. minMax[c] holds interleaved
+    // {min, max} pairs, one per `framesPerBlock` frames of channel c
+    // (ceil(numFrames / framesPerBlock) pairs; the last block may be
+    // partial); the data is copied. With samples loaded, channel and
+    // frame counts must match them, and the samples still refine column
+    // edges finer than a block. Load the samples first: any later
+    // setSamples / setSampleView / invalidateSampleView drops these
+    // peaks. Without samples the peaks alone are drawn, at block
+    // resolution. SumMono averages the channels' bounds per block (an
+    // approximation of the true mono envelope). Returns false, with a
+    // message on stderr, if the data is unusable or the widget is
+    // streaming.
+    bool setPeakData(const float* const* minMax,
+                     std::size_t numChannels,
+                     std::size_t numFrames,
+                     std::size_t framesPerBlock);
+
+    // Live input. setStreaming() switches the widget to a scrolling view
+    // of the most recent `windowFrames` frames (0 turns it off again, as
+    // does setSamples()). pushSamples() may then be called from another
+    // thread, e.g. the audio callback: it only copies into a lock-free
+    // single-producer ring and returns the frames accepted (the rest are
+    // dropped when the UI falls a whole window behind). The UI thread
+    // drains the ring during update(), refreshing just the peak columns
+    // the new frames land in; the rest scroll. Don't call setStreaming()
+    // while a producer is pushing. setRange() / zoomAt() are ignored
+    // while streaming.
+    void setStreaming(std::size_t numChannels, std::size_t windowFrames);
+    std::size_t pushSamples(const float* const* channels, std::size_t numFrames);
+    bool isStreaming() const { return m_stream != nullptr; }
+
     // Restrict rendered region to [firstFrame, firstFrame+frameCount).
     // Pass frameCount == 0 to show the full buffer.
     void setRange(std::size_t firstFrame, std::size_t frameCount);
@@ -118,20 +180,68 @@ public:
         return m_rangeCount ? m_rangeCount : m_numFrames;
     }
 
+    // True while an async pyramid build (WaveformOptions::setAsyncPeaks)
+    // is still running and the preview is on screen.
+    bool isBuildingPeaks() const { return m_peakJob != nullptr; }
+
     std::size_t getNumChannels() const { return m_numChannels; }
     std::size_t getNumFrames()   const { return m_numFrames; }
 
+    // Bytes held for the audio (owned samples, channel table) and for
+    // peaks (pyramid, stream ring, per-column cache).
+    std::size_t sampleBytes() const;
+    std::size_t peakBytes() const;
+    std::size_t heapBytes() const override { return Element::heapBytes() + sampleBytes() + peakBytes(); }
+
     void update(Rectf& parentBounds, float dt) override;
     void render() override;
 
 private:
+    bool wantsUpdate() const override { return m_stream || m_peakJob; }
+    // Streaming and a pending pyramid job ask UILO for frames from
+    // update(), so those ticks stay on the main thread.
+    bool parallelSafe() const override { return !m_stream && !m_peakJob; }
+    int  columnsFor(std::size_t frames) const;
+    void adoptSource(std::size_t numChannels, std::size_t numFrames);
     void rebuildPeaks();
-    void renderChannelStrip(std::size_t ch, Rectf strip);
+    void buildPyramid();
+    static bool buildLevels(const float* const* channels, std::size_t numChannels,
+                            std::size_t numFrames, std::size_t base,
+                            std::vector<float>* levels, std::size_t* blocks,
+                            const std::atomic<bool>* cancel);
+    static void foldLevels(std::vector<float>* levels, std::size_t* blocks,
+                           std::size_t lanes, std::size_t numFrames, std::size_t base);
+    // Large buffers with setAsyncPeaks() build the pyramid off the UI
+    // thread. The job starts from update(), never render(): starting it
+    // changes wantsUpdate(), which the ancestors pick up from the tick.
+    bool asyncPyramid() const {
+        return m_options.getAsyncPeaks() && m_numFrames * m_numChannels >= kAsyncPeakSamples;
+    }
+    void startPeakJob();
+    void cancelPeakJob();
+    void pollPeakJob();
+    void previewPeaks(std::size_t lane, std::size_t s0, std::size_t s1,
+                      float& mn, float& mx) const;
+    // Folds lane `lane`'s samples in [s0, s1) into (mn, mx), taking whole
+    // blocks from pyramid level `level` and finer levels for the edges.
+    void scanPeaks(std::size_t lane, std::size_t s0, std::size_t s1,
+                   int level, float& mn, float& mx) const;
+    void drainStream();
+    void rebuildStreamPeaks();
+    // Folds absolute frames [a, b) into their columns of m_streamPeaks.
+    void foldStream(std::uint64_t a, std::uint64_t b);
+    void scanStream(std::size_t lane, std::uint64_t a, std::uint64_t b,
+                    float& mn, float& mx) const;
+    bool syncPeakTexture();
+    void releasePeakTexture();
+    void renderChannelStrip(std::size_t ch, Rectf strip, bool gpu);
 
     WaveformOptions m_options;
 
-    // Owning copy of the audio data.
-    std::vector<float> m_samples;        // numChannels * numFrames, planar
+    // Owning copy of the audio data (empty for a sample view), and the
+    // channel pointers every reader goes through.
+    std::vector<float>        m_samples;  // numChannels * numFrames, planar
+    std::vector<const float*> m_channels; // empty when only peaks were given
     std::size_t m_numChannels = 0;
     std::size_t m_numFrames   = 0;
 
@@ -144,12 +254,51 @@ private:
     double      m_rangeStartD = 0.0;
     double      m_rangeCountD = 0.0; // 0 == full buffer
 
+    // Min/max pyramid, built on the first render after the samples change
+    // (or by a job started from the next update()) or from setPeakData(). Level L holds one {min,max} pair per full
+    // block of m_pyramidBase << (4 * L) frames (level 0 from setPeakData
+    // also keeps the partial last block):
+    // m_pyramid[L][(lane * m_pyramidBlocks[L] + block) * 2 + {0,1}].
+    // Lanes are the channels, plus a mono-average lane for SumMono when
+    // there is more than one channel (min/max don't survive averaging).
+    static constexpr int         kPyramidLevels = 3;     // 256 / 4096 / 65536
+    static constexpr std::size_t kPyramidBase   = 256;
+    std::size_t blockFrames(int level) const { return m_pyramidBase << (4 * level); }
+    std::size_t        m_pyramidBase  = kPyramidBase;
+    bool               m_pyramidDirty = false;
+    static constexpr std::size_t kAsyncPeakSamples = std::size_t{1} << 20;
+    struct PeakJob;
+    std::unique_ptr<PeakJob> m_peakJob;   // async build in flight
+    std::vector<float> m_pyramid[kPyramidLevels];
+    std::size_t        m_pyramidBlocks[kPyramidLevels] = {};
+
+    // Streaming state. m_samples then holds the last m_numFrames frames as
+    // a ring (absolute frame f lives at f % m_numFrames). Column k covers
+    // absolute frames [k * F, (k + 1) * F) and is kept in slot k % columns
+    // of m_streamPeaks, laid out like m_peaks; rebuildPeaks() unrolls the
+    // newest `columns` of them into m_peaks.
+    std::unique_ptr<SpscSampleRing> m_stream;
+    std::uint64_t      m_streamTotal           = 0;  // frames drained so far
+    std::vector<float> m_streamPeaks;
+    int                m_streamColumns         = 0;  // 0 == rebuild on next render
+    std::size_t        m_streamFramesPerColumn = 0;
+    bool               m_streamSum             = false;
+
     // Cached peaks: m_peaks[ch * numColumns * 2 + col * 2 + {0,1}] = {min,max}.
     std::vector<float> m_peaks;
     std::size_t        m_peakChannels = 0;
     int                m_peakColumns  = 0;
     Vec2f              m_peakBoundsSize = {0.f, 0.f};
     bool               m_peaksDirty   = true;
+
+    // GPU copy of m_peaks (Renderer::createPeakTexture), re-uploaded after
+    // each rebuild. m_peakTexMiss remembers a size the renderer refused so
+    // it isn't retried every frame.
+    uint16_t           m_peakTexture     = 0xFFFFu;
+    uint16_t           m_peakTexColumns  = 0;
+    uint16_t           m_peakTexLanes    = 0;
+    bool               m_peakTexDirty    = true;
+    std::uint32_t      m_peakTexMiss     = 0;
 };
 
 } // namespace uilo
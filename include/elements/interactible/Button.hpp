@@ -18,17 +18,17 @@ public:
     ButtonOptions& setLabel(Text* t)             { m_label    = t; return *this; }
 
     Color getColor()    const { return m_color; }
-    const std::string& getColorRole() const { return m_colorRole; }
+    const Role&        getColorRole() const { return m_colorRole; }
     const Gradient&    getGradient()     const { return m_gradient; }
-    const std::string& getGradientRole() const { return m_gradientRole; }
+    const Role&        getGradientRole() const { return m_gradientRole; }
     float     getRounding() const { return m_rounding; }
     Text*     getLabel()    const { return m_label; }
 
 private:
     Color m_color    = Color{0,0,0,0};
-    std::string m_colorRole;
+    Role        m_colorRole;
     Gradient    m_gradient;
-    std::string m_gradientRole;
+    Role        m_gradientRole;
     float     m_rounding = 0.f;
     Text*     m_label    = nullptr;
 };
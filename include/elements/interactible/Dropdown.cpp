@@ -1,19 +1,65 @@
 #include "Dropdown.hpp"
 #include "../../UILO.hpp"
+#include "../../utils/Utf8.hpp"
 
 #include <algorithm>
+#include <cctype>
 
 namespace uilo {
 
+namespace {
+
+// ASCII case-insensitive substring test for type-ahead; no allocation.
+bool containsFolded(std::string_view hay, std::string_view needle) {
+    if (needle.empty()) return true;
+    auto same = [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) ==
+               std::tolower(static_cast<unsigned char>(b));
+    };
+    return std::search(hay.begin(), hay.end(), needle.begin(), needle.end(), same) != hay.end();
+}
+
+}
+
 Dropdown::Dropdown(
     Modifier modifier, DropdownOptions options,
     std::initializer_list<std::string> items,
     const std::string& name
-): m_options(std::move(options)), m_items(items) {
-    m_modifier = modifier;
-    m_name     = name;
-    m_type     = ElementType::Dropdown;
+): m_options(std::move(options)), m_ownedItems(items) {
+    m_modifier  = modifier;
+    m_name      = name;
+    m_type      = ElementType::Dropdown;
+    m_itemCount = m_ownedItems.size();
+    m_itemAt    = [this](size_t i) { return std::string_view(m_ownedItems[i]); };
+    buildParts();
+}
+
+Dropdown::Dropdown(
+    Modifier modifier, DropdownOptions options,
+    std::span<const std::string> items,
+    const std::string& name
+): m_options(std::move(options)) {
+    m_modifier  = modifier;
+    m_name      = name;
+    m_type      = ElementType::Dropdown;
+    m_itemCount = items.size();
+    m_itemAt    = [items](size_t i) { return std::string_view(items[i]); };
+    buildParts();
+}
 
+Dropdown::Dropdown(
+    Modifier modifier, DropdownOptions options,
+    size_t itemCount, DropdownItemFn itemAt,
+    const std::string& name
+): m_options(std::move(options)), m_itemAt(std::move(itemAt)) {
+    m_modifier  = modifier;
+    m_name      = name;
+    m_type      = ElementType::Dropdown;
+    m_itemCount = m_itemAt ? itemCount : 0;
+    buildParts();
+}
+
+void Dropdown::buildParts() {
     // --- Header label ---
     TextOptions headerTextOpts;
     if (!m_options.getFontPath().empty()) headerTextOpts.setFont(m_options.getFontPath());
@@ -40,62 +86,90 @@ Dropdown::Dropdown(
             .setLabel(m_headerLabel),
         "");
 
-    // --- Popup column (empty children; items added via addElement below) ---
-    m_popup = new Column(
+    // --- Popup list: rows are created on demand (only as many as fit in
+    //     the popup) and rebound as the list scrolls or is filtered ---
+    m_popup = new VirtualColumn(
         Modifier().setWidth({100.f, true}).setHeight({100.f, true}),
-        ColumnOptions()
-            .setScrollable(true)
+        VirtualListOptions()
+            .setItemCount(m_itemCount)
+            .setItemExtent(m_options.getItemHeight() + m_options.getDividerThickness())
             .setColor(m_options.getPopupColor())
             .setColorRole(m_options.getPopupColorRole())
-            .setRounding(m_options.getPopupRounding()),
-        contains{}, "");
-
-    // --- Item buttons ---
-    for (size_t i = 0; i < m_items.size(); ++i) {
-        TextOptions itemTextOpts;
-        if (!m_options.getFontPath().empty()) itemTextOpts.setFont(m_options.getFontPath());
-        itemTextOpts
-            .setContent(m_items[i]);
-        if (m_options.hasCharSize()) itemTextOpts.setCharSize(m_options.getCharSize());
-        itemTextOpts
-            .setColor(m_options.getTextColor())
-            .setColorRole(m_options.getTextColorRole())
-            .setTextAlignX(m_options.getPopupTextAlignX())
-            .setTextAlignY(m_options.getPopupTextAlignY());
-
-        Text* txt = new Text(
+            .setRounding(m_options.getPopupRounding())
+            .setCreateItem([this]() { return createRow(); })
+            .setBindItem([this](Element* e, size_t pos) {
+                for (size_t k = 0; k < m_rows.size(); ++k)
+                    if (m_rows[k].root == e) { bindRow(k, pos); return; }
+            }),
+        "");
+}
+
+/*
+    createRow():
+    - Params:   none
+    - Returns:  Element*
+    - Desc:     Builds one recyclable popup row: an item button with its
+                label, wrapped in a Column with the divider below it when
+                dividers are on. The click resolves whatever position the
+                row is bound to at that moment.
+*/
+Element* Dropdown::createRow() {
+    TextOptions itemTextOpts;
+    if (!m_options.getFontPath().empty()) itemTextOpts.setFont(m_options.getFontPath());
+    if (m_options.hasCharSize()) itemTextOpts.setCharSize(m_options.getCharSize());
+    itemTextOpts
+        .setColor(m_options.getTextColor())
+        .setColorRole(m_options.getTextColorRole())
+        .setTextAlignX(m_options.getPopupTextAlignX())
+        .setTextAlignY(m_options.getPopupTextAlignY());
+
+    PopupRow row;
+    row.label = new Text(
+        Modifier().setWidth({100.f, true}).setHeight({100.f, true}),
+        itemTextOpts, "");
+
+    const size_t slot = m_rows.size();
+    row.button = new Button(
+        Modifier()
+            .setWidth({100.f, true})
+            .setHeight({m_options.getItemHeight(), false})
+            .setOnLeftClick([this, slot]() { pick(m_rows[slot].pos); }),
+        ButtonOptions()
+            .setColor(m_options.getItemColor())
+            .setColorRole(m_options.getItemColorRole())
+            .setRounding(m_options.getItemRounding())
+            .setLabel(row.label),
+        "");
+
+    row.root = row.button;
+    if (m_options.getDividerThickness() > 0.f) {
+        row.divider = new Spacer(
+            Modifier().setWidth({100.f, true}).setHeight({m_options.getDividerThickness(), false}),
+            SpacerOptions().setColor(m_options.getDividerColor()).setColorRole(m_options.getDividerColorRole()));
+        row.root = new Column(
             Modifier().setWidth({100.f, true}).setHeight({100.f, true}),
-            itemTextOpts, "");
-
-        const size_t idx = i;
-        Button* btn = new Button(
-            Modifier()
-                .setWidth({100.f, true})
-                .setHeight({m_options.getItemHeight(), false})
-                .setOnLeftClick([this, idx]() {
-                    setSelectedIndex(static_cast<int>(idx));
-                    closePopup();
-                }),
-            ButtonOptions()
-                .setColor(m_options.getItemColor())
-                .setColorRole(m_options.getItemColorRole())
-                .setRounding(m_options.getItemRounding())
-                .setLabel(txt),
-            "");
-
-        m_popup->addElement(btn);
-        m_itemTexts.push_back(txt);
-        m_itemButtons.push_back(btn);
-
-        // Insert a divider spacer after every item except the last
-        if (m_options.getDividerThickness() > 0.f && i + 1 < m_items.size()) {
-            Spacer* div = new Spacer(
-                Modifier().setWidth({100.f, true}).setHeight({m_options.getDividerThickness(), false}),
-                SpacerOptions().setColor(m_options.getDividerColor()).setColorRole(m_options.getDividerColorRole()));
-            m_popup->addElement(div);
-            m_dividers.push_back(div);
-        }
+            ColumnOptions(),
+            contains{ row.button, row.divider }, "");
     }
+    m_rows.push_back(row);
+    return row.root;
+}
+
+void Dropdown::bindRow(size_t slot, size_t pos) {
+    PopupRow& row = m_rows[slot];
+    row.pos = pos;
+    m_scratch.assign(getItem(itemAtPos(pos)));
+    row.label->setString(m_scratch);
+
+    const bool hot = static_cast<int>(pos) == m_hoveredItem;
+    row.button->setOptions(
+        ButtonOptions()
+            .setColor(hot ? m_options.getItemHoverColor() : m_options.getItemColor())
+            .setColorRole(hot ? m_options.getItemHoverColorRole() : m_options.getItemColorRole())
+            .setRounding(m_options.getItemRounding())
+            .setLabel(row.label));
+    // No divider after the last item.
+    if (row.divider) row.divider->getModifier().setVisible(pos + 1 < visibleCount());
 }
 
 void Dropdown::setUILO(UILO& uiloRef) {
@@ -104,35 +178,128 @@ void Dropdown::setUILO(UILO& uiloRef) {
     m_popup->setUILO(uiloRef); 
 }
 
+void Dropdown::collectSubtree(std::vector<Element*>& out) {
+    out.push_back(this);
+    m_header->collectSubtree(out);
+    m_popup->collectSubtree(out);
+}
+
+std::string_view Dropdown::getItem(size_t i) const {
+    if (i >= m_itemCount || !m_itemAt) return {};
+    return m_itemAt(i);
+}
+
+void Dropdown::setItems(std::span<const std::string> items) {
+    m_ownedItems.clear();
+    setItems(items.size(), [items](size_t i) { return std::string_view(items[i]); });
+}
+
+void Dropdown::setItems(size_t itemCount, DropdownItemFn itemAt) {
+    if (m_isOpen) closePopup();
+    m_itemAt    = std::move(itemAt);
+    m_itemCount = m_itemAt ? itemCount : 0;
+    m_query.clear();
+    m_filtering = false;
+    m_filtered.clear();
+    if (m_selectedIndex >= 0 && static_cast<size_t>(m_selectedIndex) < m_itemCount) {
+        m_selectedText.assign(getItem(static_cast<size_t>(m_selectedIndex)));
+    } else {
+        m_selectedIndex = -1;
+        m_selectedText.clear();
+    }
+    m_popup->setItemCount(m_itemCount);
+    updateHeaderLabel();
+}
+
 void Dropdown::updateHeaderLabel() {
+    // While filtering the header echoes what has been typed.
     const std::string& txt =
-        (m_selectedIndex >= 0 && static_cast<size_t>(m_selectedIndex) < m_items.size())
-        ? m_items[static_cast<size_t>(m_selectedIndex)]
-        : m_options.getPlaceholder();
+        (m_isOpen && !m_query.empty()) ? m_query
+        : m_selectedIndex >= 0         ? m_selectedText
+                                       : m_options.getPlaceholder();
     m_headerLabel->setString(txt);
-    m_dirty = true;
+    markDirty();
 }
 
 void Dropdown::setSelectedIndex(int idx) {
-    if (idx < 0 || static_cast<size_t>(idx) >= m_items.size()) return;
+    if (idx < 0 || static_cast<size_t>(idx) >= m_itemCount) return;
     m_selectedIndex = idx;
+    m_selectedText.assign(getItem(static_cast<size_t>(idx)));
     updateHeaderLabel();
     if (m_options.getOnItemChanged())
-        m_options.getOnItemChanged()(m_items[static_cast<size_t>(idx)]);
+        m_options.getOnItemChanged()(m_selectedText);
+}
+
+size_t Dropdown::visibleCount() const {
+    return m_filtering ? m_filtered.size() : m_itemCount;
+}
+
+size_t Dropdown::itemAtPos(size_t pos) const {
+    if (!m_filtering) return pos;
+    return pos < m_filtered.size() ? m_filtered[pos] : kNoRow;
+}
+
+/*
+    applyFilter(bool narrowing):
+    - Params:   bool narrowing
+    - Returns:  void
+    - Desc:     Recomputes the positions matching m_query. When the query
+                only grew, the current matches are narrowed in place
+                instead of rescanning every item; either way the popup's
+                existing rows are just rebound to the new positions.
+*/
+void Dropdown::applyFilter(bool narrowing) {
+    if (m_query.empty()) {
+        m_filtering = false;
+        m_filtered.clear();
+    } else if (narrowing && m_filtering) {
+        m_filtered.erase(std::remove_if(m_filtered.begin(), m_filtered.end(),
+                             [this](uint32_t i) { return !containsFolded(getItem(i), m_query); }),
+                         m_filtered.end());
+    } else {
+        m_filtered.clear();
+        for (size_t i = 0; i < m_itemCount; ++i)
+            if (containsFolded(getItem(i), m_query))
+                m_filtered.push_back(static_cast<uint32_t>(i));
+        m_filtering = true;
+    }
+
+    // Highlight the first match so Enter picks it.
+    m_hoveredItem = (m_filtering && !m_filtered.empty()) ? 0 : -1;
+    m_popup->setItemCount(visibleCount());
+    m_popup->setScrollOffset(0.f);
+    updateHeaderLabel();
+}
+
+void Dropdown::setHighlight(int pos, bool scrollIntoView) {
+    const int count = static_cast<int>(visibleCount());
+    if (pos >= count) pos = count - 1;
+    if (pos == m_hoveredItem) return;
+    if (m_hoveredItem >= 0) m_popup->refreshItem(static_cast<size_t>(m_hoveredItem));
+    m_hoveredItem = pos;
+    if (pos < 0) return;
+    m_popup->refreshItem(static_cast<size_t>(pos));
+
+    if (!scrollIntoView) return;
+    const size_t p      = static_cast<size_t>(pos);
+    const size_t inView = static_cast<size_t>(std::max(1, std::min(m_options.getMaxItems(), count)));
+    const size_t first  = m_popup->getFirstVisibleItem();
+    if (p < first)               m_popup->scrollToItem(p);
+    else if (p >= first + inView) m_popup->scrollToItem(p + 1 - inView);
 }
 
-const std::string& Dropdown::getSelectedItem() const {
-    static const std::string empty;
-    if (m_selectedIndex < 0 || static_cast<size_t>(m_selectedIndex) >= m_items.size())
-        return empty;
-    return m_items[static_cast<size_t>(m_selectedIndex)];
+void Dropdown::pick(size_t pos) {
+    const size_t item = itemAtPos(pos);
+    if (item >= m_itemCount) return;
+    setSelectedIndex(static_cast<int>(item));
+    closePopup();
 }
 
 Rectf Dropdown::computePopupBounds() const {
     const float scale      = m_uiloRef ? m_uiloRef->getScale() : 1.f;
     const float itemH      = m_options.getItemHeight() * scale;
     const float divH       = m_options.getDividerThickness() * scale;
-    const size_t nItems    = m_items.size();
+    const size_t nItems    = visibleCount();
     const size_t nDividers = nItems > 1 ? nItems - 1 : 0;
     const float totalH     = static_cast<float>(nItems) * itemH
                            + static_cast<float>(nDividers) * divH;
@@ -157,25 +324,72 @@ Rectf Dropdown::computePopupBounds() const {
 void Dropdown::openPopup() {
     if (!m_uiloRef) return;
     m_isOpen = true;
+    if (m_selectedIndex >= 0) m_popup->scrollToItem(static_cast<size_t>(m_selectedIndex));
     Rectf popupBounds = computePopupBounds();
     m_popup->tick(popupBounds, 0.f);
     m_uiloRef->registerOverlay(m_popup, [this]() { closePopup(); });
 }
 
-void Dropdown::closePopup() {
+void Dropdown::closePopup(bool releaseFocus) {
     m_isOpen        = false;
     m_justDismissed = true;
 
-    if (m_hoveredItem >= 0 && static_cast<size_t>(m_hoveredItem) < m_itemButtons.size()) {
-        m_itemButtons[static_cast<size_t>(m_hoveredItem)]->setOptions(
-            ButtonOptions()
-                .setColor(m_options.getItemColor())
-                .setRounding(m_options.getItemRounding())
-                .setLabel(m_itemTexts[static_cast<size_t>(m_hoveredItem)]));
-    }
+    const bool hadHighlight = m_hoveredItem >= 0;
     m_hoveredItem = -1;
+    if (m_filtering) {
+        m_query.clear();
+        applyFilter(false);
+    } else if (hadHighlight) {
+        m_popup->refresh();
+    }
+    updateHeaderLabel();
 
-    if (m_uiloRef) m_uiloRef->unregisterOverlay(m_popup);
+    if (!m_uiloRef) return;
+    m_uiloRef->unregisterOverlay(m_popup);
+    if (releaseFocus && m_uiloRef->getCurrInteractible() == this)
+        m_uiloRef->setCurrInteractible(nullptr);
+}
+
+void Dropdown::onDeactivate() {
+    if (m_isOpen) closePopup(false);
+}
+
+void Dropdown::handleTextInput(char32_t unicode) {
+    if (!m_isOpen || !m_options.getTypeAhead()) return;
+    if (unicode < 0x20 || unicode == 0x7F) return;
+    m_query += u32ToUtf8(std::u32string_view(&unicode, 1));
+    applyFilter(true);
+}
+
+void Dropdown::handleKeyInput(SDL_Keycode key, bool /* shift */, bool /* ctrl */) {
+    if (!m_isOpen) return;
+    const int count = static_cast<int>(visibleCount());
+    const int page  = std::max(1, m_options.getMaxItems());
+    switch (key) {
+        case SDLK_ESCAPE:
+            closePopup();
+            break;
+        case SDLK_UP:       setHighlight(std::max(0, m_hoveredItem - 1), true);    break;
+        case SDLK_DOWN:     setHighlight(m_hoveredItem + 1, true);                 break;
+        case SDLK_PAGEUP:   setHighlight(std::max(0, m_hoveredItem - page), true); break;
+        case SDLK_PAGEDOWN: setHighlight(m_hoveredItem + page, true);              break;
+        case SDLK_HOME:     setHighlight(count > 0 ? 0 : -1, true);                break;
+        case SDLK_END:      setHighlight(count - 1, true);                         break;
+        case SDLK_RETURN:
+        case SDLK_KP_ENTER:
+            if (m_hoveredItem >= 0) pick(static_cast<size_t>(m_hoveredItem));
+            break;
+        case SDLK_BACKSPACE:
+            if (m_query.empty()) break;
+            // Drop one codepoint: any continuation bytes, then its lead byte.
+            while (!m_query.empty() && (static_cast<unsigned char>(m_query.back()) & 0xC0) == 0x80)
+                m_query.pop_back();
+            if (!m_query.empty()) m_query.pop_back();
+            applyFilter(false);
+            break;
+        default:
+            break;
+    }
 }
 
 void Dropdown::update(Rectf& parentBounds, float dt) {
@@ -192,49 +406,40 @@ void Dropdown::update(Rectf& parentBounds, float dt) {
     m_header->tick(m_bounds, dt);
 
     if (m_isOpen) {
-        Rectf popupBounds = computePopupBounds();
-        m_popup->tick(popupBounds, dt);
-
+        // Hover follows the mouse only when it moves, so a pointer resting
+        // over the popup doesn't undo keyboard navigation. Rows hold the
+        // position they were last bound to; parked rows have empty bounds.
         const Vec2f mousePos = m_uiloRef ? m_uiloRef->getMousePosition() : Vec2f{};
-        int newHovered = -1;
-        for (size_t i = 0; i < m_itemButtons.size(); ++i) {
-            if (m_itemButtons[i]->getBounds().contains(mousePos)) {
-                newHovered = static_cast<int>(i);
-                break;
-            }
-        }
-
-        if (newHovered != m_hoveredItem) {
-            if (m_hoveredItem >= 0 && static_cast<size_t>(m_hoveredItem) < m_itemButtons.size()) {
-                m_itemButtons[static_cast<size_t>(m_hoveredItem)]->setOptions(
-                    ButtonOptions()
-                        .setColor(m_options.getItemColor())
-                        .setColorRole(m_options.getItemColorRole())
-                        .setRounding(m_options.getItemRounding())
-                        .setLabel(m_itemTexts[static_cast<size_t>(m_hoveredItem)]));
+        if (mousePos != m_lastMouse) {
+            m_lastMouse = mousePos;
+            int newHovered = -1;
+            for (const auto& row : m_rows) {
+                if (row.pos != kNoRow && row.root->getBounds().contains(mousePos)) {
+                    newHovered = static_cast<int>(row.pos);
+                    break;
                 }
-                if (newHovered >= 0) {
-                m_itemButtons[static_cast<size_t>(newHovered)]->setOptions(
-                    ButtonOptions()
-                        .setColor(m_options.getItemHoverColor())
-                        .setColorRole(m_options.getItemHoverColorRole())
-                        .setRounding(m_options.getItemRounding())
-                        .setLabel(m_itemTexts[static_cast<size_t>(newHovered)]));
             }
-            m_hoveredItem = newHovered;
+            setHighlight(newHovered, false);
         }
+
+        Rectf popupBounds = computePopupBounds();
+        m_popup->tick(popupBounds, dt);
     }
 }
 
 void Dropdown::render() {
     // Material is mirrored onto m_header / m_popup in update().
-    m_header->render();
+    m_header->paint();
     m_dirty = false;
 }
 
 bool Dropdown::checkLeftClick(const Vec2f& mousePosition) {
     if (!m_bounds.contains(mousePosition)) return false;
-    if (!m_isOpen && !m_justDismissed) openPopup();
+    if (!m_isOpen && !m_justDismissed) {
+        openPopup();
+        // Focus routes arrow keys and type-ahead text here while open.
+        if (m_isOpen) m_uiloRef->setCurrInteractible(this);
+    }
     return true;
 }
 
@@ -1,15 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <vector>
+#include <span>
 #include <string>
+#include <string_view>
 #include <optional>
 
-#include "../Element.hpp"
+#include "Interactible.hpp"
 #include "../decoration/Text.hpp"
 #include "../decoration/Spacer.hpp"
 #include "Button.hpp"
 #include "../containers/Column.hpp"
+#include "../containers/VirtualList.hpp"
 
 namespace uilo {
 
@@ -50,19 +54,24 @@ public:
         m_popupTextAlignX = x; m_popupTextAlignY = y; return *this;
     }
 
+    // While the popup is open, typed text narrows it to the items that
+    // contain it (case-insensitive); Backspace widens, Enter picks the
+    // highlighted item. Arrow keys move the highlight either way.
+    DropdownOptions& setTypeAhead(bool v)            { m_typeAhead = v;        return *this; }
+
     DropdownOptions& setOnItemChanged(std::function<void(const std::string&)> f) {
         m_onItemChanged = std::move(f); return *this;
     }
 
     Color        getHeaderColor()     const { return m_headerColor; }
-    const std::string& getHeaderColorRole() const { return m_headerColorRole; }
+    const Role&        getHeaderColorRole() const { return m_headerColorRole; }
     float        getHeaderRounding()  const { return m_headerRounding; }
     Color        getPopupColor()      const { return m_popupColor; }
-    const std::string& getPopupColorRole() const { return m_popupColorRole; }
+    const Role&        getPopupColorRole() const { return m_popupColorRole; }
     Color        getItemColor()       const { return m_itemColor; }
-    const std::string& getItemColorRole() const { return m_itemColorRole; }
+    const Role&        getItemColorRole() const { return m_itemColorRole; }
     Color        getItemHoverColor()  const { return m_itemHoverColor; }
-    const std::string& getItemHoverColorRole() const { return m_itemHoverColorRole; }
+    const Role&        getItemHoverColorRole() const { return m_itemHoverColorRole; }
     float        getItemHeight()      const { return m_itemHeight; }
     int          getMaxItems()       const { return m_maxItems; }
     float        getItemRounding()    const { return m_itemRounding; }
@@ -70,84 +79,149 @@ public:
     unsigned int getCharSize()        const { return m_charSize.value_or(14); }
     bool         hasCharSize()        const { return m_charSize.has_value(); }
     Color        getTextColor()       const { return m_textColor; }
-    const std::string& getTextColorRole() const { return m_textColorRole; }
+    const Role&        getTextColorRole() const { return m_textColorRole; }
     Color        getHeaderTextColor() const { return m_headerTextColor; }
-    const std::string& getHeaderTextColorRole() const { return m_headerTextColorRole; }
+    const Role&        getHeaderTextColorRole() const { return m_headerTextColorRole; }
     const std::string& getPlaceholder() const { return m_placeholder; }
     const std::string& getFontPath()  const { return m_fontPath; }
     float        getSpacer()            const { return m_spacer; }
     float        getDividerThickness()  const { return m_dividerThickness; }
     Color        getDividerColor()      const { return m_dividerColor; }
-    const std::string& getDividerColorRole() const { return m_dividerColorRole; }
+    const Role&        getDividerColorRole() const { return m_dividerColorRole; }
     Align        getHeaderTextAlignX()  const { return m_headerTextAlignX; }
     Align        getHeaderTextAlignY()  const { return m_headerTextAlignY; }
     Align        getPopupTextAlignX()   const { return m_popupTextAlignX; }
     Align        getPopupTextAlignY()   const { return m_popupTextAlignY; }
+    bool         getTypeAhead()         const { return m_typeAhead; }
     const std::function<void(const std::string&)>& getOnItemChanged() const { return m_onItemChanged; }
 
 private:
     Color        m_headerColor     = Color{60, 60, 60, 255};
-    std::string  m_headerColorRole;
+    Role         m_headerColorRole;
     float        m_headerRounding  = 0.f;
     Color        m_popupColor      = Color{50, 50, 50, 255};
-    std::string  m_popupColorRole;
+    Role         m_popupColorRole;
     Color        m_itemColor       = Color{0, 0, 0, 0};
-    std::string  m_itemColorRole;
+    Role         m_itemColorRole;
     Color        m_itemHoverColor  = Color{80, 80, 80, 255};
-    std::string  m_itemHoverColorRole;
+    Role         m_itemHoverColorRole;
     float        m_itemHeight      = 30.f;
     int          m_maxItems        = 6;
     float        m_itemRounding    = 0.f;
     float        m_popupRounding   = 0.f;
     std::optional<unsigned int> m_charSize;
     Color        m_textColor       = Color::White;
-    std::string  m_textColorRole;
+    Role         m_textColorRole;
     Color        m_headerTextColor = Color::White;
-    std::string  m_headerTextColorRole;
+    Role         m_headerTextColorRole;
     std::string  m_placeholder;
     std::string  m_fontPath;
     float        m_spacer             = 0.f;
     float        m_dividerThickness   = 0.f;
     Color        m_dividerColor       = Color{80, 80, 80, 255};
-    std::string  m_dividerColorRole;
+    Role         m_dividerColorRole;
     Align        m_headerTextAlignX   = Align::CenterX;
     Align        m_headerTextAlignY   = Align::CenterY;
     Align        m_popupTextAlignX    = Align::Left;
     Align        m_popupTextAlignY    = Align::CenterY;
+    bool         m_typeAhead          = true;
     std::function<void(const std::string&)> m_onItemChanged;
 };
 
-class Dropdown : public Element {
+// Reads item `i` of a callback item source. The view only has to stay
+// valid until the next call.
+using DropdownItemFn = std::function<std::string_view(size_t)>;
+
+// Dropdown: a header button that opens a popup list of items. The popup
+// is a VirtualColumn, so only the rows in view exist no matter how many
+// items there are. Items come from an owned copy (initializer list), a
+// caller-owned span, or a count plus a callback; the last two are read in
+// place and must outlive the dropdown (or the next setItems()).
+class Dropdown : public Interactible {
 public:
     Dropdown(Modifier modifier, DropdownOptions options,
              std::initializer_list<std::string> items,
              const std::string& name = "");
+    Dropdown(Modifier modifier, DropdownOptions options,
+             std::span<const std::string> items,
+             const std::string& name = "");
+    Dropdown(Modifier modifier, DropdownOptions options,
+             size_t itemCount, DropdownItemFn itemAt,
+             const std::string& name = "");
 
     void setUILO(UILO& uiloRef) override;
+    void collectSubtree(std::vector<Element*>& out) override;
     void update(Rectf& parentBounds, float dt) override;
     void render() override;
     bool checkLeftClick(const Vec2f& mousePosition) override;
     bool checkHover(const Vec2f& mousePosition) override;
 
+    void onDeactivate() override;
+    void handleTextInput(char32_t unicode) override;
+    void handleKeyInput(SDL_Keycode key, bool shift, bool ctrl) override;
+    bool wantsTextInput() const override { return m_isOpen && m_options.getTypeAhead(); }
+
+    // Replace the item source. The selection is kept when it's still in
+    // range; an open popup closes.
+    void setItems(std::span<const std::string> items);
+    void setItems(size_t itemCount, DropdownItemFn itemAt);
+
+    size_t             getItemCount()     const { return m_itemCount; }
+    std::string_view   getItem(size_t i)  const;
     int                getSelectedIndex() const { return m_selectedIndex; }
-    const std::string& getSelectedItem()  const;
+    const std::string& getSelectedItem()  const { return m_selectedText; }
     void               setSelectedIndex(int idx);
 
+    // Current type-ahead text; empty when the popup isn't filtered.
+    const std::string& getFilter() const { return m_query; }
+
     const DropdownOptions& getOptions() const { return m_options; }
     DropdownOptions&       getOptions()       { return m_options; }
 
 private:
+    static constexpr size_t kNoRow = static_cast<size_t>(-1);
+
+    // One recycled popup row and the filtered position it shows.
+    struct PopupRow {
+        Element* root   = nullptr;   // child of m_popup
+        Button* button  = nullptr;
+        Text*   label   = nullptr;
+        Spacer* divider = nullptr;
+        size_t  pos     = kNoRow;
+    };
+
+    // Tracks the hovered item and dismissal state every frame.
+    bool wantsUpdate() const override { return true; }
+    void          buildParts();
+    Element*      createRow();
+    void          bindRow(size_t slot, size_t pos);
     Rectf computePopupBounds() const;
     void          openPopup();
-    void          closePopup();
+    void          closePopup(bool releaseFocus = true);
     void          updateHeaderLabel();
 
+    // Type-ahead. Positions index the (possibly filtered) popup list.
+    size_t        visibleCount() const;
+    size_t        itemAtPos(size_t pos) const;
+    void          applyFilter(bool narrowing);
+    void          setHighlight(int pos, bool scrollIntoView);
+    void          pick(size_t pos);
+
     DropdownOptions          m_options;
-    std::vector<std::string> m_items;
+    std::vector<std::string> m_ownedItems;
+    DropdownItemFn           m_itemAt;
+    size_t                   m_itemCount = 0;
     int  m_selectedIndex = -1;
+    std::string m_selectedText;
     bool m_isOpen        = false;
     bool m_justDismissed = false;
     int  m_hoveredItem   = -1;
+    Vec2f m_lastMouse;
+
+    std::string           m_query;
+    bool                  m_filtering = false;
+    std::vector<uint32_t> m_filtered;     // item indices matching m_query
+    std::string           m_scratch;      // reused for row labels
 
     // TODO: font handle (FreeType/fontstash) — deferred
     // const sf::Font* m_fontPtr = nullptr;
@@ -155,10 +229,8 @@ private:
     Text*   m_headerLabel  = nullptr;
     Button* m_header       = nullptr;
 
-    std::vector<Text*>   m_itemTexts;
-    std::vector<Button*> m_itemButtons;
-    std::vector<Spacer*> m_dividers;
-    Column*              m_popup = nullptr;
+    std::vector<PopupRow> m_rows;
+    VirtualColumn*        m_popup = nullptr;
 };
 
 } // namespace uilo
@@ -1,5 +1,6 @@
 #include "Knob.hpp"
 #include "../../UILO.hpp"
+#include "../../Binding.hpp"
 #include "../../utils/RenderUtils.hpp"
 
 #include <algorithm>
@@ -136,8 +137,10 @@ void Knob::render() {
         const float start  = m_options.getStartAngle();
         const float end    = start + sweep;
 
+        // The track only changes with the bounds or options, so its
+        // tessellation is cached; the value arc below is re-emitted.
         renderer.drawArc({cx, cy}, innerR, outerR, start, end,
-                         trackColor, trackSegs);
+                         trackColor, trackSegs, true);
 
         const float curAngle  = angleForValue(m_value);
         const float fillSweep = curAngle - start;
@@ -203,6 +206,7 @@ bool Knob::checkLeftClick(const Vec2f& mousePosition) {
     }
 
     m_dragging     = true;
+    markDirty();
     m_dragStartY   = mousePosition.y;
     m_dragStartVal = m_value;
     if (m_modifier.getOnLeftClick()) m_modifier.getOnLeftClick()(this);
@@ -249,6 +253,13 @@ void Knob::onDeactivate() { m_dragging = false; }
 
 void Knob::setValue(float v) { applyValue(v); }
 
+bool Knob::bindValue(Binding<float>& value) {
+    return value.bind(this, [](Element* e, const float& v) {
+        auto* self = static_cast<Knob*>(e);
+        if (!self->m_dragging) self->applyValue(v);
+    });
+}
+
 void Knob::applyValue(float raw) {
     float v = std::clamp(raw, m_options.getMin(), m_options.getMax());
     if (m_options.getStep() > 0.f) {
@@ -63,15 +63,15 @@ public:
     KnobOptions& setOnValueChanged(KnobValueChangedFuncPtr f) { m_onValueChanged = std::move(f); return *this; }
 
     Color getBodyColor()        const { return m_bodyColor; }
-    const std::string& getBodyColorRole() const { return m_bodyColorRole; }
+    const Role&        getBodyColorRole() const { return m_bodyColorRole; }
     Color getOutlineColor()     const { return m_outlineColor; }
-    const std::string& getOutlineColorRole() const { return m_outlineColorRole; }
+    const Role&        getOutlineColorRole() const { return m_outlineColorRole; }
     Color getTrackColor()       const { return m_trackColor; }
-    const std::string& getTrackColorRole() const { return m_trackColorRole; }
+    const Role&        getTrackColorRole() const { return m_trackColorRole; }
     Color getArcColor()         const { return m_arcColor; }
-    const std::string& getArcColorRole() const { return m_arcColorRole; }
+    const Role&        getArcColorRole() const { return m_arcColorRole; }
     Color getIndicatorColor()   const { return m_indicatorColor; }
-    const std::string& getIndicatorColorRole() const { return m_indicatorColorRole; }
+    const Role&        getIndicatorColorRole() const { return m_indicatorColorRole; }
     float getOutlineThickness() const { return m_outlineThickness; }
     float getArcThickness()     const { return m_arcThickness; }
     float getIndicatorThickness()const{ return m_indicatorThickness; }
@@ -93,15 +93,15 @@ public:
 
 private:
     Color m_bodyColor          = Color{55, 58, 74};
-    std::string m_bodyColorRole;
+    Role        m_bodyColorRole;
     Color m_outlineColor       = Color::Transparent;
-    std::string m_outlineColorRole;
+    Role        m_outlineColorRole;
     Color m_trackColor         = Color{30, 32, 42};
-    std::string m_trackColorRole;
+    Role        m_trackColorRole;
     Color m_arcColor           = Color{151, 120, 206};
-    std::string m_arcColorRole;
+    Role        m_arcColorRole;
     Color m_indicatorColor     = Color::White;
-    std::string m_indicatorColorRole;
+    Role        m_indicatorColorRole;
     float m_outlineThickness   = 0.f;
     float m_arcThickness       = 4.f;
     float m_indicatorThickness = 2.f;
@@ -139,12 +139,18 @@ public:
 
     void  setValue(float v);
     float getValue() const { return m_value; }
+    // Follows `value` (see Binding.hpp) except while the user is dragging;
+    // false if this Knob isn't attached to a UILO yet.
+    bool  bindValue(Binding<float>& value);
 
     const KnobOptions& getOptions() const { return m_options; }
     KnobOptions&       getOptions()       { return m_options; }
-    void setOptions(const KnobOptions& o) { m_options = o; m_dirty = true; }
+    void setOptions(const KnobOptions& o) { m_options = o; markDirty(); }
 
 private:
+    // Polls the mouse while dragging.
+    bool wantsUpdate() const override { return m_dragging; }
+    bool parallelSafe() const override { return !m_dragging; }
     void  applyValue(float raw);
     // Total signed sweep from start to end along the chosen direction,
     // always in (0, 360]. 0 collapses to 360 to give a full ring.
@@ -153,6 +153,7 @@ bool Resizer::checkLeftClick(const Vec2f& mousePosition) {
     m_dragStartH      = m_target->getBounds().size.y / scale + 2.f * padU;
     m_dragStart       = mousePosition;
     m_dragging        = true;
+    markDirty();
     m_uiloRef->setCurrInteractible(this);
     return true;
 }
@@ -22,7 +22,7 @@ public:
     ResizerDir getDirection()       const { return m_direction; }
     float      getThickness()       const { return m_thickness; }
     Color      getColor()           const { return m_color; }
-    const std::string& getColorRole() const { return m_colorRole; }
+    const Role&        getColorRole() const { return m_colorRole; }
     Dimension  getResizeWidthMin()  const { return m_resizeWidthMin; }
     Dimension  getResizeWidthMax()  const { return m_resizeWidthMax; }
     Dimension  getResizeWidthStep() const { return m_resizeWidthStep; }
@@ -34,7 +34,7 @@ private:
     ResizerDir m_direction       = ResizerDir::Right;
     float      m_thickness       = 8.f;
     Color   m_color = Color{0,0,0,0};
-    std::string m_colorRole;
+    Role        m_colorRole;
     Dimension  m_resizeWidthMin  = {0.f,       false};
     Dimension  m_resizeWidthMax  = {100000.f,  false};
     Dimension  m_resizeWidthStep = {0.f,       false};
@@ -88,6 +88,8 @@ public:
     bool isDragging() const { return m_dragging; }
 
 private:
+    // Polls the mouse while dragging.
+    bool wantsUpdate() const override { return m_dragging; }
     ResizerOptions m_options;
     Element*       m_target           = nullptr;
     Rectf   m_containerBounds;
@@ -1,5 +1,6 @@
 #include "Slider.hpp"
 #include "../../UILO.hpp"
+#include "../../Binding.hpp"
 #include "../../utils/RenderUtils.hpp"
 
 #include <algorithm>
@@ -143,6 +144,7 @@ bool Slider::checkLeftClick(const Vec2f& mousePosition) {
     }
 
     m_dragging = true;
+    markDirty();
     const bool isHoriz = m_options.getOrientation() == SliderOrientation::Horizontal;
     applyValue(isHoriz ? valueFromMouseX(mousePosition.x) : valueFromMouseY(mousePosition.y));
     if (m_modifier.getOnLeftClick()) m_modifier.getOnLeftClick()(this);
@@ -183,6 +185,13 @@ bool Slider::checkScroll(const Vec2f& mousePosition, float delta, bool /*precise
 void Slider::onDeactivate() { m_dragging = false; }
 void Slider::setValue(float value) { applyValue(value); }
 
+bool Slider::bindValue(Binding<float>& value) {
+    return value.bind(this, [](Element* e, const float& v) {
+        auto* self = static_cast<Slider*>(e);
+        if (!self->m_dragging) self->applyValue(v);
+    });
+}
+
 float Slider::valueFromMouseX(float mouseX) const {
     const float hw    = resolveThumbHalfWidth();
     const float left  = m_bounds.position.x + hw;
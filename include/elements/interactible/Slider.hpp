@@ -35,11 +35,11 @@ public:
     SliderOptions& setOrientation(SliderOrientation o)      { m_orientation = o;        return *this; }
 
     Color            getTrackColor()      const { return m_trackColor; }
-    const std::string& getTrackColorRole() const { return m_trackColorRole; }
+    const Role&        getTrackColorRole() const { return m_trackColorRole; }
     Color            getFillColor()       const { return m_fillColor; }
-    const std::string& getFillColorRole()  const { return m_fillColorRole; }
+    const Role&        getFillColorRole()  const { return m_fillColorRole; }
     Color            getThumbColor()      const { return m_thumbColor; }
-    const std::string& getThumbColorRole() const { return m_thumbColorRole; }
+    const Role&        getThumbColorRole() const { return m_thumbColorRole; }
     ThumbShape           getThumbShape()      const { return m_thumbShape; }
     float                getTrackThickness()  const { return m_trackThickness; }
     float                getTrackRounding()   const { return m_trackRounding; }
@@ -56,11 +56,11 @@ public:
 
 private:
     Color            m_trackColor      = Color{60, 60, 60, 255};
-    std::string          m_trackColorRole;
+    Role                 m_trackColorRole;
     Color            m_fillColor       = Color::White;
-    std::string          m_fillColorRole;
+    Role                 m_fillColorRole;
     Color            m_thumbColor      = Color::White;
-    std::string          m_thumbColorRole;
+    Role                 m_thumbColorRole;
     ThumbShape           m_thumbShape      = ThumbShape::Circle;
     float                m_trackThickness  = 0.25f;                     // <=1: fraction of cross-axis size, >1: pixels
     float                m_trackRounding   = 0.f;                       // corner radius of the track bar (px)
@@ -91,12 +91,18 @@ public:
 
     void  setValue(float value);
     float getValue() const { return m_value; }
+    // Follows `value` (see Binding.hpp) except while the user is dragging;
+    // false if this Slider isn't attached to a UILO yet.
+    bool  bindValue(Binding<float>& value);
 
     const SliderOptions& getOptions() const      { return m_options; }
     SliderOptions&       getOptions()            { return m_options; }
-    void setOptions(const SliderOptions& opts)   { m_options = opts; }
+    void setOptions(const SliderOptions& opts)   { m_options = opts; markDirty(); }
 
 private:
+    // Polls the mouse while dragging.
+    bool wantsUpdate() const override { return m_dragging; }
+    bool parallelSafe() const override { return !m_dragging; }
     float valueFromMouseX(float mouseX) const;
     float valueFromMouseY(float mouseY) const;
     void  applyValue(float raw);
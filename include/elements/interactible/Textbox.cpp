@@ -1,6 +1,8 @@
 #include "Textbox.hpp"
 #include "../../UILO.hpp"
 #include "../../renderer/Renderer.hpp"
+#include "../../utils/TextWrap.hpp"
+#include "../../utils/Utf8.hpp"
 
 #include <SDL3/SDL.h>
 #include <algorithm>
@@ -10,63 +12,9 @@
 namespace uilo {
 
 // ---------------------------------------------------------------------------
-// UTF-8 / UTF-32 helpers
+// Helpers
 // ---------------------------------------------------------------------------
 
-static std::string u32ToUtf8(const std::u32string& s) {
-    std::string r;
-    r.reserve(s.size());
-    for (char32_t c : s) {
-        if (c < 0x80u) {
-            r += static_cast<char>(c);
-        } else if (c < 0x800u) {
-            r += static_cast<char>(0xC0 | (c >> 6));
-            r += static_cast<char>(0x80 | (c & 0x3F));
-        } else if (c < 0x10000u) {
-            r += static_cast<char>(0xE0 | (c >> 12));
-            r += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
-            r += static_cast<char>(0x80 | (c & 0x3F));
-        } else {
-            r += static_cast<char>(0xF0 | (c >> 18));
-            r += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
-            r += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
-            r += static_cast<char>(0x80 | (c & 0x3F));
-        }
-    }
-    return r;
-}
-
-static std::u32string utf8ToU32(const std::string& s) {
-    std::u32string r;
-    size_t i = 0;
-    while (i < s.size()) {
-        uint8_t c = static_cast<uint8_t>(s[i]);
-        char32_t cp = 0;
-        if (c < 0x80u) {
-            cp = c; i += 1;
-        } else if (c < 0xE0u && i + 1 < s.size()) {
-            cp = (static_cast<char32_t>(c & 0x1Fu) << 6) |
-                  static_cast<char32_t>(static_cast<uint8_t>(s[i+1]) & 0x3Fu);
-            i += 2;
-        } else if (c < 0xF0u && i + 2 < s.size()) {
-            cp = (static_cast<char32_t>(c & 0x0Fu) << 12) |
-                 (static_cast<char32_t>(static_cast<uint8_t>(s[i+1]) & 0x3Fu) << 6) |
-                  static_cast<char32_t>(static_cast<uint8_t>(s[i+2]) & 0x3Fu);
-            i += 3;
-        } else if (i + 3 < s.size()) {
-            cp = (static_cast<char32_t>(c & 0x07u) << 18) |
-                 (static_cast<char32_t>(static_cast<uint8_t>(s[i+1]) & 0x3Fu) << 12) |
-                 (static_cast<char32_t>(static_cast<uint8_t>(s[i+2]) & 0x3Fu) << 6) |
-                  static_cast<char32_t>(static_cast<uint8_t>(s[i+3]) & 0x3Fu);
-            i += 4;
-        } else {
-            ++i;
-        }
-        if (cp) r += cp;
-    }
-    return r;
-}
-
 static bool isWordChar(char32_t c) {
     return (c >= U'a' && c <= U'z') || (c >= U'A' && c <= U'Z') ||
            (c >= U'0' && c <= U'9') || c == U'_' || c > 127u;
@@ -113,213 +61,188 @@ float Textbox::lineHeight() const {
     return static_cast<float>(cs) * scale * 1.2f;
 }
 
-std::u32string Textbox::displayText() const {
-    if (m_options.getPasswordMode() && !m_text.empty())
-        return std::u32string(m_text.size(), U'*');
-    return m_text;
+size_t Textbox::lineIndexFor(size_t textIdx) const {
+    // Last line starting at or before textIdx.
+    auto it = std::upper_bound(m_lines.begin(), m_lines.end(), textIdx,
+                               [](size_t i, const LineLayout& l) { return i < l.start; });
+    return it == m_lines.begin() ? 0 : (size_t)(it - m_lines.begin()) - 1;
 }
 
 Vec2f Textbox::charScreenPos(size_t idx) const {
-    if (m_charPositions.empty()) return m_textOrigin;
-    const size_t dispIdx = shouldWrap(m_options) ? textToDisplay(idx) : idx;
-    const size_t clamped = std::min(dispIdx, m_charPositions.size() - 1);
-    const Vec2f rel = m_charPositions[clamped];
-    return { m_textOrigin.x + rel.x, m_textOrigin.y + rel.y };
+    if (m_lines.empty()) return m_textOrigin;
+    const LineLayout& line = m_lines[lineIndexFor(idx)];
+    if (line.positions.empty()) return m_textOrigin;
+    const size_t local = std::min(idx - std::min(idx, line.start), line.positions.size() - 1);
+    const Vec2f  rel   = line.positions[local];
+    return { m_textOrigin.x + rel.x,
+             m_textOrigin.y + (float)line.firstRow * lineHeight() + rel.y };
 }
 
 size_t Textbox::hitTestChar(Vec2f screenPos) const {
-    if (m_charPositions.empty() || !m_uiloRef) return 0;
-    const float lh      = std::max(1.f, lineHeight());
-    const size_t dispN  = m_charPositions.size();
-
-    // Pass 1: find which visual line the click is on
-    float bestLineY    = m_textOrigin.y;
-    float bestLineDist = std::numeric_limits<float>::max();
-    for (size_t i = 0; i < dispN; ++i) {
-        const float cy = m_textOrigin.y + m_charPositions[i].y;
-        const float center = cy + lh * 0.5f;
-        const float dy = std::abs(center - screenPos.y);
-        if (dy < bestLineDist) { bestLineDist = dy; bestLineY = cy; }
-    }
-
-    // Pass 2: nearest x on that line
+    if (m_lines.empty() || !m_uiloRef) return 0;
+    const float lh = std::max(1.f, lineHeight());
+
+    // Visual row under the point, clamped to the text, then the hard line
+    // holding that row.
+    const float rowF = std::floor((screenPos.y - m_textOrigin.y) / lh);
+    const int   row  = (int)std::clamp(rowF, 0.f, (float)std::max(0, m_visualRows - 1));
+    auto it = std::upper_bound(m_lines.begin(), m_lines.end(), row,
+                               [](int r, const LineLayout& l) { return r < l.firstRow; });
+    const LineLayout& line = it == m_lines.begin() ? m_lines.front() : *(it - 1);
+    const float rowY = (float)(row - line.firstRow) * lh;
+
+    // Nearest x on that row.
     size_t best = 0;
     float bestXDist = std::numeric_limits<float>::max();
-    for (size_t i = 0; i < dispN; ++i) {
-        const float cy = m_textOrigin.y + m_charPositions[i].y;
-        if (std::abs(cy - bestLineY) > lh * 0.5f) continue;
-        const float cx = m_textOrigin.x + m_charPositions[i].x;
-        const float dx = std::abs(cx - screenPos.x);
+    for (size_t i = 0; i < line.positions.size(); ++i) {
+        const Vec2f p = line.positions[i];
+        if (std::abs(p.y - rowY) > lh * 0.5f) continue;
+        const float dx = std::abs(m_textOrigin.x + p.x - screenPos.x);
         if (dx < bestXDist) { bestXDist = dx; best = i; }
     }
-
-    return shouldWrap(m_options) ? displayToText(best) : best;
+    return line.start + best;
 }
 
 // ---------------------------------------------------------------------------
 // Rebuilds — require a live renderer & font
 // ---------------------------------------------------------------------------
 
-void Textbox::rebuildSfText() {
-    m_textDirty = false;
-    m_charPositions.clear();
-    m_charPositions.push_back({0.f, 0.f});
-    m_displayU32.clear();
-    m_wrappedDisplay.clear();
-
-    if (!m_uiloRef) return;
-    auto& renderer = m_uiloRef->getRenderer();
-    Font font = renderer.loadFont(m_options.getFontPath());
-    if (!font.valid()) return;
-
-    const float scale = m_uiloRef->getScale();
-    const unsigned int cs = m_options.hasCharSize() ? m_options.getCharSize()
-                                                     : std::max(1u, m_autoCharSize);
-    const float pxH = static_cast<float>(cs) * scale;
-
-    // Cache real line height from the font.
-    {
-        TextMetrics ref = renderer.measureText("A", font, pxH);
-        m_lineHeightCache = ref.lineHeight();
-    }
-
-    // Build display (UTF-32) — wrapped or raw.
-    if (shouldWrap(m_options)) {
-        rebuildWrapped();
-        m_lastWrapWidth = textArea().size.x;
-    } else {
-        m_displayU32 = displayText();
-        m_wrappedDisplay = u32ToUtf8(m_displayU32);
-        m_softWrapAt.clear();
+std::vector<Textbox::LineLayout> Textbox::splitLines(size_t from, size_t to) const {
+    std::vector<LineLayout> out;
+    const bool split = !m_options.getPasswordMode();
+    size_t begin = from;
+    for (size_t i = from; i <= to; ++i) {
+        if (i == to || (split && m_text[i] == U'\n')) {
+            LineLayout l;
+            l.start  = begin;
+            l.length = i - begin;
+            out.push_back(std::move(l));
+            begin = i + 1;
+        }
     }
-
-    m_charPositions = renderer.charPositions(m_wrappedDisplay, font, pxH);
-    if (m_charPositions.empty()) m_charPositions.push_back({0.f, 0.f});
+    return out;
 }
 
-// Build m_displayU32 (with soft '\n's) and m_softWrapAt from m_text.
-void Textbox::rebuildWrapped() {
-    m_softWrapAt.clear();
-    m_displayU32.clear();
-    if (!m_uiloRef) { m_displayU32 = m_text; m_wrappedDisplay = u32ToUtf8(m_displayU32); return; }
-    auto& renderer = m_uiloRef->getRenderer();
-    Font font = renderer.loadFont(m_options.getFontPath());
-    if (!font.valid()) {
-        m_displayU32 = m_text;
-        m_wrappedDisplay = u32ToUtf8(m_displayU32);
+void Textbox::editText(size_t pos, size_t eraseCount, std::u32string_view insert) {
+    pos        = std::min(pos, m_text.size());
+    eraseCount = std::min(eraseCount, m_text.size() - pos);
+    if (m_lines.empty() || m_textDirty) {
+        m_text.erase(pos, eraseCount);
+        m_text.insert(pos, insert);
+        m_textDirty = true;
         return;
     }
 
-    const float scale = m_uiloRef->getScale();
+    // Re-split only the hard lines the edit spans; later lines just shift.
+    const size_t a      = lineIndexFor(pos);
+    const size_t b      = lineIndexFor(pos + eraseCount);
+    const size_t from   = m_lines[a].start;
+    const size_t oldEnd = m_lines[b].start + m_lines[b].length;
+    m_text.erase(pos, eraseCount);
+    m_text.insert(pos, insert);
+    const size_t newEnd = oldEnd - eraseCount + insert.size();
+
+    std::vector<LineLayout> fresh = splitLines(from, newEnd);
+    const size_t added = fresh.size();
+    m_lines.erase(m_lines.begin() + (std::ptrdiff_t)a, m_lines.begin() + (std::ptrdiff_t)b + 1);
+    m_lines.insert(m_lines.begin() + (std::ptrdiff_t)a,
+                   std::make_move_iterator(fresh.begin()), std::make_move_iterator(fresh.end()));
+    for (size_t i = a + added; i < m_lines.size(); ++i)
+        m_lines[i].start = m_lines[i].start - eraseCount + insert.size();
+    m_linesDirty = true;
+}
+
+void Textbox::rebuildLayout() {
+    m_textDirty = false;
+    m_lines = splitLines(0, m_text.size());
+    if (m_uiloRef) {
+        auto& renderer = m_uiloRef->getRenderer();
+        Font font = renderer.loadFont(m_options.getFontPath());
+        if (font.valid()) {
+            const unsigned int cs = m_options.hasCharSize() ? m_options.getCharSize()
+                                                             : std::max(1u, m_autoCharSize);
+            const float pxH = static_cast<float>(cs) * m_uiloRef->getScale();
+            // Cache real line height from the font.
+            m_lineHeightCache = renderer.measureText("A", font, pxH).lineHeight();
+        }
+    }
+    if (shouldWrap(m_options)) m_lastWrapWidth = textArea().size.x;
+    layoutLines();
+}
+
+// Wraps and measures the dirty lines, then re-stacks every line's first
+// row. Clean lines keep their positions, so an edit costs the lines it
+// touched plus one pass over the line index.
+void Textbox::layoutLines() {
+    m_linesDirty = false;
+    Renderer* renderer = m_uiloRef ? &m_uiloRef->getRenderer() : nullptr;
+    Font font = renderer ? renderer->loadFont(m_options.getFontPath()) : Font{};
     const unsigned int cs = m_options.hasCharSize() ? m_options.getCharSize()
                                                      : std::max(1u, m_autoCharSize);
-    const float pxH = static_cast<float>(cs) * scale;
+    const float pxH      = static_cast<float>(cs) * (m_uiloRef ? m_uiloRef->getScale() : 1.f);
     const float maxWidth = textArea().size.x;
-    const std::u32string& src = m_text;
-
-    if (maxWidth <= 0.f) {
-        m_displayU32 = src;
-        m_wrappedDisplay = u32ToUtf8(m_displayU32);
-        return;
-    }
-
-    auto measureW = [&](const std::u32string& s) -> float {
-        if (s.empty()) return 0.f;
-        return renderer.measureText(u32ToUtf8(s), font, pxH).size.x;
-    };
-
-    std::u32string result;
-    result.reserve(src.size() + 8);
-
-    auto processParagraph = [&](size_t pStart, size_t pEnd) {
-        std::u32string lineStr;
-        size_t j = pStart;
-
-        auto charWrap = [&](size_t from, size_t to) {
-            for (size_t k = from; k < to; ++k) {
-                std::u32string probe = lineStr + src[k];
-                if (!lineStr.empty() && measureW(probe) > maxWidth) {
-                    result += lineStr;
-                    m_softWrapAt.push_back(k);
-                    result += U'\n';
-                    lineStr.clear();
-                }
-                lineStr += src[k];
+    const bool  wrap     = shouldWrap(m_options) && maxWidth > 0.f;
+
+    std::u32string      para, display;
+    std::vector<float>  advances;
+    std::vector<size_t> wraps;
+    int   row   = 0;
+    float width = 0.f;
+    for (auto& line : m_lines) {
+        if (line.dirty) {
+            line.dirty = false;
+            para = m_options.getPasswordMode() ? std::u32string(line.length, U'*')
+                                               : m_text.substr(line.start, line.length);
+            wraps.clear();
+            if (wrap && font.valid()) {
+                advances.resize(para.size());
+                renderer->glyphAdvances(para, font, pxH, advances.data());
+                wrapText(para, advances.data(), maxWidth, true, wraps);
             }
-        };
-
-        while (j < pEnd) {
-            size_t wordEnd = j;
-            while (wordEnd < pEnd && src[wordEnd] != U' ') ++wordEnd;
-            size_t tokenEnd = wordEnd;
-            while (tokenEnd < pEnd && src[tokenEnd] == U' ') ++tokenEnd;
-            if (tokenEnd == j) ++tokenEnd; // stall guard
-
-            std::u32string token(src.begin() + (std::ptrdiff_t)j,
-                                 src.begin() + (std::ptrdiff_t)tokenEnd);
-
-            float tw = measureW(lineStr + token);
-            if (tw <= maxWidth) {
-                lineStr += token;
-            } else {
-                std::u32string wordOnly(src.begin() + (std::ptrdiff_t)j,
-                                        src.begin() + (std::ptrdiff_t)wordEnd);
-                float wordW = measureW(wordOnly);
-                if (wordW <= maxWidth) {
-                    if (!lineStr.empty()) {
-                        result += lineStr;
-                        m_softWrapAt.push_back(j);
-                        result += U'\n';
-                        lineStr.clear();
-                    }
-                    lineStr = token;
-                } else {
-                    if (!lineStr.empty()) {
-                        result += lineStr;
-                        m_softWrapAt.push_back(j);
-                        result += U'\n';
-                        lineStr.clear();
-                    }
-                    charWrap(j, wordEnd);
-                    lineStr += std::u32string(src.begin() + (std::ptrdiff_t)wordEnd,
-                                              src.begin() + (std::ptrdiff_t)tokenEnd);
-                }
+            // Soft breaks become '\n's; the spaces before them stay so
+            // every text char keeps a caret position.
+            display.clear();
+            display.reserve(para.size() + wraps.size());
+            for (size_t k = 0, w = 0; k < para.size(); ++k) {
+                if (w < wraps.size() && wraps[w] == k) { display += U'\n'; ++w; }
+                display += para[k];
             }
-            j = tokenEnd;
-        }
-        result += lineStr;
-    };
-
-    bool firstParagraph = true;
-    size_t paraBegin = 0;
-    for (size_t i = 0; i <= src.size(); ++i) {
-        if (i == src.size() || src[i] == U'\n') {
-            if (!firstParagraph) result += U'\n';
-            firstParagraph = false;
-            processParagraph(paraBegin, i);
-            paraBegin = i + 1;
+            line.display = u32ToUtf8(display);
+
+            // Display positions include the soft '\n's; index them by text
+            // char instead, so a char right after a break sits at the start
+            // of the next row.
+            std::vector<Vec2f> disp;
+            if (font.valid()) disp = renderer->charPositions(line.display, font, pxH);
+            if (disp.empty()) disp.push_back({0.f, 0.f});
+            line.positions.resize(line.length + 1);
+            line.width = 0.f;
+            size_t w = 0;
+            for (size_t k = 0; k <= line.length; ++k) {
+                while (w < wraps.size() && wraps[w] <= k) ++w;
+                line.positions[k] = disp[std::min(k + w, disp.size() - 1)];
+                line.width = std::max(line.width, line.positions[k].x);
+            }
+            line.rows = 1 + (int)wraps.size();
         }
+        line.firstRow = row;
+        row  += line.rows;
+        width = std::max(width, line.width);
     }
-
-    m_displayU32     = std::move(result);
-    m_wrappedDisplay = u32ToUtf8(m_displayU32);
+    m_visualRows  = std::max(1, row);
+    m_layoutWidth = width;
 }
 
 void Textbox::computeTextOrigin() {
-    if (m_charPositions.empty()) { m_textOrigin = textArea().position; return; }
+    if (m_lines.empty()) { m_textOrigin = textArea().position; return; }
     const Rectf area = textArea();
     const float lh   = lineHeight();
 
     // Total height = (lines) * lh (excluding gap on the last line, but lh already
     // includes lineGap which is fine for centering)
     // Total width  = max x across all character positions (approx text bbox width)
-    float maxX = 0.f, maxY = 0.f;
-    for (auto& p : m_charPositions) {
-        if (p.x > maxX) maxX = p.x;
-        if (p.y > maxY) maxY = p.y;
-    }
-    const float totalH = maxY + lh;
-    const float totalW = maxX;
+    const float totalH = (float)m_visualRows * lh;
+    const float totalW = m_layoutWidth;
 
     float ox;
     if (hasAlign(m_options.getTextAlignX(), Align::CenterX))
@@ -353,7 +276,7 @@ void Textbox::computeTextOrigin() {
 }
 
 void Textbox::ensureCursorVisible() {
-    if (m_charPositions.empty()) return;
+    if (m_lines.empty()) return;
     const Rectf area = textArea();
     const float lh   = lineHeight();
     const Vec2f cp   = charScreenPos(m_cursorPos);
@@ -383,24 +306,6 @@ void Textbox::ensureCursorVisible() {
     }
 }
 
-size_t Textbox::textToDisplay(size_t textIdx) const {
-    size_t extra = 0;
-    for (size_t wrapPos : m_softWrapAt) {
-        if (textIdx >= wrapPos) ++extra;
-        else break;
-    }
-    return textIdx + extra;
-}
-
-size_t Textbox::displayToText(size_t dispIdx) const {
-    size_t extra = 0;
-    for (size_t wrapPos : m_softWrapAt) {
-        if (dispIdx > wrapPos + extra) ++extra;
-        else break;
-    }
-    return dispIdx >= extra ? dispIdx - extra : 0;
-}
-
 // ---------------------------------------------------------------------------
 // Selection / cursor helpers
 // ---------------------------------------------------------------------------
@@ -412,9 +317,8 @@ bool Textbox::hasSelection() const {
 void Textbox::deleteSelection() {
     const size_t lo = std::min(m_cursorPos, m_anchorPos);
     const size_t hi = std::max(m_cursorPos, m_anchorPos);
-    m_text.erase(lo, hi - lo);
+    editText(lo, hi - lo, {});
     m_cursorPos = m_anchorPos = lo;
-    m_textDirty = true;
     m_needsCursorScroll = true;
     if (m_options.getOnStringChanged())
         m_options.getOnStringChanged()(getString());
@@ -460,11 +364,11 @@ size_t Textbox::wordRight(size_t pos) const {
 // ---------------------------------------------------------------------------
 
 std::string Textbox::getString() const {
-    return u32ToUtf8(m_text);
+    return u32ToUtf8(m_text.str());
 }
 
 void Textbox::setString(const std::string& s) {
-    m_text      = utf8ToU32(s);
+    m_text.assign(utf8ToU32(s));
     m_cursorPos = m_anchorPos = std::min(m_cursorPos, m_text.size());
     m_textDirty = true;
     m_scrollOffsetX = m_scrollOffsetY = 0.f;
@@ -474,6 +378,11 @@ void Textbox::setString(const std::string& s) {
 // update
 // ---------------------------------------------------------------------------
 
+void Textbox::translate(Vec2f delta) {
+    Element::translate(delta);
+    m_textOrigin += delta;
+}
+
 void Textbox::update(Rectf& parentBounds, float dt) {
     resize(parentBounds);
 
@@ -502,7 +411,10 @@ void Textbox::update(Rectf& parentBounds, float dt) {
 
     if (m_textDirty) {
         m_dirty = true;
-        rebuildSfText();
+        rebuildLayout();
+    } else if (m_linesDirty) {
+        m_dirty = true;
+        layoutLines();
     }
 
     // Auto-height for multiline+wrap
@@ -511,8 +423,7 @@ void Textbox::update(Rectf& parentBounds, float dt) {
             m_initialHeight    = m_bounds.size.y / scale;
             m_initialHeightSet = true;
         }
-        int lineCount = 1;
-        for (char c : m_wrappedDisplay) if (c == '\n') ++lineCount;
+        const int   lineCount = m_visualRows;
         const float lh = lineHeight();
         const float pt = m_options.getPaddingTop()    * scale;
         const float pb = m_options.getPaddingBottom() * scale;
@@ -573,6 +484,8 @@ void Textbox::update(Rectf& parentBounds, float dt) {
             m_cursorVisible = !m_cursorVisible;
             m_dirty = true;
         }
+        // Wake an on-demand host in time for the next caret toggle.
+        if (m_uiloRef) m_uiloRef->requestRedrawIn(half - m_blinkTimer);
     }
 }
 
@@ -636,34 +549,70 @@ void Textbox::render() {
                               font, pxH, textColor);
         }
     } else {
-        // Selection rects (per character; newline fills to area right edge).
+        // Only hard lines overlapping the text area are visited; rows of a
+        // long, wrapped line that fall outside are left to the scissor.
         const float lh = lineHeight();
+        const float rowH = std::max(1.f, lh);
+        const int firstVisRow = (int)std::floor((area.position.y - m_textOrigin.y) / rowH);
+        const int endVisRow   = (int)std::ceil((area.position.y + area.size.y - m_textOrigin.y) / rowH);
+        auto firstVisible = std::upper_bound(m_lines.begin(), m_lines.end(), firstVisRow,
+                                             [](int r, const LineLayout& l) { return r < l.firstRow; });
+        if (firstVisible != m_lines.begin()) --firstVisible;
+        const size_t visBegin = (size_t)(firstVisible - m_lines.begin());
+
+        // Selection rects: runs of selected chars on one row merge into one
+        // rect; a selected newline (hard or soft) fills to the area's right
+        // edge.
         if (m_focused && hasSelection()) {
             const size_t lo = std::min(m_cursorPos, m_anchorPos);
             const size_t hi = std::max(m_cursorPos, m_anchorPos);
             const Color  selCol = resolveColor(m_options.getSelectionColorRole(), m_options.getSelectionColor());
-            for (size_t i = lo; i < hi; ++i) {
-                Vec2f p0 = charScreenPos(i);
-                Vec2f p1 = charScreenPos(i + 1);
-                float x0 = p0.x;
-                float x1 = p1.x;
-                float y  = p0.y;
-                bool isNewlineSel =
-                    (i < m_text.size() && m_text[i] == U'\n') || (p1.y > p0.y + 0.5f);
-                if (isNewlineSel) {
-                    x1 = area.position.x + area.size.x;
-                }
-                if (x1 < x0) std::swap(x0, x1);
+            const float  rightEdge = area.position.x + area.size.x - m_textOrigin.x;
+            bool  open = false;
+            float runX0 = 0.f, runX1 = 0.f, runY = 0.f;
+            auto emit = [&] {
+                if (!open) return;
+                open = false;
                 renderer.draw(Rect{
-                    { x0, y },
-                    { std::max(1.f, x1 - x0), lh },
+                    { m_textOrigin.x + runX0, runY },
+                    { std::max(1.f, runX1 - runX0), lh },
                     selCol
                 });
+            };
+            for (size_t li = std::max(visBegin, lineIndexFor(lo)); li < m_lines.size(); ++li) {
+                const LineLayout& line = m_lines[li];
+                if (line.start >= hi || line.firstRow >= endVisRow) break;
+                const float lineY = m_textOrigin.y + (float)line.firstRow * lh;
+                const size_t k0 = std::max(lo, line.start) - line.start;
+                const size_t k1 = std::min(hi, line.start + line.length + 1) - line.start;
+                for (size_t k = k0; k < k1 && k < line.positions.size(); ++k) {
+                    const Vec2f p0 = line.positions[k];
+                    float x0 = p0.x, x1 = rightEdge;
+                    if (k < line.length) {
+                        const Vec2f p1 = line.positions[k + 1];
+                        if (p1.y <= p0.y + 0.5f) x1 = p1.x;
+                    }
+                    if (x1 < x0) std::swap(x0, x1);
+                    const float y = lineY + p0.y;
+                    if (open && y == runY && x0 <= runX1 + 0.5f) {
+                        runX1 = std::max(runX1, x1);
+                    } else {
+                        emit();
+                        open = true;
+                        runX0 = x0; runX1 = x1; runY = y;
+                    }
+                }
             }
+            emit();
         }
 
-        if (!m_wrappedDisplay.empty()) {
-            renderer.drawText(m_wrappedDisplay, m_textOrigin, font, pxH, textColor);
+        for (size_t li = visBegin; li < m_lines.size(); ++li) {
+            const LineLayout& line = m_lines[li];
+            if (line.firstRow >= endVisRow) break;
+            if (line.display.empty()) continue;
+            renderer.drawText(line.display,
+                              { m_textOrigin.x, m_textOrigin.y + (float)line.firstRow * lh },
+                              font, pxH, textColor);
         }
 
         // Caret
@@ -719,8 +668,7 @@ bool Textbox::checkScroll(const Vec2f& mousePos, float delta, bool /*precise*/,
     if (!m_options.getMultiline()) return false;
     const int ml = m_options.getMaxResizeLines();
     if (ml <= 0) return false;
-    int lineCount = 1;
-    for (char c : m_wrappedDisplay) if (c == '\n') ++lineCount;
+    const int lineCount = m_visualRows;
     if (lineCount <= ml) return false;
     const float lh        = lineHeight();
     const float maxScroll = static_cast<float>(lineCount - ml) * lh;
@@ -745,10 +693,9 @@ void Textbox::handleTextInput(char32_t c) {
     if (hasSelection()) deleteSelection();
     const int maxLen = m_options.getMaxLength();
     if (maxLen > 0 && static_cast<int>(m_text.size()) >= maxLen) return;
-    m_text.insert(m_text.begin() + static_cast<std::ptrdiff_t>(m_cursorPos), c);
+    editText(m_cursorPos, 0, std::u32string_view(&c, 1));
     ++m_cursorPos;
     m_anchorPos = m_cursorPos;
-    m_textDirty = true;
     resetBlink();
     m_needsCursorScroll = true;
     if (m_options.getOnStringChanged())
@@ -801,9 +748,8 @@ void Textbox::handleKeyInput(SDL_Keycode key, bool shift, bool ctrl) {
             if (hasSelection()) deleteSelection();
             else if (m_cursorPos > 0) {
                 size_t newPos = ctrl ? wordLeft(m_cursorPos) : m_cursorPos - 1;
-                m_text.erase(newPos, m_cursorPos - newPos);
+                editText(newPos, m_cursorPos - newPos, {});
                 m_cursorPos = m_anchorPos = newPos;
-                m_textDirty = true;
             }
             resetBlink();
             if (m_options.getOnStringChanged()) m_options.getOnStringChanged()(getString());
@@ -812,8 +758,7 @@ void Textbox::handleKeyInput(SDL_Keycode key, bool shift, bool ctrl) {
             if (hasSelection()) deleteSelection();
             else if (m_cursorPos < n) {
                 size_t end = ctrl ? wordRight(m_cursorPos) : m_cursorPos + 1;
-                m_text.erase(m_cursorPos, end - m_cursorPos);
-                m_textDirty = true;
+                editText(m_cursorPos, end - m_cursorPos, {});
             }
             resetBlink();
             if (m_options.getOnStringChanged()) m_options.getOnStringChanged()(getString());
@@ -824,10 +769,9 @@ void Textbox::handleKeyInput(SDL_Keycode key, bool shift, bool ctrl) {
                 if (hasSelection()) deleteSelection();
                 const int maxLen = m_options.getMaxLength();
                 if (maxLen <= 0 || static_cast<int>(m_text.size()) < maxLen) {
-                    m_text.insert(m_text.begin() + static_cast<std::ptrdiff_t>(m_cursorPos), U'\n');
+                    editText(m_cursorPos, 0, U"\n");
                     ++m_cursorPos;
                     m_anchorPos = m_cursorPos;
-                    m_textDirty = true;
                     if (m_options.getOnStringChanged()) m_options.getOnStringChanged()(getString());
                 }
             } else {
@@ -872,10 +816,9 @@ void Textbox::handleKeyInput(SDL_Keycode key, bool shift, bool ctrl) {
                                         ? static_cast<size_t>(maxLen) - m_text.size() : 0u;
                             if (pasted.size() > room) pasted.resize(room);
                         }
-                        m_text.insert(m_cursorPos, pasted);
+                        editText(m_cursorPos, 0, pasted);
                         m_cursorPos += pasted.size();
                         m_anchorPos  = m_cursorPos;
-                        m_textDirty  = true;
                         resetBlink();
                         if (m_options.getOnStringChanged()) m_options.getOnStringChanged()(getString());
                     }
@@ -4,8 +4,11 @@
 #include <string>
 #include <optional>
 #include <limits>
+#include <string_view>
+#include <vector>
 
 #include "Interactible.hpp"
+#include "../../utils/GapBuffer.hpp"
 
 namespace uilo {
 
@@ -75,30 +78,30 @@ public:
     unsigned int       getCharSize()         const { return m_charSize.value_or(18); }
     bool               hasCharSize()         const { return m_charSize.has_value(); }
     Color              getTextColor()        const { return m_textColor; }
-    const std::string& getTextColorRole()    const { return m_textColorRole; }
+    const Role&        getTextColorRole()    const { return m_textColorRole; }
     bool               getBold()             const { return m_bold; }
     bool               getItalic()           const { return m_italic; }
     Align              getTextAlignX()       const { return m_textAlignX; }
     Align              getTextAlignY()       const { return m_textAlignY; }
     Color              getBackgroundColor()  const { return m_bgColor; }
-    const std::string& getBackgroundColorRole() const { return m_bgColorRole; }
+    const Role&        getBackgroundColorRole() const { return m_bgColorRole; }
     float              getRounding()         const { return m_rounding; }
     float              getPaddingLeft()      const { return m_paddingLeft; }
     float              getPaddingRight()     const { return m_paddingRight; }
     float              getPaddingTop()       const { return m_paddingTop; }
     float              getPaddingBottom()    const { return m_paddingBottom; }
     Color              getOutlineColor()     const { return m_outlineColor; }
-    const std::string& getOutlineColorRole() const { return m_outlineColorRole; }
+    const Role&        getOutlineColorRole() const { return m_outlineColorRole; }
     float              getOutlineThickness() const { return m_outlineThickness; }
     const std::string& getPlaceholder()      const { return m_placeholder; }
     Color              getPlaceholderColor() const { return m_placeholderColor; }
-    const std::string& getPlaceholderColorRole() const { return m_placeholderColorRole; }
+    const Role&        getPlaceholderColorRole() const { return m_placeholderColorRole; }
     Color              getCursorColor()      const { return m_cursorColor; }
-    const std::string& getCursorColorRole()  const { return m_cursorColorRole; }
+    const Role&        getCursorColorRole()  const { return m_cursorColorRole; }
     float              getCursorWidth()      const { return m_cursorWidth; }
     float              getBlinkRate()        const { return m_blinkRate; }
     Color              getSelectionColor()   const { return m_selectionColor; }
-    const std::string& getSelectionColorRole() const { return m_selectionColorRole; }
+    const Role&        getSelectionColorRole() const { return m_selectionColorRole; }
     bool               getMultiline()        const { return m_multiline; }
     bool               getWrap()             const { return m_wrap; }
     int                getMaxResizeLines()   const { return m_maxResizeLines; }
@@ -111,30 +114,30 @@ private:
     std::string        m_fontPath;
     std::optional<unsigned int> m_charSize;
     Color              m_textColor        = Color::White;
-    std::string        m_textColorRole;
+    Role               m_textColorRole;
     bool               m_bold             = false;
     bool               m_italic           = false;
     Align              m_textAlignX       = Align::Left;
     Align              m_textAlignY       = Align::CenterY;
     Color              m_bgColor          = Color{50, 50, 50};
-    std::string        m_bgColorRole;
+    Role               m_bgColorRole;
     float              m_rounding         = 0.f;
     float              m_paddingLeft      = 6.f;
     float              m_paddingRight     = 6.f;
     float              m_paddingTop       = 6.f;
     float              m_paddingBottom    = 6.f;
     Color              m_outlineColor     = Color::White;
-    std::string        m_outlineColorRole;
+    Role               m_outlineColorRole;
     float              m_outlineThickness = 0.f;
     std::string        m_placeholder;
     Color              m_placeholderColor  = Color{128, 128, 128};
-    std::string        m_placeholderColorRole;
+    Role               m_placeholderColorRole;
     Color              m_cursorColor       = Color::White;
-    std::string        m_cursorColorRole;
+    Role               m_cursorColorRole;
     float              m_cursorWidth       = 2.f;
     float              m_blinkRate         = 1.0f;   // full blink cycle in seconds
     Color              m_selectionColor    = Color{70, 130, 200, 160};
-    std::string        m_selectionColorRole;
+    Role               m_selectionColorRole;
     bool               m_multiline         = false;
     bool               m_wrap              = true;    // wrap text when multiline
     int                m_maxResizeLines    = 0;       // 0 = unlimited; >0 = clamp height, scroll beyond
@@ -170,6 +173,9 @@ public:
     TextboxOptions&       getOptions()       { return m_options; }
 
 private:
+    // Caret blink, drag selection and edits all run in update().
+    bool wantsUpdate() const override { return true; }
+    void translate(Vec2f delta) override;
     Rectf         textArea()              const;
     float         lineHeight()            const;
     Vec2f         charScreenPos(size_t i) const;
@@ -178,14 +184,18 @@ private:
     bool          hasSelection()          const;
     void          deleteSelection();
     void          resetBlink();
-    void          rebuildSfText();
-    void          rebuildWrapped();        // builds m_wrappedDisplay + m_softWrapAt
     void          computeTextOrigin();
-    std::u32string displayText()          const;
 
-    // Soft-wrap index mapping helpers
-    size_t        textToDisplay(size_t textIdx)   const;
-    size_t        displayToText(size_t dispIdx)   const;
+    // Every edit goes through editText(), which splices the line index so
+    // only the hard lines it touched are re-wrapped and re-measured on the
+    // next layoutLines(). rebuildLayout() redoes every line (font, scale or
+    // wrap width changed).
+    struct LineLayout;
+    void          editText(size_t pos, size_t eraseCount, std::u32string_view insert);
+    std::vector<LineLayout> splitLines(size_t from, size_t to) const;
+    void          rebuildLayout();
+    void          layoutLines();
+    size_t        lineIndexFor(size_t textIdx) const;
 
     size_t lineStart(size_t pos)  const;
     size_t lineEnd(size_t pos)    const;
@@ -193,7 +203,7 @@ private:
     size_t wordRight(size_t pos)  const;
 
     TextboxOptions          m_options;
-    std::u32string          m_text;
+    GapBuffer               m_text;
     size_t                  m_cursorPos     = 0;
     size_t                  m_anchorPos     = 0;   // same as cursor = no selection
     bool                    m_focused       = false;
@@ -204,11 +214,22 @@ private:
     float                   m_scrollAccum   = 0.f;
     float                   m_preferredX    = 0.f;  // preserved column x for up/down nav
 
-    // Soft-wrap state (multiline+wrap mode)
-    std::string             m_wrappedDisplay;           // UTF-8 display string with soft newlines
-    std::u32string          m_displayU32;               // UTF-32 view of m_wrappedDisplay
-    std::vector<Vec2f>      m_charPositions;            // per-codepoint position (size = m_displayU32.size()+1)
-    std::vector<size_t>     m_softWrapAt;               // text indices where soft wrap was inserted
+    // Layout, one entry per hard ('\n'-separated) line; password mode
+    // keeps the whole text on one line, as it shows no line breaks.
+    struct LineLayout {
+        size_t             start    = 0;      // text index of the first char
+        size_t             length   = 0;      // chars, excluding the '\n'
+        std::string        display;           // UTF-8, soft wraps as '\n'
+        std::vector<Vec2f> positions;         // per char + trailing slot, line-relative
+        float              width    = 0.f;    // max x over positions
+        int                rows     = 1;      // visual rows after soft wrap
+        int                firstRow = 0;      // rows above this line
+        bool               dirty    = true;
+    };
+    std::vector<LineLayout> m_lines;
+    int                     m_visualRows    = 1;
+    float                   m_layoutWidth   = 0.f;    // widest line
+    bool                    m_linesDirty    = false;  // some m_lines[i].dirty
     float                   m_lastWrapWidth = 0.f;
     float                   m_lineHeightCache   = 0.f;
     float                   m_initialHeight     = 0.f;
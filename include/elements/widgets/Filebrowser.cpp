@@ -0,0 +1,763 @@
+#include "Filebrowser.hpp"
+#include "../../UILO.hpp"
+#include "../../utils/FrameArena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <variant>
+
+namespace uilo {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t kChunkSize       = 512;     // entries per published chunk
+constexpr auto   kPublishInterval = std::chrono::milliseconds(30);
+constexpr size_t kStatBatch       = 32;      // stats per worker pass
+constexpr float  kPollSeconds     = 1.f / 30.f;
+
+enum MetaState : uint8_t { kMetaUnknown, kMetaRequested, kMetaReady, kMetaFailed };
+
+char foldChar(char c) { return (char)std::tolower(static_cast<unsigned char>(c)); }
+
+std::string folded(std::string_view s) {
+    std::string r(s);
+    for (char& c : r) c = foldChar(c);
+    return r;
+}
+
+bool containsFolded(std::string_view hay, std::string_view needle) {
+    if (needle.empty()) return true;
+    return std::search(hay.begin(), hay.end(), needle.begin(), needle.end(),
+                       [](char a, char b) { return foldChar(a) == b; }) != hay.end();
+}
+
+bool endsWithFolded(std::string_view s, std::string_view suffix) {
+    if (suffix.size() > s.size()) return false;
+    return std::equal(suffix.begin(), suffix.end(), s.end() - (ptrdiff_t)suffix.size(),
+                      [](char a, char b) { return a == foldChar(b); });
+}
+
+void formatSize(char* buf, size_t n, uint64_t bytes) {
+    if      (bytes >= (1ull << 30)) std::snprintf(buf, n, "%.1f GB", (double)bytes / (1ull << 30));
+    else if (bytes >= (1ull << 20)) std::snprintf(buf, n, "%.1f MB", (double)bytes / (1ull << 20));
+    else if (bytes >= (1ull << 10)) std::snprintf(buf, n, "%.1f KB", (double)bytes / (1ull << 10));
+    else                            std::snprintf(buf, n, "%llu B", (unsigned long long)bytes);
+}
+
+void formatDate(char* buf, size_t n, int64_t seconds) {
+    const std::time_t t = (std::time_t)seconds;
+    const std::tm* tm = std::localtime(&t);
+    if (!tm || !std::strftime(buf, n, "%Y-%m-%d %H:%M", tm)) buf[0] = '\0';
+}
+
+} // anon
+
+// ---- Shared data -----------------------------------------------------------
+// Chunks are immutable once the worker publishes them, so both threads
+// read them without locking; everything else in a Listing is UI-only.
+
+struct Filebrowser::Entry {
+    std::string name;
+    bool        directory = false;
+};
+
+struct Filebrowser::EntryChunk {
+    uint32_t           first = 0;      // listing index of entries[0]
+    std::vector<Entry> entries;
+};
+
+namespace {
+
+struct Meta {
+    uint64_t size     = 0;
+    int64_t  modified = 0;             // seconds since the epoch
+    uint8_t  state    = kMetaUnknown;
+};
+
+} // anon
+
+struct Filebrowser::Listing {
+    uint64_t    id       = 0;
+    std::string path;
+    std::vector<std::shared_ptr<const EntryChunk>> chunks;
+    uint32_t    count    = 0;
+    bool        complete = false;
+    // Positions -> entry indices for the filter of generation viewGen;
+    // arrival order while scanning, directories-first sorted after.
+    std::vector<uint32_t> view;
+    uint64_t    viewGen  = 0;
+    std::vector<Meta> meta;
+    uint64_t    lastUsed = 0;
+
+    const Entry& entry(uint32_t index) const {
+        auto it = std::upper_bound(chunks.begin(), chunks.end(), index,
+            [](uint32_t i, const std::shared_ptr<const EntryChunk>& c) { return i < c->first; });
+        const EntryChunk& c = **(it - 1);
+        return c.entries[index - c.first];
+    }
+};
+
+namespace {
+
+struct FilterSpec {
+    std::string              query;        // folded
+    std::vector<std::string> extensions;   // folded, with the dot
+    bool                     showHidden = false;
+};
+
+} // anon
+
+/*
+    Worker:
+    - Desc: The widget's background thread and its two queues. The UI
+            posts tasks (scan a directory, refilter a listing, stat some
+            entries) into the inbox; the worker answers with messages in
+            the outbox, which update() drains in order. Filters outrank
+            stats, which outrank scanning, so typing and scrolling stay
+            responsive during a long scan; a scan runs in slices between
+            them; a new scan, or a cancel, abandons the old one.
+*/
+struct Filebrowser::Worker {
+    using Chunks = std::vector<std::shared_ptr<const EntryChunk>>;
+
+    struct ScanTask   { uint64_t listing; std::string path; };
+    struct FilterTask { uint64_t listing; uint64_t gen; FilterSpec spec; Chunks chunks; bool complete; };
+    struct StatTask   { uint64_t listing; uint32_t index; std::string path; };
+
+    struct ChunkMsg   { uint64_t listing; std::shared_ptr<const EntryChunk> chunk; uint64_t gen; std::vector<uint32_t> matches; };
+    struct ViewMsg    { uint64_t listing; uint64_t gen; std::vector<uint32_t> view; };
+    struct DoneMsg    { uint64_t listing; bool ok; std::string error; };
+    struct StatMsg    { uint64_t listing; uint32_t index; Meta meta; };
+    using Message = std::variant<ChunkMsg, ViewMsg, DoneMsg, StatMsg>;
+
+    std::thread             thread;
+    std::mutex              mutex;
+    std::condition_variable wake;
+    bool                    stop = false;
+
+    // Inbox (mutex).
+    std::optional<ScanTask>   scan;
+    std::optional<FilterTask> filter;
+    std::deque<StatTask>      stats;
+    bool                      cancel = false;
+    // Outbox (mutex).
+    std::vector<Message>      outbox;
+
+    // Worker-thread state.
+    struct Scan {
+        uint64_t                listing = 0;
+        fs::directory_iterator  it;
+        Chunks                  chunks;
+        uint32_t                count = 0;
+        std::shared_ptr<EntryChunk> open;
+        std::chrono::steady_clock::time_point lastPublish;
+    };
+    std::optional<Scan> active;
+    FilterSpec          spec;
+    uint64_t            gen = 0;
+
+    Worker()  { thread = std::thread([this] { run(); }); }
+    ~Worker() {
+        { std::lock_guard<std::mutex> lock(mutex); stop = true; }
+        wake.notify_one();
+        thread.join();
+    }
+
+    void post(Message m) {
+        std::lock_guard<std::mutex> lock(mutex);
+        outbox.push_back(std::move(m));
+    }
+
+    static bool matches(const Entry& e, const FilterSpec& s) {
+        if (!s.showHidden && !e.name.empty() && e.name[0] == '.') return false;
+        if (!e.directory && !s.extensions.empty()) {
+            bool any = false;
+            for (const auto& ext : s.extensions)
+                if (endsWithFolded(e.name, ext)) { any = true; break; }
+            if (!any) return false;
+        }
+        return containsFolded(e.name, s.query);
+    }
+
+    static std::vector<uint32_t> buildView(const Chunks& chunks, const FilterSpec& s, bool sorted) {
+        std::vector<uint32_t> view;
+        for (const auto& c : chunks)
+            for (size_t i = 0; i < c->entries.size(); ++i)
+                if (matches(c->entries[i], s)) view.push_back(c->first + (uint32_t)i);
+        if (!sorted || view.empty()) return view;
+
+        // Directories first, then case-insensitive by name.
+        std::vector<const Entry*> flat;
+        for (const auto& c : chunks)
+            for (const auto& e : c->entries) flat.push_back(&e);
+        std::sort(view.begin(), view.end(), [&](uint32_t a, uint32_t b) {
+            const Entry& x = *flat[a];
+            const Entry& y = *flat[b];
+            if (x.directory != y.directory) return x.directory;
+            return std::lexicographical_compare(x.name.begin(), x.name.end(), y.name.begin(), y.name.end(),
+                [](char p, char q) { return foldChar(p) < foldChar(q); });
+        });
+        return view;
+    }
+
+    void run() {
+        for (;;) {
+            std::optional<FilterTask> f;
+            std::optional<ScanTask>   s;
+            std::vector<StatTask>     st;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stop || cancel || filter || scan || !stats.empty() || active; });
+                if (stop) return;
+                if (cancel) { cancel = false; active.reset(); }
+                if (filter)              { f = std::move(filter); filter.reset(); }
+                else if (!stats.empty()) {
+                    while (!stats.empty() && st.size() < kStatBatch) {
+                        st.push_back(std::move(stats.front()));
+                        stats.pop_front();
+                    }
+                }
+                else if (scan)           { s = std::move(scan); scan.reset(); }
+            }
+            if (f)                runFilter(*f);
+            else if (!st.empty()) runStats(st);
+            else if (s)           startScan(*s);
+            else if (active)      scanSlice();
+        }
+    }
+
+    void runFilter(FilterTask& t) {
+        spec = std::move(t.spec);
+        gen  = t.gen;
+        // The listing being scanned: filter what the worker has, which may
+        // be more than the UI had when it asked.
+        const bool scanning = active && active->listing == t.listing;
+        const Chunks& chunks = scanning ? active->chunks : t.chunks;
+        post(ViewMsg{ t.listing, gen, buildView(chunks, spec, !scanning && t.complete) });
+    }
+
+    void runStats(const std::vector<StatTask>& tasks) {
+        for (const auto& t : tasks) {
+            Meta m;
+            std::error_code ec;
+            const fs::path p(t.path);
+            const auto status = fs::status(p, ec);
+            if (!ec) {
+                if (fs::is_regular_file(status)) {
+                    const auto size = fs::file_size(p, ec);
+                    if (!ec) m.size = size;
+                }
+                const auto ftime = fs::last_write_time(p, ec);
+                if (!ec) {
+                    using namespace std::chrono;
+                    const auto sys = time_point_cast<seconds>(
+                        ftime - fs::file_time_type::clock::now() + system_clock::now());
+                    m.modified = sys.time_since_epoch().count();
+                }
+            }
+            m.state = ec ? kMetaFailed : kMetaReady;
+            post(StatMsg{ t.listing, t.index, m });
+        }
+    }
+
+    void startScan(const ScanTask& t) {
+        active.reset();
+        std::error_code ec;
+        fs::directory_iterator it(fs::path(t.path), fs::directory_options::skip_permission_denied, ec);
+        if (ec) {
+            post(DoneMsg{ t.listing, false, ec.message() });
+            return;
+        }
+        active.emplace();
+        active->listing     = t.listing;
+        active->it          = std::move(it);
+        active->lastPublish = std::chrono::steady_clock::now();
+    }
+
+    void publish() {
+        Scan& sc = *active;
+        if (!sc.open || sc.open->entries.empty()) return;
+        std::shared_ptr<const EntryChunk> chunk = std::move(sc.open);
+        std::vector<uint32_t> m;
+        for (size_t i = 0; i < chunk->entries.size(); ++i)
+            if (matches(chunk->entries[i], spec)) m.push_back(chunk->first + (uint32_t)i);
+        sc.chunks.push_back(chunk);
+        sc.lastPublish = std::chrono::steady_clock::now();
+        post(ChunkMsg{ sc.listing, std::move(chunk), gen, std::move(m) });
+    }
+
+    // Reads entries until a chunk fills or the publish interval passes,
+    // then goes back to the inbox.
+    void scanSlice() {
+        Scan& sc = *active;
+        const fs::directory_iterator end;
+        std::error_code ec;
+        while (sc.it != end) {
+            const fs::directory_entry& de = *sc.it;
+            if (!sc.open) {
+                sc.open = std::make_shared<EntryChunk>();
+                sc.open->first = sc.count;
+                sc.open->entries.reserve(kChunkSize);
+            }
+            Entry e;
+            e.name      = de.path().filename().string();
+            e.directory = de.is_directory(ec);
+            sc.open->entries.push_back(std::move(e));
+            ++sc.count;
+            sc.it.increment(ec);
+            if (ec) break;
+            if (sc.open->entries.size() >= kChunkSize ||
+                std::chrono::steady_clock::now() - sc.lastPublish >= kPublishInterval) {
+                publish();
+                return;
+            }
+        }
+        publish();
+        // Done: the sorted view replaces the arrival-order one.
+        post(ViewMsg{ sc.listing, gen, buildView(sc.chunks, spec, true) });
+        post(DoneMsg{ sc.listing, !ec, ec ? ec.message() : std::string() });
+        active.reset();
+    }
+};
+
+// ---- Construction ----------------------------------------------------------
+
+Filebrowser::Filebrowser(Modifier modifier, FilebrowserOptions options, const std::string& name)
+    : Column(modifier,
+             ColumnOptions().setColor(options.getColor()).setColorRole(options.getColorRole()),
+             contains{}, name)
+    , m_browserOptions(std::move(options))
+{
+    m_showHidden = m_browserOptions.getShowHidden();
+    for (const auto& ext : m_browserOptions.getExtensions()) {
+        if (ext.empty()) continue;
+        m_extensions.push_back(folded(ext[0] == '.' ? ext : "." + ext));
+    }
+    buildParts();
+}
+
+Filebrowser::~Filebrowser() = default;
+
+void Filebrowser::buildParts() {
+    const FilebrowserOptions& o = m_browserOptions;
+    const float itemH = o.getItemHeight();
+
+    TextOptions textOpts;
+    if (!o.getFontPath().empty()) textOpts.setFont(o.getFontPath());
+    if (o.hasCharSize()) textOpts.setCharSize(o.getCharSize());
+    textOpts.setColor(o.getTextColor()).setColorRole(o.getTextColorRole()).setTextAlignY(Align::CenterY);
+
+    // --- Header: up button + current path ---
+    m_upButton = new Button(
+        Modifier().setWidth({itemH * 2.f, false}).setHeight({100.f, true})
+            .setOnLeftClick([this]() { goUp(); }),
+        ButtonOptions()
+            .setColor(o.getRowHoverColor()).setColorRole(o.getRowHoverColorRole())
+            .setLabel(new Text(Modifier().setWidth({100.f, true}).setHeight({100.f, true}),
+                               TextOptions(textOpts).setContent("..").setTextAlignX(Align::CenterX), "")),
+        "");
+    m_pathLabel = new Text(Modifier().setWidth({100.f, true}).setHeight({100.f, true}),
+                           TextOptions(textOpts).setContent(o.getPath()), "");
+    addElement(new Row(Modifier().setWidth({100.f, true}).setHeight({itemH, false}),
+                       RowOptions(), contains{ m_upButton, m_pathLabel }, ""));
+
+    // --- Search ---
+    if (o.getSearchBar()) {
+        TextboxOptions searchOpts;
+        if (!o.getFontPath().empty()) searchOpts.setFont(o.getFontPath());
+        if (o.hasCharSize()) searchOpts.setCharSize(o.getCharSize());
+        searchOpts
+            .setTextColor(o.getTextColor()).setTextColorRole(o.getTextColorRole())
+            .setBackgroundColor(o.getRowHoverColor()).setBackgroundColorRole(o.getRowHoverColorRole())
+            .setPlaceholder("Search")
+            .setOnStringChanged([this](const std::string& s) { setSearch(s); });
+        m_search = new Textbox(Modifier().setWidth({100.f, true}).setHeight({itemH, false}),
+                               searchOpts, "");
+        addElement(m_search);
+    }
+
+    // --- Entries ---
+    m_list = new VirtualColumn(
+        Modifier().setWidth({100.f, true}).setHeight({100.f, true}),
+        VirtualListOptions()
+            .setItemExtent(itemH)
+            .setCreateItem([this]() { return createRow(); })
+            .setBindItem([this](Element* e, size_t pos) {
+                for (size_t k = 0; k < m_rows.size(); ++k)
+                    if (m_rows[k].button == e) { bindRow(k, pos); return; }
+            }),
+        "");
+    addElement(m_list);
+}
+
+Element* Filebrowser::createRow() {
+    const FilebrowserOptions& o = m_browserOptions;
+    TextOptions textOpts;
+    if (!o.getFontPath().empty()) textOpts.setFont(o.getFontPath());
+    if (o.hasCharSize()) textOpts.setCharSize(o.getCharSize());
+    textOpts.setTextAlignY(Align::CenterY);
+
+    RowSlot row;
+    row.name = new Text(Modifier().setWidth({60.f, true}).setHeight({100.f, true}),
+                        TextOptions(textOpts).setColor(o.getTextColor()).setColorRole(o.getTextColorRole()), "");
+    const TextOptions detail = TextOptions(textOpts)
+        .setColor(o.getDetailTextColor()).setColorRole(o.getDetailTextColorRole());
+    row.size = new Text(Modifier().setWidth({15.f, true}).setHeight({100.f, true}),
+                        TextOptions(detail).setTextAlignX(Align::Right), "");
+    row.date = new Text(Modifier().setWidth({25.f, true}).setHeight({100.f, true}),
+                        TextOptions(detail).setTextAlignX(Align::Right), "");
+
+    const size_t slot = m_rows.size();
+    row.button = new Button(
+        Modifier().setWidth({100.f, true}).setHeight({o.getItemHeight(), false})
+            .setOnLeftClick([this, slot]() { activate(m_rows[slot].pos); }),
+        ButtonOptions().setLabel(row.name), "");
+    row.button->addElement(row.size);
+    row.button->addElement(row.date);
+    m_rows.push_back(row);
+    return row.button;
+}
+
+/*
+    bindRow(size_t slot, size_t pos):
+    - Params:   size_t slot, size_t pos
+    - Returns:  void
+    - Desc:     Shows the entry at filtered position `pos` in a recycled
+                row. Size and date come from the listing's metadata; an
+                entry that hasn't been read yet is queued for the worker
+                and its row is rebound when the result arrives.
+*/
+void Filebrowser::bindRow(size_t slot, size_t pos) {
+    RowSlot& row = m_rows[slot];
+    row.pos = pos;
+    if (!m_current || pos >= m_current->view.size()) return;
+
+    const uint32_t index = m_current->view[pos];
+    const Entry&   e     = m_current->entry(index);
+    row.name->setString(e.directory ? e.name + "/" : e.name);
+
+    Meta& meta = m_current->meta[index];
+    if (meta.state == kMetaUnknown) {
+        meta.state = kMetaRequested;
+        m_statQueue.push_back(index);
+    }
+    char size[32] = "";
+    char date[32] = "";
+    if (meta.state == kMetaReady) {
+        if (!e.directory) formatSize(size, sizeof(size), meta.size);
+        formatDate(date, sizeof(date), meta.modified);
+    }
+    row.size->setString(size);
+    row.date->setString(date);
+
+    const FilebrowserOptions& o = m_browserOptions;
+    styleListRow(*row.button, index == m_selectedEntry, m_hover.is(pos),
+                 o.getSelectedColor(), o.getSelectedColorRole(),
+                 o.getRowHoverColor(), o.getRowHoverColorRole());
+}
+
+void Filebrowser::activate(size_t pos) {
+    if (!m_current || pos >= m_current->view.size()) return;
+    const uint32_t index = m_current->view[pos];
+    const std::string path = entryPath(*m_current, index);
+    if (m_current->entry(index).directory) {
+        open(path, false);
+        return;
+    }
+    m_selectedEntry = index;
+    m_selectedPath  = path;
+    m_list->refresh();
+    if (m_browserOptions.getOnFileSelected()) m_browserOptions.getOnFileSelected()(m_selectedPath);
+}
+
+std::string Filebrowser::entryPath(const Listing& listing, uint32_t index) const {
+    return (fs::path(listing.path) / listing.entry(index).name).string();
+}
+
+// ---- Navigation ------------------------------------------------------------
+
+void Filebrowser::setPath(const std::string& path) {
+    if (!m_started) { m_browserOptions.setPath(path); return; }
+    open(path, false);
+}
+
+void Filebrowser::goUp() {
+    const fs::path parent = fs::path(m_path).parent_path();
+    if (parent.empty() || parent == fs::path(m_path)) return;
+    open(parent.string(), false);
+}
+
+void Filebrowser::refresh() {
+    if (m_started) open(m_path, true);
+}
+
+/*
+    open(const std::string& path, bool rescan):
+    - Params:   const std::string& path, bool rescan
+    - Returns:  void
+    - Desc:     Shows `path`. A complete cached listing is shown at once
+                (refiltered in the background if the filter changed since);
+                otherwise a fresh listing starts empty and the worker scans
+                into it. A listing left before its scan finished is dropped
+                and its scan cancelled.
+*/
+void Filebrowser::open(const std::string& path, bool rescan) {
+    std::error_code ec;
+    fs::path p = fs::absolute(fs::path(path), ec).lexically_normal();
+    if (ec) p = fs::path(path).lexically_normal();
+    std::string key = p.string();
+    if (key.size() > 1 && (key.back() == '/' || key.back() == '\\') && p.has_relative_path())
+        key.pop_back();
+
+    if (m_current && m_current->path == key && !rescan) return;
+    if (m_current && !m_current->complete) {
+        {
+            std::lock_guard<std::mutex> lock(m_worker->mutex);
+            m_worker->cancel = true;
+        }
+        m_worker->wake.notify_one();
+        m_cache.erase(m_current->path);
+    }
+    m_current = nullptr;
+    if (rescan) m_cache.erase(key);
+
+    auto it = m_cache.find(key);
+    if (it == m_cache.end()) {
+        auto listing = std::make_unique<Listing>();
+        listing->id      = m_nextId++;
+        listing->path    = key;
+        it = m_cache.emplace(key, std::move(listing)).first;
+        {
+            std::lock_guard<std::mutex> lock(m_worker->mutex);
+            m_worker->scan = Worker::ScanTask{ it->second->id, key };
+        }
+        m_worker->wake.notify_one();
+    }
+    // A new listing (viewGen 0) always asks, which also hands the worker
+    // the filter before it scans.
+    m_current = it->second.get();
+    m_current->lastUsed = ++m_useClock;
+    if (m_current->viewGen != m_filterGen) requestFilter();
+    evictListings();
+
+    const bool changed = key != m_path;
+    m_path = key;
+    m_selectedEntry = UINT32_MAX;
+    m_hover.reset();
+    m_pathLabel->setString(m_path);
+    showCurrent();
+    m_list->setScrollOffset(0.f);
+    if (changed && m_browserOptions.getOnDirectoryChanged())
+        m_browserOptions.getOnDirectoryChanged()(m_path);
+}
+
+void Filebrowser::showCurrent() {
+    m_list->setItemCount(m_current ? m_current->view.size() : 0);
+}
+
+void Filebrowser::evictListings() {
+    const size_t limit = std::max<size_t>(1, m_browserOptions.getCacheSize());
+    while (m_cache.size() > limit) {
+        auto oldest = m_cache.end();
+        for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
+            if (it->second.get() == m_current) continue;
+            if (oldest == m_cache.end() || it->second->lastUsed < oldest->second->lastUsed) oldest = it;
+        }
+        if (oldest == m_cache.end()) break;
+        m_cache.erase(oldest);
+    }
+}
+
+Filebrowser::Listing* Filebrowser::findListing(uint64_t id) const {
+    for (const auto& kv : m_cache)
+        if (kv.second->id == id) return kv.second.get();
+    return nullptr;
+}
+
+// ---- Filtering -------------------------------------------------------------
+
+void Filebrowser::setSearch(const std::string& query) {
+    std::string q = folded(query);
+    if (q == m_query) return;
+    m_query = std::move(q);
+    ++m_filterGen;
+    requestFilter();
+}
+
+void Filebrowser::setExtensions(std::vector<std::string> extensions) {
+    m_extensions.clear();
+    for (const auto& ext : extensions) {
+        if (ext.empty()) continue;
+        m_extensions.push_back(folded(ext[0] == '.' ? ext : "." + ext));
+    }
+    m_browserOptions.setExtensions(std::move(extensions));
+    ++m_filterGen;
+    requestFilter();
+}
+
+void Filebrowser::setShowHidden(bool v) {
+    if (v == m_showHidden) return;
+    m_showHidden = v;
+    m_browserOptions.setShowHidden(v);
+    ++m_filterGen;
+    requestFilter();
+}
+
+// The current view stays up until the worker's answer replaces it.
+void Filebrowser::requestFilter() {
+    if (!m_worker || !m_current) return;
+    {
+        std::lock_guard<std::mutex> lock(m_worker->mutex);
+        m_worker->filter = Worker::FilterTask{
+            m_current->id, m_filterGen,
+            FilterSpec{ m_query, m_extensions, m_showHidden },
+            m_current->chunks, m_current->complete };
+    }
+    m_worker->wake.notify_one();
+}
+
+// ---- Worker results --------------------------------------------------------
+
+void Filebrowser::drainWorker() {
+    std::vector<Worker::Message> messages;
+    {
+        std::lock_guard<std::mutex> lock(m_worker->mutex);
+        messages.swap(m_worker->outbox);
+    }
+    if (messages.empty()) return;
+
+    bool viewChanged = false;
+    bool rebind      = false;
+    for (auto& msg : messages) {
+        if (auto* c = std::get_if<Worker::ChunkMsg>(&msg)) {
+            Listing* l = findListing(c->listing);
+            if (!l) continue;
+            l->count += (uint32_t)c->chunk->entries.size();
+            l->chunks.push_back(std::move(c->chunk));
+            l->meta.resize(l->count);
+            // Matches for an older filter are covered by the view the
+            // worker sends for the newer one.
+            if (c->gen == l->viewGen)
+                l->view.insert(l->view.end(), c->matches.begin(), c->matches.end());
+            viewChanged |= l == m_current;
+        } else if (auto* v = std::get_if<Worker::ViewMsg>(&msg)) {
+            Listing* l = findListing(v->listing);
+            if (!l || v->gen < l->viewGen) continue;
+            l->view    = std::move(v->view);
+            l->viewGen = v->gen;
+            if (l == m_current) { viewChanged = true; m_hover.reset(); }
+        } else if (auto* d = std::get_if<Worker::DoneMsg>(&msg)) {
+            Listing* l = findListing(d->listing);
+            if (!l) continue;
+            l->complete = true;
+            if (!d->ok)
+                std::fprintf(stderr, "[UILO] Filebrowser: can't list \"%s\": %s\n",
+                             l->path.c_str(), d->error.c_str());
+        } else if (auto* s = std::get_if<Worker::StatMsg>(&msg)) {
+            if (m_statsInFlight) --m_statsInFlight;
+            Listing* l = findListing(s->listing);
+            if (!l || s->index >= l->meta.size()) continue;
+            l->meta[s->index] = s->meta;
+            rebind |= l == m_current;
+        }
+    }
+    if (viewChanged) showCurrent();
+    else if (rebind) m_list->refresh();
+}
+
+/*
+    flushStats():
+    - Params:   none
+    - Returns:  void
+    - Desc:     Hands this frame's stat requests to the worker. Requests it
+                hasn't started whose row has scrolled out of view are
+                withdrawn (and re-requested if the row comes back), so a
+                fast fling through a big folder doesn't leave a stat queued
+                for every row it passed.
+*/
+void Filebrowser::flushStats() {
+    if (!m_current) return;
+    FrameArena* arena = getFrameArena();
+    FrameVector<uint32_t> bound(arena);
+    bound.reserve(m_rows.size());
+    for (const auto& row : m_rows)
+        if (row.pos != ListRow::kNoRow && row.pos < m_current->view.size() &&
+            m_list->getItemElement(row.pos) == row.button)
+            bound.push_back(m_current->view[row.pos]);
+    auto isBound = [&](uint32_t index) {
+        return std::find(bound.begin(), bound.end(), index) != bound.end();
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(m_worker->mutex);
+        auto& q = m_worker->stats;
+        if (q.empty() && m_statQueue.empty()) return;
+        const size_t before = q.size();
+        q.erase(std::remove_if(q.begin(), q.end(), [&](const Worker::StatTask& t) {
+            if (t.listing == m_current->id && isBound(t.index)) return false;
+            if (Listing* l = findListing(t.listing))
+                if (t.index < l->meta.size()) l->meta[t.index].state = kMetaUnknown;
+            return true;
+        }), q.end());
+        m_statsInFlight -= std::min(m_statsInFlight, before - q.size());
+        for (uint32_t index : m_statQueue)
+            q.push_back({ m_current->id, index, entryPath(*m_current, index) });
+        m_statsInFlight += m_statQueue.size();
+    }
+    m_statQueue.clear();
+    m_worker->wake.notify_one();
+}
+
+bool Filebrowser::hasPendingWork() const {
+    if (m_statsInFlight > 0 || !m_statQueue.empty()) return true;
+    return m_current && (!m_current->complete || m_current->viewGen != m_filterGen);
+}
+
+size_t Filebrowser::getEntryCount()   const { return m_current ? m_current->count : 0; }
+size_t Filebrowser::getVisibleCount() const { return m_current ? m_current->view.size() : 0; }
+bool   Filebrowser::isScanning()      const { return m_current && !m_current->complete; }
+
+// ---- Update ----------------------------------------------------------------
+
+void Filebrowser::update(Rectf& parentBounds, float dt) {
+    if (!m_started) {
+        m_started = true;
+        m_worker  = std::make_unique<Worker>();
+        open(m_browserOptions.getPath(), false);
+    }
+    drainWorker();
+
+    Column::update(parentBounds, dt);
+    flushStats();
+
+    // The worker doesn't wake an on-demand loop; poll while it's busy.
+    if (m_uiloRef && hasPendingWork()) m_uiloRef->requestRedrawIn(kPollSeconds);
+}
+
+bool Filebrowser::checkHover(const Vec2f& mousePosition) {
+    m_hover.track(*m_list, m_rows, mousePosition);
+    return Column::checkHover(mousePosition);
+}
+
+void Filebrowser::releaseResources() {
+    Column::releaseResources();
+    for (auto it = m_cache.begin(); it != m_cache.end();) {
+        if (it->second.get() == m_current) ++it;
+        else it = m_cache.erase(it);
+    }
+}
+
+} // namespace uilo
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "../containers/Column.hpp"
+#include "../containers/ListRows.hpp"
+#include "../containers/VirtualList.hpp"
+#include "../decoration/Text.hpp"
+#include "../interactible/Button.hpp"
+#include "../interactible/Textbox.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace uilo {
+
+class FilebrowserOptions {
+public:
+    FilebrowserOptions() = default;
+
+    // Directory listed first.
+    FilebrowserOptions& setPath(const std::string& p)            { m_path = p;          return *this; }
+    // Only files with one of these extensions (".wav" or "wav", any case)
+    // are listed; directories always are. Empty lists every file.
+    FilebrowserOptions& setExtensions(std::vector<std::string> e) { m_extensions = std::move(e); return *this; }
+    // Dot files.
+    FilebrowserOptions& setShowHidden(bool v)                    { m_showHidden = v;    return *this; }
+    // A search box above the list; typing narrows it by name.
+    FilebrowserOptions& setSearchBar(bool v)                     { m_searchBar = v;     return *this; }
+    // Directories whose listing is kept for instant revisits.
+    FilebrowserOptions& setCacheSize(size_t n)                   { m_cacheSize = n;     return *this; }
+
+    FilebrowserOptions& setItemHeight(float h)                   { m_itemHeight = h;    return *this; }
+    FilebrowserOptions& setFont(const std::string& path)         { m_fontPath = path;   return *this; }
+    FilebrowserOptions& setCharSize(unsigned int n)              { m_charSize = n;      return *this; }
+    FilebrowserOptions& setColor(Color c)                        { m_color = c;         return *this; }
+    FilebrowserOptions& setColorRole(const std::string& r)       { m_colorRole = r;     return *this; }
+    FilebrowserOptions& setRowHoverColor(Color c)                { m_hoverColor = c;    return *this; }
+    FilebrowserOptions& setRowHoverColorRole(const std::string& r) { m_hoverColorRole = r; return *this; }
+    FilebrowserOptions& setSelectedColor(Color c)                { m_selectedColor = c; return *this; }
+    FilebrowserOptions& setSelectedColorRole(const std::string& r) { m_selectedColorRole = r; return *this; }
+    FilebrowserOptions& setTextColor(Color c)                    { m_textColor = c;     return *this; }
+    FilebrowserOptions& setTextColorRole(const std::string& r)   { m_textColorRole = r; return *this; }
+    // Size and date columns.
+    FilebrowserOptions& setDetailTextColor(Color c)              { m_detailColor = c;   return *this; }
+    FilebrowserOptions& setDetailTextColorRole(const std::string& r) { m_detailColorRole = r; return *this; }
+
+    // A file row was clicked; full path.
+    FilebrowserOptions& setOnFileSelected(std::function<void(const std::string&)> f) {
+        m_onFileSelected = std::move(f); return *this;
+    }
+    FilebrowserOptions& setOnDirectoryChanged(std::function<void(const std::string&)> f) {
+        m_onDirectoryChanged = std::move(f); return *this;
+    }
+
+    const std::string&              getPath()        const { return m_path; }
+    const std::vector<std::string>& getExtensions()  const { return m_extensions; }
+    bool               getShowHidden()        const { return m_showHidden; }
+    bool               getSearchBar()         const { return m_searchBar; }
+    size_t             getCacheSize()         const { return m_cacheSize; }
+    float              getItemHeight()        const { return m_itemHeight; }
+    const std::string& getFontPath()          const { return m_fontPath; }
+    unsigned int       getCharSize()          const { return m_charSize.value_or(14); }
+    bool               hasCharSize()          const { return m_charSize.has_value(); }
+    Color              getColor()             const { return m_color; }
+    const Role&        getColorRole()         const { return m_colorRole; }
+    Color              getRowHoverColor()     const { return m_hoverColor; }
+    const Role&        getRowHoverColorRole() const { return m_hoverColorRole; }
+    Color              getSelectedColor()     const { return m_selectedColor; }
+    const Role&        getSelectedColorRole() const { return m_selectedColorRole; }
+    Color              getTextColor()         const { return m_textColor; }
+    const Role&        getTextColorRole()     const { return m_textColorRole; }
+    Color              getDetailTextColor()   const { return m_detailColor; }
+    const Role&        getDetailTextColorRole() const { return m_detailColorRole; }
+    const std::function<void(const std::string&)>& getOnFileSelected()     const { return m_onFileSelected; }
+    const std::function<void(const std::string&)>& getOnDirectoryChanged() const { return m_onDirectoryChanged; }
+
+private:
+    std::string              m_path = ".";
+    std::vector<std::string> m_extensions;
+    bool         m_showHidden    = false;
+    bool         m_searchBar     = true;
+    size_t       m_cacheSize     = 16;
+    float        m_itemHeight    = 24.f;
+    std::string  m_fontPath;
+    std::optional<unsigned int> m_charSize;
+    Color        m_color         = Color{30, 30, 30, 255};
+    Role         m_colorRole;
+    Color        m_hoverColor    = Color{55, 55, 55, 255};
+    Role         m_hoverColorRole;
+    Color        m_selectedColor = Color{45, 75, 120, 255};
+    Role         m_selectedColorRole;
+    Color        m_textColor     = Color::White;
+    Role         m_textColorRole;
+    Color        m_detailColor   = Color{150, 150, 150, 255};
+    Role         m_detailColorRole;
+    std::function<void(const std::string&)> m_onFileSelected;
+    std::function<void(const std::string&)> m_onDirectoryChanged;
+};
+
+/*
+    Filebrowser — a directory listing for large folders and slow (network)
+    drives. A worker thread owned by the widget enumerates the directory
+    and streams entries into a VirtualColumn as they arrive, so the first
+    rows show before the scan is done and only the rows in view exist.
+    Name filtering (extensions, hidden files, the search box) and the
+    final directories-first sort run on the worker too. File size and
+    modification time are read lazily, only for rows that have been in
+    view. Listings, and the metadata read so far, are cached per
+    directory (setCacheSize); refresh() rescans the current one.
+    Clicking a directory opens it, clicking a file selects it.
+*/
+class Filebrowser : public Column {
+public:
+    explicit Filebrowser(Modifier modifier, FilebrowserOptions options = {},
+                         const std::string& name = "");
+    ~Filebrowser() override;
+
+    const FilebrowserOptions& getOptions() const { return m_browserOptions; }
+
+    void               setPath(const std::string& path);
+    const std::string& getPath() const { return m_path; }
+    void               goUp();
+    void               refresh();
+
+    void               setSearch(const std::string& query);
+    const std::string& getSearch() const { return m_query; }
+    void               setExtensions(std::vector<std::string> extensions);
+    void               setShowHidden(bool v);
+
+    // Entries found so far in the current directory, and how many of them
+    // pass the filter.
+    size_t getEntryCount()   const;
+    size_t getVisibleCount() const;
+    bool   isScanning()      const;
+    const std::string& getSelectedPath() const { return m_selectedPath; }
+
+    void update(Rectf& parentBounds, float dt) override;
+    bool checkHover(const Vec2f& mousePosition) override;
+    void releaseResources() override;
+
+private:
+    struct Entry;
+    struct EntryChunk;
+    struct Listing;
+    struct Worker;
+
+    // One recycled list row and the filtered position it shows.
+    struct RowSlot : ListRow {
+        Text*   name   = nullptr;
+        Text*   size   = nullptr;
+        Text*   date   = nullptr;
+    };
+
+    // Polls the worker while a scan, filter or stat is outstanding.
+    bool wantsUpdate() const override { return !m_started || hasPendingWork(); }
+    // update() drains the worker and may request frames: never solved
+    // flat or on a layout worker.
+    bool parallelSafe() const override { return false; }
+    LayoutAxis layoutAxis() const override { return LayoutAxis::None; }
+
+    void     buildParts();
+    Element* createRow();
+    void     bindRow(size_t slot, size_t pos);
+    void     activate(size_t pos);
+    void     open(const std::string& path, bool rescan);
+    void     requestFilter();
+    void     showCurrent();
+    void     drainWorker();
+    void     flushStats();
+    bool     hasPendingWork() const;
+    Listing* findListing(uint64_t id) const;
+    void     evictListings();
+    std::string entryPath(const Listing& listing, uint32_t index) const;
+
+    FilebrowserOptions m_browserOptions;
+    std::string        m_path;
+    std::string        m_query;
+    std::vector<std::string> m_extensions;     // lowercased, with the dot
+    bool               m_showHidden = false;
+    bool               m_started    = false;
+
+    std::unique_ptr<Worker> m_worker;
+    std::unordered_map<std::string, std::unique_ptr<Listing>> m_cache;
+    Listing*           m_current    = nullptr;
+    uint64_t           m_nextId     = 1;
+    uint64_t           m_useClock   = 0;
+    uint64_t           m_filterGen  = 1;
+    std::vector<uint32_t> m_statQueue;         // entries to stat, current listing
+    size_t             m_statsInFlight = 0;
+
+    uint32_t           m_selectedEntry = UINT32_MAX;
+    std::string        m_selectedPath;
+    ListRowHover       m_hover;
+
+    Text*              m_pathLabel  = nullptr;
+    Button*            m_upButton   = nullptr;
+    Textbox*           m_search     = nullptr;
+    VirtualColumn*     m_list       = nullptr;
+    std::vector<RowSlot> m_rows;
+};
+
+} // namespace uilo
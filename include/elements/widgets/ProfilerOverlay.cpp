@@ -0,0 +1,134 @@
+#include "ProfilerOverlay.hpp"
+
+#if UILO_PROFILER
+
+#include "../../UILO.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace uilo {
+
+namespace {
+constexpr float kLineHeight  = 16.f;   // logical px
+constexpr float kTextSize    = 12.f;
+constexpr float kPadding     = 6.f;
+constexpr float kLabelWidth  = 220.f;
+constexpr float kColumnWidth = 64.f;
+constexpr int   kColumns     = 4;
+constexpr int   kMaxIndent   = 8;
+
+std::string formatBytes(uint64_t bytes) {
+    char buf[32];
+    if      (bytes >= (1ull << 20)) std::snprintf(buf, sizeof(buf), "%.1f MB", (double)bytes / (1 << 20));
+    else if (bytes >= (1ull << 10)) std::snprintf(buf, sizeof(buf), "%.1f KB", (double)bytes / (1 << 10));
+    else                            std::snprintf(buf, sizeof(buf), "%llu B", (unsigned long long)bytes);
+    return buf;
+}
+} // anon
+
+ProfilerOverlay::ProfilerOverlay(Modifier modifier, size_t rows, const std::string& name)
+    : m_rows(std::max<size_t>(1, rows)) {
+    m_modifier = modifier;
+    m_name     = name;
+}
+
+void ProfilerOverlay::refresh() {
+    m_uiloRef->topProfiledSubtrees(m_rows + 1, m_scratch);
+    m_scratch.erase(std::remove(m_scratch.begin(), m_scratch.end(), this), m_scratch.end());
+    if (m_scratch.size() > m_rows) m_scratch.resize(m_rows);
+
+    m_table.clear();
+    for (Element* e : m_scratch) {
+        int depth = 0;
+        for (Element* p = e->m_parent; p && depth < kMaxIndent; p = p->m_parent) ++depth;
+        const ElementProfile& p = e->m_profile;
+        Row row;
+        row.label.assign((size_t)depth, ' ');
+        row.label += e->m_name.empty() ? elementTypeName(e->m_type) : e->m_name;
+        row.updateMs = p.avgUpdateMs;
+        row.renderMs = p.avgRenderMs;
+        row.draws    = p.lastDraws;
+        row.vertices = p.lastVertices;
+        m_table.push_back(std::move(row));
+    }
+
+    const UiloMemoryStats mem = m_uiloRef->getMemoryStats();
+    const RendererMemoryStats& r = mem.renderer;
+    uint64_t faceTables = 0;
+    for (const auto& f : r.faces) faceTables += f.tableBytes;
+    char count[48];
+    std::snprintf(count, sizeof(count), "elements (%u)", mem.elements);
+    m_memory.clear();
+    m_memory.emplace_back("memory total",     formatBytes(mem.totalBytes()));
+    m_memory.emplace_back("  font files",     formatBytes(r.fontFileBytes));
+    m_memory.emplace_back("  font tables",    formatBytes(faceTables));
+    m_memory.emplace_back("  glyph atlas",    formatBytes(r.glyphAtlasBytes));
+    m_memory.emplace_back("  glyph shadow",   formatBytes(r.glyphShadowBytes));
+    m_memory.emplace_back("  textures",       formatBytes(r.textureBytes));
+    m_memory.emplace_back("  pipeline",       formatBytes(r.pipelineTargetBytes));
+    m_memory.emplace_back("  framebuffers",   formatBytes(r.frameBufferBytes + r.frameBufferPoolBytes));
+    m_memory.emplace_back(std::string("  ") + count, formatBytes(mem.elementBytes));
+    m_memory.emplace_back("  waveform data",  formatBytes(mem.waveformSampleBytes + mem.waveformPeakBytes));
+    m_memory.emplace_back("mapped font files", formatBytes(r.fontMappedBytes));
+}
+
+void ProfilerOverlay::update(Rectf& parentBounds, float dt) {
+    if (!m_uiloRef) return;
+    if (!m_font.valid()) m_font = m_uiloRef->getRenderer().loadFont("");
+    m_sinceRefresh += dt;
+    if (m_sinceRefresh >= kRefreshSeconds) {
+        m_sinceRefresh = 0.f;
+        refresh();
+    }
+    const float scale = m_uiloRef->getScale();
+    m_bounds.position = parentBounds.position;
+    m_bounds.size = {
+        (kLabelWidth + kColumns * kColumnWidth + 2.f * kPadding) * scale,
+        ((float)(m_table.size() + m_memory.size() + 1) * kLineHeight + 2.f * kPadding) * scale,
+    };
+    m_uiloRef->requestRedraw();
+}
+
+void ProfilerOverlay::render() {
+    m_dirty = false;
+    if (!m_uiloRef || !m_font.valid()) return;
+    auto& renderer = m_uiloRef->getRenderer();
+    const float scale = m_uiloRef->getScale();
+    const float lineH = kLineHeight * scale;
+    const float px    = kTextSize * scale;
+    const float x0    = m_bounds.position.x + kPadding * scale;
+    float       y     = m_bounds.position.y + kPadding * scale;
+
+    renderer.draw(Rect{m_bounds.position, m_bounds.size, Color{16, 16, 22, 220}});
+
+    auto line = [&](const char* label, const char* const cols[kColumns], Color c) {
+        renderer.drawText(label, {x0, y}, m_font, px, c);
+        for (int i = 0; i < kColumns; ++i)
+            renderer.drawText(cols[i], {x0 + (kLabelWidth + (float)i * kColumnWidth) * scale, y},
+                              m_font, px, c);
+        y += lineH;
+    };
+    static const char* const kHeader[kColumns] = { "upd ms", "rnd ms", "draws", "verts" };
+    line("subtree", kHeader, Color{150, 150, 170, 255});
+
+    char buf[kColumns][24];
+    const char* cols[kColumns] = { buf[0], buf[1], buf[2], buf[3] };
+    for (const Row& row : m_table) {
+        std::snprintf(buf[0], sizeof(buf[0]), "%.3f", row.updateMs);
+        std::snprintf(buf[1], sizeof(buf[1]), "%.3f", row.renderMs);
+        std::snprintf(buf[2], sizeof(buf[2]), "%u", row.draws);
+        std::snprintf(buf[3], sizeof(buf[3]), "%u", row.vertices);
+        line(row.label.c_str(), cols, Color{225, 225, 235, 255});
+    }
+
+    static const char* const kBlank[kColumns] = { "", "", "", "" };
+    for (const auto& [label, value] : m_memory) {
+        const char* memCols[kColumns] = { value.c_str(), kBlank[1], kBlank[2], kBlank[3] };
+        line(label.c_str(), memCols, Color{180, 200, 225, 255});
+    }
+}
+
+} // namespace uilo
+
+#endif // UILO_PROFILER
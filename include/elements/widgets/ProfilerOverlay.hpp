@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../Element.hpp"
+#include "../../renderer/Renderer.hpp"
+
+#if UILO_PROFILER
+
+#include <string>
+#include <vector>
+
+namespace uilo {
+
+/*
+    ProfilerOverlay — floating table of the subtrees that cost the most of
+    late (see ElementProfile): smoothed update and render time, plus the
+    draw calls and vertices they emitted last frame, over a summary of
+    UILO::getMemoryStats() by subsystem. Only exists in
+    UILO_PROFILER builds. Float it with
+        ui.addFloating(profilerOverlay().setPosition(8_px, 8_px).setDraggable(true));
+    It sizes itself to its rows, refreshes a few times a second, and keeps
+    on-demand mode presenting while it's up.
+*/
+class ProfilerOverlay : public Element {
+public:
+    explicit ProfilerOverlay(Modifier modifier = {}, size_t rows = 20, const std::string& name = "");
+
+    void update(Rectf& parentBounds, float dt) override;
+    void render() override;
+    bool isDirty() const override { return true; }
+
+private:
+    struct Row {
+        std::string label;
+        float       updateMs = 0.f;
+        float       renderMs = 0.f;
+        uint32_t    draws    = 0;
+        uint32_t    vertices = 0;
+    };
+    static constexpr float kRefreshSeconds = 0.25f;
+
+    bool wantsUpdate() const override { return true; }
+    void refresh();
+
+    size_t                m_rows;
+    std::vector<Row>      m_table;
+    std::vector<std::pair<std::string, std::string>> m_memory;   // label, value
+    std::vector<Element*> m_scratch;
+    float                 m_sinceRefresh = kRefreshSeconds;
+    Font                  m_font;
+};
+
+} // namespace uilo
+
+#endif // UILO_PROFILER
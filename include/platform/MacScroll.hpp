@@ -44,6 +44,10 @@ void tickMacScrollMomentum(float dtSeconds);
 // receive momentum (sliders, knobs, etc.) when a momentum tick reaches them.
 void cancelMacScrollMomentum();
 
+// True while a synthesized momentum tail is still coasting, so callers that
+// skip idle frames know to keep ticking. Always false on non-macOS.
+bool isMacScrollMomentumActive();
+
 // Trackpad pinch (NSEventTypeMagnify). magnification is the per-event
 // delta (NSEvent.magnification), already normalized so that the running
 // sum across a gesture roughly equals (finalScale - 1). Callback returns
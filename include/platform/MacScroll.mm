@@ -154,6 +154,10 @@ void cancelMacScrollMomentum() {
     g_velYPxPerSec = 0.f;
 }
 
+bool isMacScrollMomentumActive() {
+    return g_coasting;
+}
+
 namespace { id g_zoomMonitor = nil; std::function<bool(float)> g_zoomCb; }
 
 bool installMacZoomMonitor(std::function<bool(float)> cb) {
@@ -178,6 +182,7 @@ namespace uilo {
 bool installMacScrollMonitor(std::function<bool(float, float, bool)>) { return false; }
 void tickMacScrollMomentum(float) {}
 void cancelMacScrollMomentum() {}
+bool isMacScrollMomentumActive() { return false; }
 bool installMacZoomMonitor(std::function<bool(float)>) { return false; }
 }
 
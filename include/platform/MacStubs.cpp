@@ -15,6 +15,7 @@ bool configureMacWindowForLiveResize(void*) { return false; }
 bool installMacScrollMonitor(std::function<bool(float, float, bool)>) { return false; }
 bool installMacZoomMonitor  (std::function<bool(float)>)              { return false; }
 void tickMacScrollMomentum  (float)                                    {}
+bool isMacScrollMomentumActive()                                       { return false; }
 
 } // namespace uilo
 
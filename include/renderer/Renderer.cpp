@@ -27,6 +27,7 @@
 #include <cstdlib>
 #include <string_view>
 #include <thread>
+#include <unordered_set>
 
 #if defined(SDL_PLATFORM_LINUX)
 #  include <X11/Xlib.h>
@@ -38,46 +39,76 @@
 
 #include "spirv/vs_solid.sc.bin.h"
 #include "spirv/vs_tex.sc.bin.h"
+#include "spirv/vs_glass.sc.bin.h"
 #include "spirv/fs_solid.sc.bin.h"
 #include "spirv/fs_tex.sc.bin.h"
 #include "spirv/fs_text.sc.bin.h"
+#include "spirv/fs_text_sdf.sc.bin.h"
 #include "spirv/fs_blur.sc.bin.h"
+#include "spirv/fs_kawase.sc.bin.h"
 #include "spirv/fs_glass.sc.bin.h"
+#include "spirv/fs_waveform.sc.bin.h"
+#include "spirv/vs_shape.sc.bin.h"
+#include "spirv/fs_shape.sc.bin.h"
 
 #include "glsl/vs_solid.sc.bin.h"
 #include "glsl/vs_tex.sc.bin.h"
+#include "glsl/vs_glass.sc.bin.h"
 #include "glsl/fs_solid.sc.bin.h"
 #include "glsl/fs_tex.sc.bin.h"
 #include "glsl/fs_text.sc.bin.h"
+#include "glsl/fs_text_sdf.sc.bin.h"
 #include "glsl/fs_blur.sc.bin.h"
+#include "glsl/fs_kawase.sc.bin.h"
 #include "glsl/fs_glass.sc.bin.h"
+#include "glsl/fs_waveform.sc.bin.h"
+#include "glsl/vs_shape.sc.bin.h"
+#include "glsl/fs_shape.sc.bin.h"
 
 #include "essl/vs_solid.sc.bin.h"
 #include "essl/vs_tex.sc.bin.h"
+#include "essl/vs_glass.sc.bin.h"
 #include "essl/fs_solid.sc.bin.h"
 #include "essl/fs_tex.sc.bin.h"
 #include "essl/fs_text.sc.bin.h"
+#include "essl/fs_text_sdf.sc.bin.h"
 #include "essl/fs_blur.sc.bin.h"
+#include "essl/fs_kawase.sc.bin.h"
 #include "essl/fs_glass.sc.bin.h"
+#include "essl/fs_waveform.sc.bin.h"
+#include "essl/vs_shape.sc.bin.h"
+#include "essl/fs_shape.sc.bin.h"
 
 #if BX_PLATFORM_OSX || BX_PLATFORM_IOS
 #  include "metal/vs_solid.sc.bin.h"
 #  include "metal/vs_tex.sc.bin.h"
+#  include "metal/vs_glass.sc.bin.h"
 #  include "metal/fs_solid.sc.bin.h"
 #  include "metal/fs_tex.sc.bin.h"
 #  include "metal/fs_text.sc.bin.h"
+#  include "metal/fs_text_sdf.sc.bin.h"
 #  include "metal/fs_blur.sc.bin.h"
+#  include "metal/fs_kawase.sc.bin.h"
 #  include "metal/fs_glass.sc.bin.h"
+#  include "metal/fs_waveform.sc.bin.h"
+#  include "metal/vs_shape.sc.bin.h"
+#  include "metal/fs_shape.sc.bin.h"
 #endif
 
 #if BX_PLATFORM_WINDOWS
 #  include "dxbc/vs_solid.sc.bin.h"
 #  include "dxbc/vs_tex.sc.bin.h"
+#  include "dxbc/vs_glass.sc.bin.h"
 #  include "dxbc/fs_solid.sc.bin.h"
 #  include "dxbc/fs_tex.sc.bin.h"
 #  include "dxbc/fs_text.sc.bin.h"
+#  include "dxbc/fs_text_sdf.sc.bin.h"
 #  include "dxbc/fs_blur.sc.bin.h"
+#  include "dxbc/fs_kawase.sc.bin.h"
 #  include "dxbc/fs_glass.sc.bin.h"
+#  include "dxbc/fs_waveform.sc.bin.h"
+#  include "dxbc/vs_shape.sc.bin.h"
+#  include "dxbc/fs_shape.sc.bin.h"
 #endif
 
 namespace uilo {
@@ -87,10 +118,16 @@ namespace {
         BGFX_EMBEDDED_SHADER(vs_solid),
         BGFX_EMBEDDED_SHADER(fs_solid),
         BGFX_EMBEDDED_SHADER(vs_tex),
+        BGFX_EMBEDDED_SHADER(vs_glass),
         BGFX_EMBEDDED_SHADER(fs_tex),
         BGFX_EMBEDDED_SHADER(fs_text),
+        BGFX_EMBEDDED_SHADER(fs_text_sdf),
         BGFX_EMBEDDED_SHADER(fs_blur),
+        BGFX_EMBEDDED_SHADER(fs_kawase),
         BGFX_EMBEDDED_SHADER(fs_glass),
+        BGFX_EMBEDDED_SHADER(fs_waveform),
+        BGFX_EMBEDDED_SHADER(vs_shape),
+        BGFX_EMBEDDED_SHADER(fs_shape),
         BGFX_EMBEDDED_SHADER_END(),
     };
 }
@@ -104,33 +141,53 @@ void Renderer::Impl::ensureLayouts() {
     solidLayout.begin()
         .add(bgfx::Attrib::Position,  2, bgfx::AttribType::Float)
         .add(bgfx::Attrib::Color0,    4, bgfx::AttribType::Uint8, true)
+        .add(bgfx::Attrib::TexCoord1, 1, bgfx::AttribType::Float)
         .end();
     texLayout.begin()
         .add(bgfx::Attrib::Position,  2, bgfx::AttribType::Float)
         .add(bgfx::Attrib::Color0,    4, bgfx::AttribType::Uint8, true)
         .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
+        .add(bgfx::Attrib::TexCoord1, 1, bgfx::AttribType::Float)
+        .end();
+    glassLayout.begin()
+        .add(bgfx::Attrib::Position,  2, bgfx::AttribType::Float)
+        .add(bgfx::Attrib::Color0,    4, bgfx::AttribType::Uint8, true)
+        .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
+        .add(bgfx::Attrib::Color1,    4, bgfx::AttribType::Uint8, true)
+        .add(bgfx::Attrib::Color2,    4, bgfx::AttribType::Uint8, true)
+        .add(bgfx::Attrib::TexCoord1, 4, bgfx::AttribType::Float)
+        .add(bgfx::Attrib::TexCoord2, 4, bgfx::AttribType::Float)
+        .add(bgfx::Attrib::TexCoord3, 4, bgfx::AttribType::Float)
+        .end();
+    quadLayout.begin()
+        .add(bgfx::Attrib::Position,  2, bgfx::AttribType::Float)
         .end();
     layoutsInit = true;
 }
 
 bool Renderer::Impl::initShaders() {
+    // An initShared() window draws with its primary's programs; only the
+    // clip table is its own.
+    if (shared->programsInit) {
+        initClipTable();
+        return true;
+    }
     const bgfx::RendererType::Enum type = bgfx::getRendererType();
 
+    // Glass, blur and waveform programs wait for their first draw
+    // (ensureGlassPrograms / ensureWaveformProgram).
     bgfx::ShaderHandle vs   = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_solid");
     bgfx::ShaderHandle fs   = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_solid");
     bgfx::ShaderHandle vst1 = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_tex");
     bgfx::ShaderHandle vst2 = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_tex");
-    bgfx::ShaderHandle vst3 = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_tex");
-    bgfx::ShaderHandle vst4 = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_tex");
+    bgfx::ShaderHandle vst5 = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_tex");
     bgfx::ShaderHandle fst  = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_tex");
     bgfx::ShaderHandle ftx  = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_text");
-    bgfx::ShaderHandle fbl  = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_blur");
-    bgfx::ShaderHandle fgl  = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_glass");
+    bgfx::ShaderHandle fsd  = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_text_sdf");
     if (!bgfx::isValid(vs)   || !bgfx::isValid(fs)   ||
         !bgfx::isValid(vst1) || !bgfx::isValid(vst2) ||
-        !bgfx::isValid(vst3) || !bgfx::isValid(vst4) ||
         !bgfx::isValid(fst)  || !bgfx::isValid(ftx)  ||
-        !bgfx::isValid(fbl)  || !bgfx::isValid(fgl)) {
+        !bgfx::isValid(vst5) || !bgfx::isValid(fsd)) {
         std::fprintf(stderr, "[UILO] Failed to create shaders (renderer=%s)\n",
                      bgfx::getRendererName(type));
         return false;
@@ -138,46 +195,225 @@ bool Renderer::Impl::initShaders() {
     solidProgram = bgfx::createProgram(vs,   fs,  true);
     texProgram   = bgfx::createProgram(vst1, fst, true);
     textProgram  = bgfx::createProgram(vst2, ftx, true);
-    blurProgram  = bgfx::createProgram(vst3, fbl, true);
-    glassProgram = bgfx::createProgram(vst4, fgl, true);
+    textSdfProgram = bgfx::createProgram(vst5, fsd, true);
     s_texColor   = bgfx::createUniform("s_texColor",   bgfx::UniformType::Sampler);
+    s_texLadder  = bgfx::createUniform("s_texLadder",  bgfx::UniformType::Sampler);
     u_imgFlags   = bgfx::createUniform("u_imgFlags",   bgfx::UniformType::Vec4);
     u_blurParams = bgfx::createUniform("u_blurParams", bgfx::UniformType::Vec4);
-    u_glassParams= bgfx::createUniform("u_glassParams",bgfx::UniformType::Vec4);
-    u_glassTint  = bgfx::createUniform("u_glassTint",  bgfx::UniformType::Vec4);
-    u_glassRect  = bgfx::createUniform("u_glassRect",  bgfx::UniformType::Vec4);
-    u_glassAnim  = bgfx::createUniform("u_glassAnim",  bgfx::UniformType::Vec4);
-    u_glassBase  = bgfx::createUniform("u_glassBase",  bgfx::UniformType::Vec4);
-    u_glassMouse = bgfx::createUniform("u_glassMouse", bgfx::UniformType::Vec4);
+    u_blurClamp  = bgfx::createUniform("u_blurClamp",  bgfx::UniformType::Vec4);
+    u_glassFrame = bgfx::createUniform("u_glassFrame", bgfx::UniformType::Vec4);
+    u_waveParams = bgfx::createUniform("u_waveParams", bgfx::UniformType::Vec4);
+    u_waveSize   = bgfx::createUniform("u_waveSize",   bgfx::UniformType::Vec4);
     u_clipRect   = bgfx::createUniform("u_clipRect",   bgfx::UniformType::Vec4);
     u_clipParams = bgfx::createUniform("u_clipParams", bgfx::UniformType::Vec4);
     u_clipRect2  = bgfx::createUniform("u_clipRect2",  bgfx::UniformType::Vec4);
     u_clipParams2= bgfx::createUniform("u_clipParams2",bgfx::UniformType::Vec4);
+    initShapeInstancing(type);
+    initClipTable();
     if (!bgfx::isValid(solidProgram) ||
         !bgfx::isValid(texProgram)   ||
         !bgfx::isValid(textProgram)  ||
-        !bgfx::isValid(blurProgram)  ||
-        !bgfx::isValid(glassProgram)) {
+        !bgfx::isValid(textSdfProgram)) {
         std::fprintf(stderr, "[UILO] Failed to create shader programs\n");
         return false;
     }
+    shared->programsInit = true;
     return true;
 }
+
+bgfx::ProgramHandle Renderer::Impl::createLazyProgram(const char* vsName, const char* fsName) {
+    const bgfx::RendererType::Enum type = bgfx::getRendererType();
+    bgfx::ShaderHandle vsh = bgfx::createEmbeddedShader(s_embeddedShaders, type, vsName);
+    bgfx::ShaderHandle fsh = bgfx::createEmbeddedShader(s_embeddedShaders, type, fsName);
+    if (!bgfx::isValid(vsh) || !bgfx::isValid(fsh)) {
+        if (bgfx::isValid(vsh)) bgfx::destroy(vsh);
+        if (bgfx::isValid(fsh)) bgfx::destroy(fsh);
+        std::fprintf(stderr, "[UILO] Failed to create %s/%s (renderer=%s)\n",
+                     vsName, fsName, bgfx::getRendererName(type));
+        return BGFX_INVALID_HANDLE;
+    }
+    return bgfx::createProgram(vsh, fsh, true);
+}
+
+bool Renderer::Impl::ensureGlassPrograms() {
+    CacheLock lock(*this);
+    if (!shared->glassTried) {
+        shared->glassTried = true;
+        glassProgram  = createLazyProgram("vs_glass", "fs_glass");
+        blurProgram   = createLazyProgram("vs_tex",   "fs_blur");
+        kawaseProgram = createLazyProgram("vs_tex",   "fs_kawase");   // optional: no ladder without it
+        if (!bgfx::isValid(glassProgram) || !bgfx::isValid(blurProgram))
+            std::fprintf(stderr, "[UILO] Glass unavailable; glass elements won't draw\n");
+    }
+    return bgfx::isValid(glassProgram) && bgfx::isValid(blurProgram);
+}
+
+bool Renderer::Impl::ensureWaveformProgram() {
+    CacheLock lock(*this);
+    if (!shared->waveformTried) {
+        shared->waveformTried = true;
+        waveformProgram = createLazyProgram("vs_tex", "fs_waveform");
+    }
+    return bgfx::isValid(waveformProgram);
+}
+
+void Renderer::Impl::initShapeInstancing(bgfx::RendererType::Enum type) {
+    // Optional: without it every shape takes the solid batch, as before.
+    const bgfx::Caps* caps = bgfx::getCaps();
+    if (!caps || !(caps->supported & BGFX_CAPS_INSTANCING)) return;
+    bgfx::ShaderHandle vsh = bgfx::createEmbeddedShader(s_embeddedShaders, type, "vs_shape");
+    bgfx::ShaderHandle fsh = bgfx::createEmbeddedShader(s_embeddedShaders, type, "fs_shape");
+    if (!bgfx::isValid(vsh) || !bgfx::isValid(fsh)) {
+        if (bgfx::isValid(vsh)) bgfx::destroy(vsh);
+        if (bgfx::isValid(fsh)) bgfx::destroy(fsh);
+        std::fprintf(stderr, "[UILO] Instanced shape shaders unavailable; using the solid batch\n");
+        return;
+    }
+    shapeProgram = bgfx::createProgram(vsh, fsh, true);
+    u_shapeXform = bgfx::createUniform("u_shapeXform", bgfx::UniformType::Vec4, 2);
+
+    static const float kUnitQuad[8]    = { 0.f, 0.f,  1.f, 0.f,  1.f, 1.f,  0.f, 1.f };
+    static const uint16_t kUnitQuadIdx[6] = { 0, 1, 2, 0, 2, 3 };
+    unitQuadVb = bgfx::createVertexBuffer(bgfx::makeRef(kUnitQuad, sizeof(kUnitQuad)), quadLayout);
+    unitQuadIb = bgfx::createIndexBuffer(bgfx::makeRef(kUnitQuadIdx, sizeof(kUnitQuadIdx)));
+    shapeInstancing = bgfx::isValid(shapeProgram) && bgfx::isValid(unitQuadVb) &&
+                      bgfx::isValid(unitQuadIb);
+}
+
+void Renderer::Impl::initClipTable() {
+    clipTableSupported = false;
+    const bgfx::Caps* caps = bgfx::getCaps();
+    if (!(caps->formats[bgfx::TextureFormat::RGBA32F] & BGFX_CAPS_FORMAT_TEXTURE_2D)) {
+        std::fprintf(stderr, "[UILO] RGBA32F textures unsupported; indexed clips unavailable\n");
+        return;
+    }
+    clipTableTex = bgfx::createTexture2D(
+        (uint16_t)kClipTableWidth, (uint16_t)kClipTableHeight, false, 1,
+        bgfx::TextureFormat::RGBA32F,
+        BGFX_SAMPLER_POINT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP, nullptr);
+    if (!bgfx::isValid(clipTableTex)) return;
+    clipTableData.assign((size_t)kClipTableWidth * kClipTableHeight * 4, 0.f);
+    bgfx::updateTexture2D(clipTableTex, 0, 0, 0, 0,
+                          (uint16_t)kClipTableWidth, (uint16_t)kClipTableHeight,
+                          bgfx::copy(clipTableData.data(),
+                                     (uint32_t)(clipTableData.size() * sizeof(float))));
+    s_clipTable = bgfx::createUniform("s_clipTable", bgfx::UniformType::Sampler);
+    u_clipTable = bgfx::createUniform("u_clipTable", bgfx::UniformType::Vec4);
+    clipNodes.assign(1, ClipNode{});
+    clipNodeDepth.assign(1, 0);
+    clipNodeIds.clear();
+    clipNodesUploaded  = 1;
+    clipTableSupported = true;
+}
+
+void Renderer::Impl::destroyClipTable() {
+    if (bgfx::isValid(clipTableTex)) bgfx::destroy(clipTableTex);
+    if (bgfx::isValid(s_clipTable))  bgfx::destroy(s_clipTable);
+    if (bgfx::isValid(u_clipTable))  bgfx::destroy(u_clipTable);
+    clipTableTex = BGFX_INVALID_HANDLE;
+    s_clipTable  = BGFX_INVALID_HANDLE;
+    u_clipTable  = BGFX_INVALID_HANDLE;
+    clipTableSupported = false;
+    clipTableOn        = false;
+    clipNodes.clear();
+    clipNodeDepth.clear();
+    clipNodeIds.clear();
+    clipTableData.clear();
+}
+
+uint32_t Renderer::Impl::internClipNode(const ClipNode& n) {
+    CacheLock lock(*this);
+    const uint64_t key = hashBytes(kHashBasis, &n, sizeof(n));
+    auto it = clipNodeIds.find(key);
+    if (it != clipNodeIds.end() &&
+        std::memcmp(&clipNodes[it->second], &n, sizeof(n)) == 0)
+        return it->second;
+    if (clipNodeDepth[n.parent] >= kClipChainMax) return 0;
+    if (clipNodes.size() >= kClipTableNodes) {
+        if (!clipTableFullWarned)
+            std::fprintf(stderr, "[UILO] Clip table full (%u nodes); new clips are "
+                                 "scissor-only until the next frame\n", kClipTableNodes);
+        clipTableFullWarned = true;
+        return 0;
+    }
+    // A colliding key keeps its first node; this one just isn't shared.
+    const uint32_t id = (uint32_t)clipNodes.size();
+    clipNodes.push_back(n);
+    clipNodeDepth.push_back((uint8_t)(clipNodeDepth[n.parent] + 1));
+    if (it == clipNodeIds.end()) clipNodeIds.emplace(key, id);
+    float* t = &clipTableData[(size_t)id * 8];
+    t[0] = n.cx;     t[1] = n.cy;            t[2] = n.halfW; t[3] = n.halfH;
+    t[4] = n.radius; t[5] = (float)n.parent; t[6] = 0.f;     t[7] = 0.f;
+    return id;
+}
+
+void Renderer::Impl::beginClipTableFrame() {
+    clipTableOn = clipTableWanted && clipTableSupported;
+    if (!clipTableOn || clipNodes.size() <= kClipTableNodes / 2) return;
+    // Nothing queued names the old ids any more.
+    clipNodes.resize(1);
+    clipNodeDepth.resize(1);
+    clipNodeIds.clear();
+    clipNodesUploaded   = 1;
+    clipTableFullWarned = false;
+    ++clipGeneration;
+}
+
+void Renderer::Impl::uploadClipTable() {
+    const uint32_t n = (uint32_t)clipNodes.size();
+    if (!bgfx::isValid(clipTableTex) || n <= clipNodesUploaded) return;
+    // Whole rows, from the one holding the first new node.
+    const uint32_t row0 = clipNodesUploaded * 2 / kClipTableWidth;
+    const uint32_t row1 = (n * 2 - 1) / kClipTableWidth + 1;
+    const size_t   rowFloats = (size_t)kClipTableWidth * 4;
+    bgfx::updateTexture2D(clipTableTex, 0, 0, 0, (uint16_t)row0,
+                          (uint16_t)kClipTableWidth, (uint16_t)(row1 - row0),
+                          bgfx::copy(&clipTableData[row0 * rowFloats],
+                                     (uint32_t)((row1 - row0) * rowFloats * sizeof(float))));
+    clipNodesUploaded = n;
+}
+
+void Renderer::Impl::bindClipTable() {
+    if (!bgfx::isValid(clipTableTex)) return;
+    static constexpr float kTable[4] = {
+        1.f / (float)kClipTableWidth, 1.f / (float)kClipTableHeight, (float)kClipTableWidth, 0.f,
+    };
+    bgfx::Encoder* e = enc();
+    e->setTexture(1, s_clipTable, clipTableTex);
+    e->setUniform(u_clipTable, kTable);
+}
+
 void Renderer::Impl::shutdownResources() {
+    destroyHeadlessTarget();
+    for (const auto& fb : transientFbs) bgfx::destroy(bgfx::FrameBufferHandle{ fb.handle });
+    for (const auto& p : fbPool) bgfx::destroy(p.handle);
+    transientFbs.clear();
+    fbPool.clear();
+    fbFreeViews.clear();
+    destroyClipTable();
+    destroySceneFramebuffers();
+    destroyGeometryArena();
+}
+
+void Renderer::Impl::destroySharedResources() {
+    textureDecoder.stop();
+    textureUploads.clear();
+    texturesPending.clear();
+    glyphBaker.stop();
+    glyphUploads.clear();
+    glyphUploadNext = 0;
     for (auto& kv : textureCache) {
-        if (kv.second.handle != UINT16_MAX) {
-            bgfx::TextureHandle h{ kv.second.handle };
+        if (kv.second.tex.valid() && !kv.second.atlased) {
+            bgfx::TextureHandle h{ kv.second.tex.handle };
             bgfx::destroy(h);
         }
     }
     textureCache.clear();
+    destroyImageAtlas();
+    destroyGradientLut();
+    textureBytes = 0;
 
-    for (auto& rec : fonts) {
-        for (auto& kv : rec.sizes) {
-            if (bgfx::isValid(kv.second.atlas))
-                bgfx::destroy(kv.second.atlas);
-        }
-    }
+    destroyGlyphAtlas();
     fonts.clear();
     fontByPath.clear();
 
@@ -187,14 +423,13 @@ void Renderer::Impl::shutdownResources() {
     cursors.clear();
 
     if (bgfx::isValid(s_texColor))   bgfx::destroy(s_texColor);
+    if (bgfx::isValid(s_texLadder))  bgfx::destroy(s_texLadder);
     if (bgfx::isValid(u_imgFlags))   bgfx::destroy(u_imgFlags);
     if (bgfx::isValid(u_blurParams)) bgfx::destroy(u_blurParams);
-    if (bgfx::isValid(u_glassParams))bgfx::destroy(u_glassParams);
-    if (bgfx::isValid(u_glassTint))  bgfx::destroy(u_glassTint);
-    if (bgfx::isValid(u_glassRect))  bgfx::destroy(u_glassRect);
-    if (bgfx::isValid(u_glassAnim))  bgfx::destroy(u_glassAnim);
-    if (bgfx::isValid(u_glassBase))  bgfx::destroy(u_glassBase);
-    if (bgfx::isValid(u_glassMouse)) bgfx::destroy(u_glassMouse);
+    if (bgfx::isValid(u_blurClamp))  bgfx::destroy(u_blurClamp);
+    if (bgfx::isValid(u_glassFrame)) bgfx::destroy(u_glassFrame);
+    if (bgfx::isValid(u_waveParams)) bgfx::destroy(u_waveParams);
+    if (bgfx::isValid(u_waveSize))   bgfx::destroy(u_waveSize);
     if (bgfx::isValid(u_clipRect))   bgfx::destroy(u_clipRect);
     if (bgfx::isValid(u_clipParams)) bgfx::destroy(u_clipParams);
     if (bgfx::isValid(u_clipRect2))  bgfx::destroy(u_clipRect2);
@@ -202,23 +437,39 @@ void Renderer::Impl::shutdownResources() {
     if (bgfx::isValid(solidProgram)) bgfx::destroy(solidProgram);
     if (bgfx::isValid(texProgram))   bgfx::destroy(texProgram);
     if (bgfx::isValid(textProgram))  bgfx::destroy(textProgram);
+    if (bgfx::isValid(textSdfProgram)) bgfx::destroy(textSdfProgram);
     if (bgfx::isValid(blurProgram))  bgfx::destroy(blurProgram);
     if (bgfx::isValid(glassProgram)) bgfx::destroy(glassProgram);
-    destroySceneFramebuffers();
+    if (bgfx::isValid(waveformProgram)) bgfx::destroy(waveformProgram);
+    if (bgfx::isValid(kawaseProgram)) bgfx::destroy(kawaseProgram);
+    if (bgfx::isValid(shapeProgram)) bgfx::destroy(shapeProgram);
+    if (bgfx::isValid(u_shapeXform)) bgfx::destroy(u_shapeXform);
+    if (bgfx::isValid(unitQuadVb))   bgfx::destroy(unitQuadVb);
+    if (bgfx::isValid(unitQuadIb))   bgfx::destroy(unitQuadIb);
+    shared->programsInit  = false;
+    shared->glassTried    = false;
+    shared->waveformTried = false;
     s_texColor   = BGFX_INVALID_HANDLE;
+    s_texLadder  = BGFX_INVALID_HANDLE;
     solidProgram = BGFX_INVALID_HANDLE;
     texProgram   = BGFX_INVALID_HANDLE;
     textProgram  = BGFX_INVALID_HANDLE;
+    textSdfProgram = BGFX_INVALID_HANDLE;
     u_imgFlags   = BGFX_INVALID_HANDLE;
     blurProgram  = BGFX_INVALID_HANDLE;
     glassProgram = BGFX_INVALID_HANDLE;
+    waveformProgram = BGFX_INVALID_HANDLE;
+    kawaseProgram   = BGFX_INVALID_HANDLE;
+    shapeProgram = BGFX_INVALID_HANDLE;
+    u_shapeXform = BGFX_INVALID_HANDLE;
+    unitQuadVb   = BGFX_INVALID_HANDLE;
+    unitQuadIb   = BGFX_INVALID_HANDLE;
+    shapeInstancing = false;
     u_blurParams = BGFX_INVALID_HANDLE;
-    u_glassParams= BGFX_INVALID_HANDLE;
-    u_glassTint  = BGFX_INVALID_HANDLE;
-    u_glassRect  = BGFX_INVALID_HANDLE;
-    u_glassAnim  = BGFX_INVALID_HANDLE;
-    u_glassBase  = BGFX_INVALID_HANDLE;
-    u_glassMouse = BGFX_INVALID_HANDLE;
+    u_blurClamp  = BGFX_INVALID_HANDLE;
+    u_glassFrame = BGFX_INVALID_HANDLE;
+    u_waveParams = BGFX_INVALID_HANDLE;
+    u_waveSize   = BGFX_INVALID_HANDLE;
 }
 
 // ============================================================================
@@ -235,13 +486,112 @@ void Renderer::Impl::destroySceneFramebuffers() {
     sceneColorTex = BGFX_INVALID_HANDLE;
     blurColorA    = BGFX_INVALID_HANDLE;
     blurColorB    = BGFX_INVALID_HANDLE;
+    destroyBlurLadder();
+    blurValid = false;
     fbWidth = fbHeight = 0;
+    fbAllocW = fbAllocH = 0;
+    fbStableFrames = 0;
+}
+
+uint64_t Renderer::Impl::blurInputsHash(uint32_t width, uint32_t height) const {
+    const auto& rec = mainRecord;
+    uint64_t h = rec.sceneHash;
+    const uint32_t size[3] = { width, height, blurLevelCap };
+    h = hashBytes(h, size, sizeof(size));
+    // Texture and peak-texture updates change what the scene's draws show
+    // without changing the draws themselves.
+    h = hashBytes(h, &contentGeneration, sizeof(contentGeneration));
+    for (const auto& d : rec.deferredGlass) {
+        const float f[6] = { d.dst.position.x, d.dst.position.y, d.dst.size.x, d.dst.size.y,
+                             d.mat.refraction,
+                             d.mat.kind == Material::Kind::Blur ? d.mat.blurRadius : 0.f };
+        const uint16_t sc[5] = { (uint16_t)d.hasScissor, d.sx, d.sy, d.sw, d.sh };
+        h = hashBytes(h, f, sizeof(f));
+        h = hashBytes(h, sc, sizeof(sc));
+    }
+    return h;
+}
+
+void Renderer::Impl::destroyBlurLadder() {
+    for (size_t i = ladderSharesBlurA ? 1 : 0; i < ladderDown.size(); ++i)
+        if (bgfx::isValid(ladderDown[i])) bgfx::destroy(ladderDown[i]);
+    for (auto h : ladderUp)   if (bgfx::isValid(h)) bgfx::destroy(h);
+    ladderDown.clear();
+    ladderUp.clear();
+    ladderLevels = 0;
+    ladderSharesBlurA = false;
+}
+
+bool Renderer::Impl::ensureBlurLadder(uint8_t levels, bool shareLevel1) {
+    if (fbAllocW == 0 || fbAllocH == 0) return false;
+    if (!ladderDown.empty() && ladderSharesBlurA != shareLevel1) destroyBlurLadder();
+    const uint64_t fbFlags = BGFX_TEXTURE_RT
+                           | BGFX_SAMPLER_U_CLAMP
+                           | BGFX_SAMPLER_V_CLAMP;
+    auto make = [&](uint8_t k, uint16_t view) {
+        const uint16_t w = (uint16_t)std::max(1u, fbAllocW >> k);
+        const uint16_t h = (uint16_t)std::max(1u, fbAllocH >> k);
+        // Level 1 is exactly blurFB_A's size.
+        const bool share = shareLevel1 && k == 1 && view == ladderDownView(1);
+        bgfx::FrameBufferHandle fb = share ? blurFB_A
+            : bgfx::createFrameBuffer(w, h, bgfx::TextureFormat::BGRA8, fbFlags);
+        if (!bgfx::isValid(fb)) return fb;
+        bgfx::setViewFrameBuffer(view, fb);
+        bgfx::setViewClear(view, BGFX_CLEAR_NONE);
+        bgfx::setViewMode(view, bgfx::ViewMode::Sequential);
+        return fb;
+    };
+    while (ladderDown.size() < levels) {
+        const uint8_t k = (uint8_t)(ladderDown.size() + 1);
+        bgfx::FrameBufferHandle fb = make(k, ladderDownView(k));
+        if (!bgfx::isValid(fb)) {
+            std::fprintf(stderr, "[UILO] Failed to create blur ladder level %u\n", (unsigned)k);
+            return false;
+        }
+        ladderDown.push_back(fb);
+        if (k == 1) ladderSharesBlurA = shareLevel1;
+    }
+    // The deepest level is only ever a downsample target.
+    while (ladderUp.size() + 1 < levels) {
+        const uint8_t k = (uint8_t)(ladderUp.size() + 1);
+        bgfx::FrameBufferHandle fb = make(k, ladderUpView(k));
+        if (!bgfx::isValid(fb)) {
+            std::fprintf(stderr, "[UILO] Failed to create blur ladder level %u\n", (unsigned)k);
+            return false;
+        }
+        ladderUp.push_back(fb);
+    }
+    return true;
+}
+
+float Renderer::Impl::ladderWeight(float radius) const {
+    if (ladderLevels < 2) return 0.f;
+    const float want = kGaussianBlurRadius + std::max(0.f, radius);
+    const float t = std::log2(want / kGaussianBlurRadius) /
+                    std::log2(ladderRadius(ladderLevels) / kGaussianBlurRadius);
+    return std::clamp(t, 0.f, 1.f);
 }
 
 void Renderer::Impl::ensureSceneFramebuffers(uint32_t width, uint32_t height) {
     if (width == 0 || height == 0) return;
-    if (bgfx::isValid(sceneFB) && fbWidth == width && fbHeight == height) return;
+    const bool valid = bgfx::isValid(sceneFB) && fbWidth != 0;
+    const bool grow  = width > fbAllocW || height > fbAllocH;
+    const bool slack = fbBucketed(width) < fbAllocW || fbBucketed(height) < fbAllocH;
+    if (valid && !grow) {
+        if (width != fbWidth || height != fbHeight) {
+            setSceneViewRects(width, height);
+            return;
+        }
+        if (!slack || ++fbStableFrames < kFbShrinkFrames) return;
+    }
 
+    // Growing keeps whichever axis is already big enough; shrinking (and
+    // the first allocation) fits the current size.
+    uint32_t allocW = fbBucketed(width), allocH = fbBucketed(height);
+    if (valid && grow) {
+        allocW = std::max(allocW, fbAllocW);
+        allocH = std::max(allocH, fbAllocH);
+    }
     destroySceneFramebuffers();
 
     const uint64_t fbFlags = BGFX_TEXTURE_RT
@@ -250,13 +600,13 @@ void Renderer::Impl::ensureSceneFramebuffers(uint32_t width, uint32_t height) {
 
     // Full-res scene target.
     sceneFB = bgfx::createFrameBuffer(
-        (uint16_t)width, (uint16_t)height,
+        (uint16_t)allocW, (uint16_t)allocH,
         bgfx::TextureFormat::BGRA8, fbFlags);
     sceneColorTex = bgfx::getTexture(sceneFB, 0);
 
     // Half-res ping/pong blur targets. Min 1px to avoid 0-sized FBs.
-    const uint16_t halfW = (uint16_t)std::max(1u, width  / 2u);
-    const uint16_t halfH = (uint16_t)std::max(1u, height / 2u);
+    const uint16_t halfW = (uint16_t)std::max(1u, allocW / 2u);
+    const uint16_t halfH = (uint16_t)std::max(1u, allocH / 2u);
 
     blurFB_A = bgfx::createFrameBuffer(halfW, halfH,
                                        bgfx::TextureFormat::BGRA8, fbFlags);
@@ -265,25 +615,15 @@ void Renderer::Impl::ensureSceneFramebuffers(uint32_t width, uint32_t height) {
     blurColorA = bgfx::getTexture(blurFB_A, 0);
     blurColorB = bgfx::getTexture(blurFB_B, 0);
 
-    fbWidth  = width;
-    fbHeight = height;
+    fbAllocW = allocW;
+    fbAllocH = allocH;
 
-    // Bind FBs to their reserved view IDs. View 0 (scene) clears, blur views
-    // overwrite, composite writes backbuffer (FB = invalid).
-    bgfx::setViewFrameBuffer(kSceneViewId,        sceneFB);
+    // Bind FBs to their reserved view IDs: blur views overwrite, composite
+    // writes the backbuffer (FB = invalid) or the headless target. The
+    // scene and glass views follow the frame graph (bindSceneViews).
     bgfx::setViewFrameBuffer(kBlurHViewId,        blurFB_A);
     bgfx::setViewFrameBuffer(kBlurVViewId,        blurFB_B);
-    bgfx::setViewFrameBuffer(kGlassBgViewId,      sceneFB);
-    bgfx::setViewFrameBuffer(kGlassChildViewId,   sceneFB);
-    bgfx::setViewFrameBuffer(kCompositeViewId,    BGFX_INVALID_HANDLE);
-
-    // Static view rects (they don't change between frames at this size).
-    bgfx::setViewRect(kSceneViewId,      0, 0, (uint16_t)width, (uint16_t)height);
-    bgfx::setViewRect(kBlurHViewId,      0, 0, halfW, halfH);
-    bgfx::setViewRect(kBlurVViewId,      0, 0, halfW, halfH);
-    bgfx::setViewRect(kGlassBgViewId,    0, 0, (uint16_t)width, (uint16_t)height);
-    bgfx::setViewRect(kGlassChildViewId, 0, 0, (uint16_t)width, (uint16_t)height);
-    bgfx::setViewRect(kCompositeViewId,  0, 0, (uint16_t)width, (uint16_t)height);
+    bgfx::setViewFrameBuffer(kCompositeViewId,    outputFB);
 
     // Composite + blur + glass views always go straight through (no depth, no clear).
     bgfx::setViewClear(kBlurHViewId,        BGFX_CLEAR_NONE);
@@ -297,6 +637,30 @@ void Renderer::Impl::ensureSceneFramebuffers(uint32_t width, uint32_t height) {
     bgfx::setViewMode(kGlassChildViewId,    bgfx::ViewMode::Sequential);
     bgfx::setViewMode(kCompositeViewId,     bgfx::ViewMode::Sequential);
 
+    setSceneViewRects(width, height);
+}
+
+void Renderer::Impl::setSceneViewRects(uint32_t width, uint32_t height) {
+    fbWidth  = width;
+    fbHeight = height;
+    fbStableFrames = 0;
+
+    // The content sub-rect of each target; the rest of the allocation is
+    // never drawn or sampled.
+    const uint16_t halfW = (uint16_t)std::max(1u, width  / 2u);
+    const uint16_t halfH = (uint16_t)std::max(1u, height / 2u);
+    bgfx::setViewRect(kBlurHViewId,      0, 0, halfW, halfH);
+    bgfx::setViewRect(kBlurVViewId,      0, 0, halfW, halfH);
+    bgfx::setViewRect(kCompositeViewId,  0, 0, (uint16_t)width, (uint16_t)height);
+}
+
+void Renderer::Impl::bindSceneViews(bgfx::FrameBufferHandle fb, uint32_t width, uint32_t height) {
+    bgfx::setViewFrameBuffer(kSceneViewId,      fb);
+    bgfx::setViewFrameBuffer(kGlassBgViewId,    fb);
+    bgfx::setViewFrameBuffer(kGlassChildViewId, fb);
+    bgfx::setViewRect(kGlassBgViewId,    0, 0, (uint16_t)width, (uint16_t)height);
+    bgfx::setViewRect(kGlassChildViewId, 0, 0, (uint16_t)width, (uint16_t)height);
+
     // Ortho transforms for glass views (full-window pixel space).
     const float W = (float)width, H = (float)height;
     const bool  hd = bgfx::getCaps()->homogeneousDepth;
@@ -310,35 +674,62 @@ void Renderer::Impl::ensureSceneFramebuffers(uint32_t width, uint32_t height) {
     };
     bgfx::setViewTransform(kGlassBgViewId,    nullptr, ortho);
     bgfx::setViewTransform(kGlassChildViewId, nullptr, ortho);
+
+    // Views recordParallel() handed out this frame draw into the same
+    // target, with the scene's projection and without its clear.
+    for (uint32_t i = 0; i < slicesUsed; ++i) {
+        for (const uint16_t v : { sliceSceneViews[i], sliceGlassViews[i] }) {
+            bgfx::setViewFrameBuffer(v, fb);
+            bgfx::setViewRect(v, 0, 0, (uint16_t)width, (uint16_t)height);
+            bgfx::setViewClear(v, BGFX_CLEAR_NONE);
+            bgfx::setViewMode(v, bgfx::ViewMode::Sequential);
+            bgfx::setViewTransform(v, nullptr, ortho);
+        }
+    }
+    orderSliceViews();
+}
+
+void Renderer::Impl::setBlurClamp(uint32_t cw, uint32_t ch, uint32_t aw, uint32_t ah) const {
+    // Half a texel in from the content edge so bilinear taps stay inside.
+    // Content sits at the top of the target, which is the high-V end when
+    // the origin is bottom-left.
+    const float maxU = ((float)cw - 0.5f) / (float)aw;
+    const float maxV = ((float)ch - 0.5f) / (float)ah;
+    const float minU = 0.5f / (float)aw, minV = 0.5f / (float)ah;
+    float c[4] = { minU, minV, maxU, maxV };
+    if (bgfx::getCaps()->originBottomLeft) { c[1] = 1.f - maxV; c[3] = 1.f - minV; }
+    bgfx::setUniform(u_blurClamp, c);
 }
 
 namespace {
     // Submit a full-screen textured quad covering [0,0]-[w,h] in pixels with
-    // UVs [0,0]-[1,1]. Vertex color is white. Caller is responsible for
-    // setting texture, uniforms, state, and view.
-    void submitFullscreenQuad(const bgfx::VertexLayout& layout,
+    // UVs [0,0]-[uvW,uvH] (the content part of a larger render target).
+    // Vertex color is white. Caller is responsible for setting texture,
+    // uniforms, state, and view.
+    void submitFullscreenQuad(Renderer::Impl& impl,
+                              const bgfx::VertexLayout& layout,
                               uint16_t viewId,
                               float dstW, float dstH,
                               bgfx::ProgramHandle program,
                               bool flipV,
-                              bool alphaBlend = false) {
+                              bool alphaBlend = false,
+                              float uvW = 1.f, float uvH = 1.f) {
         bgfx::TransientVertexBuffer tvb;
-        if (bgfx::getAvailTransientVertexBuffer(6, layout) < 6) return;
-        bgfx::allocTransientVertexBuffer(&tvb, 6, layout);
+        if (!impl.allocTransient(&tvb, layout, 6)) return;
 
-        struct V { float x, y; uint32_t abgr; float u, v; };
+        using V = PosColorUvVertex;
         V* v = (V*)tvb.data;
         const uint32_t white = 0xffffffffu;
         const float v0 = flipV ? 1.f : 0.f;
-        const float v1 = flipV ? 0.f : 1.f;
+        const float v1 = flipV ? 1.f - uvH : uvH;
 
         // Triangle 1
         v[0] = { 0.f,  0.f,  white, 0.f, v0 };
-        v[1] = { dstW, 0.f,  white, 1.f, v0 };
-        v[2] = { dstW, dstH, white, 1.f, v1 };
+        v[1] = { dstW, 0.f,  white, uvW, v0 };
+        v[2] = { dstW, dstH, white, uvW, v1 };
         // Triangle 2
         v[3] = { 0.f,  0.f,  white, 0.f, v0 };
-        v[4] = { dstW, dstH, white, 1.f, v1 };
+        v[4] = { dstW, dstH, white, uvW, v1 };
         v[5] = { 0.f,  dstH, white, 0.f, v1 };
 
         bgfx::setVertexBuffer(0, &tvb);
@@ -349,7 +740,105 @@ namespace {
     }
 }
 
+bool Renderer::Impl::collectBlurRegions(uint16_t halfW, uint16_t halfH,
+                                        std::vector<BlurRegion>& out) const {
+    out.clear();
+    const float hw = (float)halfW, hh = (float)halfH;
+    const float W = (float)fbWidth, H = (float)fbHeight;
+    const float aspect = std::max(W, H) / std::max(1.f, std::min(W, H));
+    for (const auto& d : mainRecord.deferredGlass) {
+        float x0 = d.dst.position.x, y0 = d.dst.position.y;
+        float x1 = x0 + d.dst.size.x, y1 = y0 + d.dst.size.y;
+        if (d.hasScissor) {
+            x0 = std::max(x0, (float)d.sx);
+            y0 = std::max(y0, (float)d.sy);
+            x1 = std::min(x1, (float)(d.sx + d.sw));
+            y1 = std::min(y1, (float)(d.sy + d.sh));
+        }
+        if (x1 <= x0 || y1 <= y0) continue;
+        // drawGlass scales refraction by the window's short side, so on the
+        // long axis the bend can reach `aspect` times further; ripples and
+        // the Blur kind's extra taps stay within a few more pixels.
+        const float reach = (std::abs(d.mat.refraction) * aspect + 8.f) * 0.5f;
+        out.push_back({ std::max(0.f, std::floor(x0 * 0.5f - reach)),
+                        std::max(0.f, std::floor(y0 * 0.5f - reach)),
+                        std::min(hw,  std::ceil (x1 * 0.5f + reach)),
+                        std::min(hh,  std::ceil (y1 * 0.5f + reach)) });
+        if (out.back().x1 <= out.back().x0 || out.back().y1 <= out.back().y0) out.pop_back();
+    }
+    if (out.empty()) return true;
+
+    // Merge overlapping rects until none overlap; the H pass inflates them
+    // again, so touching counts as overlap too.
+    auto overlaps = [](const BlurRegion& a, const BlurRegion& b) {
+        return a.x0 <= b.x1 + 2.f * kBlurTapReach && b.x0 <= a.x1 + 2.f * kBlurTapReach &&
+               a.y0 <= b.y1 + 2.f * kBlurTapReach && b.y0 <= a.y1 + 2.f * kBlurTapReach;
+    };
+    auto unite = [](BlurRegion& a, const BlurRegion& b) {
+        a.x0 = std::min(a.x0, b.x0); a.y0 = std::min(a.y0, b.y0);
+        a.x1 = std::max(a.x1, b.x1); a.y1 = std::max(a.y1, b.y1);
+    };
+    for (bool merged = true; merged;) {
+        merged = false;
+        for (size_t i = 0; i < out.size() && !merged; ++i)
+            for (size_t j = i + 1; j < out.size(); ++j) {
+                if (!overlaps(out[i], out[j])) continue;
+                unite(out[i], out[j]);
+                out.erase(out.begin() + (std::ptrdiff_t)j);
+                merged = true;
+                break;
+            }
+    }
+    if (out.size() > kMaxBlurRegions) {
+        for (size_t i = 1; i < out.size(); ++i) unite(out[0], out[i]);
+        out.resize(1);
+    }
+
+    float area = 0.f;
+    for (const auto& r : out) area += (r.x1 - r.x0) * (r.y1 - r.y0);
+    return area < kBlurFullscreenAt * hw * hh;
+}
+
+namespace {
+    // Submit one quad per region (half-res pixels) as a single draw, with
+    // UVs matching the quad's position in a texW x texH target whose
+    // content height is dstH. `grow` inflates each region vertically, for
+    // the H pass feeding the V pass's taps.
+    void submitRegionQuads(Renderer::Impl& impl,
+                           const bgfx::VertexLayout& layout,
+                           uint16_t viewId,
+                           float dstH,
+                           float texW, float texH,
+                           const std::vector<Renderer::Impl::BlurRegion>& regions,
+                           float grow,
+                           bgfx::ProgramHandle program,
+                           bool flipV) {
+        const uint32_t n = (uint32_t)regions.size() * 6u;
+        bgfx::TransientVertexBuffer tvb;
+        if (n == 0 || !impl.allocTransient(&tvb, layout, n)) return;
+
+        using V = PosColorUvVertex;
+        V* v = (V*)tvb.data;
+        const uint32_t white = 0xffffffffu;
+        auto vtx = [&](float x, float y) -> V {
+            const float tv = y / texH;
+            return { x, y, white, x / texW, flipV ? 1.f - tv : tv };
+        };
+        for (const auto& r : regions) {
+            const float y0 = std::max(0.f,  r.y0 - grow);
+            const float y1 = std::min(dstH, r.y1 + grow);
+            *v++ = vtx(r.x0, y0); *v++ = vtx(r.x1, y0); *v++ = vtx(r.x1, y1);
+            *v++ = vtx(r.x0, y0); *v++ = vtx(r.x1, y1); *v++ = vtx(r.x0, y1);
+        }
+
+        bgfx::setVertexBuffer(0, &tvb);
+        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+        bgfx::submit(viewId, program);
+    }
+}
+
 void Renderer::Impl::runBlurPasses(uint32_t width, uint32_t height) {
+    UILO_TRACE_ZONE("Renderer::runBlurPasses");
     if (!bgfx::isValid(sceneFB) || !bgfx::isValid(blurProgram)) return;
     const uint16_t halfW = (uint16_t)std::max(1u, width  / 2u);
     const uint16_t halfH = (uint16_t)std::max(1u, height / 2u);
@@ -373,26 +862,119 @@ void Renderer::Impl::runBlurPasses(uint32_t width, uint32_t height) {
     setOrtho(kBlurHViewId, halfW, halfH);
     setOrtho(kBlurVViewId, halfW, halfH);
 
+    // Glass only samples blurFB_B under itself, so blur just those rects
+    // (texels outside them are left stale). The V pass reads blurFB_A
+    // kBlurTapReach rows beyond each rect, so the H pass covers those too.
+    const bool regional = collectBlurRegions(halfW, halfH, blurRegions);
+    if (regional && blurRegions.empty()) {
+        blurRegionsLastFrame  = 0;
+        blurCoverageLastFrame = 0.f;
+        return;
+    }
+    float area = 0.f;
+    for (const auto& r : blurRegions) area += (r.x1 - r.x0) * (r.y1 - r.y0);
+    blurRegionsLastFrame  = regional ? (uint32_t)blurRegions.size() : 1u;
+    blurCoverageLastFrame = regional ? area / ((float)halfW * (float)halfH) : 1.f;
+
+    // Both passes sample the top-left content of oversized targets (see
+    // fbAllocW), so steps are in allocated texels and taps are clamped.
+    const float allocHW = (float)std::max(1u, fbAllocW / 2u);
+    const float allocHH = (float)std::max(1u, fbAllocH / 2u);
+
     // ---- Horizontal blur: sceneFB color -> blurFB_A ----
     {
-        const float step[4] = { 1.f / (float)halfW, 0.f, 0.f, 0.f };
+        const float step[4] = { 1.f / allocHW, 0.f, 0.f, 0.f };
         bgfx::setUniform(u_blurParams, step);
+        setBlurClamp(width, height, fbAllocW, fbAllocH);
         bgfx::setTexture(0, s_texColor, sceneColorTex);
-        submitFullscreenQuad(texLayout, kBlurHViewId,
-                             (float)halfW, (float)halfH,
-                             blurProgram, flipV);
+        if (regional)
+            submitRegionQuads(*this, texLayout, kBlurHViewId, (float)halfH,
+                              allocHW, allocHH, blurRegions, kBlurTapReach, blurProgram, flipV);
+        else
+            submitFullscreenQuad(*this, texLayout, kBlurHViewId,
+                                 (float)halfW, (float)halfH,
+                                 blurProgram, flipV, false,
+                                 (float)halfW / allocHW, (float)halfH / allocHH);
     }
     // ---- Vertical blur: blurFB_A -> blurFB_B ----
     {
-        const float step[4] = { 0.f, 1.f / (float)halfH, 0.f, 0.f };
+        const float step[4] = { 0.f, 1.f / allocHH, 0.f, 0.f };
         bgfx::setUniform(u_blurParams, step);
+        setBlurClamp(halfW, halfH, (uint32_t)allocHW, (uint32_t)allocHH);
         bgfx::setTexture(0, s_texColor, blurColorA);
-        submitFullscreenQuad(texLayout, kBlurVViewId,
-                             (float)halfW, (float)halfH,
-                             blurProgram, false /* sampling our own RT in same orient */);
+        if (regional)
+            submitRegionQuads(*this, texLayout, kBlurVViewId, (float)halfH,
+                              allocHW, allocHH, blurRegions, 0.f, blurProgram, flipV);
+        else
+            submitFullscreenQuad(*this, texLayout, kBlurVViewId,
+                                 (float)halfW, (float)halfH,
+                                 blurProgram, flipV, false,
+                                 (float)halfW / allocHW, (float)halfH / allocHH);
     }
 }
 
+uint8_t Renderer::Impl::wantedLadderLevels(uint32_t width, uint32_t height) const {
+    if (!bgfx::isValid(kawaseProgram) || blurLevelCap < 2) return 0;
+
+    // Depth from the largest radius any Material::Blur asked for.
+    float want = 0.f;
+    for (const auto& d : mainRecord.deferredGlass)
+        if (d.mat.kind == Material::Kind::Blur)
+            want = std::max(want, kGaussianBlurRadius + d.mat.blurRadius);
+    if (want <= kGaussianBlurRadius) return 0;
+    uint8_t levels = 2;
+    while (levels < blurLevelCap && ladderRadius(levels) < want) ++levels;
+    // Don't halve past a single texel.
+    while (levels > 2 && (std::min(width, height) >> levels) == 0) --levels;
+    return levels;
+}
+
+void Renderer::Impl::runBlurLadder(uint32_t width, uint32_t height, uint8_t levels) {
+    ladderLevels = 0;
+    if (levels < 2 || !ensureBlurLadder(levels, fgTarget[FgLadderTemp] == FgBlurTemp)) return;
+
+    const bool flipV = bgfx::getCaps()->originBottomLeft;
+    // Level k renders (width >> k) x (height >> k) into the top-left of a
+    // (fbAllocW >> k) x (fbAllocH >> k) target; level 0 is the scene.
+    auto pass = [&](uint16_t view, uint8_t k, bgfx::TextureHandle src, bool up) {
+        const uint32_t w  = std::max(1u, width  >> k);
+        const uint32_t h  = std::max(1u, height >> k);
+        const uint8_t  sk = up ? (uint8_t)(k + 1) : (uint8_t)(k - 1);
+        const uint32_t sw = std::max(1u, width  >> sk), sh = std::max(1u, height >> sk);
+        const uint32_t aw = std::max(1u, fbAllocW >> sk), ah = std::max(1u, fbAllocH >> sk);
+        bgfx::setViewRect(view, 0, 0, (uint16_t)w, (uint16_t)h);
+        const bool  hd = bgfx::getCaps()->homogeneousDepth;
+        const float m[16] = {
+            2.f/(float)w, 0.f,           0.f,             0.f,
+            0.f,         -2.f/(float)h,  0.f,             0.f,
+            0.f,          0.f,           hd ? 2.f : 1.f,  0.f,
+           -1.f,          1.f,           hd ? -1.f : 0.f, 1.f
+        };
+        bgfx::setViewTransform(view, nullptr, m);
+        const float params[4] = { 0.5f / (float)std::max(1u, fbAllocW >> k),
+                                  0.5f / (float)std::max(1u, fbAllocH >> k),
+                                  up ? 1.f : 0.f, 0.f };
+        bgfx::setUniform(u_blurParams, params);
+        setBlurClamp(sw, sh, aw, ah);
+        bgfx::setTexture(0, s_texColor, src);
+        submitFullscreenQuad(*this, texLayout, view, (float)w, (float)h, kawaseProgram, flipV, false,
+                             (float)sw / (float)aw, (float)sh / (float)ah);
+    };
+    pass(ladderDownView(1), 1, sceneColorTex, false);
+    for (uint8_t k = 2; k <= levels; ++k)
+        pass(ladderDownView(k), k, bgfx::getTexture(ladderDown[k - 2]), false);
+    pass(ladderUpView(levels - 1), levels - 1, bgfx::getTexture(ladderDown[levels - 1]), true);
+    for (uint8_t k = levels - 1; k-- > 1;)
+        pass(ladderUpView(k), k, bgfx::getTexture(ladderUp[k]), true);
+    ladderLevels = levels;
+}
+
+void Renderer::setBlurLevels(uint8_t levels) {
+    m_impl->blurLevelCap = std::min(levels, Impl::kMaxBlurLevels);
+}
+
+uint8_t Renderer::getBlurLevels() const { return m_impl->blurLevelCap; }
+
 void Renderer::Impl::compositeSceneToBackbuffer(uint32_t width, uint32_t height,
                                                 const bgfx::VertexLayout& layout,
                                                 bgfx::ProgramHandle program) {
@@ -431,7 +1013,8 @@ void Renderer::Impl::compositeSceneToBackbuffer(uint32_t width, uint32_t height,
     if (bgfx::isValid(u_clipParams2)) bgfx::setUniform(u_clipParams2, clipZero);
 
     bgfx::setTexture(0, s_texColor, sceneColorTex);
-    submitFullscreenQuad(layout, kCompositeViewId, W, H, program, flipV, embedded);
+    submitFullscreenQuad(*this, layout, kCompositeViewId, W, H, program, flipV, embedded,
+                         W / (float)fbAllocW, H / (float)fbAllocH);
 }
 
 // ============================================================================
@@ -441,34 +1024,11 @@ void Renderer::Impl::compositeSceneToBackbuffer(uint32_t width, uint32_t height,
 Renderer::Renderer() : m_impl(std::make_unique<Impl>()) {}
 Renderer::~Renderer() { shutdown(); }
 
-bool Renderer::init(uint32_t width, uint32_t height,
-                    const std::string& title, uint8_t msaa) {
-    if (m_initialised) return true;
-
-    if (!SDL_Init(SDL_INIT_VIDEO)) {
-        std::fprintf(stderr, "[UILO] SDL_Init failed: %s\n", SDL_GetError());
-        return false;
-    }
-
-    uint32_t flags = SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY;
-    m_window = SDL_CreateWindow(title.c_str(), (int)width, (int)height, flags);
-    if (!m_window) {
-        std::fprintf(stderr, "[UILO] SDL_CreateWindow failed: %s\n", SDL_GetError());
-        return false;
-    }
-
-    // Use real backing-pixel size (HiDPI displays make this larger than the
-    // logical width/height requested above).
-    {
-        int pxW = (int)width, pxH = (int)height;
-        SDL_GetWindowSizeInPixels(m_window, &pxW, &pxH);
-        width  = (uint32_t)pxW;
-        height = (uint32_t)pxH;
-    }
-
+// Native handles bgfx needs to create a swapchain on the window.
+static bgfx::PlatformData platformDataFor(SDL_Window* window) {
     bgfx::PlatformData pd{};
 #if defined(SDL_PLATFORM_WIN32)
-    SDL_PropertiesID props = SDL_GetWindowProperties(m_window);
+    SDL_PropertiesID props = SDL_GetWindowProperties(window);
     pd.nwh = SDL_GetPointerProperty(props,
                 SDL_PROP_WINDOW_WIN32_HWND_POINTER, nullptr);
 #elif defined(SDL_PLATFORM_MACOS)
@@ -476,9 +1036,9 @@ bool Renderer::init(uint32_t width, uint32_t height,
     // backend accepts either, but bgfx's Vulkan/MoltenVK surface creation
     // only accepts an NSWindow or CAMetalLayer and silently falls back to
     // Metal when handed a view.
-    pd.nwh = SDL_Metal_GetLayer(SDL_Metal_CreateView(m_window));
+    pd.nwh = SDL_Metal_GetLayer(SDL_Metal_CreateView(window));
 #elif defined(SDL_PLATFORM_LINUX)
-    SDL_PropertiesID props = SDL_GetWindowProperties(m_window);
+    SDL_PropertiesID props = SDL_GetWindowProperties(window);
     void* waylandSurf = SDL_GetPointerProperty(props,
                 SDL_PROP_WINDOW_WAYLAND_SURFACE_POINTER, nullptr);
     Window x11WinNum  = (Window)SDL_GetNumberProperty(props,
@@ -496,6 +1056,46 @@ bool Renderer::init(uint32_t width, uint32_t height,
         pd.nwh = x11Win;
     }
 #endif
+    return pd;
+}
+
+bool Renderer::init(uint32_t width, uint32_t height,
+                    const std::string& title, uint8_t msaa) {
+    if (m_initialised) return true;
+    auto& startup = m_impl->startup;
+    m_impl->initStartNs = Impl::pacerNowNs();
+    auto msSince = [](uint64_t t0) { return (float)((double)(Impl::pacerNowNs() - t0) * 1e-6); };
+
+    // Headless (initHeadless) keeps SDL to its event queue.
+    if (!SDL_Init(m_headless ? SDL_INIT_EVENTS : SDL_INIT_VIDEO)) {
+        std::fprintf(stderr, "[UILO] SDL_Init failed: %s\n", SDL_GetError());
+        return false;
+    }
+
+    if (!m_headless) {
+        uint32_t flags = SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY;
+        m_window = SDL_CreateWindow(title.c_str(), (int)width, (int)height, flags);
+        if (!m_window) {
+            std::fprintf(stderr, "[UILO] SDL_CreateWindow failed: %s\n", SDL_GetError());
+            return false;
+        }
+    }
+
+    // Use real backing-pixel size (HiDPI displays make this larger than the
+    // logical width/height requested above).
+    if (m_window) {
+        int pxW = (int)width, pxH = (int)height;
+        SDL_GetWindowSizeInPixels(m_window, &pxW, &pxH);
+        width  = (uint32_t)pxW;
+        height = (uint32_t)pxH;
+    }
+
+    startup.windowMs = msSince(m_impl->initStartNs);
+
+    // Headless: no native handles, so the backend renders without a
+    // swapchain.
+    bgfx::PlatformData pd{};
+    if (m_window) pd = platformDataFor(m_window);
 
     bgfx::Init init;
     init.platformData      = pd;
@@ -503,7 +1103,7 @@ bool Renderer::init(uint32_t width, uint32_t height,
     init.resolution.height = height;
     // Count = let bgfx pick the platform default (Metal / D3D / Vulkan).
     // UILO_RENDERER overrides for A/B testing without a rebuild:
-    // vulkan | metal | d3d11 | d3d12 | gl | auto.
+    // vulkan | metal | d3d11 | d3d12 | gl | noop | auto.
     init.type = bgfx::RendererType::Count;
     if (const char* env = std::getenv("UILO_RENDERER")) {
         const std::string_view want{env};
@@ -512,9 +1112,24 @@ bool Renderer::init(uint32_t width, uint32_t height,
         else if (want == "d3d11")  init.type = bgfx::RendererType::Direct3D11;
         else if (want == "d3d12")  init.type = bgfx::RendererType::Direct3D12;
         else if (want == "gl")     init.type = bgfx::RendererType::OpenGL;
+        else if (want == "noop")   init.type = bgfx::RendererType::Noop;
         else if (want == "auto")   init.type = bgfx::RendererType::Count;
         else std::fprintf(stderr, "[UILO] unknown UILO_RENDERER '%s' (ignored)\n", env);
     }
+    if (m_headless && init.type == bgfx::RendererType::Count) {
+        // The platform default may need a window (GL does); take the first
+        // backend that renders without one.
+        bgfx::RendererType::Enum supported[bgfx::RendererType::Count];
+        const uint8_t n = bgfx::getSupportedRenderers(bgfx::RendererType::Count, supported);
+        init.type = bgfx::RendererType::Noop;
+        for (auto want : { bgfx::RendererType::Vulkan, bgfx::RendererType::Metal,
+                           bgfx::RendererType::Direct3D12, bgfx::RendererType::Direct3D11 }) {
+            if (std::find(supported, supported + n, want) != supported + n) {
+                init.type = want;
+                break;
+            }
+        }
+    }
 
     // Raise transient buffer budgets so dense UI passes (grids, markers,
     // waveform-like primitives) don't hit allocation cliffs and silently drop
@@ -526,18 +1141,21 @@ bool Renderer::init(uint32_t width, uint32_t height,
     init.limits.maxTransientIbSize = std::max(init.limits.maxTransientIbSize,
                                               kTransientIbBytes);
 
-    uint32_t resetFlags = BGFX_RESET_VSYNC | BGFX_RESET_FLUSH_AFTER_RENDER;
+    uint32_t resetFlags = (m_headless ? 0u : BGFX_RESET_VSYNC) | BGFX_RESET_FLUSH_AFTER_RENDER;
     if      (msaa >= 16) resetFlags |= BGFX_RESET_MSAA_X16;
     else if (msaa >=  8) resetFlags |= BGFX_RESET_MSAA_X8;
     else if (msaa >=  4) resetFlags |= BGFX_RESET_MSAA_X4;
     else if (msaa >=  2) resetFlags |= BGFX_RESET_MSAA_X2;
     init.resolution.reset = resetFlags;
-    // Limit swapchain queued frames (Metal/DXGI) to 1 to minimise input lag.
-    init.resolution.maxFrameLatency = 1;
+    // Limit swapchain queued frames (Metal/DXGI) to 1 to minimise input
+    // lag, unless the render thread was asked for a deeper pipeline.
+    init.resolution.maxFrameLatency = m_renderThreadWanted ? m_pipelineFrames : 1;
     m_resetFlags = resetFlags;
 
+    if (m_renderThreadWanted) m_impl->startRenderThread();
     if (!bgfx::init(init)) {
         std::fprintf(stderr, "[UILO] bgfx::init failed\n");
+        m_impl->stopRenderThread();
         return false;
     }
 
@@ -550,123 +1168,594 @@ bool Renderer::init(uint32_t width, uint32_t height,
             caps->limits.maxTransientIbSize / 1024u);
     }
 
-    bgfx::setDebug(BGFX_DEBUG_NONE);
+    bgfx::setDebug(m_impl->passTimings ? BGFX_DEBUG_PROFILER : BGFX_DEBUG_NONE);
+    startup.contextMs = msSince(m_impl->initStartNs) - startup.windowMs;
 
+    const uint64_t resourcesStart = Impl::pacerNowNs();
     m_impl->ensureLayouts();
     if (!m_impl->initShaders()) return false;
+    if (m_headless && !m_impl->createHeadlessTarget(width, height, m_nextViewId++)) return false;
+    startup.resourcesMs = msSince(resourcesStart);
 
+    m_impl->shared->contextLive = true;
+    ++m_impl->shared->renderers;
     m_msaa        = msaa;
     m_initialised = true;
     return true;
 }
 
-bool Renderer::attach(SDL_Window* hostWindow, uint16_t baseView) {
+bool Renderer::attach(SDL_Window* hostWindow, uint16_t baseView, const EmbeddedBudget& budget) {
     if (m_initialised) return true;
 
     m_window      = hostWindow;        // borrowed; not destroyed in shutdown()
     m_ownsContext = false;             // host owns SDL + bgfx + the frame loop
     m_impl->embedded = true;           // composite alpha-blends over the host image
     m_impl->setViewBase(baseView);     // rebase the pipeline views above the host's
-    m_nextViewId  = baseView + 6;      // user framebuffers above UILO's pipeline
+    m_nextViewId  = baseView + Impl::kMaxFbViews + Impl::kPipelineViews; // overflow framebuffers above the pipeline
 
     // bgfx + window already exist; just build UILO's own GPU resources.
     m_impl->ensureLayouts();
     if (!m_impl->initShaders()) return false;
+    m_impl->transientBudget = budget.transientBytes;
+    if (!m_impl->createGeometryArena(budget))
+        std::fprintf(stderr, "[UILO] attach: no geometry arena; batches use the transient pool\n");
 
+    ++m_impl->shared->renderers;
     m_initialised = true;
     return true;
 }
 
-void Renderer::shutdown() {
-    if (!m_initialised) return;
-    if (m_impl) m_impl->shutdownResources();   // UILO's own FBs/shaders, both modes
-    if (m_ownsContext) {
-        bgfx::shutdown();
-        if (m_window) SDL_DestroyWindow(m_window);
-        SDL_Quit();
+void Renderer::setHostBackdrop(const Texture& blurred) {
+    auto& impl = *m_impl;
+    if (!impl.embedded && blurred.valid()) {
+        std::fprintf(stderr, "[UILO] setHostBackdrop: only used by attach()ed renderers\n");
+        return;
     }
-    m_window = nullptr; // borrowed in attach mode; just drop the reference
-    m_initialised = false;
+    impl.hostBackdrop   = bgfx::TextureHandle{ blurred.handle };
+    impl.hostBackdropUv = blurred.uv;
+    impl.blurValid      = false;   // whichever backdrop comes next starts fresh
 }
 
 // ============================================================================
-//  Window / cursor
+//  Embedded geometry budget (see EmbeddedBudget)
 // ============================================================================
 
-Vec2u Renderer::getSize() const {
-    if (!m_window) return {0u, 0u};
-    int w, h;
-    SDL_GetWindowSizeInPixels(m_window, &w, &h);
-    return { (unsigned)w, (unsigned)h };
+bool Renderer::Impl::createGeometryArena(const EmbeddedBudget& budget) {
+    destroyGeometryArena();
+    if (budget.arenaVertices == 0 || budget.arenaIndices == 0) return true;
+    solidArena.vb = bgfx::createDynamicVertexBuffer(budget.arenaVertices, solidLayout);
+    texArena.vb   = bgfx::createDynamicVertexBuffer(budget.arenaVertices, texLayout);
+    arenaIb       = bgfx::createDynamicIndexBuffer(budget.arenaIndices);
+    if (!bgfx::isValid(solidArena.vb) || !bgfx::isValid(texArena.vb) || !bgfx::isValid(arenaIb)) {
+        destroyGeometryArena();
+        return false;
+    }
+    solidArena.capacity = texArena.capacity = budget.arenaVertices;
+    arenaIbCapacity     = budget.arenaIndices;
+    return true;
 }
 
-void Renderer::setTitle(const std::string& title) {
-    if (m_window) SDL_SetWindowTitle(m_window, title.c_str());
+void Renderer::Impl::destroyGeometryArena() {
+    for (GeometryArena* a : { &solidArena, &texArena }) {
+        if (bgfx::isValid(a->vb)) bgfx::destroy(a->vb);
+        *a = GeometryArena{};
+    }
+    if (bgfx::isValid(arenaIb)) bgfx::destroy(arenaIb);
+    arenaIb         = BGFX_INVALID_HANDLE;
+    arenaIbCapacity = arenaIbUsed = 0;
 }
 
-RendererStats Renderer::getStats() const {
-    RendererStats out;
-    const bgfx::Stats* s = bgfx::getStats();
-    if (!s) return out;
-    out.numDraw     = s->numDraw;
-    out.numVertices = 0; // bgfx::Stats doesn't break out vertex counts in the public struct
-    const double toMs = 1000.0 / (double)s->cpuTimerFreq;
-    out.cpuTimeMs   = double(s->cpuTimeEnd - s->cpuTimeBegin) * toMs;
-    const double gpuToMs = s->gpuTimerFreq ? 1000.0 / (double)s->gpuTimerFreq : 0.0;
-    out.gpuTimeMs   = double(s->gpuTimeEnd - s->gpuTimeBegin) * gpuToMs;
-    return out;
+void Renderer::Impl::beginGeometryFrame() {
+    solidArena.used = texArena.used = arenaIbUsed = 0;
+    transientVbThisFrame.store(0, std::memory_order_relaxed);
+    transientIbThisFrame.store(0, std::memory_order_relaxed);
+    budgetDroppedThisFrame.store(0, std::memory_order_relaxed);
 }
 
-void Renderer::setVsync(bool enabled) {
-    uint32_t f = m_resetFlags;
-    if (enabled) f |=  BGFX_RESET_VSYNC;
-    else         f &= ~BGFX_RESET_VSYNC;
-    if (f == m_resetFlags) return;
-    m_resetFlags = f;
-    Vec2u sz = getSize();
-    // maxFrameLatency only applies on full reset with width/height; keep 1.
-    bgfx::reset(sz.x, sz.y, m_resetFlags);
-    m_lastWidth  = sz.x;
-    m_lastHeight = sz.y;
-    // bgfx::reset can invalidate view->framebuffer bindings on some
-    // backends. Force ensureSceneFramebuffers() to rebuild + re-bind every
-    // reserved view on the next beginFrame by clearing the cached size.
-    m_impl->fbWidth  = 0;
-    m_impl->fbHeight = 0;
+void Renderer::Impl::latchGeometryFrame() {
+    transientVbLastFrame   = transientVbThisFrame.load(std::memory_order_relaxed);
+    transientIbLastFrame   = transientIbThisFrame.load(std::memory_order_relaxed);
+    budgetDroppedLastFrame = budgetDroppedThisFrame.load(std::memory_order_relaxed);
+    arenaVbLastFrame = solidArena.used * solidLayout.getStride() + texArena.used * texLayout.getStride();
+    arenaIbLastFrame = arenaIbUsed * (uint32_t)sizeof(uint16_t);
 }
 
-bool Renderer::getVsync() const {
-    return (m_resetFlags & BGFX_RESET_VSYNC) != 0;
+bool Renderer::Impl::allocTransient(bgfx::TransientVertexBuffer* tvb, const bgfx::VertexLayout& layout,
+                                    uint32_t numV, bgfx::TransientIndexBuffer* tib, uint32_t numI) {
+    const uint32_t vb = numV * layout.getStride();
+    const uint32_t ib = tib ? numI * (uint32_t)sizeof(uint16_t) : 0u;
+    // Book first, so slices racing for the last of the budget can't both
+    // get it; give the bytes back if bgfx can't deliver them.
+    const uint32_t before = transientVbThisFrame.fetch_add(vb, std::memory_order_relaxed)
+                          + transientIbThisFrame.fetch_add(ib, std::memory_order_relaxed);
+    bool ok = transientBudget == 0 || before + vb + ib <= transientBudget;
+    if (ok && tib) {
+        ok = bgfx::allocTransientBuffers(tvb, layout, numV, tib, numI);
+    } else if (ok) {
+        ok = bgfx::getAvailTransientVertexBuffer(numV, layout) >= numV;
+        if (ok) bgfx::allocTransientVertexBuffer(tvb, numV, layout);
+    }
+    if (!ok) {
+        transientVbThisFrame.fetch_sub(vb, std::memory_order_relaxed);
+        transientIbThisFrame.fetch_sub(ib, std::memory_order_relaxed);
+        budgetDroppedThisFrame.fetch_add(1, std::memory_order_relaxed);
+    }
+    return ok;
 }
 
-void Renderer::setFramerateLimit(float fps) {
-    if (fps <= 0.f || !std::isfinite(fps)) {
-        m_frameInterval = 0.0;
-        m_nextFrameTick = 0;
-        return;
+bool Renderer::Impl::allocInstances(bgfx::InstanceDataBuffer* idb, uint32_t num, uint16_t stride) {
+    // Instance data comes out of the transient vertex pool too.
+    const uint32_t bytes  = num * stride;
+    const uint32_t before = transientVbThisFrame.fetch_add(bytes, std::memory_order_relaxed)
+                          + transientIbThisFrame.load(std::memory_order_relaxed);
+    const bool ok = (transientBudget == 0 || before + bytes <= transientBudget) &&
+                    bgfx::getAvailInstanceDataBuffer(num, stride) == num;
+    if (!ok) {
+        transientVbThisFrame.fetch_sub(bytes, std::memory_order_relaxed);
+        budgetDroppedThisFrame.fetch_add(1, std::memory_order_relaxed);
+        return false;
     }
-    m_frameInterval = 1.0 / (double)fps;
-    m_nextFrameTick = 0; // re-anchor on next endFrame()
+    bgfx::allocInstanceDataBuffer(idb, num, stride);
+    return true;
 }
 
-float Renderer::getFramerateLimit() const {
-    return m_frameInterval > 0.0 ? (float)(1.0 / m_frameInterval) : 0.f;
+bool Renderer::Impl::setBatchGeometry(bgfx::Encoder* enc, bool textured, const void* verts, uint32_t numV,
+                                      const uint16_t* idx, uint32_t numI) {
+    GeometryArena& arena = textured ? texArena : solidArena;
+    const uint16_t stride = (textured ? texLayout : solidLayout).getStride();
+    if (&rs() == &mainRecord && bgfx::isValid(arena.vb) &&
+        arena.used + numV <= arena.capacity && arenaIbUsed + numI <= arenaIbCapacity) {
+        // Indices stay batch-relative: the start vertex is the base vertex.
+        bgfx::update(arena.vb, arena.used, bgfx::copy(verts, numV * stride));
+        bgfx::update(arenaIb, arenaIbUsed, bgfx::copy(idx, numI * (uint32_t)sizeof(uint16_t)));
+        enc->setVertexBuffer(0, arena.vb, arena.used, numV);
+        enc->setIndexBuffer(arenaIb, arenaIbUsed, numI);
+        arena.used  += numV;
+        arenaIbUsed += numI;
+        return true;
+    }
+    bgfx::TransientVertexBuffer tvb;
+    bgfx::TransientIndexBuffer  tib;
+    if (!allocTransient(&tvb, textured ? texLayout : solidLayout, numV, &tib, numI)) return false;
+    std::memcpy(tvb.data, verts, numV * stride);
+    std::memcpy(tib.data, idx,   numI * sizeof(uint16_t));
+    enc->setVertexBuffer(0, &tvb);
+    enc->setIndexBuffer(&tib);
+    return true;
 }
 
-void Renderer::setCursor(CursorType type) {
-    auto& impl = *m_impl;
-    int key = (int)type;
-    SDL_Cursor* cur = nullptr;
-    auto it = impl.cursors.find(key);
-    if (it != impl.cursors.end()) {
-        cur = (SDL_Cursor*)it->second;
-    } else {
-        SDL_SystemCursor sdlType = SDL_SYSTEM_CURSOR_DEFAULT;
-        switch (type) {
-            case CursorType::Arrow:          sdlType = SDL_SYSTEM_CURSOR_DEFAULT;   break;
-            case CursorType::Hand:           sdlType = SDL_SYSTEM_CURSOR_POINTER;   break;
-            case CursorType::SizeHorizontal: sdlType = SDL_SYSTEM_CURSOR_EW_RESIZE; break;
-            case CursorType::SizeVertical:   sdlType = SDL_SYSTEM_CURSOR_NS_RESIZE; break;
+bool Renderer::initShared(Renderer& primary, uint32_t width, uint32_t height,
+                          const std::string& title) {
+    if (m_initialised) return true;
+    if (&primary == this || !primary.m_initialised || !primary.m_window ||
+        primary.m_sharedContext) {
+        std::fprintf(stderr, "[UILO] initShared: primary must be an initialised, windowed renderer\n");
+        return false;
+    }
+    const bgfx::Caps* caps = bgfx::getCaps();
+    if (!(caps->supported & BGFX_CAPS_SWAP_CHAIN)) {
+        std::fprintf(stderr, "[UILO] initShared: %s has no swapchain support\n",
+                     bgfx::getRendererName(bgfx::getRendererType()));
+        return false;
+    }
+    auto shared = primary.m_impl->shared;
+    int block = -1;
+    for (size_t k = 0; k < shared->windowBlocks.size(); ++k) {
+        if (shared->windowBlocks.test(k)) continue;
+        if (Impl::windowBlockBase(k) >= primary.m_nextViewId) block = (int)k;
+        break;
+    }
+    if (block < 0) {
+        std::fprintf(stderr, "[UILO] initShared: out of view ids for another window\n");
+        return false;
+    }
+
+    SDL_Window* window = SDL_CreateWindow(title.c_str(), (int)width, (int)height,
+                                          SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY);
+    if (!window) {
+        std::fprintf(stderr, "[UILO] SDL_CreateWindow failed: %s\n", SDL_GetError());
+        return false;
+    }
+    int pxW = (int)width, pxH = (int)height;
+    SDL_GetWindowSizeInPixels(window, &pxW, &pxH);
+
+    auto impl = std::make_unique<Impl>(shared);
+    const uint16_t base = (uint16_t)Impl::windowBlockBase((size_t)block);
+    impl->windowBlock  = block;
+    impl->viewEnd      = base + Impl::kWindowViews;
+    impl->setViewBase(base);
+    impl->windowHandle = platformDataFor(window).nwh;
+    if (!impl->createWindowTarget((uint32_t)std::max(pxW, 1), (uint32_t)std::max(pxH, 1))) {
+        SDL_DestroyWindow(window);
+        return false;
+    }
+    impl->initClipTable();       // programs, layouts and caches are the primary's
+
+    shared->windowBlocks.set((size_t)block);
+    ++shared->renderers;
+    m_impl          = std::move(impl);
+    m_window        = window;
+    m_nextViewId    = base + Impl::kMaxFbViews + Impl::kPipelineViews;
+    m_ownsContext   = false;     // the primary's endFrame presents this window too
+    m_sharedContext = true;
+    m_resetFlags    = primary.m_resetFlags;
+    m_msaa          = 1;         // swapchain framebuffers aren't multisampled
+    m_initialised   = true;
+    return true;
+}
+
+bool Renderer::Impl::createWindowTarget(uint32_t width, uint32_t height) {
+    if (bgfx::isValid(outputFB)) bgfx::destroy(outputFB);
+    outputFB = bgfx::createFrameBuffer(windowHandle, (uint16_t)width, (uint16_t)height);
+    if (!bgfx::isValid(outputFB)) {
+        std::fprintf(stderr, "[UILO] initShared: can't create a %ux%u swapchain\n", width, height);
+        return false;
+    }
+    // ensureSceneFramebuffers() binds the composite view to it.
+    fbWidth = fbHeight = 0;
+    return true;
+}
+
+uint32_t Renderer::Impl::windowBlockBase(size_t block) {
+    const uint32_t maxViews = std::min<uint32_t>(bgfx::getCaps()->limits.maxViews, 256);
+    const uint32_t span     = kWindowViews * (uint32_t)(block + 1);
+    return maxViews > span ? maxViews - span : 0;
+}
+
+uint16_t Renderer::Impl::viewLimit() const {
+    if (viewEnd) return viewEnd;
+    uint32_t limit = std::min<uint32_t>(bgfx::getCaps()->limits.maxViews, 256);
+    for (size_t k = 0; k < shared->windowBlocks.size(); ++k)
+        if (shared->windowBlocks.test(k)) limit = std::min(limit, windowBlockBase(k));
+    return (uint16_t)limit;
+}
+
+void Renderer::shutdown() {
+    if (!m_initialised) return;
+    auto shared = m_impl->shared;
+    if (m_sharedContext && !shared->contextLive) {
+        // The primary already shut bgfx down, and with it this window's
+        // handles; only the window is left.
+        std::fprintf(stderr, "[UILO] shutdown: shared window outlived its primary\n");
+    } else {
+        m_impl->shutdownResources();   // this window's FBs and targets, every mode
+        --shared->renderers;
+        if (m_impl->windowBlock >= 0) shared->windowBlocks.reset((size_t)m_impl->windowBlock);
+        if (shared->renderers == 0 || m_ownsContext) {
+            if (shared->renderers > 0)
+                std::fprintf(stderr, "[UILO] shutdown: %u shared window(s) still open\n",
+                             shared->renderers);
+            m_impl->destroySharedResources();
+        }
+    }
+    if (m_ownsContext) {
+        shared->contextLive = false;
+        bgfx::shutdown();
+        m_impl->stopRenderThread();   // pumped renderFrame() through the shutdown
+        if (m_window) SDL_DestroyWindow(m_window);
+        SDL_Quit();
+    } else if (m_sharedContext && m_window) {
+        SDL_DestroyWindow(m_window);
+    }
+    m_window = nullptr; // borrowed in attach mode; just drop the reference
+    m_headless      = false;
+    m_sharedContext = false;
+    m_initialised   = false;
+}
+
+void Renderer::setRenderThread(bool enabled, uint8_t pipelineFrames) {
+    if (m_initialised) {
+        std::fprintf(stderr, "[UILO] setRenderThread must be called before init(); ignored\n");
+        return;
+    }
+    m_renderThreadWanted = enabled;
+    m_pipelineFrames     = (uint8_t)std::clamp<int>(pipelineFrames, 1, 2);
+}
+
+bool Renderer::hasRenderThread() const { return m_impl->renderThread.joinable(); }
+
+void Renderer::Impl::startRenderThread() {
+    renderThreadStop = false;
+    std::atomic<bool> claimed{false};
+    renderThread = std::thread([this, &claimed] {
+        // A renderFrame() ahead of bgfx::init() makes this the render
+        // thread instead of one bgfx would spawn. init() itself needs
+        // frames pumped, so the loop starts before the context exists.
+        bgfx::renderFrame();
+        claimed = true;
+        while (!renderThreadStop) {
+            if (bgfx::renderFrame(kRenderWaitMs) == bgfx::RenderFrame::NoContext)
+                std::this_thread::yield();
+        }
+    });
+    while (!claimed) std::this_thread::yield();
+}
+
+void Renderer::Impl::stopRenderThread() {
+    if (!renderThread.joinable()) return;
+    renderThreadStop = true;
+    renderThread.join();
+}
+
+// ============================================================================
+//  Window / cursor
+// ============================================================================
+
+Vec2u Renderer::getSize() const {
+    if (m_headless) return m_headlessSize;
+    if (!m_window) return {0u, 0u};
+    int w, h;
+    SDL_GetWindowSizeInPixels(m_window, &w, &h);
+    return { (unsigned)w, (unsigned)h };
+}
+
+void Renderer::setTitle(const std::string& title) {
+    if (m_window) SDL_SetWindowTitle(m_window, title.c_str());
+}
+
+RendererStats Renderer::getStats() const {
+    RendererStats out;
+    const bgfx::Stats* s = bgfx::getStats();
+    if (!s) return out;
+    out.numDraw     = s->numDraw;
+    out.numVertices = 0; // bgfx::Stats doesn't break out vertex counts in the public struct
+    const double toMs = 1000.0 / (double)s->cpuTimerFreq;
+    out.cpuTimeMs   = double(s->cpuTimeEnd - s->cpuTimeBegin) * toMs;
+    const double gpuToMs = s->gpuTimerFreq ? 1000.0 / (double)s->gpuTimerFreq : 0.0;
+    out.gpuTimeMs   = double(s->gpuTimeEnd - s->gpuTimeBegin) * gpuToMs;
+
+    const uint64_t pageArea = uint64_t(Impl::kGlyphPageSize) * Impl::kGlyphPageSize;
+    uint64_t used = 0;
+    for (const auto& p : m_impl->glyphPages) {
+        if (!bgfx::isValid(p.tex)) continue;
+        ++out.glyphAtlasPages;
+        used += p.usedArea;
+    }
+    out.glyphAtlasBytes     = out.glyphAtlasPages * pageArea;
+    out.glyphAtlasOccupancy = out.glyphAtlasPages
+        ? float(double(used) / double(out.glyphAtlasPages * pageArea)) : 0.f;
+    out.glyphAtlasEvictions = m_impl->glyphAtlasEvictions;
+    out.textRuns      = (uint32_t)m_impl->textRuns.size();
+    out.textRunHits   = m_impl->textRunHits;
+    out.textRunMisses = m_impl->textRunMisses;
+    out.arcMeshes     = (uint32_t)m_impl->arcMeshes.size();
+    out.arcMeshHits   = m_impl->arcMeshHits;
+    out.arcMeshMisses = m_impl->arcMeshMisses;
+    out.culledElements = m_impl->culledLastFrame;
+    out.rejectedDraws  = m_impl->rejectedLastFrame;
+    out.clipNodes      = m_impl->clipTableOn ? (uint32_t)m_impl->clipNodes.size() - 1 : 0;
+    out.texturesLoading = (uint32_t)m_impl->texturesPending.size();
+    out.textures         = (uint32_t)m_impl->textureCache.size();
+    out.textureBytes     = m_impl->textureBytes;
+    out.textureEvictions = m_impl->textureEvictions;
+    out.imageAtlasPages  = (uint32_t)m_impl->imageAtlasPages.size();
+    out.blurRegions      = m_impl->blurRegionsLastFrame;
+    out.blurCoverage     = m_impl->blurCoverageLastFrame;
+    out.blurLadderLevels = m_impl->ladderLevels;
+    out.blurReused       = m_impl->blurReusedLastFrame;
+    out.glassPanels      = m_impl->glassPanelsLastFrame;
+    out.glassDraws       = m_impl->glassDrawsLastFrame;
+    out.frameBuffersPooled = (uint32_t)m_impl->fbPool.size();
+    out.frameBufferAllocs  = m_impl->fbAllocsLastFrame;
+    out.framePasses        = m_impl->fgPassesLastFrame;
+    out.sceneDirect        = m_impl->sceneDirectLastFrame;
+    out.recordSlices       = m_impl->parallelSlicesLastFrame;
+    out.batchedSubmits     = m_impl->batchedSubmitsLastFrame;
+    out.immediateSubmits   = m_impl->immediateSubmitsLastFrame;
+    out.flushesState       = m_impl->flushesLastFrame[(size_t)FlushReason::State];
+    out.flushesCapacity    = m_impl->flushesLastFrame[(size_t)FlushReason::Capacity];
+    out.flushesSwitch      = m_impl->flushesLastFrame[(size_t)FlushReason::Switch];
+    out.flushesExplicit    = m_impl->flushesLastFrame[(size_t)FlushReason::Explicit];
+    out.transientVbUsed    = (uint32_t)std::max(0, s->transientVbUsed);
+    out.transientIbUsed    = (uint32_t)std::max(0, s->transientIbUsed);
+    out.transientVbPeak    = m_impl->transientVbPeak;
+    out.transientIbPeak    = m_impl->transientIbPeak;
+    if (const bgfx::Caps* caps = bgfx::getCaps()) {
+        out.transientVbSize = caps->limits.transientVbSize;
+        out.transientIbSize = caps->limits.transientIbSize;
+    }
+    out.uiloTransientVbBytes = m_impl->transientVbLastFrame;
+    out.uiloTransientIbBytes = m_impl->transientIbLastFrame;
+    out.arenaVbBytes         = m_impl->arenaVbLastFrame;
+    out.arenaIbBytes         = m_impl->arenaIbLastFrame;
+    out.budgetDroppedDraws   = m_impl->budgetDroppedLastFrame;
+    // Profiler view stats, grouped by pass. Slice views count with the
+    // view they continue; everything else is a framebuffer view.
+    const Impl& impl = *m_impl;
+    for (uint16_t i = 0; i < s->numViews && s->viewStats; ++i) {
+        const bgfx::ViewStats& vs = s->viewStats[i];
+        const uint16_t v = vs.view;
+        const auto isSlice = [&](const std::vector<uint16_t>& views) {
+            return std::find(views.begin(), views.end(), v) != views.end();
+        };
+        RendererPassTiming* pass = &out.frameBufferPass;
+        if (v == impl.kSceneViewId || isSlice(impl.sliceSceneViews))          pass = &out.scenePass;
+        else if (v == impl.kBlurHViewId)                                     pass = &out.blurHPass;
+        else if (v == impl.kBlurVViewId)                                     pass = &out.blurVPass;
+        else if (v >= impl.kLadderViewFirst && v < impl.kGlassBgViewId)      pass = &out.blurLadderPass;
+        else if (v == impl.kGlassBgViewId)                                   pass = &out.glassBgPass;
+        else if (v == impl.kGlassChildViewId || isSlice(impl.sliceGlassViews)) pass = &out.glassChildPass;
+        else if (v == impl.kCompositeViewId)                                 pass = &out.compositePass;
+        pass->cpuMs += double(vs.cpuTimeEnd - vs.cpuTimeBegin) * toMs;
+        pass->gpuMs += double(vs.gpuTimeEnd - vs.gpuTimeBegin) * gpuToMs;
+    }
+    if (const size_t n = m_impl->frameTimeCount) {
+        double sum = 0.0, sq = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += m_impl->frameTimesMs[i];
+            sq  += (double)m_impl->frameTimesMs[i] * m_impl->frameTimesMs[i];
+        }
+        out.frameTimeMeanMs   = sum / (double)n;
+        out.frameTimeStdDevMs = std::sqrt(std::max(0.0, sq / (double)n
+                                          - out.frameTimeMeanMs * out.frameTimeMeanMs));
+    }
+    out.frameCostMs    = m_impl->frameCostNs * 1e-6;
+    out.inputLatencyMs = m_impl->inputLatencyMs;
+    return out;
+}
+
+// Node-based map: an entry plus its node links, and the bucket array.
+template <class Map>
+static uint64_t mapBytes(const Map& m) {
+    return uint64_t(m.size()) * (sizeof(typename Map::value_type) + 2 * sizeof(void*))
+         + uint64_t(m.bucket_count()) * sizeof(void*);
+}
+
+RendererMemoryStats Renderer::getMemoryStats() const {
+    Impl::CacheLock lock(*m_impl);
+    const auto& impl = *m_impl;
+    RendererMemoryStats out;
+
+    std::vector<const std::string*> pathOf(impl.fonts.size(), nullptr);
+    for (const auto& [path, id] : impl.fontByPath)
+        if (id < pathOf.size() && !pathOf[id]) pathOf[id] = &path;
+    std::unordered_set<const FontBlob*> blobs;
+    for (size_t i = 0; i < impl.fonts.size(); ++i) {
+        const auto& rec = impl.fonts[i];
+        if (rec.ttf && rec.ttf->file.valid() && blobs.insert(rec.ttf.get()).second)
+            (rec.ttf->file.isMapped() ? out.fontMappedBytes : out.fontFileBytes) += rec.ttf->size;
+        for (const auto& [px, face] : rec.sizes) {
+            RendererFaceMemory f;
+            f.font        = pathOf[i] ? *pathOf[i] : std::string();
+            f.pixelHeight = px;
+            f.sdf         = face.sdf;
+            f.glyphs      = (uint32_t)face.glyphs.size();
+            f.tableBytes  = sizeof(FontFace) + mapBytes(face.glyphs) + mapBytes(face.advances);
+            // R8 pages: a byte per texel of every glyph still packed.
+            for (const auto& [cp, g] : face.glyphs) {
+                if (g.page >= impl.glyphPages.size() || g.pageGen != impl.glyphPages[g.page].gen) continue;
+                f.atlasBytes += uint64_t(g.w) * g.h;
+            }
+            out.faces.push_back(std::move(f));
+        }
+    }
+
+    const uint64_t glyphPageBytes = uint64_t(Impl::kGlyphPageSize) * Impl::kGlyphPageSize;
+    for (const auto& p : impl.glyphPages) {
+        if (bgfx::isValid(p.tex)) out.glyphAtlasBytes += glyphPageBytes;
+        out.glyphShadowBytes += p.shadow.capacity();
+    }
+    out.textureBytes    = impl.textureBytes;
+    out.imageAtlasBytes = uint64_t(impl.imageAtlasPages.size())
+                        * Impl::kImageAtlasPageSize * Impl::kImageAtlasPageSize * 4;
+
+    // Pipeline targets are BGRA8: the scene at full size, the two blur
+    // targets at half, each ladder level at its own.
+    if (bgfx::isValid(impl.sceneFB)) {
+        const uint32_t w = impl.fbAllocW, h = impl.fbAllocH;
+        out.pipelineTargetBytes += Impl::fbBytes(w, h, FrameBufferFormat::BGRA8);
+        out.pipelineTargetBytes += 2 * Impl::fbBytes(std::max(1u, w / 2), std::max(1u, h / 2),
+                                                     FrameBufferFormat::BGRA8);
+        auto level = [&](size_t i) {
+            return Impl::fbBytes(std::max(1u, w >> (i + 1)), std::max(1u, h >> (i + 1)),
+                                 FrameBufferFormat::BGRA8);
+        };
+        for (size_t i = 0; i < impl.ladderDown.size(); ++i)
+            if (!(i == 0 && impl.ladderSharesBlurA)) out.pipelineTargetBytes += level(i);
+        for (size_t i = 0; i < impl.ladderUp.size(); ++i) out.pipelineTargetBytes += level(i);
+    }
+    if (bgfx::isValid(impl.outputFB))
+        out.pipelineTargetBytes += Impl::fbBytes(impl.outputW, impl.outputH, FrameBufferFormat::BGRA8);
+    out.frameBufferBytes = impl.liveFbBytes;
+    for (const auto& p : impl.fbPool) out.frameBufferPoolBytes += Impl::fbBytes(p.w, p.h, p.format);
+    out.geometryArenaBytes = (uint64_t)impl.solidArena.capacity * impl.solidLayout.getStride()
+                           + (uint64_t)impl.texArena.capacity   * impl.texLayout.getStride()
+                           + (uint64_t)impl.arenaIbCapacity     * sizeof(uint16_t);
+
+    if (const bgfx::Stats* st = bgfx::getStats()) {
+        out.gpuTextureBytes = (uint64_t)std::max<int64_t>(0, st->textureMemoryUsed);
+        out.gpuTargetBytes  = (uint64_t)std::max<int64_t>(0, st->rtMemoryUsed);
+    }
+    return out;
+}
+
+RendererStartupStats Renderer::getStartupStats() const { return m_impl->startup; }
+
+void Renderer::setPassTimings(bool enabled) {
+    m_impl->passTimings = enabled;
+    if (m_initialised) bgfx::setDebug(enabled ? BGFX_DEBUG_PROFILER : BGFX_DEBUG_NONE);
+}
+
+bool Renderer::getPassTimings() const {
+    return m_impl->passTimings;
+}
+
+void Renderer::countCulled(uint32_t n) {
+    m_impl->rs().culledThisFrame += n;
+}
+
+#if UILO_PROFILER
+void Renderer::getProfileCounters(uint32_t& submits, uint32_t& vertices) const {
+    const auto& rec = m_impl->rs();
+    submits  = rec.batchedSubmits + rec.immediateSubmits;
+    vertices = rec.verticesQueued;
+}
+#endif
+
+void Renderer::setInstancedShapes(bool enabled) {
+    // Queued instances keep drawing; only new shapes change path.
+    m_impl->shapeInstancingEnabled = enabled;
+}
+
+bool Renderer::getInstancedShapes() const { return m_impl->useShapeInstancing(); }
+
+void Renderer::setAnalyticAA(bool enabled) { m_impl->analyticAA = enabled; }
+
+bool Renderer::getAnalyticAA() const { return m_impl->analyticAA; }
+
+void Renderer::setIndexedClips(bool enabled) {
+    // Latched at beginFrame: clips pushed this frame keep their mode.
+    m_impl->clipTableWanted = enabled;
+}
+
+bool Renderer::getIndexedClips() const {
+    return m_impl->clipTableWanted && m_impl->clipTableSupported;
+}
+
+void Renderer::setVsync(bool enabled) {
+    if (m_sharedContext) {
+        std::fprintf(stderr, "[UILO] setVsync: a shared window presents with its primary\n");
+        return;
+    }
+    uint32_t f = m_resetFlags;
+    if (enabled) f |=  BGFX_RESET_VSYNC;
+    else         f &= ~BGFX_RESET_VSYNC;
+    if (f == m_resetFlags) return;
+    m_resetFlags = f;
+    Vec2u sz = getSize();
+    // maxFrameLatency only applies on full reset with width/height; keep init's.
+    bgfx::reset(sz.x, sz.y, m_resetFlags);
+    m_lastWidth  = sz.x;
+    m_lastHeight = sz.y;
+    // bgfx::reset can invalidate view->framebuffer bindings on some
+    // backends. Force ensureSceneFramebuffers() to rebuild + re-bind every
+    // reserved view on the next beginFrame by clearing the cached size.
+    m_impl->fbWidth  = 0;
+    m_impl->fbHeight = 0;
+}
+
+bool Renderer::getVsync() const {
+    return (m_resetFlags & BGFX_RESET_VSYNC) != 0;
+}
+
+bool Renderer::isAnimating() const {
+    return m_impl->animatedLastFrame;
+}
+
+void Renderer::setCursor(CursorType type) {
+    auto& impl = *m_impl;
+    int key = (int)type;
+    SDL_Cursor* cur = nullptr;
+    auto it = impl.cursors.find(key);
+    if (it != impl.cursors.end()) {
+        cur = (SDL_Cursor*)it->second;
+    } else {
+        SDL_SystemCursor sdlType = SDL_SYSTEM_CURSOR_DEFAULT;
+        switch (type) {
+            case CursorType::Arrow:          sdlType = SDL_SYSTEM_CURSOR_DEFAULT;   break;
+            case CursorType::Hand:           sdlType = SDL_SYSTEM_CURSOR_POINTER;   break;
+            case CursorType::SizeHorizontal: sdlType = SDL_SYSTEM_CURSOR_EW_RESIZE; break;
+            case CursorType::SizeVertical:   sdlType = SDL_SYSTEM_CURSOR_NS_RESIZE; break;
             case CursorType::Text:           sdlType = SDL_SYSTEM_CURSOR_TEXT;      break;
             case CursorType::Crosshair:      sdlType = SDL_SYSTEM_CURSOR_CROSSHAIR; break;
         }
@@ -681,9 +1770,12 @@ void Renderer::setCursor(CursorType type) {
 // ============================================================================
 
 void Renderer::beginFrame() {
+    auto& rec = m_impl->mainRecord;
     Vec2u sz = getSize();
     if (sz.x != m_lastWidth || sz.y != m_lastHeight) {
         if (m_ownsContext) bgfx::reset(sz.x, sz.y, m_resetFlags); // host owns reset when embedded
+        else if (m_sharedContext)
+            m_impl->createWindowTarget(std::max(sz.x, 1u), std::max(sz.y, 1u));
         m_lastWidth  = sz.x;
         m_lastHeight = sz.y;
     }
@@ -695,262 +1787,478 @@ void Renderer::beginFrame() {
         const auto now = clock::now();
         m_impl->elapsed = std::chrono::duration<float>(now - s_t0).count();
     }
-    // (Re)create offscreen scene + blur framebuffers if the window resized.
-    m_impl->ensureSceneFramebuffers(sz.x, sz.y);
-
-    // Predict whether this frame will use glass based on what we saw
-    // last frame. When bypassing, view 0 renders straight to the
-    // backbuffer and the endFrame pipeline (blur+replay+composite) is
-    // skipped entirely.
-    m_impl->bypassSceneFb     = !m_impl->hadGlassLastFrame;
-    m_impl->hadGlassThisFrame = false;
-
-    // Embedded: never bypass to the backbuffer (that would clear the host's
-    // scene). Always render to sceneFB, then composite over the host image.
-    if (!m_ownsContext) m_impl->bypassSceneFb = false;
-
-    // Scene view → sceneFB (set every frame in case bgfx reset clobbered it).
-    const uint16_t sceneView = m_impl->kSceneViewId;
-    if (m_impl->bypassSceneFb) {
-        bgfx::setViewFrameBuffer(sceneView, BGFX_INVALID_HANDLE);
-    } else {
-        bgfx::setViewFrameBuffer(sceneView, m_impl->sceneFB);
+    // Last frame's acquireFrameBuffer targets go back to the pool.
+    for (auto& fb : m_impl->transientFbs) destroyFrameBuffer(fb);
+    m_impl->transientFbs.clear();
+    m_impl->fbAllocsLastFrame = m_impl->fbAllocsThisFrame;
+    m_impl->fbAllocsThisFrame = 0;
+    m_impl->trimFrameBufferPool();
+    m_impl->beginGeometryFrame();
+    // The caches are shared between windows: the first beginFrame of a bgfx
+    // frame maintains them for all of them.
+    if (!m_impl->shared->frameOpen) {
+        m_impl->shared->frameOpen = true;
+        ++m_impl->frameIndex;
+        m_impl->trimTextRuns();
+        m_impl->trimArcMeshes();
+        m_impl->pumpTextureUploads();
+        m_impl->pumpGlyphBakes();
+        m_impl->trimTextures();
     }
+    m_impl->beginClipTableFrame();
+    rec.animatedThisFrame = false;
+    rec.culledThisFrame   = 0;
+    rec.rejectedThisFrame = 0;
+    rec.batchedSubmits    = 0;
+    rec.immediateSubmits  = 0;
+    std::fill(std::begin(rec.flushes), std::end(rec.flushes), 0u);
+#if UILO_PROFILER
+    rec.verticesQueued    = 0;
+#endif
+    // Back on the pipeline's own views until a recordParallel() moves on.
+    m_impl->slicesLastFrame = m_impl->slicesUsed;
+    m_impl->slicesUsed      = 0;
+    m_impl->parallelSlicesLastFrame = m_impl->parallelSlicesThisFrame;
+    m_impl->parallelSlicesThisFrame = 0;
+    rec.sceneView      = m_impl->kSceneViewId;
+    rec.glassChildView = m_impl->kGlassChildViewId;
+    rec.viewStackTop   = 0;
+
+    // Which target the scene view draws into is only decided in endFrame
+    // (see buildFrameGraph); bgfx latches it at bgfx::frame().
+    const uint16_t sceneView = m_impl->kSceneViewId;
     bgfx::setViewRect(sceneView, 0, 0, (uint16_t)sz.x, (uint16_t)sz.y);
     // Transparent clear when embedded so the UI composites over the host scene.
-    const uint32_t sceneClear = m_ownsContext ? 0x000000ff : 0x00000000;
+    const uint32_t sceneClear = m_impl->embedded ? 0x00000000 : 0x000000ff;
     bgfx::setViewClear(sceneView, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, sceneClear, 1.f, 0);
     bgfx::setViewMode(sceneView, bgfx::ViewMode::Sequential);
     submitOrtho(sceneView, sz);
     bgfx::touch(sceneView);
 
-    // Defensively clear any rotation left set by user code from the last
-    // frame so internal/system draws (composite, blur, etc.) never inherit.
+    // Defensively clear any transform / rotation left set by user code from
+    // the last frame so internal/system draws (composite, blur, etc.) never
+    // inherit.
+    rec.xformStack.clear();
+    rec.xform = {};
     clearRotation();
-    m_impl->deferredGlass.clear();
+    rec.deferredGlass.clear();
     // Reset clip-uniform dedup so the first draw of the frame always
     // pushes its uniforms (bgfx uniform state isn't guaranteed to
     // persist across bgfx::frame()).
-    m_impl->lastClipValid = false;
+    rec.lastClipValid = false;
     // Defensive reset: clip stacks should be balanced each frame.
-    m_impl->scissorTop = 0;
-    m_impl->roundClipTop = 0;
-    m_impl->scissorOverflowDepth = 0;
-    m_impl->roundClipOverflowDepth = 0;
+    rec.scissorTop = 0;
+    rec.roundClipTop = 0;
+    rec.scissorOverflowDepth = 0;
+    rec.roundClipOverflowDepth = 0;
+    rec.layerStack.clear();
+    rec.viewOrigin   = {0.f, 0.f};
+    rec.layerTainted = false;
+    rec.sceneHash    = Impl::kHashBasis;
+    rec.touchedViews.reset();
 }
 
 void Renderer::endFrame() {
-    // Flush any rects still sitting in the solid-rect batch from the
+    UILO_TRACE_ZONE("Renderer::endFrame");
+    auto& rec = m_impl->mainRecord;
+    // Flush any shapes or text still sitting in the draw batches from the
     // last user draw call before kicking off internal passes.
-    m_impl->flushSolidBatch();
-
-    // Carry the per-frame glass-presence flag into the next frame's
-    // prediction. Done before the early-out below so the next frame
-    // correctly switches back to the FB pipeline when glass appeared.
-    m_impl->hadGlassLastFrame = m_impl->hadGlassThisFrame;
-
-    if (m_impl->bypassSceneFb) {
-        // Scene was rendered directly to backbuffer; nothing else to do.
-        m_impl->deferredGlass.clear();
-        if (m_ownsContext) bgfx::frame(); // host presents when embedded
-        // Framerate cap (unchanged from the FB path below).
-        if (m_frameInterval > 0.0) {
-            using clock = std::chrono::steady_clock;
-            const auto now    = clock::now();
-            const auto nowNs  = (uint64_t)std::chrono::duration_cast<
-                                    std::chrono::nanoseconds>(now.time_since_epoch()).count();
-            const uint64_t intervalNs = (uint64_t)(m_frameInterval * 1e9);
-            if (m_nextFrameTick == 0 || nowNs > m_nextFrameTick + intervalNs) {
-                m_nextFrameTick = nowNs + intervalNs;
-            } else {
-                if (nowNs < m_nextFrameTick) {
-                    const uint64_t waitNs = m_nextFrameTick - nowNs;
-                    constexpr uint64_t spinMarginNs = 500'000;
-                    if (waitNs > spinMarginNs) {
-                        std::this_thread::sleep_for(
-                            std::chrono::nanoseconds(waitNs - spinMarginNs));
-                    }
-                    while ((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
-                               clock::now().time_since_epoch()).count() < m_nextFrameTick) {
-                        std::this_thread::yield();
-                    }
-                }
-                m_nextFrameTick += intervalNs;
-            }
-        }
-        return;
-    }
-
-    // After the scene has been submitted to sceneFB (without any glass
-    // elements — those were deferred), run the blur ladder so glass
-    // samples a glass-free backdrop, then replay the deferred glass
-    // draws into sceneFB, then composite.
+    m_impl->flushBatches();
+    m_impl->uploadClipTable();
+    m_impl->uploadGlyphAtlas();
+    m_impl->uploadGradientLut();
+
+    m_impl->animatedLastFrame = rec.animatedThisFrame;
+    m_impl->culledLastFrame   = rec.culledThisFrame;
+    m_impl->rejectedLastFrame = rec.rejectedThisFrame;
+    m_impl->batchedSubmitsLastFrame   = rec.batchedSubmits;
+    m_impl->immediateSubmitsLastFrame = rec.immediateSubmits;
+    std::copy(std::begin(rec.flushes), std::end(rec.flushes), m_impl->flushesLastFrame);
+
+    // The scene was submitted without any glass elements (those were
+    // deferred). The frame graph decides what runs on top of it: blur
+    // passes so glass samples a glass-free backdrop, the deferred glass
+    // replay, and the composite (or none of them, drawing the scene
+    // straight into the backbuffer).
     Vec2u sz = getSize();
-    // Skip the (expensive) blur ladder + glass replay entirely when no
-    // glass material drew this frame. The blur target's contents become
-    // stale but nothing samples them this frame, so it doesn't matter.
-    const bool anyGlass = !m_impl->deferredGlass.empty();
-    if (anyGlass) {
-        m_impl->runBlurPasses(sz.x, sz.y);
-    }
-
-    if (!m_impl->deferredGlass.empty()) {
-        // kGlassBgViewId was configured in beginFrame; push it so
-        // drawGlass submits there during replay. It executes BEFORE
-        // kGlassChildViewId (where child elements were submitted), so
-        // glass backgrounds end up beneath their children in sceneFB.
-        m_viewStack[m_viewStackTop++] = { m_impl->kGlassBgViewId };
-        m_impl->replayingGlass = true;
-        for (const auto& d : m_impl->deferredGlass) {
-            // Re-establish the scissor that was active at capture time.
-            // (Push then pop around each replay so they don't accumulate.)
-            if (d.hasScissor) {
-                m_impl->scissorStack[m_impl->scissorTop++] =
-                    { d.sx, d.sy, d.sw, d.sh };
-            }
-            drawGlass(d.dst, d.mat, d.baseColor);
-            if (d.hasScissor) {
-                --m_impl->scissorTop;
-            }
-        }
-        m_impl->replayingGlass = false;
-        m_impl->deferredGlass.clear();
-        if (m_viewStackTop > 0) --m_viewStackTop;
+    m_impl->buildFrameGraph(sz.x, sz.y, m_mousePos,
+                            std::max(0.f, m_impl->elapsed - m_mouseLastMoveT));
+    m_impl->compileFrameGraph();
+    m_impl->executeFrameGraph(sz.x, sz.y);
+    rec.deferredGlass.clear();
+    if (rec.encoder) {
+        bgfx::end(rec.encoder);
+        rec.encoder = nullptr;
     }
-
-    m_impl->compositeSceneToBackbuffer(sz.x, sz.y,
-                                       m_impl->texLayout,
-                                       m_impl->texProgram);
-
-    if (m_ownsContext) bgfx::frame(); // host presents when embedded
-    if (m_frameInterval > 0.0) {
-        using clock = std::chrono::steady_clock;
-        const auto now    = clock::now();
-        const auto nowNs  = (uint64_t)std::chrono::duration_cast<
-                                std::chrono::nanoseconds>(now.time_since_epoch()).count();
-        const uint64_t intervalNs = (uint64_t)(m_frameInterval * 1e9);
-        if (m_nextFrameTick == 0 || nowNs > m_nextFrameTick + intervalNs) {
-            // First call or we drifted way behind: re-anchor.
-            m_nextFrameTick = nowNs + intervalNs;
-        } else {
-            if (nowNs < m_nextFrameTick) {
-                const uint64_t waitNs = m_nextFrameTick - nowNs;
-                // Sleep most of the remaining time, leaving ~0.5 ms for a
-                // short spin so we don't overshoot due to scheduler latency.
-                constexpr uint64_t spinMarginNs = 500'000; // 0.5 ms
-                if (waitNs > spinMarginNs) {
-                    std::this_thread::sleep_for(
-                        std::chrono::nanoseconds(waitNs - spinMarginNs));
-                }
-                while ((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
-                           clock::now().time_since_epoch()).count() < m_nextFrameTick) {
-                    std::this_thread::yield();
-                }
-            }
-            m_nextFrameTick += intervalNs;
-        }
+    m_impl->latchGeometryFrame();
+
+    m_impl->submitReadbacks();
+    if (m_sharedContext) return;   // recorded into the primary's next frame
+    if (m_ownsContext) m_impl->submittedFrame = bgfx::frame(); // host presents when embedded
+    m_impl->shared->frameOpen = false;
+    m_impl->notePresent();
+    if (m_impl->initStartNs) {
+        m_impl->startup.firstFrameMs =
+            (float)((double)(Impl::pacerNowNs() - m_impl->initStartNs) * 1e-6);
+        m_impl->initStartNs = 0;
+    }
+    m_impl->deliverReadbacks();
+    if (const bgfx::Stats* s = bgfx::getStats()) {
+        m_impl->transientVbPeak = std::max(m_impl->transientVbPeak, (uint32_t)std::max(0, s->transientVbUsed));
+        m_impl->transientIbPeak = std::max(m_impl->transientIbPeak, (uint32_t)std::max(0, s->transientIbUsed));
     }
+    // With late input sampling the wait moves to waitForInputDeadline().
+    if (m_frameInterval > 0.0 && !m_impl->lateInput)
+        m_impl->paceFrame(m_frameInterval, m_nextFrameTick, 0);
+    m_impl->frameWorkStartNs = Impl::pacerNowNs();
 }
 
-void Renderer::submitOrtho(uint16_t viewId, Vec2u size) {
-    const float W  = (float)size.x;
-    const float H  = (float)size.y;
-    const float nd = 0.f, fd = 1.f;
-    const bool  hd = bgfx::getCaps()->homogeneousDepth;
-    const float zScale = hd ? 2.f/(fd-nd)      : 1.f/(fd-nd);
-    const float zBias  = hd ? -(fd+nd)/(fd-nd) : -nd/(fd-nd);
-    const float ortho[16] = {
-        2.f/W, 0.f,   0.f,    0.f,
-        0.f,  -2.f/H, 0.f,    0.f,
-        0.f,   0.f,   zScale, 0.f,
-       -1.f,   1.f,   zBias,  1.f
-    };
-    bgfx::setViewTransform(viewId, nullptr, ortho);
+void Renderer::submitOrtho(uint16_t viewId, Vec2u size, Vec2f origin) {
+    m_impl->onApiThread([viewId, size, origin] {
+        const float W  = (float)size.x;
+        const float H  = (float)size.y;
+        const float nd = 0.f, fd = 1.f;
+        const bool  hd = bgfx::getCaps()->homogeneousDepth;
+        const float zScale = hd ? 2.f/(fd-nd)      : 1.f/(fd-nd);
+        const float zBias  = hd ? -(fd+nd)/(fd-nd) : -nd/(fd-nd);
+        const float ortho[16] = {
+            2.f/W, 0.f,   0.f,    0.f,
+            0.f,  -2.f/H, 0.f,    0.f,
+            0.f,   0.f,   zScale, 0.f,
+           -1.f - 2.f * origin.x / W, 1.f + 2.f * origin.y / H, zBias, 1.f
+        };
+        bgfx::setViewTransform(viewId, nullptr, ortho);
+    });
 }
 
 uint16_t Renderer::currentViewId() const {
-    if (m_viewStackTop > 0) return m_viewStack[m_viewStackTop - 1].viewId;
-    return m_impl->kSceneViewId; // rebased scene view (was hardcoded 0)
+    auto& rec = m_impl->rs();
+    if (rec.viewStackTop > 0) return rec.viewStack[rec.viewStackTop - 1].viewId;
+    return rec.sceneView; // rebased scene view, or this slice's
 }
 
 // ============================================================================
 //  Framebuffer
 // ============================================================================
 
-FrameBuffer Renderer::createFrameBuffer(Vec2u size) {
+bgfx::FrameBufferHandle Renderer::Impl::takePooledFrameBuffer(uint16_t& w, uint16_t& h,
+                                                              FrameBufferFormat format) {
+    const auto bucket = [](uint16_t px) {
+        return (uint16_t)((std::max<uint32_t>(px, 1u) + kFbPoolBucket - 1) / kFbPoolBucket * kFbPoolBucket);
+    };
+    w = bucket(w);
+    h = bucket(h);
+    for (size_t i = 0; i < fbPool.size(); ++i) {
+        const auto& p = fbPool[i];
+        if (p.w != w || p.h != h || p.format != format || p.releasedAt >= frameIndex) continue;
+        const bgfx::FrameBufferHandle fb = p.handle;
+        fbPool[i] = fbPool.back();
+        fbPool.pop_back();
+        return fb;
+    }
+    ++fbAllocsThisFrame;
+    return bgfx::createFrameBuffer(
+        w, h,
+        format == FrameBufferFormat::RGBA16F ? bgfx::TextureFormat::RGBA16F
+                                             : bgfx::TextureFormat::BGRA8,
+        BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
+}
+
+void Renderer::Impl::releasePooledFrameBuffer(bgfx::FrameBufferHandle handle, uint16_t w,
+                                              uint16_t h, FrameBufferFormat format) {
+    if (!bgfx::isValid(handle)) return;
+    fbPool.push_back({ handle, w, h, format, frameIndex });
+}
+
+void Renderer::Impl::trimFrameBufferPool() {
+    // Oldest releases first, so over kFbPoolMaxIdle the stalest go.
+    std::sort(fbPool.begin(), fbPool.end(),
+              [](const PooledFrameBuffer& a, const PooledFrameBuffer& b) {
+                  return a.releasedAt > b.releasedAt;
+              });
+    while (!fbPool.empty() &&
+           (fbPool.size() > kFbPoolMaxIdle ||
+            frameIndex - fbPool.back().releasedAt > kFbPoolIdleFrames)) {
+        bgfx::destroy(fbPool.back().handle);
+        fbPool.pop_back();
+    }
+}
+
+FrameBuffer Renderer::createFrameBuffer(Vec2u size, FrameBufferFormat format) {
+    Impl::CacheLock lock(*m_impl);
+    auto& impl = *m_impl;
     FrameBuffer fb;
     fb.size   = size;
-    fb.viewId = m_nextViewId++;
+    fb.format = format;
+    // Prefer a pooled view (executes before the scene); past the pool, fall
+    // back to a view after the composite, which the scene samples a frame late.
+    for (uint16_t v = impl.fbViewFirst; v < impl.fbViewFirst + Impl::kMaxFbViews; ++v) {
+        if (!impl.fbViews.test(v)) { fb.viewId = v; break; }
+    }
+    if (fb.viewId == UINT16_MAX && !impl.fbFreeViews.empty()) {
+        const auto lowest = std::min_element(impl.fbFreeViews.begin(), impl.fbFreeViews.end());
+        fb.viewId = *lowest;
+        *lowest = impl.fbFreeViews.back();
+        impl.fbFreeViews.pop_back();
+    }
+    if (fb.viewId == UINT16_MAX) {
+        if (m_nextViewId >= impl.viewLimit()) {
+            std::fprintf(stderr, "[UILO] createFrameBuffer: out of view ids\n");
+            fb.viewId = UINT16_MAX;
+            return fb;
+        }
+        fb.viewId = m_nextViewId++;
+    }
+    if (fb.viewId < impl.fbViews.size()) impl.fbViews.set(fb.viewId);
 
-    bgfx::FrameBufferHandle h = bgfx::createFrameBuffer(
-        (uint16_t)size.x, (uint16_t)size.y,
-        bgfx::TextureFormat::BGRA8,
-        BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
+    uint16_t aw = (uint16_t)size.x, ah = (uint16_t)size.y;
+    bgfx::FrameBufferHandle h = impl.takePooledFrameBuffer(aw, ah, format);
     fb.handle = h.idx;
-
-    bgfx::setViewFrameBuffer(fb.viewId, h);
-    bgfx::setViewRect(fb.viewId, 0, 0, (uint16_t)size.x, (uint16_t)size.y);
+    fb.alloc  = { aw, ah };
+    impl.liveFbBytes += Impl::fbBytes(aw, ah, format);
+
+    const uint16_t view = fb.viewId;
+    impl.onApiThread([view, h, size] {
+        bgfx::setViewFrameBuffer(view, h);
+        bgfx::setViewRect(view, 0, 0, (uint16_t)size.x, (uint16_t)size.y);
+    });
     submitOrtho(fb.viewId, size);
     return fb;
 }
 
+FrameBuffer Renderer::acquireFrameBuffer(Vec2u size, FrameBufferFormat format) {
+    FrameBuffer fb = createFrameBuffer(size, format);
+    if (fb.valid()) m_impl->transientFbs.push_back(fb);
+    return fb;
+}
+
 void Renderer::resizeFrameBuffer(FrameBuffer& fb, Vec2u newSize) {
     if (fb.size == newSize) return;
+    // Still fits the pooled target: just draw into more (or less) of it.
+    if (fb.valid() && newSize.x <= fb.alloc.x && newSize.y <= fb.alloc.y &&
+        newSize.x + Impl::kFbPoolBucket > fb.alloc.x &&
+        newSize.y + Impl::kFbPoolBucket > fb.alloc.y) {
+        fb.size = newSize;
+        const uint16_t view = fb.viewId;
+        m_impl->onApiThread([view, newSize] {
+            bgfx::setViewRect(view, 0, 0, (uint16_t)newSize.x, (uint16_t)newSize.y);
+        });
+        submitOrtho(fb.viewId, newSize);
+        return;
+    }
+    const FrameBufferFormat format = fb.format;
     destroyFrameBuffer(fb);
-    fb = createFrameBuffer(newSize);
+    fb = createFrameBuffer(newSize, format);
 }
 
 void Renderer::destroyFrameBuffer(FrameBuffer& fb) {
+    Impl::CacheLock lock(*m_impl);
     if (!fb.valid()) return;
-    bgfx::FrameBufferHandle h{ fb.handle };
-    bgfx::destroy(h);
+    auto& impl = *m_impl;
+    impl.releasePooledFrameBuffer(bgfx::FrameBufferHandle{ fb.handle },
+                                  (uint16_t)fb.alloc.x, (uint16_t)fb.alloc.y, fb.format);
+    impl.liveFbBytes -= std::min(impl.liveFbBytes, Impl::fbBytes(fb.alloc.x, fb.alloc.y, fb.format));
+    if (fb.viewId < impl.fbViews.size()) impl.fbViews.reset(fb.viewId);
+    if (fb.viewId >= impl.fbViewFirst + Impl::kMaxFbViews) impl.fbFreeViews.push_back(fb.viewId);
     fb.handle = UINT16_MAX;
 }
 
 void Renderer::pushFrameBuffer(FrameBuffer& fb) {
-    m_impl->flushSolidBatch();
-    assert(m_viewStackTop < kMaxViewStack);
-    m_viewStack[m_viewStackTop++] = { fb.viewId };
-    bgfx::setViewRect(fb.viewId, 0, 0, (uint16_t)fb.size.x, (uint16_t)fb.size.y);
+    auto& rec = m_impl->rs();
+    m_impl->flushBatches();
+    assert(rec.viewStackTop < Impl::RecordState::kMaxViewStack);
+    rec.viewStack[rec.viewStackTop++] = { fb.viewId };
+    const uint16_t view = fb.viewId;
+    const Vec2u    size = fb.size;
+    m_impl->onApiThread([view, size] {
+        bgfx::setViewRect(view, 0, 0, (uint16_t)size.x, (uint16_t)size.y);
+    });
     submitOrtho(fb.viewId, fb.size);
 }
 
 void Renderer::popFrameBuffer() {
-    m_impl->flushSolidBatch();
-    if (m_viewStackTop > 0) --m_viewStackTop;
+    auto& rec = m_impl->rs();
+    m_impl->flushBatches();
+    if (rec.viewStackTop > 0) --rec.viewStackTop;
 }
 
 void Renderer::beginGlassSubtree() {
-    m_impl->flushSolidBatch();
-    assert(m_viewStackTop < kMaxViewStack);
-    m_viewStack[m_viewStackTop++] = { m_impl->kGlassChildViewId };
+    auto& rec = m_impl->rs();
+    m_impl->flushBatches();
+    assert(rec.viewStackTop < Impl::RecordState::kMaxViewStack);
+    // Inside a layer the glass view would land in the scene, not the layer;
+    // keep drawing into the layer and flag it so the caller redraws directly.
+    if (!rec.layerStack.empty()) {
+        rec.layerTainted = true;
+        rec.viewStack[rec.viewStackTop] = { currentViewId() };
+        ++rec.viewStackTop;
+        return;
+    }
+    rec.viewStack[rec.viewStackTop++] = { rec.glassChildView };
 }
 
 void Renderer::endGlassSubtree() {
-    m_impl->flushSolidBatch();
-    if (m_viewStackTop > 0) --m_viewStackTop;
+    auto& rec = m_impl->rs();
+    m_impl->flushBatches();
+    if (rec.viewStackTop > 0) --rec.viewStackTop;
 }
 
 void Renderer::drawFrameBuffer(const FrameBuffer& fb, Vec2f dest, Vec2f size,
                                 Color tint) {
-    (void)fb; (void)dest; (void)size; (void)tint;
-    // TODO: textured-quad blit of fb's color attachment
+    if (!fb.valid()) return;
+    auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    impl.flushBatches();
+    if (!bgfx::isValid(impl.texProgram) || scissorEmpty(impl)) return;
+    if (size.x <= 0.f || size.y <= 0.f) return;
+    if (impl.rejectDraw({dest, size})) return;
+
+    bgfx::TransientVertexBuffer tvb;
+    bgfx::TransientIndexBuffer  tib;
+    if (!impl.allocTransient(&tvb, impl.texLayout, 4, &tib, 6)) return;
+
+    // The target is premultiplied, so the tint has to be too.
+    const float a = tint.a / 255.f;
+    const uint32_t col = packColor(Color{(uint8_t)std::lround(tint.r * a),
+                                         (uint8_t)std::lround(tint.g * a),
+                                         (uint8_t)std::lround(tint.b * a),
+                                         tint.a});
+    // Only the top-left fb.size of the pooled target holds the contents.
+    const bool  flipV = bgfx::getCaps()->originBottomLeft;
+    const float u1 = fb.alloc.x ? (float)fb.size.x / (float)fb.alloc.x : 1.f;
+    const float sv = fb.alloc.y ? (float)fb.size.y / (float)fb.alloc.y : 1.f;
+    const float v0 = flipV ? 1.f : 0.f;
+    const float v1 = flipV ? 1.f - sv : sv;
+    float x0 = dest.x,          y0 = dest.y;
+    float x1 = dest.x + size.x, y1 = dest.y;
+    float x2 = dest.x + size.x, y2 = dest.y + size.y;
+    float x3 = dest.x,          y3 = dest.y + size.y;
+    impl.xformPt(x0, y0); impl.xformPt(x1, y1);
+    impl.xformPt(x2, y2); impl.xformPt(x3, y3);
+    const PosColorUvVertex verts[4] = {
+        {x0, y0, col, 0.f, v0},
+        {x1, y1, col, u1,  v0},
+        {x2, y2, col, u1,  v1},
+        {x3, y3, col, 0.f, v1},
+    };
+    const uint16_t idx[6] = {0,1,2, 0,2,3};
+    std::memcpy(tvb.data, verts, sizeof(verts));
+    std::memcpy(tib.data, idx,   sizeof(idx));
+
+    bgfx::FrameBufferHandle h{ fb.handle };
+    bgfx::Encoder* enc = impl.enc();
+    enc->setTexture(0, impl.s_texColor, bgfx::getTexture(h));
+    const float flags[4] = { 0.f, 0.f, 0.f, 0.f };
+    enc->setUniform(impl.u_imgFlags, flags);
+    enc->setVertexBuffer(0, &tvb);
+    enc->setIndexBuffer(&tib);
+    enc->setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                   BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_ONE,
+                                         BGFX_STATE_BLEND_INV_SRC_ALPHA));
+    applyScissor(impl);
+    enc->submit(currentViewId(), impl.texProgram);
+    ++impl.rs().immediateSubmits;
+
+    // The target's contents only change on frames something drew into it.
+    const uint16_t view = currentViewId();
+    const uint32_t drawnAt = fb.viewId < rec.touchedViews.size() &&
+                             rec.touchedViews.test(fb.viewId) ? impl.frameIndex : 0u;
+    impl.hashSceneLiveState(view);
+    impl.hashScene(view, verts, sizeof(verts));
+    impl.hashSceneValue(view, fb.handle);
+    impl.hashSceneValue(view, drawnAt);
+}
+
+bool Renderer::beginLayer(FrameBuffer& fb, Vec2f origin) {
+    auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    if (!fb.valid() || rec.xformOn) return false;
+    if (rec.viewStackTop >= Impl::RecordState::kMaxViewStack) return false;
+    impl.flushBatches();
+
+    rec.layerStack.emplace_back();
+    auto& save = rec.layerStack.back();
+    std::memcpy(save.scissorStack,   rec.scissorStack,   sizeof(rec.scissorStack));
+    std::memcpy(save.roundClipStack, rec.roundClipStack, sizeof(rec.roundClipStack));
+    save.scissorTop             = rec.scissorTop;
+    save.scissorOverflowDepth   = rec.scissorOverflowDepth;
+    save.roundClipTop           = rec.roundClipTop;
+    save.roundClipOverflowDepth = rec.roundClipOverflowDepth;
+    save.viewOrigin             = rec.viewOrigin;
+    save.tainted                = rec.layerTainted;
+    rec.scissorTop             = 0;
+    rec.scissorOverflowDepth   = 0;
+    rec.roundClipTop           = 0;
+    rec.roundClipOverflowDepth = 0;
+    rec.viewOrigin             = origin;
+    rec.layerTainted           = false;
+    ++rec.clipVersion;
+
+    rec.viewStack[rec.viewStackTop++] = { fb.viewId };
+    const uint16_t view = fb.viewId;
+    const Vec2u    size = fb.size;
+    impl.onApiThread([view, size] {
+        bgfx::setViewRect(view, 0, 0, (uint16_t)size.x, (uint16_t)size.y);
+        bgfx::setViewClear(view, BGFX_CLEAR_COLOR, 0x00000000, 1.f, 0);
+        bgfx::setViewMode(view, bgfx::ViewMode::Sequential);
+    });
+    submitOrtho(fb.viewId, fb.size, origin);
+    impl.enc()->touch(fb.viewId);
+    return true;
+}
+
+bool Renderer::endLayer() {
+    auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    if (rec.layerStack.empty()) return false;
+    impl.flushBatches();
+    if (rec.viewStackTop > 0) --rec.viewStackTop;
+
+    const auto& save = rec.layerStack.back();
+    std::memcpy(rec.scissorStack,   save.scissorStack,   sizeof(rec.scissorStack));
+    std::memcpy(rec.roundClipStack, save.roundClipStack, sizeof(rec.roundClipStack));
+    rec.scissorTop             = save.scissorTop;
+    rec.scissorOverflowDepth   = save.scissorOverflowDepth;
+    rec.roundClipTop           = save.roundClipTop;
+    rec.roundClipOverflowDepth = save.roundClipOverflowDepth;
+    rec.viewOrigin             = save.viewOrigin;
+    const bool ok = !rec.layerTainted;
+    // An enclosing layer holds this one's contents, so it's tainted too.
+    rec.layerTainted = save.tainted || rec.layerTainted;
+    ++rec.clipVersion;
+    rec.layerStack.pop_back();
+    return ok;
 }
 
 // ============================================================================
 //  Scissor
 // ============================================================================
 
+Rectf Renderer::getClipBounds() const {
+    const auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    if (rec.scissorTop > 0) {
+        const auto& sc = rec.scissorStack[rec.scissorTop - 1];
+        return {{(float)sc.x + rec.viewOrigin.x, (float)sc.y + rec.viewOrigin.y},
+                {(float)sc.w, (float)sc.h}};
+    }
+    const Vec2u sz = getSize();
+    return {rec.viewOrigin, {(float)sz.x, (float)sz.y}};
+}
+
 void Renderer::pushScissor(Rectf b) {
-    // No batch flush here: the solid-rect batch flushes lazily on state
-    // mismatch at the next draw (see draw(Rect)).
+    // No batch flush here: the solid-shape batch flushes lazily on state
+    // mismatch at the next draw (see reserveSolidBatch).
     auto& impl = *m_impl;
-    if (impl.scissorTop >= Impl::kMaxScissor) {
-        ++impl.scissorOverflowDepth;
+    auto& rec = impl.rs();
+    if (rec.scissorTop >= Impl::kMaxScissor) {
+        ++rec.scissorOverflowDepth;
         return;
     }
-    if (impl.scissorTop > 0) {
-        auto& p  = impl.scissorStack[impl.scissorTop - 1];
+    b = impl.clipToScreen(b);
+    b.position -= rec.viewOrigin;   // scissor is in target pixels
+    if (rec.scissorTop > 0) {
+        auto& p  = rec.scissorStack[rec.scissorTop - 1];
         float px = (float)p.x, py = (float)p.y;
         float px2 = px + (float)p.w, py2 = py + (float)p.h;
         float bx2 = b.position.x + b.size.x, by2 = b.position.y + b.size.y;
@@ -980,7 +2288,7 @@ void Renderer::pushScissor(Rectf b) {
     const uint16_t w  = (uint16_t)std::max(0.f, x1f - x0f);
     const uint16_t h  = (uint16_t)std::max(0.f, y1f - y0f);
 
-    impl.scissorStack[impl.scissorTop++] = {
+    rec.scissorStack[rec.scissorTop++] = {
         x0,
         y0,
         w,
@@ -989,37 +2297,32 @@ void Renderer::pushScissor(Rectf b) {
 }
 
 void Renderer::popScissor() {
-    if (m_impl->scissorOverflowDepth > 0) {
-        --m_impl->scissorOverflowDepth;
+    auto& rec = m_impl->rs();
+    if (rec.scissorOverflowDepth > 0) {
+        --rec.scissorOverflowDepth;
         return;
     }
-    if (m_impl->scissorTop > 0) --m_impl->scissorTop;
+    if (rec.scissorTop > 0) --rec.scissorTop;
 }
 
 void Renderer::pushRoundClip(Rectf b, float radius) {
     auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    const int scissorTop = rec.scissorTop;
     pushScissor(b);
-    if (impl.roundClipTop >= Impl::kMaxRoundClip) {
-        ++impl.roundClipOverflowDepth;
+    if (rec.roundClipTop >= Impl::kMaxRoundClip) {
+        ++rec.roundClipOverflowDepth;
         return;
     }
-    ++impl.clipVersion;    // stack changes below; invalidate the clip cache
+    ++rec.clipVersion;    // stack changes below; invalidate the clip cache
+    const uint32_t parentNode = impl.clipNodeId();
     float r = std::max(0.f, radius);
-    if (r <= 0.f) {
-        // Plain rectangle: still record an "off" entry so pop balances
-        // and (when there's already a rounded parent clip) the parent
-        // clip still applies to children that don't add their own.
-        if (impl.roundClipTop == 0) {
-            impl.roundClipStack[impl.roundClipTop++] = {0.f, 0.f, 0.f, 0.f, -1.f};
-        } else {
-            // Inherit parent's clip verbatim so SDF mask doesn't change.
-            impl.roundClipStack[impl.roundClipTop] =
-                impl.roundClipStack[impl.roundClipTop - 1];
-            impl.roundClipTop++;
-        }
-        return;
+    if (!rec.xform.isIdentity()) {
+        if (!rec.xform.isAxisAligned()) r = 0.f;   // bounds no longer the shape
+        r *= impl.clipRadiusScale();
+        b  = impl.clipToScreen(b);
     }
-    // Snap rounded clip bounds to pixel edges to keep AA and corner shape
+    // Snap clip bounds to pixel edges to keep AA and corner shape
     // visually consistent across scales.
     const float x0 = std::floor(b.position.x);
     const float y0 = std::floor(b.position.y);
@@ -1039,25 +2342,134 @@ void Renderer::pushRoundClip(Rectf b, float radius) {
     // scissor pushed above; soft cropping by the parent's rounded edge
     // is an acceptable trade-off we skip here.
     r = std::min(r, std::min(halfW, halfH));
-    impl.roundClipStack[impl.roundClipTop++] = {cx, cy, halfW, halfH, r};
+
+    // Indexed clips: this clip becomes a node under the current one, and
+    // once it is, the node crops instead of the scissor (see batchScissor),
+    // including the parent's rounded edge skipped above.
+    uint32_t node = parentNode;
+    if (impl.clipTableOn) {
+        const uint32_t id = impl.internClipNode({ cx, cy, halfW, halfH, r, parentNode });
+        if (id != 0) {
+            node = id;
+            if (rec.scissorTop > scissorTop) rec.scissorStack[rec.scissorTop - 1].soft = true;
+        }
+    }
+
+    if (r <= 0.f) {
+        // Plain rectangle: still record an "off" entry so pop balances
+        // and (when there's already a rounded parent clip) the parent
+        // clip still applies to children that don't add their own.
+        if (rec.roundClipTop == 0) {
+            rec.roundClipStack[rec.roundClipTop++] = {0.f, 0.f, 0.f, 0.f, -1.f, node};
+        } else {
+            // Inherit parent's clip verbatim so SDF mask doesn't change.
+            rec.roundClipStack[rec.roundClipTop] =
+                rec.roundClipStack[rec.roundClipTop - 1];
+            rec.roundClipStack[rec.roundClipTop].node = node;
+            rec.roundClipTop++;
+        }
+        return;
+    }
+    rec.roundClipStack[rec.roundClipTop++] = {cx, cy, halfW, halfH, r, node};
 }
 
 void Renderer::popRoundClip() {
     auto& impl = *m_impl;
-    if (impl.roundClipOverflowDepth > 0) {
-        --impl.roundClipOverflowDepth;
-    } else if (impl.roundClipTop > 0) {
-        --impl.roundClipTop;
-        ++impl.clipVersion;
+    auto& rec = impl.rs();
+    if (rec.roundClipOverflowDepth > 0) {
+        --rec.roundClipOverflowDepth;
+    } else if (rec.roundClipTop > 0) {
+        --rec.roundClipTop;
+        ++rec.clipVersion;
     }
     popScissor();
 }
 
+void Renderer::Impl::updateEffectiveXform() {
+    auto& rec = rs();
+    rec.effective = rec.xform;
+    if (rec.rotation.enabled) {
+        const float px = rec.rotation.pivotX, py = rec.rotation.pivotY;
+        const Transform2D r{ rec.rotation.cosA, rec.rotation.sinA, -rec.rotation.sinA, rec.rotation.cosA,
+                             px - rec.rotation.cosA * px + rec.rotation.sinA * py,
+                             py - rec.rotation.sinA * px - rec.rotation.cosA * py };
+        rec.effective = rec.xform * r;
+    }
+    rec.xformOn = !rec.effective.isIdentity();
+}
+
+Rectf Renderer::Impl::clipToScreen(Rectf b) const {
+    auto& rec = rs();
+    if (rec.xform.isIdentity()) return b;
+    const Vec2f p0 = rec.xform.apply(b.position);
+    const Vec2f p1 = rec.xform.apply({b.right(), b.position.y});
+    const Vec2f p2 = rec.xform.apply({b.right(), b.bottom()});
+    const Vec2f p3 = rec.xform.apply({b.position.x, b.bottom()});
+    const float x0 = std::min(std::min(p0.x, p1.x), std::min(p2.x, p3.x));
+    const float y0 = std::min(std::min(p0.y, p1.y), std::min(p2.y, p3.y));
+    const float x1 = std::max(std::max(p0.x, p1.x), std::max(p2.x, p3.x));
+    const float y1 = std::max(std::max(p0.y, p1.y), std::max(p2.y, p3.y));
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+bool Renderer::Impl::rejectDraw(Rectf b, float pad) {
+    auto& rec = rs();
+    if (rec.scissorTop == 0) return false;
+    float x0 = b.position.x - pad, y0 = b.position.y - pad;
+    float x1 = b.right() + pad,    y1 = b.bottom() + pad;
+    if (rec.xformOn) {
+        const Vec2f p0 = rec.effective.apply({x0, y0});
+        const Vec2f p1 = rec.effective.apply({x1, y0});
+        const Vec2f p2 = rec.effective.apply({x1, y1});
+        const Vec2f p3 = rec.effective.apply({x0, y1});
+        x0 = std::min(std::min(p0.x, p1.x), std::min(p2.x, p3.x));
+        y0 = std::min(std::min(p0.y, p1.y), std::min(p2.y, p3.y));
+        x1 = std::max(std::max(p0.x, p1.x), std::max(p2.x, p3.x));
+        y1 = std::max(std::max(p0.y, p1.y), std::max(p2.y, p3.y));
+    }
+    // The scissor is in target pixels.
+    const auto& sc = rec.scissorStack[rec.scissorTop - 1];
+    x0 -= rec.viewOrigin.x; x1 -= rec.viewOrigin.x;
+    y0 -= rec.viewOrigin.y; y1 -= rec.viewOrigin.y;
+    if (x1 > (float)sc.x && y1 > (float)sc.y &&
+        x0 < (float)(sc.x + sc.w) && y0 < (float)(sc.y + sc.h)) return false;
+    ++rec.rejectedThisFrame;
+    return true;
+}
+
+float Renderer::Impl::clipRadiusScale() const {
+    auto& rec = rs();
+    return std::sqrt(std::abs(rec.xform.a * rec.xform.d - rec.xform.b * rec.xform.c));
+}
+
+void Renderer::pushTransform(const Transform2D& t) {
+    // No flush, same as rotation: batched vertices are mapped as they're
+    // appended, and the instanced batch flushes on a matrix change.
+    auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    rec.xformStack.push_back({rec.xform, rec.rotation});
+    rec.xform    = rec.effective * t;
+    rec.rotation = {};
+    impl.updateEffectiveXform();
+}
+
+void Renderer::popTransform() {
+    auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    if (rec.xformStack.empty()) return;
+    rec.xform    = rec.xformStack.back().xform;
+    rec.rotation = rec.xformStack.back().rotation;
+    rec.xformStack.pop_back();
+    impl.updateEffectiveXform();
+}
+
+Transform2D Renderer::getTransform() const { return m_impl->rs().effective; }
+
 void Renderer::setRotation(float degrees, Vec2f pivot) {
     // No flush: rotation is applied CPU-side when vertices are appended,
     // so rects already queued in the batch keep the rotation they were
     // emitted under.
-    auto& r = m_impl->rotation;
+    auto& r = m_impl->rs().rotation;
     r.pivotX   = pivot.x;
     r.pivotY   = pivot.y;
     r.angleDeg = degrees;
@@ -1065,23 +2477,26 @@ void Renderer::setRotation(float degrees, Vec2f pivot) {
     r.cosA = std::cos(rad);
     r.sinA = std::sin(rad);
     r.enabled = std::abs(r.sinA) > 1e-6f || std::abs(r.cosA - 1.f) > 1e-6f;
+    m_impl->updateEffectiveXform();
 }
 
 void Renderer::rotate(float deltaDegrees) {
-    auto& r = m_impl->rotation;
+    auto& r = m_impl->rs().rotation;
     r.angleDeg += deltaDegrees;
     const float rad = r.angleDeg * (3.14159265f / 180.f);
     r.cosA = std::cos(rad);
     r.sinA = std::sin(rad);
     r.enabled = std::abs(r.sinA) > 1e-6f || std::abs(r.cosA - 1.f) > 1e-6f;
+    m_impl->updateEffectiveXform();
 }
 
 void Renderer::clearRotation() {
-    auto& r = m_impl->rotation;
+    auto& r = m_impl->rs().rotation;
     r.angleDeg = 0.f;
     r.cosA = 1.f;
     r.sinA = 0.f;
     r.enabled = false;
+    m_impl->updateEffectiveXform();
 }
 
 void Renderer::setMouseState(Vec2f mousePosFbPx) {
@@ -1098,12 +2513,15 @@ void Renderer::setMouseState(Vec2f mousePosFbPx) {
 }
 
 void Renderer::clear(Color color) {
-    m_impl->flushSolidBatch();
+    m_impl->flushBatches();
     uint32_t rgba = (uint32_t(color.r) << 24) | (uint32_t(color.g) << 16) |
                     (uint32_t(color.b) <<  8) |  uint32_t(color.a);
-    bgfx::setViewClear(currentViewId(),
-                       BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, rgba, 1.f, 0);
-    bgfx::touch(currentViewId());
+    const uint16_t view = currentViewId();
+    m_impl->onApiThread([view, rgba] {
+        bgfx::setViewClear(view, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, rgba, 1.f, 0);
+    });
+    m_impl->enc()->touch(currentViewId());
+    m_impl->hashSceneValue(currentViewId(), rgba);
 }
 
 // ============================================================================
@@ -1119,56 +2537,77 @@ static constexpr float kDeg2Rad = 3.14159265f / 180.f;
 // applied in the fragment shader, so a child element stays its own shape AND
 // gets cropped by the parent's rounded corners.
 void Renderer::Impl::refreshClipCache() {
-    if (curClipVersion == clipVersion) return;
+    auto& rec = rs();
+    if (rec.curClipVersion == rec.clipVersion) return;
     for (int i = 0; i < 4; ++i) {
-        curClipRect[i]    = 0.f;
-        curClipParams[i]  = 0.f;
-        curClipRect2[i]   = 0.f;
-        curClipParams2[i] = 0.f;
+        rec.curClipRect[i]    = 0.f;
+        rec.curClipParams[i]  = 0.f;
+        rec.curClipRect2[i]   = 0.f;
+        rec.curClipParams2[i] = 0.f;
     }
     int picked = 0;
-    for (int i = roundClipTop - 1; i >= 0 && picked < 2; --i) {
-        const auto& c = roundClipStack[i];
+    for (int i = rec.roundClipTop - 1; i >= 0 && picked < 2; --i) {
+        const auto& c = rec.roundClipStack[i];
         if (c.radius <= 0.f) continue;
         if (picked == 0) {
-            curClipRect[0] = c.cx;    curClipRect[1] = c.cy;
-            curClipRect[2] = c.halfW; curClipRect[3] = c.halfH;
-            curClipParams[0] = c.radius; curClipParams[1] = 1.f;
+            rec.curClipRect[0] = c.cx;    rec.curClipRect[1] = c.cy;
+            rec.curClipRect[2] = c.halfW; rec.curClipRect[3] = c.halfH;
+            rec.curClipParams[0] = c.radius; rec.curClipParams[1] = 1.f;
         } else {
-            curClipRect2[0] = c.cx;    curClipRect2[1] = c.cy;
-            curClipRect2[2] = c.halfW; curClipRect2[3] = c.halfH;
-            curClipParams2[0] = c.radius; curClipParams2[1] = 1.f;
+            rec.curClipRect2[0] = c.cx;    rec.curClipRect2[1] = c.cy;
+            rec.curClipRect2[2] = c.halfW; rec.curClipRect2[3] = c.halfH;
+            rec.curClipParams2[0] = c.radius; rec.curClipParams2[1] = 1.f;
         }
         ++picked;
     }
-    curClipVersion = clipVersion;
+    rec.curClipVersion = rec.clipVersion;
 }
 
-bool Renderer::Impl::batchStateMatches(uint16_t viewId) {
-    if (solidBatchView != viewId) return false;
-    const bool hasSc = scissorTop > 0;
-    if (hasSc != batchHasScissor) return false;
-    if (hasSc) {
-        const auto& sc = scissorStack[scissorTop - 1];
-        if (sc.x != batchScissor.x || sc.y != batchScissor.y ||
-            sc.w != batchScissor.w || sc.h != batchScissor.h) return false;
+bool Renderer::Impl::batchStateMatches(const BatchState& st, uint16_t viewId) {
+    auto& rec = rs();
+    if (st.view != viewId) return false;
+    const ScissorEntry* sc = batchScissor();
+    if ((sc != nullptr) != st.hasScissor) return false;
+    if (sc) {
+        if (sc->x != st.scissor.x || sc->y != st.scissor.y ||
+            sc->w != st.scissor.w || sc->h != st.scissor.h) return false;
     }
+    // Indexed clips ride the vertices; the uniforms stay off.
+    if (clipTableOn) return !st.clipParams[1] && !st.clipParams2[1];
     refreshClipCache();
-    return std::memcmp(curClipRect,    batchClipRect,    sizeof(curClipRect))    == 0
-        && std::memcmp(curClipParams,  batchClipParams,  sizeof(curClipParams))  == 0
-        && std::memcmp(curClipRect2,   batchClipRect2,   sizeof(curClipRect2))   == 0
-        && std::memcmp(curClipParams2, batchClipParams2, sizeof(curClipParams2)) == 0;
+    return std::memcmp(rec.curClipRect,    st.clipRect,    sizeof(rec.curClipRect))    == 0
+        && std::memcmp(rec.curClipParams,  st.clipParams,  sizeof(rec.curClipParams))  == 0
+        && std::memcmp(rec.curClipRect2,   st.clipRect2,   sizeof(rec.curClipRect2))   == 0
+        && std::memcmp(rec.curClipParams2, st.clipParams2, sizeof(rec.curClipParams2)) == 0;
 }
 
-void Renderer::Impl::captureBatchState(uint16_t viewId) {
-    solidBatchView  = viewId;
-    batchHasScissor = scissorTop > 0;
-    if (batchHasScissor) batchScissor = scissorStack[scissorTop - 1];
+void Renderer::Impl::captureBatchState(BatchState& st, uint16_t viewId) {
+    auto& rec = rs();
+    st.view = viewId;
+    const ScissorEntry* sc = batchScissor();
+    st.hasScissor = sc != nullptr;
+    if (sc) st.scissor = *sc;
+    if (clipTableOn) {
+        static constexpr float kOff[4] = {0.f, 0.f, 0.f, 0.f};
+        std::memcpy(st.clipRect,    kOff, sizeof(st.clipRect));
+        std::memcpy(st.clipParams,  kOff, sizeof(st.clipParams));
+        std::memcpy(st.clipRect2,   kOff, sizeof(st.clipRect2));
+        std::memcpy(st.clipParams2, kOff, sizeof(st.clipParams2));
+        return;
+    }
     refreshClipCache();
-    std::memcpy(batchClipRect,    curClipRect,    sizeof(batchClipRect));
-    std::memcpy(batchClipParams,  curClipParams,  sizeof(batchClipParams));
-    std::memcpy(batchClipRect2,   curClipRect2,   sizeof(batchClipRect2));
-    std::memcpy(batchClipParams2, curClipParams2, sizeof(batchClipParams2));
+    std::memcpy(st.clipRect,    rec.curClipRect,    sizeof(st.clipRect));
+    std::memcpy(st.clipParams,  rec.curClipParams,  sizeof(st.clipParams));
+    std::memcpy(st.clipRect2,   rec.curClipRect2,   sizeof(st.clipRect2));
+    std::memcpy(st.clipParams2, rec.curClipParams2, sizeof(st.clipParams2));
+}
+
+void Renderer::Impl::applyBatchState(const BatchState& st) {
+    if (st.hasScissor)
+        enc()->setScissor(st.scissor.x, st.scissor.y, st.scissor.w, st.scissor.h);
+    applyClipUniforms(*this, st.clipRect, st.clipParams,
+                      st.clipRect2, st.clipParams2);
+    bindClipTable();
 }
 
 namespace {
@@ -1182,70 +2621,362 @@ inline uint32_t packAvgColor(Color a, Color b, Color c, Color d) {
 }
 } // anon
 
-void Renderer::draw(const Rect& r) {
-    auto& impl = *m_impl;
-    if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
-
-    // Lazy flush: only break the batch when this rect's pipeline state
-    // (view + scissor + round-clip) differs from what the queued rects
-    // were recorded under.
-    const uint16_t view = currentViewId();
-    if (!impl.solidBatchVerts.empty() && !impl.batchStateMatches(view))
-        impl.flushSolidBatch();
-    if (impl.solidBatchVerts.empty())
-        impl.captureBatchState(view);
-
-    float x = r.position.x, y = r.position.y;
-    float w = r.size.x,     h = r.size.y;
+uint16_t Renderer::Impl::reserveSolidBatch(uint16_t viewId, uint32_t numVerts) {
+    auto& rec = rs();
+    // Lazy flush: only break the batch when the incoming shape's pipeline
+    // state (view + scissor + round-clip) differs from what the queued
+    // geometry was recorded under. A frame can also legitimately overflow
+    // uint16_t indices, so flush before crossing the line.
+    flushTextBatch(FlushReason::Switch);
+    flushShapeBatch(FlushReason::Switch);
+    if (!rec.solidBatchVerts.empty()) {
+        if (rec.solidBatchVerts.size() + numVerts > kBatchMaxVerts)
+            flushSolidBatch(FlushReason::Capacity);
+        else if (!batchStateMatches(rec.solidBatch, viewId))
+            flushSolidBatch(FlushReason::State);
+    }
+    if (rec.solidBatchVerts.empty())
+        captureBatchState(rec.solidBatch, viewId);
+#if UILO_PROFILER
+    rec.verticesQueued += numVerts;
+#endif
+    return (uint16_t)rec.solidBatchVerts.size();
+}
 
+void Renderer::Impl::appendSolidQuad(uint16_t viewId, float x, float y, float w, float h,
+                                     Color cTL, Color cTR, Color cBR, Color cBL,
+                                     bool gradient) {
+    auto& rec = rs();
     float x0 = x,     y0 = y;
     float x1 = x + w, y1 = y;
     float x2 = x + w, y2 = y + h;
     float x3 = x,     y3 = y + h;
-    impl.rotPt(x0, y0); impl.rotPt(x1, y1);
-    impl.rotPt(x2, y2); impl.rotPt(x3, y3);
+    xformPt(x0, y0); xformPt(x1, y1);
+    xformPt(x2, y2); xformPt(x3, y3);
 
     // Vertex order is TL, TR, BR, BL.
-    uint32_t c0, c1, c2, c3;
-    if (r.gradient) {
-        c0 = packColor(r.colorTL); c1 = packColor(r.colorTR);
-        c2 = packColor(r.colorBR); c3 = packColor(r.colorBL);
-    } else {
-        c0 = c1 = c2 = c3 = packColor(r.fillColor);
-    }
-
-    const uint16_t vertsNeeded = r.gradient ? 5 : 4;
-    const uint16_t base = (uint16_t)impl.solidBatchVerts.size();
-    // A frame can legitimately overflow uint16_t indices (65535 / 4 = 16383
-    // rects). Flush before crossing the line.
-    if (base + vertsNeeded > 65532) {
-        impl.flushSolidBatch();
-        impl.captureBatchState(view);
-    }
-    const uint16_t b2 = (uint16_t)impl.solidBatchVerts.size();
-    impl.solidBatchVerts.push_back({x0, y0, c0});
-    impl.solidBatchVerts.push_back({x1, y1, c1});
-    impl.solidBatchVerts.push_back({x2, y2, c2});
-    impl.solidBatchVerts.push_back({x3, y3, c3});
-    if (!r.gradient) {
-        impl.solidBatchIdx.push_back(b2 + 0);
-        impl.solidBatchIdx.push_back(b2 + 1);
-        impl.solidBatchIdx.push_back(b2 + 2);
-        impl.solidBatchIdx.push_back(b2 + 0);
-        impl.solidBatchIdx.push_back(b2 + 2);
-        impl.solidBatchIdx.push_back(b2 + 3);
+    const uint16_t base = reserveSolidBatch(viewId, gradient ? 5u : 4u);
+    const float    clip = (float)clipNodeId();
+    rec.solidBatchVerts.push_back({x0, y0, packColor(cTL), clip});
+    rec.solidBatchVerts.push_back({x1, y1, packColor(cTR), clip});
+    rec.solidBatchVerts.push_back({x2, y2, packColor(cBR), clip});
+    rec.solidBatchVerts.push_back({x3, y3, packColor(cBL), clip});
+    if (!gradient) {
+        static constexpr uint16_t kQuad[6] = {0,1,2, 0,2,3};
+        for (uint16_t i : kQuad) rec.solidBatchIdx.push_back(base + i);
+        return;
+    }
+    // Two triangles interpolate a 4-corner gradient with a visible seam
+    // along the shared diagonal whenever the corner colors aren't
+    // coplanar; a center vertex at the average color keeps the blend
+    // symmetric.
+    float cx = x + w * 0.5f, cy = y + h * 0.5f;
+    xformPt(cx, cy);
+    rec.solidBatchVerts.push_back({cx, cy, packAvgColor(cTL, cTR, cBL, cBR), clip});
+    static constexpr uint16_t kFan[12] = {0,1,4, 1,2,4, 2,3,4, 3,0,4};
+    for (uint16_t i : kFan) rec.solidBatchIdx.push_back(base + i);
+}
+
+void Renderer::Impl::appendFeatheredQuad(uint16_t viewId, float x, float y, float w, float h,
+                                         Color c) {
+    auto& rec = rs();
+    const Transform2D& m = rec.effective;
+    const bool xf = rec.xformOn;
+    // Half a screen pixel in local units along each axis.
+    const float sx = xf ? std::sqrt(m.a * m.a + m.b * m.b) : 1.f;
+    const float sy = xf ? std::sqrt(m.c * m.c + m.d * m.d) : 1.f;
+    if (sx <= 0.f || sy <= 0.f) return;
+    {
+        float x0 = x, y0 = y, x1 = x + w, y1 = y + h;
+        xformPt(x0, y0); xformPt(x1, y1);
+        const bool aligned = (!xf || m.isAxisAligned()) &&
+            x0 == std::floor(x0) && y0 == std::floor(y0) &&
+            x1 == std::floor(x1) && y1 == std::floor(y1);
+        if (aligned) {
+            appendSolidQuad(viewId, x, y, w, h, c, c, c, c, false);
+            return;
+        }
+    }
+    const float hx = 0.5f / sx, hy = 0.5f / sy;
+    // Under a pixel across, the inner quad collapses to the centre line and
+    // carries the partial coverage instead.
+    const float cover = std::min(1.f, w * sx) * std::min(1.f, h * sy);
+    const float ix0 = std::min(x + hx, x + w * 0.5f), ix1 = std::max(x + w - hx, x + w * 0.5f);
+    const float iy0 = std::min(y + hy, y + h * 0.5f), iy1 = std::max(y + h - hy, y + h * 0.5f);
+    const float ox0 = x - hx, ox1 = x + w + hx;
+    const float oy0 = y - hy, oy1 = y + h + hy;
+    float px[8] = { ix0, ix1, ix1, ix0,  ox0, ox1, ox1, ox0 };
+    float py[8] = { iy0, iy0, iy1, iy1,  oy0, oy0, oy1, oy1 };
+    for (int i = 0; i < 8; ++i) xformPt(px[i], py[i]);
+
+    const uint16_t base  = reserveSolidBatch(viewId, 8);
+    const float    clip  = (float)clipNodeId();
+    const uint32_t inner = packColor(Color{c.r, c.g, c.b, (uint8_t)std::lround(c.a * cover)});
+    const uint32_t outer = packColor(Color{c.r, c.g, c.b, 0});
+    for (int i = 0; i < 8; ++i)
+        rec.solidBatchVerts.push_back({px[i], py[i], i < 4 ? inner : outer, clip});
+    // Inner quad, then one quad per side of the ring (inner i, outer i + 4).
+    static constexpr uint16_t kIdx[30] = {
+        0,1,2, 0,2,3,
+        4,5,1, 4,1,0,   5,6,2, 5,2,1,   6,7,3, 6,3,2,   7,4,0, 7,0,3,
+    };
+    for (uint16_t i : kIdx) rec.solidBatchIdx.push_back(base + i);
+}
+
+namespace {
+constexpr int kCornerMaxSegs = 32;
+
+// Unit quarter circles, one per segment count: cs[segs][k] is the cos, sin
+// of k / segs * 90 degrees. Built once, read from any recording thread.
+struct CornerFans {
+    float cs[kCornerMaxSegs + 1][kCornerMaxSegs + 1][2];
+    CornerFans() {
+        for (int n = 1; n <= kCornerMaxSegs; ++n)
+            for (int k = 0; k <= n; ++k) {
+                const float a = 1.5707963f * (float)k / (float)n;
+                cs[n][k][0] = std::cos(a);
+                cs[n][k][1] = std::sin(a);
+            }
+    }
+};
+
+const CornerFans& cornerFans() {
+    static const CornerFans fans;
+    return fans;
+}
+
+// Segments per corner keeping the arc within a quarter pixel of the circle.
+int cornerSegments(float radius) {
+    if (radius <= 0.5f) return 1;
+    const float step = 2.f * std::acos(1.f - 0.25f / radius);
+    return std::clamp((int)std::ceil(1.5707963f / step), 1, kCornerMaxSegs);
+}
+
+inline Color lerpColor(Color a, Color b, float t) {
+    return Color{ (uint8_t)std::lround(a.r + (b.r - a.r) * t), (uint8_t)std::lround(a.g + (b.g - a.g) * t),
+                  (uint8_t)std::lround(a.b + (b.b - a.b) * t), (uint8_t)std::lround(a.a + (b.a - a.a) * t) };
+}
+} // anon
+
+void Renderer::Impl::appendRoundedFan(uint16_t viewId, float x, float y, float w, float h, float radius,
+                                      Color cTL, Color cTR, Color cBR, Color cBL, bool gradient) {
+    auto& rec = rs();
+    const Transform2D& m = rec.effective;
+    // Half a screen pixel in local units (mean scale under a transform).
+    const float scale = rec.xformOn ? 0.5f * (std::sqrt(m.a * m.a + m.b * m.b) +
+                                              std::sqrt(m.c * m.c + m.d * m.d)) : 1.f;
+    if (scale <= 0.f) return;
+    const float hp   = 0.5f / scale;
+    const int   segs = cornerSegments(radius * scale);
+    const auto& fan  = cornerFans().cs[segs];
+
+    // Corners clockwise from top-left; each arc turns a quarter starting
+    // from the direction given (cos, sin multipliers into the unit table).
+    struct Corner { float cx, cy, ux, uy, vx, vy; };
+    const Corner corners[4] = {
+        { x + radius,     y + radius,     -1.f,  0.f,  0.f, -1.f },   // left -> up
+        { x + w - radius, y + radius,      0.f, -1.f,  1.f,  0.f },   // up -> right
+        { x + w - radius, y + h - radius,  1.f,  0.f,  0.f,  1.f },   // right -> down
+        { x + radius,     y + h - radius,  0.f,  1.f, -1.f,  0.f },   // down -> left
+    };
+    const uint32_t ring = 4u * (uint32_t)(segs + 1);
+    const uint16_t base = reserveSolidBatch(viewId, ring * 2 + 1);
+    const float    clip = (float)clipNodeId();
+    const float    inR  = std::max(0.f, radius - hp), outR = radius + hp;
+    const uint32_t flat = packColor(cTL);
+
+    // Outer ring vertices keep the color with zero alpha.
+    auto colorAt = [&](float px, float py, bool outer) {
+        if (!gradient && !outer) return flat;
+        Color c = cTL;
+        if (gradient) {
+            const float u = w > 0.f ? std::clamp((px - x) / w, 0.f, 1.f) : 0.f;
+            const float v = h > 0.f ? std::clamp((py - y) / h, 0.f, 1.f) : 0.f;
+            c = lerpColor(lerpColor(cTL, cTR, u), lerpColor(cBL, cBR, u), v);
+        }
+        if (outer) c.a = 0;
+        return packColor(c);
+    };
+    // Inner ring (0 .. ring-1), outer ring (ring .. 2*ring-1), then centre.
+    for (int pass = 0; pass < 2; ++pass) {
+        const float rr = pass == 0 ? inR : outR;
+        for (const Corner& c : corners)
+            for (int k = 0; k <= segs; ++k) {
+                const float dx = c.ux * fan[k][0] + c.vx * fan[k][1];
+                const float dy = c.uy * fan[k][0] + c.vy * fan[k][1];
+                float px = c.cx + dx * rr, py = c.cy + dy * rr;
+                const uint32_t col = colorAt(px, py, pass == 1);
+                xformPt(px, py);
+                rec.solidBatchVerts.push_back({px, py, col, clip});
+            }
+    }
+    float cx = x + w * 0.5f, cy = y + h * 0.5f;
+    xformPt(cx, cy);
+    rec.solidBatchVerts.push_back({cx, cy, gradient ? packAvgColor(cTL, cTR, cBL, cBR) : flat, clip});
+
+    const uint16_t centre = (uint16_t)(base + ring * 2);
+    for (uint32_t i = 0; i < ring; ++i) {
+        const uint16_t a = (uint16_t)(base + i), b = (uint16_t)(base + (i + 1) % ring);
+        rec.solidBatchIdx.push_back(centre);
+        rec.solidBatchIdx.push_back(a);
+        rec.solidBatchIdx.push_back(b);
+        rec.solidBatchIdx.push_back(a);
+        rec.solidBatchIdx.push_back((uint16_t)(a + ring));
+        rec.solidBatchIdx.push_back((uint16_t)(b + ring));
+        rec.solidBatchIdx.push_back(a);
+        rec.solidBatchIdx.push_back((uint16_t)(b + ring));
+        rec.solidBatchIdx.push_back(b);
+    }
+}
+
+void Renderer::Impl::appendShape(uint16_t viewId, float x, float y, float w, float h,
+                                 float radius, float pad,
+                                 Color cTL, Color cTR, Color cBR, Color cBL) {
+    auto& rec = rs();
+    flushSolidBatch(FlushReason::Switch);
+    flushTextBatch(FlushReason::Switch);
+    if (!rec.shapeBatch.empty()) {
+        if (rec.shapeBatch.size() >= kShapeBatchMax)
+            flushShapeBatch(FlushReason::Capacity);
+        else if (rec.effective != rec.shapeBatchXform ||
+                 !batchStateMatches(rec.shapeBatchState, viewId))
+            flushShapeBatch(FlushReason::State);
+    }
+    if (rec.shapeBatch.empty()) {
+        captureBatchState(rec.shapeBatchState, viewId);
+        rec.shapeBatchXform = rec.effective;
+    }
+    auto rgb = [](Color c) {
+        return (float)(((uint32_t)c.r << 16) | ((uint32_t)c.g << 8) | (uint32_t)c.b);
+    };
+#if UILO_PROFILER
+    rec.verticesQueued += 4;
+#endif
+    rec.shapeBatch.push_back(ShapeInstance{
+        { x, y, w, h },
+        { rgb(cTL), rgb(cTR), rgb(cBR), rgb(cBL) },
+        { radius, (float)(cTL.a + cTR.a * 256), (float)(cBR.a + cBL.a * 256),
+          pad + (float)clipNodeId() * 4.f },
+    });
+}
+
+void Renderer::Impl::appendRampShape(uint16_t viewId, float x, float y, float w, float h,
+                                     float radius, float pad, const GradientRamp& ramp) {
+    // Colours are placeholders; the ramp fields take their slots below.
+    appendShape(viewId, x, y, w, h, radius, pad, Color{}, Color{}, Color{}, Color{});
+    auto& rec = rs();
+    ShapeInstance& inst = rec.shapeBatch.back();
+    std::memcpy(inst.rgb, ramp.geom, sizeof(inst.rgb));
+    inst.params[1] = ramp.radial ? -2.f : -1.f;
+    inst.params[2] = (float)ramp.row;
+    rec.shapeBatchRamps = true;
+}
+
+void Renderer::Impl::flushShapeBatch(FlushReason why) {
+    auto& rec = rs();
+    if (rec.shapeBatch.empty() || rec.shapeBatchState.view == UINT16_MAX) {
+        rec.shapeBatch.clear();
+        rec.shapeBatchRamps = false;
+        return;
+    }
+    const uint32_t n      = (uint32_t)rec.shapeBatch.size();
+    const uint16_t stride = (uint16_t)sizeof(ShapeInstance);
+    bgfx::InstanceDataBuffer idb;
+    if (bgfx::isValid(shapeProgram) && allocInstances(&idb, n, stride)) {
+        bgfx::Encoder* enc = this->enc();
+        std::memcpy(idb.data, rec.shapeBatch.data(), (size_t)n * stride);
+        enc->setVertexBuffer(0, unitQuadVb);
+        enc->setIndexBuffer(unitQuadIb);
+        enc->setInstanceDataBuffer(&idb);
+        const Transform2D& m = rec.shapeBatchXform;
+        const float xf[8] = { m.a, m.b, m.c, m.d, m.tx, m.ty, 0.f, 0.f };
+        enc->setUniform(u_shapeXform, xf, 2);
+        enc->setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                       blendState(rec.shapeBatchState.view));
+        applyBatchState(rec.shapeBatchState);
+        if (rec.shapeBatchRamps) bindGradientLut();
+        enc->submit(rec.shapeBatchState.view, shapeProgram);
+        ++rec.batchedSubmits;
+        ++rec.flushes[(size_t)why];
+        hashSceneState(rec.shapeBatchState);
+        hashScene(rec.shapeBatchState.view, rec.shapeBatch.data(), (size_t)n * stride);
+        hashScene(rec.shapeBatchState.view, xf, sizeof(xf));
+        // A recycled row changes what the same instances draw.
+        if (rec.shapeBatchRamps) hashSceneValue(rec.shapeBatchState.view, gradientEvictions);
+        if (!rec.recordingLists.empty()) recordShapeFlush();
     } else {
-        // Two triangles interpolate a 4-corner gradient with a visible seam
-        // along the shared diagonal whenever the corner colors aren't
-        // coplanar; a center vertex at the average color keeps the blend
-        // symmetric.
-        float cx = x + w * 0.5f, cy = y + h * 0.5f;
-        impl.rotPt(cx, cy);
-        impl.solidBatchVerts.push_back(
-            {cx, cy, packAvgColor(r.colorTL, r.colorTR, r.colorBL, r.colorBR)});
-        static constexpr uint16_t kFan[12] = {0,1,4, 1,2,4, 2,3,4, 3,0,4};
-        for (uint16_t i : kFan) impl.solidBatchIdx.push_back(b2 + i);
+        // Recorded as solid geometry by flushSolidBatch, not as instances.
+        replayShapesSolid(why);
+    }
+    rec.shapeBatch.clear();
+    rec.shapeBatchRamps = false;
+    rec.shapeBatchState.view = UINT16_MAX;
+}
+
+void Renderer::Impl::replayShapesSolid(FlushReason why) {
+    auto& rec = rs();
+    // appendShape flushed the solid batch, so it is free to take the
+    // shapes' own snapshot; the vertices are transformed here rather than
+    // through the live xformPt, which may have moved on since.
+    const Transform2D& m = rec.shapeBatchXform;
+    auto corner = [](float rgb, float a) {
+        const uint32_t c = (uint32_t)rgb;
+        return packColor(Color{ (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c, (uint8_t)a });
+    };
+    for (const ShapeInstance& s : rec.shapeBatch) {
+        // Ramp instances carry their geometry in rgb; no LUT on this path.
+        if (s.params[1] < 0.f) {
+            budgetDroppedThisFrame.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (rec.solidBatchVerts.size() + 4 > kBatchMaxVerts)
+            flushSolidBatch(FlushReason::Capacity);
+        if (rec.solidBatchVerts.empty()) rec.solidBatch = rec.shapeBatchState;
+        const float x = s.rect[0], y = s.rect[1], w = s.rect[2], h = s.rect[3];
+        const float px[4] = { x, x + w, x + w, x };
+        const float py[4] = { y, y, y + h, y + h };
+        const float a[4]  = { std::fmod(s.params[1], 256.f), std::floor(s.params[1] / 256.f),
+                              std::fmod(s.params[2], 256.f), std::floor(s.params[2] / 256.f) };
+        const float    clip = std::floor(s.params[3] / 4.f);
+        const uint16_t base = (uint16_t)rec.solidBatchVerts.size();
+        for (int i = 0; i < 4; ++i) {
+            const Vec2f p = m.apply({ px[i], py[i] });
+            rec.solidBatchVerts.push_back({ p.x, p.y, corner(s.rgb[i], a[i]), clip });
+        }
+        static constexpr uint16_t kQuad[6] = {0,1,2, 0,2,3};
+        for (uint16_t i : kQuad) rec.solidBatchIdx.push_back(base + i);
     }
+    flushSolidBatch(why);
+}
+
+void Renderer::draw(const Rect& r) {
+    auto& impl = *m_impl;
+    if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
+    const bool aa = impl.analyticAA;
+    if (impl.rejectDraw({r.position, r.size}, aa ? 1.f : 0.f)) return;
+
+    const float x = r.position.x, y = r.position.y;
+    const float w = r.size.x,     h = r.size.y;
+    if (impl.useShapeInstancing()) {
+        // Radius -1: fs_shape's box coverage ramp, padded by a pixel.
+        const float radius = aa ? -1.f : 0.f;
+        const float pad    = aa ?  1.f : 0.f;
+        if (r.ramp.valid())
+            impl.appendRampShape(currentViewId(), x, y, w, h, radius, pad, r.ramp);
+        else if (r.gradient)
+            impl.appendShape(currentViewId(), x, y, w, h, radius, pad,
+                             r.colorTL, r.colorTR, r.colorBR, r.colorBL);
+        else
+            impl.appendShape(currentViewId(), x, y, w, h, radius, pad,
+                             r.fillColor, r.fillColor, r.fillColor, r.fillColor);
+    } else if (r.gradient)
+        impl.appendSolidQuad(currentViewId(), x, y, w, h,
+                             r.colorTL, r.colorTR, r.colorBR, r.colorBL, true);
+    else if (aa)
+        impl.appendFeatheredQuad(currentViewId(), x, y, w, h, r.fillColor);
+    else
+        impl.appendSolidQuad(currentViewId(), x, y, w, h,
+                             r.fillColor, r.fillColor, r.fillColor, r.fillColor, false);
 
     if (r.outlineThickness > 0.f && r.outlineColor.a > 0) {
         float t = r.outlineThickness;
@@ -1257,48 +2988,274 @@ void Renderer::draw(const Rect& r) {
     }
 }
 
-void Renderer::Impl::flushSolidBatch() {
-    if (solidBatchVerts.empty() || solidBatchView == UINT16_MAX) {
-        solidBatchVerts.clear();
-        solidBatchIdx.clear();
+void Renderer::Impl::flushSolidBatch(FlushReason why) {
+    auto& rec = rs();
+    if (rec.solidBatchVerts.empty() || rec.solidBatch.view == UINT16_MAX) {
+        rec.solidBatchVerts.clear();
+        rec.solidBatchIdx.clear();
         return;
     }
     if (!bgfx::isValid(solidProgram)) {
-        solidBatchVerts.clear();
-        solidBatchIdx.clear();
-        solidBatchView = UINT16_MAX;
+        rec.solidBatchVerts.clear();
+        rec.solidBatchIdx.clear();
+        rec.solidBatch.view = UINT16_MAX;
         return;
     }
-    const uint32_t numV = (uint32_t)solidBatchVerts.size();
-    const uint32_t numI = (uint32_t)solidBatchIdx.size();
-    bgfx::TransientVertexBuffer tvb;
-    bgfx::TransientIndexBuffer  tib;
-    if (bgfx::allocTransientBuffers(&tvb, solidLayout, numV, &tib, numI)) {
-        std::memcpy(tvb.data, solidBatchVerts.data(), numV * sizeof(PosColorVertex));
-        std::memcpy(tib.data, solidBatchIdx.data(),   numI * sizeof(uint16_t));
-        bgfx::setVertexBuffer(0, &tvb);
-        bgfx::setIndexBuffer(&tib);
-        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                       BGFX_STATE_BLEND_ALPHA);
+    const uint32_t numV = (uint32_t)rec.solidBatchVerts.size();
+    const uint32_t numI = (uint32_t)rec.solidBatchIdx.size();
+    bgfx::Encoder* enc = this->enc();
+    if (setBatchGeometry(enc, false, rec.solidBatchVerts.data(), numV, rec.solidBatchIdx.data(), numI)) {
+        enc->setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                       blendState(rec.solidBatch.view));
         // Apply the scissor/round-clip snapshot captured when the batch
         // started. Flushing is lazy, so the live stacks may have changed
-        // since these rects were queued — the snapshot is what they were
+        // since this geometry was queued — the snapshot is what it was
         // actually drawn under.
-        if (batchHasScissor)
-            bgfx::setScissor(batchScissor.x, batchScissor.y,
-                             batchScissor.w, batchScissor.h);
-        applyClipUniforms(*this, batchClipRect, batchClipParams,
-                          batchClipRect2, batchClipParams2);
-        bgfx::submit(solidBatchView, solidProgram);
+        applyBatchState(rec.solidBatch);
+        enc->submit(rec.solidBatch.view, solidProgram);
+        ++rec.batchedSubmits;
+        ++rec.flushes[(size_t)why];
+        hashSceneState(rec.solidBatch);
+        hashScene(rec.solidBatch.view, rec.solidBatchVerts.data(), numV * sizeof(PosColorVertex));
+        hashScene(rec.solidBatch.view, rec.solidBatchIdx.data(),   numI * sizeof(uint16_t));
+    }
+    if (!rec.recordingLists.empty())
+        recordFlush(false, rec.solidBatch, solidProgram, BGFX_INVALID_HANDLE);
+    rec.solidBatchVerts.clear();
+    rec.solidBatchIdx.clear();
+    rec.solidBatch.view = UINT16_MAX;
+}
+
+void Renderer::Impl::flushBatches() {
+    flushSolidBatch();
+    flushTextBatch();
+    flushShapeBatch();
+    for (auto* list : rs().recordingLists) list->tainted = true;
+}
+
+// ============================================================================
+//  Retained draw lists
+// ============================================================================
+
+DrawList::DrawList() = default;
+DrawList::~DrawList() = default;
+DrawList::DrawList(DrawList&&) noexcept = default;
+DrawList& DrawList::operator=(DrawList&&) noexcept = default;
+
+bool DrawList::valid() const { return m_data && m_data->valid; }
+void DrawList::reset()       { m_data.reset(); }
+
+namespace {
+bool sameBatchState(const Renderer::Impl::BatchState& a,
+                    const Renderer::Impl::BatchState& b) {
+    if (a.view != b.view || a.hasScissor != b.hasScissor) return false;
+    if (a.hasScissor &&
+        (a.scissor.x != b.scissor.x || a.scissor.y != b.scissor.y ||
+         a.scissor.w != b.scissor.w || a.scissor.h != b.scissor.h)) return false;
+    return std::memcmp(a.clipRect,    b.clipRect,    sizeof(a.clipRect))    == 0
+        && std::memcmp(a.clipParams,  b.clipParams,  sizeof(a.clipParams))  == 0
+        && std::memcmp(a.clipRect2,   b.clipRect2,   sizeof(a.clipRect2))   == 0
+        && std::memcmp(a.clipParams2, b.clipParams2, sizeof(a.clipParams2)) == 0;
+}
+} // anon
+
+void Renderer::Impl::recordFlush(bool text, const BatchState& st,
+                                 bgfx::ProgramHandle program,
+                                 bgfx::TextureHandle atlas) {
+    CacheLock lock(*this);
+    auto& rec = rs();
+    // Images batch through the text path. Only atlas pages are sure to
+    // outlive the recording; any other texture may be destroyed under it.
+    if (text && program.idx == texProgram.idx && !isImageAtlasPage(atlas.idx)) {
+        for (auto* list : rec.recordingLists) list->tainted = true;
+        return;
+    }
+    uint16_t page = UINT16_MAX;
+    if (text) {
+        for (size_t i = 0; i < glyphPages.size(); ++i)
+            if (glyphPages[i].tex.idx == atlas.idx) { page = (uint16_t)i; break; }
+    }
+    for (auto* list : rec.recordingLists) {
+        DrawList::Data::Cmd c;
+        c.text      = text;
+        c.state     = st;
+        c.program   = program;
+        c.atlas     = atlas;
+        c.page      = page;
+        c.firstIdx  = (uint32_t)list->idx.size();
+        if (text) {
+            c.firstVert = (uint32_t)list->textVerts.size();
+            c.numVerts  = (uint32_t)rec.textBatchVerts.size();
+            c.numIdx    = (uint32_t)rec.textBatchIdx.size();
+            list->textVerts.insert(list->textVerts.end(),
+                                   rec.textBatchVerts.begin(), rec.textBatchVerts.end());
+            list->idx.insert(list->idx.end(), rec.textBatchIdx.begin(), rec.textBatchIdx.end());
+        } else {
+            c.firstVert = (uint32_t)list->solidVerts.size();
+            c.numVerts  = (uint32_t)rec.solidBatchVerts.size();
+            c.numIdx    = (uint32_t)rec.solidBatchIdx.size();
+            list->solidVerts.insert(list->solidVerts.end(),
+                                    rec.solidBatchVerts.begin(), rec.solidBatchVerts.end());
+            list->idx.insert(list->idx.end(), rec.solidBatchIdx.begin(), rec.solidBatchIdx.end());
+        }
+        list->cmds.push_back(c);
+    }
+}
+
+void Renderer::Impl::recordShapeFlush() {
+    auto& rec = rs();
+    for (auto* list : rec.recordingLists) {
+        DrawList::Data::Cmd c;
+        c.shapes    = true;
+        c.state     = rec.shapeBatchState;
+        c.program   = shapeProgram;
+        c.xform     = rec.shapeBatchXform;
+        c.ramps     = rec.shapeBatchRamps;
+        c.firstVert = (uint32_t)list->shapes.size();
+        c.numVerts  = (uint32_t)rec.shapeBatch.size();
+        list->shapes.insert(list->shapes.end(), rec.shapeBatch.begin(), rec.shapeBatch.end());
+        list->cmds.push_back(c);
+    }
+}
+
+void Renderer::Impl::replayDrawCmd(const DrawList::Data& list, size_t cmd) {
+    auto& rec = rs();
+    const auto& c = list.cmds[cmd];
+    const uint16_t* idx = list.idx.data() + c.firstIdx;
+#if UILO_PROFILER
+    rec.verticesQueued += c.shapes ? c.numVerts * 4 : c.numVerts;
+#endif
+    if (c.shapes) {
+        flushSolidBatch(FlushReason::Switch);
+        flushTextBatch(FlushReason::Switch);
+        if (!rec.shapeBatch.empty()) {
+            if (rec.shapeBatch.size() + c.numVerts > kShapeBatchMax)
+                flushShapeBatch(FlushReason::Capacity);
+            else if (c.xform != rec.shapeBatchXform ||
+                     !sameBatchState(rec.shapeBatchState, c.state))
+                flushShapeBatch(FlushReason::State);
+        }
+        if (rec.shapeBatch.empty()) {
+            rec.shapeBatchState = c.state;
+            rec.shapeBatchXform = c.xform;
+        }
+        const auto* v = list.shapes.data() + c.firstVert;
+        rec.shapeBatch.insert(rec.shapeBatch.end(), v, v + c.numVerts);
+        if (c.ramps) {
+            // Keep the rows from being recycled while this frame samples them.
+            rec.shapeBatchRamps = true;
+            for (uint32_t i = 0; i < c.numVerts; ++i)
+                if (v[i].params[1] < 0.f && (size_t)v[i].params[2] < gradientRows.size())
+                    gradientRows[(size_t)v[i].params[2]].lastUse = frameIndex;
+        }
+    } else if (c.text) {
+        flushSolidBatch(FlushReason::Switch);
+        flushShapeBatch(FlushReason::Switch);
+        if (!rec.textBatchVerts.empty()) {
+            if (rec.textBatchVerts.size() + c.numVerts > kBatchMaxVerts)
+                flushTextBatch(FlushReason::Capacity);
+            else if (rec.textBatchAtlas.idx != c.atlas.idx ||
+                     rec.textBatchProgram.idx != c.program.idx ||
+                     !sameBatchState(rec.textBatch, c.state))
+                flushTextBatch(FlushReason::State);
+        }
+        if (rec.textBatchVerts.empty()) {
+            rec.textBatch        = c.state;
+            rec.textBatchAtlas   = c.atlas;
+            rec.textBatchProgram = c.program;
+        }
+        const uint16_t base = (uint16_t)rec.textBatchVerts.size();
+        const auto* v = list.textVerts.data() + c.firstVert;
+        rec.textBatchVerts.insert(rec.textBatchVerts.end(), v, v + c.numVerts);
+        for (uint32_t i = 0; i < c.numIdx; ++i)
+            rec.textBatchIdx.push_back((uint16_t)(base + idx[i]));
+        if (c.page < glyphPages.size()) glyphPages[c.page].lastUsed = frameIndex;
+    } else {
+        flushTextBatch(FlushReason::Switch);
+        flushShapeBatch(FlushReason::Switch);
+        if (!rec.solidBatchVerts.empty()) {
+            if (rec.solidBatchVerts.size() + c.numVerts > kBatchMaxVerts)
+                flushSolidBatch(FlushReason::Capacity);
+            else if (!sameBatchState(rec.solidBatch, c.state))
+                flushSolidBatch(FlushReason::State);
+        }
+        if (rec.solidBatchVerts.empty()) rec.solidBatch = c.state;
+        const uint16_t base = (uint16_t)rec.solidBatchVerts.size();
+        const auto* v = list.solidVerts.data() + c.firstVert;
+        rec.solidBatchVerts.insert(rec.solidBatchVerts.end(), v, v + c.numVerts);
+        for (uint32_t i = 0; i < c.numIdx; ++i)
+            rec.solidBatchIdx.push_back((uint16_t)(base + idx[i]));
     }
-    solidBatchVerts.clear();
-    solidBatchIdx.clear();
-    solidBatchView = UINT16_MAX;
+}
+
+void Renderer::beginDrawList(DrawList& list) {
+    auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    // Close out whatever is queued so the recording starts on a batch
+    // boundary (enclosing recordings capture it as their own content).
+    impl.flushSolidBatch();
+    impl.flushTextBatch();
+    impl.flushShapeBatch();
+    if (!list.m_data) list.m_data = std::make_unique<DrawList::Data>();
+    auto& d = *list.m_data;
+    d.solidVerts.clear();
+    d.textVerts.clear();
+    d.idx.clear();
+    d.shapes.clear();
+    d.cmds.clear();
+    impl.captureBatchState(d.entry, currentViewId());
+    d.entryXform     = rec.effective;
+    d.entryClipNode  = impl.clipNodeId();
+    d.indexedClips   = impl.clipTableOn;
+    d.clipGeneration = impl.clipGeneration;
+    Impl::CacheLock lock(impl);
+    d.glyphEvictions = impl.glyphAtlasEvictions;
+    d.gradientEvictions = impl.gradientEvictions;
+    d.tainted        = false;
+    d.valid          = false;
+    rec.recordingLists.push_back(&d);
+}
+
+bool Renderer::endDrawList(DrawList& list) {
+    auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    impl.flushSolidBatch();
+    impl.flushTextBatch();
+    impl.flushShapeBatch();
+    DrawList::Data* d = list.m_data.get();
+    if (!d) return false;
+    auto it = std::find(rec.recordingLists.begin(), rec.recordingLists.end(), d);
+    if (it != rec.recordingLists.end()) rec.recordingLists.erase(it);
+    // An eviction mid-recording may have recycled a page an earlier text
+    // command samples.
+    Impl::CacheLock lock(impl);
+    d->valid = !d->tainted && d->glyphEvictions == impl.glyphAtlasEvictions &&
+               d->gradientEvictions == impl.gradientEvictions &&
+               d->clipGeneration == impl.clipGeneration;
+    return d->valid;
+}
+
+bool Renderer::replayDrawList(const DrawList& list) {
+    auto& impl = *m_impl;
+    const DrawList::Data* d = list.m_data.get();
+    if (!d || !d->valid) return false;
+    // Replayed commands touch glyph pages' last use.
+    Impl::CacheLock lock(impl);
+    if (d->glyphEvictions != impl.glyphAtlasEvictions) return false;
+    if (d->gradientEvictions != impl.gradientEvictions) return false;
+    if (!impl.batchStateMatches(d->entry, currentViewId())) return false;
+    if (impl.rs().effective != d->entryXform) return false;
+    if (d->indexedClips != impl.clipTableOn || d->clipGeneration != impl.clipGeneration ||
+        d->entryClipNode != impl.clipNodeId()) return false;
+    for (size_t i = 0; i < d->cmds.size(); ++i) impl.replayDrawCmd(*d, i);
+    return true;
 }
 
 void Renderer::draw(const RoundedRect& rr) {
     auto& impl = *m_impl;
     if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
+    // The outline layer grows the shape by its thickness.
+    if (impl.rejectDraw({rr.position, rr.size}, std::max(0.f, rr.outlineThickness))) return;
 
     float r = std::min(rr.radius, std::min(rr.size.x, rr.size.y) * 0.5f);
     if (r <= 0.f) {
@@ -1307,173 +3264,105 @@ void Renderer::draw(const RoundedRect& rr) {
         rect.gradient = rr.gradient;
         rect.colorTL = rr.colorTL; rect.colorTR = rr.colorTR;
         rect.colorBL = rr.colorBL; rect.colorBR = rr.colorBR;
+        rect.ramp    = rr.ramp;
         draw(rect);
         return;
     }
 
-    // Immediate-mode submits below: flush queued rects first so draw order
-    // is preserved (push/popRoundClip no longer flush).
-    impl.flushSolidBatch();
-
     // Render the outline as a slightly larger rounded rect underneath, then
-    // the fill on top. Each is a single quad masked by the fragment-shader
-    // SDF clip — anti-aliased corners with no per-corner tessellation, which
-    // also means a gradient fill is nothing more than per-vertex colors.
-    auto submitQuad = [&](float x, float y, float w, float h,
-                          Color cTL, Color cTR, Color cBR, Color cBL,
-                          bool gradient) {
-        float x0 = x,     y0 = y;
-        float x1 = x + w, y1 = y;
-        float x2 = x + w, y2 = y + h;
-        float x3 = x,     y3 = y + h;
-        impl.rotPt(x0, y0); impl.rotPt(x1, y1);
-        impl.rotPt(x2, y2); impl.rotPt(x3, y3);
-        PosColorVertex verts[5] = {
-            {x0, y0, packColor(cTL)},
-            {x1, y1, packColor(cTR)},
-            {x2, y2, packColor(cBR)},
-            {x3, y3, packColor(cBL)},
-            {0.f, 0.f, 0u},             // center, used for gradients only
-        };
-        static constexpr uint16_t idxQuad[6]  = {0,1,2, 0,2,3};
-        // Center-vertex fan: see draw(Rect) — avoids the diagonal seam on
-        // non-coplanar corner colors.
-        static constexpr uint16_t idxFan[12]  = {0,1,4, 1,2,4, 2,3,4, 3,0,4};
-        const uint16_t* idx  = idxQuad;
-        uint32_t        numV = 4, numI = 6;
-        if (gradient) {
-            float cx = x + w * 0.5f, cy = y + h * 0.5f;
-            impl.rotPt(cx, cy);
-            verts[4] = {cx, cy, packAvgColor(cTL, cTR, cBL, cBR)};
-            idx = idxFan; numV = 5; numI = 12;
+    // the fill on top. Instanced, each is a single quad whose rounded mask
+    // fs_shape evaluates as an SDF from the instance radius, so rounded
+    // rects cost what rects do and share their batch.
+    const uint16_t view = currentViewId();
+    if (impl.useShapeInstancing()) {
+        if (rr.outlineThickness > 0.f && rr.outlineColor.a > 0) {
+            const float t = rr.outlineThickness;
+            impl.appendShape(view, rr.position.x - t, rr.position.y - t,
+                             rr.size.x + t * 2.f, rr.size.y + t * 2.f, r + t, 0.f,
+                             rr.outlineColor, rr.outlineColor, rr.outlineColor, rr.outlineColor);
         }
-
-        bgfx::TransientVertexBuffer tvb;
-        bgfx::TransientIndexBuffer  tib;
-        if (!bgfx::allocTransientBuffers(&tvb, impl.solidLayout, numV, &tib, numI))
-            return;
-        std::memcpy(tvb.data, verts, numV * sizeof(PosColorVertex));
-        std::memcpy(tib.data, idx,   numI * sizeof(uint16_t));
-        bgfx::setVertexBuffer(0, &tvb);
-        bgfx::setIndexBuffer(&tib);
-        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                       BGFX_STATE_BLEND_ALPHA);
-        applyScissor(impl);
-        bgfx::submit(currentViewId(), impl.solidProgram);
-    };
-
+        if (rr.ramp.valid())
+            impl.appendRampShape(view, rr.position.x, rr.position.y, rr.size.x, rr.size.y, r, 0.f,
+                                 rr.ramp);
+        else if (rr.gradient)
+            impl.appendShape(view, rr.position.x, rr.position.y, rr.size.x, rr.size.y, r, 0.f,
+                             rr.colorTL, rr.colorTR, rr.colorBR, rr.colorBL);
+        else
+            impl.appendShape(view, rr.position.x, rr.position.y, rr.size.x, rr.size.y, r, 0.f,
+                             rr.fillColor, rr.fillColor, rr.fillColor, rr.fillColor);
+        return;
+    }
+    // Without instancing both layers are tessellated from the cached corner
+    // arcs, which keeps them in the solid batch with the quads around them.
     if (rr.outlineThickness > 0.f && rr.outlineColor.a > 0) {
-        const float t  = rr.outlineThickness;
-        const float ox = rr.position.x - t;
-        const float oy = rr.position.y - t;
-        const float ow = rr.size.x + t * 2.f;
-        const float oh = rr.size.y + t * 2.f;
-        const float orad = r + t;
-        pushRoundClip({{ox, oy}, {ow, oh}}, orad);
-        submitQuad(ox, oy, ow, oh, rr.outlineColor, rr.outlineColor,
-                   rr.outlineColor, rr.outlineColor, false);
-        popRoundClip();
-    }
-
-    pushRoundClip({rr.position, rr.size}, r);
-    if (rr.gradient) {
-        submitQuad(rr.position.x, rr.position.y, rr.size.x, rr.size.y,
-                   rr.colorTL, rr.colorTR, rr.colorBR, rr.colorBL, true);
-    } else {
-        submitQuad(rr.position.x, rr.position.y, rr.size.x, rr.size.y,
-                   rr.fillColor, rr.fillColor, rr.fillColor, rr.fillColor, false);
+        const float t = rr.outlineThickness;
+        impl.appendRoundedFan(view, rr.position.x - t, rr.position.y - t,
+                              rr.size.x + t * 2.f, rr.size.y + t * 2.f, r + t,
+                              rr.outlineColor, rr.outlineColor, rr.outlineColor, rr.outlineColor, false);
     }
-    popRoundClip();
+    if (rr.gradient)
+        impl.appendRoundedFan(view, rr.position.x, rr.position.y, rr.size.x, rr.size.y, r,
+                              rr.colorTL, rr.colorTR, rr.colorBR, rr.colorBL, true);
+    else
+        impl.appendRoundedFan(view, rr.position.x, rr.position.y, rr.size.x, rr.size.y, r,
+                              rr.fillColor, rr.fillColor, rr.fillColor, rr.fillColor, false);
 }
 
 void Renderer::draw(const Circle& c) {
     auto& impl = *m_impl;
-    impl.flushSolidBatch();
     if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
     if (c.radius <= 0.f || c.fillColor.a == 0) return;
+    if (impl.rejectDraw({c.center.x - c.radius, c.center.y - c.radius,
+                         c.radius * 2.f, c.radius * 2.f}, 1.f)) return;
 
     // Render as a rounded-rect with radius == half-size — the fragment
     // shader SDF gives proper sub-pixel AA, matching Button/Dropdown.
     // Inflate the quad by 1px so the AA falloff has room outside the
-    // disc's geometric bounds (the SDF eats ~1px of edge).
+    // disc's geometric bounds (the SDF eats ~1px of edge). Without
+    // instancing the disc is a fan from the cached corner arcs instead.
     const float r   = c.radius;
     const float pad = 1.f;
-    const float x   = c.center.x - r - pad;
-    const float y   = c.center.y - r - pad;
-    const float w   = (r + pad) * 2.f;
-    const float h   = (r + pad) * 2.f;
-
-    pushRoundClip({{c.center.x - r, c.center.y - r}, {r * 2.f, r * 2.f}}, r);
-
-    uint32_t col = packColor(c.fillColor);
-    float x0 = x,     y0 = y;
-    float x1 = x + w, y1 = y;
-    float x2 = x + w, y2 = y + h;
-    float x3 = x,     y3 = y + h;
-    impl.rotPt(x0, y0); impl.rotPt(x1, y1);
-    impl.rotPt(x2, y2); impl.rotPt(x3, y3);
-    PosColorVertex verts[4] = {
-        {x0, y0, col},
-        {x1, y1, col},
-        {x2, y2, col},
-        {x3, y3, col},
-    };
-    uint16_t idx[6] = {0,1,2, 0,2,3};
 
-    bgfx::TransientVertexBuffer tvb;
-    bgfx::TransientIndexBuffer  tib;
-    if (!bgfx::allocTransientBuffers(&tvb, impl.solidLayout, 4, &tib, 6)) {
-        popRoundClip();
+    if (impl.useShapeInstancing()) {
+        impl.appendShape(currentViewId(), c.center.x - r, c.center.y - r, r * 2.f, r * 2.f,
+                         r, pad, c.fillColor, c.fillColor, c.fillColor, c.fillColor);
         return;
     }
-    std::memcpy(tvb.data, verts, sizeof(verts));
-    std::memcpy(tib.data, idx,   sizeof(idx));
-    bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
-    bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                   BGFX_STATE_BLEND_ALPHA);
-    applyScissor(impl);
-    bgfx::submit(currentViewId(), impl.solidProgram);
-
-    popRoundClip();
+    impl.appendRoundedFan(currentViewId(), c.center.x - r, c.center.y - r, r * 2.f, r * 2.f, r,
+                          c.fillColor, c.fillColor, c.fillColor, c.fillColor, false);
 }
 
 void Renderer::draw(const Triangle& t) {
     auto& impl = *m_impl;
-    impl.flushSolidBatch();
+    auto& rec = impl.rs();
     if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
+    {
+        const float x0 = std::min({t.a.x, t.b.x, t.c.x}), y0 = std::min({t.a.y, t.b.y, t.c.y});
+        const float x1 = std::max({t.a.x, t.b.x, t.c.x}), y1 = std::max({t.a.y, t.b.y, t.c.y});
+        if (impl.rejectDraw({x0, y0, x1 - x0, y1 - y0})) return;
+    }
 
     uint32_t col = packColor(t.fillColor);
     float ax = t.a.x, ay = t.a.y;
     float bx = t.b.x, by = t.b.y;
     float cx = t.c.x, cy = t.c.y;
-    impl.rotPt(ax, ay);
-    impl.rotPt(bx, by);
-    impl.rotPt(cx, cy);
-    PosColorVertex verts[3] = {
-        {ax, ay, col},
-        {bx, by, col},
-        {cx, cy, col},
-    };
-    uint16_t idx[3] = {0,1,2};
-
-    bgfx::TransientVertexBuffer tvb;
-    bgfx::TransientIndexBuffer  tib;
-    if (!bgfx::allocTransientBuffers(&tvb, impl.solidLayout, 3, &tib, 3))
-        return;
-    std::memcpy(tvb.data, verts, sizeof(verts));
-    std::memcpy(tib.data, idx,   sizeof(idx));
-    bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
-    bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                   BGFX_STATE_BLEND_ALPHA);
-    applyScissor(impl);
-    bgfx::submit(currentViewId(), impl.solidProgram);
+    impl.xformPt(ax, ay);
+    impl.xformPt(bx, by);
+    impl.xformPt(cx, cy);
+
+    const uint16_t base = impl.reserveSolidBatch(currentViewId(), 3);
+    const float    clip = (float)impl.clipNodeId();
+    rec.solidBatchVerts.push_back({ax, ay, col, clip});
+    rec.solidBatchVerts.push_back({bx, by, col, clip});
+    rec.solidBatchVerts.push_back({cx, cy, col, clip});
+    rec.solidBatchIdx.push_back(base + 0);
+    rec.solidBatchIdx.push_back(base + 1);
+    rec.solidBatchIdx.push_back(base + 2);
 }
 
 void Renderer::draw(const Line& l) {
     auto& impl = *m_impl;
-    impl.flushSolidBatch();
+    auto& rec = impl.rs();
     if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
 
     float dx = l.end.x - l.start.x;
@@ -1486,6 +3375,8 @@ void Renderer::draw(const Line& l) {
     const float uy =  dx / len;
     const float half = l.thickness * 0.5f;
     const float pad  = 1.f; // skirt width in pixels for edge AA
+    if (impl.rejectDraw({std::min(l.start.x, l.end.x), std::min(l.start.y, l.end.y),
+                         std::abs(dx), std::abs(dy)}, half + pad)) return;
 
     // Six vertices per line endpoint: outer skirt | edge | inner edge twice
     // simplifies to 4 rows along the normal at offsets:
@@ -1493,143 +3384,423 @@ void Renderer::draw(const Line& l) {
     const float offs[4]   = {  half + pad,  half, -half, -half - pad };
     const uint8_t alphas[4] = { 0, 255, 255, 0 };
 
+    const uint16_t base = impl.reserveSolidBatch(currentViewId(), 8);
+    const float    clip = (float)impl.clipNodeId();
     const uint8_t baseA = l.color.a;
-    float vx[8], vy[8]; // 2 endpoints * 4 rows
-    uint32_t vc[8];
     for (int ep = 0; ep < 2; ++ep) {
         const float bx = (ep == 0) ? l.start.x : l.end.x;
         const float by = (ep == 0) ? l.start.y : l.end.y;
         for (int r = 0; r < 4; ++r) {
             float x = bx + ux * offs[r];
             float y = by + uy * offs[r];
-            impl.rotPt(x, y);
-            vx[ep*4 + r] = x;
-            vy[ep*4 + r] = y;
+            impl.xformPt(x, y);
             uint8_t a = (uint8_t)((uint16_t)baseA * (uint16_t)alphas[r] / 255);
-            vc[ep*4 + r] = packColor(Color{l.color.r, l.color.g, l.color.b, a});
+            rec.solidBatchVerts.push_back(
+                {x, y, packColor(Color{l.color.r, l.color.g, l.color.b, a}), clip});
         }
     }
 
-    PosColorVertex verts[8];
-    for (int i = 0; i < 8; ++i) verts[i] = { vx[i], vy[i], vc[i] };
-
     // 3 quads (skirt, body, skirt) between the two endpoints.
-    uint16_t idx[18];
-    int ii = 0;
     for (int r = 0; r < 3; ++r) {
-        const uint16_t v00 = (uint16_t)(0*4 + r);
-        const uint16_t v01 = (uint16_t)(0*4 + r + 1);
-        const uint16_t v10 = (uint16_t)(1*4 + r);
-        const uint16_t v11 = (uint16_t)(1*4 + r + 1);
-        idx[ii++] = v00; idx[ii++] = v01; idx[ii++] = v11;
-        idx[ii++] = v00; idx[ii++] = v11; idx[ii++] = v10;
+        const uint16_t v00 = (uint16_t)(base + 0*4 + r);
+        const uint16_t v01 = (uint16_t)(base + 0*4 + r + 1);
+        const uint16_t v10 = (uint16_t)(base + 1*4 + r);
+        const uint16_t v11 = (uint16_t)(base + 1*4 + r + 1);
+        rec.solidBatchIdx.push_back(v00);
+        rec.solidBatchIdx.push_back(v01);
+        rec.solidBatchIdx.push_back(v11);
+        rec.solidBatchIdx.push_back(v00);
+        rec.solidBatchIdx.push_back(v11);
+        rec.solidBatchIdx.push_back(v10);
     }
+}
 
-    bgfx::TransientVertexBuffer tvb;
-    bgfx::TransientIndexBuffer  tib;
-    if (!bgfx::allocTransientBuffers(&tvb, impl.solidLayout, 8, &tib, 18))
-        return;
-    std::memcpy(tvb.data, verts, sizeof(verts));
-    std::memcpy(tib.data, idx,   sizeof(idx));
-    bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
-    bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                   BGFX_STATE_BLEND_ALPHA);
-    applyScissor(impl);
-    bgfx::submit(currentViewId(), impl.solidProgram);
+namespace {
+// One Line as a quad (v0..v3, unrotated), shared by drawLines and the
+// retained geometry path. False for a degenerate segment.
+bool expandLine(const Line& l, PosColorVertex* out) {
+    float dx = l.end.x - l.start.x;
+    float dy = l.end.y - l.start.y;
+    float len2 = dx*dx + dy*dy;
+    if (len2 < 1e-6f) return false;
+    float len = std::sqrt(len2);
+    float nx = -dy / len * l.thickness * 0.5f;
+    float ny =  dx / len * l.thickness * 0.5f;
+    uint32_t col = packColor(l.color);
+    out[0] = {l.start.x + nx, l.start.y + ny, col};
+    out[1] = {l.start.x - nx, l.start.y - ny, col};
+    out[2] = {l.end.x   - nx, l.end.y   - ny, col};
+    out[3] = {l.end.x   + nx, l.end.y   + ny, col};
+    return true;
 }
+} // anon
 
 void Renderer::drawLines(const Line* lines, size_t count) {
     auto& impl = *m_impl;
-    impl.flushSolidBatch();
+    auto& rec = impl.rs();
     if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
     if (!lines || count == 0) return;
+    // One test for the whole batch: a grid scrolled out of its clip costs
+    // a pass over the endpoints instead of a quad per line.
+    if (rec.scissorTop > 0) {
+        float x0 = lines[0].start.x, y0 = lines[0].start.y, x1 = x0, y1 = y0, half = 0.f;
+        for (size_t i = 0; i < count; ++i) {
+            const Line& l = lines[i];
+            x0 = std::min({x0, l.start.x, l.end.x}); x1 = std::max({x1, l.start.x, l.end.x});
+            y0 = std::min({y0, l.start.y, l.end.y}); y1 = std::max({y1, l.start.y, l.end.y});
+            half = std::max(half, l.thickness * 0.5f);
+        }
+        if (impl.rejectDraw({x0, y0, x1 - x0, y1 - y0}, half)) return;
+    }
+
+    // Every segment is one quad appended to the solid batch; it is flushed
+    // on its own whenever the 16-bit index range would overflow, so large
+    // grids no longer need explicit chunking here.
+    const uint16_t view = currentViewId();
+    const float    clip = (float)impl.clipNodeId();
+    rec.solidBatchVerts.reserve(rec.solidBatchVerts.size() +
+                                 std::min<size_t>(count * 4, Impl::kBatchMaxVerts));
+    rec.solidBatchIdx.reserve(rec.solidBatchIdx.size() +
+                               std::min<size_t>(count * 6, Impl::kBatchMaxVerts * 3 / 2));
+    for (size_t i = 0; i < count; ++i) {
+        PosColorVertex q[4];
+        if (!expandLine(lines[i], q)) continue;
+        for (auto& v : q) { impl.xformPt(v.x, v.y); v.clip = clip; }
+
+        const uint16_t base = impl.reserveSolidBatch(view, 4);
+        rec.solidBatchVerts.insert(rec.solidBatchVerts.end(), q, q + 4);
+        rec.solidBatchIdx.push_back(base + 0);
+        rec.solidBatchIdx.push_back(base + 1);
+        rec.solidBatchIdx.push_back(base + 2);
+        rec.solidBatchIdx.push_back(base + 0);
+        rec.solidBatchIdx.push_back(base + 2);
+        rec.solidBatchIdx.push_back(base + 3);
+    }
+}
+
+// ---------------------------------------------------------------------------
+//  Polylines — a path as one shared-vertex strip in the solid batch. Each
+//  point adds its vertices to the strip's running end, so a corner costs
+//  two vertices (miter) or a small fan (bevel / round) instead of the two
+//  overlapping quads drawLines would give it.
+// ---------------------------------------------------------------------------
+namespace {
 
-    // Worst case all `count` lines are non-degenerate. Cap so we never
-    // exceed the 16-bit index range (max 65535 indices => 10922 quads).
-    constexpr size_t kMaxQuadsPerBatch = 65535 / 6;
-    size_t offset = 0;
-    while (offset < count) {
-        size_t chunk = std::min(count - offset, kMaxQuadsPerBatch);
-
-        // First pass: count non-degenerate lines so we allocate tightly.
-        size_t valid = 0;
-        for (size_t i = 0; i < chunk; ++i) {
-            const Line& l = lines[offset + i];
-            float dx = l.end.x - l.start.x;
-            float dy = l.end.y - l.start.y;
-            if (dx*dx + dy*dy >= 1e-6f) ++valid;
+constexpr float kMiterLimit = 4.f;    // miter length / half thickness
+constexpr int   kRoundJoinMaxSteps = 16;
+
+// Appends a strip to the solid batch a point at a time. Every point
+// reserves its vertices (and room for two more) up front; when that
+// flushes the batch, the strip's trailing pair is queued again at the start
+// of the new one, so a path of any length continues across batches.
+struct StripWriter {
+    Renderer::Impl& impl;
+    Renderer::Impl::RecordState& rec;
+    uint16_t view;
+    float    clip;
+    uint32_t color;
+    size_t   expect = SIZE_MAX;     // batch size after the last point
+    uint16_t tailL = 0, tailR = 0;
+    PosColorVertex tailVL{}, tailVR{};
+
+    void reserve(uint32_t numVerts) {
+        impl.reserveSolidBatch(view, numVerts + 2);
+        if (expect != SIZE_MAX && rec.solidBatchVerts.size() != expect) {
+            tailL = (uint16_t)rec.solidBatchVerts.size();
+            tailR = (uint16_t)(tailL + 1);
+            rec.solidBatchVerts.push_back(tailVL);
+            rec.solidBatchVerts.push_back(tailVR);
         }
-        if (valid == 0) { offset += chunk; continue; }
+    }
+    uint16_t push(float x, float y) {
+        impl.xformPt(x, y);
+        const uint16_t i = (uint16_t)rec.solidBatchVerts.size();
+        rec.solidBatchVerts.push_back({x, y, color, clip});
+        return i;
+    }
+    void tri(uint16_t a, uint16_t b, uint16_t c) {
+        rec.solidBatchIdx.push_back(a);
+        rec.solidBatchIdx.push_back(b);
+        rec.solidBatchIdx.push_back(c);
+    }
+    // Quad from the trailing pair to (l, r), which becomes the new tail.
+    void advance(uint16_t l, uint16_t r) {
+        tri(tailL, tailR, r);
+        tri(tailL, r, l);
+        setTail(l, r);
+    }
+    void setTail(uint16_t l, uint16_t r) {
+        tailL  = l;
+        tailR  = r;
+        tailVL = rec.solidBatchVerts[l];
+        tailVR = rec.solidBatchVerts[r];
+        expect = rec.solidBatchVerts.size();
+    }
+};
 
-        const uint32_t nV = (uint32_t)(valid * 4);
-        const uint32_t nI = (uint32_t)(valid * 6);
-        bgfx::TransientVertexBuffer tvb;
-        bgfx::TransientIndexBuffer  tib;
-        if (!bgfx::allocTransientBuffers(&tvb, impl.solidLayout, nV, &tib, nI))
-            return;
+inline Vec2f normalOf(Vec2f a, Vec2f b, float& len) {
+    const float dx = b.x - a.x, dy = b.y - a.y;
+    len = std::sqrt(dx * dx + dy * dy);
+    return {-dy / len, dx / len};
+}
+
+} // anon
+
+void Renderer::drawPolyline(const Vec2f* points, size_t count, float thickness, Color color,
+                            LineJoin join) {
+    auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
+    if (!points || count < 2 || !(thickness > 0.f)) return;
+
+    // Repeated points have no direction; drop them first.
+    auto& pts = rec.polylineScratch;
+    pts.clear();
+    pts.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        if (pts.empty() || std::abs(points[i].x - pts.back().x) + std::abs(points[i].y - pts.back().y) > 1e-3f)
+            pts.push_back(points[i]);
+    if (pts.size() < 2) return;
+
+    const float half = thickness * 0.5f;
+    if (rec.scissorTop > 0) {
+        float x0 = pts[0].x, y0 = pts[0].y, x1 = x0, y1 = y0;
+        for (const Vec2f& p : pts) {
+            x0 = std::min(x0, p.x); x1 = std::max(x1, p.x);
+            y0 = std::min(y0, p.y); y1 = std::max(y1, p.y);
+        }
+        if (impl.rejectDraw({x0, y0, x1 - x0, y1 - y0}, half * kMiterLimit)) return;
+    }
 
-        auto* verts = reinterpret_cast<PosColorVertex*>(tvb.data);
-        auto* idx   = reinterpret_cast<uint16_t*>(tib.data);
-
-        uint32_t vi = 0, ii = 0;
-        for (size_t i = 0; i < chunk; ++i) {
-            const Line& l = lines[offset + i];
-            float dx = l.end.x - l.start.x;
-            float dy = l.end.y - l.start.y;
-            float len2 = dx*dx + dy*dy;
-            if (len2 < 1e-6f) continue;
-            float len = std::sqrt(len2);
-            float nx = -dy / len * l.thickness * 0.5f;
-            float ny =  dx / len * l.thickness * 0.5f;
-            uint32_t col = packColor(l.color);
-            float x0 = l.start.x + nx, y0 = l.start.y + ny;
-            float x1 = l.start.x - nx, y1 = l.start.y - ny;
-            float x2 = l.end.x   - nx, y2 = l.end.y   - ny;
-            float x3 = l.end.x   + nx, y3 = l.end.y   + ny;
-            impl.rotPt(x0, y0); impl.rotPt(x1, y1);
-            impl.rotPt(x2, y2); impl.rotPt(x3, y3);
-            verts[vi+0] = {x0, y0, col};
-            verts[vi+1] = {x1, y1, col};
-            verts[vi+2] = {x2, y2, col};
-            verts[vi+3] = {x3, y3, col};
-            idx[ii+0] = (uint16_t)(vi+0);
-            idx[ii+1] = (uint16_t)(vi+1);
-            idx[ii+2] = (uint16_t)(vi+2);
-            idx[ii+3] = (uint16_t)(vi+0);
-            idx[ii+4] = (uint16_t)(vi+2);
-            idx[ii+5] = (uint16_t)(vi+3);
-            vi += 4; ii += 6;
+    // A round join's arc is split finely enough to stay within a quarter
+    // pixel of the true circle.
+    const float roundStep = half > 0.25f ? 2.f * std::acos(1.f - 0.25f / half) : 3.14159265f;
+
+    StripWriter w{impl, rec, currentViewId(), (float)impl.clipNodeId(), packColor(color)};
+    float len0 = 0.f;
+    Vec2f n0 = normalOf(pts[0], pts[1], len0);
+    w.reserve(2);
+    w.setTail(w.push(pts[0].x + n0.x * half, pts[0].y + n0.y * half),
+              w.push(pts[0].x - n0.x * half, pts[0].y - n0.y * half));
+
+    for (size_t i = 1; i + 1 < pts.size(); ++i) {
+        const Vec2f p = pts[i];
+        float len1 = 0.f;
+        const Vec2f n1 = normalOf(p, pts[i + 1], len1);
+
+        // Miter direction halves the corner; its length reaches the offset
+        // edges' intersection.
+        Vec2f m{n0.x + n1.x, n0.y + n1.y};
+        const float mLen = std::sqrt(m.x * m.x + m.y * m.y);
+        float miter = 0.f;
+        if (mLen > 1e-4f) {
+            m = {m.x / mLen, m.y / mLen};
+            miter = half / std::max(m.x * n0.x + m.y * n0.y, 1e-4f);
         }
 
-        bgfx::setVertexBuffer(0, &tvb);
-        bgfx::setIndexBuffer(&tib);
-        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                       BGFX_STATE_BLEND_ALPHA);
-        applyScissor(impl);
-        bgfx::submit(currentViewId(), impl.solidProgram);
+        if (join == LineJoin::Miter && mLen > 1e-4f && miter <= half * kMiterLimit) {
+            w.reserve(2);
+            w.advance(w.push(p.x + m.x * miter, p.y + m.y * miter),
+                      w.push(p.x - m.x * miter, p.y - m.y * miter));
+        } else {
+            // Outer side (s along the normals) gets the bevel or arc; the
+            // inner side shares one vertex, pulled in no further than the
+            // shorter segment allows.
+            const float cross = n0.x * n1.y - n0.y * n1.x;
+            const float s     = cross > 0.f ? -1.f : 1.f;
+            const float reach = std::min(miter, std::sqrt(half * half + std::min(len0, len1) * std::min(len0, len1)));
+            const float ix = p.x - s * m.x * reach, iy = p.y - s * m.y * reach;
+
+            int steps = 1;
+            float a0 = 0.f, sweep = 0.f;
+            if (join == LineJoin::Round) {
+                a0    = std::atan2(s * n0.y, s * n0.x);
+                sweep = std::atan2(s * n1.y, s * n1.x) - a0;
+                if (sweep >  3.14159265f) sweep -= 2.f * 3.14159265f;
+                if (sweep < -3.14159265f) sweep += 2.f * 3.14159265f;
+                steps = std::clamp((int)std::ceil(std::abs(sweep) / roundStep), 1, kRoundJoinMaxSteps);
+            }
 
-        offset += chunk;
+            w.reserve(3 + (uint32_t)(steps - 1));
+            const uint16_t in = w.push(ix, iy);
+            const uint16_t o0 = w.push(p.x + s * n0.x * half, p.y + s * n0.y * half);
+            if (s > 0.f) w.advance(o0, in);
+            else         w.advance(in, o0);
+            uint16_t prev = o0;
+            for (int k = 1; k < steps; ++k) {
+                const float a = a0 + sweep * (float)k / (float)steps;
+                const uint16_t v = w.push(p.x + std::cos(a) * half, p.y + std::sin(a) * half);
+                w.tri(in, prev, v);
+                prev = v;
+            }
+            const uint16_t o1 = w.push(p.x + s * n1.x * half, p.y + s * n1.y * half);
+            w.tri(in, prev, o1);
+            if (s > 0.f) w.setTail(o1, in);
+            else         w.setTail(in, o1);
+        }
+        n0   = n1;
+        len0 = len1;
     }
+
+    const Vec2f e = pts.back();
+    w.reserve(2);
+    w.advance(w.push(e.x + n0.x * half, e.y + n0.y * half),
+              w.push(e.x - n0.x * half, e.y - n0.y * half));
 }
 
-void Renderer::drawArc(Vec2f center, float innerR, float outerR,
-                       float startDeg, float endDeg, Color color, int segments) {
+void Renderer::drawFilledEnvelope(const Vec2f* points, size_t count, float baselineY, Color color) {
     auto& impl = *m_impl;
-    impl.flushSolidBatch();
+    auto& rec = impl.rs();
     if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
-    if (color.a == 0) return;
+    if (!points || count < 2) return;
+    if (rec.scissorTop > 0) {
+        float y0 = baselineY, y1 = baselineY;
+        for (size_t i = 0; i < count; ++i) { y0 = std::min(y0, points[i].y); y1 = std::max(y1, points[i].y); }
+        const float x0 = points[0].x, x1 = points[count - 1].x;
+        if (impl.rejectDraw({x0, y0, x1 - x0, y1 - y0})) return;
+    }
 
-    if (innerR > outerR) std::swap(innerR, outerR);
-    if (outerR <= 0.f) return;
-    if (innerR < 0.f) innerR = 0.f;
+    // Left vertex of each pair is on the curve, right on the baseline. A
+    // span that crosses the baseline is split there, so neither half folds
+    // over the other.
+    StripWriter w{impl, rec, currentViewId(), (float)impl.clipNodeId(), packColor(color)};
+    w.reserve(2);
+    w.setTail(w.push(points[0].x, points[0].y), w.push(points[0].x, baselineY));
+    for (size_t i = 1; i < count; ++i) {
+        const Vec2f a = points[i - 1], b = points[i];
+        const float da = a.y - baselineY, db = b.y - baselineY;
+        if ((da < 0.f && db > 0.f) || (da > 0.f && db < 0.f)) {
+            w.reserve(3);
+            const float x = a.x + (b.x - a.x) * (da / (da - db));
+            const uint16_t c = w.push(x, baselineY);
+            w.tri(w.tailL, w.tailR, c);
+            const uint16_t t = w.push(b.x, b.y), u = w.push(b.x, baselineY);
+            w.tri(c, u, t);
+            w.setTail(t, u);
+        } else {
+            w.reserve(2);
+            w.advance(w.push(b.x, b.y), w.push(b.x, baselineY));
+        }
+    }
+}
 
-    int segs = std::max(1, segments);
-    // We emit (segs + 2 angular skirt) slices x 4 radial rows. Cap so
-    // vertex / index counts stay in 16-bit range. Per slice = 4 verts,
-    // 6 quads (between adjacent slices) x 6 indices = 18 indices.
-    constexpr int kMaxSlices = (65535 / 6);
-    if (segs + 2 > kMaxSlices) segs = kMaxSlices - 2;
+// ---------------------------------------------------------------------------
+//  Retained geometry — line quads kept in bgfx dynamic buffers with 32-bit
+//  indices, so a batch of any size is one submit and costs nothing on the
+//  CPU until it changes. Vertices are stored unrotated; drawGeometry folds
+//  the offset and the active rotation into the model transform.
+// ---------------------------------------------------------------------------
+Geometry Renderer::createGeometry() {
+    Impl::CacheLock lock(*m_impl);
+    auto& impl = *m_impl;
+    const bgfx::Caps* caps = bgfx::getCaps();
+    if (!caps || !(caps->supported & BGFX_CAPS_INDEX32)) return Geometry{};
+    impl.ensureLayouts();
+    bgfx::DynamicVertexBufferHandle vb =
+        bgfx::createDynamicVertexBuffer(4, impl.solidLayout, BGFX_BUFFER_ALLOW_RESIZE);
+    bgfx::DynamicIndexBufferHandle ib =
+        bgfx::createDynamicIndexBuffer(6, BGFX_BUFFER_INDEX32 | BGFX_BUFFER_ALLOW_RESIZE);
+    if (!bgfx::isValid(vb) || !bgfx::isValid(ib)) {
+        if (bgfx::isValid(vb)) bgfx::destroy(vb);
+        if (bgfx::isValid(ib)) bgfx::destroy(ib);
+        std::fprintf(stderr, "[UILO] createGeometry: out of dynamic buffers\n");
+        return Geometry{};
+    }
+    Geometry geo;
+    geo.vertexBuffer = vb.idx;
+    geo.indexBuffer  = ib.idx;
+    return geo;
+}
+
+void Renderer::updateGeometry(Geometry& geo, const Line* lines, size_t count) {
+    Impl::CacheLock lock(*m_impl);
+    if (!geo.valid()) return;
+    ++m_impl->contentGeneration;
+    geo.numVertices = 0;
+    geo.numIndices  = 0;
+    if (!lines || count == 0) return;
+
+    geo.bounds = {};
+    std::vector<PosColorVertex> verts;
+    std::vector<uint32_t>       idx;
+    verts.reserve(count * 4);
+    idx.reserve(count * 6);
+    for (size_t i = 0; i < count; ++i) {
+        PosColorVertex q[4];
+        if (!expandLine(lines[i], q)) continue;
+        const uint32_t base = (uint32_t)verts.size();
+        verts.insert(verts.end(), q, q + 4);
+        for (uint32_t k : {0u, 1u, 2u, 0u, 2u, 3u}) idx.push_back(base + k);
+    }
+    if (verts.empty()) return;
+    float x0 = verts[0].x, y0 = verts[0].y, x1 = x0, y1 = y0;
+    for (const auto& v : verts) {
+        x0 = std::min(x0, v.x); x1 = std::max(x1, v.x);
+        y0 = std::min(y0, v.y); y1 = std::max(y1, v.y);
+    }
+    geo.bounds = {x0, y0, x1 - x0, y1 - y0};
+
+    bgfx::update(bgfx::DynamicVertexBufferHandle{ geo.vertexBuffer }, 0,
+                 bgfx::copy(verts.data(), (uint32_t)(verts.size() * sizeof(PosColorVertex))));
+    bgfx::update(bgfx::DynamicIndexBufferHandle{ geo.indexBuffer }, 0,
+                 bgfx::copy(idx.data(), (uint32_t)(idx.size() * sizeof(uint32_t))));
+    geo.numVertices = (uint32_t)verts.size();
+    geo.numIndices  = (uint32_t)idx.size();
+}
+
+void Renderer::drawGeometry(const Geometry& geo, Vec2f offset) {
+    auto& impl = *m_impl;
+    if (!geo.valid() || geo.numIndices == 0) return;
+    if (!bgfx::isValid(impl.solidProgram)) return;
+    if (scissorEmpty(impl) ||
+        impl.rejectDraw({geo.bounds.position + offset, geo.bounds.size})) return;
+    impl.flushBatches();
+
+    // p' = effective * (p + offset), as a row-vector bx matrix.
+    const Transform2D m = impl.rs().effective * Transform2D::translate(offset.x, offset.y);
+    const float model[16] = {
+        m.a,  m.b,  0.f, 0.f,
+        m.c,  m.d,  0.f, 0.f,
+        0.f,  0.f,  1.f, 0.f,
+        m.tx, m.ty, 0.f, 1.f,
+    };
+    bgfx::Encoder* enc = impl.enc();
+    enc->setTransform(model);
+    enc->setVertexBuffer(0, bgfx::DynamicVertexBufferHandle{ geo.vertexBuffer }, 0, geo.numVertices);
+    enc->setIndexBuffer(bgfx::DynamicIndexBufferHandle{ geo.indexBuffer }, 0, geo.numIndices);
+    enc->setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                   impl.blendState(currentViewId()));
+    applyScissor(impl);
+    enc->submit(currentViewId(), impl.solidProgram);
+    ++impl.rs().immediateSubmits;
+    const uint16_t view = currentViewId();
+    impl.hashSceneLiveState(view);
+    impl.hashScene(view, model, sizeof(model));
+    impl.hashSceneValue(view, geo.vertexBuffer);
+    impl.hashSceneValue(view, impl.contentGeneration);
+}
+
+void Renderer::destroyGeometry(Geometry& geo) {
+    Impl::CacheLock lock(*m_impl);
+    if (bgfx::isValid(bgfx::DynamicVertexBufferHandle{ geo.vertexBuffer }))
+        bgfx::destroy(bgfx::DynamicVertexBufferHandle{ geo.vertexBuffer });
+    if (bgfx::isValid(bgfx::DynamicIndexBufferHandle{ geo.indexBuffer }))
+        bgfx::destroy(bgfx::DynamicIndexBufferHandle{ geo.indexBuffer });
+    geo = Geometry{};
+}
+
+namespace {
+// Fills `m` with the ring described on ArcMesh. Interior slice angles come
+// from an angle-addition recurrence (in double, so drift stays far below a
+// pixel at any segment count): six trig calls per arc instead of two per
+// slice.
+void tessellateArc(ArcMesh& m, float innerR, float outerR,
+                   float startDeg, float endDeg, int segs) {
+    m.innerR   = innerR;
+    m.outerR   = outerR;
+    m.startDeg = startDeg;
+    m.endDeg   = endDeg;
+    m.segs     = segs;
 
     const float startRad = startDeg * kDeg2Rad;
     const float endRad   = endDeg   * kDeg2Rad;
@@ -1651,74 +3822,138 @@ void Renderer::drawArc(Vec2f center, float innerR, float outerR,
     const bool solidCore = innerR <= 0.f;
 
     const int sliceCount = segs + 3; // [-1, 0..segs, segs+1]
-    const uint32_t nV = (uint32_t)sliceCount * 4;
     // Quads per slice gap: 3 normally, or 2 if solidCore (skip inner-skirt row).
     const int rowsPerGap = solidCore ? 2 : 3;
-    const uint32_t nI = (uint32_t)(sliceCount - 1) * rowsPerGap * 6;
 
-    bgfx::TransientVertexBuffer tvb;
-    bgfx::TransientIndexBuffer  tib;
-    if (!bgfx::allocTransientBuffers(&tvb, impl.solidLayout, nV, &tib, nI))
-        return;
-
-    auto* verts = reinterpret_cast<PosColorVertex*>(tvb.data);
-    auto* idx   = reinterpret_cast<uint16_t*>(tib.data);
-
-    auto sliceAngle = [&](int s) -> float {
-        // s = 0       -> startSk
-        // s = 1       -> startRad
-        // s = segs+1  -> endRad
-        // s = segs+2  -> endSk
-        if (s == 0)              return startSk;
-        if (s == sliceCount - 1) return endSk;
-        return startRad + step * (float)(s - 1);
-    };
-    auto sliceAngularAlpha = [&](int s) -> uint8_t {
-        return (s == 0 || s == sliceCount - 1) ? 0 : 255;
-    };
+    m.offsets.clear();
+    m.alpha.clear();
+    m.idx.clear();
+    m.offsets.reserve((size_t)sliceCount * 4);
+    m.alpha.reserve((size_t)sliceCount * 4);
+    m.idx.reserve((size_t)(sliceCount - 1) * rowsPerGap * 6);
 
-    for (int s = 0; s < sliceCount; ++s) {
-        const float a   = sliceAngle(s);
-        const float ca  = std::cos(a);
-        const float sa  = std::sin(a);
-        const uint8_t am = sliceAngularAlpha(s);
+    auto emitSlice = [&](float ca, float sa, uint8_t am) {
         for (int r = 0; r < 4; ++r) {
-            float px = center.x + radii[r] * ca;
-            float py = center.y + radii[r] * sa;
-            impl.rotPt(px, py);
+            m.offsets.push_back({ radii[r] * ca, radii[r] * sa });
             // Combine radial-skirt alpha with angular-skirt alpha
             // (multiplicative). Solid-core forces inner skirt alpha to 1.
             uint8_t ra = (solidCore && r == 3) ? 255 : alphaMul[r];
             uint16_t a16 = (uint16_t)ra * (uint16_t)am;
-            uint8_t finalA = (uint8_t)((a16 + 127) / 255);
-            Color cc{color.r, color.g, color.b,
-                     (uint8_t)((uint16_t)color.a * (uint16_t)finalA / 255)};
-            verts[s*4 + r] = { px, py, packColor(cc) };
+            m.alpha.push_back((uint8_t)((a16 + 127) / 255));
         }
+    };
+
+    // s = 0 -> startSk, s = 1..segs+1 -> startRad + step * (s - 1),
+    // s = segs+2 -> endSk.
+    emitSlice(std::cos(startSk), std::sin(startSk), 0);
+    const double cs = std::cos((double)step), ss = std::sin((double)step);
+    double c = std::cos((double)startRad), sn = std::sin((double)startRad);
+    for (int k = 0; k <= segs; ++k) {
+        emitSlice((float)c, (float)sn, 255);
+        const double nc = c * cs - sn * ss;
+        sn = sn * cs + c * ss;
+        c  = nc;
     }
+    emitSlice(std::cos(endSk), std::sin(endSk), 0);
 
-    uint32_t ii = 0;
     for (int s = 0; s < sliceCount - 1; ++s) {
         for (int r = 0; r < rowsPerGap; ++r) {
             const uint16_t v00 = (uint16_t)(s*4 + r);
             const uint16_t v01 = (uint16_t)(s*4 + r + 1);
             const uint16_t v10 = (uint16_t)((s+1)*4 + r);
             const uint16_t v11 = (uint16_t)((s+1)*4 + r + 1);
-            idx[ii++] = v00;
-            idx[ii++] = v01;
-            idx[ii++] = v11;
-            idx[ii++] = v00;
-            idx[ii++] = v11;
-            idx[ii++] = v10;
+            m.idx.push_back(v00);
+            m.idx.push_back(v01);
+            m.idx.push_back(v11);
+            m.idx.push_back(v00);
+            m.idx.push_back(v11);
+            m.idx.push_back(v10);
         }
     }
+}
 
-    bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
-    bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                   BGFX_STATE_BLEND_ALPHA);
-    applyScissor(impl);
-    bgfx::submit(currentViewId(), impl.solidProgram);
+uint64_t arcMeshKey(float innerR, float outerR, float startDeg, float endDeg, int segs) {
+    uint32_t words[5];
+    std::memcpy(&words[0], &innerR,   4);
+    std::memcpy(&words[1], &outerR,   4);
+    std::memcpy(&words[2], &startDeg, 4);
+    std::memcpy(&words[3], &endDeg,   4);
+    words[4] = (uint32_t)segs;
+    uint64_t h = 1469598103934665603ull;   // FNV-1a over the words
+    for (uint32_t w : words) { h ^= w; h *= 1099511628211ull; }
+    return h;
+}
+} // anon
+
+const ArcMesh& Renderer::Impl::getArcMesh(float innerR, float outerR,
+                                          float startDeg, float endDeg, int segs) {
+    ArcMesh& m = arcMeshes[arcMeshKey(innerR, outerR, startDeg, endDeg, segs)];
+    if (m.segs == segs && m.innerR == innerR && m.outerR == outerR &&
+        m.startDeg == startDeg && m.endDeg == endDeg && !m.idx.empty()) {
+        ++arcMeshHits;
+    } else {
+        // New entry, or a colliding key: rebuild in place.
+        ++arcMeshMisses;
+        tessellateArc(m, innerR, outerR, startDeg, endDeg, segs);
+    }
+    m.lastUsed = frameIndex;
+    return m;
+}
+
+void Renderer::Impl::trimArcMeshes() {
+    if (arcMeshes.size() <= kArcMeshCacheSoftMax) return;
+    for (auto it = arcMeshes.begin(); it != arcMeshes.end();) {
+        if (frameIndex - it->second.lastUsed > kArcMeshMaxAge) it = arcMeshes.erase(it);
+        else ++it;
+    }
+}
+
+void Renderer::drawArc(Vec2f center, float innerR, float outerR,
+                       float startDeg, float endDeg, Color color, int segments,
+                       bool cacheTessellation) {
+    auto& impl = *m_impl;
+    auto& rec = impl.rs();
+    if (!bgfx::isValid(impl.solidProgram) || scissorEmpty(impl)) return;
+    if (color.a == 0) return;
+
+    if (innerR > outerR) std::swap(innerR, outerR);
+    if (outerR <= 0.f) return;
+    if (innerR < 0.f) innerR = 0.f;
+    // The whole disc, sweep aside; the AA skirt reaches a pixel out.
+    if (impl.rejectDraw({center.x - outerR, center.y - outerR, outerR * 2.f, outerR * 2.f}, 1.f))
+        return;
+
+    int segs = std::max(1, segments);
+    // We emit (segs + 3) slices x 4 radial rows into the solid batch. Cap
+    // so a single arc always fits in one batch's 16-bit vertex range.
+    constexpr int kMaxSlices = (int)(Impl::kBatchMaxVerts / 4);
+    if (segs + 3 > kMaxSlices) segs = kMaxSlices - 3;
+
+    // Held through the emit: a colliding key rebuilds the cached mesh in place.
+    Impl::CacheLock lock(impl);
+    const ArcMesh* mesh = &rec.arcScratch;
+    if (cacheTessellation)
+        mesh = &impl.getArcMesh(innerR, outerR, startDeg, endDeg, segs);
+    else
+        tessellateArc(rec.arcScratch, innerR, outerR, startDeg, endDeg, segs);
+
+    const uint32_t numVerts = (uint32_t)mesh->offsets.size();
+    const uint16_t base = impl.reserveSolidBatch(currentViewId(), numVerts);
+    rec.solidBatchVerts.reserve(rec.solidBatchVerts.size() + numVerts);
+    rec.solidBatchIdx.reserve(rec.solidBatchIdx.size() + mesh->idx.size());
+
+    // Only two colors occur: the skirt alpha is either 0 or 255.
+    const uint32_t solid = packColor(color);
+    const uint32_t clear = packColor(Color{color.r, color.g, color.b, 0});
+    const float    clip  = (float)impl.clipNodeId();
+    for (uint32_t v = 0; v < numVerts; ++v) {
+        float px = center.x + mesh->offsets[v].x;
+        float py = center.y + mesh->offsets[v].y;
+        impl.xformPt(px, py);
+        rec.solidBatchVerts.push_back({ px, py, mesh->alpha[v] ? solid : clear, clip });
+    }
+    for (uint16_t i : mesh->idx)
+        rec.solidBatchIdx.push_back((uint16_t)(base + i));
 }
 
 } // namespace uilo
@@ -1,14 +1,17 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../utils/Math.hpp"
 #include "../utils/Color.hpp"
 #include "../utils/Alignment.hpp"
 #include "../utils/Material.hpp"
+#include "../utils/Profiler.hpp"
 #include "Shapes.hpp"
 
 // Forward-declare SDL and bgfx types so elements never need to include those
@@ -18,6 +21,8 @@ namespace bgfx { struct FrameBufferHandle; }
 
 namespace uilo {
 
+class JobPool;
+
 // ---- Cursor types --------------------------------------------------------
 enum class CursorType {
     Arrow,
@@ -35,9 +40,46 @@ struct Texture {
     uint16_t handle = UINT16_MAX;   // bgfx::TextureHandle.idx
     uint16_t width  = 0;
     uint16_t height = 0;
+    // Region of `handle` holding the image: all of it, unless the image
+    // was packed into the shared image atlas. drawImage maps into it.
+    Rectf    uv     = {{0.f, 0.f}, {1.f, 1.f}};
     bool valid() const { return handle != UINT16_MAX; }
 };
 
+// Icons bundled in assets/EmbeddedIcons.hpp, for loadEmbeddedIcon.
+enum class EmbeddedIcon : uint8_t {
+    Folder,
+    File,
+};
+
+// How loadTexture stores an image. A nonzero max size box-filters it down
+// to fit (aspect kept, never enlarged) so a thumbnail costs thumbnail
+// memory; mipmaps adds a full box-filtered mip chain (+1/3 memory) for
+// clean minification when it's drawn smaller still.
+struct TextureLoadOptions {
+    uint16_t maxWidth  = 0;     // 0 = unconstrained
+    uint16_t maxHeight = 0;
+    bool     mipmaps   = false;
+};
+
+// Per-pixel style for drawWaveform; same order as WaveformStyle.
+enum class PeakStyle : uint8_t {
+    Bars,
+    Line,
+    Filled,
+};
+
+// Retained line geometry in GPU-resident dynamic buffers; see
+// Renderer::createGeometry. Owned by the caller, pair with destroyGeometry.
+struct Geometry {
+    uint16_t vertexBuffer = UINT16_MAX;  // bgfx::DynamicVertexBufferHandle.idx
+    uint16_t indexBuffer  = UINT16_MAX;  // bgfx::DynamicIndexBufferHandle.idx
+    uint32_t numVertices  = 0;
+    uint32_t numIndices   = 0;
+    Rectf    bounds;                     // of the line quads, before drawGeometry's offset
+    bool valid() const { return vertexBuffer != UINT16_MAX; }
+};
+
 struct Font {
     uint32_t id = UINT32_MAX;       // index into Renderer's font table
     bool valid() const { return id != UINT32_MAX; }
@@ -51,6 +93,12 @@ struct TextMetrics {
     float lineHeight() const { return ascent + descent + lineGap; }
 };
 
+// CPU and GPU time one pass (a group of bgfx views) took last frame.
+struct RendererPassTiming {
+    double cpuMs = 0.0;
+    double gpuMs = 0.0;
+};
+
 // Snapshot of bgfx renderer counters for the previous frame. Useful for
 // HUD overlays and perf instrumentation.
 struct RendererStats {
@@ -58,6 +106,197 @@ struct RendererStats {
     uint32_t numVertices = 0;
     double   cpuTimeMs   = 0.0;
     double   gpuTimeMs   = 0.0;
+
+    // Shared glyph atlas: live pages, their GPU bytes, the fraction of page
+    // area handed out to glyphs, and total page evictions since init.
+    uint32_t glyphAtlasPages     = 0;
+    uint64_t glyphAtlasBytes     = 0;
+    float    glyphAtlasOccupancy = 0.f;
+    uint32_t glyphAtlasEvictions = 0;
+
+    // Shaped-run cache used by measureText / charPositions / drawText:
+    // cached runs, and cumulative lookups served from / missing the cache.
+    uint32_t textRuns      = 0;
+    uint64_t textRunHits   = 0;
+    uint64_t textRunMisses = 0;
+
+    // Cached arc tessellations (drawArc with cacheTessellation), same shape.
+    uint32_t arcMeshes      = 0;
+    uint64_t arcMeshHits    = 0;
+    uint64_t arcMeshMisses  = 0;
+
+    // Elements containers skipped because they lay outside the viewport.
+    uint32_t culledElements = 0;
+    // Draw calls dropped on the CPU because they lay wholly outside the
+    // scissor (drawLines counts once per batch).
+    uint32_t rejectedDraws  = 0;
+    // Indexed-clip nodes in the clip table (0 with indexed clips off).
+    uint32_t clipNodes      = 0;
+
+    // loadTextureAsync requests still decoding or waiting for upload.
+    uint32_t texturesLoading = 0;
+
+    // loadTexture's cache: entries (failed loads included), GPU bytes they
+    // hold, and budget evictions since init.
+    uint32_t textures         = 0;
+    uint64_t textureBytes     = 0;
+    uint64_t textureEvictions = 0;
+    // Pages of the shared image atlas (counted in textureBytes).
+    uint32_t imageAtlasPages  = 0;
+
+    // Glass blur ladder last frame: rects it ran over (0 = no glass, 1 with
+    // full coverage = full-screen pass) and the fraction of the window they
+    // cover.
+    uint32_t blurRegions  = 0;
+    float    blurCoverage = 0.f;
+    // Dual-Kawase levels run last frame for Material::Blur (0 = none).
+    uint32_t blurLadderLevels = 0;
+    // Nothing under the glass changed, so last frame reused the previous
+    // blur instead of running the passes (the stats above describe it).
+    bool     blurReused = false;
+    // Deferred glass panels and the draws they were merged into.
+    uint32_t glassPanels = 0;
+    uint32_t glassDraws  = 0;
+
+    // Framebuffer pool: idle targets kept for reuse, and real GPU
+    // allocations it had to make last frame (0 in steady state).
+    uint32_t frameBuffersPooled = 0;
+    uint32_t frameBufferAllocs  = 0;
+
+    // Frame-graph passes kept last frame (scene included), and whether the
+    // scene was drawn straight into the backbuffer with no composite.
+    uint32_t framePasses = 0;
+    bool     sceneDirect = false;
+
+    // Slices recordParallel() recorded last frame (0 = all on one thread).
+    uint32_t recordSlices = 0;
+
+    // Frame pacing over the last 120 presents: mean and standard deviation
+    // of present-to-present time, and the estimated CPU cost of a frame.
+    // inputLatencyMs is input sample (waitForInputDeadline) to present,
+    // smoothed; 0 when the host never calls waitForInputDeadline.
+    double   frameTimeMeanMs   = 0.0;
+    double   frameTimeStdDevMs = 0.0;
+    double   frameCostMs       = 0.0;
+    double   inputLatencyMs    = 0.0;
+
+    // Per-pass share of cpuTimeMs / gpuTimeMs, from bgfx's profiler; all
+    // zero unless Renderer::setPassTimings(true). Slices of
+    // recordParallel() count with the scene / glass child pass, and every
+    // framebuffer and layer view goes into frameBufferPass.
+    RendererPassTiming scenePass;
+    RendererPassTiming blurHPass;
+    RendererPassTiming blurVPass;
+    RendererPassTiming blurLadderPass;
+    RendererPassTiming glassBgPass;
+    RendererPassTiming glassChildPass;
+    RendererPassTiming compositePass;
+    RendererPassTiming frameBufferPass;
+
+    // User draws last frame: submits made by flushing a batch, and draws
+    // that went to bgfx on their own (textures, waveforms, drawFrameBuffer,
+    // cached geometry). Batch flushes by cause: pipeline state changed
+    // (view, clip, atlas, program, transform), the batch was full, a draw
+    // for another batch arrived, or an explicit flush (an unbatched draw,
+    // a target or draw-list boundary, end of frame).
+    uint32_t batchedSubmits   = 0;
+    uint32_t immediateSubmits = 0;
+    uint32_t flushesState     = 0;
+    uint32_t flushesCapacity  = 0;
+    uint32_t flushesSwitch    = 0;
+    uint32_t flushesExplicit  = 0;
+
+    // Transient vertex / index buffer bytes: used last frame, the most any
+    // frame has used since init, and the per-frame capacity.
+    uint32_t transientVbUsed = 0;
+    uint32_t transientIbUsed = 0;
+    uint32_t transientVbPeak = 0;
+    uint32_t transientIbPeak = 0;
+    uint32_t transientVbSize = 0;
+    uint32_t transientIbSize = 0;
+    // UILO's own share of transientVbUsed / transientIbUsed last frame
+    // (instance data counts as vertex bytes); attached, the rest is the
+    // host's. Then the bytes batches wrote to the embedded geometry arena
+    // instead, and draws dropped for want of geometry space: the shared
+    // pool, or EmbeddedBudget::transientBytes, had no room left.
+    uint32_t uiloTransientVbBytes = 0;
+    uint32_t uiloTransientIbBytes = 0;
+    uint32_t arenaVbBytes         = 0;
+    uint32_t arenaIbBytes         = 0;
+    uint32_t budgetDroppedDraws   = 0;
+};
+
+// One baked font face in RendererMemoryStats.
+struct RendererFaceMemory {
+    std::string font;              // loadFont path ("" = the embedded font)
+    int         pixelHeight = 0;
+    bool        sdf         = false;
+    uint32_t    glyphs      = 0;
+    uint64_t    atlasBytes  = 0;   // its live glyphs' share of the glyph atlas
+    uint64_t    tableBytes  = 0;   // glyph and advance tables
+};
+
+// Approximate memory the renderer holds, by subsystem. GPU figures are
+// computed from the sizes and formats UILO asked for; gpuTextureBytes and
+// gpuTargetBytes are bgfx's own totals where the backend reports them.
+struct RendererMemoryStats {
+    // TTF files, once per file however many records and faces share them.
+    // fontFileBytes are heap copies (files that couldn't be mapped);
+    // fontMappedBytes are mapped views, paged in from the file cache on
+    // demand and so left out of totalBytes(). The embedded font lives in
+    // static data and counts in neither.
+    uint64_t fontFileBytes   = 0;
+    uint64_t fontMappedBytes = 0;
+    std::vector<RendererFaceMemory> faces;
+
+    uint64_t glyphAtlasBytes      = 0;   // every page, however full
+    uint64_t glyphShadowBytes     = 0;   // CPU copies the pages are uploaded from
+    uint64_t textureBytes         = 0;   // loadTexture's cache, image atlas included
+    uint64_t imageAtlasBytes      = 0;
+    uint64_t pipelineTargetBytes  = 0;   // scene, blur and ladder (and headless output)
+    uint64_t frameBufferBytes     = 0;   // live createFrameBuffer targets
+    uint64_t frameBufferPoolBytes = 0;   // released targets idling in the pool
+    uint64_t geometryArenaBytes   = 0;   // attach()'s EmbeddedBudget arena
+
+    uint64_t gpuTextureBytes = 0;
+    uint64_t gpuTargetBytes  = 0;
+
+    uint64_t totalBytes() const {
+        uint64_t faceTables = 0;
+        for (const auto& f : faces) faceTables += f.tableBytes;
+        return fontFileBytes + faceTables + glyphAtlasBytes + glyphShadowBytes + textureBytes
+             + pipelineTargetBytes + frameBufferBytes + frameBufferPoolBytes + geometryArenaBytes;
+    }
+};
+
+// Where init() spent its time, and how long after init() began the first
+// endFrame() returned. Milliseconds; 0 until that step has run.
+struct RendererStartupStats {
+    float windowMs     = 0.f;   // SDL_Init and the window
+    float contextMs    = 0.f;   // bgfx::init
+    float resourcesMs  = 0.f;   // layouts, programs, uniforms, clip table
+    float firstFrameMs = 0.f;
+};
+
+// What an attach()ed renderer may take from the host's frame. The arena
+// is a vertex buffer per vertex format (shapes, textured quads) and one
+// index buffer, created at attach() and refilled every frame, so batched
+// shapes, text and images stay out of bgfx's shared transient pool; a
+// batch that doesn't fit falls back to the pool. transientBytes caps what
+// UILO takes from the pool per frame (arena overflow, glass, blur and
+// composite quads, instanced shapes): past it draws are dropped and
+// counted in RendererStats::budgetDroppedDraws rather than leaving the
+// host short. Zero means no arena / no cap.
+struct EmbeddedBudget {
+    uint32_t arenaVertices  = 0;
+    uint32_t arenaIndices   = 0;
+    uint32_t transientBytes = 0;
+};
+
+// Colour format of a createFrameBuffer / acquireFrameBuffer target.
+enum class FrameBufferFormat : uint8_t {
+    BGRA8,
+    RGBA16F,
 };
 
 // ---- Framebuffer handle (opaque wrapper around bgfx framebuffer) ---------
@@ -65,9 +304,36 @@ struct FrameBuffer {
     uint16_t handle  = UINT16_MAX;
     uint16_t viewId  = UINT16_MAX;
     Vec2u    size    = {0u, 0u};
+    // Size of the pooled target; `size` is drawn into its top-left.
+    Vec2u    alloc   = {0u, 0u};
+    FrameBufferFormat format = FrameBufferFormat::BGRA8;
     bool     valid() const { return handle != UINT16_MAX; }
 };
 
+// ---- Retained draw list ----------------------------------------------------
+// Batched geometry (shapes + text) recorded between Renderer::beginDrawList
+// and endDrawList, replayable on later frames without re-running the code
+// that emitted it. Owned by the caller (Container keeps one per subtree);
+// contents are opaque and live in RendererImpl.hpp.
+class DrawList {
+public:
+    DrawList();
+    ~DrawList();
+    DrawList(DrawList&&) noexcept;
+    DrawList& operator=(DrawList&&) noexcept;
+    DrawList(const DrawList&)            = delete;
+    DrawList& operator=(const DrawList&) = delete;
+
+    // True once a recording finished without hitting an unrecordable draw.
+    bool valid() const;
+    void reset();
+
+    struct Data;
+private:
+    std::unique_ptr<Data> m_data;
+    friend class Renderer;
+};
+
 // ---- Renderer ------------------------------------------------------------
 class Renderer {
 public:
@@ -83,11 +349,45 @@ public:
               uint8_t msaa = 4);
     // Embedded mode: attach to a host that already owns the SDL window + bgfx
     // context. Skips SDL/bgfx/window creation and never calls bgfx::frame /
-    // reset / shutdown. UILO's pipeline views are rebased to start at baseView,
-    // and the scene clears transparent so the UI composites over the host image.
-    bool attach(SDL_Window* hostWindow, uint16_t baseView);
+    // reset / shutdown. UILO's views (framebuffer pool, then the pipeline) are
+    // rebased to start at baseView, and the scene clears transparent so the UI
+    // composites over the host image. `budget` bounds the geometry UILO
+    // allocates per frame (see EmbeddedBudget).
+    bool attach(SDL_Window* hostWindow, uint16_t baseView, const EmbeddedBudget& budget = {});
+    // Attached: glass samples `blurred`, the host's own blurred copy of
+    // its scene (uv = the part covering the window), instead of UILO
+    // blurring the scene and running its ladder. Material::Blur radii
+    // then come from the host's blur. An invalid Texture goes back to
+    // UILO's passes. The handle stays the host's; keep it alive while set.
+    void setHostBackdrop(const Texture& blurred);
+    // Second window on `primary`'s bgfx context: opens its own SDL window
+    // and draws into a swapchain framebuffer on it, sharing the primary's
+    // programs, textures, atlases, fonts and text caches (nothing is loaded
+    // or baked twice). Record it with beginFrame()/endFrame() as usual;
+    // the primary's endFrame() presents both. No MSAA, and vsync follows
+    // the primary. Needs a backend with swapchain support; view ids come
+    // from a block at the top of the range. Shut it down before the primary.
+    bool initShared(Renderer& primary, uint32_t width, uint32_t height,
+                    const std::string& title = "UILO");
+    bool isShared() const { return m_sharedContext; }
+    // Headless mode: no window or surface. Frames render into an offscreen
+    // target of width x height, SDL events still pump, and requestReadback()
+    // copies frames to the CPU. Unless UILO_RENDERER says otherwise, the
+    // first compiled backend that runs without a display is used (Vulkan,
+    // Metal, D3D12, D3D11; Vulkan on lavapipe or SwiftShader runs on the
+    // CPU), else noop, which draws and reads back nothing. No MSAA or vsync.
+    bool initHeadless(uint32_t width, uint32_t height);
+    bool isHeadless() const { return m_headless; }
     bool ownsContext() const { return m_ownsContext; } // false in attach mode
     void shutdown();
+    // Opt-in, before init(): bgfx's backend runs on a thread of its own
+    // that loops bgfx::renderFrame(), so endFrame() only hands the frame
+    // over and the next frame's update and layout overlap the driver work
+    // for this one. pipelineFrames (1 or 2) is how many frames the
+    // swapchain may queue ahead: 2 keeps the GPU fed under uneven frame
+    // times at the cost of a frame of input latency. Ignored by attach().
+    void setRenderThread(bool enabled, uint8_t pipelineFrames = 1);
+    bool hasRenderThread() const;
 
     void beginFrame();
     void endFrame();
@@ -101,11 +401,79 @@ public:
     // With vsync also on, the effective rate is min(vsync, this limit).
     void   setFramerateLimit(float fps);
     float  getFramerateLimit() const;
+    // Late input sampling, for use with a framerate limit. endFrame() stops
+    // waiting for the deadline; instead waitForInputDeadline(), which the
+    // host calls right before polling events, sleeps until the deadline
+    // less the estimated frame cost. Input is then as fresh as it can be
+    // when the frame presents. Best with vsync off, whose blocking present
+    // the pacer can't see past.
+    void   setLateInputSampling(bool enabled);
+    bool   getLateInputSampling() const;
+    // Call before polling events each frame. Waits only with late input
+    // sampling on; always marks when input was sampled, for inputLatencyMs.
+    void   waitForInputDeadline();
     SDL_Window* sdlWindow() const { return m_window; }
 
+    // Headless only: copy the frame being recorded to the CPU. done runs
+    // inside a later endFrame(), once the GPU has finished it, with tightly
+    // packed BGRA8 rows, top row first. Several may be in flight. Returns
+    // false, and done never runs, when the backend can't read back.
+    using ReadbackFn = std::function<void(const uint8_t* bgra, uint32_t width, uint32_t height)>;
+    bool   requestReadback(ReadbackFn done);
+
+    // True when the last completed frame drew a time-animated material
+    // (Holographic / Liquid / Shimmer / Aurora / Ripple / Hover), i.e. the
+    // next frame would look different even if nothing else changed. Used by
+    // UILO's on-demand mode to keep presenting while such content is up.
+    bool   isAnimating() const;
+
+    // Per-pass timings in RendererStats (bgfx's profiler, which costs a
+    // little per view). Off by default.
+    void   setPassTimings(bool enabled);
+    bool   getPassTimings() const;
+
+    // Rect / RoundedRect / Circle go through an instanced batch (one
+    // instance per shape, expanded on the GPU) when the backend supports
+    // instancing. Off forces the CPU-expanded solid batch, e.g. for
+    // before/after comparisons. getInstancedShapes() is true only when
+    // enabled and supported.
+    void   setInstancedShapes(bool enabled);
+    bool   getInstancedShapes() const;
+
+    // Indexed clips: every pushRoundClip becomes a node in a per-renderer
+    // clip table (texture) and batched shapes, text and images carry the
+    // node they're clipped by, so nested rounded clips all apply (up to 16
+    // deep) and clip changes no longer split batches. Off keeps the clip
+    // uniforms, which see only the innermost two rounded clips. Takes
+    // effect at the next beginFrame. getIndexedClips() is true only when
+    // enabled and supported (RGBA32F textures).
+    void   setIndexedClips(bool enabled);
+    bool   getIndexedClips() const;
+
+    // Analytic edge AA (default on): rect edges that fall between pixels
+    // get a one-pixel coverage ramp in the shaders / solid batch, the way
+    // rounded rects, circles, lines and arcs already do. Pixel-aligned
+    // rects are unchanged. With it on, init(..., msaa = 1) draws smooth
+    // UI without MSAA's fill and framebuffer cost.
+    void   setAnalyticAA(bool enabled);
+    bool   getAnalyticAA() const;
+
     // Returns counters from bgfx::getStats() for the most recently
     // submitted frame. Cheap; safe to call once per frame.
     RendererStats getStats() const;
+    // Walks the font, texture and framebuffer caches; cheap enough for an
+    // overlay refreshing a few times a second, not for every frame.
+    RendererMemoryStats getMemoryStats() const;
+    RendererStartupStats getStartupStats() const;
+    // Containers report each child skipped by viewport culling here; the
+    // frame's total shows up as RendererStats::culledElements.
+    void          countCulled(uint32_t n = 1);
+#if UILO_PROFILER
+    // Running totals on the calling thread's recording this frame, which
+    // Element::paint() takes the difference of: bgfx submits issued and
+    // vertices queued (an instanced shape counts four).
+    void          getProfileCounters(uint32_t& submits, uint32_t& vertices) const;
+#endif
 
     // ---- Cursor -----------------------------------------------------------
     void setCursor(CursorType type);
@@ -117,29 +485,104 @@ public:
     void draw(const Triangle&    triangle);
     void draw(const Line&        line);
 
+    // Bakes a linear / radial ramp (stops sorted by offset; a row is 256
+    // texels) into the gradient table for Rect / RoundedRect::ramp;
+    // identical ramps share a row. Invalid without instanced shapes, or when
+    // every row was baked this frame; the shape then draws its corner colors.
+    GradientRamp bakeGradientRamp(const GradientRampStop* stops, size_t count,
+                                  bool radial, const float geom[4]);
+
     // Batched line draw: emits all `count` lines in a single transient
     // vertex buffer / submit. Far cheaper than calling draw(Line) in a
     // loop when rendering many primitives (e.g. waveforms, grids).
     void drawLines(const Line* lines, size_t count);
 
+    // Connected line through `count` points as one strip: consecutive
+    // segments share their vertices and the corners are joined, so there is
+    // no overlap at the joints (translucent lines blend evenly) and about
+    // half the vertices of the same path through drawLines. Butt ends.
+    void drawPolyline(const Vec2f* points, size_t count, float thickness, Color color,
+                      LineJoin join = LineJoin::Miter);
+    // Fills between a polyline (points in increasing x) and the horizontal
+    // line y = baselineY, as one strip that may cross the baseline.
+    void drawFilledEnvelope(const Vec2f* points, size_t count, float baselineY, Color color);
+
+    // Retained alternative to drawLines for large line sets that rarely
+    // change (grids, automation curves, waveform lanes). updateGeometry
+    // expands the lines into GPU dynamic buffers, which grow as needed and
+    // aren't bound by the per-frame transient space; drawGeometry then
+    // submits them as-is, translated by `offset`, for one draw call and no
+    // per-frame CPU work. createGeometry returns an invalid Geometry when
+    // the backend lacks 32-bit indices; callers then fall back to drawLines.
+    // drawGeometry isn't recordable, so it taints an enclosing draw list.
+    Geometry createGeometry();
+    void     updateGeometry(Geometry& geo, const Line* lines, size_t count);
+    void     drawGeometry(const Geometry& geo, Vec2f offset = {0.f, 0.f});
+    void     destroyGeometry(Geometry& geo);
+
     // Filled annular arc (gap-free triangle strip between innerR/outerR).
     // Angles in degrees, cartesian convention (0=+x, sweep increases CCW;
     // pass endDeg < startDeg for a clockwise sweep). Caller chooses
     // tessellation density via `segments` (clamped to >= 1).
+    // `cacheTessellation` keeps the tessellated ring (relative to its
+    // center) keyed by radii, angles and segments, so redrawing the same
+    // arc skips the vertex math; use it for arcs that stay put across
+    // frames (a knob's track), not ones whose sweep animates.
     void drawArc(Vec2f center, float innerR, float outerR,
-                 float startDeg, float endDeg, Color color, int segments);
+                 float startDeg, float endDeg, Color color, int segments,
+                 bool cacheTessellation = false);
 
     // ---- Texture / image --------------------------------------------------
-    // Load an image file (png/jpg/etc.). Cached by path; safe to call
-    // multiple times. Returns invalid Texture on failure.
-    Texture loadTexture(const std::string& path);
+    // Load an image file (png/jpg/etc.). Cached by path and options; safe
+    // to call multiple times. Returns invalid Texture on failure.
+    Texture loadTexture(const std::string& path, const TextureLoadOptions& opts = {});
+    // Non-blocking loadTexture: the file is decoded on a background thread
+    // and uploaded during a later beginFrame. Returns the cached texture
+    // once uploaded and an invalid Texture until then (or on failure);
+    // call again each frame. Shares loadTexture's cache, so each path is
+    // decoded once however many callers ask.
+    Texture loadTextureAsync(const std::string& path, const TextureLoadOptions& opts = {});
+    // True while an async load of `path` is queued, decoding or awaiting
+    // upload.
+    bool    isTextureLoading(const std::string& path, const TextureLoadOptions& opts = {}) const;
+    bool    isTextureLoading() const;     // any async load outstanding
+    // Decoded images are waiting for the next beginFrame to upload them.
+    bool    hasTextureUploads() const;
+    // loadTexture from an encoded image in memory, cached under `key`
+    // (which must not collide with a file path).
+    Texture loadTextureFromMemory(const std::string& key, const uint8_t* data, size_t size,
+                                  const TextureLoadOptions& opts = {});
+    // One of the bundled icons, downsampled to fit sizePx x sizePx; small
+    // sizes land in the image atlas, so a toolbar of them batches.
+    Texture loadEmbeddedIcon(EmbeddedIcon icon, uint16_t sizePx);
+
+    // Images up to this many px on each side (after any TextureLoadOptions
+    // downsampling, and without mipmaps) are packed into shared atlas pages
+    // so neighbouring drawImage calls batch into one submit. 0 turns the
+    // atlas off; default 128. Affects loads made afterwards.
+    void     setImageAtlasMaxSize(uint16_t px);
+    uint16_t getImageAtlasMaxSize() const;
+
+    // GPU memory budget for loadTexture's cache, in bytes (0, the default,
+    // is unlimited). While over it, beginFrame destroys cached textures
+    // nobody retains, least recently loaded first, so a Texture kept from
+    // loadTexture is only safe to draw while its path is retained.
+    void     setTextureBudget(uint64_t bytes);
+    uint64_t getTextureBudget() const;
+    // Reference-count a cached path + options (Image does this for its texture).
+    // Retaining a path that isn't cached yet is a no-op.
+    void    retainTexture(const std::string& path, const TextureLoadOptions& opts = {});
+    void    releaseTexture(const std::string& path, const TextureLoadOptions& opts = {});
+    // Invalidates `tex`. A cached texture retained more than once only
+    // loses a reference; the GPU handle is destroyed with the last one.
     void    destroyTexture(Texture& tex);
 
     // Decode an image file to tightly-packed RGBA8 bytes without creating a
     // GPU texture (row-major, top-left origin). Not cached. Returns false
-    // and leaves the outputs untouched on failure.
-    bool loadImagePixels(const std::string& path, std::vector<uint8_t>& outRgba,
-                         uint32_t& outWidth, uint32_t& outHeight);
+    // and leaves the outputs untouched on failure. Touches no renderer
+    // state, so it may run on any thread.
+    static bool loadImagePixels(const std::string& path, std::vector<uint8_t>& outRgba,
+                                uint32_t& outWidth, uint32_t& outHeight);
 
     // Create an empty *mutable* RGBA8 texture. Unlike loadTexture's cached
     // textures (immutable: created with initial contents), these accept
@@ -148,11 +591,32 @@ public:
 
     // Replace the full contents of a texture made by createTexture with
     // width*height*4 RGBA8 bytes. No-op on invalid texture / null pixels.
+    // An image packed into the shared atlas rewrites only its own rect.
     void updateTexture(const Texture& tex, const uint8_t* rgba);
 
-    // Draw a textured quad in screen space. uv defaults to the whole image.
-    // If `clipEllipse` is true, alpha is masked to the inscribed ellipse of
-    // the destination rectangle.
+    // Create a mutable RG32F peak texture of `columns` x `lanes` {min, max}
+    // texels for drawWaveform. Returns an invalid Texture when the backend
+    // can't sample RG32F or the size exceeds its texture limit, so callers
+    // can fall back to drawLines. Pair with destroyTexture.
+    Texture createPeakTexture(uint16_t columns, uint16_t lanes);
+
+    // Replace the contents of a peak texture with lanes*columns {min, max}
+    // float pairs, lane-major (the layout Waveform keeps its peaks in).
+    void updatePeakTexture(const Texture& tex, const float* minMax);
+
+    // Draw row `lane` of a peak texture as a single quad covering `dst`;
+    // the fragment shader rasterises the style per pixel, so the CPU cost
+    // doesn't depend on the column count. Peaks are scaled by `gain` and
+    // clamped to the strip. Returns false (nothing drawn) when the
+    // waveform program or texture is unavailable.
+    bool drawWaveform(const Rectf& dst, const Texture& peaks, uint16_t lane,
+                      PeakStyle style, Color color, float gain, float thickness);
+
+    // Draw a textured quad in screen space. uv defaults to the whole image
+    // (it is relative to tex.uv). If `clipEllipse` is true, alpha is masked
+    // to the inscribed ellipse of the destination rectangle. Unclipped
+    // draws go through a batch: consecutive ones sampling the same texture
+    // or atlas page under the same clip share one submit.
     void drawImage(const Rectf& dst, const Texture& tex,
                    Color tint = Color::White,
                    Rectf uv   = {{0.f, 0.f}, {1.f, 1.f}},
@@ -171,6 +635,13 @@ public:
     void drawGlass(const Rectf& dst, const Material& mat,
                    Color baseColor = Color::Transparent);
 
+    // Deepest dual-Kawase level Material::Blur may use (each level doubles
+    // the reachable radius, up to 5 ≈ 128 px). The ladder runs only as deep
+    // as the frame's largest blurRadius needs; below 2 it is disabled and
+    // Blur falls back to the Gaussian backdrop every glass kind shares.
+    void    setBlurLevels(uint8_t levels);
+    uint8_t getBlurLevels() const;
+
     // ---- Mouse state for interactive materials ----------------------------
     // UILO calls this each frame after sampling the cursor. The renderer
     // uses it to drive Material::Ripple / Material::Hover (mouse trail
@@ -179,7 +650,38 @@ public:
 
     // ---- Text -------------------------------------------------------------
     // Load a TTF font file. Cached by path. Returns invalid Font on failure.
-    Font loadFont(const std::string& path);
+    // `sdf` bakes glyphs once as signed-distance fields at a fixed base size
+    // and scales them on the GPU, so every size and zoom level of that font
+    // shares one set of atlas entries (edges stay sharp when magnified; very
+    // small sizes lose a little hinting crispness vs. bitmap glyphs). The
+    // same path loaded both ways yields two distinct Fonts.
+    Font loadFont(const std::string& path, bool sdf = false);
+
+    // Fallback chain for `font`: codepoints it has no glyph for are drawn
+    // and measured with the first of `paths` that has one, aligned to
+    // `font`'s baseline. Each fallback loads (as SDF if `font` is) the
+    // first time a string needs it, and every font in the chain shares the
+    // one glyph atlas, so mixed-script text still draws as one batch.
+    // Applies to every user of `font`'s path; an empty list clears it.
+    void setFontFallbacks(const Font& font, const std::vector<std::string>& paths);
+
+    // Rasterizes every codepoint of `charset` (UTF-8) at each of `sizesPx`
+    // on a background thread, then packs them into the glyph atlas over the
+    // next beginFrames, so the first drawText of that text doesn't stall to
+    // bake it. Meant for a splash screen: e.g. ASCII plus the UI's own
+    // strings at the sizes the theme uses. SDF fonts have one face and
+    // ignore the sizes. Glyphs already cached are skipped and the atlas
+    // budget still applies; codepoints a fallback chain resolves are baked
+    // in that fallback. isFontPrewarming() stays true until every request
+    // has been uploaded.
+    void prewarmFont(const Font& font, const std::vector<float>& sizesPx,
+                     const std::string& charset);
+    bool isFontPrewarming() const;
+    // prewarmFont() for the text drawn in about the last second, at its
+    // size times `ratio`: what a UI scale change is about to ask for (see
+    // UILO::setScale). Bitmap fonts only; SDF text is the same face at any
+    // size.
+    void prewarmRescaledText(float ratio);
 
     // Draw a UTF-8 string at `position` (top-left of the text box).
     // `sizePx` is the requested cap height in pixels.
@@ -189,6 +691,14 @@ public:
                   float sizePx,
                   Color color = Color::White);
 
+    // GPU memory budget for the glyph atlas shared by every font and size,
+    // in bytes (default 4 MiB = four 1024x1024 R8 pages). Past the budget
+    // the least-recently-used page is evicted and its glyphs re-rasterize
+    // on demand. Lowering the budget frees idle pages right away. At least
+    // one page is always allowed.
+    void   setGlyphAtlasBudget(size_t bytes);
+    size_t getGlyphAtlasBudget() const;
+
     // Measure a UTF-8 string at the given size.
     TextMetrics measureText(const std::string& utf8,
                             const Font& font,
@@ -202,22 +712,56 @@ public:
                                      const Font& font,
                                      float sizePx);
 
+    // Writes the horizontal advance of each codepoint of `text` at sizePx
+    // to out[0 .. text.size()); '\n' and '\r' advance 0. Text isn't
+    // kerned, so a line's measureText width is the sum of its advances.
+    // Only reads font metrics: nothing is shaped, cached or rasterized.
+    // Feeds wrapText() (utils/TextWrap.hpp).
+    void glyphAdvances(std::u32string_view text, const Font& font, float sizePx,
+                       float* out);
+
     // ---- Framebuffer management -------------------------------------------
-    FrameBuffer createFrameBuffer(Vec2u size);
+    // Targets come from a pool keyed by size bucket and format, so
+    // destroy + create (or a resize within the same bucket) reuses the GPU
+    // allocation; view ids are recycled on destroy.
+    FrameBuffer createFrameBuffer(Vec2u size,
+                                  FrameBufferFormat format = FrameBufferFormat::BGRA8);
     void        resizeFrameBuffer(FrameBuffer& fb, Vec2u newSize);
     void        destroyFrameBuffer(FrameBuffer& fb);
+    // A pooled target for this frame only: it goes back to the pool at the
+    // next beginFrame, so don't keep the handle (or its contents) past
+    // endFrame and don't destroy it.
+    FrameBuffer acquireFrameBuffer(Vec2u size,
+                                   FrameBufferFormat format = FrameBufferFormat::BGRA8);
 
     void pushFrameBuffer(FrameBuffer& fb);
     void popFrameBuffer();
 
+    // Composites fb's colour (premultiplied, see createFrameBuffer) as a
+    // quad at dest under the current scissor / round clip.
     void drawFrameBuffer(const FrameBuffer& fb, Vec2f dest, Vec2f size,
                          Color tint = Color::White);
 
+    // ---- Cached layers ----------------------------------------------------
+    // beginLayer() clears fb and routes subsequent draws into it, with the
+    // scene point `origin` landing on fb's top-left; the clip stacks start
+    // empty so the contents don't depend on the parent's clip. Returns
+    // false (and changes nothing) while a transform or rotation is active.
+    // endLayer() returns false when something drawn in between can't be
+    // cached in a layer (glass materials are skipped, not drawn); the
+    // caller should then discard fb and draw the subtree directly.
+    bool beginLayer(FrameBuffer& fb, Vec2f origin);
+    bool endLayer();
+
     void clear(Color color = Color::Transparent);
 
     // ---- Scissor clipping -------------------------------------------------
     void pushScissor(Rectf bounds);
     void popScissor();
+    // Screen-space area draws can currently reach: the innermost scissor,
+    // or the whole render target when none is pushed. Lets an element
+    // skip work for its off-screen parts.
+    Rectf getClipBounds() const;
 
     // ---- Rounded-rect clipping (SDF in fragment shaders) ------------------
     // Pushes a rounded clip region. All subsequent draws (solid/tex/text)
@@ -238,23 +782,72 @@ public:
     void beginGlassSubtree();
     void endGlassSubtree();
 
+    // ---- Retained draw lists ---------------------------------------------
+    // Draws between begin/endDrawList are emitted as usual and also copied
+    // into `list`. Recordings nest: an inner list's geometry lands in every
+    // enclosing one too. Only batched draws (Rect, RoundedRect, Circle,
+    // Triangle, Line(s), Arc, Text) can be recorded; images, glass,
+    // framebuffer switches and clear() mark the list unreplayable, and
+    // endDrawList then returns false.
+    //
+    // replayDrawList re-emits the recorded geometry (one memcpy per batch)
+    // and returns true, or returns false without drawing when the list is
+    // invalid or was recorded under a different view / scissor / round
+    // clip / transform, or glyph pages it samples were evicted since. The
+    // caller then renders normally and re-records.
+    void beginDrawList(DrawList& list);
+    bool endDrawList(DrawList& list);
+    bool replayDrawList(const DrawList& list);
+
+    // ---- Transform stack --------------------------------------------------
+    // pushTransform(t) composes t onto the current transform (t applies
+    // first, in the current local space) for every later draw until the
+    // matching popTransform(). Batched draws map their vertices as they're
+    // appended, so pushing / popping never breaks a batch; instanced shapes
+    // and drawGeometry take the matrix on the GPU instead. Scissors and
+    // round clips pushed under a translate / scale are mapped with it;
+    // under rotation or skew they clip to the mapped rect's screen bounds
+    // and lose their rounding. Cleared each frame.
+    void        pushTransform(const Transform2D& t);
+    void        popTransform();
+    // The matrix draws currently go through, rotation included.
+    Transform2D getTransform() const;
+
     // ---- Rotation ---------------------------------------------------------
     // Degrees, standard cartesian convention: 0 = +x, 90 = +y,
-    // 180 = -x, 270 = -y, 360 wraps to 0. Pivot is in screen-pixel coords.
-    // Applied CPU-side to vertex positions of subsequent draws (Rect,
-    // Circle, Triangle, Line, drawLines, drawImage, drawText). Note:
-    // RoundedRect's SDF clip is axis-aligned and won't itself rotate; for
-    // knob indicators prefer Image/Triangle/Line drawn on top of a Circle.
+    // 180 = -x, 270 = -y, 360 wraps to 0. Pivot is in the current
+    // transform's local space (screen pixels when none is pushed), and
+    // each pushTransform level has its own rotation, restored on pop.
+    // Applies to subsequent draws but not to clips. Note: without
+    // instanced shapes (getInstancedShapes() false) a RoundedRect's SDF
+    // mask is axis-aligned and won't itself rotate; for knob indicators
+    // prefer Image/Triangle/Line drawn on top of a Circle.
     void setRotation(float degrees, Vec2f pivot);
     void rotate(float deltaDegrees);
     void clearRotation();
 
+    // ---- Parallel recording -----------------------------------------------
+    // Runs draw(i) for every i in [0, count) on pool's threads, each slice
+    // recording through its own bgfx encoder with its own batches, clip
+    // stacks, transform and view stack, all starting from the caller's.
+    // The slices land in the frame in index order, exactly as if they had
+    // been drawn one after another, and later draws stay on top of them.
+    // Everything on Renderer may be called from a slice; the caches it
+    // shares (fonts, atlases, textures) lock while slices run. A slice
+    // must leave its stacks balanced. Falls back to recording in order on
+    // the calling thread without a pool, inside a framebuffer, layer, glass
+    // subtree or draw-list recording, or when view ids run out.
+    void recordParallel(JobPool* pool, size_t count,
+                        const std::function<void(size_t)>& draw);
+
 private:
     SDL_Window* m_window      = nullptr;
     uint32_t    m_lastWidth   = 0;
     uint32_t    m_lastHeight  = 0;
     uint8_t     m_msaa        = 4;
     uint32_t    m_resetFlags  = 0;
+    bool        m_renderThreadWanted = false;
+    uint8_t     m_pipelineFrames     = 1;   // swapchain maxFrameLatency
     bool        m_initialised = false;
     double      m_frameInterval = 0.0; // seconds per frame; 0 = unlimited
     uint64_t    m_nextFrameTick = 0;   // steady_clock ns of next frame deadline
@@ -266,18 +859,18 @@ private:
     Vec2f       m_mousePosPrev  = { -1.f, -1.f };
     float       m_mouseLastMoveT = 0.f; // value of impl.elapsed at last move
 
-    // Views 0..3 are reserved for the scene FB + blur ladder + composite
-    // (see RendererImpl.hpp::Impl). User framebuffers start at 4.
-    uint16_t m_nextViewId = 6;
+    // Views 0..15 are the framebuffer pool and 16..30 the scene FB + blur
+    // ladder + composite (see RendererImpl.hpp::Impl). Framebuffers that
+    // don't fit the pool take views from 31 up; destroyed ones hand theirs
+    // back through Impl::fbFreeViews before new ids are taken.
+    uint16_t m_nextViewId = 31;
     bool     m_ownsContext = true; // false in attach() mode: host owns bgfx/window/frame
-
-    struct ViewEntry { uint16_t viewId; };
-    static constexpr int kMaxViewStack = 16;
-    ViewEntry m_viewStack[kMaxViewStack] = {};
-    int       m_viewStackTop = 0;
+    bool     m_sharedContext = false; // initShared(): the primary owns bgfx and presents
+    bool     m_headless    = false;
+    Vec2u    m_headlessSize = {0u, 0u};
 
     uint16_t currentViewId() const;
-    void     submitOrtho(uint16_t viewId, Vec2u size);
+    void     submitOrtho(uint16_t viewId, Vec2u size, Vec2f origin = {0.f, 0.f});
 
 public:
     // PIMPL is public so TU-local helpers (in renderer .cpp files that include
@@ -3,19 +3,30 @@
 #pragma once
 
 #include "Renderer.hpp"
+#include "../utils/InlineFunction.hpp"
+#include "../utils/MappedFile.hpp"
+#include "../utils/Trace.hpp"
+#include "../utils/Utf8.hpp"
 
 #include <bgfx/bgfx.h>
 // NOTE: no <bgfx/platform.h> -- upstream bgfx merged it into bgfx.h; the old
 // header only exists in stale system installs and pulls in mismatched decls.
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <cstdio>
 #include <algorithm>
+#include <atomic>
+#include <bitset>
 
 // stb_truetype declaration only — STB_TRUETYPE_IMPLEMENTATION lives in
 // Renderer_Text.cpp.
@@ -23,68 +34,488 @@
 
 namespace uilo {
 
+// `clip` is the indexed-clip node the vertex is masked by (0 = none; see
+// the clip table in Renderer::Impl). Only batched vertices set it.
 struct PosColorVertex {
     float    x, y;
     uint32_t abgr;
+    float    clip = 0.f;
 };
 
 struct PosColorUvVertex {
     float    x, y;
     uint32_t abgr;
     float    u, v;
+    float    clip = 0.f;
+};
+
+// One instanced Rect / RoundedRect / Circle (vs_shape's i_data0..2). Corner
+// RGB travels as an exact integer float (r << 16 | g << 8 | b) and alphas
+// in pairs, keeping the instance at three vec4s. A stop-ramp fill reuses
+// the colour slots: rgb holds GradientRamp::geom, params[1] is -1 (linear)
+// or -2 (radial) and params[2] the gradient table row.
+struct ShapeInstance {
+    float rect[4];     // x, y, w, h of the shape (local px)
+    float rgb[4];      // TL, TR, BR, BL
+    float params[4];   // radius (< 0: AA rect), aTL + aTR * 256, aBR + aBL * 256,
+                       // quad padding (< 4) + clip node * 4
+};
+
+// One corner of a deferred glass panel (vs_glass). Everything fs_glass
+// used to take as per-draw uniforms rides here, so panels batch.
+struct GlassVertex {
+    float    x, y;
+    uint32_t local;      // element-local 0..1 in the r/g bytes
+    float    u, v;       // blur-target UV
+    uint32_t tint;       // ABGR
+    uint32_t base;       // ABGR, element's own colour
+    float    params[4];  // opacity, saturation, brightness, edge highlight
+    float    rect[4];    // corner radius, half width, half height, refraction (UV)
+    float    anim[4];    // kind, unused, anim speed, anim strength / ladder weight
 };
 
 // ---- Cached glyph in a font atlas ----------------------------------------
 struct Glyph {
-    uint16_t x, y, w, h;   // pixel rect inside atlas
+    uint16_t x, y, w, h;   // pixel rect inside its atlas page
     float    xoff, yoff;   // offset from pen position to top-left of bitmap
     float    xadvance;     // horizontal advance
+    uint16_t page    = UINT16_MAX; // GlyphAtlasPage slot; UINT16_MAX = no bitmap
+    uint32_t pageGen = 0;          // page generation the rect was packed in
+    uint32_t retryFrame = 0;       // atlas was full this frame; retry after it
+};
+
+// Immutable TTF bytes shared by every record and face cut from one font:
+// either a mapping of the file on disk, or pointing at the embedded array
+// (nothing open). Faces hold a reference because their stbtt_fontinfo
+// points into it.
+struct FontBlob {
+    MappedFile           file;
+    const uint8_t*       data = nullptr;
+    size_t               size = 0;
 };
+using FontBlobPtr = std::shared_ptr<const FontBlob>;
 
-// A baked font at a specific pixel size.
+// A baked font at a specific pixel size. Bitmaps live in the shared glyph
+// atlas (Impl::glyphPages); the face only keeps metrics + the glyph table.
+// SDF faces are baked once at Impl::kSdfBasePx and hold distance fields;
+// callers scale metrics by sizePx / pixelHeight.
 struct FontFace {
-    std::vector<uint8_t>             ttfData;   // owning copy of TTF bytes
+    FontBlobPtr                      ttf;       // bytes `info` points into
     stbtt_fontinfo                   info{};
     float                            pixelHeight = 0.f;
     float                            scale       = 1.f;
     float                            ascent      = 0.f;
     float                            descent     = 0.f;
     float                            lineGap     = 0.f;
-    int                              atlasW      = 0;
-    int                              atlasH      = 0;
-    int                              penX        = 0;
-    int                              penY        = 0;
-    int                              rowH        = 0;
-    bgfx::TextureHandle              atlas       = BGFX_INVALID_HANDLE;
+    bool                             sdf         = false;
     std::unordered_map<uint32_t, Glyph> glyphs;
+    // Direct index over `glyphs` for codepoints < 256 (entries point into
+    // the map, whose nodes never move); findGlyph / storeGlyph keep it.
+    Glyph*                           latin1[256] = {};
+    // Advances (face px) for glyphAdvances(), filled on first use without
+    // rasterizing anything: dense for ASCII (< 0 = not yet read).
+    float                            asciiAdvance[128];
+    std::unordered_map<uint32_t, float> advances;
+
+    FontFace() { for (float& a : asciiAdvance) a = -1.f; }
+    // Copies would point latin1 into the source's map.
+    FontFace(const FontFace&) = delete;
+    FontFace& operator=(const FontFace&) = delete;
+    FontFace(FontFace&&) = default;
+    FontFace& operator=(FontFace&&) = default;
+
+    Glyph* findGlyph(uint32_t cp) {
+        if (cp < 256) return latin1[cp];
+        auto it = glyphs.find(cp);
+        return it != glyphs.end() ? &it->second : nullptr;
+    }
+    const Glyph* findGlyph(uint32_t cp) const { return const_cast<FontFace*>(this)->findGlyph(cp); }
+    Glyph* storeGlyph(uint32_t cp, const Glyph& g) {
+        Glyph* slot = &(glyphs[cp] = g);
+        if (cp < 256) latin1[cp] = slot;
+        return slot;
+    }
+};
+
+// ---- Shared glyph atlas page ---------------------------------------------
+// One R8 texture shared by every font face and size, packed with a shelf
+// allocator. Pages are evicted whole (LRU by last frame touched); bumping
+// `gen` invalidates every Glyph packed into the page so it re-rasterizes on
+// next use instead of sampling someone else's pixels. Glyphs are rasterized
+// into a CPU `shadow` of the page; the rect they dirtied goes up in one
+// update per page at endFrame (Impl::uploadGlyphAtlas).
+struct GlyphAtlasPage {
+    struct Shelf { uint16_t y, h, x; };
+    bgfx::TextureHandle  tex       = BGFX_INVALID_HANDLE;
+    std::vector<Shelf>   shelves;
+    std::vector<uint8_t> shadow;           // kGlyphPageSize^2 texels while tex is live
+    uint16_t             nextY     = 0;     // top of the unallocated region
+    uint32_t             gen       = 1;
+    uint32_t             lastUsed  = 0;     // Impl::frameIndex of last lookup
+    uint64_t             usedArea  = 0;     // px^2 handed out (occupancy stat)
+    // Dirty rect not yet uploaded, [x0, x1) x [y0, y1); empty when x0 >= x1.
+    uint16_t             dirtyX0 = UINT16_MAX, dirtyY0 = UINT16_MAX;
+    uint16_t             dirtyX1 = 0,          dirtyY1 = 0;
+
+    void markDirty(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+        dirtyX0 = std::min(dirtyX0, x);
+        dirtyY0 = std::min(dirtyY0, y);
+        dirtyX1 = std::max(dirtyX1, (uint16_t)(x + w));
+        dirtyY1 = std::max(dirtyY1, (uint16_t)(y + h));
+    }
+    bool dirty() const { return dirtyX0 < dirtyX1; }
+    void clearDirty() { dirtyX0 = dirtyY0 = UINT16_MAX; dirtyX1 = dirtyY1 = 0; }
+};
+
+// ---- Shared image atlas page -----------------------------------------------
+// RGBA8 page that small loadTexture images are packed into, so consecutive
+// drawImage calls from one page share a submit. Never evicted: entries are
+// small and an image draw may sample its page until shutdown.
+struct ImageAtlasPage {
+    using Shelf = GlyphAtlasPage::Shelf;
+    bgfx::TextureHandle tex      = BGFX_INVALID_HANDLE;
+    std::vector<Shelf>  shelves;
+    uint16_t            nextY    = 0;
+    uint64_t            usedArea = 0;
+};
+
+// Shelf packer shared by both atlases: best-fit among shelves tall enough
+// for the rect, preferring ones that don't waste more than half its height;
+// opens a new shelf when nothing fits. `pad` blank texels follow every rect.
+template <class Page>
+bool packShelf(Page& p, int size, int pad, int w, int h, uint16_t& outX, uint16_t& outY) {
+    const int pw = w + pad;
+    const int ph = h + pad;
+    typename Page::Shelf* best = nullptr;
+    for (int pass = 0; pass < 2 && !best; ++pass) {
+        for (auto& sh : p.shelves) {
+            if (sh.h < ph || sh.x + pw > size) continue;
+            if (pass == 0 && sh.h > ph + ph / 2) continue;
+            if (!best || sh.h < best->h) best = &sh;
+        }
+        // A fresh shelf beats a loose fit while vertical space remains.
+        if (pass == 0 && !best && p.nextY + ph <= size) break;
+    }
+    if (!best) {
+        if (p.nextY + ph > size) return false;
+        p.shelves.push_back({p.nextY, (uint16_t)ph, (uint16_t)pad});
+        p.nextY = (uint16_t)(p.nextY + ph);
+        best = &p.shelves.back();
+    }
+    outX = best->x;
+    outY = best->y;
+    best->x = (uint16_t)(best->x + pw);
+    p.usedArea += (uint64_t)w * (uint64_t)h;
+    return true;
+}
+
+// ---- Shaped text run -------------------------------------------------------
+// Everything measureText / charPositions / drawText derive from one
+// (string, font, size): decoded once, then replayed. Quads are relative to
+// the draw position and unsnapped; drawText snaps bitmap glyphs at replay
+// since the fractional part of the position varies between calls. A quad
+// whose page generation moved on means the atlas evicted it, so the run is
+// rebuilt.
+struct TextRunQuad {
+    float    x, y, w, h;
+    float    u0, v0, u1, v1;
+    uint16_t page;
+    uint32_t pageGen;
+};
+
+struct TextRun {
+    std::string              text;
+    uint32_t                 fontId  = UINT32_MAX;
+    float                    sizePx  = 0.f;
+    bool                     sdf     = false;
+    TextMetrics              metrics;
+    std::vector<Vec2f>       positions;   // charPositions() result
+    std::vector<TextRunQuad> quads;
+    uint32_t                 lastUsed   = 0;  // Impl::frameIndex
+    uint32_t                 retryFrame = 0;  // some glyphs missed a full atlas
+};
+
+// ---- Cached image texture --------------------------------------------------
+// textureCache entry. Failed loads are cached too (invalid tex, 0 bytes) so
+// a missing file isn't re-read every frame; they expire after
+// Impl::kFailedTextureMaxAge frames.
+struct TextureEntry {
+    Texture  tex;
+    uint64_t bytes    = 0;
+    uint32_t refs     = 0;   // retainTexture holders; never evicted while > 0
+    uint32_t lastUsed = 0;   // Impl::frameIndex of last lookup / release
+    bool     atlased  = false;   // tex is a region of an ImageAtlasPage
+};
+
+// ---- Tessellated arc -------------------------------------------------------
+// drawArc's ring of (segs + 3) slices x 4 radial rows, relative to the
+// center and unrotated. `alpha` is each vertex's skirt coverage (0 / 255);
+// indices are relative to the first vertex.
+struct ArcMesh {
+    float                 innerR   = 0.f;
+    float                 outerR   = 0.f;
+    float                 startDeg = 0.f;
+    float                 endDeg   = 0.f;
+    int                   segs     = 0;
+    std::vector<Vec2f>    offsets;
+    std::vector<uint8_t>  alpha;
+    std::vector<uint16_t> idx;
+    uint32_t              lastUsed = 0;  // Impl::frameIndex
+};
+
+// Background image decoding for loadTextureAsync. Workers decode queued
+// paths (from a MappedFile) into RGBA8 and park the results; only the
+// render thread touches bgfx, in Impl::pumpTextureUploads. Workers start
+// on the first request.
+struct TextureDecodeQueue {
+    struct Result {
+        std::string          key;       // Impl::textureKey
+        std::string          path;
+        std::vector<uint8_t> rgba;      // whole mip chain when mips; empty on failure
+        uint16_t             width  = 0;
+        uint16_t             height = 0;
+        bool                 mips   = false;
+        std::string          error;
+    };
+
+    TextureDecodeQueue() = default;
+    ~TextureDecodeQueue() { stop(); }
+    TextureDecodeQueue(const TextureDecodeQueue&) = delete;
+    TextureDecodeQueue& operator=(const TextureDecodeQueue&) = delete;
+
+    void push(std::string key, const std::string& path, const TextureLoadOptions& opts);
+    // Moves finished decodes into out (appending).
+    void drain(std::vector<Result>& out);
+    bool hasResults() const;
+    // Joins the workers and drops queued and finished work.
+    void stop();
+
+private:
+    struct Request {
+        std::string        key;
+        std::string        path;
+        TextureLoadOptions opts;
+    };
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<Request>      m_queue;
+    std::vector<Result>      m_done;
+    mutable std::mutex       m_mutex;
+    std::condition_variable  m_wake;
+    bool                     m_stop = false;
+};
+
+// Background glyph rasterization for prewarmFont. One worker bakes queued
+// (font, size, codepoints) requests into CPU bitmaps with its own
+// stbtt_fontinfo over the shared blob; the render thread packs and uploads
+// them in Impl::pumpGlyphBakes. The worker starts on the first request.
+struct GlyphBakeQueue {
+    struct Baked {
+        uint32_t codepoint = 0;
+        Glyph    glyph{};          // metrics; w/h the bitmap size (0 = blank)
+        size_t   offset    = 0;    // start of its bitmap in Result::pixels
+    };
+    struct Result {
+        uint32_t             fontId = 0;
+        int                  sizeKey = 0;   // FontFace key (Impl::getFace)
+        std::vector<Baked>   glyphs;
+        std::vector<uint8_t> pixels;        // R8 bitmaps, tightly packed
+    };
+
+    GlyphBakeQueue() = default;
+    ~GlyphBakeQueue() { stop(); }
+    GlyphBakeQueue(const GlyphBakeQueue&) = delete;
+    GlyphBakeQueue& operator=(const GlyphBakeQueue&) = delete;
+
+    void push(uint32_t fontId, int sizeKey, bool sdf, FontBlobPtr ttf,
+              std::vector<uint32_t> codepoints);
+    // Moves finished batches into out (appending).
+    void drain(std::vector<Result>& out);
+    // Requests queued or being baked, plus results not yet drained.
+    bool busy() const;
+    // Joins the worker and drops queued and finished work.
+    void stop();
+
+private:
+    struct Request {
+        uint32_t              fontId  = 0;
+        int                   sizeKey = 0;
+        bool                  sdf     = false;
+        FontBlobPtr           ttf;
+        std::vector<uint32_t> codepoints;
+    };
+    void workerLoop();
+
+    std::thread             m_worker;
+    std::deque<Request>     m_queue;
+    std::vector<Result>     m_done;
+    uint32_t                m_baking = 0;   // requests the worker has taken
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_wake;
+    bool                    m_stop = false;
+};
+
+// Why a queued batch was submitted (RendererStats::flushes*).
+enum class FlushReason : uint8_t {
+    State,      // view, scissor, round clip, atlas, program or transform changed
+    Capacity,   // vertex / instance limit
+    Switch,     // a draw for another batch came in
+    Explicit,   // flushBatches(): unbatched draws, targets, lists, frame end
+    Count,
+};
+
+// ---- Loaded font -------------------------------------------------------------
+// RendererShared::fonts entry: path -> record; faces stored sparsely per
+// requested pixel size.
+struct FontRecord {
+    FontBlobPtr ttf;     // shared with the file's other record and faces
+    stbtt_fontinfo info{};   // over ttf; copied into each face
+    // map keyed by integer pixel height (SDF records hold one face)
+    std::unordered_map<int, FontFace> sizes;
+    bool sdf = false;
+    // setFontFallbacks chain, tried in order for codepoints this font
+    // lacks. Each loads (with this record's sdf) the first time it's
+    // needed; `resolved` caches which font answered a codepoint.
+    struct Fallback {
+        std::string path;
+        uint32_t    id    = UINT32_MAX;
+        bool        tried = false;
+    };
+    std::vector<Fallback>                  fallbacks;
+    std::unordered_map<uint32_t, uint32_t> resolved;   // codepoint -> font id
+};
+
+// ---- Gradient table row ------------------------------------------------------
+// One baked ramp in RendererShared::gradientLut, keyed by its stops' hash.
+struct GradientLutRow {
+    uint64_t key     = 0;
+    uint32_t lastUse = 0;     // frameIndex of the last bake
+};
+
+// ---- Resources shared between windows -----------------------------------------
+// Everything on the GPU that doesn't belong to one window, and the caches
+// over it: programs, uniforms and layouts, textures, the image and glyph
+// atlases, fonts, shaped runs and arc meshes. Each context owner makes one;
+// Renderer::initShared() hands a second window its primary's, so opening it
+// loads and bakes nothing. Impl reaches every member through a reference of
+// the same name. frameIndex moves once per bgfx frame however many windows
+// record into it (frameOpen), so a page one window drew from this frame is
+// never evicted by another.
+struct RendererShared {
+    bgfx::VertexLayout       solidLayout;
+    bgfx::VertexLayout       texLayout;
+    bgfx::VertexLayout       glassLayout;
+    bgfx::VertexLayout       quadLayout;
+    bool                     layoutsInit     = false;
+    bool                     programsInit    = false;
+    bool                     glassTried      = false;   // ensureGlassPrograms() ran
+    bool                     waveformTried   = false;
+    bgfx::ProgramHandle      solidProgram    = BGFX_INVALID_HANDLE;
+    bgfx::ProgramHandle      texProgram      = BGFX_INVALID_HANDLE;
+    bgfx::ProgramHandle      textProgram     = BGFX_INVALID_HANDLE;
+    bgfx::ProgramHandle      textSdfProgram  = BGFX_INVALID_HANDLE;
+    bgfx::ProgramHandle      blurProgram     = BGFX_INVALID_HANDLE;
+    bgfx::ProgramHandle      kawaseProgram   = BGFX_INVALID_HANDLE;
+    bgfx::ProgramHandle      glassProgram    = BGFX_INVALID_HANDLE;
+    bgfx::ProgramHandle      waveformProgram = BGFX_INVALID_HANDLE;
+    bgfx::ProgramHandle      shapeProgram    = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      s_texColor      = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      s_texLadder     = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_imgFlags      = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_blurParams    = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_blurClamp     = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_glassFrame    = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_waveParams    = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_waveSize      = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_shapeXform    = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_clipRect      = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_clipParams    = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_clipRect2     = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle      u_clipParams2   = BGFX_INVALID_HANDLE;
+    bgfx::VertexBufferHandle unitQuadVb      = BGFX_INVALID_HANDLE;
+    bgfx::IndexBufferHandle  unitQuadIb      = BGFX_INVALID_HANDLE;
+    bool                     shapeInstancing = false;
+
+    std::unordered_map<std::string, TextureEntry> textureCache;
+    uint64_t                                 textureBudget    = 0;
+    uint64_t                                 textureBytes     = 0;
+    uint64_t                                 textureEvictions = 0;
+    std::unordered_set<std::string>          texturesPending;
+    TextureDecodeQueue                       textureDecoder;
+    std::vector<TextureDecodeQueue::Result>  textureUploads;
+    GlyphBakeQueue                           glyphBaker;
+    std::vector<GlyphBakeQueue::Result>      glyphUploads;
+    size_t                                   glyphUploadNext  = 0;
+    uint16_t                                 imageAtlasMaxSize = 128;
+    std::vector<ImageAtlasPage>              imageAtlasPages;
+    // A deque so records (and the faces in them) stay put as fallbacks load.
+    std::deque<FontRecord>                   fonts;
+    std::unordered_map<std::string, uint32_t> fontByPath;
+    std::vector<GlyphAtlasPage>              glyphPages;
+    size_t                                   glyphAtlasBudget    = size_t(4) << 20;  // four 1024^2 R8 pages
+    uint32_t                                 glyphAtlasEvictions = 0;
+    uint32_t                                 frameIndex = 1;
+    std::unordered_map<uint64_t, TextRun>    textRuns;
+    uint64_t                                 textRunHits   = 0;
+    uint64_t                                 textRunMisses = 0;
+    std::unordered_map<uint64_t, ArcMesh>    arcMeshes;
+    uint64_t                                 arcMeshHits   = 0;
+    uint64_t                                 arcMeshMisses = 0;
+    std::unordered_map<int, void*>           cursors;
+    bgfx::TextureHandle                      gradientLut   = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle                      s_gradientLut = BGFX_INVALID_HANDLE;
+    std::vector<uint8_t>                     gradientLutPixels;
+    std::vector<GradientLutRow>              gradientRows;
+    std::unordered_map<uint64_t, uint16_t>   gradientRowByKey;
+    uint16_t                                 gradientDirty0 = UINT16_MAX, gradientDirty1 = 0;
+    uint32_t                                 gradientEvictions = 0;
+    uint64_t                                 contentGeneration = 0;
+    std::recursive_mutex                     cacheMutex;
+
+    uint32_t       renderers   = 0;       // initialised Renderers drawing with these
+    bool           contextLive = false;   // bgfx is up (its owner hasn't shut down)
+    bool           frameOpen   = false;   // a beginFrame ran since the last bgfx::frame()
+    std::bitset<8> windowBlocks;          // view-id blocks held by initShared() windows
 };
 
 struct Renderer::Impl {
+    explicit Impl(std::shared_ptr<RendererShared> s = std::make_shared<RendererShared>())
+        : shared(std::move(s)) { setViewBase(0); }
+
+    // Declared first: the references below bind to it.
+    std::shared_ptr<RendererShared> shared;
+
     // ---- bgfx shader programs ----
-    bgfx::VertexLayout              solidLayout;
-    bgfx::VertexLayout              texLayout;
-    bgfx::ProgramHandle             solidProgram = BGFX_INVALID_HANDLE;
-    bgfx::ProgramHandle             texProgram   = BGFX_INVALID_HANDLE;
-    bgfx::ProgramHandle             textProgram  = BGFX_INVALID_HANDLE;
-    bgfx::ProgramHandle             blurProgram  = BGFX_INVALID_HANDLE;
-    bgfx::ProgramHandle             glassProgram = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             s_texColor   = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_imgFlags   = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_blurParams = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_glassParams= BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_glassTint  = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_glassRect  = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_glassAnim  = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_glassBase  = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_glassMouse = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_clipRect   = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_clipParams = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_clipRect2  = BGFX_INVALID_HANDLE;
-    bgfx::UniformHandle             u_clipParams2= BGFX_INVALID_HANDLE;
-    bool                            layoutsInit  = false;
+    bgfx::VertexLayout&             solidLayout = shared->solidLayout;
+    bgfx::VertexLayout&             texLayout = shared->texLayout;
+    bgfx::VertexLayout&             glassLayout = shared->glassLayout;
+    bgfx::ProgramHandle&            solidProgram = shared->solidProgram;
+    bgfx::ProgramHandle&            texProgram = shared->texProgram;
+    bgfx::ProgramHandle&            textProgram = shared->textProgram;
+    bgfx::ProgramHandle&            textSdfProgram = shared->textSdfProgram;
+    bgfx::ProgramHandle&            blurProgram = shared->blurProgram;
+    bgfx::ProgramHandle&            kawaseProgram = shared->kawaseProgram;
+    bgfx::ProgramHandle&            glassProgram = shared->glassProgram;
+    bgfx::ProgramHandle&            waveformProgram = shared->waveformProgram;
+    bgfx::ProgramHandle&            shapeProgram = shared->shapeProgram;
+    bgfx::UniformHandle&            s_texColor = shared->s_texColor;
+    bgfx::UniformHandle&            s_texLadder = shared->s_texLadder;
+    bgfx::UniformHandle&            u_imgFlags = shared->u_imgFlags;
+    bgfx::UniformHandle&            u_blurParams = shared->u_blurParams;
+    bgfx::UniformHandle&            u_blurClamp = shared->u_blurClamp;
+    bgfx::UniformHandle&            u_glassFrame = shared->u_glassFrame;
+    bgfx::UniformHandle&            u_waveParams = shared->u_waveParams;
+    bgfx::UniformHandle&            u_waveSize = shared->u_waveSize;
+    bgfx::UniformHandle&            u_shapeXform = shared->u_shapeXform;
+    bgfx::UniformHandle&            u_clipRect = shared->u_clipRect;
+    bgfx::UniformHandle&            u_clipParams = shared->u_clipParams;
+    bgfx::UniformHandle&            u_clipRect2 = shared->u_clipRect2;
+    bgfx::UniformHandle&            u_clipParams2 = shared->u_clipParams2;
+    bool&                           layoutsInit = shared->layoutsInit;
 
     // Wall-clock elapsed seconds since renderer init, fed into animated
-    // materials (Holographic / Liquid / Shimmer / Aurora) via u_glassAnim.y.
+    // materials (Holographic / Liquid / Shimmer / Aurora) via u_glassFrame.w.
     float                           elapsed      = 0.f;
 
     // ---- Offscreen scene + blur ladder (for Material::Glass) ----
@@ -92,10 +523,14 @@ struct Renderer::Impl {
     //   View 0: app draws the non-glass scene into sceneFB.
     //   View 1: horizontal blur, sceneFB -> blurFB_A (half-res).
     //   View 2: vertical   blur, blurFB_A -> blurFB_B (half-res, final blur).
-    //   View 3: replay deferred glass draws into sceneFB, sampling blurFB_B.
-    //   View 4: composite sceneFB -> backbuffer.
+    //   Views 3..11: dual-Kawase ladder (only when a Material::Blur asks
+    //           for more than the Gaussian gives; see ladderDown/Up).
+    //   View 12: replay deferred glass draws into sceneFB, sampling blurFB_B
+    //           and the ladder.
+    //   View 14: composite sceneFB -> backbuffer.
     // Glass elements thus sample a blur built from the SAME frame's scene
     // minus the glass elements themselves — no one-frame lag, no self-blur.
+    // Which of these run each frame is up to the frame graph (fgPasses).
     bgfx::FrameBufferHandle         sceneFB       = BGFX_INVALID_HANDLE;
     bgfx::FrameBufferHandle         blurFB_A      = BGFX_INVALID_HANDLE;
     bgfx::FrameBufferHandle         blurFB_B      = BGFX_INVALID_HANDLE;
@@ -104,26 +539,191 @@ struct Renderer::Impl {
     bgfx::TextureHandle             blurColorB    = BGFX_INVALID_HANDLE;
     uint32_t                        fbWidth       = 0;
     uint32_t                        fbHeight      = 0;
+    // Live resizes would otherwise recreate every target each frame, so
+    // they're allocated in kFbBucket steps and only ever grow; the content
+    // (fbWidth x fbHeight) renders into the top-left of the allocation.
+    // They shrink back once the size has held for kFbShrinkFrames.
+    static constexpr uint32_t       kFbBucket       = 256;
+    static constexpr uint32_t       kFbShrinkFrames = 120;
+    static uint32_t fbBucketed(uint32_t px) { return (px + kFbBucket - 1) / kFbBucket * kFbBucket; }
+    uint32_t                        fbAllocW      = 0;
+    uint32_t                        fbAllocH      = 0;
+    uint32_t                        fbStableFrames = 0;
+    // Blur + composite view rects; the scene and glass views are bound by
+    // bindSceneViews() each frame.
+    void setSceneViewRects(uint32_t width, uint32_t height);
+    // Clamps blur taps to the content of a (cw x ch) image inside its
+    // (aw x ah) target, so they never read the stale margin.
+    void setBlurClamp(uint32_t cw, uint32_t ch, uint32_t aw, uint32_t ah) const;
+
+    // Dual-Kawase ladder for Material::Blur radii the half-res Gaussian
+    // can't reach. ladderDown[k] holds level k+1 (1/2^(k+1) resolution);
+    // ladderUp[k] the upsample back to that level, so ladderUp[0] (half
+    // res) is the ladder's output. Created on first use, one level per
+    // doubling of the largest radius requested; deeper levels nobody
+    // asked for this frame are simply not submitted.
+    static constexpr uint8_t  kMaxBlurLevels     = 5;
+    static constexpr uint16_t kBlurLadderViews   = 2 * kMaxBlurLevels - 1;
+    static constexpr float    kGaussianBlurRadius = 8.f;   // fs_blur, full-res px
+    // Approximate full-res radius of a ladder `levels` deep.
+    static float ladderRadius(uint8_t levels) { return (float)(4u << levels); }
+    std::vector<bgfx::FrameBufferHandle> ladderDown;
+    std::vector<bgfx::FrameBufferHandle> ladderUp;
+    uint8_t                         blurLevelCap  = kMaxBlurLevels; // setBlurLevels
+    uint8_t                         ladderLevels  = 0;              // this frame
+    // shareLevel1: use blurFB_A as the level-1 downsample (see fgTarget).
+    bool ensureBlurLadder(uint8_t levels, bool shareLevel1);
+    void destroyBlurLadder();
+    void runBlurLadder(uint32_t width, uint32_t height, uint8_t levels);
+    // Texture glass samples as its wide blur; blurColorB when no ladder ran.
+    bgfx::TextureHandle ladderTexture() const {
+        return ladderLevels >= 2 ? bgfx::getTexture(ladderUp[0]) : blurColorB;
+    }
+    // Weight drawGlass mixes the ladder in with for a Material::Blur
+    // element asking for `radius` extra pixels: 0 keeps the Gaussian, 1
+    // is the full ladder, in between blends on a log scale.
+    float ladderWeight(float radius) const;
+    // Framebuffer views. createFrameBuffer() hands these out first; they sit
+    // BELOW the pipeline views so whatever a framebuffer receives during the
+    // frame is finished before the scene that composites it executes. Views
+    // owned by live framebuffers are flagged in fbViews; their targets hold
+    // premultiplied colour (see blendState()).
+    static constexpr uint16_t kMaxFbViews = 16;
+    uint16_t         fbViewFirst = 0;
+    std::bitset<256> fbViews;
+    // Overflow views (past the pool) released by destroyFrameBuffer.
+    std::vector<uint16_t> fbFreeViews;
+
+    // Idle user framebuffers, keyed by kFbPoolBucket-rounded size and
+    // format. A target released this frame may still be sampled by views
+    // that haven't executed, so it's only handed out again from the next
+    // frame on. Idle past kFbPoolIdleFrames (or beyond kFbPoolMaxIdle of
+    // them) they're destroyed.
+    struct PooledFrameBuffer {
+        bgfx::FrameBufferHandle handle = BGFX_INVALID_HANDLE;
+        uint16_t                w = 0, h = 0;
+        FrameBufferFormat       format = FrameBufferFormat::BGRA8;
+        uint32_t                releasedAt = 0;   // frameIndex
+    };
+    static constexpr uint32_t kFbPoolBucket     = 64;
+    static constexpr uint32_t kFbPoolIdleFrames = 300;
+    static constexpr size_t   kFbPoolMaxIdle    = 8;
+    std::vector<PooledFrameBuffer> fbPool;
+    std::vector<FrameBuffer>       transientFbs;   // acquireFrameBuffer, this frame
+    uint64_t liveFbBytes = 0;                      // created, not yet destroyed
+    static uint64_t fbBytes(uint32_t w, uint32_t h, FrameBufferFormat format) {
+        return uint64_t(w) * h * (format == FrameBufferFormat::RGBA16F ? 8u : 4u);
+    }
+    uint32_t fbAllocsThisFrame = 0;
+    uint32_t fbAllocsLastFrame = 0;
+    // A target of at least w x h in `format`: reused from fbPool when a
+    // matching one is idle, else created. Sets w/h to its real size.
+    bgfx::FrameBufferHandle takePooledFrameBuffer(uint16_t& w, uint16_t& h,
+                                                  FrameBufferFormat format);
+    void releasePooledFrameBuffer(bgfx::FrameBufferHandle handle, uint16_t w, uint16_t h,
+                                  FrameBufferFormat format);
+    void trimFrameBufferPool();
     // Pipeline view ids. Non-const so an embedded host (e.g. the engine) can
     // rebase them above its own views via setViewBase(); see Renderer::attach().
-    uint16_t       kSceneViewId        = 0;
-    uint16_t       kBlurHViewId        = 1;
-    uint16_t       kBlurVViewId        = 2;
-    uint16_t       kGlassBgViewId      = 3;
-    uint16_t       kGlassChildViewId   = 4;
-    uint16_t       kCompositeViewId    = 5;
+    uint16_t       kSceneViewId        = kMaxFbViews + 0;
+    uint16_t       kBlurHViewId        = kMaxFbViews + 1;
+    uint16_t       kBlurVViewId        = kMaxFbViews + 2;
+    // Blur-ladder passes take kBlurLadderViews ids: the downsamples in
+    // order, then the upsamples from the deepest level back to half res.
+    uint16_t       kLadderViewFirst    = kMaxFbViews + 3;
+    uint16_t       kGlassBgViewId      = kMaxFbViews + 3 + kBlurLadderViews;
+    uint16_t       kGlassChildViewId   = kMaxFbViews + 4 + kBlurLadderViews;
+    uint16_t       kCompositeViewId    = kMaxFbViews + 5 + kBlurLadderViews;
+    static constexpr uint16_t kPipelineViews = 6 + kBlurLadderViews;
     void setViewBase(uint16_t base) {
-        kSceneViewId      = base + 0;
-        kBlurHViewId      = base + 1;
-        kBlurVViewId      = base + 2;
-        kGlassBgViewId    = base + 3;
-        kGlassChildViewId = base + 4;
-        kCompositeViewId  = base + 5;
+        fbViewFirst       = base;
+        kSceneViewId      = base + kMaxFbViews + 0;
+        kBlurHViewId      = base + kMaxFbViews + 1;
+        kBlurVViewId      = base + kMaxFbViews + 2;
+        kLadderViewFirst  = base + kMaxFbViews + 3;
+        kGlassBgViewId    = base + kMaxFbViews + 3 + kBlurLadderViews;
+        kGlassChildViewId = base + kMaxFbViews + 4 + kBlurLadderViews;
+        kCompositeViewId  = base + kMaxFbViews + 5 + kBlurLadderViews;
+        mainRecord.sceneView      = kSceneViewId;
+        mainRecord.glassChildView = kGlassChildViewId;
+    }
+    // initShared() windows each hold a block of kWindowViews ids, taken
+    // from the top of the range down (windowBlockBase): framebuffer pool
+    // and pipeline first, overflow framebuffers and parallel slices in the
+    // rest. The primary keeps everything below the lowest block held.
+    static constexpr uint16_t kWindowViews = 48;
+    uint16_t viewEnd     = 0;      // initShared(): end of this window's block
+    int      windowBlock = -1;
+    static uint32_t windowBlockBase(size_t block);
+    // First view id past the ones this renderer may hand out.
+    uint16_t viewLimit() const;
+    // View of the downsample into level `k` / the upsample into level `k`
+    // (1-based, level 1 = half res).
+    uint16_t ladderDownView(uint8_t k) const { return kLadderViewFirst + (k - 1); }
+    uint16_t ladderUpView(uint8_t k) const {
+        return kLadderViewFirst + kMaxBlurLevels + (kMaxBlurLevels - 1 - k);
+    }
+    // Blend state for batches/quads submitted to `view`. Framebuffer views
+    // accumulate alpha with ONE/INV_SRC_ALPHA so the target ends up
+    // premultiplied and drawFrameBuffer() can composite it exactly.
+    uint64_t blendState(uint16_t view) const {
+        if (view < fbViews.size() && fbViews.test(view))
+            return BGFX_STATE_BLEND_FUNC_SEPARATE(BGFX_STATE_BLEND_SRC_ALPHA,
+                                                  BGFX_STATE_BLEND_INV_SRC_ALPHA,
+                                                  BGFX_STATE_BLEND_ONE,
+                                                  BGFX_STATE_BLEND_INV_SRC_ALPHA);
+        return BGFX_STATE_BLEND_ALPHA;
     }
     // Embedded (attach) mode: composite alpha-blends over the host's image
     // instead of an opaque blit. Set by Renderer::attach().
     bool embedded = false;
 
+    // ---- Embedded geometry budget (Renderer::attach, EmbeddedBudget) ----
+    // Arena buffers are refilled from the start every frame. Only the main
+    // record writes them (bgfx::update is API-thread only); recordParallel
+    // slices and everything unbatched go to the transient pool through
+    // allocTransient(), which books what UILO took there against
+    // transientBudget. Counters are atomic for the slices, latched in
+    // endFrame for getStats().
+    struct GeometryArena {
+        bgfx::DynamicVertexBufferHandle vb = BGFX_INVALID_HANDLE;
+        uint32_t capacity = 0;   // vertices
+        uint32_t used     = 0;
+    };
+    GeometryArena                  solidArena;
+    GeometryArena                  texArena;
+    bgfx::DynamicIndexBufferHandle arenaIb         = BGFX_INVALID_HANDLE;
+    uint32_t                       arenaIbCapacity = 0;
+    uint32_t                       arenaIbUsed     = 0;
+    uint32_t                       transientBudget = 0;   // bytes, 0 = no cap
+    std::atomic<uint32_t>          transientVbThisFrame{0};
+    std::atomic<uint32_t>          transientIbThisFrame{0};
+    std::atomic<uint32_t>          budgetDroppedThisFrame{0};
+    uint32_t transientVbLastFrame   = 0;
+    uint32_t transientIbLastFrame   = 0;
+    uint32_t arenaVbLastFrame       = 0;
+    uint32_t arenaIbLastFrame       = 0;
+    uint32_t budgetDroppedLastFrame = 0;
+    // Renderer::setHostBackdrop: the host's blurred scene, sampled by glass
+    // in place of blurFB_B and the ladder.
+    bgfx::TextureHandle hostBackdrop   = BGFX_INVALID_HANDLE;
+    Rectf               hostBackdropUv = {{0.f, 0.f}, {1.f, 1.f}};
+    bool usingHostBackdrop() const { return embedded && bgfx::isValid(hostBackdrop); }
+
+    bool createGeometryArena(const EmbeddedBudget& budget);
+    void destroyGeometryArena();
+    void beginGeometryFrame();
+    void latchGeometryFrame();
+    // bgfx's transient allocators with UILO's accounting and budget; false
+    // (the caller drops the draw) when the pool or the budget is out.
+    bool allocTransient(bgfx::TransientVertexBuffer* tvb, const bgfx::VertexLayout& layout, uint32_t numV,
+                        bgfx::TransientIndexBuffer* tib = nullptr, uint32_t numI = 0);
+    bool allocInstances(bgfx::InstanceDataBuffer* idb, uint32_t num, uint16_t stride);
+    // Puts a batch's vertices and indices on `enc`: in the arena when it
+    // has room, else in transient buffers. False when neither had.
+    bool setBatchGeometry(bgfx::Encoder* enc, bool textured, const void* verts, uint32_t numV,
+                          const uint16_t* idx, uint32_t numI);
+
     // ---- Deferred Material::Kind::* ("glass") draws ---------------------
     // drawGlass() captures here during the main render pass instead of
     // submitting immediately, so the blur ladder can run over a sceneFB
@@ -136,84 +736,385 @@ struct Renderer::Impl {
         bool        hasScissor = false;
         uint16_t    sx = 0, sy = 0, sw = 0, sh = 0;
     };
-    std::vector<DeferredGlass> deferredGlass;
-    bool                       replayingGlass = false;
-
-    // ---- Glass-pipeline bypass --------------------------------------------
-    // The full glass pipeline (render scene to sceneFB → blur ladder →
-    // composite back to backbuffer) costs an extra render-target switch,
-    // a fullscreen blit, and a clear per frame even when no glass element
-    // is on screen. We avoid all of that by predicting on each frame: if
-    // the previous frame had no glass draws, we bind view 0 directly to
-    // the backbuffer and skip the entire endFrame pipeline. Any glass
-    // call during a bypassed frame falls back to a flat tint and flips
-    // `hadGlassThisFrame` so the next frame uses the FB path again.
-    bool hadGlassLastFrame = false;
-    bool hadGlassThisFrame = false;
-    bool bypassSceneFb     = false;
+    // Replay: panels go into as few draws as possible. A panel joins the
+    // first batch with its scissor at or after the last batch holding a
+    // panel it overlaps, so only overlapping panels keep their order.
+    struct GlassBatch {
+        bool                  hasScissor = false;
+        uint16_t              sx = 0, sy = 0, sw = 0, sh = 0;
+        std::vector<uint32_t> items;   // indices into deferredGlass
+    };
+    std::vector<GlassBatch>  glassBatches;   // scratch, reused per frame
+    std::vector<GlassVertex> glassVerts;
+    std::vector<uint16_t>    glassIdx;
+    uint32_t                 glassPanelsLastFrame = 0;
+    uint32_t                 glassDrawsLastFrame  = 0;
+    void appendGlassQuad(const DeferredGlass& d, float W, float H);
+    // Submits deferredGlass into kGlassBgViewId. `mouse` / `sinceMove`
+    // feed the interactive kinds.
+    void replayDeferredGlass(float W, float H, Vec2f mouse, float sinceMove);
+
+    // ---- Frame graph (Renderer_FrameGraph.cpp) ----------------------------
+    // endFrame declares the pipeline as passes over a handful of resources
+    // and compiles it before anything is bound. bgfx only latches a view's
+    // framebuffer at bgfx::frame(), so targets can be picked after the
+    // scene was submitted:
+    //   - passes whose outputs nothing downstream reads are culled;
+    //   - when no kept pass samples the scene, it's drawn straight into
+    //     the output and the composite goes (no glass, or glass over a
+    //     reused blur). Embedded, the output is the host's image, which
+    //     the scene's clear would wipe, so the composite always stays;
+    //   - transient targets of one size whose lifetimes don't overlap
+    //     share an allocation (the ladder's first downsample reuses
+    //     blurFB_A once the V pass has read it).
+    enum FgResource : uint8_t {
+        FgScene,
+        FgBlurTemp,     // blurFB_A: H pass -> V pass
+        FgBlur,         // blurFB_B, kept across frames for blur reuse
+        FgLadderTemp,   // ladder level-1 downsample
+        FgLadder,       // ladderUp[0], kept like FgBlur
+        FgOutput,       // backbuffer, or the host's image when embedded
+        FgLayers,       // user framebuffers, imported as-is
+        FgResourceCount
+    };
+    static constexpr uint32_t fgBit(FgResource r) { return 1u << r; }
+    struct FgPass {
+        const char* name    = "";
+        uint32_t    samples = 0;    // fgBit()s read as textures
+        uint32_t    writes  = 0;
+        bool        copy    = false; // samples -> writes blit, elidable
+        bool        live    = false;
+        InlineFunction<void()> run;
+    };
+    std::vector<FgPass> fgPasses;
+    // Allocation each resource ended up on (itself unless aliased).
+    FgResource fgTarget[FgResourceCount] = {};
+    bool       ladderSharesBlurA = false;   // ladderDown[0] is blurFB_A
+    uint32_t   fgPassesLastFrame = 0;
+    bool       sceneDirectLastFrame = false;
+    void buildFrameGraph(uint32_t width, uint32_t height, Vec2f mouse, float sinceMove);
+    void compileFrameGraph();
+    void executeFrameGraph(uint32_t width, uint32_t height);
+    // Binds the scene and glass views to `fb` (invalid = backbuffer).
+    void bindSceneViews(bgfx::FrameBufferHandle fb, uint32_t width, uint32_t height);
+    // Ladder depth this frame's Material::Blur radii need (0 = none).
+    uint8_t wantedLadderLevels(uint32_t width, uint32_t height) const;
+
+    // Latched for Renderer::isAnimating().
+    bool animatedLastFrame = false;
+    // Viewport-culled element counts (Renderer::countCulled), latched the
+    // same way for getStats(), and draws rejectDraw() dropped.
+    uint32_t culledLastFrame   = 0;
+    uint32_t rejectedLastFrame = 0;
+    // Submit and flush counts, latched the same way.
+    uint32_t batchedSubmitsLastFrame   = 0;
+    uint32_t immediateSubmitsLastFrame = 0;
+    uint32_t flushesLastFrame[(size_t)FlushReason::Count] = {};
+    // Per-view profiler timings in getStats() (Renderer::setPassTimings),
+    // and the most transient VB / IB bytes any frame has used.
+    bool     passTimings     = false;
+    uint32_t transientVbPeak = 0;
+    uint32_t transientIbPeak = 0;
+
+    // ---- Blur reuse across frames -----------------------------------------
+    // Everything submitted to kSceneViewId (batched vertices, clip state,
+    // textures, uniforms) is folded into sceneHash as it flushes. endFrame
+    // adds the glass layout; when the result matches the frame the blur
+    // last ran for, blurFB_B and the ladder already hold what the passes
+    // would produce and they are skipped. Animated kinds read `elapsed` in
+    // fs_glass at replay time, so they keep moving over a reused blur.
+    // Contents the hash can't see (texture uploads, Geometry updates, a
+    // framebuffer re-rendered this frame) bump contentGeneration or are
+    // keyed by touchedViews instead.
+    static constexpr uint64_t kHashBasis = 1469598103934665603ull;
+    uint64_t         blurHash          = 0;
+    bool             blurValid         = false;   // blurHash describes blurFB_B
+    bool             blurReusedLastFrame = false;
+    uint64_t&        contentGeneration = shared->contentGeneration;
+    void hashScene(uint16_t view, const void* data, size_t bytes) {
+        RecordState& r = rs();
+        if (view != r.sceneView) {
+            if (view < r.touchedViews.size()) r.touchedViews.set(view);
+            return;
+        }
+        r.sceneHash = hashBytes(r.sceneHash, data, bytes);
+    }
+    // FNV-1a, a word at a time: change detection, not identity.
+    static uint64_t hashBytes(uint64_t h, const void* data, size_t bytes) {
+        const uint8_t* p = (const uint8_t*)data;
+        size_t i = 0;
+        for (; i + 4 <= bytes; i += 4) {
+            uint32_t w;
+            std::memcpy(&w, p + i, 4);
+            h ^= w; h *= 1099511628211ull;
+        }
+        for (; i < bytes; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+        return h;
+    }
+    // sceneHash plus everything else the blur passes read: target size,
+    // glass regions, and the ladder depth inputs.
+    uint64_t blurInputsHash(uint32_t width, uint32_t height) const;
+    template <class T> void hashSceneValue(uint16_t view, const T& v) { hashScene(view, &v, sizeof(T)); }
 
     // ---- Scissor stack ----
-    struct ScissorEntry { uint16_t x, y, w, h; };
+    // A soft entry was pushed for an indexed-clip node, which does its
+    // clipping; batches only apply the nearest hard entry (batchScissor).
+    struct ScissorEntry { uint16_t x, y, w, h; bool soft = false; };
     static constexpr int            kMaxScissor = 64;
-    ScissorEntry                    scissorStack[kMaxScissor]{};
-    int                             scissorTop = 0;
-    int                             scissorOverflowDepth = 0;
 
     // ---- Rounded-rect clip stack (SDF in fragment shaders) ----
-    struct RoundClipEntry { float cx, cy, halfW, halfH, radius; };
+    // `node` is the indexed-clip node in effect from this entry on (0 when
+    // indexed clips are off).
+    struct RoundClipEntry { float cx, cy, halfW, halfH, radius; uint32_t node = 0; };
     static constexpr int            kMaxRoundClip = 64;
-    RoundClipEntry                  roundClipStack[kMaxRoundClip]{};
-    int                             roundClipTop = 0;
-    int                             roundClipOverflowDepth = 0;
+
+    // ---- Indexed clips (Renderer::setIndexedClips) -------------------------
+    // Every round clip, rounded or not, is interned as a node {rect, radius,
+    // parent} and mirrored into clipTableTex (RGBA32F, two texels a node).
+    // Batched vertices carry their innermost node (PosColorVertex::clip,
+    // ShapeInstance params[3]) and the clip shaders walk its parents, so a
+    // clip push changes neither the clip uniforms (left "off" for batches)
+    // nor the batch's scissor: clips nest to any depth and stop breaking
+    // batches. Node ids stay valid for a clipGeneration; beginFrame starts
+    // a new one once the table is half full, never mid-frame, since queued
+    // vertices still name the old ids. Pushes that find the table full or
+    // the chain at kClipChainMax keep a plain hard scissor instead.
+    static constexpr uint32_t kClipTableWidth  = 256;   // texels per row
+    static constexpr uint32_t kClipTableHeight = 128;
+    static constexpr uint32_t kClipTableNodes  = kClipTableWidth * kClipTableHeight / 2;
+    static constexpr uint32_t kClipChainMax    = 16;    // UILO_CLIP_CHAIN_MAX
+    struct ClipNode { float cx, cy, halfW, halfH, radius; uint32_t parent; };
+    bool                                   clipTableSupported = false;   // caps + texture OK
+    bool                                   clipTableWanted    = false;
+    bool                                   clipTableOn        = false;   // latched per frame
+    bgfx::TextureHandle                    clipTableTex = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle                    s_clipTable  = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle                    u_clipTable  = BGFX_INVALID_HANDLE;
+    std::vector<ClipNode>                  clipNodes;       // [0] = unclipped
+    std::vector<uint8_t>                   clipNodeDepth;
+    std::unordered_map<uint64_t, uint32_t> clipNodeIds;     // content hash -> id
+    std::vector<float>                     clipTableData;   // texture mirror
+    uint32_t                               clipNodesUploaded = 1;
+    uint32_t                               clipGeneration    = 0;
+    bool                                   clipTableFullWarned = false;
+    void     initClipTable();
+    void     destroyClipTable();
+    // Id of `n` (appended when new) or 0 when it can't be represented.
+    // Takes the cache lock.
+    uint32_t internClipNode(const ClipNode& n);
+    void     beginClipTableFrame();
+    void     uploadClipTable();
+    // The node batched vertices recorded now are masked by.
+    uint32_t clipNodeId() const {
+        const auto& r = rs();
+        return r.roundClipTop > 0 ? r.roundClipStack[r.roundClipTop - 1].node : 0u;
+    }
+    // Bind the table for a batched submit (a no-op while unsupported).
+    void bindClipTable();
+    // Scissor a batch recorded now is drawn under, nullptr for none.
+    const ScissorEntry* batchScissor() const {
+        const auto& r = rs();
+        for (int i = r.scissorTop - 1; i >= 0; --i)
+            if (!r.scissorStack[i].soft) return &r.scissorStack[i];
+        return nullptr;
+    }
+
+    // ---- Cached layers (Renderer::beginLayer / endLayer) ------------------
+    // A layer starts with empty clip stacks so its contents don't depend on
+    // the parent's clip; the parent's stacks are parked here meanwhile.
+    // viewOrigin is the scene point mapped to the current target's (0,0);
+    // pushScissor() subtracts it, round clips stay in scene space (the clip
+    // shaders compare against untransformed positions). layerTainted is set
+    // by draws that can't live in a layer (glass).
+    struct LayerSave {
+        ScissorEntry   scissorStack[kMaxScissor];
+        int            scissorTop;
+        int            scissorOverflowDepth;
+        RoundClipEntry roundClipStack[kMaxRoundClip];
+        int            roundClipTop;
+        int            roundClipOverflowDepth;
+        Vec2f          viewOrigin;
+        bool           tainted;
+    };
 
     // Last clip uniform values actually pushed to bgfx. Used to dedup
     // setUniform calls when consecutive draws share the same clip state.
-    float lastClipRect[4]    = { 1e30f, 0.f, 0.f, 0.f };
-    float lastClipParams[4]  = { 1e30f, 0.f, 0.f, 0.f };
-    float lastClipRect2[4]   = { 1e30f, 0.f, 0.f, 0.f };
-    float lastClipParams2[4] = { 1e30f, 0.f, 0.f, 0.f };
-    bool  lastClipValid      = false;
 
     // ---- Effective round-clip uniform cache -------------------------------
     // The four vec4s the fragment-shader clip needs for the CURRENT
     // round-clip stack (top-most two radius>0 entries). push/popRoundClip
     // bump clipVersion; refreshClipCache() recomputes lazily so repeated
     // draws under an unchanged stack don't re-walk it.
-    float    curClipRect[4]    = {0.f, 0.f, 0.f, 0.f};
-    float    curClipParams[4]  = {0.f, 0.f, 0.f, 0.f};
-    float    curClipRect2[4]   = {0.f, 0.f, 0.f, 0.f};
-    float    curClipParams2[4] = {0.f, 0.f, 0.f, 0.f};
-    uint32_t clipVersion    = 1;
-    uint32_t curClipVersion = 0;
     void refreshClipCache();
 
-    // ---- Solid-rect batch ------------------------------------------------
-    // All `draw(Rect&)` calls sharing the same view + scissor + round-clip
-    // state get coalesced into a single transient vertex buffer + submit.
+    // ---- Batch state snapshot ---------------------------------------------
+    // View + scissor + round-clip state a queued batch was recorded under. By
+    // flush time the live stacks may have moved on, so the flush applies
+    // this snapshot, never the current stacks.
+    struct BatchState {
+        uint16_t     view           = UINT16_MAX;
+        ScissorEntry scissor{};
+        bool         hasScissor     = false;
+        float        clipRect[4]    = {0.f, 0.f, 0.f, 0.f};
+        float        clipParams[4]  = {0.f, 0.f, 0.f, 0.f};
+        float        clipRect2[4]   = {0.f, 0.f, 0.f, 0.f};
+        float        clipParams2[4] = {0.f, 0.f, 0.f, 0.f};
+    };
+    bool batchStateMatches(const BatchState& st, uint16_t viewId);
+    void captureBatchState(BatchState& st, uint16_t viewId);
+    // Fold a batch's (or the live) scissor + clip state into sceneHash.
+    void hashSceneState(const BatchState& st) {
+        if (!isSceneView(st.view)) { hashScene(st.view, nullptr, 0); return; }
+        hashSceneValue(st.view, st.hasScissor);
+        if (st.hasScissor) {
+            const uint16_t sc[4] = { st.scissor.x, st.scissor.y, st.scissor.w, st.scissor.h };
+            hashScene(st.view, sc, sizeof(sc));
+        }
+        hashScene(st.view, st.clipRect,    sizeof(st.clipRect));
+        hashScene(st.view, st.clipParams,  sizeof(st.clipParams));
+        hashScene(st.view, st.clipRect2,   sizeof(st.clipRect2));
+        hashScene(st.view, st.clipParams2, sizeof(st.clipParams2));
+        // Node ids in the vertices mean the same rects for a generation.
+        if (clipTableOn) hashSceneValue(st.view, clipGeneration);
+    }
+    // What an immediate submit applies (applyScissor): the top scissor,
+    // soft or not, and the live clip uniforms.
+    void hashSceneLiveState(uint16_t view) {
+        if (!isSceneView(view)) { hashScene(view, nullptr, 0); return; }
+        const auto& r = rs();
+        BatchState st;
+        st.view       = view;
+        st.hasScissor = r.scissorTop > 0;
+        if (st.hasScissor) st.scissor = r.scissorStack[r.scissorTop - 1];
+        refreshClipCache();
+        std::memcpy(st.clipRect,    r.curClipRect,    sizeof(st.clipRect));
+        std::memcpy(st.clipParams,  r.curClipParams,  sizeof(st.clipParams));
+        std::memcpy(st.clipRect2,   r.curClipRect2,   sizeof(st.clipRect2));
+        std::memcpy(st.clipParams2, r.curClipParams2, sizeof(st.clipParams2));
+        hashSceneState(st);
+    }
+    // Bind a snapshot's scissor + clip uniforms for the upcoming submit.
+    void applyBatchState(const BatchState& st);
+
+    // Flush before a batch crosses the 16-bit index range.
+    static constexpr uint32_t kBatchMaxVerts = 65532;
+
+    // ---- Solid shape batch -----------------------------------------------
+    // Every solidProgram shape (Rect, RoundedRect, Circle, Triangle, Line,
+    // drawLines, drawArc) sharing the same view + scissor + round-clip state
+    // gets coalesced into a single transient vertex buffer + submit.
     // Flushing is lazy: scissor/round-clip push+pop do NOT flush; instead
-    // draw(Rect) compares the current state against the snapshot below and
-    // flushes only on a real mismatch, so push/pop cycles between rects that
-    // resolve to the same state (e.g. per-child pushRoundClip of the same
-    // container bounds) keep extending one batch. Every immediate-mode
-    // submit path still flushes first to preserve draw order. Rotation never
-    // flushes at all — it's baked into vertices at append time.
-    std::vector<PosColorVertex> solidBatchVerts;
-    std::vector<uint16_t>       solidBatchIdx;
-    uint16_t                    solidBatchView = UINT16_MAX;
-
-    // Scissor + round-clip snapshot the queued rects were recorded under. By
-    // flush time the live stacks may have moved on, so flushSolidBatch()
-    // applies this snapshot, never the current stacks.
-    ScissorEntry batchScissor{};
-    bool         batchHasScissor    = false;
-    float        batchClipRect[4]    = {0.f, 0.f, 0.f, 0.f};
-    float        batchClipParams[4]  = {0.f, 0.f, 0.f, 0.f};
-    float        batchClipRect2[4]   = {0.f, 0.f, 0.f, 0.f};
-    float        batchClipParams2[4] = {0.f, 0.f, 0.f, 0.f};
-    bool batchStateMatches(uint16_t viewId);
-    void captureBatchState(uint16_t viewId);
-
-    // ---- Affine rotation (applied CPU-side to draw vertices) -------------
+    // reserveSolidBatch() compares the current state against the snapshot
+    // below and flushes only on a real mismatch, so push/pop cycles between
+    // shapes that resolve to the same state (e.g. per-child pushRoundClip of
+    // the same container bounds) keep extending one batch. Shapes are
+    // appended in call order, so draw order within a batch is preserved;
+    // every other submit path (images, glass) flushes first.
+    // Transforms never flush at all — they're baked into vertices at append
+    // time.
+    // Make room for `numVerts` more vertices recorded under the current
+    // state, flushing on a state mismatch or index overflow. Returns the
+    // base vertex index the caller's indices are relative to.
+    uint16_t reserveSolidBatch(uint16_t viewId, uint32_t numVerts);
+    // Append one axis-aligned quad (TL, TR, BR, BL colors; mapped through
+    // xformPt). `gradient` adds an average-color center vertex + fan.
+    void appendSolidQuad(uint16_t viewId, float x, float y, float w, float h,
+                         Color cTL, Color cTR, Color cBR, Color cBL,
+                         bool gradient);
+    // appendSolidQuad with a 1px coverage ramp (analytic AA): an inner
+    // quad inset half a pixel at full alpha and an outer ring outset half
+    // a pixel at zero. Pixel-aligned quads skip the ring.
+    void appendFeatheredQuad(uint16_t viewId, float x, float y, float w, float h, Color c);
+    // Rounded rect as geometry in the solid batch, for when instanced
+    // shapes are off: a fan over four corner arcs taken from a shared unit
+    // table (segment count bucketed by radius), inset half a pixel, plus a
+    // ring outset half a pixel at zero alpha for AA. No round clip is
+    // pushed, so it batches with the quads around it.
+    void appendRoundedFan(uint16_t viewId, float x, float y, float w, float h, float radius,
+                          Color cTL, Color cTR, Color cBR, Color cBL, bool gradient);
+
+    // ---- Text batch ------------------------------------------------------
+    // Glyph quads from consecutive drawText calls that sample the same atlas
+    // under the same view + scissor + round-clip state, coalesced into one
+    // textProgram submit. Same lazy-flush rules as the solid batch. At most
+    // one of the two batches is non-empty at any time (appending to one
+    // flushes the other), which keeps shapes and text in call order.
+    // Bitmap and SDF glyphs use different programs, so switching breaks it.
+    uint16_t reserveTextBatch(uint16_t viewId, bgfx::TextureHandle atlas,
+                              bgfx::ProgramHandle program, uint32_t numVerts);
+
+    // ---- Instanced shape batch -------------------------------------------
+    // With instancing available, Rect / RoundedRect / Circle skip the solid
+    // batch: each becomes one ShapeInstance drawn over a static unit quad,
+    // and vs_shape / fs_shape expand it, the shape's own rounded mask
+    // included. A rounded shape therefore no longer pushes a round clip of
+    // its own, so neighbouring rounded shapes share a submit instead of
+    // each breaking the batch. Same lazy-flush rules as the other batches,
+    // and of the three at most one is non-empty. The transform is applied in
+    // the vertex shader, so it is batch state here (shapeBatchXform) rather
+    // than baked in.
+    static constexpr uint32_t  kShapeBatchMax = 16384;
+    bool&                      shapeInstancing = shared->shapeInstancing;   // caps + program OK
+    bool                       shapeInstancingEnabled = true;
+    bgfx::VertexLayout&        quadLayout = shared->quadLayout;
+    bgfx::VertexBufferHandle&  unitQuadVb = shared->unitQuadVb;
+    bgfx::IndexBufferHandle&   unitQuadIb = shared->unitQuadIb;
+    void initShapeInstancing(bgfx::RendererType::Enum type);
+    bool useShapeInstancing() const { return shapeInstancing && shapeInstancingEnabled; }
+
+    // ---- Analytic edge AA (Renderer::setAnalyticAA) ------------------------
+    // Rect edges get a 1px coverage ramp, so shapes stay smooth with MSAA
+    // off: instanced rects are masked in fs_shape (radius < 0 asks for the
+    // box ramp, with a pixel of quad padding), solid-batch rects through
+    // appendFeatheredQuad. Pixel-aligned rects come out identical either
+    // way. Rounded shapes and circles already antialias through their SDF
+    // masks, lines and arcs through alpha skirts.
+    bool analyticAA = true;
+    void appendShape(uint16_t viewId, float x, float y, float w, float h,
+                     float radius, float pad,
+                     Color cTL, Color cTR, Color cBR, Color cBL);
+    // Same, filled from a baked stop ramp instead of the corner colors.
+    void appendRampShape(uint16_t viewId, float x, float y, float w, float h,
+                         float radius, float pad, const GradientRamp& ramp);
+    void flushShapeBatch(FlushReason why = FlushReason::Explicit);
+    // Instance memory ran out: the queued shapes go out as plain solid-batch
+    // quads instead (square corners, ramps dropped) so the frame keeps them.
+    void replayShapesSolid(FlushReason why);
+
+    // ---- Gradient table ----
+    // Linear / radial ramps, one kGradientLutWidth-texel RGBA8 row each,
+    // sampled by fs_shape (whose UILO_GRADIENT_LUT_* must match). Rows
+    // are baked on demand, shared by identical ramps, and recycled least
+    // recently used once all kGradientLutRows are taken; never one baked
+    // this frame. A recycled row bumps gradientEvictions, which retires
+    // draw lists that point at it.
+    static constexpr uint16_t kGradientLutWidth = 256;
+    static constexpr uint16_t kGradientLutRows  = 64;
+    bgfx::TextureHandle&                    gradientLut = shared->gradientLut;
+    bgfx::UniformHandle&                    s_gradientLut = shared->s_gradientLut;
+    std::vector<uint8_t>&                   gradientLutPixels = shared->gradientLutPixels;
+    std::vector<GradientLutRow>&            gradientRows = shared->gradientRows;
+    std::unordered_map<uint64_t, uint16_t>& gradientRowByKey = shared->gradientRowByKey;
+    uint16_t&                               gradientDirty0 = shared->gradientDirty0;
+    uint16_t&                               gradientDirty1 = shared->gradientDirty1;
+    uint32_t&                               gradientEvictions = shared->gradientEvictions;
+    // Row holding the ramp, baking it if needed; UINT16_MAX when every row
+    // is in use this frame.
+    uint16_t gradientRow(const GradientRampStop* stops, size_t count);
+    void     uploadGradientLut();    // dirty rows, from endFrame
+    void     bindGradientLut();      // with each shape batch
+    void     destroyGradientLut();
+
+    // ---- Retained draw-list recording --------------------------------------
+    // Every batch flush while recordingLists is non-empty is copied into each
+    // active list, so replayed geometry merged into an enclosing recording
+    // is captured too. Any other submit path calls flushBatches() first,
+    // which taints the active recordings.
+    void recordFlush(bool text, const BatchState& st, bgfx::ProgramHandle program,
+                     bgfx::TextureHandle atlas);
+    void recordShapeFlush();
+
+    // ---- Transform stack + rotation (applied CPU-side to batched vertices)
     // Convention: degrees, +x at 0, +y at 90 (matches a (cos t, sin t)
     // direction vector in screen-pixel coords).
     struct RotState {
@@ -224,40 +1125,384 @@ struct Renderer::Impl {
         float sinA    = 0.f;
         bool  enabled = false;
     };
-    RotState rotation;
-
-    // Rotate a screen-space point around the current pivot. Identity when
-    // rotation is disabled, so callers can pipe every emitted vertex through
-    // this without a branch at each call site.
-    inline void rotPt(float& x, float& y) const {
-        if (!rotation.enabled) return;
-        const float dx = x - rotation.pivotX;
-        const float dy = y - rotation.pivotY;
-        x = rotation.pivotX + dx * rotation.cosA - dy * rotation.sinA;
-        y = rotation.pivotY + dx * rotation.sinA + dy * rotation.cosA;
+
+    // pushTransform saves the level it replaces; each level owns its own
+    // setRotation state, with the pivot in that level's local space.
+    struct XformLevel { Transform2D xform; RotState rotation; };
+    // Recompute `effective` / `xformOn` after xform or rotation changes.
+    void updateEffectiveXform();
+
+    // Map a local point to screen space through the current transform.
+    // Identity when nothing is set, so callers can pipe every emitted
+    // vertex through this without a branch at each call site.
+    inline void xformPt(float& x, float& y) const {
+        const RecordState& r = rs();
+        if (!r.xformOn) return;
+        const Transform2D& e = r.effective;
+        const float nx = e.a * x + e.c * y + e.tx;
+        y = e.b * x + e.d * y + e.ty;
+        x = nx;
     }
 
+    // Clips follow the pushed transforms but not setRotation, which never
+    // moved clips. Translate + scale maps a clip rect exactly; anything
+    // else clips to the screen bounds of the mapped rect. Radii scale by
+    // the transform's mean scale.
+    Rectf clipToScreen(Rectf b) const;
+    float clipRadiusScale() const;
+    // True when local rect b, grown by pad on every side, maps (through
+    // the full transform, rotation included) wholly outside the scissor:
+    // the GPU would discard every fragment, so the draw is dropped and
+    // counted instead. Edge-touching bounds are outside, as for the GPU.
+    bool rejectDraw(Rectf b, float pad = 0.f);
+
+    // ---- Recording state ----------------------------------------------------
+    // Everything a draw call reads or writes besides the shared caches: the
+    // clip stacks, batches, transforms, view stack and what the frame
+    // graph gathers from the scene. The main thread records into
+    // mainRecord; Renderer::recordParallel() gives every slice its own, so
+    // slices on different threads never share any of it. rs() is the one
+    // the calling thread is recording into.
+    struct RecordState {
+        const Impl*                 owner = nullptr;
+        // bgfx::begin() on the main thread hands out the implicit encoder,
+        // so mainRecord's submits land exactly where the free functions'
+        // would; slices get one of their own.
+        bgfx::Encoder*              encoder = nullptr;
+        // Where the scene and glass-subtree content goes: kSceneViewId /
+        // kGlassChildViewId for mainRecord until a parallel recording
+        // moves it past the slices (see sliceSceneViews).
+        uint16_t                    sceneView      = UINT16_MAX;
+        uint16_t                    glassChildView = UINT16_MAX;
+        struct ViewEntry { uint16_t viewId; };
+        static constexpr int        kMaxViewStack = 16;
+        ViewEntry                   viewStack[kMaxViewStack] = {};
+        int                         viewStackTop = 0;
+        // setView* calls a slice made; only the API thread may issue them,
+        // so they run when the slices are joined.
+        std::vector<InlineFunction<void()>> viewOps;
+
+        ScissorEntry                scissorStack[kMaxScissor]{};
+        int                         scissorTop = 0;
+        int                         scissorOverflowDepth = 0;
+        RoundClipEntry              roundClipStack[kMaxRoundClip]{};
+        int                         roundClipTop = 0;
+        int                         roundClipOverflowDepth = 0;
+        std::vector<LayerSave>      layerStack;
+        Vec2f                       viewOrigin   = {0.f, 0.f};
+        bool                        layerTainted = false;
+
+        // Uniforms are per encoder, and so is their dedup.
+        float lastClipRect[4]    = { 1e30f, 0.f, 0.f, 0.f };
+        float lastClipParams[4]  = { 1e30f, 0.f, 0.f, 0.f };
+        float lastClipRect2[4]   = { 1e30f, 0.f, 0.f, 0.f };
+        float lastClipParams2[4] = { 1e30f, 0.f, 0.f, 0.f };
+        bool  lastClipValid      = false;
+        float    curClipRect[4]    = {0.f, 0.f, 0.f, 0.f};
+        float    curClipParams[4]  = {0.f, 0.f, 0.f, 0.f};
+        float    curClipRect2[4]   = {0.f, 0.f, 0.f, 0.f};
+        float    curClipParams2[4] = {0.f, 0.f, 0.f, 0.f};
+        uint32_t clipVersion    = 1;
+        uint32_t curClipVersion = 0;
+
+        std::vector<PosColorVertex>   solidBatchVerts;
+        std::vector<uint16_t>         solidBatchIdx;
+        BatchState                    solidBatch;
+        std::vector<PosColorUvVertex> textBatchVerts;
+        std::vector<uint16_t>         textBatchIdx;
+        BatchState                    textBatch;
+        bgfx::TextureHandle           textBatchAtlas   = BGFX_INVALID_HANDLE;
+        bgfx::ProgramHandle           textBatchProgram = BGFX_INVALID_HANDLE;
+        std::vector<ShapeInstance>    shapeBatch;
+        BatchState                    shapeBatchState;
+        Transform2D                   shapeBatchXform;
+        bool                          shapeBatchRamps = false;   // samples the gradient table
+        std::vector<DrawList::Data*>  recordingLists;
+        // drawText's copy of a shaped run, taken under the cache lock.
+        std::vector<TextRunQuad>         textQuads;
+        std::vector<bgfx::TextureHandle> textPages;
+        ArcMesh                       arcScratch;
+        std::vector<Vec2f>            polylineScratch;   // drawPolyline's deduplicated points
+
+        RotState                rotation;
+        std::vector<XformLevel> xformStack;
+        Transform2D             xform;        // product of the pushed transforms
+        Transform2D             effective;    // xform * rotation: what vertices go through
+        bool                    xformOn = false;
+
+        // Folded into the frame's totals in slice order at the join.
+        uint64_t                   sceneHash = kHashBasis;
+        std::bitset<256>           touchedViews;      // non-scene views drawn this frame
+        std::vector<DeferredGlass> deferredGlass;
+        bool                       animatedThisFrame = false;
+        uint32_t                   culledThisFrame   = 0;
+        uint32_t                   rejectedThisFrame = 0;
+        uint32_t                   batchedSubmits    = 0;   // batch flushes
+        uint32_t                   immediateSubmits  = 0;   // draws bypassing the batches
+        uint32_t                   flushes[(size_t)FlushReason::Count] = {};
+#if UILO_PROFILER
+        uint32_t                   verticesQueued    = 0;   // Renderer::getProfileCounters
+#endif
+        // An encoder couldn't be had on the worker; the slice is recorded
+        // on the main thread after the others instead.
+        bool                       retryOnMain = false;
+    };
+    RecordState mainRecord;
+    static inline thread_local RecordState* t_record = nullptr;
+    RecordState&       rs()       { return t_record && t_record->owner == this ? *t_record : mainRecord; }
+    const RecordState& rs() const { return t_record && t_record->owner == this ? *t_record : mainRecord; }
+    bgfx::Encoder* enc() {
+        RecordState& r = rs();
+        if (!r.encoder) r.encoder = bgfx::begin();
+        return r.encoder;
+    }
+    bool isSceneView(uint16_t view) const { return view == rs().sceneView; }
+    // Runs f now on the main thread, or at the join from a slice.
+    template <class F> void onApiThread(F&& f) {
+        RecordState& r = rs();
+        if (&r == &mainRecord) f();
+        else                   r.viewOps.emplace_back(std::forward<F>(f));
+    }
+
+    // ---- Parallel recording (Renderer::recordParallel) ---------------------
+    // Each slice draws into a scene view and a glass-subtree view of its
+    // own, taken once from the overflow range and kept. bgfx::setViewOrder
+    // slots the ones used this frame right after kSceneViewId and
+    // kGlassChildViewId, in slice order, so the stitched frame sorts
+    // exactly as if the slices had been recorded one after another.
+    // mainRecord moves on to a fresh pair after the join, so whatever is
+    // drawn afterwards stays on top.
+    std::vector<uint16_t>    sliceSceneViews;
+    std::vector<uint16_t>    sliceGlassViews;
+    std::vector<uint16_t>    sliceViewOrder;   // scratch for setViewOrder
+    uint32_t                 slicesUsed      = 0;   // pairs handed out this frame
+    uint32_t                 slicesLastFrame = 0;
+    uint32_t                 parallelSlicesThisFrame = 0;
+    uint32_t                 parallelSlicesLastFrame = 0;
+    std::vector<std::unique_ptr<RecordState>> sliceRecords;
+    // Caches draw calls share (fonts, shaped runs, glyph and image atlases,
+    // textures, arc meshes, framebuffer pool) are only locked while slices
+    // are recording.
+    std::recursive_mutex&    cacheMutex = shared->cacheMutex;
+    bool                     parallelRecording = false;
+    struct CacheLock {
+        explicit CacheLock(Impl& impl)
+            : m(impl.parallelRecording ? &impl.cacheMutex : nullptr) { if (m) m->lock(); }
+        ~CacheLock() { if (m) m->unlock(); }
+        CacheLock(const CacheLock&) = delete;
+        CacheLock& operator=(const CacheLock&) = delete;
+        std::recursive_mutex* m;
+    };
+    // A slice record starting from `from`'s clip, transform and view origin.
+    void beginSliceRecord(RecordState& r, const RecordState& from, uint16_t sceneView,
+                          uint16_t glassChildView);
+    // Folds a finished slice into mainRecord and replays its view ops.
+    void mergeSliceRecord(RecordState& r);
+    // Slots this frame's slice views in after the views they extend.
+    void orderSliceViews();
+
     // ---- Texture cache ----
-    // path -> Texture
-    std::unordered_map<std::string, Texture> textureCache;
+    // textureKey -> texture. Over textureBudget bytes (0 = unlimited), trimTextures
+    // evicts unreferenced entries, least recently used first.
+    static constexpr uint32_t                kFailedTextureMaxAge = 600;
+    std::unordered_map<std::string, TextureEntry>& textureCache = shared->textureCache;
+    uint64_t&                                textureBudget = shared->textureBudget;
+    uint64_t&                                textureBytes = shared->textureBytes;   // resident in textureCache
+    uint64_t&                                textureEvictions = shared->textureEvictions;
+    // A plain load is keyed by its path; a resampled or mip-mapped one by
+    // path plus options, so each variant is cached (and evicted) on its own.
+    static std::string textureKey(const std::string& path, const TextureLoadOptions& opts);
+    // Caches tex (`bytes` of GPU memory) under key and returns it. If the
+    // key is already cached the first entry wins and tex is destroyed.
+    Texture cacheTexture(const std::string& key, const Texture& tex, uint64_t bytes,
+                         bool atlased = false);
+    void trimTextures();
+    // loadTextureAsync keys queued or decoded but not yet uploaded; a key
+    // is in at most one of this and textureCache.
+    static constexpr size_t                  kTextureUploadBudget = 16u << 20;  // bytes per frame
+    std::unordered_set<std::string>&         texturesPending = shared->texturesPending;
+    TextureDecodeQueue&                      textureDecoder = shared->textureDecoder;
+    std::vector<TextureDecodeQueue::Result>& textureUploads = shared->textureUploads;   // decoded, awaiting upload
+    // Uploads decoded images into textureCache, up to kTextureUploadBudget
+    // bytes per call (always at least one). Called from beginFrame.
+    void pumpTextureUploads();
+    // Uploads a decode (atlas first when it's small enough) and caches it.
+    Texture uploadDecodedTexture(const std::string& key, const TextureDecodeQueue::Result& r);
+
+    // ---- Glyph prewarming ----
+    // prewarmFont batches, baked off-thread and packed into the atlas by
+    // pumpGlyphBakes from beginFrame, up to kGlyphUploadBudget bitmap bytes
+    // per frame.
+    static constexpr size_t                  kGlyphUploadBudget = 1u << 20;
+    GlyphBakeQueue&                          glyphBaker = shared->glyphBaker;
+    std::vector<GlyphBakeQueue::Result>&     glyphUploads = shared->glyphUploads;
+    size_t&                                  glyphUploadNext = shared->glyphUploadNext;  // next glyph of glyphUploads[0]
+    void pumpGlyphBakes();
+
+    // ---- Image atlas ----
+    // Mip-less images no larger than imageAtlasMaxSize on either side are
+    // packed into shared pages rather than given a texture each; their
+    // Texture carries the page handle plus the image's uv rect. Up to
+    // kImageAtlasMaxPages pages, then images get their own textures again.
+    static constexpr int            kImageAtlasPageSize = 1024;
+    static constexpr size_t         kImageAtlasMaxPages = 4;
+    uint16_t&                       imageAtlasMaxSize = shared->imageAtlasMaxSize;   // 0 = atlas off
+    std::vector<ImageAtlasPage>&    imageAtlasPages = shared->imageAtlasPages;
+    // Copies rgba (w x h) into a page, edge texels extruded by one so
+    // filtering never picks up a neighbour. False when it doesn't fit.
+    bool packImageAtlas(const uint8_t* rgba, uint16_t w, uint16_t h, Texture& out);
+    void writeImageAtlasRect(bgfx::TextureHandle page, uint16_t x, uint16_t y,
+                             const uint8_t* rgba, uint16_t w, uint16_t h);
+    bool isImageAtlasPage(uint16_t handle) const;
+    void destroyImageAtlas();
 
     // ---- Font cache ----
     // path -> font index; faces stored sparsely per requested pixel size
-    struct FontRecord {
-        std::vector<uint8_t> ttfData;
-        // map keyed by integer pixel height
-        std::unordered_map<int, FontFace> sizes;
-    };
-    std::vector<FontRecord>                 fonts;
-    std::unordered_map<std::string, uint32_t> fontByPath;
+    using FontRecord = uilo::FontRecord;
+    std::deque<FontRecord>&                 fonts = shared->fonts;
+    std::unordered_map<std::string, uint32_t>& fontByPath = shared->fontByPath;
+    // loadFont without the lock; falls back to the embedded font on failure.
+    Font loadFontRecord(const std::string& path, bool sdf);
+    // The font in fontId's fallback chain that has `codepoint`: fontId
+    // itself when it does or when none does. May load a fallback, so it
+    // can grow `fonts`; records and faces already held stay valid.
+    uint32_t resolveFont(uint32_t fontId, uint32_t codepoint);
+
+    // ---- Shared glyph atlas ----
+    // Pages are created on demand up to glyphAtlasBudget bytes; past that the
+    // least-recently-used page not touched this frame is wiped and reused.
+    // A page touched this frame is never evicted, since glyph quads already
+    // queued this frame still sample it.
+    static constexpr int            kGlyphPageSize = 1024;
+    // Bake size for SDF faces; big enough that distance fields stay accurate
+    // when magnified a few times, small enough to keep many glyphs per page.
+    static constexpr int            kSdfBasePx     = 48;
+    std::vector<GlyphAtlasPage>&    glyphPages = shared->glyphPages;
+    size_t&                         glyphAtlasBudget = shared->glyphAtlasBudget;
+    uint32_t&                       glyphAtlasEvictions = shared->glyphAtlasEvictions;
+    // Bumped every beginFrame; drives atlas LRU.
+    uint32_t&                       frameIndex = shared->frameIndex;
+    // Find room for a w x h bitmap; returns false when every page is full and
+    // nothing can be evicted. Outputs page slot + top-left.
+    bool allocGlyphRect(int w, int h, uint16_t& page, uint16_t& x, uint16_t& y);
+    // Uploads each page's dirty rect from its shadow. Called from endFrame.
+    void uploadGlyphAtlas();
+    // Destroy pages beyond the budget that weren't used this frame.
+    void trimGlyphAtlas();
+    void destroyGlyphAtlas();
+
+    // ---- Shaped-run cache ----
+    // Keyed by hash(text, font, size); a colliding key is simply rebuilt.
+    // Runs unused for kTextRunMaxAge frames are dropped once the cache holds
+    // more than kTextRunCacheSoftMax entries (typing into a Textbox mints a
+    // new string per keystroke). Hit/miss counters are cumulative.
+    static constexpr size_t         kTextRunCacheSoftMax = 2048;
+    static constexpr uint32_t       kTextRunMaxAge       = 120;
+    std::unordered_map<uint64_t, TextRun>& textRuns = shared->textRuns;
+    uint64_t&                       textRunHits = shared->textRunHits;
+    uint64_t&                       textRunMisses = shared->textRunMisses;
+    // nullptr when the font is invalid.
+    const TextRun* getTextRun(const std::string& utf8, uint32_t fontId, float sizePx);
+    void trimTextRuns();
+
+    // ---- Arc tessellation cache ----
+    // Same policy as the shaped-run cache. arcScratch holds uncached arcs.
+    static constexpr size_t         kArcMeshCacheSoftMax = 1024;
+    static constexpr uint32_t       kArcMeshMaxAge       = 120;
+    std::unordered_map<uint64_t, ArcMesh>& arcMeshes = shared->arcMeshes;
+    uint64_t&                       arcMeshHits = shared->arcMeshHits;
+    uint64_t&                       arcMeshMisses = shared->arcMeshMisses;
+    const ArcMesh& getArcMesh(float innerR, float outerR,
+                              float startDeg, float endDeg, int segs);
+    void trimArcMeshes();
 
     // ---- Cursor cache (kept alive for lifetime of Renderer) ----
-    std::unordered_map<int, void*>          cursors;  // CursorType -> SDL_Cursor*
+    std::unordered_map<int, void*>&         cursors = shared->cursors;  // CursorType -> SDL_Cursor*
+
+    // ---- Render thread (Renderer::setRenderThread) ----
+    // Loops bgfx::renderFrame() from before bgfx::init() until shutdown;
+    // whichever thread calls init() stays bgfx's API thread.
+    static constexpr int32_t kRenderWaitMs = 100;   // also the stop poll
+    std::thread              renderThread;
+    std::atomic<bool>        renderThreadStop{false};
+    void startRenderThread();
+    void stopRenderThread();
+
+    // ---- Frame pacing (Renderer::setFramerateLimit / setLateInputSampling) ----
+    // waitUntilNs sleeps coarsely through SDL_DelayNS and spins the last
+    // pacerSpinNs, which follows the worst recent oversleep so the sleep
+    // itself never runs past the deadline. frameCostNs estimates the CPU
+    // side of a frame (input sample -> present); late sampling wakes that
+    // long, plus kLateInputSafetyNs, before the deadline. frameTimes holds
+    // the last present-to-present intervals behind the pacing stats.
+    static constexpr uint64_t kPacerSpinMinNs    = 200'000;
+    static constexpr uint64_t kPacerSpinMaxNs    = 4'000'000;
+    static constexpr uint64_t kLateInputSafetyNs = 1'000'000;
+    static constexpr double   kFrameCostDecay    = 0.05;  // per frame, falling
+    static constexpr size_t   kFrameTimeWindow   = 120;
+    bool     lateInput        = false;
+    uint64_t pacerSpinNs      = 1'000'000;
+    double   frameCostNs      = 0.0;
+    uint64_t frameWorkStartNs = 0;        // 0 = not stamped this frame
+    uint64_t inputSampleNs    = 0;        // 0 = host didn't sample this frame
+    uint64_t lastPresentNs    = 0;
+    double   inputLatencyMs   = 0.0;
+    float    frameTimesMs[kFrameTimeWindow] = {};
+    size_t   frameTimeCount   = 0;
+    size_t   frameTimeNext    = 0;
+    static uint64_t pacerNowNs();
+    uint64_t             initStartNs = 0;   // init() entry, until the first frame is out
+    RendererStartupStats startup;
+    void waitUntilNs(uint64_t deadlineNs);
+    // Waits for the frame deadline in nextTick less leadNs, then advances
+    // it; re-anchors without waiting on the first frame or far behind.
+    void paceFrame(double interval, uint64_t& nextTick, uint64_t leadNs);
+    // Right after bgfx::frame(): records the interval, cost and latency.
+    void notePresent();
+
+    // ---- Headless target and readback (Renderer::initHeadless) ----
+    // outputFB stands in for the backbuffer wherever the frame graph writes
+    // FgOutput; invalid means the real one. endFrame() blits each queued
+    // readback into its CPU-readable texture on readbackView (past the
+    // composite), starts readTexture(), and hands the pixels over once
+    // bgfx::frame() has reached readyFrame.
+    struct Readback {
+        Renderer::ReadbackFn done;
+        bgfx::TextureHandle  tex = BGFX_INVALID_HANDLE;
+        std::vector<uint8_t> pixels;
+        uint32_t             readyFrame = 0;
+    };
+    bgfx::FrameBufferHandle          outputFB     = BGFX_INVALID_HANDLE;
+    bgfx::TextureHandle              outputTex    = BGFX_INVALID_HANDLE;
+    uint32_t                         outputW      = 0;
+    uint32_t                         outputH      = 0;
+    uint16_t                         readbackView = UINT16_MAX;
+    std::vector<Readback>            readbackQueue;      // requested this frame
+    std::deque<Readback>             readbacksInFlight;  // by readyFrame
+    std::vector<bgfx::TextureHandle> readbackSpare;
+    uint32_t                         submittedFrame = 0; // last bgfx::frame()
+    bool createHeadlessTarget(uint32_t width, uint32_t height, uint16_t view);
+    // initShared(): outputFB is instead a swapchain framebuffer on this
+    // native window, remade whenever its pixel size changes.
+    void* windowHandle = nullptr;
+    bool  createWindowTarget(uint32_t width, uint32_t height);
+    void destroyHeadlessTarget();
+    void submitReadbacks();    // before bgfx::frame()
+    void deliverReadbacks();   // after it
 
     // ---- Shader & layout setup ----
+    // Builds what the first frame draws with: solid, tex, text and shapes.
     bool initShaders();
+    // Programs no first frame needs, created by the first draw that does.
+    // False (once reported) when the backend can't build them.
+    bgfx::ProgramHandle createLazyProgram(const char* vsName, const char* fsName);
+    bool ensureGlassPrograms();    // glass, blur and the kawase ladder
+    bool ensureWaveformProgram();
     void ensureLayouts();
+    // This window's targets; destroySharedResources() the rest, once
+    // nothing draws with them.
     void shutdownResources();
+    void destroySharedResources();
 
     // ---- Offscreen FB management for glass effect ----
     // Recreates sceneFB / blurFB_A / blurFB_B if (width,height) changed.
@@ -266,7 +1511,20 @@ struct Renderer::Impl {
     // Submits views kBlurHViewId and kBlurVViewId; assumes sceneFB has been
     // rendered into during this or the previous frame.
     void runBlurPasses(uint32_t width, uint32_t height);
-    // Submits view kCompositeViewId: full-screen blit of sceneFB to backbuffer.
+    // Half-res pixel rect the blur ladder writes. Only the area under this
+    // frame's deferredGlass (plus what their refraction and taps can reach)
+    // is blurred; collectBlurRegions() returns false when the merged union
+    // covers enough of the window that one full-screen pass is cheaper.
+    struct BlurRegion { float x0, y0, x1, y1; };
+    static constexpr size_t kMaxBlurRegions    = 8;
+    static constexpr float  kBlurTapReach      = 4.f;    // fs_blur taps, half-res px
+    static constexpr float  kBlurFullscreenAt  = 0.6f;   // union / window area
+    bool collectBlurRegions(uint16_t halfW, uint16_t halfH, std::vector<BlurRegion>& out) const;
+    std::vector<BlurRegion> blurRegions;                 // scratch, reused per frame
+    uint32_t                blurRegionsLastFrame  = 0;
+    float                   blurCoverageLastFrame = 0.f;
+    // Submits view kCompositeViewId: full-screen blit of sceneFB to the
+    // backbuffer (outputFB when headless).
     void compositeSceneToBackbuffer(uint32_t width, uint32_t height,
                                     const bgfx::VertexLayout& layout,
                                     bgfx::ProgramHandle program);
@@ -274,11 +1532,56 @@ struct Renderer::Impl {
     // ---- Helpers ----
     FontFace* getFace(uint32_t fontId, float pixelHeight);
     const Glyph* getGlyph(FontFace& face, uint32_t codepoint);
+    float        glyphAdvance(FontFace& face, uint32_t codepoint);
 
-    // Flushes any queued solid-rect batch as a single transient-buffer
-    // submit. Must be called before any pipeline-state change (view,
-    // scissor, round-clip, FB, rotation, non-Rect shader/program).
-    void flushSolidBatch();
+    // Flush a queued batch as a single transient-buffer submit. `why` is
+    // tallied per frame for RendererStats.
+    void flushSolidBatch(FlushReason why = FlushReason::Explicit);
+    void flushTextBatch(FlushReason why = FlushReason::Explicit);
+    // Flush whichever batch is pending. Must be called before any submit
+    // that doesn't go through a batch (textures, glass) and before view /
+    // FB changes. Taints any draw list being recorded, since that submit
+    // can't be captured.
+    void flushBatches();
+    // Append one recorded batch into the live solid/text batch (replay).
+    void replayDrawCmd(const DrawList::Data& list, size_t cmd);
+};
+
+// ---- Recorded draw list -----------------------------------------------------
+// One command per batch flush captured while recording. Vertices are final
+// (transform baked in) and indices are relative to the command's first
+// vertex, so replay is a copy + rebase into the live batch.
+struct DrawList::Data {
+    struct Cmd {
+        bool                        text     = false;
+        bool                        shapes   = false;   // instances, not verts
+        bool                        ramps    = false;   // shapes sampling gradient rows
+        Transform2D                 xform;
+        Renderer::Impl::BatchState  state;
+        bgfx::ProgramHandle         program  = BGFX_INVALID_HANDLE;
+        bgfx::TextureHandle         atlas    = BGFX_INVALID_HANDLE;
+        uint16_t                    page     = UINT16_MAX;  // glyph page slot
+        uint32_t                    firstVert = 0, numVerts = 0;
+        uint32_t                    firstIdx  = 0, numIdx   = 0;
+    };
+    std::vector<PosColorVertex>   solidVerts;
+    std::vector<PosColorUvVertex> textVerts;
+    std::vector<uint16_t>         idx;
+    std::vector<ShapeInstance>    shapes;
+    std::vector<Cmd>              cmds;
+    // State the recording started under; replay requires an exact match
+    // because every command's scissor / clip is absolute.
+    Renderer::Impl::BatchState    entry;
+    Transform2D                   entryXform{};
+    // Indexed clips: vertices name clip nodes, which only mean the same
+    // rects within one generation and under the same enclosing node.
+    uint32_t                      entryClipNode  = 0;
+    uint32_t                      clipGeneration = 0;
+    bool                          indexedClips   = false;
+    uint32_t                      glyphEvictions = 0;
+    uint32_t                      gradientEvictions = 0;
+    bool                          tainted = false;
+    bool                          valid   = false;
 };
 
 // ---- Shared draw-path helpers ---------------------------------------------
@@ -288,42 +1591,48 @@ struct Renderer::Impl {
 inline void applyClipUniforms(Renderer::Impl& impl,
                               const float rect[4],  const float params[4],
                               const float rect2[4], const float params2[4]) {
-    const bool same = impl.lastClipValid
-        && std::memcmp(rect,    impl.lastClipRect,    sizeof(impl.lastClipRect))    == 0
-        && std::memcmp(params,  impl.lastClipParams,  sizeof(impl.lastClipParams))  == 0
-        && std::memcmp(rect2,   impl.lastClipRect2,   sizeof(impl.lastClipRect2))   == 0
-        && std::memcmp(params2, impl.lastClipParams2, sizeof(impl.lastClipParams2)) == 0;
+    auto& r = impl.rs();
+    const bool same = r.lastClipValid
+        && std::memcmp(rect,    r.lastClipRect,    sizeof(r.lastClipRect))    == 0
+        && std::memcmp(params,  r.lastClipParams,  sizeof(r.lastClipParams))  == 0
+        && std::memcmp(rect2,   r.lastClipRect2,   sizeof(r.lastClipRect2))   == 0
+        && std::memcmp(params2, r.lastClipParams2, sizeof(r.lastClipParams2)) == 0;
     if (same) return;
-    if (bgfx::isValid(impl.u_clipRect))    bgfx::setUniform(impl.u_clipRect,    rect);
-    if (bgfx::isValid(impl.u_clipParams))  bgfx::setUniform(impl.u_clipParams,  params);
-    if (bgfx::isValid(impl.u_clipRect2))   bgfx::setUniform(impl.u_clipRect2,   rect2);
-    if (bgfx::isValid(impl.u_clipParams2)) bgfx::setUniform(impl.u_clipParams2, params2);
-    std::memcpy(impl.lastClipRect,    rect,    sizeof(impl.lastClipRect));
-    std::memcpy(impl.lastClipParams,  params,  sizeof(impl.lastClipParams));
-    std::memcpy(impl.lastClipRect2,   rect2,   sizeof(impl.lastClipRect2));
-    std::memcpy(impl.lastClipParams2, params2, sizeof(impl.lastClipParams2));
-    impl.lastClipValid = true;
+    bgfx::Encoder* enc = impl.enc();
+    if (bgfx::isValid(impl.u_clipRect))    enc->setUniform(impl.u_clipRect,    rect);
+    if (bgfx::isValid(impl.u_clipParams))  enc->setUniform(impl.u_clipParams,  params);
+    if (bgfx::isValid(impl.u_clipRect2))   enc->setUniform(impl.u_clipRect2,   rect2);
+    if (bgfx::isValid(impl.u_clipParams2)) enc->setUniform(impl.u_clipParams2, params2);
+    std::memcpy(r.lastClipRect,    rect,    sizeof(r.lastClipRect));
+    std::memcpy(r.lastClipParams,  params,  sizeof(r.lastClipParams));
+    std::memcpy(r.lastClipRect2,   rect2,   sizeof(r.lastClipRect2));
+    std::memcpy(r.lastClipParams2, params2, sizeof(r.lastClipParams2));
+    r.lastClipValid = true;
 }
 
 // Bind the round-clip uniforms for the current round-clip stack.
 inline void applyRoundClipInner(Renderer::Impl& impl) {
     impl.refreshClipCache();
-    applyClipUniforms(impl, impl.curClipRect, impl.curClipParams,
-                      impl.curClipRect2, impl.curClipParams2);
+    const auto& r = impl.rs();
+    applyClipUniforms(impl, r.curClipRect, r.curClipParams,
+                      r.curClipRect2, r.curClipParams2);
 }
 
 // Bind scissor + round-clip for an immediate (non-batched) submit.
 inline void applyScissor(Renderer::Impl& impl) {
-    if (impl.scissorTop > 0) {
-        const auto& sc = impl.scissorStack[impl.scissorTop - 1];
-        bgfx::setScissor(sc.x, sc.y, sc.w, sc.h);
+    const auto& r = impl.rs();
+    if (r.scissorTop > 0) {
+        const auto& sc = r.scissorStack[r.scissorTop - 1];
+        impl.enc()->setScissor(sc.x, sc.y, sc.w, sc.h);
     }
     applyRoundClipInner(impl);
+    impl.bindClipTable();
 }
 
 inline bool scissorEmpty(const Renderer::Impl& impl) {
-    if (impl.scissorTop == 0) return false;
-    const auto& sc = impl.scissorStack[impl.scissorTop - 1];
+    const auto& r = impl.rs();
+    if (r.scissorTop == 0) return false;
+    const auto& sc = r.scissorStack[r.scissorTop - 1];
     return sc.w == 0 || sc.h == 0;
 }
 
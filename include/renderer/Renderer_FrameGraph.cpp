@@ -0,0 +1,152 @@
+#include "RendererImpl.hpp"
+
+#include <bit>
+
+namespace uilo {
+
+// ============================================================================
+//  Frame graph: the endFrame pass pipeline (see RendererImpl.hpp)
+// ============================================================================
+
+void Renderer::Impl::buildFrameGraph(uint32_t width, uint32_t height,
+                                     Vec2f mouse, float sinceMove) {
+    fgPasses.clear();
+    blurReusedLastFrame = false;
+    auto add = [&](const char* name, uint32_t samples, uint32_t writes) -> FgPass& {
+        FgPass& p = fgPasses.emplace_back();
+        p.name    = name;
+        p.samples = samples;
+        p.writes  = writes;
+        return p;
+    };
+
+    // Submitted while the frame was built; nothing left to run.
+    add("scene", fgBit(FgLayers), fgBit(FgScene));
+
+    const bool anyGlass = !mainRecord.deferredGlass.empty();
+    // Offscreen targets for whatever may sample the scene. (Re)creating
+    // them drops a stale blur, so this comes before the reuse check.
+    if (anyGlass || embedded) ensureSceneFramebuffers(width, height);
+
+    if (anyGlass && usingHostBackdrop()) {
+        // The host blurred its scene already (setHostBackdrop): glass
+        // samples that, and none of UILO's blur passes run.
+        blurRegionsLastFrame  = 0;
+        blurCoverageLastFrame = 0.f;
+        ladderLevels          = 0;
+        blurValid             = false;
+        add("glass", 0u, fgBit(FgScene)).run = [this, width, height, mouse, sinceMove] {
+            replayDeferredGlass((float)width, (float)height, mouse, sinceMove);
+        };
+    } else if (anyGlass) {
+        // Nothing under the glass changed since the blur last ran:
+        // blurFB_B and the ladder still hold exactly that result, so
+        // FgBlur / FgLadder come in from the previous frame.
+        const uint64_t inputs = blurInputsHash(width, height);
+        uint8_t levels = ladderLevels;
+        if (blurValid && inputs == blurHash) {
+            blurReusedLastFrame = true;
+        } else {
+            add("blur", fgBit(FgScene) | fgBit(FgBlurTemp),
+                fgBit(FgBlurTemp) | fgBit(FgBlur)).run = [this, width, height] {
+                runBlurPasses(width, height);
+            };
+            levels = wantedLadderLevels(width, height);
+            if (levels >= 2)
+                add("ladder", fgBit(FgScene) | fgBit(FgLadderTemp),
+                    fgBit(FgLadderTemp) | fgBit(FgLadder)).run = [this, width, height, levels] {
+                    runBlurLadder(width, height, levels);
+                };
+            else
+                ladderLevels = 0;
+            blurHash  = inputs;
+            blurValid = true;
+        }
+        // Blends over the scene in place, so it only writes it.
+        add("glass", fgBit(FgBlur) | (levels >= 2 ? fgBit(FgLadder) : 0u),
+            fgBit(FgScene)).run = [this, width, height, mouse, sinceMove] {
+            replayDeferredGlass((float)width, (float)height, mouse, sinceMove);
+        };
+    } else {
+        // The blur target's contents go stale, but nothing samples them.
+        blurRegionsLastFrame  = 0;
+        blurCoverageLastFrame = 0.f;
+        ladderLevels          = 0;
+        blurValid             = false;
+        glassPanelsLastFrame  = 0;
+        glassDrawsLastFrame   = 0;
+    }
+
+    FgPass& composite = add("composite", fgBit(FgScene), fgBit(FgOutput));
+    composite.copy = true;
+    composite.run  = [this, width, height] {
+        compositeSceneToBackbuffer(width, height, texLayout, texProgram);
+    };
+}
+
+void Renderer::Impl::compileFrameGraph() {
+    // Cull: walking back from the output, a pass stays when something a
+    // kept pass samples (or the output) is among what it writes.
+    uint32_t needed = fgBit(FgOutput);
+    for (size_t i = fgPasses.size(); i-- > 0;) {
+        FgPass& p = fgPasses[i];
+        p.live = (p.writes & needed) != 0;
+        if (p.live) needed |= p.samples;
+    }
+
+    for (uint8_t r = 0; r < FgResourceCount; ++r) fgTarget[r] = (FgResource)r;
+
+    // A blit whose source no other kept pass samples is elided by drawing
+    // the source straight into the destination. The host's image can't
+    // take the scene's clear, so embedded the composite always stays.
+    for (auto& p : fgPasses) {
+        if (!p.live || !p.copy || (embedded && (p.writes & fgBit(FgOutput)))) continue;
+        bool sampledElsewhere = false;
+        for (const auto& q : fgPasses)
+            if (&q != &p && q.live && (q.samples & p.samples)) sampledElsewhere = true;
+        if (sampledElsewhere) continue;
+        fgTarget[std::countr_zero(p.samples)] = (FgResource)std::countr_zero(p.writes);
+        p.live = false;
+    }
+
+    // Transients of one size (all half-res BGRA8) whose kept lifetimes
+    // don't overlap share the earlier one's target.
+    static constexpr FgResource kHalfResTransients[] = { FgBlurTemp, FgLadderTemp };
+    int first[FgResourceCount], last[FgResourceCount];
+    std::fill(std::begin(first), std::end(first), -1);
+    std::fill(std::begin(last),  std::end(last),  -1);
+    for (size_t i = 0; i < fgPasses.size(); ++i) {
+        if (!fgPasses[i].live) continue;
+        for (uint32_t m = fgPasses[i].samples | fgPasses[i].writes; m; m &= m - 1) {
+            const int r = std::countr_zero(m);
+            if (first[r] < 0) first[r] = (int)i;
+            last[r] = (int)i;
+        }
+    }
+    for (size_t b = 1; b < std::size(kHalfResTransients); ++b) {
+        const FgResource rb = kHalfResTransients[b];
+        if (first[rb] < 0) continue;
+        for (size_t a = 0; a < b; ++a) {
+            const FgResource ra = kHalfResTransients[a];
+            if (first[ra] < 0 || fgTarget[ra] != ra || last[ra] >= first[rb]) continue;
+            fgTarget[rb] = ra;
+            break;
+        }
+    }
+}
+
+void Renderer::Impl::executeFrameGraph(uint32_t width, uint32_t height) {
+    const bool direct = fgTarget[FgScene] == FgOutput;
+    const bgfx::FrameBufferHandle backbuffer = outputFB;   // invalid unless headless
+    bindSceneViews(direct ? backbuffer : sceneFB, width, height);
+    uint32_t ran = 0;
+    for (auto& p : fgPasses) {
+        if (!p.live) continue;
+        ++ran;
+        if (p.run) p.run();
+    }
+    fgPassesLastFrame    = ran;
+    sceneDirectLastFrame = direct;
+}
+
+} // namespace uilo
@@ -0,0 +1,121 @@
+#include "RendererImpl.hpp"
+
+namespace uilo {
+
+// ============================================================================
+//  Headless rendering and frame readback (see RendererImpl.hpp)
+// ============================================================================
+
+bool Renderer::initHeadless(uint32_t width, uint32_t height) {
+    if (m_initialised) return true;
+    if (width == 0 || height == 0 || width > UINT16_MAX || height > UINT16_MAX) {
+        std::fprintf(stderr, "[UILO] initHeadless: bad size %ux%u\n", width, height);
+        return false;
+    }
+    m_headless     = true;
+    m_headlessSize = { width, height };
+    // No window to multisample; analytic AA still applies.
+    if (!init(width, height, "UILO", 1)) {
+        m_headless = false;
+        return false;
+    }
+    return true;
+}
+
+bool Renderer::Impl::createHeadlessTarget(uint32_t width, uint32_t height, uint16_t view) {
+    outputFB = bgfx::createFrameBuffer((uint16_t)width, (uint16_t)height,
+                                       bgfx::TextureFormat::BGRA8,
+                                       BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
+    if (!bgfx::isValid(outputFB)) {
+        std::fprintf(stderr, "[UILO] initHeadless: can't create a %ux%u target\n", width, height);
+        return false;
+    }
+    outputTex    = bgfx::getTexture(outputFB, 0);
+    outputW      = width;
+    outputH      = height;
+    readbackView = view;
+    bgfx::setViewFrameBuffer(view, outputFB);
+    bgfx::setViewRect(view, 0, 0, (uint16_t)width, (uint16_t)height);
+    bgfx::setViewClear(view, BGFX_CLEAR_NONE);
+    bgfx::setViewMode(view, bgfx::ViewMode::Sequential);
+    return true;
+}
+
+void Renderer::Impl::destroyHeadlessTarget() {
+    for (auto& r : readbackQueue)     if (bgfx::isValid(r.tex)) bgfx::destroy(r.tex);
+    for (auto& r : readbacksInFlight) if (bgfx::isValid(r.tex)) bgfx::destroy(r.tex);
+    for (auto tex : readbackSpare) bgfx::destroy(tex);
+    readbackQueue.clear();
+    readbacksInFlight.clear();
+    readbackSpare.clear();
+    if (bgfx::isValid(outputFB)) bgfx::destroy(outputFB);
+    outputFB  = BGFX_INVALID_HANDLE;
+    outputTex = BGFX_INVALID_HANDLE;
+    outputW = outputH = 0;
+}
+
+bool Renderer::requestReadback(ReadbackFn done) {
+    auto& impl = *m_impl;
+    if (!m_headless || !bgfx::isValid(impl.outputTex)) {
+        std::fprintf(stderr, "[UILO] requestReadback: only available headless\n");
+        return false;
+    }
+    constexpr uint64_t kNeeded = BGFX_CAPS_TEXTURE_BLIT | BGFX_CAPS_TEXTURE_READ_BACK;
+    if ((bgfx::getCaps()->supported & kNeeded) != kNeeded) {
+        std::fprintf(stderr, "[UILO] requestReadback: %s can't read textures back\n",
+                     bgfx::getRendererName(bgfx::getRendererType()));
+        return false;
+    }
+
+    Impl::Readback r;
+    r.done = std::move(done);
+    if (!impl.readbackSpare.empty()) {
+        r.tex = impl.readbackSpare.back();
+        impl.readbackSpare.pop_back();
+    } else {
+        r.tex = bgfx::createTexture2D((uint16_t)impl.outputW, (uint16_t)impl.outputH, false, 1,
+                                      bgfx::TextureFormat::BGRA8,
+                                      BGFX_TEXTURE_BLIT_DST | BGFX_TEXTURE_READ_BACK
+                                      | BGFX_SAMPLER_POINT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
+        if (!bgfx::isValid(r.tex)) return false;
+    }
+    r.pixels.resize((size_t)impl.outputW * impl.outputH * 4);
+    impl.readbackQueue.push_back(std::move(r));
+    return true;
+}
+
+void Renderer::Impl::submitReadbacks() {
+    // The readback view sorts after the composite, so each blit copies the
+    // finished frame.
+    for (auto& r : readbackQueue) {
+        bgfx::blit(readbackView, r.tex, 0, 0, outputTex, 0, 0,
+                   (uint16_t)outputW, (uint16_t)outputH);
+        r.readyFrame = bgfx::readTexture(r.tex, r.pixels.data());
+        readbacksInFlight.push_back(std::move(r));
+    }
+    readbackQueue.clear();
+}
+
+void Renderer::Impl::deliverReadbacks() {
+    const bool flip = !readbacksInFlight.empty() && bgfx::getCaps()->originBottomLeft;
+    const size_t rowBytes = (size_t)outputW * 4;
+    while (!readbacksInFlight.empty() && submittedFrame >= readbacksInFlight.front().readyFrame) {
+        Readback r = std::move(readbacksInFlight.front());
+        readbacksInFlight.pop_front();
+        if (flip) {
+            std::vector<uint8_t> row(rowBytes);
+            for (uint32_t y = 0; y < outputH / 2; ++y) {
+                uint8_t* a = r.pixels.data() + (size_t)y * rowBytes;
+                uint8_t* b = r.pixels.data() + (size_t)(outputH - 1 - y) * rowBytes;
+                std::memcpy(row.data(), a, rowBytes);
+                std::memcpy(a, b, rowBytes);
+                std::memcpy(b, row.data(), rowBytes);
+            }
+        }
+        readbackSpare.push_back(r.tex);
+        // May queue the next readback.
+        if (r.done) r.done(r.pixels.data(), outputW, outputH);
+    }
+}
+
+} // namespace uilo
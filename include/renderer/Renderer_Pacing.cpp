@@ -0,0 +1,110 @@
+#include "RendererImpl.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace uilo {
+
+// ============================================================================
+//  Frame pacing: framerate limit and late input sampling (see RendererImpl.hpp)
+// ============================================================================
+
+uint64_t Renderer::Impl::pacerNowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Renderer::Impl::waitUntilNs(uint64_t deadlineNs) {
+    uint64_t now = pacerNowNs();
+    if (now >= deadlineNs) return;
+    if (deadlineNs - now > pacerSpinNs) {
+        const uint64_t sleepNs = deadlineNs - now - pacerSpinNs;
+        SDL_DelayNS(sleepNs);
+        const uint64_t woke = pacerNowNs();
+        const uint64_t over = woke > now + sleepNs ? woke - (now + sleepNs) : 0;
+        // Keep half again the oversleep in hand; jump up to a bad wakeup,
+        // then creep back down as the scheduler behaves.
+        const uint64_t want = over + over / 2;
+        pacerSpinNs = want > pacerSpinNs ? want : pacerSpinNs - (pacerSpinNs - want) / 16;
+        pacerSpinNs = std::clamp(pacerSpinNs, kPacerSpinMinNs, kPacerSpinMaxNs);
+        now = woke;
+    }
+    while (now < deadlineNs) {
+        std::this_thread::yield();
+        now = pacerNowNs();
+    }
+}
+
+void Renderer::Impl::paceFrame(double interval, uint64_t& nextTick, uint64_t leadNs) {
+    UILO_TRACE_ZONE("Renderer::paceFrame");
+    const uint64_t now        = pacerNowNs();
+    const uint64_t intervalNs = (uint64_t)(interval * 1e9);
+    if (nextTick == 0 || now > nextTick + intervalNs) {
+        // First call or we drifted way behind: re-anchor.
+        nextTick = now + intervalNs;
+        return;
+    }
+    if (nextTick > now + leadNs) waitUntilNs(nextTick - leadNs);
+    nextTick += intervalNs;
+}
+
+void Renderer::Impl::notePresent() {
+    const uint64_t now = pacerNowNs();
+    if (lastPresentNs != 0) {
+        frameTimesMs[frameTimeNext] = (float)((double)(now - lastPresentNs) * 1e-6);
+        frameTimeNext  = (frameTimeNext + 1) % kFrameTimeWindow;
+        frameTimeCount = std::min(frameTimeCount + 1, kFrameTimeWindow);
+    }
+    lastPresentNs = now;
+
+    if (frameWorkStartNs != 0) {
+        // Rises at once so one slow frame can't make the next one late too.
+        const double cost = (double)(now - frameWorkStartNs);
+        frameCostNs = cost > frameCostNs ? cost
+                                         : frameCostNs + (cost - frameCostNs) * kFrameCostDecay;
+    }
+    if (inputSampleNs != 0) {
+        const double ms = (double)(now - inputSampleNs) * 1e-6;
+        inputLatencyMs = inputLatencyMs == 0.0 ? ms : inputLatencyMs + (ms - inputLatencyMs) * 0.1;
+        inputSampleNs = 0;
+    }
+    frameWorkStartNs = 0;
+}
+
+void Renderer::setFramerateLimit(float fps) {
+    if (fps <= 0.f || !std::isfinite(fps)) {
+        m_frameInterval = 0.0;
+        m_nextFrameTick = 0;
+        return;
+    }
+    m_frameInterval = 1.0 / (double)fps;
+    m_nextFrameTick = 0; // re-anchor on the next wait
+}
+
+float Renderer::getFramerateLimit() const {
+    return m_frameInterval > 0.0 ? (float)(1.0 / m_frameInterval) : 0.f;
+}
+
+void Renderer::setLateInputSampling(bool enabled) {
+    if (m_impl->lateInput == enabled) return;
+    m_impl->lateInput = enabled;
+    m_nextFrameTick   = 0;
+}
+
+bool Renderer::getLateInputSampling() const {
+    return m_impl->lateInput;
+}
+
+void Renderer::waitForInputDeadline() {
+    auto& impl = *m_impl;
+    if (m_frameInterval > 0.0 && impl.lateInput)
+        impl.paceFrame(m_frameInterval, m_nextFrameTick,
+                       (uint64_t)impl.frameCostNs + Impl::kLateInputSafetyNs);
+    impl.inputSampleNs    = Impl::pacerNowNs();
+    impl.frameWorkStartNs = impl.inputSampleNs;
+}
+
+} // namespace uilo
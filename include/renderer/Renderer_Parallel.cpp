@@ -0,0 +1,188 @@
+#include "RendererImpl.hpp"
+#include "../utils/JobPool.hpp"
+
+namespace uilo {
+
+// ============================================================================
+//  Parallel recording: top-level subtrees on per-slice encoders
+//  (see RendererImpl.hpp)
+// ============================================================================
+
+void Renderer::Impl::beginSliceRecord(RecordState& r, const RecordState& from,
+                                      uint16_t sceneView, uint16_t glassChildView) {
+    r.owner          = this;
+    r.encoder        = nullptr;
+    r.sceneView      = sceneView;
+    r.glassChildView = glassChildView;
+    r.viewStackTop   = 0;
+    r.viewOps.clear();
+    r.retryOnMain    = false;
+
+    std::memcpy(r.scissorStack,   from.scissorStack,   sizeof(r.scissorStack));
+    std::memcpy(r.roundClipStack, from.roundClipStack, sizeof(r.roundClipStack));
+    r.scissorTop             = from.scissorTop;
+    r.scissorOverflowDepth   = from.scissorOverflowDepth;
+    r.roundClipTop           = from.roundClipTop;
+    r.roundClipOverflowDepth = from.roundClipOverflowDepth;
+    r.layerStack.clear();
+    r.viewOrigin             = from.viewOrigin;
+    r.layerTainted           = false;
+    // A fresh encoder has none of the clip uniforms set.
+    r.lastClipValid  = false;
+    r.clipVersion    = from.clipVersion;
+    r.curClipVersion = from.clipVersion - 1;
+
+    r.solidBatchVerts.clear();
+    r.solidBatchIdx.clear();
+    r.solidBatch.view = UINT16_MAX;
+    r.textBatchVerts.clear();
+    r.textBatchIdx.clear();
+    r.textBatch.view = UINT16_MAX;
+    r.shapeBatch.clear();
+    r.shapeBatchState.view = UINT16_MAX;
+    r.recordingLists.clear();
+
+    r.rotation   = from.rotation;
+    r.xformStack = from.xformStack;
+    r.xform      = from.xform;
+    r.effective  = from.effective;
+    r.xformOn    = from.xformOn;
+
+    r.sceneHash = kHashBasis;
+    r.touchedViews.reset();
+    r.deferredGlass.clear();
+    r.animatedThisFrame = false;
+    r.culledThisFrame   = 0;
+    r.rejectedThisFrame = 0;
+    r.batchedSubmits    = 0;
+    r.immediateSubmits  = 0;
+    std::fill(std::begin(r.flushes), std::end(r.flushes), 0u);
+#if UILO_PROFILER
+    r.verticesQueued    = 0;
+#endif
+}
+
+void Renderer::Impl::mergeSliceRecord(RecordState& r) {
+    RecordState& m = mainRecord;
+    m.sceneHash = hashBytes(m.sceneHash, &r.sceneHash, sizeof(r.sceneHash));
+    m.touchedViews |= r.touchedViews;
+    m.deferredGlass.insert(m.deferredGlass.end(), r.deferredGlass.begin(), r.deferredGlass.end());
+    r.deferredGlass.clear();
+    m.animatedThisFrame = m.animatedThisFrame || r.animatedThisFrame;
+    m.culledThisFrame  += r.culledThisFrame;
+    m.rejectedThisFrame += r.rejectedThisFrame;
+    m.batchedSubmits    += r.batchedSubmits;
+    m.immediateSubmits  += r.immediateSubmits;
+    for (size_t i = 0; i < std::size(r.flushes); ++i) m.flushes[i] += r.flushes[i];
+    for (auto& op : r.viewOps) op();
+    r.viewOps.clear();
+}
+
+void Renderer::Impl::orderSliceViews() {
+    if (slicesUsed == 0 && slicesLastFrame == 0) return;
+    uint16_t last = kCompositeViewId;
+    for (size_t i = 0; i < sliceSceneViews.size(); ++i)
+        last = std::max({ last, sliceSceneViews[i], sliceGlassViews[i] });
+    const uint16_t num = (uint16_t)(last - fbViewFirst + 1);
+    // Nothing recorded in parallel: back to plain id order.
+    if (slicesUsed == 0) {
+        bgfx::setViewOrder(fbViewFirst, num, nullptr);
+        return;
+    }
+
+    // Position -> view id, from fbViewFirst: each slice's views run right
+    // after the shared view they continue, later slices later.
+    sliceViewOrder.clear();
+    for (uint16_t v = fbViewFirst; v <= kSceneViewId; ++v) sliceViewOrder.push_back(v);
+    for (uint32_t i = 0; i < slicesUsed; ++i) sliceViewOrder.push_back(sliceSceneViews[i]);
+    for (uint16_t v = kBlurHViewId; v <= kGlassChildViewId; ++v) sliceViewOrder.push_back(v);
+    for (uint32_t i = 0; i < slicesUsed; ++i) sliceViewOrder.push_back(sliceGlassViews[i]);
+    sliceViewOrder.push_back(kCompositeViewId);
+    // Overflow framebuffers and idle slice views keep their relative order.
+    for (uint32_t v = kCompositeViewId + 1u; v <= last; ++v) {
+        bool used = false;
+        for (uint32_t i = 0; i < slicesUsed && !used; ++i)
+            used = v == sliceSceneViews[i] || v == sliceGlassViews[i];
+        if (!used) sliceViewOrder.push_back((uint16_t)v);
+    }
+    bgfx::setViewOrder(fbViewFirst, num, sliceViewOrder.data());
+}
+
+void Renderer::recordParallel(JobPool* pool, size_t count,
+                              const std::function<void(size_t)>& draw) {
+    auto& impl = *m_impl;
+    auto& rec = impl.mainRecord;
+    auto serial = [&] { for (size_t i = 0; i < count; ++i) draw(i); };
+
+    // Slices start on the scene with an empty view stack; anything that
+    // redirects drawing (a framebuffer, layer, glass subtree or draw list)
+    // or an already parallel caller records serially.
+    if (!pool || pool->getWorkerCount() == 0 || count <= 1 || JobPool::inJob() ||
+        &impl.rs() != &rec || rec.viewStackTop > 0 || !rec.layerStack.empty() ||
+        !rec.recordingLists.empty()) {
+        serial();
+        return;
+    }
+    const bgfx::Caps* caps = bgfx::getCaps();
+    if (caps->limits.maxEncoders <= 1) { serial(); return; }
+
+    // One view pair per slice, plus one for what's drawn after the join.
+    const uint32_t pairs = impl.slicesUsed + (uint32_t)count + 1;
+    const size_t   grow  = pairs > impl.sliceSceneViews.size()
+                         ? pairs - impl.sliceSceneViews.size() : 0;
+    const uint32_t maxViews = std::min<uint32_t>(impl.viewLimit(),
+                                                 (uint32_t)rec.touchedViews.size());
+    if ((uint32_t)m_nextViewId + 2 * grow > maxViews) {
+        std::fprintf(stderr, "[UILO] recordParallel: out of view ids, recording serially\n");
+        serial();
+        return;
+    }
+    for (size_t i = 0; i < grow; ++i) {
+        impl.sliceSceneViews.push_back(m_nextViewId++);
+        impl.sliceGlassViews.push_back(m_nextViewId++);
+    }
+    while (impl.sliceRecords.size() < count)
+        impl.sliceRecords.push_back(std::make_unique<Impl::RecordState>());
+
+    impl.flushBatches();
+    const uint32_t first = impl.slicesUsed;
+    for (size_t i = 0; i < count; ++i)
+        impl.beginSliceRecord(*impl.sliceRecords[i], rec,
+                              impl.sliceSceneViews[first + i], impl.sliceGlassViews[first + i]);
+    impl.slicesUsed = pairs;
+
+    impl.parallelRecording = true;
+    pool->parallelFor(count, [&](size_t i) {
+        Impl::RecordState& r = *impl.sliceRecords[i];
+        r.encoder = bgfx::begin(true);
+        if (!r.encoder) { r.retryOnMain = true; return; }
+        Impl::t_record = &r;
+        draw(i);
+        impl.flushBatches();
+        Impl::t_record = nullptr;
+        bgfx::end(r.encoder);
+        r.encoder = nullptr;
+    });
+    // Out of encoders: these go through the main thread's. Their views
+    // still sort them into place.
+    for (size_t i = 0; i < count; ++i) {
+        Impl::RecordState& r = *impl.sliceRecords[i];
+        if (!r.retryOnMain) continue;
+        r.encoder     = bgfx::begin();
+        r.retryOnMain = false;
+        Impl::t_record = &r;
+        draw(i);
+        impl.flushBatches();
+        Impl::t_record = nullptr;
+        r.encoder = nullptr;
+    }
+    impl.parallelRecording = false;
+
+    for (size_t i = 0; i < count; ++i) impl.mergeSliceRecord(*impl.sliceRecords[i]);
+    rec.sceneView      = impl.sliceSceneViews[pairs - 1];
+    rec.glassChildView = impl.sliceGlassViews[pairs - 1];
+    rec.lastClipValid  = false;
+    impl.parallelSlicesThisFrame += (uint32_t)count;
+}
+
+} // namespace uilo
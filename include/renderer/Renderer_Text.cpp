@@ -7,6 +7,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <functional>
+#include <map>
 
 namespace uilo {
 
@@ -14,27 +16,31 @@ namespace uilo {
 // RendererImpl.hpp.
 
 namespace {
-// Slurp a file fully into a vector.
-bool readFile(const char* path, std::vector<uint8_t>& out) {
-    std::FILE* f = std::fopen(path, "rb");
-    if (!f) return false;
-    std::fseek(f, 0, SEEK_END);
-    long sz = std::ftell(f);
-    std::fseek(f, 0, SEEK_SET);
-    if (sz <= 0) { std::fclose(f); return false; }
-    out.resize((size_t)sz);
-    size_t got = std::fread(out.data(), 1, (size_t)sz, f);
-    std::fclose(f);
-    return got == (size_t)sz;
-}
-
-constexpr int kAtlasW = 1024;
-constexpr int kAtlasH = 1024;
-constexpr const char* kEmbeddedFontCacheKey = "__UILO_EMBEDDED_DEFAULT_FONT__";
-
-void initAtlasFace(FontFace& face, stbtt_fontinfo info,
-                   std::vector<uint8_t> ttf, float pixelHeight) {
-    face.ttfData     = std::move(ttf);
+
+constexpr const char* kEmbeddedFontCacheKey    = "__UILO_EMBEDDED_DEFAULT_FONT__";
+constexpr const char* kEmbeddedSdfFontCacheKey = "__UILO_EMBEDDED_DEFAULT_FONT_SDF__";
+constexpr const char* kSdfCacheSuffix          = "#sdf";
+constexpr int kGlyphPad = 1;   // blank texels around every packed glyph
+
+// SDF bake parameters: the field extends kSdfSpread base pixels past the
+// outline, with the edge itself at 128 (0.5 in fs_text_sdf).
+constexpr int   kSdfSpread = 6;
+constexpr unsigned char kSdfOnEdge = 128;
+constexpr float kSdfDistScale = (float)kSdfOnEdge / (float)kSdfSpread;
+
+// Glyph-space -> screen-space factor. Bitmap faces are baked at the draw
+// size; SDF faces at kSdfBasePx and scaled here.
+inline float faceScale(const FontFace& face, float sizePx) {
+    return face.sdf ? sizePx / face.pixelHeight : 1.f;
+}
+
+bool initFontInfo(stbtt_fontinfo& info, const FontBlob& blob) {
+    return stbtt_InitFont(&info, blob.data, stbtt_GetFontOffsetForIndex(blob.data, 0)) != 0;
+}
+
+void initFace(FontFace& face, stbtt_fontinfo info,
+              FontBlobPtr ttf, float pixelHeight) {
+    face.ttf         = std::move(ttf);
     face.info        = info;
     face.pixelHeight = pixelHeight;
     face.scale       = stbtt_ScaleForPixelHeight(&face.info, pixelHeight);
@@ -43,123 +49,311 @@ void initAtlasFace(FontFace& face, stbtt_fontinfo info,
     face.ascent  =  asc     * face.scale;
     face.descent = -desc    * face.scale;  // stb reports negative descent
     face.lineGap =  lineGap * face.scale;
-    face.atlasW  = kAtlasW;
-    face.atlasH  = kAtlasH;
-    face.penX = 1;
-    face.penY = 1;
-    face.rowH = 0;
-
-    // Allocate R8 texture, blank.
-    face.atlas = bgfx::createTexture2D(
-        (uint16_t)kAtlasW, (uint16_t)kAtlasH, false, 1,
-        bgfx::TextureFormat::R8,
-        BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP,
-        nullptr);
+}
+
+// Advance and bitmap box of a bitmap glyph at `scale`.
+void glyphBox(const stbtt_fontinfo& info, float scale, uint32_t codepoint,
+              Glyph& g, int& gw, int& gh) {
+    int adv = 0, lsb = 0;
+    stbtt_GetCodepointHMetrics(&info, (int)codepoint, &adv, &lsb);
+    g.xadvance = adv * scale;
+    int x0, y0, x1, y1;
+    stbtt_GetCodepointBitmapBox(&info, (int)codepoint, scale, scale, &x0, &y0, &x1, &y1);
+    gw = x1 - x0;
+    gh = y1 - y0;
+    g.xoff = (float)x0;
+    g.yoff = (float)y0;   // negative (above baseline)
+}
+
+// Advance and distance field of an SDF glyph; free with stbtt_FreeSDF.
+unsigned char* sdfGlyph(const stbtt_fontinfo& info, float scale, uint32_t codepoint,
+                        Glyph& g, int& gw, int& gh) {
+    int adv = 0, lsb = 0;
+    stbtt_GetCodepointHMetrics(&info, (int)codepoint, &adv, &lsb);
+    g.xadvance = adv * scale;
+    int xo = 0, yo = 0;
+    gw = gh = 0;
+    unsigned char* bmp = stbtt_GetCodepointSDF(&info, scale, (int)codepoint,
+                                               kSdfSpread, kSdfOnEdge, kSdfDistScale,
+                                               &gw, &gh, &xo, &yo);
+    if (!bmp) gw = gh = 0;
+    g.xoff = (float)xo;
+    g.yoff = (float)yo;
+    return bmp;
+}
+
+// Rasterizes one glyph: its metrics into g and a gw x gh R8 bitmap
+// (either may be 0 for a blank glyph) appended to out. Touches nothing
+// but `info`, so the prewarm worker can run it.
+void rasterizeGlyph(const stbtt_fontinfo& info, float scale, bool sdf, uint32_t codepoint,
+                    Glyph& g, int& gw, int& gh, std::vector<uint8_t>& out) {
+    if (sdf) {
+        unsigned char* bmp = sdfGlyph(info, scale, codepoint, g, gw, gh);
+        if (bmp && gw > 0 && gh > 0) out.insert(out.end(), bmp, bmp + (size_t)gw * (size_t)gh);
+        if (bmp) stbtt_FreeSDF(bmp, nullptr);
+        return;
+    }
+    glyphBox(info, scale, codepoint, g, gw, gh);
+    if (gw <= 0 || gh <= 0) return;
+    const size_t at = out.size();
+    out.resize(at + (size_t)gw * (size_t)gh, 0);
+    stbtt_MakeCodepointBitmap(&info, out.data() + at, gw, gh, gw, scale, scale, (int)codepoint);
+}
+
+// Copies a w x h bitmap into the page's shadow at (x, y) and dirties it.
+void writeGlyph(GlyphAtlasPage& p, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                const uint8_t* src) {
+    const int size = Renderer::Impl::kGlyphPageSize;
+    for (uint16_t row = 0; row < h; ++row)
+        std::memcpy(p.shadow.data() + (size_t)(y + row) * size + x, src + (size_t)row * w, w);
+    p.markDirty(x, y, w, h);
+}
+
+// Whether a cached glyph can be drawn as is: packed in a page that still
+// holds it, or blank for good (not waiting out a full atlas).
+bool glyphUsable(const Glyph& g, const std::vector<GlyphAtlasPage>& pages) {
+    if (g.page == UINT16_MAX) return g.retryFrame == 0;
+    const auto& pg = pages[g.page];
+    return bgfx::isValid(pg.tex) && pg.gen == g.pageGen;
+}
+
+void resetPage(GlyphAtlasPage& p) {
+    p.shelves.clear();
+    p.nextY    = kGlyphPad;
+    p.usedArea = 0;
+    ++p.gen;   // every Glyph packed into the old contents is now stale
+}
+
+bool packIntoPage(GlyphAtlasPage& p, int w, int h, uint16_t& outX, uint16_t& outY) {
+    return packShelf(p, Renderer::Impl::kGlyphPageSize, kGlyphPad, w, h, outX, outY);
+}
+
+// Wipe a whole page so stale texels from evicted glyphs can't bleed into
+// the padding of new ones under filtering. The clear goes up with the
+// page's next upload.
+void clearPageTexture(GlyphAtlasPage& p) {
+    const int size = Renderer::Impl::kGlyphPageSize;
+    p.shadow.assign((size_t)size * size, 0);
+    p.clearDirty();
+    p.markDirty(0, 0, (uint16_t)size, (uint16_t)size);
 }
 } // anon
 
+bool Renderer::Impl::allocGlyphRect(int w, int h, uint16_t& page,
+                                    uint16_t& x, uint16_t& y) {
+    if (w + 2 * kGlyphPad > kGlyphPageSize || h + 2 * kGlyphPad > kGlyphPageSize)
+        return false;
+
+    size_t live = 0;
+    for (size_t i = 0; i < glyphPages.size(); ++i) {
+        auto& p = glyphPages[i];
+        if (!bgfx::isValid(p.tex)) continue;
+        ++live;
+        if (packIntoPage(p, w, h, x, y)) { page = (uint16_t)i; return true; }
+    }
+
+    const size_t pageBytes = size_t(kGlyphPageSize) * kGlyphPageSize;
+    if (live == 0 || (live + 1) * pageBytes <= glyphAtlasBudget) {
+        size_t slot = glyphPages.size();
+        for (size_t i = 0; i < glyphPages.size(); ++i)
+            if (!bgfx::isValid(glyphPages[i].tex)) { slot = i; break; }
+        if (slot == glyphPages.size()) glyphPages.emplace_back();
+        auto& p = glyphPages[slot];
+        p.tex = bgfx::createTexture2D(
+            (uint16_t)kGlyphPageSize, (uint16_t)kGlyphPageSize, false, 1,
+            bgfx::TextureFormat::R8,
+            BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP,
+            nullptr);
+        if (!bgfx::isValid(p.tex)) return false;
+        resetPage(p);
+        clearPageTexture(p);
+        p.lastUsed = frameIndex;
+        page = (uint16_t)slot;
+        return packIntoPage(p, w, h, x, y);
+    }
+
+    // Over budget: recycle the coldest page not sampled this frame.
+    GlyphAtlasPage* victim = nullptr;
+    size_t victimSlot = 0;
+    for (size_t i = 0; i < glyphPages.size(); ++i) {
+        auto& p = glyphPages[i];
+        if (!bgfx::isValid(p.tex) || p.lastUsed == frameIndex) continue;
+        if (!victim || p.lastUsed < victim->lastUsed) { victim = &p; victimSlot = i; }
+    }
+    if (!victim) return false;
+    resetPage(*victim);
+    clearPageTexture(*victim);
+    victim->lastUsed = frameIndex;
+    ++glyphAtlasEvictions;
+    page = (uint16_t)victimSlot;
+    return packIntoPage(*victim, w, h, x, y);
+}
+
+void Renderer::Impl::trimGlyphAtlas() {
+    const size_t pageBytes = size_t(kGlyphPageSize) * kGlyphPageSize;
+    for (;;) {
+        size_t live = 0;
+        GlyphAtlasPage* victim = nullptr;
+        for (auto& p : glyphPages) {
+            if (!bgfx::isValid(p.tex)) continue;
+            ++live;
+            if (p.lastUsed == frameIndex) continue;
+            if (!victim || p.lastUsed < victim->lastUsed) victim = &p;
+        }
+        if (live <= 1 || live * pageBytes <= glyphAtlasBudget || !victim) return;
+        bgfx::destroy(victim->tex);
+        victim->tex = BGFX_INVALID_HANDLE;
+        resetPage(*victim);
+        victim->shadow = {};
+        victim->clearDirty();
+        ++glyphAtlasEvictions;
+    }
+}
+
+void Renderer::Impl::uploadGlyphAtlas() {
+    const int size = kGlyphPageSize;
+    for (auto& p : glyphPages) {
+        if (!p.dirty()) continue;
+        if (!bgfx::isValid(p.tex)) { p.clearDirty(); continue; }
+        const uint16_t w = (uint16_t)(p.dirtyX1 - p.dirtyX0);
+        const uint16_t h = (uint16_t)(p.dirtyY1 - p.dirtyY0);
+        const bgfx::Memory* mem = bgfx::alloc((uint32_t)w * h);
+        for (uint16_t row = 0; row < h; ++row)
+            std::memcpy(mem->data + (size_t)row * w,
+                        p.shadow.data() + (size_t)(p.dirtyY0 + row) * size + p.dirtyX0, w);
+        bgfx::updateTexture2D(p.tex, 0, 0, p.dirtyX0, p.dirtyY0, w, h, mem, w);
+        p.clearDirty();
+    }
+}
+
+void Renderer::Impl::destroyGlyphAtlas() {
+    for (auto& p : glyphPages)
+        if (bgfx::isValid(p.tex)) bgfx::destroy(p.tex);
+    glyphPages.clear();
+    textRuns.clear();   // cached quads point into the pages
+}
+
 FontFace* Renderer::Impl::getFace(uint32_t fontId, float pixelHeight) {
     if (fontId >= fonts.size()) return nullptr;
-    int key = (int)(pixelHeight + 0.5f);
-    if (key < 1) key = 1;
     auto& rec = fonts[fontId];
+    int key = rec.sdf ? kSdfBasePx : (int)(pixelHeight + 0.5f);
+    if (key < 1) key = 1;
     auto it = rec.sizes.find(key);
     if (it != rec.sizes.end()) return &it->second;
 
-    // Parse font info from owning ttfData
-    stbtt_fontinfo info{};
-    if (!stbtt_InitFont(&info, rec.ttfData.data(),
-                       stbtt_GetFontOffsetForIndex(rec.ttfData.data(), 0))) {
-        return nullptr;
-    }
+    // The face shares the record's bytes rather than copying them.
     FontFace face;
-    initAtlasFace(face, info, rec.ttfData, (float)key);
+    initFace(face, rec.info, rec.ttf, (float)key);
+    face.sdf = rec.sdf;
     auto [insIt, ok] = rec.sizes.emplace(key, std::move(face));
     return &insIt->second;
 }
 
 const Glyph* Renderer::Impl::getGlyph(FontFace& face, uint32_t codepoint) {
-    auto it = face.glyphs.find(codepoint);
-    if (it != face.glyphs.end()) return &it->second;
-
-    int x0, y0, x1, y1;
-    stbtt_GetCodepointBitmapBox(&face.info, (int)codepoint,
-                                 face.scale, face.scale,
-                                 &x0, &y0, &x1, &y1);
-    int gw = x1 - x0;
-    int gh = y1 - y0;
-
-    int adv = 0, lsb = 0;
-    stbtt_GetCodepointHMetrics(&face.info, (int)codepoint, &adv, &lsb);
+    if (Glyph* hit = face.findGlyph(codepoint)) {
+        Glyph& cached = *hit;
+        if (cached.page != UINT16_MAX) {
+            auto& pg = glyphPages[cached.page];
+            if (bgfx::isValid(pg.tex) && pg.gen == cached.pageGen) {
+                pg.lastUsed = frameIndex;
+                return &cached;
+            }
+            // Page was evicted: fall through and re-rasterize.
+        } else if (cached.retryFrame == 0 || cached.retryFrame == frameIndex) {
+            return &cached;   // blank glyph, or atlas still full this frame
+        }
+    }
+    UILO_TRACE_ZONE("Renderer::getGlyph miss");
 
+    // Bitmap glyphs rasterize straight into the page shadow once they have
+    // a rect; SDF ones come from stb already and are copied in.
     Glyph g{};
-    g.xoff     = (float)x0;
-    g.yoff     = (float)y0;   // negative (above baseline)
-    g.xadvance = adv * face.scale;
+    int gw = 0, gh = 0;
+    unsigned char* sdfBmp = nullptr;
+    if (face.sdf) sdfBmp = sdfGlyph(face.info, face.scale, codepoint, g, gw, gh);
+    else          glyphBox(face.info, face.scale, codepoint, g, gw, gh);
 
     if (gw <= 0 || gh <= 0) {
+        if (sdfBmp) stbtt_FreeSDF(sdfBmp, nullptr);
         g.x = g.y = 0;
         g.w = g.h = 0;
-        return &face.glyphs.emplace(codepoint, g).first->second;
+        return face.storeGlyph(codepoint, g);
     }
 
-    // Reserve space in atlas
-    const int pad = 1;
-    if (face.penX + gw + pad >= face.atlasW) {
-        face.penX  = 1;
-        face.penY += face.rowH + pad;
-        face.rowH  = 0;
-    }
-    if (face.penY + gh + pad >= face.atlasH) {
-        // Atlas full — give up on this glyph (no visible draw)
+    uint16_t page = 0, ax = 0, ay = 0;
+    if (!allocGlyphRect(gw, gh, page, ax, ay)) {
+        // Atlas full of glyphs in use this frame: draw nothing for now and
+        // try again next frame, when colder pages become evictable.
+        if (sdfBmp) stbtt_FreeSDF(sdfBmp, nullptr);
+        g.x = g.y = 0;
         g.w = g.h = 0;
-        return &face.glyphs.emplace(codepoint, g).first->second;
+        g.retryFrame = frameIndex;
+        return face.storeGlyph(codepoint, g);
     }
 
-    // Render glyph into temp buffer
-    std::vector<uint8_t> bmp((size_t)gw * (size_t)gh, 0);
-    stbtt_MakeCodepointBitmap(&face.info, bmp.data(), gw, gh, gw,
-                              face.scale, face.scale, (int)codepoint);
-
-    // Upload subregion
-    const bgfx::Memory* mem = bgfx::copy(bmp.data(), (uint32_t)bmp.size());
-    bgfx::updateTexture2D(face.atlas, 0, 0,
-                          (uint16_t)face.penX, (uint16_t)face.penY,
-                          (uint16_t)gw, (uint16_t)gh,
-                          mem, (uint16_t)gw);
+    auto& pg = glyphPages[page];
+    if (sdfBmp) {
+        writeGlyph(pg, ax, ay, (uint16_t)gw, (uint16_t)gh, sdfBmp);
+        stbtt_FreeSDF(sdfBmp, nullptr);
+    } else {
+        stbtt_MakeCodepointBitmap(&face.info, pg.shadow.data() + (size_t)ay * kGlyphPageSize + ax,
+                                  gw, gh, kGlyphPageSize, face.scale, face.scale, (int)codepoint);
+        pg.markDirty(ax, ay, (uint16_t)gw, (uint16_t)gh);
+    }
+    pg.lastUsed = frameIndex;
 
-    g.x = (uint16_t)face.penX;
-    g.y = (uint16_t)face.penY;
+    g.x = ax;
+    g.y = ay;
     g.w = (uint16_t)gw;
     g.h = (uint16_t)gh;
-    face.penX += gw + pad;
-    if (gh > face.rowH) face.rowH = gh;
+    g.page    = page;
+    g.pageGen = pg.gen;
+    return face.storeGlyph(codepoint, g);
+}
 
-    return &face.glyphs.emplace(codepoint, g).first->second;
+void Renderer::setGlyphAtlasBudget(size_t bytes) {
+    m_impl->glyphAtlasBudget = bytes;
+    m_impl->trimGlyphAtlas();
 }
 
-Font Renderer::loadFont(const std::string& path) {
-    auto& impl = *m_impl;
+size_t Renderer::getGlyphAtlasBudget() const {
+    return m_impl->glyphAtlasBudget;
+}
+
+Font Renderer::loadFont(const std::string& path, bool sdf) {
+    Impl::CacheLock lock(*m_impl);
+    return m_impl->loadFontRecord(path, sdf);
+}
+
+Font Renderer::Impl::loadFontRecord(const std::string& path, bool sdf) {
+    auto& impl = *this;
+    const char* embeddedKey = sdf ? kEmbeddedSdfFontCacheKey : kEmbeddedFontCacheKey;
+    // SDF and bitmap records of one file are cached separately.
+    const std::string key = sdf ? path + kSdfCacheSuffix : path;
 
     auto loadEmbeddedFallback = [&]() -> Font {
-        auto itEmbedded = impl.fontByPath.find(kEmbeddedFontCacheKey);
+        auto itEmbedded = impl.fontByPath.find(embeddedKey);
         if (itEmbedded != impl.fontByPath.end()) {
             Font f; f.id = itEmbedded->second; return f;
         }
 
-        std::vector<uint8_t> ttf(EMBEDDED_FONT.begin(), EMBEDDED_FONT.end());
+        // Points straight at the embedded array: nothing is copied.
+        auto blob  = std::make_shared<FontBlob>();
+        blob->data = EMBEDDED_FONT.data();
+        blob->size = EMBEDDED_FONT.size();
         stbtt_fontinfo probe{};
-        if (!stbtt_InitFont(&probe, ttf.data(),
-                           stbtt_GetFontOffsetForIndex(ttf.data(), 0))) {
+        if (!initFontInfo(probe, *blob)) {
             std::fprintf(stderr, "[UILO] loadFont: embedded fallback font is invalid\n");
             return Font{};
         }
 
         Impl::FontRecord rec;
-        rec.ttfData = std::move(ttf);
+        rec.ttf  = std::move(blob);
+        rec.info = probe;
+        rec.sdf  = sdf;
         uint32_t id = (uint32_t)impl.fonts.size();
         impl.fonts.push_back(std::move(rec));
-        impl.fontByPath.emplace(kEmbeddedFontCacheKey, id);
+        impl.fontByPath.emplace(embeddedKey, id);
 
         Font f; f.id = id; return f;
     };
@@ -168,197 +362,624 @@ Font Renderer::loadFont(const std::string& path) {
         return loadEmbeddedFallback();
     }
 
-    auto it = impl.fontByPath.find(path);
+    auto it = impl.fontByPath.find(key);
     if (it != impl.fontByPath.end()) {
         Font f; f.id = it->second; return f;
     }
 
-    std::vector<uint8_t> ttf;
-    if (!readFile(path.c_str(), ttf)) {
+    // The bitmap and SDF records of one file share its bytes.
+    auto other = impl.fontByPath.find(sdf ? path : path + kSdfCacheSuffix);
+    if (other != impl.fontByPath.end()) {
+        Impl::FontRecord rec;
+        rec.ttf  = impl.fonts[other->second].ttf;
+        rec.info = impl.fonts[other->second].info;
+        rec.sdf  = sdf;
+        uint32_t id = (uint32_t)impl.fonts.size();
+        impl.fonts.push_back(std::move(rec));
+        impl.fontByPath.emplace(key, id);
+        Font f; f.id = id; return f;
+    }
+
+    // Mapped rather than read: a large font costs only the pages touched.
+    auto blob = std::make_shared<FontBlob>();
+    if (!blob->file.open(path.c_str())) {
         std::fprintf(stderr, "[UILO] loadFont: failed to read '%s', using embedded fallback\n", path.c_str());
         Font f = loadEmbeddedFallback();
-        if (f.valid()) impl.fontByPath.emplace(path, f.id);
+        if (f.valid()) impl.fontByPath.emplace(key, f.id);
         return f;
     }
 
+    blob->data = blob->file.data();
+    blob->size = blob->file.size();
+
     // Validate
     stbtt_fontinfo probe{};
-    if (!stbtt_InitFont(&probe, ttf.data(),
-                       stbtt_GetFontOffsetForIndex(ttf.data(), 0))) {
+    if (!initFontInfo(probe, *blob)) {
         std::fprintf(stderr, "[UILO] loadFont: invalid TTF '%s', using embedded fallback\n", path.c_str());
         Font f = loadEmbeddedFallback();
-        if (f.valid()) impl.fontByPath.emplace(path, f.id);
+        if (f.valid()) impl.fontByPath.emplace(key, f.id);
         return f;
     }
     Impl::FontRecord rec;
-    rec.ttfData = std::move(ttf);
+    rec.ttf  = std::move(blob);
+    rec.info = probe;
+    rec.sdf  = sdf;
     uint32_t id = (uint32_t)impl.fonts.size();
     impl.fonts.push_back(std::move(rec));
-    impl.fontByPath.emplace(path, id);
+    impl.fontByPath.emplace(key, id);
     Font f; f.id = id; return f;
 }
 
-TextMetrics Renderer::measureText(const std::string& utf8, const Font& font, float sizePx) {
-    TextMetrics m{};
-    if (!font.valid()) return m;
+// ---- Fallback chains -------------------------------------------------------
+
+void Renderer::setFontFallbacks(const Font& font, const std::vector<std::string>& paths) {
+    Impl::CacheLock lock(*m_impl);
     auto& impl = *m_impl;
-    FontFace* face = impl.getFace(font.id, sizePx);
-    if (!face) return m;
+    if (!font.valid() || font.id >= impl.fonts.size()) return;
+    auto& rec = impl.fonts[font.id];
+    rec.fallbacks.clear();
+    rec.resolved.clear();
+    for (const auto& p : paths) rec.fallbacks.push_back({p});
+    // Cached runs were shaped against the old chain.
+    impl.textRuns.clear();
+}
+
+uint32_t Renderer::Impl::resolveFont(uint32_t fontId, uint32_t codepoint) {
+    if (fontId >= fonts.size() || fonts[fontId].fallbacks.empty()) return fontId;
+    {
+        auto& rec = fonts[fontId];
+        if (stbtt_FindGlyphIndex(&rec.info, (int)codepoint) != 0) return fontId;
+        auto it = rec.resolved.find(codepoint);
+        if (it != rec.resolved.end()) return it->second;
+    }
+    uint32_t found = fontId;
+    for (size_t i = 0; i < fonts[fontId].fallbacks.size(); ++i) {
+        // Loading grows `fonts`, so the record is re-fetched every time.
+        if (!fonts[fontId].fallbacks[i].tried) {
+            const std::string path = fonts[fontId].fallbacks[i].path;
+            const Font f = loadFontRecord(path, fonts[fontId].sdf);
+            fonts[fontId].fallbacks[i].tried = true;
+            fonts[fontId].fallbacks[i].id    = f.id;
+        }
+        const uint32_t id = fonts[fontId].fallbacks[i].id;
+        if (id >= fonts.size() || id == fontId) continue;
+        if (stbtt_FindGlyphIndex(&fonts[id].info, (int)codepoint) != 0) { found = id; break; }
+    }
+    fonts[fontId].resolved.emplace(codepoint, found);
+    return found;
+}
 
-    m.ascent   = face->ascent;
-    m.descent  = face->descent;
-    m.lineGap  = face->lineGap;
+// ---- Glyph prewarming ----------------------------------------------------
 
-    float x = 0.f;
-    float maxX = 0.f;
-    int   lines = 1;
-    const char* s = utf8.data();
-    size_t left = utf8.size();
+void Renderer::prewarmFont(const Font& font, const std::vector<float>& sizesPx,
+                           const std::string& charset) {
+    Impl::CacheLock lock(*m_impl);
+    auto& impl = *m_impl;
+    if (!font.valid() || font.id >= impl.fonts.size()) return;
+    const bool sdf = impl.fonts[font.id].sdf;
+
+    std::vector<uint32_t> cps;
+    const char* s = charset.data();
+    size_t left = charset.size();
     uint32_t cp = 0;
     while (left > 0) {
         int n = utf8Decode(s, left, &cp);
         if (n <= 0) break;
-        s += n; left -= n;
+        s += n;
+        left -= (size_t)n;
+        if (cp >= 0x20) cps.push_back(cp);
+    }
+    std::sort(cps.begin(), cps.end());
+    cps.erase(std::unique(cps.begin(), cps.end()), cps.end());
+    if (cps.empty()) return;
+
+    // Each codepoint is baked in the font of the chain that will draw it
+    // (loading fallbacks now rather than mid-frame).
+    std::vector<std::pair<uint32_t, uint32_t>> byFont;   // (font id, codepoint)
+    for (uint32_t c : cps) byFont.emplace_back(impl.resolveFont(font.id, c), c);
+    std::stable_sort(byFont.begin(), byFont.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // Same face keys getFace() uses; an SDF font has the one.
+    std::vector<int> keys;
+    for (float px : sizesPx) keys.push_back(sdf ? Impl::kSdfBasePx : std::max(1, (int)(px + 0.5f)));
+    if (sdf && keys.empty()) keys.push_back(Impl::kSdfBasePx);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    for (size_t first = 0; first < byFont.size();) {
+        const uint32_t fid = byFont[first].first;
+        size_t last = first;
+        while (last < byFont.size() && byFont[last].first == fid) ++last;
+        const auto& rec = impl.fonts[fid];
+        for (int key : keys) {
+            std::vector<uint32_t> todo;
+            auto face = rec.sizes.find(key);
+            for (size_t i = first; i < last; ++i) {
+                const uint32_t c = byFont[i].second;
+                if (face != rec.sizes.end()) {
+                    const Glyph* g = face->second.findGlyph(c);
+                    if (g && glyphUsable(*g, impl.glyphPages)) continue;
+                }
+                todo.push_back(c);
+            }
+            if (!todo.empty()) impl.glyphBaker.push(fid, key, rec.sdf, rec.ttf, std::move(todo));
+        }
+        first = last;
+    }
+}
+
+void Renderer::prewarmRescaledText(float ratio) {
+    if (!(ratio > 0.f) || ratio == 1.f) return;
+    constexpr uint32_t kRecentFrames = 60;
+    // (font, size) -> the text of its recent runs; prewarmFont dedupes.
+    std::map<std::pair<uint32_t, float>, std::string> bySize;
+    {
+        Impl::CacheLock lock(*m_impl);
+        auto& impl = *m_impl;
+        for (const auto& [key, run] : impl.textRuns) {
+            if (run.sdf || impl.frameIndex - run.lastUsed > kRecentFrames) continue;
+            bySize[{run.fontId, run.sizePx}] += run.text;
+        }
+    }
+    for (const auto& [fs, text] : bySize) {
+        Font f;
+        f.id = fs.first;
+        prewarmFont(f, {fs.second * ratio}, text);
+    }
+}
+
+bool Renderer::isFontPrewarming() const {
+    Impl::CacheLock lock(*m_impl);
+    return m_impl->glyphBaker.busy() || !m_impl->glyphUploads.empty();
+}
+
+void Renderer::Impl::pumpGlyphBakes() {
+    glyphBaker.drain(glyphUploads);
+    if (glyphUploads.empty()) return;
+    UILO_TRACE_ZONE("Renderer::pumpGlyphBakes");
+
+    size_t bytes = 0;
+    while (!glyphUploads.empty()) {
+        auto& r = glyphUploads.front();
+        FontFace* face = getFace(r.fontId, (float)r.sizeKey);
+        for (; face && glyphUploadNext < r.glyphs.size(); ++glyphUploadNext) {
+            if (bytes >= kGlyphUploadBudget) return;
+            const auto& b = r.glyphs[glyphUploadNext];
+            const Glyph* have = face->findGlyph(b.codepoint);
+            if (have && glyphUsable(*have, glyphPages)) continue;
+
+            Glyph g = b.glyph;
+            if (g.w == 0 || g.h == 0) { face->storeGlyph(b.codepoint, g); continue; }
+            uint16_t page = 0, ax = 0, ay = 0;
+            // A full atlas leaves the rest to bake on demand as usual.
+            if (!allocGlyphRect(g.w, g.h, page, ax, ay)) continue;
+            auto& pg = glyphPages[page];
+            writeGlyph(pg, ax, ay, g.w, g.h, r.pixels.data() + b.offset);
+            pg.lastUsed = frameIndex;
+
+            g.x = ax;
+            g.y = ay;
+            g.page    = page;
+            g.pageGen = pg.gen;
+            face->storeGlyph(b.codepoint, g);
+            bytes += (size_t)g.w * g.h;
+        }
+        glyphUploads.erase(glyphUploads.begin());
+        glyphUploadNext = 0;
+    }
+}
+
+void GlyphBakeQueue::push(uint32_t fontId, int sizeKey, bool sdf, FontBlobPtr ttf,
+                          std::vector<uint32_t> codepoints) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_worker.joinable()) {
+            m_stop   = false;
+            m_worker = std::thread([this] { workerLoop(); });
+        }
+        m_queue.push_back(Request{fontId, sizeKey, sdf, std::move(ttf), std::move(codepoints)});
+    }
+    m_wake.notify_one();
+}
+
+void GlyphBakeQueue::drain(std::vector<Result>& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& r : m_done) out.push_back(std::move(r));
+    m_done.clear();
+}
+
+bool GlyphBakeQueue::busy() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_queue.empty() || m_baking > 0 || !m_done.empty();
+}
+
+void GlyphBakeQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+    if (m_worker.joinable()) m_worker.join();
+    m_done.clear();
+    m_baking = 0;
+}
+
+void GlyphBakeQueue::workerLoop() {
+    // Batches this many glyphs, so uploads start before a large charset
+    // has finished baking.
+    constexpr size_t kChunk = 128;
+    for (;;) {
+        Request req;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_stop) return;
+            req = std::move(m_queue.front());
+            m_queue.pop_front();
+            ++m_baking;
+        }
+
+        stbtt_fontinfo info{};
+        const bool ok = req.ttf && initFontInfo(info, *req.ttf);
+        const float scale = ok ? stbtt_ScaleForPixelHeight(&info, (float)req.sizeKey) : 0.f;
+        for (size_t i = 0; ok && i < req.codepoints.size(); i += kChunk) {
+            Result r;
+            r.fontId  = req.fontId;
+            r.sizeKey = req.sizeKey;
+            const size_t end = std::min(req.codepoints.size(), i + kChunk);
+            for (size_t c = i; c < end; ++c) {
+                GlyphBakeQueue::Baked b;
+                b.codepoint = req.codepoints[c];
+                b.offset    = r.pixels.size();
+                int gw = 0, gh = 0;
+                rasterizeGlyph(info, scale, req.sdf, b.codepoint, b.glyph, gw, gh, r.pixels);
+                // Too big for a page: leave it to getGlyph, which gives up the same way.
+                if (gw + 2 * kGlyphPad > Renderer::Impl::kGlyphPageSize ||
+                    gh + 2 * kGlyphPad > Renderer::Impl::kGlyphPageSize) {
+                    r.pixels.resize(b.offset);
+                    continue;
+                }
+                b.glyph.w = (uint16_t)std::max(gw, 0);
+                b.glyph.h = (uint16_t)std::max(gh, 0);
+                r.glyphs.push_back(b);
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stop) break;
+            m_done.push_back(std::move(r));
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_baking;
+    }
+}
+
+namespace {
+uint64_t textRunKey(const std::string& utf8, uint32_t fontId, float sizePx) {
+    uint32_t sizeBits = 0;
+    std::memcpy(&sizeBits, &sizePx, sizeof(sizeBits));
+    uint64_t h = std::hash<std::string>{}(utf8);
+    const uint64_t tag = ((uint64_t)fontId << 32) | sizeBits;
+    h ^= tag * 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+bool textRunQuadsLive(const TextRun& run, const std::vector<GlyphAtlasPage>& pages) {
+    for (const auto& q : run.quads) {
+        const auto& pg = pages[q.page];
+        if (!bgfx::isValid(pg.tex) || pg.gen != q.pageGen) return false;
+    }
+    return true;
+}
+} // anon
+
+const TextRun* Renderer::Impl::getTextRun(const std::string& utf8, uint32_t fontId,
+                                          float sizePx) {
+    const uint64_t key = textRunKey(utf8, fontId, sizePx);
+    auto it = textRuns.find(key);
+    if (it != textRuns.end()) {
+        TextRun& run = it->second;
+        if (run.fontId == fontId && run.sizePx == sizePx && run.text == utf8 &&
+            (run.retryFrame == 0 || run.retryFrame == frameIndex) &&
+            textRunQuadsLive(run, glyphPages)) {
+            for (const auto& q : run.quads) glyphPages[q.page].lastUsed = frameIndex;
+            run.lastUsed = frameIndex;
+            ++textRunHits;
+            return &run;
+        }
+    }
+    ++textRunMisses;
+
+    FontFace* face = getFace(fontId, sizePx);
+    if (!face) return nullptr;
+    const float k  = faceScale(*face, sizePx);
+    const float lh = (face->ascent + face->descent + face->lineGap) * k;
+    const float inv = 1.f / (float)kGlyphPageSize;
+
+    TextRun& run = textRuns[key];
+    run.text       = utf8;
+    run.fontId     = fontId;
+    run.sizePx     = sizePx;
+    run.sdf        = face->sdf;
+    run.lastUsed   = frameIndex;
+    run.retryFrame = 0;
+    run.positions.clear();
+    run.quads.clear();
+    run.positions.push_back({0.f, 0.f});
+
+    TextMetrics& m = run.metrics;
+    m = TextMetrics{};
+    m.ascent  = face->ascent  * k;
+    m.descent = face->descent * k;
+    m.lineGap = face->lineGap * k;
+
+    float x = 0.f;
+    float y = 0.f;
+    float maxX = 0.f;
+    int   lines = 1;
+    auto place = [&](uint32_t cp) {
         if (cp == '\n') {
             if (x > maxX) maxX = x;
             x = 0.f;
+            y += lh;
             ++lines;
-            continue;
+        } else if (cp != '\r') {
+            // Codepoints the font lacks come from its fallback chain, on the
+            // primary's baseline; every font shares the atlas, so the run
+            // still draws as one batch. Loading a fallback adds to `fonts`,
+            // a deque, so `face` stays valid across resolveFont.
+            FontFace* gface = face;
+            float     gk    = k;
+            const uint32_t fid = resolveFont(fontId, cp);
+            if (fid != fontId) {
+                if (FontFace* fb = getFace(fid, sizePx)) { gface = fb; gk = faceScale(*fb, sizePx); }
+            }
+            const Glyph* g = getGlyph(*gface, cp);
+            if (g) {
+                if (g->w > 0 && g->h > 0) {
+                    TextRunQuad q;
+                    q.x  = x + g->xoff * gk;
+                    q.y  = y + m.ascent + g->yoff * gk;
+                    q.w  = (float)g->w * gk;
+                    q.h  = (float)g->h * gk;
+                    q.u0 = g->x * inv;
+                    q.v0 = g->y * inv;
+                    q.u1 = (g->x + g->w) * inv;
+                    q.v1 = (g->y + g->h) * inv;
+                    q.page    = g->page;
+                    q.pageGen = g->pageGen;
+                    run.quads.push_back(q);
+                } else if (g->retryFrame != 0) {
+                    run.retryFrame = frameIndex;
+                }
+                x += g->xadvance * gk;
+            }
         }
-        const Glyph* g = impl.getGlyph(*face, cp);
-        if (g) x += g->xadvance;
+        run.positions.push_back({x, y});
+    };
+    // Pure-ASCII stretches skip the decoder: each byte is its codepoint.
+    const char* s = utf8.data();
+    size_t left = utf8.size();
+    while (left > 0) {
+        const size_t ascii = asciiPrefixLength(s, left);
+        for (size_t i = 0; i < ascii; ++i) place((uint8_t)s[i]);
+        s += ascii; left -= ascii;
+        if (left == 0) break;
+        uint32_t cp = 0;
+        int n = utf8Decode(s, left, &cp);
+        if (n <= 0) break;
+        s += n; left -= n;
+        place(cp);
     }
     if (x > maxX) maxX = x;
     m.size.x = maxX;
     m.size.y = m.lineHeight() * (float)lines - m.lineGap;
-    return m;
+    return &run;
+}
+
+void Renderer::Impl::trimTextRuns() {
+    if (textRuns.size() <= kTextRunCacheSoftMax) return;
+    for (auto it = textRuns.begin(); it != textRuns.end();) {
+        if (frameIndex - it->second.lastUsed > kTextRunMaxAge) it = textRuns.erase(it);
+        else ++it;
+    }
+}
+
+TextMetrics Renderer::measureText(const std::string& utf8, const Font& font, float sizePx) {
+    Impl::CacheLock lock(*m_impl);
+    if (!font.valid()) return TextMetrics{};
+    const TextRun* run = m_impl->getTextRun(utf8, font.id, sizePx);
+    return run ? run->metrics : TextMetrics{};
+}
+
+float Renderer::Impl::glyphAdvance(FontFace& face, uint32_t codepoint) {
+    if (codepoint < 128 && face.asciiAdvance[codepoint] >= 0.f)
+        return face.asciiAdvance[codepoint];
+    if (codepoint >= 128) {
+        auto it = face.advances.find(codepoint);
+        if (it != face.advances.end()) return it->second;
+    }
+    // Same metric getGlyph() stores as Glyph::xadvance.
+    int adv = 0, lsb = 0;
+    stbtt_GetCodepointHMetrics(&face.info, (int)codepoint, &adv, &lsb);
+    const float a = adv * face.scale;
+    if (codepoint < 128) face.asciiAdvance[codepoint] = a;
+    else                 face.advances.emplace(codepoint, a);
+    return a;
+}
+
+void Renderer::glyphAdvances(std::u32string_view text, const Font& font, float sizePx,
+                             float* out) {
+    Impl::CacheLock lock(*m_impl);
+    FontFace* face = font.valid() ? m_impl->getFace(font.id, sizePx) : nullptr;
+    if (!face) {
+        std::fill(out, out + text.size(), 0.f);
+        return;
+    }
+    const float k = faceScale(*face, sizePx);
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char32_t cp = text[i];
+        if (cp == U'\n' || cp == U'\r') { out[i] = 0.f; continue; }
+        // Same fallback resolution as getTextRun, so widths match the draw
+        // (and `face` outlives any fallback it loads the same way).
+        const uint32_t fid = m_impl->resolveFont(font.id, cp);
+        FontFace* gface = fid != font.id ? m_impl->getFace(fid, sizePx) : nullptr;
+        out[i] = gface ? m_impl->glyphAdvance(*gface, cp) * faceScale(*gface, sizePx)
+                       : m_impl->glyphAdvance(*face, cp) * k;
+    }
 }
 
 std::vector<Vec2f> Renderer::charPositions(const std::string& utf8,
                                             const Font& font, float sizePx) {
-    std::vector<Vec2f> out;
-    out.push_back({0.f, 0.f});
-    if (!font.valid()) return out;
-    auto& impl = *m_impl;
-    FontFace* face = impl.getFace(font.id, sizePx);
-    if (!face) return out;
+    Impl::CacheLock lock(*m_impl);
+    const TextRun* run = font.valid() ? m_impl->getTextRun(utf8, font.id, sizePx) : nullptr;
+    if (!run) return {Vec2f{0.f, 0.f}};
+    return run->positions;
+}
 
-    const float lh = face->ascent + face->descent + face->lineGap;
-    float x = 0.f;
-    float y = 0.f;
+uint16_t Renderer::Impl::reserveTextBatch(uint16_t viewId, bgfx::TextureHandle atlas,
+                                          bgfx::ProgramHandle program,
+                                          uint32_t numVerts) {
+    auto& rec = rs();
+    // Mirrors reserveSolidBatch(): the atlas and program are more state that
+    // breaks the batch, since the whole submit samples a single texture.
+    flushSolidBatch(FlushReason::Switch);
+    flushShapeBatch(FlushReason::Switch);
+    if (!rec.textBatchVerts.empty()) {
+        if (rec.textBatchVerts.size() + numVerts > kBatchMaxVerts)
+            flushTextBatch(FlushReason::Capacity);
+        else if (rec.textBatchAtlas.idx != atlas.idx ||
+                 rec.textBatchProgram.idx != program.idx ||
+                 !batchStateMatches(rec.textBatch, viewId))
+            flushTextBatch(FlushReason::State);
+    }
+    if (rec.textBatchVerts.empty()) {
+        captureBatchState(rec.textBatch, viewId);
+        rec.textBatchAtlas   = atlas;
+        rec.textBatchProgram = program;
+    }
+#if UILO_PROFILER
+    rec.verticesQueued += numVerts;
+#endif
+    return (uint16_t)rec.textBatchVerts.size();
+}
 
-    const char* s = utf8.data();
-    size_t left = utf8.size();
-    uint32_t cp = 0;
-    while (left > 0) {
-        int n = utf8Decode(s, left, &cp);
-        if (n <= 0) break;
-        s += n; left -= n;
-        if (cp == '\n') {
-            x = 0.f;
-            y += lh;
-        } else if (cp == '\r') {
-            // skip; matches drawText
-        } else {
-            const Glyph* g = impl.getGlyph(*face, cp);
-            if (g) x += g->xadvance;
+void Renderer::Impl::flushTextBatch(FlushReason why) {
+    auto& rec = rs();
+    if (rec.textBatchVerts.empty() || rec.textBatch.view == UINT16_MAX ||
+        !bgfx::isValid(rec.textBatchProgram) || !bgfx::isValid(rec.textBatchAtlas)) {
+        rec.textBatchVerts.clear();
+        rec.textBatchIdx.clear();
+        rec.textBatch.view = UINT16_MAX;
+        return;
+    }
+    const uint32_t numV = (uint32_t)rec.textBatchVerts.size();
+    const uint32_t numI = (uint32_t)rec.textBatchIdx.size();
+    bgfx::Encoder* enc = this->enc();
+    if (setBatchGeometry(enc, true, rec.textBatchVerts.data(), numV, rec.textBatchIdx.data(), numI)) {
+        enc->setTexture(0, s_texColor, rec.textBatchAtlas);
+        if (rec.textBatchProgram.idx == texProgram.idx) {
+            // Batched drawImage quads: no ellipse mask.
+            const float flags[4] = { 0.f, 0.f, 0.f, 0.f };
+            enc->setUniform(u_imgFlags, flags);
         }
-        out.push_back({x, y});
+        enc->setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                       blendState(rec.textBatch.view));
+        applyBatchState(rec.textBatch);
+        enc->submit(rec.textBatch.view, rec.textBatchProgram);
+        ++rec.batchedSubmits;
+        ++rec.flushes[(size_t)why];
+        hashSceneState(rec.textBatch);
+        hashScene(rec.textBatch.view, rec.textBatchVerts.data(), numV * sizeof(PosColorUvVertex));
+        hashScene(rec.textBatch.view, rec.textBatchIdx.data(),   numI * sizeof(uint16_t));
+        hashSceneValue(rec.textBatch.view, rec.textBatchAtlas.idx);
+        hashSceneValue(rec.textBatch.view, rec.textBatchProgram.idx);
     }
-    return out;
+    if (!rec.recordingLists.empty())
+        recordFlush(true, rec.textBatch, rec.textBatchProgram, rec.textBatchAtlas);
+    rec.textBatchVerts.clear();
+    rec.textBatchIdx.clear();
+    rec.textBatch.view = UINT16_MAX;
 }
 
 void Renderer::drawText(const std::string& utf8, Vec2f position,
                          const Font& font, float sizePx, Color color) {
     if (!font.valid() || utf8.empty()) return;
     auto& impl = *m_impl;
-    impl.flushSolidBatch();
-    if (!bgfx::isValid(impl.textProgram) || scissorEmpty(impl)) return;
-
-    FontFace* face = impl.getFace(font.id, sizePx);
-    if (!face || !bgfx::isValid(face->atlas)) return;
-
-    // Single pass: allocate transient space for the worst case (one quad per
-    // UTF-8 byte, an upper bound on codepoints) and submit only the range
-    // actually filled. This avoids a separate pre-count pass that would
-    // decode the string and hit the glyph cache twice per draw. Cap at the
-    // 16-bit index range; longer strings truncate (they produced garbage
-    // indices before, so nothing sane is lost).
-    const uint32_t maxQuads =
-        (uint32_t)std::min<size_t>(utf8.size(), 65532u / 4u);
-    bgfx::TransientVertexBuffer tvb;
-    bgfx::TransientIndexBuffer  tib;
-    if (!bgfx::allocTransientBuffers(&tvb, impl.texLayout, maxQuads * 4,
-                                     &tib, maxQuads * 6))
-        return;
-
-    auto* verts = reinterpret_cast<PosColorUvVertex*>(tvb.data);
-    auto* idx   = reinterpret_cast<uint16_t*>(tib.data);
-
-    uint32_t col = packColor(color);
-    const float invW = 1.f / (float)face->atlasW;
-    const float invH = 1.f / (float)face->atlasH;
-
-    float penX = position.x;
-    float penY = position.y + face->ascent;   // baseline
-    uint32_t vi = 0, ii = 0;
-
-    const char* s = utf8.data();
-    size_t left = utf8.size();
-    uint32_t cp = 0;
-    while (left > 0) {
-        int n = utf8Decode(s, left, &cp);
-        if (n <= 0) break;
-        s += n; left -= n;
-        if (cp == '\n') {
-            penX  = position.x;
-            penY += face->ascent + face->descent + face->lineGap;
-            continue;
+    auto& rec = impl.rs();
+    if (scissorEmpty(impl)) return;
+
+    // The run and its pages live in shared caches another slice may be
+    // reshaping, so while slices record they're copied out under the lock.
+    const TextRunQuad* quads = nullptr;
+    size_t numQuads = 0;
+    bool   sdf      = false;
+    Rectf  ink;                       // run-local bounds of the glyph quads
+    {
+        Impl::CacheLock lock(impl);
+        const TextRun* run = impl.getTextRun(utf8, font.id, sizePx);
+        if (!run || run->quads.empty()) return;
+        sdf      = run->sdf;
+        numQuads = run->quads.size();
+        quads    = run->quads.data();
+        if (impl.parallelRecording) {
+            rec.textQuads.assign(run->quads.begin(), run->quads.end());
+            quads = rec.textQuads.data();
         }
-        if (cp == '\r') continue;
-
-        const Glyph* g = impl.getGlyph(*face, cp);
-        if (!g) continue;
-
-        if (g->w > 0 && g->h > 0 && vi + 4 <= maxQuads * 4) {
-            float gx = std::floor(penX + g->xoff + 0.5f);
-            float gy = std::floor(penY + g->yoff + 0.5f);
-            float gw = (float)g->w;
-            float gh = (float)g->h;
-            float u0 = g->x * invW;
-            float v0 = g->y * invH;
-            float u1 = (g->x + g->w) * invW;
-            float v1 = (g->y + g->h) * invH;
-
-            uint16_t base = (uint16_t)vi;
-            float p0x = gx,      p0y = gy;
-            float p1x = gx + gw, p1y = gy;
-            float p2x = gx + gw, p2y = gy + gh;
-            float p3x = gx,      p3y = gy + gh;
-            impl.rotPt(p0x, p0y); impl.rotPt(p1x, p1y);
-            impl.rotPt(p2x, p2y); impl.rotPt(p3x, p3y);
-            verts[vi++] = {p0x, p0y, col, u0, v0};
-            verts[vi++] = {p1x, p1y, col, u1, v0};
-            verts[vi++] = {p2x, p2y, col, u1, v1};
-            verts[vi++] = {p3x, p3y, col, u0, v1};
-            idx[ii++] = base;
-            idx[ii++] = (uint16_t)(base + 1);
-            idx[ii++] = (uint16_t)(base + 2);
-            idx[ii++] = base;
-            idx[ii++] = (uint16_t)(base + 2);
-            idx[ii++] = (uint16_t)(base + 3);
+        rec.textPages.clear();
+        float x0 = quads[0].x, y0 = quads[0].y, x1 = x0, y1 = y0;
+        for (size_t i = 0; i < numQuads; ++i) {
+            const TextRunQuad& q = quads[i];
+            rec.textPages.push_back(impl.glyphPages[q.page].tex);
+            x0 = std::min(x0, q.x); x1 = std::max(x1, q.x + q.w);
+            y0 = std::min(y0, q.y); y1 = std::max(y1, q.y + q.h);
         }
-        penX += g->xadvance;
+        ink = {x0, y0, x1 - x0, y1 - y0};
     }
-    if (ii == 0) return;   // whitespace-only: nothing to submit
+    // A pixel of slack for the bitmap glyphs' snapping.
+    if (impl.rejectDraw({position + ink.position, ink.size}, 1.f)) return;
+    const bgfx::ProgramHandle program = sdf ? impl.textSdfProgram : impl.textProgram;
+    if (!bgfx::isValid(program)) return;
+
+    // Cached glyph quads go straight into the text batch, so consecutive
+    // labels under the same clip and atlas page share one submit. The batch
+    // flushes itself before it would overflow 16-bit indices, which means
+    // long strings are no longer truncated.
+    const uint16_t view = currentViewId();
+    uint32_t col = packColor(color);
+    const float clip = (float)impl.clipNodeId();
+
+    for (size_t i = 0; i < numQuads; ++i) {
+        const TextRunQuad& q = quads[i];
+        // Bitmap glyphs snap to whole pixels to stay crisp; SDF glyphs are
+        // resolution independent and keep sub-pixel placement.
+        float gx = position.x + q.x;
+        float gy = position.y + q.y;
+        if (!sdf) {
+            gx = std::floor(gx + 0.5f);
+            gy = std::floor(gy + 0.5f);
+        }
 
-    bgfx::setTexture(0, impl.s_texColor, face->atlas);
-    bgfx::setVertexBuffer(0, &tvb, 0, vi);
-    bgfx::setIndexBuffer(&tib, 0, ii);
-    bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                   BGFX_STATE_BLEND_ALPHA);
-    applyScissor(impl);
-    bgfx::submit(currentViewId(), impl.textProgram);
+        float p0x = gx,       p0y = gy;
+        float p1x = gx + q.w, p1y = gy;
+        float p2x = gx + q.w, p2y = gy + q.h;
+        float p3x = gx,       p3y = gy + q.h;
+        impl.xformPt(p0x, p0y); impl.xformPt(p1x, p1y);
+        impl.xformPt(p2x, p2y); impl.xformPt(p3x, p3y);
+
+        const uint16_t base = impl.reserveTextBatch(view, rec.textPages[i], program, 4);
+        rec.textBatchVerts.push_back({p0x, p0y, col, q.u0, q.v0, clip});
+        rec.textBatchVerts.push_back({p1x, p1y, col, q.u1, q.v0, clip});
+        rec.textBatchVerts.push_back({p2x, p2y, col, q.u1, q.v1, clip});
+        rec.textBatchVerts.push_back({p3x, p3y, col, q.u0, q.v1, clip});
+        rec.textBatchIdx.push_back(base);
+        rec.textBatchIdx.push_back((uint16_t)(base + 1));
+        rec.textBatchIdx.push_back((uint16_t)(base + 2));
+        rec.textBatchIdx.push_back(base);
+        rec.textBatchIdx.push_back((uint16_t)(base + 2));
+        rec.textBatchIdx.push_back((uint16_t)(base + 3));
+    }
 }
 
 } // namespace uilo
@@ -1,36 +1,30 @@
 #include "RendererImpl.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
-#define STBI_NO_STDIO   // we'll feed a buffer; actually keep stdio for stbi_load
-#undef  STBI_NO_STDIO
+#define STBI_NO_STDIO   // files are mapped and decoded from memory (decodeFile)
 #include "stb_image.h"
 
+#include "../assets/EmbeddedIcons.hpp"
+#include "../utils/ImageResample.hpp"
+#include "../utils/MappedFile.hpp"
+
 namespace uilo {
 
 // applyScissor / scissorEmpty / clip-uniform helpers are shared inlines in
 // RendererImpl.hpp.
 
-Texture Renderer::loadTexture(const std::string& path) {
-    auto& impl = *m_impl;
-    auto it = impl.textureCache.find(path);
-    if (it != impl.textureCache.end()) return it->second;
+namespace {
 
-    int w = 0, h = 0, comp = 0;
-    stbi_uc* pixels = stbi_load(path.c_str(), &w, &h, &comp, 4);
-    if (!pixels) {
-        std::fprintf(stderr, "[UILO] loadTexture: failed to load '%s': %s\n",
-                     path.c_str(), stbi_failure_reason());
-        Texture invalid;
-        impl.textureCache.emplace(path, invalid);
-        return invalid;
-    }
+constexpr const char* kEmbeddedFolderIconKey = "__UILO_EMBEDDED_FOLDER_ICON__";
+constexpr const char* kEmbeddedFileIconKey   = "__UILO_EMBEDDED_FILE_ICON__";
 
+// Immutable RGBA8 texture over a copy of `rgba` (the whole mip chain,
+// largest level first, when `mips`).
+Texture createImageTexture(const std::vector<uint8_t>& rgba, uint16_t w, uint16_t h, bool mips) {
     // bgfx::TextureFormat::RGBA8 expects RGBA bytes (matches stb_image's req_comp=4)
-    const bgfx::Memory* mem = bgfx::copy(pixels, (uint32_t)(w * h * 4));
-    stbi_image_free(pixels);
-
+    const bgfx::Memory* mem = bgfx::copy(rgba.data(), (uint32_t)rgba.size());
     bgfx::TextureHandle th = bgfx::createTexture2D(
-        (uint16_t)w, (uint16_t)h, false, 1,
+        w, h, mips, 1,
         bgfx::TextureFormat::RGBA8,
         BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP |
         BGFX_SAMPLER_MIN_ANISOTROPIC | BGFX_SAMPLER_MAG_ANISOTROPIC,
@@ -38,19 +32,414 @@ Texture Renderer::loadTexture(const std::string& path) {
 
     Texture tex;
     tex.handle = th.idx;
-    tex.width  = (uint16_t)w;
-    tex.height = (uint16_t)h;
-    impl.textureCache.emplace(path, tex);
+    tex.width  = w;
+    tex.height = h;
     return tex;
 }
 
+// Decodes an image file to RGBA8 straight from a mapping of it, so the
+// encoded bytes are never copied onto the heap. On failure returns
+// nullptr with `error` set.
+stbi_uc* decodeFile(const char* path, int& w, int& h, const char*& error) {
+    MappedFile file;
+    if (!file.open(path)) { error = "can't open file"; return nullptr; }
+    if (file.size() > (size_t)INT32_MAX) { error = "file too large"; return nullptr; }
+    int comp = 0;
+    stbi_uc* pixels = stbi_load_from_memory(file.data(), (int)file.size(), &w, &h, &comp, 4);
+    if (!pixels) error = stbi_failure_reason();
+    return pixels;
+}
+
+// Resamples stb output per `opts` into r.rgba / width / height (or sets
+// r.error) and frees it. Runs on the decode workers as well as the render
+// thread.
+void finishDecode(stbi_uc* pixels, int w, int h, const TextureLoadOptions& opts,
+                  TextureDecodeQueue::Result& r) {
+    if (!pixels) { r.error = stbi_failure_reason(); return; }
+
+    // Fit inside the requested box, keeping the aspect; never upscale.
+    float scale = 1.f;
+    if (opts.maxWidth  > 0) scale = std::min(scale, (float)opts.maxWidth  / (float)w);
+    if (opts.maxHeight > 0) scale = std::min(scale, (float)opts.maxHeight / (float)h);
+    const int dw = std::max(1, (int)std::lround((float)w * scale));
+    const int dh = std::max(1, (int)std::lround((float)h * scale));
+    if (dw > UINT16_MAX || dh > UINT16_MAX) {
+        stbi_image_free(pixels);
+        r.error = "image too large";
+        return;
+    }
+
+    size_t total = (size_t)dw * (size_t)dh * 4;
+    if (opts.mipmaps)
+        for (int lw = dw, lh = dh; lw > 1 || lh > 1;) {
+            lw = std::max(1, lw / 2);
+            lh = std::max(1, lh / 2);
+            total += (size_t)lw * (size_t)lh * 4;
+        }
+    r.rgba.resize(total);
+    if (dw == w && dh == h)
+        std::memcpy(r.rgba.data(), pixels, (size_t)w * (size_t)h * 4);
+    else
+        boxDownsampleRgba(pixels, w, h, r.rgba.data(), dw, dh);
+    stbi_image_free(pixels);
+
+    // Each level is the 2x2 box of the one before it.
+    uint8_t* level = r.rgba.data();
+    for (int lw = dw, lh = dh; opts.mipmaps && (lw > 1 || lh > 1);) {
+        const int nw = std::max(1, lw / 2), nh = std::max(1, lh / 2);
+        uint8_t* next = level + (size_t)lw * (size_t)lh * 4;
+        boxDownsampleRgba(level, lw, lh, next, nw, nh);
+        level = next;
+        lw = nw;
+        lh = nh;
+    }
+    r.width  = (uint16_t)dw;
+    r.height = (uint16_t)dh;
+    r.mips   = opts.mipmaps;
+}
+
+void decodeImage(TextureDecodeQueue::Result& r, const TextureLoadOptions& opts) {
+    int w = 0, h = 0;
+    const char* error = nullptr;
+    stbi_uc* pixels = decodeFile(r.path.c_str(), w, h, error);
+    if (!pixels) { r.error = error; return; }
+    finishDecode(pixels, w, h, opts, r);
+}
+
+} // namespace
+
+std::string Renderer::Impl::textureKey(const std::string& path, const TextureLoadOptions& opts) {
+    if (opts.maxWidth == 0 && opts.maxHeight == 0 && !opts.mipmaps) return path;
+    return path + '\n' + std::to_string(opts.maxWidth) + 'x' +
+           std::to_string(opts.maxHeight) + (opts.mipmaps ? "m" : "");
+}
+
+Texture Renderer::Impl::cacheTexture(const std::string& key, const Texture& tex,
+                                     uint64_t bytes, bool atlased) {
+    auto [it, added] = textureCache.try_emplace(key);
+    TextureEntry& e = it->second;
+    if (added) {
+        e.tex     = tex;
+        e.bytes   = tex.valid() ? bytes : 0;
+        e.atlased = atlased;
+        textureBytes += e.bytes;
+    } else if (tex.valid() && !atlased) {
+        bgfx::TextureHandle h{ tex.handle };
+        bgfx::destroy(h);
+    }
+    e.lastUsed = frameIndex;
+    return e.tex;
+}
+
+void Renderer::Impl::trimTextures() {
+    // Failed loads are free to keep but shouldn't stick forever: the file
+    // may turn up later.
+    for (auto it = textureCache.begin(); it != textureCache.end();) {
+        const TextureEntry& e = it->second;
+        if (!e.tex.valid() && e.refs == 0 && frameIndex - e.lastUsed > kFailedTextureMaxAge)
+            it = textureCache.erase(it);
+        else
+            ++it;
+    }
+    if (textureBudget == 0 || textureBytes <= textureBudget) return;
+
+    std::vector<std::pair<uint32_t, const std::string*>> lru;
+    for (const auto& kv : textureCache)
+        if (kv.second.refs == 0 && kv.second.tex.valid() && !kv.second.atlased)
+            lru.emplace_back(kv.second.lastUsed, &kv.first);
+    std::sort(lru.begin(), lru.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& [lastUsed, path] : lru) {
+        if (textureBytes <= textureBudget) break;
+        (void)lastUsed;
+        auto it = textureCache.find(*path);
+        bgfx::TextureHandle h{ it->second.tex.handle };
+        bgfx::destroy(h);
+        textureBytes -= it->second.bytes;
+        ++textureEvictions;
+        textureCache.erase(it);
+    }
+}
+
+void Renderer::setTextureBudget(uint64_t bytes) { m_impl->textureBudget = bytes; }
+uint64_t Renderer::getTextureBudget() const    { return m_impl->textureBudget; }
+
+void Renderer::retainTexture(const std::string& path, const TextureLoadOptions& opts) {
+    Impl::CacheLock lock(*m_impl);
+    auto it = m_impl->textureCache.find(Impl::textureKey(path, opts));
+    if (it != m_impl->textureCache.end()) ++it->second.refs;
+}
+
+void Renderer::releaseTexture(const std::string& path, const TextureLoadOptions& opts) {
+    Impl::CacheLock lock(*m_impl);
+    auto it = m_impl->textureCache.find(Impl::textureKey(path, opts));
+    if (it == m_impl->textureCache.end() || it->second.refs == 0) return;
+    if (--it->second.refs == 0) it->second.lastUsed = m_impl->frameIndex;
+}
+
+Texture Renderer::loadTexture(const std::string& path, const TextureLoadOptions& opts) {
+    Impl::CacheLock lock(*m_impl);
+    auto& impl = *m_impl;
+    const std::string key = Impl::textureKey(path, opts);
+    auto it = impl.textureCache.find(key);
+    if (it != impl.textureCache.end()) {
+        it->second.lastUsed = impl.frameIndex;
+        return it->second.tex;
+    }
+    UILO_TRACE_ZONE("Renderer::loadTexture");
+    // Still decoding asynchronously: load it here instead; the worker's
+    // result is dropped when it arrives.
+    impl.texturesPending.erase(key);
+
+    TextureDecodeQueue::Result r;
+    r.path = path;
+    decodeImage(r, opts);
+    if (r.rgba.empty()) {
+        std::fprintf(stderr, "[UILO] loadTexture: failed to load '%s': %s\n",
+                     path.c_str(), r.error.c_str());
+        return impl.cacheTexture(key, Texture{}, 0);
+    }
+    return impl.uploadDecodedTexture(key, r);
+}
+
+Texture Renderer::loadTextureFromMemory(const std::string& key, const uint8_t* data, size_t size,
+                                        const TextureLoadOptions& opts) {
+    Impl::CacheLock lock(*m_impl);
+    auto& impl = *m_impl;
+    const std::string k = Impl::textureKey(key, opts);
+    auto it = impl.textureCache.find(k);
+    if (it != impl.textureCache.end()) {
+        it->second.lastUsed = impl.frameIndex;
+        return it->second.tex;
+    }
+    int w = 0, h = 0, comp = 0;
+    stbi_uc* pixels = data && size > 0 && size <= (size_t)INT32_MAX
+        ? stbi_load_from_memory(data, (int)size, &w, &h, &comp, 4) : nullptr;
+    TextureDecodeQueue::Result r;
+    if (!pixels && (!data || size == 0)) r.error = "no data";
+    else finishDecode(pixels, w, h, opts, r);
+    if (r.rgba.empty()) {
+        std::fprintf(stderr, "[UILO] loadTextureFromMemory: failed to load '%s': %s\n",
+                     key.c_str(), r.error.c_str());
+        return impl.cacheTexture(k, Texture{}, 0);
+    }
+    return impl.uploadDecodedTexture(k, r);
+}
+
+Texture Renderer::loadEmbeddedIcon(EmbeddedIcon icon, uint16_t sizePx) {
+    Impl::CacheLock lock(*m_impl);
+    TextureLoadOptions opts;
+    opts.maxWidth  = sizePx;
+    opts.maxHeight = sizePx;
+    const std::vector<uint8_t>& png =
+        icon == EmbeddedIcon::Folder ? EMBEDDED_FOLDER_ICON : EMBEDDED_FILE_ICON;
+    const char* key =
+        icon == EmbeddedIcon::Folder ? kEmbeddedFolderIconKey : kEmbeddedFileIconKey;
+    return loadTextureFromMemory(key, png.data(), png.size(), opts);
+}
+
+Texture Renderer::Impl::uploadDecodedTexture(const std::string& key,
+                                             const TextureDecodeQueue::Result& r) {
+    Texture tex;
+    if (!r.mips && imageAtlasMaxSize > 0 &&
+        r.width <= imageAtlasMaxSize && r.height <= imageAtlasMaxSize &&
+        packImageAtlas(r.rgba.data(), r.width, r.height, tex))
+        return cacheTexture(key, tex, 0, true);
+    return cacheTexture(key, createImageTexture(r.rgba, r.width, r.height, r.mips), r.rgba.size());
+}
+
+// Uploads a w x h image with its 1px extruded border, the border's
+// top-left corner at (x, y) of the page.
+void Renderer::Impl::writeImageAtlasRect(bgfx::TextureHandle page, uint16_t x, uint16_t y,
+                                         const uint8_t* rgba, uint16_t w, uint16_t h) {
+    const int bw = w + 2, bh = h + 2;
+    const bgfx::Memory* mem = bgfx::alloc((uint32_t)(bw * bh * 4));
+    for (int row = 0; row < bh; ++row) {
+        const int sy = std::clamp(row - 1, 0, (int)h - 1);
+        const uint8_t* src = rgba + (size_t)sy * w * 4;
+        uint8_t* dst = mem->data + (size_t)row * bw * 4;
+        std::memcpy(dst, src, 4);
+        std::memcpy(dst + 4, src, (size_t)w * 4);
+        std::memcpy(dst + (size_t)(w + 1) * 4, src + (size_t)(w - 1) * 4, 4);
+    }
+    bgfx::updateTexture2D(page, 0, 0, x, y, (uint16_t)bw, (uint16_t)bh, mem);
+}
+
+bool Renderer::Impl::packImageAtlas(const uint8_t* rgba, uint16_t w, uint16_t h, Texture& out) {
+    const int size = kImageAtlasPageSize;
+    const int bw = w + 2, bh = h + 2;   // plus the extruded border
+    if (w == 0 || h == 0 || bw > size || bh > size) return false;
+
+    ImageAtlasPage* page = nullptr;
+    uint16_t x = 0, y = 0;
+    for (auto& p : imageAtlasPages)
+        if (packShelf(p, size, 0, bw, bh, x, y)) { page = &p; break; }
+    if (!page) {
+        if (imageAtlasPages.size() >= kImageAtlasMaxPages) return false;
+        ImageAtlasPage p;
+        // No initial contents, so the page stays updatable. Texels outside
+        // packed rects are never sampled.
+        p.tex = bgfx::createTexture2D(
+            (uint16_t)size, (uint16_t)size, false, 1,
+            bgfx::TextureFormat::RGBA8,
+            BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP |
+            BGFX_SAMPLER_MIN_ANISOTROPIC | BGFX_SAMPLER_MAG_ANISOTROPIC,
+            nullptr);
+        if (!bgfx::isValid(p.tex)) return false;
+        imageAtlasPages.push_back(std::move(p));
+        textureBytes += (uint64_t)size * size * 4;
+        page = &imageAtlasPages.back();
+        if (!packShelf(*page, size, 0, bw, bh, x, y)) return false;
+    }
+
+    writeImageAtlasRect(page->tex, x, y, rgba, w, h);
+
+    const float inv = 1.f / (float)size;
+    out.handle = page->tex.idx;
+    out.width  = w;
+    out.height = h;
+    out.uv     = {{(float)(x + 1) * inv, (float)(y + 1) * inv},
+                  {(float)w * inv, (float)h * inv}};
+    return true;
+}
+
+bool Renderer::Impl::isImageAtlasPage(uint16_t handle) const {
+    for (const auto& p : imageAtlasPages)
+        if (p.tex.idx == handle) return true;
+    return false;
+}
+
+void Renderer::Impl::destroyImageAtlas() {
+    for (auto& p : imageAtlasPages)
+        if (bgfx::isValid(p.tex)) bgfx::destroy(p.tex);
+    imageAtlasPages.clear();
+}
+
+void Renderer::setImageAtlasMaxSize(uint16_t px) { m_impl->imageAtlasMaxSize = px; }
+uint16_t Renderer::getImageAtlasMaxSize() const   { return m_impl->imageAtlasMaxSize; }
+
+Texture Renderer::loadTextureAsync(const std::string& path, const TextureLoadOptions& opts) {
+    Impl::CacheLock lock(*m_impl);
+    auto& impl = *m_impl;
+    std::string key = Impl::textureKey(path, opts);
+    auto it = impl.textureCache.find(key);
+    if (it != impl.textureCache.end()) {
+        it->second.lastUsed = impl.frameIndex;
+        return it->second.tex;
+    }
+    if (impl.texturesPending.insert(key).second)
+        impl.textureDecoder.push(std::move(key), path, opts);
+    return Texture{};
+}
+
+bool Renderer::isTextureLoading(const std::string& path, const TextureLoadOptions& opts) const {
+    Impl::CacheLock lock(*m_impl);
+    return m_impl->texturesPending.count(Impl::textureKey(path, opts)) != 0;
+}
+
+bool Renderer::isTextureLoading() const {
+    Impl::CacheLock lock(*m_impl);
+    return !m_impl->texturesPending.empty();
+}
+
+bool Renderer::hasTextureUploads() const {
+    return !m_impl->textureUploads.empty() || m_impl->textureDecoder.hasResults();
+}
+
+void Renderer::Impl::pumpTextureUploads() {
+    textureDecoder.drain(textureUploads);
+    if (textureUploads.empty()) return;
+
+    size_t bytes = 0, n = 0;
+    for (; n < textureUploads.size(); ++n) {
+        auto& r = textureUploads[n];
+        if (n > 0 && bytes + r.rgba.size() > kTextureUploadBudget) break;
+        bytes += r.rgba.size();
+        // Not pending any more: loaded synchronously in the meantime, or
+        // dropped by a shutdown.
+        if (texturesPending.erase(r.key) == 0) continue;
+        if (r.rgba.empty()) {
+            std::fprintf(stderr, "[UILO] loadTextureAsync: failed to load '%s': %s\n",
+                         r.path.c_str(), r.error.c_str());
+            cacheTexture(r.key, Texture{}, 0);
+            continue;
+        }
+        uploadDecodedTexture(r.key, r);
+    }
+    textureUploads.erase(textureUploads.begin(), textureUploads.begin() + (ptrdiff_t)n);
+}
+
+void TextureDecodeQueue::push(std::string key, const std::string& path,
+                              const TextureLoadOptions& opts) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_workers.empty()) {
+            // Decoding is I/O and inflate bound; a few threads are plenty
+            // and leave the cores to the frame's own JobPool.
+            const unsigned hw = std::thread::hardware_concurrency();
+            const unsigned n  = std::clamp(hw > 1 ? hw - 1 : 1u, 1u, 4u);
+            m_stop = false;
+            for (unsigned i = 0; i < n; ++i)
+                m_workers.emplace_back([this] { workerLoop(); });
+        }
+        m_queue.push_back(Request{std::move(key), path, opts});
+    }
+    m_wake.notify_one();
+}
+
+void TextureDecodeQueue::drain(std::vector<Result>& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& r : m_done) out.push_back(std::move(r));
+    m_done.clear();
+}
+
+bool TextureDecodeQueue::hasResults() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_done.empty();
+}
+
+void TextureDecodeQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+    for (auto& t : m_workers) t.join();
+    m_workers.clear();
+    m_done.clear();
+}
+
+void TextureDecodeQueue::workerLoop() {
+    for (;;) {
+        Request req;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_stop) return;
+            req = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        Result r;
+        r.key  = std::move(req.key);
+        r.path = std::move(req.path);
+        decodeImage(r, req.opts);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done.push_back(std::move(r));
+    }
+}
+
 bool Renderer::loadImagePixels(const std::string& path, std::vector<uint8_t>& outRgba,
                                uint32_t& outWidth, uint32_t& outHeight) {
-    int w = 0, h = 0, comp = 0;
-    stbi_uc* pixels = stbi_load(path.c_str(), &w, &h, &comp, 4);
+    int w = 0, h = 0;
+    const char* error = nullptr;
+    stbi_uc* pixels = decodeFile(path.c_str(), w, h, error);
     if (!pixels) {
         std::fprintf(stderr, "[UILO] loadImagePixels: failed to load '%s': %s\n",
-                     path.c_str(), stbi_failure_reason());
+                     path.c_str(), error);
         return false;
     }
     outRgba.assign(pixels, pixels + (size_t)w * (size_t)h * 4);
@@ -61,6 +450,7 @@ bool Renderer::loadImagePixels(const std::string& path, std::vector<uint8_t>& ou
 }
 
 Texture Renderer::createTexture(uint16_t width, uint16_t height) {
+    Impl::CacheLock lock(*m_impl);
     if (width == 0 || height == 0) return Texture{};
     // mem == nullptr makes the texture mutable (bgfx only allows
     // updateTexture2D on textures created without initial contents).
@@ -78,19 +468,46 @@ Texture Renderer::createTexture(uint16_t width, uint16_t height) {
 }
 
 void Renderer::updateTexture(const Texture& tex, const uint8_t* rgba) {
+    Impl::CacheLock lock(*m_impl);
     if (!tex.valid() || !rgba) return;
-    const bgfx::Memory* mem =
-        bgfx::copy(rgba, (uint32_t)tex.width * (uint32_t)tex.height * 4);
     bgfx::TextureHandle th{ tex.handle };
-    bgfx::updateTexture2D(th, 0, 0, 0, 0, tex.width, tex.height, mem);
+    if (m_impl->isImageAtlasPage(tex.handle)) {
+        // Only this image's rect of the shared page (and its border).
+        const float size = (float)Impl::kImageAtlasPageSize;
+        const uint16_t x = (uint16_t)(std::lround(tex.uv.position.x * size) - 1);
+        const uint16_t y = (uint16_t)(std::lround(tex.uv.position.y * size) - 1);
+        m_impl->writeImageAtlasRect(th, x, y, rgba, tex.width, tex.height);
+    } else {
+        const bgfx::Memory* mem =
+            bgfx::copy(rgba, (uint32_t)tex.width * (uint32_t)tex.height * 4);
+        bgfx::updateTexture2D(th, 0, 0, 0, 0, tex.width, tex.height, mem);
+    }
+    ++m_impl->contentGeneration;
 }
 
 void Renderer::destroyTexture(Texture& tex) {
+    Impl::CacheLock lock(*m_impl);
     if (!tex.valid()) return;
+    ++m_impl->contentGeneration;
+    // Atlas images share their page with others; it lives until shutdown.
+    if (m_impl->isImageAtlasPage(tex.handle)) { tex.handle = UINT16_MAX; return; }
+    // A cached texture drops one reference; the handle goes only with the
+    // last, and then leaves the cache so it isn't destroyed (or counted)
+    // again later on.
+    for (auto it = m_impl->textureCache.begin(); it != m_impl->textureCache.end(); ++it) {
+        if (it->second.tex.handle != tex.handle) continue;
+        if (it->second.refs > 1) {
+            --it->second.refs;
+            tex.handle = UINT16_MAX;
+            return;
+        }
+        m_impl->textureBytes -= it->second.bytes;
+        m_impl->textureCache.erase(it);
+        break;
+    }
     bgfx::TextureHandle h{ tex.handle };
     bgfx::destroy(h);
     tex.handle = UINT16_MAX;
-    // (We don't bother removing from cache; it'll be cleared on shutdown.)
 }
 
 void Renderer::drawImage(const Rectf& dst, const Texture& tex,
@@ -99,15 +516,21 @@ void Renderer::drawImage(const Rectf& dst, const Texture& tex,
                           bool clipEllipse) {
     if (!tex.valid()) return;
     auto& impl = *m_impl;
-    impl.flushSolidBatch();
+    auto& rec = impl.rs();
     if (!bgfx::isValid(impl.texProgram) || scissorEmpty(impl)) return;
+    if (impl.rejectDraw(dst)) return;
 
     float x = dst.position.x, y = dst.position.y;
     float w = dst.size.x,     h = dst.size.y;
 
-    float u0 = uv.position.x, v0 = uv.position.y;
-    float u1 = uv.position.x + uv.size.x;
-    float v1 = uv.position.y + uv.size.y;
+    // uv is relative to the image, which may be a region of an atlas page.
+    const Rectf region = {
+        {tex.uv.position.x + uv.position.x * tex.uv.size.x,
+         tex.uv.position.y + uv.position.y * tex.uv.size.y},
+        {uv.size.x * tex.uv.size.x, uv.size.y * tex.uv.size.y}};
+    float u0 = region.position.x, v0 = region.position.y;
+    float u1 = region.position.x + region.size.x;
+    float v1 = region.position.y + region.size.y;
     if (flipH) std::swap(u0, u1);
     if (flipV) std::swap(v0, v1);
 
@@ -117,8 +540,8 @@ void Renderer::drawImage(const Rectf& dst, const Texture& tex,
     float x1 = x + w, y1 = y;
     float x2 = x + w, y2 = y + h;
     float x3 = x,     y3 = y + h;
-    impl.rotPt(x0, y0); impl.rotPt(x1, y1);
-    impl.rotPt(x2, y2); impl.rotPt(x3, y3);
+    impl.xformPt(x0, y0); impl.xformPt(x1, y1);
+    impl.xformPt(x2, y2); impl.xformPt(x3, y3);
 
     PosColorUvVertex verts[4] = {
         {x0, y0, col, u0, v0},
@@ -127,25 +550,246 @@ void Renderer::drawImage(const Rectf& dst, const Texture& tex,
         {x3, y3, col, u0, v1},
     };
     uint16_t idx[6] = {0,1,2, 0,2,3};
+    bgfx::TextureHandle th{ tex.handle };
 
+    // Unmasked images ride the text batch (same layout, one texture per
+    // submit), so runs of icons from one atlas page cost a single draw.
+    if (!clipEllipse) {
+        const uint16_t base = impl.reserveTextBatch(currentViewId(), th, impl.texProgram, 4);
+        for (auto& v : verts) v.clip = (float)impl.clipNodeId();
+        rec.textBatchVerts.insert(rec.textBatchVerts.end(), verts, verts + 4);
+        for (uint16_t i : idx) rec.textBatchIdx.push_back((uint16_t)(base + i));
+        return;
+    }
+
+    impl.flushBatches();
     bgfx::TransientVertexBuffer tvb;
     bgfx::TransientIndexBuffer  tib;
-    if (!bgfx::allocTransientBuffers(&tvb, impl.texLayout, 4, &tib, 6)) return;
+    if (!impl.allocTransient(&tvb, impl.texLayout, 4, &tib, 6)) return;
     std::memcpy(tvb.data, verts, sizeof(verts));
     std::memcpy(tib.data, idx,   sizeof(idx));
 
+    bgfx::Encoder* enc = impl.enc();
+    enc->setTexture(0, impl.s_texColor, th);
+    {
+        const float flags[4] = { std::max(region.size.x, 1e-6f), region.size.y,
+                                 region.position.x, region.position.y };
+        enc->setUniform(impl.u_imgFlags, flags);
+        const uint16_t view = currentViewId();
+        impl.hashSceneLiveState(view);
+        impl.hashScene(view, verts, sizeof(verts));
+        impl.hashScene(view, flags, sizeof(flags));
+        impl.hashSceneValue(view, th.idx);
+    }
+    enc->setVertexBuffer(0, &tvb);
+    enc->setIndexBuffer(&tib);
+    enc->setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                   impl.blendState(currentViewId()));
+    applyScissor(impl);
+    enc->submit(currentViewId(), impl.texProgram);
+    ++impl.rs().immediateSubmits;
+}
+
+// ---------------------------------------------------------------------------
+//  Gradient table — one baked RGBA8 ramp per row for linear / radial fills;
+//  fs_shape samples it along the instance's ramp geometry.
+// ---------------------------------------------------------------------------
+uint16_t Renderer::Impl::gradientRow(const GradientRampStop* stops, size_t count) {
+    const uint64_t key = hashBytes(kHashBasis, stops, count * sizeof(GradientRampStop));
+    if (auto it = gradientRowByKey.find(key); it != gradientRowByKey.end()) {
+        gradientRows[it->second].lastUse = frameIndex;
+        return it->second;
+    }
+    if (!bgfx::isValid(gradientLut)) {
+        gradientLut = bgfx::createTexture2D(kGradientLutWidth, kGradientLutRows, false, 1,
+                                            bgfx::TextureFormat::RGBA8,
+                                            BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
+        if (!bgfx::isValid(gradientLut)) return UINT16_MAX;
+        s_gradientLut = bgfx::createUniform("s_gradientLut", bgfx::UniformType::Sampler);
+        gradientLutPixels.assign((size_t)kGradientLutWidth * kGradientLutRows * 4, 0);
+    }
+
+    uint16_t row = UINT16_MAX;
+    if (gradientRows.size() < kGradientLutRows) {
+        row = (uint16_t)gradientRows.size();
+        gradientRows.emplace_back();
+    } else {
+        uint32_t oldest = frameIndex;
+        for (size_t i = 0; i < gradientRows.size(); ++i)
+            if (gradientRows[i].lastUse < oldest) { oldest = gradientRows[i].lastUse; row = (uint16_t)i; }
+        if (row == UINT16_MAX) return UINT16_MAX;
+        gradientRowByKey.erase(gradientRows[row].key);
+        ++gradientEvictions;
+    }
+    gradientRows[row] = { key, frameIndex };
+    gradientRowByKey.emplace(key, row);
+
+    uint8_t* px = gradientLutPixels.data() + (size_t)row * kGradientLutWidth * 4;
+    size_t s = 0;
+    for (uint16_t i = 0; i < kGradientLutWidth; ++i) {
+        const float t = (float)i / (float)(kGradientLutWidth - 1);
+        while (s + 1 < count && stops[s + 1].offset < t) ++s;
+        Color c = stops[s].color;
+        if (t > stops[s].offset && s + 1 < count) {
+            const float span = stops[s + 1].offset - stops[s].offset;
+            const float f    = span > 0.f ? (t - stops[s].offset) / span : 1.f;
+            const Color a = stops[s].color, b = stops[s + 1].color;
+            c = Color{ (uint8_t)std::lround(a.r + (b.r - a.r) * f), (uint8_t)std::lround(a.g + (b.g - a.g) * f),
+                       (uint8_t)std::lround(a.b + (b.b - a.b) * f), (uint8_t)std::lround(a.a + (b.a - a.a) * f) };
+        }
+        px[i * 4 + 0] = c.r;
+        px[i * 4 + 1] = c.g;
+        px[i * 4 + 2] = c.b;
+        px[i * 4 + 3] = c.a;
+    }
+    gradientDirty0 = std::min(gradientDirty0, row);
+    gradientDirty1 = std::max<uint16_t>(gradientDirty1, row + 1);
+    return row;
+}
+
+void Renderer::Impl::uploadGradientLut() {
+    if (gradientDirty0 >= gradientDirty1 || !bgfx::isValid(gradientLut)) return;
+    const uint32_t pitch = (uint32_t)kGradientLutWidth * 4;
+    const uint16_t rows  = (uint16_t)(gradientDirty1 - gradientDirty0);
+    const bgfx::Memory* mem = bgfx::copy(gradientLutPixels.data() + (size_t)gradientDirty0 * pitch,
+                                         rows * pitch);
+    bgfx::updateTexture2D(gradientLut, 0, 0, 0, gradientDirty0, kGradientLutWidth, rows, mem, (uint16_t)pitch);
+    gradientDirty0 = UINT16_MAX;
+    gradientDirty1 = 0;
+}
+
+void Renderer::Impl::bindGradientLut() {
+    if (bgfx::isValid(gradientLut)) enc()->setTexture(2, s_gradientLut, gradientLut);
+}
+
+void Renderer::Impl::destroyGradientLut() {
+    if (bgfx::isValid(gradientLut))   bgfx::destroy(gradientLut);
+    if (bgfx::isValid(s_gradientLut)) bgfx::destroy(s_gradientLut);
+    gradientLut   = BGFX_INVALID_HANDLE;
+    s_gradientLut = BGFX_INVALID_HANDLE;
+    gradientLutPixels.clear();
+    gradientRows.clear();
+    gradientRowByKey.clear();
+    gradientDirty0 = UINT16_MAX;
+    gradientDirty1 = 0;
+    ++gradientEvictions;
+}
+
+GradientRamp Renderer::bakeGradientRamp(const GradientRampStop* stops, size_t count,
+                                        bool radial, const float geom[4]) {
+    auto& impl = *m_impl;
+    GradientRamp ramp;
+    if (!stops || count == 0 || !impl.useShapeInstancing()) return ramp;
+    Impl::CacheLock lock(impl);
+    ramp.row = impl.gradientRow(stops, count);
+    if (!ramp.valid()) return ramp;
+    ramp.radial = radial;
+    std::memcpy(ramp.geom, geom, sizeof(ramp.geom));
+    return ramp;
+}
+
+// ---------------------------------------------------------------------------
+//  Peak textures — Waveform's GPU path. Each strip is one quad; fs_waveform
+//  point-samples the {min, max} texels and rasterises Bars / Line / Filled.
+// ---------------------------------------------------------------------------
+Texture Renderer::createPeakTexture(uint16_t columns, uint16_t lanes) {
+    Impl::CacheLock lock(*m_impl);
+    if (columns == 0 || lanes == 0) return Texture{};
+    const bgfx::Caps* caps = bgfx::getCaps();
+    if (!caps || !(caps->formats[bgfx::TextureFormat::RG32F] & BGFX_CAPS_FORMAT_TEXTURE_2D))
+        return Texture{};
+    if (columns > caps->limits.maxTextureSize || lanes > caps->limits.maxTextureSize)
+        return Texture{};
+    // Float textures aren't filterable everywhere; the shader samples
+    // texel centres, so point sampling loses nothing.
+    bgfx::TextureHandle th = bgfx::createTexture2D(
+        columns, lanes, false, 1,
+        bgfx::TextureFormat::RG32F,
+        BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP | BGFX_SAMPLER_POINT,
+        nullptr);
+    if (!bgfx::isValid(th)) return Texture{};
+    Texture tex;
+    tex.handle = th.idx;
+    tex.width  = columns;
+    tex.height = lanes;
+    return tex;
+}
+
+void Renderer::updatePeakTexture(const Texture& tex, const float* minMax) {
+    Impl::CacheLock lock(*m_impl);
+    if (!tex.valid() || !minMax) return;
+    const bgfx::Memory* mem = bgfx::copy(
+        minMax, (uint32_t)tex.width * (uint32_t)tex.height * 2 * sizeof(float));
     bgfx::TextureHandle th{ tex.handle };
-    bgfx::setTexture(0, impl.s_texColor, th);
+    bgfx::updateTexture2D(th, 0, 0, 0, 0, tex.width, tex.height, mem);
+    ++m_impl->contentGeneration;
+}
+
+bool Renderer::drawWaveform(const Rectf& dst, const Texture& peaks, uint16_t lane,
+                            PeakStyle style, Color color, float gain, float thickness) {
+    auto& impl = *m_impl;
+    if (!peaks.valid() || lane >= peaks.height) return false;
+    if (!impl.ensureWaveformProgram()) return false;
+    impl.flushBatches();
+    if (scissorEmpty(impl)) return true;
+    if (dst.size.x <= 0.f || dst.size.y <= 0.f || color.a == 0) return true;
+    if (impl.rejectDraw(dst)) return true;
+
+    const uint32_t col = packColor(color);
+    float x0 = dst.position.x,              y0 = dst.position.y;
+    float x1 = dst.position.x + dst.size.x, y1 = dst.position.y;
+    float x2 = dst.position.x + dst.size.x, y2 = dst.position.y + dst.size.y;
+    float x3 = dst.position.x,              y3 = dst.position.y + dst.size.y;
+    impl.xformPt(x0, y0); impl.xformPt(x1, y1);
+    impl.xformPt(x2, y2); impl.xformPt(x3, y3);
+
+    // Indexed clips crop the whole round-clip chain in fs_waveform, so the
+    // clip uniforms stay off then, as for batches.
+    const float clip = impl.clipTableOn ? (float)impl.clipNodeId() : 0.f;
+    PosColorUvVertex verts[4] = {
+        {x0, y0, col, 0.f, 0.f, clip},
+        {x1, y1, col, 1.f, 0.f, clip},
+        {x2, y2, col, 1.f, 1.f, clip},
+        {x3, y3, col, 0.f, 1.f, clip},
+    };
+    uint16_t idx[6] = {0,1,2, 0,2,3};
+
+    bgfx::TransientVertexBuffer tvb;
+    bgfx::TransientIndexBuffer  tib;
+    if (!impl.allocTransient(&tvb, impl.texLayout, 4, &tib, 6)) return true;
+    std::memcpy(tvb.data, verts, sizeof(verts));
+    std::memcpy(tib.data, idx,   sizeof(idx));
+
+    bgfx::TextureHandle th{ peaks.handle };
+    bgfx::Encoder* enc = impl.enc();
+    enc->setTexture(0, impl.s_texColor, th);
     {
-        const float flags[4] = { clipEllipse ? 1.f : 0.f, 0.f, 0.f, 0.f };
-        bgfx::setUniform(impl.u_imgFlags, flags);
+        const float params[4] = {
+            (float)style, gain, std::max(0.5f, thickness),
+            ((float)lane + 0.5f) / (float)peaks.height,
+        };
+        const float size[4] = { (float)peaks.width, dst.size.x, dst.size.y, 0.f };
+        enc->setUniform(impl.u_waveParams, params);
+        enc->setUniform(impl.u_waveSize,   size);
+        const uint16_t view = currentViewId();
+        impl.hashSceneLiveState(view);
+        impl.hashScene(view, verts,  sizeof(verts));
+        impl.hashScene(view, params, sizeof(params));
+        impl.hashScene(view, size,   sizeof(size));
+        impl.hashSceneValue(view, th.idx);
     }
-    bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
-    bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                   BGFX_STATE_BLEND_ALPHA);
+    enc->setVertexBuffer(0, &tvb);
+    enc->setIndexBuffer(&tib);
+    enc->setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                   impl.blendState(currentViewId()));
     applyScissor(impl);
-    bgfx::submit(currentViewId(), impl.texProgram);
+    if (impl.clipTableOn) {
+        static constexpr float kOff[4] = {0.f, 0.f, 0.f, 0.f};
+        applyClipUniforms(impl, kOff, kOff, kOff, kOff);
+    }
+    enc->submit(currentViewId(), impl.waveformProgram);
+    ++impl.rs().immediateSubmits;
+    return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -156,65 +800,92 @@ void Renderer::drawGlass(const Rectf& dst, const Material& mat,
                          Color baseColor) {
     if (mat.kind == Material::Kind::None) return;
     auto& impl = *m_impl;
-    impl.flushSolidBatch();
-    if (!bgfx::isValid(impl.glassProgram)) return;
+    auto& rec = impl.rs();
+    // Glass samples the live scene blur, so it can't be baked into a layer.
+    if (!rec.layerStack.empty()) {
+        rec.layerTainted = true;
+        return;
+    }
+    impl.flushBatches();
+    if (!impl.ensureGlassPrograms())       return;
     if (scissorEmpty(impl))                return;
     if (dst.size.x <= 0.f || dst.size.y <= 0.f) return;
-
-    // Mark glass-presence so the next frame switches back to the FB
-    // pipeline. When this frame is in bypass mode (the predictor said
-    // no glass), there's no sceneFB to defer into and no blur ladder
-    // to feed — draw a flat tint as a one-frame visual fallback while
-    // the FB path comes back online next frame.
-    impl.hadGlassThisFrame = true;
-    if (impl.bypassSceneFb) {
-        Rect r;
-        r.position  = dst.position;
-        r.size      = dst.size;
-        r.fillColor = baseColor;
-        draw(r);
-        return;
+    if (impl.rejectDraw(dst)) return;
+    // The replay draws in screen space, so map dst through the current
+    // transform now: its screen bounds (exact for translate + scale), with
+    // the pixel-sized material params scaled to match.
+    Rectf    box = dst;
+    Material m   = mat;
+    if (rec.xformOn) {
+        const Transform2D& e = rec.effective;
+        const Vec2f p0 = e.apply(dst.position);
+        const Vec2f p1 = e.apply({dst.right(), dst.position.y});
+        const Vec2f p2 = e.apply({dst.right(), dst.bottom()});
+        const Vec2f p3 = e.apply({dst.position.x, dst.bottom()});
+        const float x0 = std::min(std::min(p0.x, p1.x), std::min(p2.x, p3.x));
+        const float y0 = std::min(std::min(p0.y, p1.y), std::min(p2.y, p3.y));
+        const float x1 = std::max(std::max(p0.x, p1.x), std::max(p2.x, p3.x));
+        const float y1 = std::max(std::max(p0.y, p1.y), std::max(p2.y, p3.y));
+        box = Rectf{{x0, y0}, {x1 - x0, y1 - y0}};
+        const float k = std::sqrt(std::abs(e.a * e.d - e.b * e.c));
+        m.cornerRadius *= k;
+        m.refraction   *= k;
+        m.blurRadius   *= k;
     }
 
+    switch (m.kind) {
+        case Material::Kind::Holographic:
+        case Material::Kind::Liquid:
+        case Material::Kind::Shimmer:
+        case Material::Kind::Aurora:
+        case Material::Kind::Ripple:
+        case Material::Kind::Hover:
+            rec.animatedThisFrame = true;
+            break;
+        default:
+            break;
+    }
     // Defer until endFrame so the blur ladder runs over a sceneFB that
-    // doesn't contain any glass elements. During the replay pass we set
-    // replayingGlass=true and re-enter here to actually submit.
-    if (!impl.replayingGlass) {
-        Impl::DeferredGlass d;
-        d.dst        = dst;
-        d.mat        = mat;
-        d.baseColor  = baseColor;
-        if (impl.scissorTop > 0) {
-            const auto& s = impl.scissorStack[impl.scissorTop - 1];
-            d.hasScissor = true;
-            d.sx = s.x; d.sy = s.y; d.sw = s.w; d.sh = s.h;
-        }
-        impl.deferredGlass.push_back(d);
-        return;
+    // doesn't contain any glass elements; the frame graph's glass pass
+    // (replayDeferredGlass) then submits the queue.
+    Impl::DeferredGlass d;
+    d.dst        = box;
+    d.mat        = m;
+    d.baseColor  = baseColor;
+    if (rec.scissorTop > 0) {
+        const auto& s = rec.scissorStack[rec.scissorTop - 1];
+        d.hasScissor = true;
+        d.sx = s.x; d.sy = s.y; d.sw = s.w; d.sh = s.h;
     }
+    rec.deferredGlass.push_back(d);
+}
 
-    if (!bgfx::isValid(impl.blurFB_B))     return;
+void Renderer::Impl::appendGlassQuad(const DeferredGlass& d, float W, float H) {
+    const Material& mat = d.mat;
+    float x = d.dst.position.x, y = d.dst.position.y;
+    float w = d.dst.size.x,     h = d.dst.size.y;
 
     // Backdrop UV: map the element's screen-space rect into the half-res
-    // blur target's UV space. blurColorB shares aspect ratio with the
-    // window (just at half resolution), so plain windowSize works.
-    const float W = (float)m_lastWidth;
-    const float H = (float)m_lastHeight;
-    if (W <= 0.f || H <= 0.f) return;
-
-    float x = dst.position.x, y = dst.position.y;
-    float w = dst.size.x,     h = dst.size.y;
-
+    // blur target's UV space. The blur content is the window at half
+    // resolution in the top-left of a target sized from fbAllocW/H, so
+    // scale by the part of the target it covers.
     // Some renderers (GL/ES) put the FB origin at the bottom-left; we need
     // to flip V when sampling our offscreen blur target.
-    const bool flipV = bgfx::getCaps()->originBottomLeft;
-    float u0 = x / W,         u1 = (x + w) / W;
-    float v0 = y / H,         v1 = (y + h) / H;
+    // The host's backdrop covers the window over its own uv rect instead.
+    const bool  flipV = bgfx::getCaps()->originBottomLeft;
+    const bool  host  = usingHostBackdrop();
+    const float su = host ? hostBackdropUv.size.x
+                          : (float)std::max(1u, fbWidth  / 2u) / (float)std::max(1u, fbAllocW / 2u);
+    const float sv = host ? hostBackdropUv.size.y
+                          : (float)std::max(1u, fbHeight / 2u) / (float)std::max(1u, fbAllocH / 2u);
+    const float ou = host ? hostBackdropUv.position.x : 0.f;
+    const float ov = host ? hostBackdropUv.position.y : 0.f;
+    float u0 = ou + x / W * su,    u1 = ou + (x + w) / W * su;
+    float v0 = ov + y / H * sv,    v1 = ov + (y + h) / H * sv;
     if (flipV) { v0 = 1.f - v0; v1 = 1.f - v1; }
 
-    // v_color0 is packed with local 0..1 coords (in .rg via the .r/.g
-    // bytes). The fragment shader reads it as a float vec4 normalised to
-    // 0..1, so 0->0.0 and 255->1.0 — i.e. plain colour encoding works.
+    // Local 0..1 coords ride in the r/g bytes of `local`; the fragment
+    // shader reads them as a normalised colour (0 -> 0.0, 255 -> 1.0).
     auto pack01 = [](float a, float b) -> uint32_t {
         uint8_t ra = (uint8_t)std::clamp(a * 255.f, 0.f, 255.f);
         uint8_t rb = (uint8_t)std::clamp(b * 255.f, 0.f, 255.f);
@@ -222,91 +893,118 @@ void Renderer::drawGlass(const Rectf& dst, const Material& mat,
         return (uint32_t)0xff000000u | (uint32_t)rb << 8 | (uint32_t)ra;
     };
 
-    PosColorUvVertex verts[4] = {
-        {x,     y,     pack01(0.f, 0.f), u0, v0},
-        {x + w, y,     pack01(1.f, 0.f), u1, v0},
-        {x + w, y + h, pack01(1.f, 1.f), u1, v1},
-        {x,     y + h, pack01(0.f, 1.f), u0, v1},
-    };
-    uint16_t idx[6] = {0,1,2, 0,2,3};
-
-    bgfx::TransientVertexBuffer tvb;
-    bgfx::TransientIndexBuffer  tib;
-    if (!bgfx::allocTransientBuffers(&tvb, impl.texLayout, 4, &tib, 6)) return;
-    std::memcpy(tvb.data, verts, sizeof(verts));
-    std::memcpy(tib.data, idx,   sizeof(idx));
-
-    // ---- Uniforms ----
-    const float params[4] = {
-        mat.opacity,                  // x = body opacity
-        mat.saturation,
-        mat.brightness,
-        mat.edgeHighlight,
-    };
-    const float tintRgba[4] = {
-        mat.tint.r / 255.f,
-        mat.tint.g / 255.f,
-        mat.tint.b / 255.f,
-        mat.tint.a / 255.f,
-    };
+    GlassVertex v{};
+    v.tint = packColor(mat.tint);
+    // Element's own colour (for Tinted / Ripple / Hover). Transparent
+    // signals "no base colour" — the shader will skip the overlay branch.
+    v.base = packColor(d.baseColor);
+    v.params[0] = mat.opacity;
+    v.params[1] = mat.saturation;
+    v.params[2] = mat.brightness;
+    v.params[3] = mat.edgeHighlight;
     // Refraction is authored in pixels; convert to UV units of the
     // (full-window) blur target so the shader can offset v_texcoord0
     // directly. Use the smaller axis so the bend reads similarly on
     // wide and tall panels.
-    const float refractUv = mat.refraction / std::max(1.f, std::min(W, H));
-    const float rect[4] = {
-        mat.cornerRadius,     // x = corner radius (px)
-        w * 0.5f,             // y = half width  (px)
-        h * 0.5f,             // z = half height (px)
-        refractUv,            // w = refraction strength (UV units)
-    };
-    bgfx::setUniform(impl.u_glassParams, params);
-    bgfx::setUniform(impl.u_glassTint,   tintRgba);
-    bgfx::setUniform(impl.u_glassRect,   rect);
-    // Per-kind animation block: x=kind, y=time, z=speed, w=strength
-    // For Material::Blur the w slot is repurposed to carry the per-element
-    // blur radius (in pixels) instead — that kind isn't animated, so the
-    // overload is safe.
-    const bool  isBlurKind = (mat.kind == Material::Kind::Blur);
-    const float anim[4] = {
-        (float)(int)mat.kind,
-        impl.elapsed,
-        mat.animSpeed,
-        isBlurKind ? mat.blurRadius : mat.animStrength,
-    };
-    bgfx::setUniform(impl.u_glassAnim, anim);
+    v.rect[0] = mat.cornerRadius;
+    v.rect[1] = w * 0.5f;
+    v.rect[2] = h * 0.5f;
+    v.rect[3] = mat.refraction / std::max(1.f, std::min(W, H)) * std::min(su, sv);
+    // For Material::Blur the strength slot carries how much of the
+    // dual-Kawase ladder to mix in for its blurRadius — that kind isn't
+    // animated, so the overload is safe.
+    const bool isBlurKind = (mat.kind == Material::Kind::Blur);
+    v.anim[0] = (float)(int)mat.kind;
+    v.anim[2] = mat.animSpeed;
+    v.anim[3] = isBlurKind ? ladderWeight(mat.blurRadius) : mat.animStrength;
+
+    const uint16_t base = (uint16_t)glassVerts.size();
+    const float    xs[4] = { x, x + w, x + w, x };
+    const float    ys[4] = { y, y, y + h, y + h };
+    const float    us[4] = { u0, u1, u1, u0 };
+    const float    vs[4] = { v0, v0, v1, v1 };
+    const float    ls[4] = { 0.f, 1.f, 1.f, 0.f };
+    const float    lt[4] = { 0.f, 0.f, 1.f, 1.f };
+    for (int i = 0; i < 4; ++i) {
+        v.x = xs[i]; v.y = ys[i];
+        v.u = us[i]; v.v = vs[i];
+        v.local = pack01(ls[i], lt[i]);
+        glassVerts.push_back(v);
+    }
+    for (uint16_t i : { 0, 1, 2, 0, 2, 3 }) glassIdx.push_back((uint16_t)(base + i));
+}
 
-    // Element's own colour (for Tinted / Ripple / Hover). Transparent
-    // signals "no base colour" — the shader will skip the overlay branch.
-    const float base[4] = {
-        baseColor.r / 255.f,
-        baseColor.g / 255.f,
-        baseColor.b / 255.f,
-        baseColor.a / 255.f,
+void Renderer::Impl::replayDeferredGlass(float W, float H, Vec2f mouse, float sinceMove) {
+    auto& rec = rs();
+    glassPanelsLastFrame = (uint32_t)rec.deferredGlass.size();
+    glassDrawsLastFrame  = 0;
+    const bool host = usingHostBackdrop();
+    if (!bgfx::isValid(glassProgram) || (!host && !bgfx::isValid(blurFB_B))) return;
+    if (W <= 0.f || H <= 0.f) return;
+    const bgfx::TextureHandle backdrop = host ? hostBackdrop : blurColorB;
+    const bgfx::TextureHandle ladder   = host ? hostBackdrop : ladderTexture();
+
+    auto overlaps = [](const Rectf& a, const Rectf& b) {
+        return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x &&
+               a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
     };
-    bgfx::setUniform(impl.u_glassBase, base);
-
-    // Cursor in element-local 0..1 coords + activity signals. We compute
-    // both axes regardless of whether the cursor sits inside the rect so
-    // the shader can still render a soft halo on the rim when the user
-    // approaches it.
-    const Vec2f mpx       = m_mousePos;
-    const float localU    = (mpx.x - x) / std::max(1.f, w);
-    const float localV    = (mpx.y - y) / std::max(1.f, h);
-    const float inside    = (localU >= 0.f && localU <= 1.f &&
-                             localV >= 0.f && localV <= 1.f) ? 1.f : 0.f;
-    const float sinceMove = std::max(0.f, impl.elapsed - m_mouseLastMoveT);
-    const float mouseUni[4] = { localU, localV, inside, sinceMove };
-    bgfx::setUniform(impl.u_glassMouse, mouseUni);
-
-    bgfx::setTexture(0, impl.s_texColor, impl.blurColorB);
-
-    bgfx::setVertexBuffer(0, &tvb);
-    bgfx::setIndexBuffer(&tib);
-    bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-                   BGFX_STATE_BLEND_ALPHA);
-    applyScissor(impl);
-    bgfx::submit(currentViewId(), impl.glassProgram);
+    for (auto& b : glassBatches) b.items.clear();
+    size_t used = 0;
+    for (uint32_t i = 0; i < (uint32_t)rec.deferredGlass.size(); ++i) {
+        const DeferredGlass& g = rec.deferredGlass[i];
+        // Past the last batch this panel overlaps, it may join any batch
+        // with the same scissor; it lands after everything it covers.
+        size_t first = 0;
+        for (size_t b = used; b-- > 0 && first == 0;)
+            for (uint32_t j : glassBatches[b].items)
+                if (overlaps(rec.deferredGlass[j].dst, g.dst)) { first = b; break; }
+        size_t pick = used;
+        for (size_t b = first; b < used; ++b) {
+            const GlassBatch& gb = glassBatches[b];
+            if (gb.hasScissor == g.hasScissor &&
+                (!g.hasScissor || (gb.sx == g.sx && gb.sy == g.sy && gb.sw == g.sw && gb.sh == g.sh))) {
+                pick = b;
+                break;
+            }
+        }
+        if (pick == used) {
+            if (used == glassBatches.size()) glassBatches.emplace_back();
+            GlassBatch& nb = glassBatches[used++];
+            nb.hasScissor = g.hasScissor;
+            nb.sx = g.sx; nb.sy = g.sy; nb.sw = g.sw; nb.sh = g.sh;
+        }
+        glassBatches[pick].items.push_back(i);
+    }
+
+    const float frame[4] = { mouse.x, mouse.y, sinceMove, elapsed };
+    for (size_t b = 0; b < used; ++b) {
+        const GlassBatch& gb = glassBatches[b];
+        // 16-bit indices: split a batch every kBatchMaxVerts vertices.
+        for (size_t at = 0; at < gb.items.size();) {
+            glassVerts.clear();
+            glassIdx.clear();
+            for (; at < gb.items.size() && glassVerts.size() + 4 <= kBatchMaxVerts; ++at)
+                appendGlassQuad(rec.deferredGlass[gb.items[at]], W, H);
+            const uint32_t numV = (uint32_t)glassVerts.size();
+            const uint32_t numI = (uint32_t)glassIdx.size();
+            bgfx::TransientVertexBuffer tvb;
+            bgfx::TransientIndexBuffer  tib;
+            if (!allocTransient(&tvb, glassLayout, numV, &tib, numI)) return;
+            std::memcpy(tvb.data, glassVerts.data(), numV * sizeof(GlassVertex));
+            std::memcpy(tib.data, glassIdx.data(),   numI * sizeof(uint16_t));
+
+            bgfx::setUniform(u_glassFrame, frame);
+            bgfx::setTexture(0, s_texColor,  backdrop);
+            bgfx::setTexture(1, s_texLadder, ladder);
+            bgfx::setVertexBuffer(0, &tvb);
+            bgfx::setIndexBuffer(&tib);
+            bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                           BGFX_STATE_BLEND_ALPHA);
+            if (gb.hasScissor) bgfx::setScissor(gb.sx, gb.sy, gb.sw, gb.sh);
+            bgfx::submit(kGlassBgViewId, glassProgram);
+            ++glassDrawsLastFrame;
+        }
+    }
 }
 
 } // namespace uilo
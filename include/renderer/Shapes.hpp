@@ -4,3 +4,4 @@
 #include "shapes/Circle.hpp"
 #include "shapes/Triangle.hpp"
 #include "shapes/Line.hpp"
+#include "shapes/GradientRamp.hpp"
@@ -0,0 +1,40 @@
+// Shared by the fragment shaders that batch under indexed clips; include
+// after <bgfx_shader.sh>. Sampler stage 1 is the clip table.
+#ifndef UILO_CLIP_SH
+#define UILO_CLIP_SH
+
+// Indexed clips (Renderer::setIndexedClips): v_clip names the innermost
+// node of a table of every round clip pushed, two texels a node:
+// (cx, cy, halfW, halfH) and (radius, parent node, 0, 0), world px. All
+// ancestors up to UILO_CLIP_CHAIN_MAX apply; radius 0 is a hard rect.
+// Node 0 = unclipped, so non-batched draws never sample the table.
+// u_clipTable: xy = 1 / table size (texels), z = texels per row.
+#define UILO_CLIP_CHAIN_MAX 16
+SAMPLER2D(s_clipTable, 1);
+uniform vec4 u_clipTable;
+
+vec4 uiloClipTexel(float i) {
+    float row = floor(i / u_clipTable.z);
+    vec2  uv  = (vec2(i - row * u_clipTable.z, row) + vec2_splat(0.5)) * u_clipTable.xy;
+    return texture2DLod(s_clipTable, uv, 0.0);
+}
+
+float uiloClipChain(vec2 p, float clip) {
+    // Derivatives aren't defined under the loop's divergent flow.
+    float aa   = max(fwidth(p.x), fwidth(p.y)) + 1e-5;
+    float node = floor(clip + 0.5);
+    float a    = 1.0;
+    for (int i = 0; i < UILO_CLIP_CHAIN_MAX; ++i) {
+        if (node < 0.5) break;
+        vec4  rect = uiloClipTexel(node * 2.0);
+        vec4  info = uiloClipTexel(node * 2.0 + 1.0);
+        vec2  q    = abs(p - rect.xy) - rect.zw + vec2_splat(info.x);
+        float d    = length(max(q, vec2_splat(0.0))) +
+                     min(max(q.x, q.y), 0.0) - info.x;
+        a   *= info.x > 0.0 ? 1.0 - smoothstep(-aa, aa, d) : step(d, 0.0);
+        node = info.y;
+    }
+    return a;
+}
+
+#endif // UILO_CLIP_SH
@@ -0,0 +1,42 @@
+$input v_color0, v_texcoord0, v_worldpos, v_clip
+
+#include <bgfx_shader.sh>
+
+// Dual-Kawase blur ladder pass (see Renderer::Impl::runBlurLadder). Each
+// downsample halves the target and each upsample doubles it again, so the
+// blur radius grows with the depth while every pass stays a handful of
+// bilinear taps.
+SAMPLER2D(s_texColor, 0);
+uniform vec4 u_blurParams; // xy = half a texel of the target (UV), z = 0 down / 1 up
+uniform vec4 u_blurClamp;  // xy = min, zw = max UV of the source's content
+
+vec4 kawaseTap(vec2 uv) {
+    return texture2D(s_texColor, clamp(uv, u_blurClamp.xy, u_blurClamp.zw));
+}
+
+void main() {
+    vec2 uv = v_texcoord0;
+    vec2 h  = u_blurParams.xy;
+    vec4 c;
+    if (u_blurParams.z < 0.5) {
+        // Centre plus the four diagonals, each a bilinear 2x2 average.
+        c  = kawaseTap(uv) * 4.0;
+        c += kawaseTap(uv - h);
+        c += kawaseTap(uv + h);
+        c += kawaseTap(uv + vec2(h.x, -h.y));
+        c += kawaseTap(uv - vec2(h.x, -h.y));
+        c *= 0.125;
+    } else {
+        // Tent of eight taps around the target texel.
+        c  = kawaseTap(uv + vec2(-h.x * 2.0, 0.0));
+        c += kawaseTap(uv + vec2(-h.x,  h.y)) * 2.0;
+        c += kawaseTap(uv + vec2( 0.0,  h.y * 2.0));
+        c += kawaseTap(uv + vec2( h.x,  h.y)) * 2.0;
+        c += kawaseTap(uv + vec2( h.x * 2.0, 0.0));
+        c += kawaseTap(uv + vec2( h.x, -h.y)) * 2.0;
+        c += kawaseTap(uv + vec2( 0.0, -h.y * 2.0));
+        c += kawaseTap(uv + vec2(-h.x, -h.y)) * 2.0;
+        c *= (1.0 / 12.0);
+    }
+    gl_FragColor = c;
+}
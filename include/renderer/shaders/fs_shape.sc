@@ -0,0 +1,72 @@
+$input v_color0, v_color1, v_color2, v_color3, v_shape, v_local, v_worldpos, v_clip
+
+#include <bgfx_shader.sh>
+
+// Instanced Rect / RoundedRect / Circle. The shape's own rounded mask is
+// evaluated in its unrotated local space from the instance radius (< 0: a
+// rect with analytic edge AA); the clip uniforms are the enclosing round
+// clips, as in fs_solid.
+uniform vec4 u_clipRect;
+uniform vec4 u_clipParams;
+uniform vec4 u_clipRect2;
+uniform vec4 u_clipParams2;
+
+float uiloRoundedAlpha(vec2 p, vec4 rect, vec4 params) {
+    if (params.y < 0.5) return 1.0;
+    vec2  c  = rect.xy;
+    vec2  b  = rect.zw;
+    float r  = params.x;
+    vec2  q  = abs(p - c) - b + vec2_splat(r);
+    float d  = length(max(q, vec2_splat(0.0))) +
+               min(max(q.x, q.y), 0.0) - r;
+    float aa = fwidth(d) + 1e-5;
+    return 1.0 - smoothstep(-aa, aa, d);
+}
+
+#include "clip.sh"
+
+// Gradient table (Renderer::bakeGradientRamp): one baked ramp per row.
+// Must match kGradientLutWidth / kGradientLutRows in RendererImpl.hpp.
+#define UILO_GRADIENT_LUT_WIDTH 256.0
+#define UILO_GRADIENT_LUT_ROWS  64.0
+SAMPLER2D(s_gradientLut, 2);
+
+// v_color0 = ramp geometry in the unit square, v_color1.xy = kind, row.
+vec4 uiloGradientRamp(vec2 uv) {
+    float t;
+    if (v_color1.x < 0.5) {
+        vec2 d = v_color0.zw - v_color0.xy;
+        t = dot(uv - v_color0.xy, d) / max(dot(d, d), 1e-8);
+    } else {
+        t = length((uv - v_color0.xy) / max(v_color0.zw, vec2_splat(1e-4)));
+    }
+    vec2 st = vec2((clamp(t, 0.0, 1.0) * (UILO_GRADIENT_LUT_WIDTH - 1.0) + 0.5) / UILO_GRADIENT_LUT_WIDTH,
+                   (v_color1.y + 0.5) / UILO_GRADIENT_LUT_ROWS);
+    return texture2DLod(s_gradientLut, st, 0.0);
+}
+
+void main() {
+    // Bilinear corner blend: a gradient has no diagonal seam.
+    vec2 uv = clamp((v_local.xy - v_shape.xy) / max(v_shape.zw, vec2_splat(1e-5)),
+                    vec2_splat(0.0), vec2_splat(1.0));
+    vec4 c  = v_color1.w < 0.0
+            ? uiloGradientRamp(uv)
+            : mix(mix(v_color0, v_color1, uv.x), mix(v_color3, v_color2, uv.x), uv.y);
+
+    vec4 self = vec4(v_shape.xy + v_shape.zw * 0.5, v_shape.zw * 0.5);
+    c.a *= uiloRoundedAlpha(v_local.xy, self, vec4(v_local.z, v_local.z > 0.0 ? 1.0 : 0.0, 0.0, 0.0));
+    if (v_local.z < 0.0) {
+        // Analytic AA for a plain rect: a one-pixel coverage ramp across
+        // each edge, exact when axis aligned (pixel-aligned edges keep
+        // full / zero coverage).
+        vec2 q  = abs(v_local.xy - self.xy) - self.zw;
+        vec2 fw = max(fwidth(q), vec2_splat(1e-5));
+        vec2 cv = clamp(vec2_splat(0.5) - q / fw, vec2_splat(0.0), vec2_splat(1.0));
+        c.a *= cv.x * cv.y;
+    }
+    c.a *= uiloRoundedAlpha(v_worldpos, u_clipRect,  u_clipParams);
+    c.a *= uiloRoundedAlpha(v_worldpos, u_clipRect2, u_clipParams2);
+    c.a *= uiloClipChain(v_worldpos, v_clip);
+    if (c.a <= 0.0) discard;
+    gl_FragColor = c;
+}
@@ -1,4 +1,4 @@
-$input v_color0, v_worldpos
+$input v_color0, v_worldpos, v_clip
 
 #include <bgfx_shader.sh>
 
@@ -26,10 +26,13 @@ float uiloRoundedAlpha(vec2 p, vec4 rect, vec4 params) {
     return 1.0 - smoothstep(-aa, aa, d);
 }
 
+#include "clip.sh"
+
 void main() {
     vec4 c = v_color0;
     c.a *= uiloRoundedAlpha(v_worldpos, u_clipRect,  u_clipParams);
     c.a *= uiloRoundedAlpha(v_worldpos, u_clipRect2, u_clipParams2);
+    c.a *= uiloClipChain(v_worldpos, v_clip);
     if (c.a <= 0.0) discard;
     gl_FragColor = c;
 }
@@ -1,10 +1,11 @@
-$input v_color0, v_texcoord0, v_worldpos
+$input v_color0, v_texcoord0, v_worldpos, v_clip
 
 #include <bgfx_shader.sh>
 
 SAMPLER2D(s_texColor, 0);
 
-// x = clipEllipse flag (1 = enabled, 0 = disabled)
+// clipEllipse: xy = uv size and zw = uv origin of the image's region of
+// the texture; x = 0 disables the mask.
 uniform vec4 u_imgFlags;
 uniform vec4 u_clipRect;
 uniform vec4 u_clipParams;
@@ -23,11 +24,13 @@ float uiloRoundedAlpha(vec2 p, vec4 rect, vec4 params) {
     return 1.0 - smoothstep(-aa, aa, d);
 }
 
+#include "clip.sh"
+
 void main() {
     vec4 c = texture2D(s_texColor, v_texcoord0) * v_color0;
 
-    if (u_imgFlags.x > 0.5) {
-        vec2  d  = v_texcoord0 - vec2(0.5, 0.5);
+    if (u_imgFlags.x > 0.0) {
+        vec2  d  = (v_texcoord0 - u_imgFlags.zw) / u_imgFlags.xy - vec2(0.5, 0.5);
         float r2 = dot(d, d) * 4.0;
         float aa = fwidth(r2) + 1e-5;
         c.a *= 1.0 - smoothstep(1.0 - aa, 1.0 + aa, r2);
@@ -35,6 +38,7 @@ void main() {
 
     c.a *= uiloRoundedAlpha(v_worldpos, u_clipRect,  u_clipParams);
     c.a *= uiloRoundedAlpha(v_worldpos, u_clipRect2, u_clipParams2);
+    c.a *= uiloClipChain(v_worldpos, v_clip);
     if (c.a <= 0.0) discard;
     gl_FragColor = c;
 }
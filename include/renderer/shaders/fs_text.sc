@@ -1,4 +1,4 @@
-$input v_color0, v_texcoord0, v_worldpos
+$input v_color0, v_texcoord0, v_worldpos, v_clip
 
 #include <bgfx_shader.sh>
 
@@ -21,11 +21,14 @@ float uiloRoundedAlpha(vec2 p, vec4 rect, vec4 params) {
     return 1.0 - smoothstep(-aa, aa, d);
 }
 
+#include "clip.sh"
+
 void main() {
     float a = texture2D(s_texColor, v_texcoord0).x;
     float ca = v_color0.a * a
              * uiloRoundedAlpha(v_worldpos, u_clipRect,  u_clipParams)
-             * uiloRoundedAlpha(v_worldpos, u_clipRect2, u_clipParams2);
+             * uiloRoundedAlpha(v_worldpos, u_clipRect2, u_clipParams2)
+             * uiloClipChain(v_worldpos, v_clip);
     if (ca <= 0.0) discard;
     gl_FragColor = vec4(v_color0.rgb, ca);
 }
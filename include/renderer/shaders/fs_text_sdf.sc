@@ -0,0 +1,38 @@
+$input v_color0, v_texcoord0, v_worldpos, v_clip
+
+#include <bgfx_shader.sh>
+
+SAMPLER2D(s_texColor, 0);
+
+uniform vec4 u_clipRect;
+uniform vec4 u_clipParams;
+uniform vec4 u_clipRect2;
+uniform vec4 u_clipParams2;
+
+float uiloRoundedAlpha(vec2 p, vec4 rect, vec4 params) {
+    if (params.y < 0.5) return 1.0;
+    vec2  c  = rect.xy;
+    vec2  b  = rect.zw;
+    float r  = params.x;
+    vec2  q  = abs(p - c) - b + vec2_splat(r);
+    float d  = length(max(q, vec2_splat(0.0))) +
+               min(max(q.x, q.y), 0.0) - r;
+    float aa = fwidth(d) + 1e-5;
+    return 1.0 - smoothstep(-aa, aa, d);
+}
+
+#include "clip.sh"
+
+// Signed-distance glyphs (see Renderer_Text.cpp: baked with the edge at
+// 128/255). fwidth keeps the AA ramp ~1 screen pixel wide at any scale.
+void main() {
+    float d  = texture2D(s_texColor, v_texcoord0).x;
+    float aa = max(fwidth(d) * 0.75, 1e-4);
+    float a  = smoothstep(0.5 - aa, 0.5 + aa, d);
+    float ca = v_color0.a * a
+             * uiloRoundedAlpha(v_worldpos, u_clipRect,  u_clipParams)
+             * uiloRoundedAlpha(v_worldpos, u_clipRect2, u_clipParams2)
+             * uiloClipChain(v_worldpos, v_clip);
+    if (ca <= 0.0) discard;
+    gl_FragColor = vec4(v_color0.rgb, ca);
+}
@@ -0,0 +1,102 @@
+$input v_color0, v_texcoord0, v_worldpos, v_clip
+
+#include <bgfx_shader.sh>
+
+// RG32F peak texture: one {min, max} texel per column, one row per lane.
+SAMPLER2D(s_texColor, 0);
+
+// x = style (0 Bars, 1 Line, 2 Filled), y = gain, z = thickness (px),
+// w = texture v of the lane's row
+uniform vec4 u_waveParams;
+// x = columns, y = strip width (px), z = strip height (px)
+uniform vec4 u_waveSize;
+uniform vec4 u_clipRect;
+uniform vec4 u_clipParams;
+uniform vec4 u_clipRect2;
+uniform vec4 u_clipParams2;
+
+float uiloRoundedAlpha(vec2 p, vec4 rect, vec4 params) {
+    if (params.y < 0.5) return 1.0;
+    vec2  c  = rect.xy;
+    vec2  b  = rect.zw;
+    float r  = params.x;
+    vec2  q  = abs(p - c) - b + vec2_splat(r);
+    float d  = length(max(q, vec2_splat(0.0))) +
+               min(max(q.x, q.y), 0.0) - r;
+    float aa = fwidth(d) + 1e-5;
+    return 1.0 - smoothstep(-aa, aa, d);
+}
+
+#include "clip.sh"
+
+// Explicit LOD: implicit-derivative sampling isn't allowed under the
+// divergent loop in main() on every backend.
+vec2 wavePeak(float col) {
+    vec2 mm = texture2DLod(s_texColor, vec2((col + 0.5) / u_waveSize.x, u_waveParams.w), 0.0).xy;
+    return clamp(mm * u_waveParams.y, -1.0, 1.0);
+}
+
+// The signed extreme drawn by Line / Filled.
+float waveSigned(vec2 mm) {
+    return abs(mm.y) >= abs(mm.x) ? mm.y : mm.x;
+}
+
+// Coverage of a vertical stroke centred on x, spanning [y0, y1].
+float waveBar(vec2 p, float x, float halfW, float y0, float y1) {
+    float cx = clamp(halfW + 0.5 - abs(p.x - x), 0.0, 1.0);
+    float cy = clamp(min(p.y - y0, y1 - p.y) + 0.5, 0.0, 1.0);
+    return cx * cy;
+}
+
+float waveSegment(vec2 p, vec2 a, vec2 b, float halfW) {
+    vec2  ab = b - a;
+    float t  = clamp(dot(p - a, ab) / max(dot(ab, ab), 1e-6), 0.0, 1.0);
+    return clamp(halfW + 0.5 - length(p - a - ab * t), 0.0, 1.0);
+}
+
+void main() {
+    float cols  = u_waveSize.x;
+    vec2  p     = v_texcoord0 * u_waveSize.yz;   // strip-local pixels
+    float colW  = u_waveSize.y / cols;
+    float midY  = u_waveSize.z * 0.5;
+    float style = u_waveParams.x;
+    float thick = u_waveParams.z;
+    float here  = floor(p.x / colW);
+
+    // Strokes are centred on their column, so only the nearest few
+    // columns can reach this pixel.
+    float cover = 0.0;
+    for (int i = -2; i <= 2; ++i) {
+        float k = here + float(i);
+        if (k < 0.0 || k > cols - 1.0) continue;
+        vec2  mm = wavePeak(k);
+        float x  = (k + 0.5) * colW;
+        if (style < 0.5) {
+            float y0 = midY - mm.y * midY;
+            float y1 = midY - mm.x * midY;
+            if (y1 - y0 < 1.0) { y0 = midY - 0.5; y1 = midY + 0.5; }
+            cover = max(cover, waveBar(p, x, thick * 0.5, y0, y1));
+        } else if (style < 1.5) {
+            if (k + 1.0 > cols - 1.0) continue;
+            vec2 a = vec2(x,        midY - waveSigned(mm) * midY);
+            vec2 b = vec2(x + colW, midY - waveSigned(wavePeak(k + 1.0)) * midY);
+            cover = max(cover, waveSegment(p, a, b, thick * 0.5));
+        } else {
+            // Baseline to the signed peak, wide enough to meet the
+            // neighbouring columns.
+            float v = waveSigned(mm);
+            float y = midY - v * midY;
+            if (abs(y - midY) < 0.5) y = midY + (v >= 0.0 ? -0.5 : 0.5);
+            cover = max(cover, waveBar(p, x, max(thick, colW + 1.0) * 0.5,
+                                       min(y, midY), max(y, midY)));
+        }
+    }
+
+    vec4 c = v_color0;
+    c.a *= cover;
+    c.a *= uiloRoundedAlpha(v_worldpos, u_clipRect,  u_clipParams);
+    c.a *= uiloRoundedAlpha(v_worldpos, u_clipRect2, u_clipParams2);
+    c.a *= uiloClipChain(v_worldpos, v_clip);
+    if (c.a <= 0.0) discard;
+    gl_FragColor = c;
+}
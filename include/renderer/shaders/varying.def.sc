@@ -1,7 +1,30 @@
 vec4 v_color0    : COLOR0    = vec4(1.0, 0.0, 0.0, 1.0);
 vec2 v_texcoord0 : TEXCOORD0 = vec2(0.0, 0.0);
 vec2 v_worldpos  : TEXCOORD1 = vec2(0.0, 0.0);
+// Indexed-clip node of batched geometry (0 = none), from a_texcoord1.x or
+// the shape instance.
+float v_clip     : TEXCOORD7 = 0.0;
 
 vec2 a_position  : POSITION;
 vec4 a_color0    : COLOR0;
 vec2 a_texcoord0 : TEXCOORD0;
+
+// Glass panels (vs_glass): tint / base colour and three parameter blocks,
+// forwarded through v_color1..3, v_shape and v_local.
+vec4 a_color1    : COLOR1;
+vec4 a_color2    : COLOR2;
+vec4 a_texcoord1 : TEXCOORD1;
+vec4 a_texcoord2 : TEXCOORD2;
+vec4 a_texcoord3 : TEXCOORD3;
+
+// Instanced shapes (vs_shape / fs_shape): corner colors TR / BR / BL
+// (TL rides in v_color0), the shape rect, and local position + radius.
+vec4 v_color1    : TEXCOORD2 = vec4(1.0, 0.0, 0.0, 1.0);
+vec4 v_color2    : TEXCOORD3 = vec4(1.0, 0.0, 0.0, 1.0);
+vec4 v_color3    : TEXCOORD4 = vec4(1.0, 0.0, 0.0, 1.0);
+vec4 v_shape     : TEXCOORD5 = vec4(0.0, 0.0, 0.0, 0.0);
+vec4 v_local     : TEXCOORD6 = vec4(0.0, 0.0, 0.0, 0.0);
+
+vec4 i_data0     : TEXCOORD7;
+vec4 i_data1     : TEXCOORD6;
+vec4 i_data2     : TEXCOORD5;
@@ -0,0 +1,20 @@
+$input  a_position, a_color0, a_texcoord0, a_color1, a_color2, a_texcoord1, a_texcoord2, a_texcoord3
+$output v_color0, v_texcoord0, v_worldpos, v_color1, v_color2, v_color3, v_shape, v_local
+
+#include <bgfx_shader.sh>
+
+// Deferred glass panels (see GlassVertex in RendererImpl.hpp). Every
+// per-panel parameter rides on the vertices so non-overlapping panels of
+// any kind share one draw. They are equal at all four corners, so the
+// interpolated varyings hand fs_glass the panel's own values.
+void main() {
+    gl_Position = mul(u_modelViewProj, vec4(a_position, 0.0, 1.0));
+    v_color0    = a_color0;      // .rg = element-local 0..1
+    v_texcoord0 = a_texcoord0;   // blur-target UV
+    v_worldpos  = a_position;
+    v_color1    = a_texcoord1;   // opacity, saturation, brightness, edge highlight
+    v_color2    = a_color1;      // tint
+    v_color3    = a_color2;      // element base colour
+    v_shape     = a_texcoord2;   // corner radius, half width, half height, refraction (UV)
+    v_local     = a_texcoord3;   // kind, unused, anim speed, anim strength / ladder weight
+}
@@ -0,0 +1,52 @@
+$input  a_position, i_data0, i_data1, i_data2
+$output v_color0, v_color1, v_color2, v_color3, v_shape, v_local, v_worldpos, v_clip
+
+#include <bgfx_shader.sh>
+
+// Per instance (see ShapeInstance in RendererImpl.hpp):
+//   i_data0 = shape rect x, y, w, h (local px)
+//   i_data1 = corner colors TL, TR, BR, BL as r * 65536 + g * 256 + b
+//   i_data2 = x: corner radius (< 0: antialiased rect),
+//             y: aTL + aTR * 256, z: aBR + aBL * 256,
+//             w: quad padding beyond the rect (px, < 4) + clip node * 4
+// A stop gradient (y < 0: -1 linear, -2 radial) instead carries its ramp
+// geometry in i_data1 and its gradient table row in i_data2.z.
+// The batch's affine transform: [0] = a, b, c, d; [1].xy = tx, ty
+// (x' = a*x + c*y + tx, y' = b*x + d*y + ty).
+uniform vec4 u_shapeXform[2];
+
+vec4 shapeColor(float rgb, float a) {
+    float r = floor(rgb / 65536.0);
+    float g = floor(mod(rgb / 256.0, 256.0));
+    float b = mod(rgb, 256.0);
+    return vec4(r, g, b, a) / 255.0;
+}
+
+void main() {
+    vec4  rect  = i_data0;
+    float pad   = mod(i_data2.w, 4.0);
+    vec2  local = rect.xy - vec2_splat(pad) + a_position * (rect.zw + vec2_splat(2.0 * pad));
+    vec4  m     = u_shapeXform[0];
+    vec2  world = vec2(m.x * local.x + m.z * local.y,
+                       m.y * local.x + m.w * local.y) + u_shapeXform[1].xy;
+    gl_Position = mul(u_modelViewProj, vec4(world, 0.0, 1.0));
+
+    if (i_data2.y < 0.0) {
+        // fs_shape: v_color1 = kind (0 linear, 1 radial), row, -, w < 0.
+        v_color0 = i_data1;
+        v_color1 = vec4(-i_data2.y - 1.0, i_data2.z, 0.0, -1.0);
+        v_color2 = vec4_splat(0.0);
+        v_color3 = vec4_splat(0.0);
+    } else {
+        float aTL = mod(i_data2.y, 256.0), aTR = floor(i_data2.y / 256.0);
+        float aBR = mod(i_data2.z, 256.0), aBL = floor(i_data2.z / 256.0);
+        v_color0 = shapeColor(i_data1.x, aTL);
+        v_color1 = shapeColor(i_data1.y, aTR);
+        v_color2 = shapeColor(i_data1.z, aBR);
+        v_color3 = shapeColor(i_data1.w, aBL);
+    }
+    v_shape    = rect;
+    v_local    = vec4(local, i_data2.x, 0.0);
+    v_worldpos = world;
+    v_clip     = floor(i_data2.w / 4.0);
+}
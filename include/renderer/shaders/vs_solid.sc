@@ -1,5 +1,5 @@
-$input  a_position, a_color0
-$output v_color0, v_worldpos
+$input  a_position, a_color0, a_texcoord1
+$output v_color0, v_worldpos, v_clip
 
 #include <bgfx_shader.sh>
 
@@ -7,4 +7,5 @@ void main() {
     gl_Position = mul(u_modelViewProj, vec4(a_position, 0.0, 1.0));
     v_color0    = a_color0;
     v_worldpos  = a_position;
+    v_clip      = a_texcoord1.x;
 }
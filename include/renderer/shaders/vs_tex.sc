@@ -1,5 +1,5 @@
-$input  a_position, a_color0, a_texcoord0
-$output v_color0, v_texcoord0, v_worldpos
+$input  a_position, a_color0, a_texcoord0, a_texcoord1
+$output v_color0, v_texcoord0, v_worldpos, v_clip
 
 #include <bgfx_shader.sh>
 
@@ -8,4 +8,5 @@ void main() {
     v_color0    = a_color0;
     v_texcoord0 = a_texcoord0;
     v_worldpos  = a_position;
+    v_clip      = a_texcoord1.x;
 }
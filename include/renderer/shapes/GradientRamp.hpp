@@ -0,0 +1,27 @@
+#pragma once
+#include "../../utils/Color.hpp"
+
+#include <cstdint>
+
+namespace uilo {
+
+// One stop of a ramp handed to Renderer::bakeGradientRamp.
+struct GradientRampStop {
+    float offset = 0.f;
+    Color color;
+};
+
+// A linear / radial fill the shape shader evaluates per pixel from a row of
+// the renderer's gradient table. Only good for the frame it was baked in
+// (rows are recycled); elements bake again each time they draw.
+struct GradientRamp {
+    uint16_t row    = UINT16_MAX;
+    bool     radial = false;
+    // In the shape's unit square. Linear: start x, y, end x, y.
+    // Radial: centre x, y, radius x, y.
+    float    geom[4] = { 0.f, 0.f, 1.f, 0.f };
+
+    bool valid() const { return row != UINT16_MAX; }
+};
+
+} // namespace uilo
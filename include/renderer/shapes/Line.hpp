@@ -2,8 +2,18 @@
 #include "../../utils/Math.hpp"
 #include "../../utils/Color.hpp"
 
+#include <cstdint>
+
 namespace uilo {
 
+// How Renderer::drawPolyline turns a corner. Miter falls back to a bevel
+// past a 4x-thickness spike.
+enum class LineJoin : uint8_t {
+    Miter,
+    Round,
+    Bevel,
+};
+
 struct Line {
     Vec2f start;
     Vec2f end;
@@ -1,6 +1,7 @@
 #pragma once
 #include "../../utils/Math.hpp"
 #include "../../utils/Color.hpp"
+#include "GradientRamp.hpp"
 
 namespace uilo {
 
@@ -21,6 +22,10 @@ struct RoundedRect {
     Color colorTL = Color::White, colorTR = Color::White,
           colorBL = Color::White, colorBR = Color::White;
 
+    // Stop gradient the instanced path samples instead of the corners,
+    // which stay its fallback.
+    GradientRamp ramp{};
+
     void setGradientColors(const Color c[4]) {
         gradient = true;
         colorTL = c[0]; colorTR = c[1]; colorBL = c[2]; colorBR = c[3];
@@ -19,6 +19,7 @@ struct Dimension {
     bool percent = false;
 
     float resolve(float parent) const { return percent ? parent * value / 100.f : value; }
+    constexpr bool operator==(const Dimension& o) const { return value == o.value && percent == o.percent; }
 };
 
 // Literals to make it easier to specify dimensions in code, e.g. 10_px or 50_pct
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace uilo {
+
+// Hashed element name for lookups that run often. "meterL"_id is folded at
+// compile time; ElementId(name) hashes the same way at run time, so either
+// matches an element registered under that name (FNV-1a, 64-bit).
+struct ElementId {
+    uint64_t value = 0;
+
+    constexpr ElementId() = default;
+    constexpr explicit ElementId(std::string_view name) : value(hash(name)) {}
+
+    static constexpr uint64_t hash(std::string_view name) {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (char c : name) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    constexpr bool operator==(const ElementId& o) const { return value == o.value; }
+};
+
+constexpr ElementId operator""_id(const char* name, std::size_t len) {
+    return ElementId(std::string_view(name, len));
+}
+
+} // namespace uilo
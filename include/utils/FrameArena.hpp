@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace uilo {
+
+// Bump allocator for per-frame temporaries. UILO owns one and resets it at
+// the top of every update(); anything allocated from it is valid until the
+// next reset. After a reset that followed an overflow, the blocks are
+// merged into one big enough for the whole previous frame, so steady-state
+// frames don't touch the heap.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t initialBytes = 64 * 1024) : m_nextBlockSize(initialBytes) {}
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+        if (bytes == 0) bytes = 1;
+        if (!m_blocks.empty()) {
+            Block& b = m_blocks.back();
+            const std::size_t at = (b.used + align - 1) & ~(align - 1);
+            if (at + bytes <= b.size) {
+                b.used = at + bytes;
+                m_frameBytes += bytes;
+                return b.data.get() + at;
+            }
+        }
+        const std::size_t size = std::max(m_nextBlockSize, bytes + align);
+        m_nextBlockSize = size * 2;
+        m_blocks.push_back(Block{std::make_unique<std::byte[]>(size), size, 0});
+        return allocate(bytes, align);
+    }
+
+    void reset() {
+        if (m_blocks.size() > 1) {
+            std::size_t total = 0;
+            for (auto& b : m_blocks) total += b.size;
+            m_blocks.clear();
+            m_blocks.push_back(Block{std::make_unique<std::byte[]>(total), total, 0});
+            m_nextBlockSize = total;
+        } else if (!m_blocks.empty()) {
+            m_blocks.back().used = 0;
+        }
+        m_frameBytes = 0;
+    }
+
+    // Bytes handed out since the last reset (excluding alignment padding).
+    std::size_t getFrameBytes() const { return m_frameBytes; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size = 0;
+        std::size_t used = 0;
+    };
+
+    std::vector<Block> m_blocks;
+    std::size_t        m_nextBlockSize;
+    std::size_t        m_frameBytes = 0;
+};
+
+// std allocator over a FrameArena. Deallocation is a no-op; memory comes
+// back on the next reset. A null arena falls back to the heap so elements
+// that aren't attached to a UILO still work.
+template <class T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    FrameAllocator(FrameArena* arena = nullptr) noexcept : m_arena(arena) {}
+    template <class U> FrameAllocator(const FrameAllocator<U>& o) noexcept : m_arena(o.arena()) {}
+
+    T* allocate(std::size_t n) {
+        if (m_arena) return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t) noexcept {
+        if (!m_arena) ::operator delete(p);
+    }
+
+    FrameArena* arena() const noexcept { return m_arena; }
+
+    template <class U> bool operator==(const FrameAllocator<U>& o) const noexcept { return m_arena == o.arena(); }
+
+private:
+    FrameArena* m_arena;
+};
+
+// Vector whose storage lives in the frame arena. Reserve up front where the
+// size is known: growth leaves the old storage behind until the reset.
+template <class T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+} // namespace uilo
@@ -0,0 +1,77 @@
+#include "GapBuffer.hpp"
+
+#include <algorithm>
+
+namespace uilo {
+
+void GapBuffer::assign(std::u32string_view text) {
+    m_data.assign(text.begin(), text.end());
+    m_gapStart = m_gapEnd = m_data.size();
+}
+
+void GapBuffer::moveGap(std::size_t pos) {
+    const auto base = m_data.begin();
+    if (pos < m_gapStart) {
+        const std::size_t n = m_gapStart - pos;
+        std::copy_backward(base + (std::ptrdiff_t)pos, base + (std::ptrdiff_t)m_gapStart,
+                           base + (std::ptrdiff_t)m_gapEnd);
+        m_gapStart -= n;
+        m_gapEnd   -= n;
+    } else if (pos > m_gapStart) {
+        const std::size_t n = pos - m_gapStart;
+        std::copy(base + (std::ptrdiff_t)m_gapEnd, base + (std::ptrdiff_t)(m_gapEnd + n),
+                  base + (std::ptrdiff_t)m_gapStart);
+        m_gapStart += n;
+        m_gapEnd   += n;
+    }
+}
+
+void GapBuffer::reserveGap(std::size_t n) {
+    const std::size_t gap = m_gapEnd - m_gapStart;
+    if (gap >= n) return;
+    // Grow by at least half the text so a long paste or steady typing
+    // reallocates a logarithmic number of times.
+    const std::size_t tail   = m_data.size() - m_gapEnd;
+    const std::size_t newGap = std::max({n, size() / 2, (std::size_t)64});
+    m_data.resize(m_gapStart + newGap + tail);
+    const auto base = m_data.begin();
+    std::copy_backward(base + (std::ptrdiff_t)m_gapEnd, base + (std::ptrdiff_t)(m_gapEnd + tail),
+                       m_data.end());
+    m_gapEnd = m_gapStart + newGap;
+}
+
+void GapBuffer::insert(std::size_t pos, std::u32string_view text) {
+    if (text.empty()) return;
+    moveGap(std::min(pos, size()));
+    reserveGap(text.size());
+    std::copy(text.begin(), text.end(), m_data.begin() + (std::ptrdiff_t)m_gapStart);
+    m_gapStart += text.size();
+}
+
+void GapBuffer::erase(std::size_t pos, std::size_t n) {
+    const std::size_t sz = size();
+    if (pos >= sz) return;
+    n = std::min(n, sz - pos);
+    if (n == 0) return;
+    moveGap(pos);
+    m_gapEnd += n;
+}
+
+std::u32string GapBuffer::substr(std::size_t pos, std::size_t n) const {
+    const std::size_t sz = size();
+    if (pos >= sz) return {};
+    n = std::min(n, sz - pos);
+    std::u32string r;
+    r.reserve(n);
+    const std::size_t end = pos + n;
+    if (pos < m_gapStart)
+        r.append(m_data.data() + pos, std::min(end, m_gapStart) - pos);
+    if (end > m_gapStart) {
+        const std::size_t from = std::max(pos, m_gapStart);
+        const std::size_t gap  = m_gapEnd - m_gapStart;
+        r.append(m_data.data() + from + gap, end - from);
+    }
+    return r;
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace uilo {
+
+// UTF-32 text with a movable gap at the last edit, for editors. Typing or
+// deleting at one spot only shifts the characters between the previous
+// edit and this one, so keystrokes stay cheap however long the text is.
+class GapBuffer {
+public:
+    GapBuffer() = default;
+    explicit GapBuffer(std::u32string_view text) { assign(text); }
+
+    std::size_t size()  const { return m_data.size() - (m_gapEnd - m_gapStart); }
+    bool        empty() const { return size() == 0; }
+    char32_t operator[](std::size_t i) const {
+        return m_data[i < m_gapStart ? i : i + (m_gapEnd - m_gapStart)];
+    }
+
+    void assign(std::u32string_view text);
+    void clear() { m_data.clear(); m_gapStart = m_gapEnd = 0; }
+    // pos is clamped to size(); erase() clamps the count as well.
+    void insert(std::size_t pos, std::u32string_view text);
+    void erase(std::size_t pos, std::size_t n);
+
+    // Copy of [pos, pos + n), clamped to size().
+    std::u32string substr(std::size_t pos, std::size_t n = std::u32string::npos) const;
+    std::u32string str() const { return substr(0); }
+
+private:
+    void moveGap(std::size_t pos);
+    void reserveGap(std::size_t n);
+
+    std::vector<char32_t> m_data;   // [0, gapStart) + gap + [gapEnd, end)
+    std::size_t           m_gapStart = 0;
+    std::size_t           m_gapEnd   = 0;
+};
+
+}
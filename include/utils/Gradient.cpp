@@ -1,6 +1,9 @@
 #include "Gradient.hpp"
 #include "../Palette.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace uilo {
 
 Gradient Gradient::vertical(GradientColor top, GradientColor bottom) {
@@ -11,7 +14,99 @@ Gradient Gradient::horizontal(GradientColor left, GradientColor right) {
     return Gradient(left, right, left, right);
 }
 
+Gradient Gradient::linear(float angleDegrees, std::vector<GradientColorStop> stops) {
+    Gradient g;
+    g.kind  = GradientKind::Linear;
+    g.angle = angleDegrees;
+    g.stops = std::move(stops);
+    return g;
+}
+
+Gradient Gradient::radial(std::vector<GradientColorStop> stops) {
+    Gradient g;
+    g.kind  = GradientKind::Radial;
+    g.stops = std::move(stops);
+    return g;
+}
+
+Gradient& Gradient::addStop(float offset, GradientColor c) {
+    if (kind == GradientKind::Corners) kind = GradientKind::Linear;
+    stops.push_back({ offset, std::move(c) });
+    return *this;
+}
+
+void Gradient::rampGeometry(float out[4]) const {
+    if (kind == GradientKind::Radial) {
+        out[0] = centerX;
+        out[1] = centerY;
+        out[2] = out[3] = std::max(radius, 1e-4f);
+        return;
+    }
+    // Through the centre along the angle, long enough that the corners
+    // furthest back and forward land on 0 and 1.
+    const float rad = angle * 3.14159265f / 180.f;
+    const float dx = std::cos(rad), dy = std::sin(rad);
+    const float half = 0.5f * (std::fabs(dx) + std::fabs(dy));
+    out[0] = 0.5f - dx * half;
+    out[1] = 0.5f - dy * half;
+    out[2] = 0.5f + dx * half;
+    out[3] = 0.5f + dy * half;
+}
+
+void Gradient::resolveStops(const Palette& palette, std::vector<GradientColorStop>& out) const {
+    out.clear();
+    out.reserve(stops.size());
+    for (const auto& s : stops)
+        out.push_back({ std::clamp(s.offset, 0.f, 1.f), palette.resolve(s.color.role, s.color.color) });
+    std::stable_sort(out.begin(), out.end(),
+                     [](const GradientColorStop& a, const GradientColorStop& b) { return a.offset < b.offset; });
+}
+
+namespace {
+
+Color lerpColor(Color a, Color b, float t) {
+    auto ch = [t](uint8_t x, uint8_t y) { return (uint8_t)std::lround(x + (y - x) * t); };
+    return Color{ ch(a.r, b.r), ch(a.g, b.g), ch(a.b, b.b), ch(a.a, b.a) };
+}
+
+// The resolved ramp at t (clamped past the end stops).
+Color sampleStops(const std::vector<GradientColorStop>& stops, float t) {
+    if (t <= stops.front().offset) return stops.front().color.color;
+    for (size_t i = 1; i < stops.size(); ++i) {
+        if (t > stops[i].offset) continue;
+        const float span = stops[i].offset - stops[i - 1].offset;
+        return lerpColor(stops[i - 1].color.color, stops[i].color.color,
+                         span > 0.f ? (t - stops[i - 1].offset) / span : 1.f);
+    }
+    return stops.back().color.color;
+}
+
+} // anon
+
 void Gradient::resolve(const Palette& palette, Color out[4]) const {
+    if (hasStops()) {
+        std::vector<GradientColorStop> resolved;
+        resolveStops(palette, resolved);
+        if (resolved.empty()) {
+            for (int i = 0; i < 4; ++i) out[i] = Color{0, 0, 0, 0};
+            return;
+        }
+        float geom[4];
+        rampGeometry(geom);
+        static constexpr float kCorners[4][2] = { {0.f, 0.f}, {1.f, 0.f}, {0.f, 1.f}, {1.f, 1.f} };
+        for (int i = 0; i < 4; ++i) {
+            const float u = kCorners[i][0], v = kCorners[i][1];
+            float t;
+            if (kind == GradientKind::Radial) {
+                t = std::hypot((u - geom[0]) / geom[2], (v - geom[1]) / geom[3]);
+            } else {
+                const float dx = geom[2] - geom[0], dy = geom[3] - geom[1];
+                t = ((u - geom[0]) * dx + (v - geom[1]) * dy) / std::max(dx * dx + dy * dy, 1e-6f);
+            }
+            out[i] = sampleStops(resolved, std::clamp(t, 0.f, 1.f));
+        }
+        return;
+    }
     out[0] = palette.resolve(topLeft.role,     topLeft.color);
     out[1] = palette.resolve(topRight.role,    topRight.color);
     out[2] = palette.resolve(bottomLeft.role,  bottomLeft.color);
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "Color.hpp"
+#include "Role.hpp"
 
+#include <cstdint>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace uilo {
 
@@ -39,6 +42,19 @@ class Palette; // resolve() walks it at draw time — see Gradient.cpp
     Colors are interpolated across the background quad on the GPU, and the
     rounded-corner SDF mask clips the result exactly like a solid fill —
     gradients and rounding compose with no extra cost.
+
+    Linear and radial gradients take any number of color stops instead of
+    corners. Their geometry is in the shape's unit square, (0, 0) top-left
+    to (1, 1) bottom-right:
+
+        Gradient::linear(45.f, {{0.f, "accent"}, {0.5f, Color::White}, {1.f, "panel"}});
+        Gradient::radial({{0.f, Color{255, 240, 200}}, {1.f, Color{40, 20, 60}}})
+            .setCenter(0.5f, 0.3f).setRadius(0.7f);
+
+    The stops are baked into a row of the renderer's gradient table and the
+    fragment shader samples it, so a many-stop fill is still one batched
+    instance. Without instanced shapes it falls back to the ramp's colors
+    at the four corners.
 */
 
 // One corner of a gradient: a literal Color, or a palette role resolved at
@@ -46,12 +62,12 @@ class Palette; // resolve() walks it at draw time — see Gradient.cpp
 // sites just pass a color or a role name.
 struct GradientColor {
     Color       color { 0, 0, 0, 0 };
-    std::string role;                 // non-empty -> resolved via palette
+    Role        role;                 // non-empty -> resolved via palette
 
     GradientColor() = default;
     GradientColor(Color c) : color(c) {}
     GradientColor(const char* paletteRole) : role(paletteRole) {}
-    GradientColor(std::string paletteRole) : role(std::move(paletteRole)) {}
+    GradientColor(const std::string& paletteRole) : role(paletteRole) {}
 
     bool operator==(const GradientColor& o) const { return color == o.color && role == o.role; }
     bool operator!=(const GradientColor& o) const { return !(*this == o); }
@@ -60,9 +76,35 @@ struct GradientColor {
 // Deprecated alias for the old name. Prefer GradientColor.
 using GradientStop = GradientColor;
 
+// One stop of a linear / radial gradient: a color at an offset along the
+// ramp (0 = start, 1 = end).
+struct GradientColorStop {
+    float         offset = 0.f;
+    GradientColor color;
+
+    bool operator==(const GradientColorStop& o) const { return offset == o.offset && color == o.color; }
+    bool operator!=(const GradientColorStop& o) const { return !(*this == o); }
+};
+
+enum class GradientKind : uint8_t {
+    Corners,    // four corner colors, bilinear
+    Linear,     // stops along `angle`
+    Radial,     // stops out from `center` to `radius`
+};
+
 struct Gradient {
     GradientColor topLeft, topRight, bottomLeft, bottomRight;
 
+    GradientKind                   kind = GradientKind::Corners;
+    std::vector<GradientColorStop> stops;            // Linear / Radial, by offset
+    // Linear: degrees clockwise from left-to-right (90 = top to bottom, 45
+    // = top-left corner to bottom-right); the ramp spans the whole shape.
+    float angle   = 0.f;
+    // Radial: centre and radius in the unit square (0.5 reaches the edge
+    // midpoints, ~0.707 the corners).
+    float centerX = 0.5f, centerY = 0.5f;
+    float radius  = 0.5f;
+
     Gradient() = default;
 
     // Four corners in reading order: {topLeft, topRight, bottomLeft, bottomRight}.
@@ -90,24 +132,42 @@ struct Gradient {
 
     static Gradient vertical(GradientColor top, GradientColor bottom);
     static Gradient horizontal(GradientColor left, GradientColor right);
+    static Gradient linear(float angleDegrees, std::vector<GradientColorStop> stops);
+    static Gradient radial(std::vector<GradientColorStop> stops);
+
+    // Appends a stop; a corner gradient becomes a linear one.
+    Gradient& addStop(float offset, GradientColor c);
+    Gradient& setAngle(float degrees)        { angle = degrees;         return *this; }
+    Gradient& setCenter(float x, float y)    { centerX = x; centerY = y; return *this; }
+    Gradient& setRadius(float r)             { radius = r;              return *this; }
+    bool      hasStops() const               { return kind != GradientKind::Corners; }
 
     // False for a default-constructed Gradient (all corners unset) — the
     // element falls back to its solid color. A gradient of deliberately
     // transparent literals still counts as inactive because it would draw
     // nothing anyway.
     bool active() const {
+        if (hasStops()) return !stops.empty();
         const GradientColor unset;
         return topLeft != unset || topRight != unset ||
                bottomLeft != unset || bottomRight != unset;
     }
 
     // Resolve the four corners for drawing (role colors through the palette,
-    // literal colors pass through). Output order: TL, TR, BL, BR.
+    // literal colors pass through). Output order: TL, TR, BL, BR. A stop
+    // gradient gives its ramp's colors at the corners.
     void resolve(const Palette& palette, Color out[4]) const;
+    // Stop gradients: the stops' colors, resolved, sorted by offset.
+    void resolveStops(const Palette& palette, std::vector<GradientColorStop>& out) const;
+    // Stop gradients, in the unit square. Linear: start x, y, end x, y.
+    // Radial: centre x, y, radius x, y.
+    void rampGeometry(float out[4]) const;
 
     bool operator==(const Gradient& o) const {
         return topLeft == o.topLeft && topRight == o.topRight &&
-               bottomLeft == o.bottomLeft && bottomRight == o.bottomRight;
+               bottomLeft == o.bottomLeft && bottomRight == o.bottomRight &&
+               kind == o.kind && stops == o.stops && angle == o.angle &&
+               centerX == o.centerX && centerY == o.centerY && radius == o.radius;
     }
     bool operator!=(const Gradient& o) const { return !(*this == o); }
 };
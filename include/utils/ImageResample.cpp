@@ -0,0 +1,45 @@
+#include "ImageResample.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace uilo {
+
+void boxDownsampleRgba(const uint8_t* src, int w, int h, uint8_t* dst, int dw, int dh) {
+    const float sx = (float)w / (float)dw, sy = (float)h / (float)dh;
+    for (int y = 0; y < dh; ++y) {
+        const float fy0 = (float)y * sy, fy1 = fy0 + sy;
+        const int   y0  = (int)fy0, y1 = std::min(h, (int)std::ceil(fy1));
+        for (int x = 0; x < dw; ++x) {
+            const float fx0 = (float)x * sx, fx1 = fx0 + sx;
+            const int   x0  = (int)fx0, x1 = std::min(w, (int)std::ceil(fx1));
+            float r = 0.f, g = 0.f, b = 0.f, a = 0.f, area = 0.f;
+            for (int yy = y0; yy < y1; ++yy) {
+                const float wy = std::min((float)yy + 1.f, fy1) - std::max((float)yy, fy0);
+                const uint8_t* row = src + (size_t)yy * (size_t)w * 4;
+                for (int xx = x0; xx < x1; ++xx) {
+                    const float wx = std::min((float)xx + 1.f, fx1) - std::max((float)xx, fx0);
+                    const uint8_t* p = row + (size_t)xx * 4;
+                    const float wa = wx * wy * (float)p[3];
+                    r += wa * (float)p[0];
+                    g += wa * (float)p[1];
+                    b += wa * (float)p[2];
+                    a += wa;
+                    area += wx * wy;
+                }
+            }
+            uint8_t* o = dst + ((size_t)y * (size_t)dw + (size_t)x) * 4;
+            if (a > 0.f) {
+                o[0] = (uint8_t)(r / a + 0.5f);
+                o[1] = (uint8_t)(g / a + 0.5f);
+                o[2] = (uint8_t)(b / a + 0.5f);
+            } else {
+                o[0] = o[1] = o[2] = 0;
+            }
+            o[3] = (uint8_t)std::min(255.f, a / area + 0.5f);
+        }
+    }
+}
+
+}
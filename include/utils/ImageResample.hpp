@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+namespace uilo {
+
+// Area-average (box) resample of a w x h RGBA8 image down to dw x dh, each
+// no larger than the source; fractional footprints are weighted by
+// coverage. Colour is weighted by alpha so transparent texels don't darken
+// the edges they border. Thread-safe, so decode workers use it too.
+void boxDownsampleRgba(const uint8_t* src, int w, int h, uint8_t* dst, int dw, int dh);
+
+}
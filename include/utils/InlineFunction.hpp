@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace uilo {
+
+// std::function look-alike that keeps callables of up to Capacity bytes in
+// an inline buffer, so wrapping a lambda with a few captures never touches
+// the heap. Larger (or throwing-move) callables are boxed on the heap as a
+// fallback. Copyable like std::function; a copy copies the callable.
+template <class Sig, std::size_t Capacity = 48>
+class InlineFunction;
+
+template <class R, class... Args, std::size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    InlineFunction() noexcept {}
+    InlineFunction(std::nullptr_t) noexcept {}
+
+    template <class F,
+              class D = std::decay_t<F>,
+              class = std::enable_if_t<!std::is_same_v<D, InlineFunction>
+                                       && std::is_invocable_r_v<R, D&, Args...>>>
+    InlineFunction(F&& f) {
+        if constexpr (fitsInline<D>()) {
+            ::new (static_cast<void*>(m_buf)) D(std::forward<F>(f));
+            m_ops = &kInlineOps<D>;
+        } else {
+            ::new (static_cast<void*>(m_buf)) D*(new D(std::forward<F>(f)));
+            m_ops = &kBoxedOps<D>;
+        }
+    }
+
+    InlineFunction(const InlineFunction& o) {
+        if (o.m_ops) { o.m_ops->copy(m_buf, o.m_buf); m_ops = o.m_ops; }
+    }
+    InlineFunction(InlineFunction&& o) noexcept {
+        if (o.m_ops) { o.m_ops->move(m_buf, o.m_buf); m_ops = o.m_ops; o.m_ops = nullptr; }
+    }
+    InlineFunction& operator=(const InlineFunction& o) {
+        if (this != &o) { InlineFunction tmp(o); *this = std::move(tmp); }
+        return *this;
+    }
+    InlineFunction& operator=(InlineFunction&& o) noexcept {
+        if (this != &o) {
+            reset();
+            if (o.m_ops) { o.m_ops->move(m_buf, o.m_buf); m_ops = o.m_ops; o.m_ops = nullptr; }
+        }
+        return *this;
+    }
+    InlineFunction& operator=(std::nullptr_t) noexcept { reset(); return *this; }
+    ~InlineFunction() { reset(); }
+
+    explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+    // Like std::function, callable through a const reference even when the
+    // target is a mutable lambda.
+    R operator()(Args... args) const {
+        return m_ops->invoke(m_buf, std::forward<Args>(args)...);
+    }
+
+private:
+    struct Ops {
+        R    (*invoke)(void*, Args&&...);
+        void (*copy)(void* dst, const void* src);
+        void (*move)(void* dst, void* src) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template <class D>
+    static constexpr bool fitsInline() {
+        return sizeof(D) <= Capacity && alignof(D) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<D>;
+    }
+
+    template <class D>
+    static constexpr Ops kInlineOps = {
+        [](void* p, Args&&... a) -> R { return (*static_cast<D*>(p))(std::forward<Args>(a)...); },
+        [](void* dst, const void* src) { ::new (dst) D(*static_cast<const D*>(src)); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) D(std::move(*static_cast<D*>(src)));
+            static_cast<D*>(src)->~D();
+        },
+        [](void* p) noexcept { static_cast<D*>(p)->~D(); },
+    };
+
+    template <class D>
+    static constexpr Ops kBoxedOps = {
+        [](void* p, Args&&... a) -> R { return (**static_cast<D**>(p))(std::forward<Args>(a)...); },
+        [](void* dst, const void* src) { ::new (dst) D*(new D(**static_cast<D* const*>(src))); },
+        [](void* dst, void* src) noexcept { ::new (dst) D*(*static_cast<D**>(src)); },
+        [](void* p) noexcept { delete *static_cast<D**>(p); },
+    };
+
+    void reset() noexcept {
+        if (m_ops) { m_ops->destroy(m_buf); m_ops = nullptr; }
+    }
+
+    alignas(std::max_align_t) mutable unsigned char m_buf[Capacity];
+    const Ops* m_ops = nullptr;
+};
+
+} // namespace uilo
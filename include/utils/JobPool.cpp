@@ -0,0 +1,98 @@
+#include "JobPool.hpp"
+#include "Trace.hpp"
+
+namespace uilo {
+
+namespace {
+thread_local bool        t_inJob    = false;
+thread_local FrameArena* t_jobArena = nullptr;
+}
+
+JobPool::JobPool(unsigned workers)
+    : m_shares(std::make_unique<Share[]>(workers + 1))
+{
+    m_workers.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i) m_workers.push_back(std::make_unique<Worker>());
+    for (unsigned i = 0; i < workers; ++i)
+        m_workers[i]->thread = std::thread([this, i] { workerLoop(i); });
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& w : m_workers) w->thread.join();
+}
+
+bool JobPool::inJob() { return t_inJob; }
+FrameArena* JobPool::jobArena() { return t_jobArena; }
+
+void JobPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+    if (t_inJob || m_workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    // Contiguous shares, caller last.
+    const unsigned parts = (unsigned)m_workers.size() + 1;
+    for (unsigned p = 0; p < parts; ++p) {
+        m_shares[p].next.store(count * p / parts, std::memory_order_relaxed);
+        m_shares[p].end = count * (p + 1) / parts;
+    }
+    m_fn = &fn;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_busy = (unsigned)m_workers.size();
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    t_inJob = true;
+    runShares(parts - 1, nullptr);
+    t_inJob = false;
+
+    // Every index is claimed once the caller's loop ends; wait for the
+    // workers to finish theirs and park again before fn goes away.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_fn = nullptr;
+}
+
+void JobPool::runShares(unsigned self, FrameArena* arena) {
+    const unsigned parts = (unsigned)m_workers.size() + 1;
+    for (unsigned k = 0; k < parts; ++k) {
+        Share& s = m_shares[(self + k) % parts];
+        for (;;) {
+            const size_t i = s.next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= s.end) break;
+            if (arena) arena->reset();
+            (*m_fn)(i);
+        }
+    }
+}
+
+void JobPool::workerLoop(unsigned index) {
+    Trace::setThreadName("JobPool worker");
+    Worker& w = *m_workers[index];
+    t_inJob    = true;
+    t_jobArena = &w.arena;
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+        runShares(index, &w.arena);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busy == 0) m_done.notify_one();
+        }
+    }
+}
+
+} // namespace uilo
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "FrameArena.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace uilo {
+
+/*
+    JobPool — a small fork/join pool for splitting one frame's work across
+    cores. parallelFor() hands each participant (every worker plus the
+    calling thread) a contiguous share of the indices; whoever finishes
+    early steals from the others' shares, so uneven jobs still balance.
+
+    Each worker has its own FrameArena, reset before every job; Element
+    code reaches it through Element::getFrameArena(). Jobs must not
+    outlive the parallelFor() call that started them. A parallelFor()
+    issued from inside a job runs inline on that thread.
+*/
+class JobPool {
+public:
+    explicit JobPool(unsigned workers);
+    ~JobPool();
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    unsigned getWorkerCount() const { return (unsigned)m_workers.size(); }
+
+    // Runs fn(i) for every i in [0, count) and returns once all are done.
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    // True on a thread currently running a job (including the caller while
+    // it helps out inside parallelFor()).
+    static bool inJob();
+    // The running worker's arena, or nullptr outside a worker thread.
+    static FrameArena* jobArena();
+
+private:
+    struct Share {
+        std::atomic<size_t> next{0};
+        size_t              end = 0;
+    };
+    struct Worker {
+        std::thread thread;
+        FrameArena  arena{16 * 1024};
+    };
+
+    void workerLoop(unsigned index);
+    void runShares(unsigned self, FrameArena* arena);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::unique_ptr<Share[]>             m_shares;     // workers + caller
+
+    std::mutex              m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    uint64_t                m_generation = 0;
+    bool                    m_stop       = false;
+    unsigned                m_busy       = 0;          // workers still in the batch
+
+    const std::function<void(size_t)>* m_fn = nullptr;
+};
+
+} // namespace uilo
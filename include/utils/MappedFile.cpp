@@ -0,0 +1,125 @@
+#include "MappedFile.hpp"
+
+#include <cstdio>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <string>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace uilo {
+
+namespace {
+
+// Returns the mapping's base, or nullptr (with size left 0) to fall back.
+const uint8_t* mapWhole(const char* path, std::size_t& size) {
+    size = 0;
+#if defined(_WIN32)
+    const int wlen = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+    if (wlen <= 0) return nullptr;
+    std::wstring wpath((size_t)wlen, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath.data(), wlen);
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER len{};
+    if (!GetFileSizeEx(file, &len) || len.QuadPart <= 0 ||
+        (unsigned long long)len.QuadPart > (unsigned long long)SIZE_MAX) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);   // the mapping keeps the file open
+    if (!mapping) return nullptr;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // and the view keeps the mapping
+    if (!view) return nullptr;
+    size = (std::size_t)len.QuadPart;
+    return static_cast<const uint8_t*>(view);
+#else
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    void* view = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);         // the mapping keeps the file referenced
+    if (view == MAP_FAILED) return nullptr;
+    size = (std::size_t)st.st_size;
+    return static_cast<const uint8_t*>(view);
+#endif
+}
+
+void unmapWhole(const uint8_t* data, std::size_t size) {
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    ::munmap(const_cast<uint8_t*>(data), size);
+#endif
+}
+
+bool readWhole(const char* path, std::vector<uint8_t>& out) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    std::fseek(f, 0, SEEK_END);
+    long sz = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    if (sz <= 0) { std::fclose(f); return false; }
+    out.resize((size_t)sz);
+    size_t got = std::fread(out.data(), 1, (size_t)sz, f);
+    std::fclose(f);
+    return got == (size_t)sz;
+}
+
+} // namespace
+
+MappedFile& MappedFile::operator=(MappedFile&& o) noexcept {
+    if (this == &o) return *this;
+    close();
+    m_data   = std::exchange(o.m_data, nullptr);
+    m_size   = std::exchange(o.m_size, 0);
+    m_mapped = std::exchange(o.m_mapped, false);
+    m_heap   = std::move(o.m_heap);   // the buffer, and so m_data, stays put
+    return *this;
+}
+
+bool MappedFile::open(const char* path) {
+    close();
+    if (const uint8_t* view = mapWhole(path, m_size)) {
+        m_data   = view;
+        m_mapped = true;
+        return true;
+    }
+    if (!readWhole(path, m_heap)) {
+        m_heap = {};
+        return false;
+    }
+    m_data = m_heap.data();
+    m_size = m_heap.size();
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_mapped && m_data) unmapWhole(m_data, m_size);
+    m_data   = nullptr;
+    m_size   = 0;
+    m_mapped = false;
+    m_heap   = {};
+}
+
+}
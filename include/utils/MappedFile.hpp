@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace uilo {
+
+// Read-only view of a whole file, memory-mapped where the platform allows
+// (POSIX mmap, Win32 file mapping) so its pages come from the page cache
+// on demand and are never copied onto the heap. Anything that can't be
+// mapped (a pipe, an exotic filesystem) is read into a heap buffer
+// instead; isMapped() says which. Empty files fail to open. Move-only;
+// the view stays valid until close() or destruction.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(MappedFile&& o) noexcept { *this = static_cast<MappedFile&&>(o); }
+    MappedFile& operator=(MappedFile&& o) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // `path` is UTF-8. Closes whatever was open first.
+    bool open(const char* path);
+    void close();
+
+    bool           valid()    const { return m_data != nullptr; }
+    bool           isMapped() const { return m_mapped; }
+    const uint8_t* data()     const { return m_data; }
+    std::size_t    size()     const { return m_size; }
+
+private:
+    const uint8_t*       m_data   = nullptr;
+    std::size_t          m_size   = 0;
+    bool                 m_mapped = false;
+    std::vector<uint8_t> m_heap;   // fallback copy when mapping fails
+};
+
+}
@@ -87,8 +87,10 @@ struct Material {
     // Animation tempo (cycles/sec-ish) and amplitude for *animated* kinds.
     float animSpeed     = 1.0f;
     float animStrength  = 1.0f;
-    // Extra blur radius (in pixels) applied on top of the global blur
-    // ladder. Only consumed by the Blur kind.
+    // Extra blur radius (in pixels) on top of the shared backdrop blur;
+    // the renderer runs a dual-Kawase ladder deep enough for the largest
+    // one on screen (see Renderer::setBlurLevels). Only consumed by the
+    // Blur kind.
     float blurRadius    = 8.f;
 
     // ---------------- fluent setters ---------------------------------------
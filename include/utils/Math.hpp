@@ -66,6 +66,11 @@ struct Rectf {
         return p.x >= position.x && p.x < position.x + size.x &&
                p.y >= position.y && p.y < position.y + size.y;
     }
+    // True when the two rects share a non-empty area.
+    constexpr bool intersects(const Rectf& o) const {
+        return position.x < o.right() && o.position.x < right() &&
+               position.y < o.bottom() && o.position.y < bottom();
+    }
 
     constexpr bool operator==(const Rectf& o) const {
         return position == o.position && size == o.size;
@@ -73,4 +78,43 @@ struct Rectf {
     constexpr bool operator!=(const Rectf& o) const { return !(*this == o); }
 };
 
+// 2D affine transform: x' = a*x + c*y + tx, y' = b*x + d*y + ty (the same
+// layout as SVG / canvas matrix(a, b, c, d, e, f)).
+struct Transform2D {
+    float a = 1.f, b = 0.f, c = 0.f, d = 1.f, tx = 0.f, ty = 0.f;
+
+    static constexpr Transform2D translate(float x, float y) { return {1.f, 0.f, 0.f, 1.f, x, y}; }
+    static constexpr Transform2D scale(float sx, float sy)   { return {sx, 0.f, 0.f, sy, 0.f, 0.f}; }
+    // Degrees, same convention as Renderer::setRotation (0 = +x, 90 = +y).
+    static Transform2D rotate(float degrees) {
+        const float rad = degrees * (3.14159265f / 180.f);
+        const float cs = std::cos(rad), sn = std::sin(rad);
+        return {cs, sn, -sn, cs, 0.f, 0.f};
+    }
+    static Transform2D rotate(float degrees, Vec2f pivot) {
+        return translate(pivot.x, pivot.y) * rotate(degrees) * translate(-pivot.x, -pivot.y);
+    }
+
+    // (A * B).apply(p) == A.apply(B.apply(p)): B runs first.
+    constexpr Transform2D operator*(const Transform2D& o) const {
+        return {a * o.a + c * o.b,         b * o.a + d * o.b,
+                a * o.c + c * o.d,         b * o.c + d * o.d,
+                a * o.tx + c * o.ty + tx,  b * o.tx + d * o.ty + ty};
+    }
+    constexpr Vec2f apply(Vec2f p) const {
+        return {a * p.x + c * p.y + tx, b * p.x + d * p.y + ty};
+    }
+
+    constexpr bool isIdentity() const {
+        return a == 1.f && b == 0.f && c == 0.f && d == 1.f && tx == 0.f && ty == 0.f;
+    }
+    // Translate + scale only, so rects stay axis-aligned rects.
+    constexpr bool isAxisAligned() const { return b == 0.f && c == 0.f; }
+
+    constexpr bool operator==(const Transform2D& o) const {
+        return a == o.a && b == o.b && c == o.c && d == o.d && tx == o.tx && ty == o.ty;
+    }
+    constexpr bool operator!=(const Transform2D& o) const { return !(*this == o); }
+};
+
 } // namespace uilo
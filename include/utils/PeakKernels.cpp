@@ -0,0 +1,213 @@
+#include "PeakKernels.hpp"
+
+#include <algorithm>
+
+// SSE2 is only baseline on 64-bit x86; 32-bit builds take the scalar path.
+#if defined(__x86_64__) || defined(_M_X64)
+    #define UILO_PEAKS_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define UILO_TARGET_AVX2
+    #else
+        #define UILO_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define UILO_PEAKS_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace uilo {
+
+namespace {
+
+// std::min(mn, v) keeps mn when v is NaN; the vector kernels below put
+// the accumulator second for the same effect.
+void scalarMinMax(const float* src, std::size_t n, float& mn, float& mx) {
+    for (std::size_t i = 0; i < n; ++i) {
+        mn = std::min(mn, src[i]);
+        mx = std::max(mx, src[i]);
+    }
+}
+
+void scalarSumMinMax(const float* const* channels, std::size_t numChannels,
+                     std::size_t first, std::size_t n, float& mn, float& mx) {
+    const float div = (float)numChannels;
+    for (std::size_t s = first; s < first + n; ++s) {
+        float sum = 0.f;
+        for (std::size_t c = 0; c < numChannels; ++c)
+            sum += channels[c][s];
+        sum /= div;
+        mn = std::min(mn, sum);
+        mx = std::max(mx, sum);
+    }
+}
+
+#if UILO_PEAKS_X86
+
+void sse2MinMax(const float* src, std::size_t n, float& mn, float& mx) {
+    std::size_t i = 0;
+    if (n >= 4) {
+        __m128 vmn = _mm_set1_ps(mn), vmx = _mm_set1_ps(mx);
+        for (; i + 4 <= n; i += 4) {
+            const __m128 v = _mm_loadu_ps(src + i);
+            vmn = _mm_min_ps(v, vmn);
+            vmx = _mm_max_ps(v, vmx);
+        }
+        alignas(16) float lo[4], hi[4];
+        _mm_store_ps(lo, vmn);
+        _mm_store_ps(hi, vmx);
+        for (int k = 0; k < 4; ++k) { mn = std::min(mn, lo[k]); mx = std::max(mx, hi[k]); }
+    }
+    scalarMinMax(src + i, n - i, mn, mx);
+}
+
+void sse2SumMinMax(const float* const* channels, std::size_t numChannels,
+                   std::size_t first, std::size_t n, float& mn, float& mx) {
+    std::size_t i = 0;
+    if (n >= 4) {
+        const __m128 div = _mm_set1_ps((float)numChannels);
+        __m128 vmn = _mm_set1_ps(mn), vmx = _mm_set1_ps(mx);
+        for (; i + 4 <= n; i += 4) {
+            __m128 sum = _mm_setzero_ps();
+            for (std::size_t c = 0; c < numChannels; ++c)
+                sum = _mm_add_ps(sum, _mm_loadu_ps(channels[c] + first + i));
+            sum = _mm_div_ps(sum, div);
+            vmn = _mm_min_ps(sum, vmn);
+            vmx = _mm_max_ps(sum, vmx);
+        }
+        alignas(16) float lo[4], hi[4];
+        _mm_store_ps(lo, vmn);
+        _mm_store_ps(hi, vmx);
+        for (int k = 0; k < 4; ++k) { mn = std::min(mn, lo[k]); mx = std::max(mx, hi[k]); }
+    }
+    scalarSumMinMax(channels, numChannels, first + i, n - i, mn, mx);
+}
+
+UILO_TARGET_AVX2
+void avx2MinMax(const float* src, std::size_t n, float& mn, float& mx) {
+    std::size_t i = 0;
+    if (n >= 16) {
+        // Two accumulators per bound hide the min/max latency.
+        __m256 mn0 = _mm256_set1_ps(mn), mn1 = mn0;
+        __m256 mx0 = _mm256_set1_ps(mx), mx1 = mx0;
+        for (; i + 16 <= n; i += 16) {
+            const __m256 a = _mm256_loadu_ps(src + i);
+            const __m256 b = _mm256_loadu_ps(src + i + 8);
+            mn0 = _mm256_min_ps(a, mn0); mx0 = _mm256_max_ps(a, mx0);
+            mn1 = _mm256_min_ps(b, mn1); mx1 = _mm256_max_ps(b, mx1);
+        }
+        alignas(32) float lo[8], hi[8];
+        _mm256_store_ps(lo, _mm256_min_ps(mn0, mn1));
+        _mm256_store_ps(hi, _mm256_max_ps(mx0, mx1));
+        for (int k = 0; k < 8; ++k) { mn = std::min(mn, lo[k]); mx = std::max(mx, hi[k]); }
+    }
+    sse2MinMax(src + i, n - i, mn, mx);
+}
+
+UILO_TARGET_AVX2
+void avx2SumMinMax(const float* const* channels, std::size_t numChannels,
+                   std::size_t first, std::size_t n, float& mn, float& mx) {
+    std::size_t i = 0;
+    if (n >= 8) {
+        const __m256 div = _mm256_set1_ps((float)numChannels);
+        __m256 vmn = _mm256_set1_ps(mn), vmx = _mm256_set1_ps(mx);
+        for (; i + 8 <= n; i += 8) {
+            __m256 sum = _mm256_setzero_ps();
+            for (std::size_t c = 0; c < numChannels; ++c)
+                sum = _mm256_add_ps(sum, _mm256_loadu_ps(channels[c] + first + i));
+            sum = _mm256_div_ps(sum, div);
+            vmn = _mm256_min_ps(sum, vmn);
+            vmx = _mm256_max_ps(sum, vmx);
+        }
+        alignas(32) float lo[8], hi[8];
+        _mm256_store_ps(lo, vmn);
+        _mm256_store_ps(hi, vmx);
+        for (int k = 0; k < 8; ++k) { mn = std::min(mn, lo[k]); mx = std::max(mx, hi[k]); }
+    }
+    sse2SumMinMax(channels, numChannels, first + i, n - i, mn, mx);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx     = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // UILO_PEAKS_X86
+
+#if UILO_PEAKS_NEON
+
+// vminnmq / vmaxnmq return the number when one side is NaN.
+void neonMinMax(const float* src, std::size_t n, float& mn, float& mx) {
+    std::size_t i = 0;
+    if (n >= 8) {
+        float32x4_t mn0 = vdupq_n_f32(mn), mn1 = mn0;
+        float32x4_t mx0 = vdupq_n_f32(mx), mx1 = mx0;
+        for (; i + 8 <= n; i += 8) {
+            const float32x4_t a = vld1q_f32(src + i);
+            const float32x4_t b = vld1q_f32(src + i + 4);
+            mn0 = vminnmq_f32(a, mn0); mx0 = vmaxnmq_f32(a, mx0);
+            mn1 = vminnmq_f32(b, mn1); mx1 = vmaxnmq_f32(b, mx1);
+        }
+        mn = std::min(mn, vminnmvq_f32(vminnmq_f32(mn0, mn1)));
+        mx = std::max(mx, vmaxnmvq_f32(vmaxnmq_f32(mx0, mx1)));
+    }
+    scalarMinMax(src + i, n - i, mn, mx);
+}
+
+void neonSumMinMax(const float* const* channels, std::size_t numChannels,
+                   std::size_t first, std::size_t n, float& mn, float& mx) {
+    std::size_t i = 0;
+    if (n >= 4) {
+        const float32x4_t div = vdupq_n_f32((float)numChannels);
+        float32x4_t vmn = vdupq_n_f32(mn), vmx = vdupq_n_f32(mx);
+        for (; i + 4 <= n; i += 4) {
+            float32x4_t sum = vdupq_n_f32(0.f);
+            for (std::size_t c = 0; c < numChannels; ++c)
+                sum = vaddq_f32(sum, vld1q_f32(channels[c] + first + i));
+            sum = vdivq_f32(sum, div);
+            vmn = vminnmq_f32(sum, vmn);
+            vmx = vmaxnmq_f32(sum, vmx);
+        }
+        mn = std::min(mn, vminnmvq_f32(vmn));
+        mx = std::max(mx, vmaxnmvq_f32(vmx));
+    }
+    scalarSumMinMax(channels, numChannels, first + i, n - i, mn, mx);
+}
+
+#endif // UILO_PEAKS_NEON
+
+const PeakKernels kScalar = {"scalar", scalarMinMax, scalarSumMinMax};
+
+const PeakKernels& selectKernels() {
+#if UILO_PEAKS_X86
+    static const PeakKernels kSse2 = {"sse2", sse2MinMax, sse2SumMinMax};
+    static const PeakKernels kAvx2 = {"avx2", avx2MinMax, avx2SumMinMax};
+    return cpuHasAvx2() ? kAvx2 : kSse2;
+#elif UILO_PEAKS_NEON
+    static const PeakKernels kNeon = {"neon", neonMinMax, neonSumMinMax};
+    return kNeon;
+#else
+    return kScalar;
+#endif
+}
+
+} // namespace
+
+const PeakKernels& getPeakKernels() {
+    static const PeakKernels& k = selectKernels();
+    return k;
+}
+
+const PeakKernels& getScalarPeakKernels() { return kScalar; }
+
+}
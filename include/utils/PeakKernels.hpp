@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+namespace uilo {
+
+/*
+    PeakKernels — min/max reductions over float sample buffers, used by
+    Waveform to build its peak pyramid and column peaks.
+
+    Every kernel folds into (mn, mx) rather than overwriting them, so a
+    caller can reduce a range in several pieces. Results are bit-identical
+    across implementations: the mono path adds channels in the same order
+    and divides the same way as the scalar loop, and NaN samples are
+    ignored everywhere.
+
+    getPeakKernels() picks the widest implementation the CPU supports
+    (AVX2 or SSE2 on x86, NEON on ARM64) once, on first use.
+*/
+struct PeakKernels {
+    const char* name;
+
+    // min / max of src[0, n).
+    void (*minMax)(const float* src, std::size_t n, float& mn, float& mx);
+
+    // min / max over frames [first, first + n) of the per-frame average of
+    // `numChannels` planar channels.
+    void (*sumMinMax)(const float* const* channels, std::size_t numChannels,
+                      std::size_t first, std::size_t n, float& mn, float& mx);
+};
+
+const PeakKernels& getPeakKernels();
+const PeakKernels& getScalarPeakKernels();
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// Per-element profiler. Built only with UILO_PROFILER=1 (the CMake option
+// of the same name); otherwise none of this, nor the fields and calls it
+// adds to Element, UILO and Renderer, exists.
+#ifndef UILO_PROFILER
+#define UILO_PROFILER 0
+#endif
+
+#if UILO_PROFILER
+
+#include <chrono>
+#include <cstdint>
+
+namespace uilo {
+
+// What one element's subtree cost. tick() and paint() are timed around the
+// whole call, so a container's figures include its children's; draws and
+// vertices are the bgfx submits issued and vertices queued (an instanced
+// shape counts its four corners) while it painted. The accumulators count
+// the frame in `frame`; roll() folds them into the last-frame counts and
+// the smoothed times the overlay ranks by.
+struct ElementProfile {
+    static constexpr float kSmoothing = 0.1f;
+
+    uint32_t frame    = 0;
+    uint64_t updateNs = 0;
+    uint64_t renderNs = 0;
+    uint32_t draws    = 0;
+    uint32_t vertices = 0;
+
+    uint32_t lastFrame    = 0;     // frame the last* counts belong to
+    uint32_t lastDraws    = 0;
+    uint32_t lastVertices = 0;
+    float    avgUpdateMs  = 0.f;
+    float    avgRenderMs  = 0.f;
+
+    void roll(uint32_t newFrame) {
+        if (frame != 0) {
+            avgUpdateMs += ((float)updateNs * 1e-6f - avgUpdateMs) * kSmoothing;
+            avgRenderMs += ((float)renderNs * 1e-6f - avgRenderMs) * kSmoothing;
+            lastFrame    = frame;
+            lastDraws    = draws;
+            lastVertices = vertices;
+        }
+        frame    = newFrame;
+        updateNs = renderNs = 0;
+        draws    = vertices = 0;
+    }
+};
+
+inline uint64_t profilerNowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace uilo
+
+#endif // UILO_PROFILER
@@ -0,0 +1,176 @@
+#include "Quadtree.hpp"
+
+#include <algorithm>
+
+namespace uilo {
+
+namespace {
+
+constexpr float kInitialRootSize = 1024.f;
+
+bool encloses(const Rectf& outer, const Rectf& r) {
+    return r.left() >= outer.left() && r.right() <= outer.right() &&
+           r.top() >= outer.top()   && r.bottom() <= outer.bottom();
+}
+
+Rectf quadrant(const Rectf& b, int q) {
+    const Vec2f half{ b.size.x * 0.5f, b.size.y * 0.5f };
+    return { { b.position.x + ((q & 1) ? half.x : 0.f),
+               b.position.y + ((q & 2) ? half.y : 0.f) }, half };
+}
+
+} // namespace
+
+void Quadtree::clear() {
+    m_nodes.clear();
+    m_items.clear();
+}
+
+void Quadtree::insert(uint32_t id, const Rectf& rect) {
+    if (id >= m_items.size()) m_items.resize((size_t)id + 1);
+    if (m_items[id].node >= 0) unlink(id);
+    m_items[id].rect = rect;
+    growToFit(rect);
+    place(id);
+}
+
+void Quadtree::move(uint32_t id, const Rectf& rect) {
+    if (id < m_items.size() && m_items[id].node >= 0) {
+        Item& it = m_items[id];
+        // Still enclosed by its node and by none of that node's children:
+        // it stays put, only the rect changes.
+        const Node& n = m_nodes[(size_t)it.node];
+        const bool deeper = n.firstChild >= 0 &&
+            std::any_of(&m_nodes[(size_t)n.firstChild], &m_nodes[(size_t)n.firstChild] + 4,
+                        [&](const Node& c) { return encloses(c.bounds, rect); });
+        if (encloses(n.bounds, rect) && !deeper) {
+            it.rect = rect;
+            return;
+        }
+    }
+    insert(id, rect);
+}
+
+void Quadtree::remove(uint32_t id) {
+    if (id < m_items.size() && m_items[id].node >= 0) unlink(id);
+}
+
+void Quadtree::unlink(uint32_t id) {
+    auto& items = m_nodes[(size_t)m_items[id].node].items;
+    auto found = std::find(items.begin(), items.end(), id);
+    if (found != items.end()) {
+        *found = items.back();
+        items.pop_back();
+    }
+    m_items[id].node = -1;
+}
+
+void Quadtree::growToFit(const Rectf& rect) {
+    if (m_nodes.empty()) {
+        const float s = std::max({ kInitialRootSize, rect.size.x, rect.size.y });
+        Node root;
+        root.bounds = { rect.position, { s, s } };
+        m_nodes.push_back(std::move(root));
+        return;
+    }
+    // Bounded, so a non-finite rect settles in the root instead of looping.
+    for (int grown = 0; grown < 64 && !encloses(m_nodes[0].bounds, rect); ++grown) {
+        // Double toward the rect; the old root becomes one quadrant.
+        const Rectf b = m_nodes[0].bounds;
+        const bool left = rect.left() < b.left();
+        const bool up   = rect.top()  < b.top();
+        Rectf nb{ { left ? b.position.x - b.size.x : b.position.x,
+                    up   ? b.position.y - b.size.y : b.position.y },
+                  { b.size.x * 2.f, b.size.y * 2.f } };
+        const int oldQ = (left ? 1 : 0) + (up ? 2 : 0);
+
+        const int32_t first = (int32_t)m_nodes.size();
+        m_nodes.resize(m_nodes.size() + 4);
+        for (int q = 0; q < 4; ++q) m_nodes[(size_t)first + q].bounds = quadrant(nb, q);
+        const int32_t oldAt = first + oldQ;
+        m_nodes[(size_t)oldAt].firstChild = m_nodes[0].firstChild;
+        m_nodes[(size_t)oldAt].items      = std::move(m_nodes[0].items);
+        for (uint32_t id : m_nodes[(size_t)oldAt].items) m_items[id].node = oldAt;
+
+        m_nodes[0].bounds     = nb;
+        m_nodes[0].firstChild = first;
+        m_nodes[0].items.clear();
+    }
+}
+
+void Quadtree::place(uint32_t id) {
+    const Rectf& r = m_items[id].rect;
+    int32_t at = 0;
+    for (int depth = 0;; ++depth) {
+        Node& n = m_nodes[(size_t)at];
+        if (n.firstChild < 0) {
+            n.items.push_back(id);
+            m_items[id].node = at;
+            if (n.items.size() > kLeafItems && depth < kMaxDepth) split(at);
+            return;
+        }
+        int32_t next = -1;
+        for (int q = 0; q < 4 && next < 0; ++q)
+            if (encloses(m_nodes[(size_t)n.firstChild + q].bounds, r)) next = n.firstChild + q;
+        if (next < 0) {
+            n.items.push_back(id);
+            m_items[id].node = at;
+            return;
+        }
+        at = next;
+    }
+}
+
+void Quadtree::split(int32_t node) {
+    const int32_t first = (int32_t)m_nodes.size();
+    m_nodes.resize(m_nodes.size() + 4);   // invalidates references into m_nodes
+    Node& n = m_nodes[(size_t)node];
+    n.firstChild = first;
+    for (int q = 0; q < 4; ++q) m_nodes[(size_t)first + q].bounds = quadrant(n.bounds, q);
+
+    std::vector<uint32_t> keep;
+    for (uint32_t id : n.items) {
+        int32_t to = -1;
+        for (int q = 0; q < 4 && to < 0; ++q)
+            if (encloses(m_nodes[(size_t)first + q].bounds, m_items[id].rect)) to = first + q;
+        if (to < 0) { keep.push_back(id); continue; }
+        m_nodes[(size_t)to].items.push_back(id);
+        m_items[id].node = to;
+    }
+    n.items = std::move(keep);
+}
+
+void Quadtree::query(const Rectf& area, std::vector<uint32_t>& out) const {
+    if (m_nodes.empty()) return;
+    std::vector<int32_t> stack{ 0 };
+    while (!stack.empty()) {
+        const Node& n = m_nodes[(size_t)stack.back()];
+        stack.pop_back();
+        for (uint32_t id : n.items)
+            if (m_items[id].rect.intersects(area)) out.push_back(id);
+        if (n.firstChild < 0) continue;
+        for (int q = 0; q < 4; ++q) {
+            const int32_t c = n.firstChild + q;
+            const Node& cn = m_nodes[(size_t)c];
+            if ((cn.firstChild >= 0 || !cn.items.empty()) && cn.bounds.intersects(area))
+                stack.push_back(c);
+        }
+    }
+}
+
+void Quadtree::query(Vec2f point, std::vector<uint32_t>& out) const {
+    if (m_nodes.empty()) return;
+    int32_t at = 0;
+    while (at >= 0) {
+        const Node& n = m_nodes[(size_t)at];
+        for (uint32_t id : n.items)
+            if (m_items[id].rect.contains(point)) out.push_back(id);
+        if (n.firstChild < 0) break;
+        int32_t next = -1;
+        for (int q = 0; q < 4 && next < 0; ++q)
+            if (m_nodes[(size_t)n.firstChild + q].bounds.contains(point)) next = n.firstChild + q;
+        at = next;
+    }
+}
+
+}
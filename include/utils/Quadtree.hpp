@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Math.hpp"
+
+namespace uilo {
+
+// Quadtree over axis-aligned rects with dense ids (0 .. n-1, e.g. a child's
+// index). Each rect lives in the deepest node that wholly contains it, so a
+// rect straddling a split line stays at the parent. The root grows by
+// doubling toward whatever falls outside it, so the space is unbounded.
+// query() returns ids in no particular order; an id appears once.
+class Quadtree {
+public:
+    static constexpr uint32_t kLeafItems = 16;   // a leaf splits past this
+    static constexpr int      kMaxDepth  = 12;
+
+    void clear();
+    // Inserting an id already present moves it.
+    void insert(uint32_t id, const Rectf& rect);
+    void move(uint32_t id, const Rectf& rect);
+    void remove(uint32_t id);
+    bool contains(uint32_t id) const { return id < m_items.size() && m_items[id].node >= 0; }
+    const Rectf& rectOf(uint32_t id) const { return m_items[id].rect; }
+
+    // Appends the ids whose rect shares area with `area` (Rectf::intersects)
+    // or holds `point` (Rectf::contains).
+    void query(const Rectf& area, std::vector<uint32_t>& out) const;
+    void query(Vec2f point, std::vector<uint32_t>& out) const;
+
+private:
+    struct Node {
+        Rectf                 bounds;
+        int32_t               firstChild = -1;     // four consecutive nodes, or -1
+        std::vector<uint32_t> items;
+    };
+    struct Item {
+        Rectf   rect;
+        int32_t node = -1;                         // -1 = not in the tree
+    };
+
+    void growToFit(const Rectf& rect);
+    void place(uint32_t id);
+    void split(int32_t node);
+    void unlink(uint32_t id);
+
+    std::vector<Node> m_nodes;                     // [0] is the root
+    std::vector<Item> m_items;
+};
+
+}
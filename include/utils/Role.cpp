@@ -0,0 +1,58 @@
+#include "Role.hpp"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace uilo {
+
+namespace {
+
+// Never destroyed: statics holding roles may outlive it otherwise. A deque
+// keeps every interned name at a stable address.
+struct RoleTable {
+    std::mutex                                        mutex;
+    std::deque<std::string>                           names { std::string() };
+    std::unordered_map<std::string_view, uint32_t>    ids   { { names.front(), 0u } };
+};
+
+RoleTable& table() {
+    static RoleTable* t = new RoleTable;
+    return *t;
+}
+
+} // namespace
+
+const std::string& Role::emptyName() { return table().names.front(); }
+
+Role::Role(std::string_view name) {
+    if (name.empty()) return;
+    RoleTable& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    auto it = t.ids.find(name);
+    if (it == t.ids.end()) {
+        t.names.emplace_back(name);
+        it = t.ids.emplace(t.names.back(), static_cast<uint32_t>(t.names.size() - 1)).first;
+    }
+    m_id   = it->second;
+    m_name = &t.names[it->second];
+}
+
+uint32_t Role::count() {
+    RoleTable& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    return static_cast<uint32_t>(t.names.size());
+}
+
+Role Role::fromId(uint32_t id) {
+    RoleTable& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    Role r;
+    if (id < t.names.size()) {
+        r.m_id   = id;
+        r.m_name = &t.names[id];
+    }
+    return r;
+}
+
+} // namespace uilo
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace uilo {
+
+// Interned palette role name. Options setters store roles as Role, so the
+// string is hashed once when the role is assigned and the render path keys
+// Palette's resolved-color cache by id() instead. Equal names share an id
+// for the life of the process; id 0 is the empty role. Converts back to
+// the name implicitly, so it reads like the std::string it replaced.
+class Role {
+public:
+    Role() = default;
+    explicit Role(std::string_view name);
+    Role& operator=(std::string_view name) { return *this = Role(name); }
+
+    uint32_t           id()    const { return m_id; }
+    const std::string& str()   const { return *m_name; }
+    bool               empty() const { return m_id == 0; }
+
+    operator const std::string&() const { return *m_name; }
+    operator std::string_view()   const { return *m_name; }
+
+    bool operator==(const Role& o) const { return m_id == o.m_id; }
+
+    // Roles interned so far (ids are below this), and the role with a
+    // given id; for walking every id, e.g. to fill a per-id cache.
+    static uint32_t count();
+    static Role     fromId(uint32_t id);
+
+private:
+    static const std::string& emptyName();
+
+    uint32_t           m_id   = 0;
+    const std::string* m_name = &emptyName();
+};
+
+} // namespace uilo
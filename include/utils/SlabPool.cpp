@@ -0,0 +1,149 @@
+#include "SlabPool.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace uilo {
+
+namespace {
+
+constexpr std::size_t kClasses = SlabPool::kMaxObject / SlabPool::kGranule;
+
+// Lives at the start of every slab; slabs are kSlabBytes-aligned, so an
+// object's slab is found by masking its address.
+struct Slab {
+    Slab*       prev     = nullptr;   // links within the class's open list
+    Slab*       next     = nullptr;
+    void*       freeList = nullptr;   // intrusive list of released objects
+    std::size_t bump     = 0;         // offset of the next never-used object
+    std::size_t objSize  = 0;
+    std::size_t live     = 0;
+    std::size_t capacity = 0;
+    bool        open     = false;     // on the class's open list
+};
+
+constexpr std::size_t kHeaderBytes =
+    (sizeof(Slab) + SlabPool::kGranule - 1) / SlabPool::kGranule * SlabPool::kGranule;
+
+struct SizeClass {
+    Slab* open  = nullptr;   // slabs with at least one free object
+    Slab* spare = nullptr;   // an empty slab kept back from the heap
+};
+
+struct State {
+    std::mutex  mutex;
+    SizeClass   classes[kClasses];
+    std::size_t slabs       = 0;
+    std::size_t liveObjects = 0;
+};
+
+// Never destroyed: elements owned by a static UILO may be freed after
+// every other static is gone.
+State& state() {
+    static State* s = new State;
+    return *s;
+}
+
+void linkOpen(SizeClass& c, Slab* s) {
+    s->prev = nullptr;
+    s->next = c.open;
+    if (c.open) c.open->prev = s;
+    c.open  = s;
+    s->open = true;
+}
+
+void unlinkOpen(SizeClass& c, Slab* s) {
+    if (s->prev) s->prev->next = s->next;
+    else         c.open        = s->next;
+    if (s->next) s->next->prev = s->prev;
+    s->prev = s->next = nullptr;
+    s->open = false;
+}
+
+Slab* newSlab(State& st, std::size_t objSize) {
+    void* mem = ::operator new(SlabPool::kSlabBytes, std::align_val_t(SlabPool::kSlabBytes));
+    Slab* s = ::new (mem) Slab;
+    s->objSize  = objSize;
+    s->bump     = kHeaderBytes;
+    s->capacity = (SlabPool::kSlabBytes - kHeaderBytes) / objSize;
+    ++st.slabs;
+    return s;
+}
+
+void freeSlab(State& st, Slab* s) {
+    s->~Slab();
+    ::operator delete(static_cast<void*>(s), std::align_val_t(SlabPool::kSlabBytes));
+    --st.slabs;
+}
+
+std::size_t classIndex(std::size_t bytes) {
+    return (bytes + SlabPool::kGranule - 1) / SlabPool::kGranule - 1;
+}
+
+} // namespace
+
+void* SlabPool::allocate(std::size_t bytes) {
+    if (bytes == 0) bytes = 1;
+    if (bytes > kMaxObject) return ::operator new(bytes);
+
+    const std::size_t idx = classIndex(bytes);
+    State& st = state();
+    std::lock_guard<std::mutex> lock(st.mutex);
+    SizeClass& c = st.classes[idx];
+
+    Slab* s = c.open;
+    if (!s) {
+        s = c.spare ? c.spare : newSlab(st, (idx + 1) * kGranule);
+        c.spare = nullptr;
+        linkOpen(c, s);
+    }
+
+    void* p;
+    if (s->freeList) {
+        p = s->freeList;
+        s->freeList = *static_cast<void**>(p);
+    } else {
+        p = reinterpret_cast<std::byte*>(s) + s->bump;
+        s->bump += s->objSize;
+    }
+    ++s->live;
+    ++st.liveObjects;
+    if (s->live == s->capacity) unlinkOpen(c, s);
+    return p;
+}
+
+void SlabPool::deallocate(void* p, std::size_t bytes) noexcept {
+    if (!p) return;
+    if (bytes == 0) bytes = 1;
+    if (bytes > kMaxObject) { ::operator delete(p); return; }
+
+    State& st = state();
+    std::lock_guard<std::mutex> lock(st.mutex);
+    SizeClass& c = st.classes[classIndex(bytes)];
+    Slab* s = reinterpret_cast<Slab*>(
+        reinterpret_cast<std::uintptr_t>(p) & ~(std::uintptr_t)(kSlabBytes - 1));
+
+    *static_cast<void**>(p) = s->freeList;
+    s->freeList = p;
+    --s->live;
+    --st.liveObjects;
+
+    if (s->live == 0) {
+        if (s->open) unlinkOpen(c, s);
+        if (c.spare) { freeSlab(st, s); return; }
+        s->freeList = nullptr;
+        s->bump     = kHeaderBytes;
+        c.spare     = s;
+    } else if (!s->open) {
+        linkOpen(c, s);
+    }
+}
+
+SlabPool::Stats SlabPool::getStats() {
+    State& st = state();
+    std::lock_guard<std::mutex> lock(st.mutex);
+    return {st.slabs, st.liveObjects};
+}
+
+}
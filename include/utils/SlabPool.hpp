@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace uilo {
+
+// Size-classed slab allocator behind Element::operator new/delete, so a
+// page's elements land next to each other in a few 64 KB slabs instead of
+// thousands of scattered heap blocks. Each 64-byte size class keeps its
+// own slabs; a slab whose last object is freed goes straight back to the
+// heap (one spare per class is kept to avoid churn), so tearing down a
+// page returns its memory in whole slabs. Requests above kMaxObject go
+// to the global heap. Thread-safe.
+class SlabPool {
+public:
+    static constexpr std::size_t kGranule   = 64;
+    static constexpr std::size_t kMaxObject = 4096;
+    static constexpr std::size_t kSlabBytes = 64 * 1024;
+
+    static void* allocate(std::size_t bytes);
+    // `bytes` must be the size passed to allocate().
+    static void  deallocate(void* p, std::size_t bytes) noexcept;
+
+    struct Stats {
+        std::size_t slabs       = 0;  // slabs currently held, spares included
+        std::size_t liveObjects = 0;  // slab-backed objects not yet freed
+    };
+    static Stats getStats();
+};
+
+}
@@ -0,0 +1,44 @@
+#include "SpscSampleRing.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace uilo {
+
+SpscSampleRing::SpscSampleRing(std::size_t numChannels, std::size_t capacityFrames)
+    : m_data(numChannels * std::max<std::size_t>(1, capacityFrames), 0.f)
+    , m_channels(numChannels)
+    , m_capacity(std::max<std::size_t>(1, capacityFrames)) {}
+
+std::size_t SpscSampleRing::write(const float* const* channels, std::size_t n) {
+    const std::size_t w = m_write.load(std::memory_order_relaxed);
+    const std::size_t r = m_read.load(std::memory_order_acquire);
+    n = std::min(n, m_capacity - (w - r));
+    if (n == 0 || !channels) return 0;
+
+    const std::size_t at    = w % m_capacity;
+    const std::size_t first = std::min(n, m_capacity - at);
+    for (std::size_t c = 0; c < m_channels; ++c) {
+        float* dst = m_data.data() + c * m_capacity;
+        if (channels[c]) {
+            std::memcpy(dst + at, channels[c],         first * sizeof(float));
+            std::memcpy(dst,      channels[c] + first, (n - first) * sizeof(float));
+        } else {
+            std::memset(dst + at, 0, first * sizeof(float));
+            std::memset(dst,      0, (n - first) * sizeof(float));
+        }
+    }
+    m_write.store(w + n, std::memory_order_release);
+    return n;
+}
+
+std::size_t SpscSampleRing::readable() const {
+    return m_write.load(std::memory_order_acquire) - m_read.load(std::memory_order_relaxed);
+}
+
+void SpscSampleRing::consume(std::size_t n) {
+    const std::size_t r = m_read.load(std::memory_order_relaxed);
+    m_read.store(r + std::min(n, readable()), std::memory_order_release);
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace uilo {
+
+// Fixed-capacity planar float ring for handing audio from one producer
+// thread (typically the audio callback) to one consumer thread (the UI).
+// write() is wait-free and never allocates; frames that don't fit are
+// dropped rather than blocking the producer. The consumer reads the
+// oldest frames in place via channel() / readOffset() and then releases
+// them with consume().
+class SpscSampleRing {
+public:
+    SpscSampleRing(std::size_t numChannels, std::size_t capacityFrames);
+    SpscSampleRing(const SpscSampleRing&) = delete;
+    SpscSampleRing& operator=(const SpscSampleRing&) = delete;
+
+    // Producer. Appends up to n frames from `numChannels` planar buffers
+    // (a null channel writes silence); returns how many were accepted.
+    std::size_t write(const float* const* channels, std::size_t n);
+
+    // Consumer. Frames [readOffset(), readOffset() + readable()) of each
+    // channel, wrapping at getCapacity(), are stable until consume().
+    std::size_t readable() const;
+    std::size_t readOffset() const { return m_read.load(std::memory_order_relaxed) % m_capacity; }
+    const float* channel(std::size_t c) const { return m_data.data() + c * m_capacity; }
+    void consume(std::size_t n);
+
+    std::size_t getNumChannels() const { return m_channels; }
+    std::size_t getCapacity()    const { return m_capacity; }
+
+private:
+    std::vector<float> m_data;      // m_channels * m_capacity, planar
+    std::size_t        m_channels = 0;
+    std::size_t        m_capacity = 0;
+
+    // Monotonic frame counters; each is written by one side only.
+    alignas(64) std::atomic<std::size_t> m_write{0};
+    alignas(64) std::atomic<std::size_t> m_read{0};
+};
+
+}
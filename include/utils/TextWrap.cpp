@@ -0,0 +1,57 @@
+#include "TextWrap.hpp"
+
+namespace uilo {
+
+void wrapText(std::u32string_view text, const float* advances, float maxWidth,
+              bool breakWords, std::vector<std::size_t>& breaks) {
+    breaks.clear();
+    const std::size_t n = text.size();
+    float lineW   = 0.f;    // up to the end of the last word on the line
+    float spaceW  = 0.f;    // spaces since then, not yet committed
+    bool  hasWord = false;  // the line holds at least one word char
+
+    std::size_t i = 0;
+    while (i < n) {
+        const char32_t c = text[i];
+        if (c == U'\n') {
+            lineW = spaceW = 0.f;
+            hasWord = false;
+            ++i;
+            continue;
+        }
+        if (c == U' ') {
+            spaceW += advances[i++];
+            continue;
+        }
+
+        std::size_t end = i;
+        float wordW = 0.f;
+        while (end < n && text[end] != U' ' && text[end] != U'\n') wordW += advances[end++];
+
+        if (hasWord && lineW + spaceW + wordW > maxWidth) {
+            breaks.push_back(i);
+            lineW = spaceW = 0.f;
+            hasWord = false;
+        }
+        // Spaces only count once a word follows them on the same line,
+        // which keeps leading indentation and drops hanging spaces.
+        lineW += spaceW;
+        spaceW = 0.f;
+        if (!breakWords || lineW + wordW <= maxWidth) {
+            lineW  += wordW;
+            hasWord = true;
+        } else {
+            for (std::size_t k = i; k < end; ++k) {
+                if (hasWord && lineW + advances[k] > maxWidth) {
+                    breaks.push_back(k);
+                    lineW = 0.f;
+                }
+                lineW  += advances[k];
+                hasWord = true;
+            }
+        }
+        i = end;
+    }
+}
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace uilo {
+
+// Greedy word wrap in one pass over per-codepoint advances (see
+// Renderer::glyphAdvances); each word is summed once and nothing is
+// re-measured. Lines break after runs of spaces, and those trailing
+// spaces hang past maxWidth instead of forcing a break. '\n' ends a line
+// without being reported. With breakWords a word wider than maxWidth is
+// split between characters; otherwise it overflows on a line of its own.
+//
+// `breaks` receives, in order, the index of the first codepoint of each
+// soft-wrapped line.
+void wrapText(std::u32string_view text, const float* advances, float maxWidth,
+              bool breakWords, std::vector<std::size_t>& breaks);
+
+}
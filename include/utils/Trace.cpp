@@ -0,0 +1,147 @@
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace uilo {
+
+namespace {
+struct TraceEvent {
+    const char* name    = nullptr;
+    uint64_t    beginNs = 0;
+    uint64_t    endNs   = 0;
+};
+
+// Single-producer ring: the owning thread writes events[head % N], then
+// publishes head. A reader copies what it sees and keeps only the indices
+// the writer can't have reached by the time it's done (seqlock-style).
+struct TraceRing {
+    TraceEvent            events[Trace::kRingEvents];
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> floor{0};   // clear(): indices below are dropped
+    const char*           threadName = nullptr;
+    uint32_t              tid        = 0;
+};
+
+std::mutex                              g_ringsMutex;
+std::vector<std::unique_ptr<TraceRing>> g_rings;
+thread_local TraceRing*                 t_ring     = nullptr;
+thread_local const char*                t_pendingName = nullptr;
+
+TraceRing& threadRing() {
+    if (!t_ring) {
+        auto ring = std::make_unique<TraceRing>();
+        std::lock_guard<std::mutex> lock(g_ringsMutex);
+        ring->tid        = (uint32_t)g_rings.size() + 1;
+        ring->threadName = t_pendingName;
+        t_ring = ring.get();
+        g_rings.push_back(std::move(ring));
+    }
+    return *t_ring;
+}
+
+void writeJsonString(std::FILE* f, const char* s) {
+    std::fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) std::fputc(*s, f);
+    }
+    std::fputc('"', f);
+}
+} // anon
+
+uint64_t Trace::nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char* name, uint64_t beginNs, uint64_t endNs) {
+    TraceRing& ring = threadRing();
+    const uint64_t h = ring.head.load(std::memory_order_relaxed);
+    ring.events[h % kRingEvents] = { name, beginNs, endNs };
+    ring.head.store(h + 1, std::memory_order_release);
+}
+
+void Trace::setThreadName(const char* name) {
+    t_pendingName = name;
+    if (t_ring) {
+        std::lock_guard<std::mutex> lock(g_ringsMutex);
+        t_ring->threadName = name;
+    }
+}
+
+void Trace::clear() {
+    std::lock_guard<std::mutex> lock(g_ringsMutex);
+    for (auto& ring : g_rings)
+        ring->floor.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+bool Trace::dumpChromeJson(const std::string& path) {
+    struct Track {
+        uint32_t                tid  = 0;
+        const char*             name = nullptr;
+        std::vector<TraceEvent> events;
+    };
+    std::vector<Track> tracks;
+    {
+        std::lock_guard<std::mutex> lock(g_ringsMutex);
+        for (auto& ring : g_rings) {
+            Track& t = tracks.emplace_back();
+            t.tid  = ring->tid;
+            t.name = ring->threadName;
+            const uint64_t h0    = ring->head.load(std::memory_order_acquire);
+            const uint64_t floor = ring->floor.load(std::memory_order_relaxed);
+            const uint64_t from  = std::max(floor, h0 > kRingEvents ? h0 - kRingEvents : 0);
+            for (uint64_t i = from; i < h0; ++i) t.events.push_back(ring->events[i % kRingEvents]);
+            // The writer may have lapped the oldest copies, and is possibly
+            // mid-write on the slot after h1 - 1.
+            const uint64_t h1   = ring->head.load(std::memory_order_acquire);
+            const uint64_t safe = h1 + 1 > kRingEvents ? h1 + 1 - kRingEvents : 0;
+            if (safe > from)
+                t.events.erase(t.events.begin(),
+                               t.events.begin() + (std::ptrdiff_t)std::min<uint64_t>(safe - from, t.events.size()));
+        }
+    }
+
+    uint64_t baseNs = UINT64_MAX;
+    for (const auto& t : tracks)
+        for (const auto& e : t.events) baseNs = std::min(baseNs, e.beginNs);
+    if (baseNs == UINT64_MAX) baseNs = 0;
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "[UILO] Trace::dumpChromeJson: can't open '%s'\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    auto sep = [&] { if (!first) std::fputs(",\n", f); first = false; };
+    for (const auto& t : tracks) {
+        if (t.name) {
+            sep();
+            std::fprintf(f, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", t.tid);
+            writeJsonString(f, t.name);
+            std::fputs("}}", f);
+        }
+        for (const auto& e : t.events) {
+            sep();
+            std::fputs("{\"ph\":\"X\",\"name\":", f);
+            writeJsonString(f, e.name);
+            std::fprintf(f, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", t.tid,
+                         (double)(e.beginNs - baseNs) * 1e-3, (double)(e.endNs - e.beginNs) * 1e-3);
+        }
+    }
+    std::fputs("\n]}\n", f);
+    const bool ok = std::ferror(f) == 0;
+    if (std::fclose(f) != 0 || !ok) {
+        std::fprintf(stderr, "[UILO] Trace::dumpChromeJson: failed writing '%s'\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace uilo
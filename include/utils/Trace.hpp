@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped trace zones. UILO_TRACE (CMake option, on by default) compiles the
+// zones in; they cost one relaxed load until Trace::setEnabled(true).
+// UILO_TRACY additionally opens a Tracy zone for each.
+#ifndef UILO_TRACE
+#define UILO_TRACE 1
+#endif
+#ifndef UILO_TRACY
+#define UILO_TRACY 0
+#endif
+
+#if UILO_TRACY
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace uilo {
+
+/*
+    Trace — timeline capture for diagnosing hitches. Each thread that
+    closes a zone while tracing is on gets its own ring of the last
+    kRingEvents zones; the owner is the only writer, so recording takes no
+    lock. dumpChromeJson() writes every ring as Chrome trace-event JSON,
+    which chrome://tracing and ui.perfetto.dev both open. Rings are kept
+    for the life of the process, so a thread's zones outlive it. Zone
+    names must be string literals (only the pointer is stored).
+*/
+class Trace {
+public:
+    static constexpr size_t kRingEvents = 1u << 14;
+
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled()              { return s_enabled.load(std::memory_order_relaxed); }
+    // Label for the calling thread's track in the dump; must outlive it.
+    static void setThreadName(const char* name);
+    // Drops every recorded zone.
+    static void clear();
+    // Writes all rings to `path`. Safe while tracing: zones overwritten
+    // mid-copy are left out. False (with a message) when the file can't
+    // be written.
+    static bool dumpChromeJson(const std::string& path);
+
+    static uint64_t nowNs();
+    static void     record(const char* name, uint64_t beginNs, uint64_t endNs);
+
+private:
+    static inline std::atomic<bool> s_enabled{false};
+};
+
+// Records [construction, destruction) on the calling thread's ring when
+// tracing was on at construction.
+class TraceZone {
+public:
+    explicit TraceZone(const char* name)
+        : m_name(Trace::isEnabled() ? name : nullptr),
+          m_beginNs(m_name ? Trace::nowNs() : 0) {}
+    ~TraceZone() { if (m_name) Trace::record(m_name, m_beginNs, Trace::nowNs()); }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t    m_beginNs;
+};
+
+} // namespace uilo
+
+#define UILO_TRACE_CAT2(a, b) a##b
+#define UILO_TRACE_CAT(a, b)  UILO_TRACE_CAT2(a, b)
+
+#if UILO_TRACE && UILO_TRACY
+#define UILO_TRACE_ZONE(name) ZoneScopedN(name); \
+    ::uilo::TraceZone UILO_TRACE_CAT(uiloTraceZone_, __LINE__)(name)
+#elif UILO_TRACE
+#define UILO_TRACE_ZONE(name) ::uilo::TraceZone UILO_TRACE_CAT(uiloTraceZone_, __LINE__)(name)
+#elif UILO_TRACY
+#define UILO_TRACE_ZONE(name) ZoneScopedN(name)
+#else
+#define UILO_TRACE_ZONE(name) ((void)0)
+#endif
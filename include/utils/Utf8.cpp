@@ -0,0 +1,52 @@
+#include "Utf8.hpp"
+
+#include <cstring>
+
+// SSE2 is only baseline on 64-bit x86; 32-bit builds take the word path.
+#if defined(__x86_64__) || defined(_M_X64)
+    #define UILO_UTF8_X86 1
+    #include <emmintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define UILO_UTF8_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace uilo {
+
+size_t asciiPrefixLength(const char* s, size_t n) {
+    size_t i = 0;
+#if UILO_UTF8_X86
+    // movemask gathers the 16 top bits: any set byte ends the run.
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const int mask = _mm_movemask_epi8(v);
+        if (mask != 0) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long bit = 0;
+            _BitScanForward(&bit, (unsigned long)mask);
+            return i + bit;
+#else
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+#endif
+        }
+    }
+#elif UILO_UTF8_NEON
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(s + i));
+        if (vmaxvq_u8(v) >= 0x80u) break;   // the scalar tail finds the byte
+    }
+#endif
+    // Eight bytes at a time elsewhere (and for the tail).
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, s + i, sizeof(w));
+        if (w & 0x8080808080808080ull) break;
+    }
+    while (i < n && static_cast<uint8_t>(s[i]) < 0x80u) ++i;
+    return i;
+}
+
+}
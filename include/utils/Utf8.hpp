@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace uilo {
+
+// Length of the pure-ASCII run at the start of s[0, n): bytes a decoder
+// can take as codepoints one for one. Scans 16 bytes at a time with SSE2 /
+// NEON where available (Utf8.cpp).
+size_t asciiPrefixLength(const char* s, size_t n);
+
+// UTF-8 <-> UTF-32 for text elements that edit or wrap by codepoint.
+// Truncated sequences at the end of the input are dropped.
+inline std::string u32ToUtf8(std::u32string_view s) {
+    std::string r;
+    r.reserve(s.size());
+    for (char32_t c : s) {
+        if (c < 0x80u) {
+            r += static_cast<char>(c);
+        } else if (c < 0x800u) {
+            r += static_cast<char>(0xC0 | (c >> 6));
+            r += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000u) {
+            r += static_cast<char>(0xE0 | (c >> 12));
+            r += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            r += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            r += static_cast<char>(0xF0 | (c >> 18));
+            r += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            r += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            r += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return r;
+}
+
+inline std::u32string utf8ToU32(std::string_view s) {
+    std::u32string r;
+    r.reserve(s.size());
+    size_t i = 0;
+    while (i < s.size()) {
+        const size_t ascii = asciiPrefixLength(s.data() + i, s.size() - i);
+        for (size_t k = 0; k < ascii; ++k)
+            if (s[i + k]) r += static_cast<char32_t>(static_cast<uint8_t>(s[i + k]));
+        i += ascii;
+        if (i >= s.size()) break;
+        uint8_t c = static_cast<uint8_t>(s[i]);
+        char32_t cp = 0;
+        if (c < 0x80u) {
+            cp = c; i += 1;
+        } else if (c < 0xE0u && i + 1 < s.size()) {
+            cp = (static_cast<char32_t>(c & 0x1Fu) << 6) |
+                  static_cast<char32_t>(static_cast<uint8_t>(s[i+1]) & 0x3Fu);
+            i += 2;
+        } else if (c < 0xF0u && i + 2 < s.size()) {
+            cp = (static_cast<char32_t>(c & 0x0Fu) << 12) |
+                 (static_cast<char32_t>(static_cast<uint8_t>(s[i+1]) & 0x3Fu) << 6) |
+                  static_cast<char32_t>(static_cast<uint8_t>(s[i+2]) & 0x3Fu);
+            i += 3;
+        } else if (i + 3 < s.size()) {
+            cp = (static_cast<char32_t>(c & 0x07u) << 18) |
+                 (static_cast<char32_t>(static_cast<uint8_t>(s[i+1]) & 0x3Fu) << 12) |
+                 (static_cast<char32_t>(static_cast<uint8_t>(s[i+2]) & 0x3Fu) << 6) |
+                  static_cast<char32_t>(static_cast<uint8_t>(s[i+3]) & 0x3Fu);
+            i += 4;
+        } else {
+            ++i;
+        }
+        if (cp) r += cp;
+    }
+    return r;
+}
+
+}